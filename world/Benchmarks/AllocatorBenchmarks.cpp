@@ -0,0 +1,590 @@
+#include <algorithm>
+#include <cstdio>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <random>
+#include "Framework/Allocation.h"
+#include "Framework/Math.h"
+#include "Benchmark.h"
+
+// ObjectAllocator
+
+namespace {
+
+	template <int SIZE>
+	struct TestObject {
+		Byte data[ SIZE ];
+	};
+
+	/*
+	Mereni jednoho typu objektu:
+	- latence New() a Delete() (kazde volani zvlast)
+	- propustnost sekvencniho New/Delete a nahodneho poradi uvolneni
+	- obsazena pamet na objekt (vcetne rezidentni pameti procesu, zahrnuje rezii alokace chunku) a fragmentace po nahodnem uvolneni poloviny objektu
+	- ucinnost Flush() po uvolneni 90 % objektu v nahodnem poradi
+	*/
+	template <typename T, typename BlockAllocator>
+	void BenchmarkObjects( const BenchmarkOptions& options, const char* const name ) {
+		const std::size_t count = Iterations( options, 1000000 );
+		ObjectAllocator< T, BlockAllocator > allocator;
+		std::vector< T* > objects( count );
+		std::mt19937 random( 7 );
+		std::printf( "%s, %zu objects\n", name, count );
+
+		// rezidentni pamet na objekt, samostatny alokator bez ostatnich bufferu benchmarku
+		TrimSystemHeap();
+		const std::size_t residentBefore = GetResidentBytes();
+		double residentPerObject = 0.0;
+		{
+			ObjectAllocator< T, BlockAllocator > fresh;
+			for ( std::size_t i = 0; i < count; i++ ) {
+				objects[ i ] = fresh.New();
+			}
+			const std::size_t residentAfter = GetResidentBytes();
+			residentPerObject = static_cast< double >( residentAfter > residentBefore ? residentAfter - residentBefore : 0 ) / static_cast< double >( count );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				fresh.Delete( objects[ i ] );
+			}
+		}
+
+		// latence, prvni pruchod zahrnuje alokaci chunku
+		LatencyRecorder newLatency( count );
+		LatencyRecorder deleteLatency( count );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const BenchmarkClock::time_point begin = BenchmarkClock::now();
+			objects[ i ] = allocator.New();
+			newLatency.Add( Nanoseconds( begin, BenchmarkClock::now() ) );
+		}
+		const double bytesPerObject = static_cast< double >( allocator.MemoryOccupied() ) / static_cast< double >( count );
+		std::shuffle( objects.begin(), objects.end(), random );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const BenchmarkClock::time_point begin = BenchmarkClock::now();
+			allocator.Delete( objects[ i ] );
+			deleteLatency.Add( Nanoseconds( begin, BenchmarkClock::now() ) );
+		}
+		newLatency.Print( "New()" );
+		deleteLatency.Print( "Delete() random order" );
+
+		// propustnost
+		const int rounds = 8;
+		BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			for ( std::size_t i = 0; i < count; i++ ) {
+				objects[ i ] = allocator.New();
+			}
+			for ( std::size_t i = 0; i < count; i++ ) {
+				allocator.Delete( objects[ i ] );
+			}
+		}
+		const double sequential = 2.0 * rounds * count / Seconds( begin, BenchmarkClock::now() );
+
+		for ( std::size_t i = 0; i < count; i++ ) {
+			objects[ i ] = allocator.New();
+		}
+		std::shuffle( objects.begin(), objects.end(), random );
+		begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			for ( std::size_t i = 0; i < count / 2; i++ ) {
+				allocator.Delete( objects[ i ] );
+			}
+			for ( std::size_t i = 0; i < count / 2; i++ ) {
+				objects[ i ] = allocator.New();
+			}
+			std::shuffle( objects.begin(), objects.begin() + count / 2, random );
+		}
+		const double churn = 1.0 * rounds * count / Seconds( begin, BenchmarkClock::now() );
+		std::printf( "  throughput               sequential %.1f Mops/s  random churn %.1f Mops/s\n", sequential / 1e6, churn / 1e6 );
+
+		// fragmentace po uvolneni poloviny objektu v nahodnem poradi
+		std::shuffle( objects.begin(), objects.end(), random );
+		for ( std::size_t i = 0; i < count / 2; i++ ) {
+			allocator.Delete( objects[ i ] );
+		}
+		const unsigned long halfOccupied = allocator.MemoryOccupied();
+		const unsigned long halfAllocated = allocator.MemoryAllocated();
+
+		// Flush() po uvolneni 90 % objektu
+		for ( std::size_t i = count / 2; i < count * 9 / 10; i++ ) {
+			allocator.Delete( objects[ i ] );
+		}
+		const unsigned long beforeFlush = allocator.MemoryOccupied();
+		allocator.Flush();
+		const unsigned long afterFlush = allocator.MemoryOccupied();
+		const unsigned long live = allocator.MemoryAllocated();
+		for ( std::size_t i = count * 9 / 10; i < count; i++ ) {
+			allocator.Delete( objects[ i ] );
+		}
+		allocator.Flush();
+		std::printf(
+			"  memory                   %.2f B/object, resident %.2f B/object (sizeof %zu), 50%% freed: occupied/allocated %.2f\n",
+			bytesPerObject,
+			residentPerObject,
+			sizeof( T ),
+			static_cast< double >( halfOccupied ) / static_cast< double >( Math::Max( halfAllocated, 1ul ) )
+		);
+		std::printf(
+			"  Flush() at 10%% live      %lu KB -> %lu KB (live %lu KB, reclaimed %.1f%%)\n",
+			beforeFlush / 1024,
+			afterFlush / 1024,
+			live / 1024,
+			100.0 * static_cast< double >( beforeFlush - afterFlush ) / static_cast< double >( Math::Max( beforeFlush - live, 1ul ) )
+		);
+	}
+}
+
+int RunObjectAllocatorBenchmark( const BenchmarkOptions& options ) {
+	BenchmarkObjects< TestObject< 16 >, FixedAllocator >( options, "ObjectAllocator<16 B>" );
+	BenchmarkObjects< TestObject< 48 >, FixedAllocator >( options, "ObjectAllocator<48 B>" );
+	BenchmarkObjects< TestObject< 128 >, FixedAllocator >( options, "ObjectAllocator<128 B>" );
+	BenchmarkObjects< TestObject< 48 >, ThreadCachedFixedAllocator >( options, "ObjectAllocator<48 B, ThreadCachedFixedAllocator>" );
+	return 0;
+}
+
+// churn
+
+namespace {
+
+	// alokator pro churn benchmark, Free() dostava velikost bloku
+	struct ChurnTarget {
+		const char* name;
+		void* ( *alloc )( const std::size_t size );
+		void ( *free )( void* const ptr, const std::size_t size );
+	};
+
+	void* HeapAlloc( const std::size_t size ) {
+		return ::operator new( size );
+	}
+
+	void HeapFree( void* const ptr, const std::size_t size ) {
+		::operator delete( ptr, size );
+	}
+
+	void* SystemAlloc( const std::size_t size ) {
+		return std::malloc( size );
+	}
+
+	void SystemFree( void* const ptr, const std::size_t ) {
+		std::free( ptr );
+	}
+
+	const ChurnTarget churnTargets[] = {
+		{ "operator new", HeapAlloc, HeapFree },
+		{ "malloc", SystemAlloc, SystemFree }
+	};
+
+	// velikost alokace, vetsinou male bloky (size class pooly), 1/16 alokaci do 4 KB
+	inline std::size_t GetChurnSize( std::mt19937& random ) {
+		const uint32_t value = random();
+		if ( ( value & 15 ) == 0 ) {
+			return 257 + ( value >> 4 ) % 3840;
+		}
+		return 8 + ( value >> 4 ) % 249;
+	}
+	
+	// systemova halda a chunky poolu operatoru new (chunky nejsou alokovany funkci malloc)
+	inline std::size_t GetChurnHeapBytes() {
+		return GetSystemHeapBytes() + GetSmallAllocationsMemoryOccupied();
+	}
+}
+
+/*
+Kazde vlakno drzi okno WINDOW zivych bloku nahodne velikosti a nahodne je nahrazuje.
+Vypisuje propustnost pro pocty vlaken 1 az 64, obsazenou haldu po churn (fragmentace = halda / zive bajty)
+a haldu po uvolneni vsech bloku (ucinnost vraceni pameti).
+*/
+int RunChurnBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t WINDOW = 1024;
+	const std::size_t operations = Iterations( options, 2000000 );
+	for ( const ChurnTarget& target : churnTargets ) {
+		std::printf( "%s, %zu operations per thread\n", target.name, operations );
+		for ( const int threadsCount : GetThreadCounts( options ) ) {
+			TrimSystemHeap();
+			const std::size_t heapBefore = GetChurnHeapBytes();
+			std::vector< std::vector< std::pair< void*, std::size_t > > > windows( threadsCount );
+			std::vector< std::size_t > liveBytes( threadsCount, 0 );
+			const double seconds = RunThreads( threadsCount, [ & ]( const int thread ) {
+				std::mt19937 random( 1 + thread );
+				std::vector< std::pair< void*, std::size_t > >& window = windows[ thread ];
+				window.resize( WINDOW );
+				for ( std::size_t i = 0; i < WINDOW; i++ ) {
+					const std::size_t size = GetChurnSize( random );
+					window[ i ] = { target.alloc( size ), size };
+				}
+				for ( std::size_t i = 0; i < operations; i++ ) {
+					std::pair< void*, std::size_t >& slot = window[ random() % WINDOW ];
+					target.free( slot.first, slot.second );
+					slot.second = GetChurnSize( random );
+					slot.first = target.alloc( slot.second );
+					static_cast< Byte* >( slot.first )[ 0 ] = 1;
+				}
+				for ( const std::pair< void*, std::size_t >& block : window ) {
+					liveBytes[ thread ] += block.second;
+				}
+			} );
+			const std::size_t heapChurn = GetChurnHeapBytes();
+			std::size_t live = 0;
+			for ( int thread = 0; thread < threadsCount; thread++ ) {
+				live += liveBytes[ thread ];
+				for ( const std::pair< void*, std::size_t >& block : windows[ thread ] ) {
+					target.free( block.first, block.second );
+				}
+			}
+			windows.clear();
+			windows.shrink_to_fit();
+			TrimSystemHeap();
+			const std::size_t heapFreed = GetChurnHeapBytes();
+			std::printf(
+				"  %2d threads  %7.1f Mops/s  heap %6zu KB for %6zu KB live (%.2fx)  after free %+zd KB\n",
+				threadsCount,
+				2.0 * operations * threadsCount / seconds / 1e6,
+				( heapChurn - heapBefore ) / 1024,
+				live / 1024,
+				static_cast< double >( heapChurn - heapBefore ) / static_cast< double >( live ),
+				( static_cast< std::ptrdiff_t >( heapFreed ) - static_cast< std::ptrdiff_t >( heapBefore ) ) / 1024
+			);
+		}
+	}
+	return 0;
+}
+
+// contention
+
+namespace {
+
+	// sdileny alokator 64 bajtovych bloku pro contention benchmark
+	class SharedBlockAllocator {
+	public:
+		virtual ~SharedBlockAllocator() {}
+		virtual void* Alloc() = 0;
+		virtual void Free( void* const ptr ) = 0;
+	};
+
+	class ThreadCachedBlocks: public SharedBlockAllocator {
+	public:
+		explicit ThreadCachedBlocks( const unsigned long size ): allocator( size, 256 ) {}
+		virtual void* Alloc() override { return allocator.Alloc(); }
+		virtual void Free( void* const ptr ) override { allocator.Free( ptr ); }
+	private:
+		ThreadCachedFixedAllocator allocator;
+	};
+
+	class ConcurrentBlocks: public SharedBlockAllocator {
+	public:
+		explicit ConcurrentBlocks( const unsigned long size ): allocator( size, 256 ) {}
+		virtual void* Alloc() override { return allocator.Alloc(); }
+		virtual void Free( void* const ptr ) override { allocator.Free( ptr ); }
+	private:
+		ConcurrentFixedAllocator allocator;
+	};
+
+	class MutexBlocks: public SharedBlockAllocator {
+	public:
+		explicit MutexBlocks( const unsigned long size ): allocator( size, 256 ) {}
+
+		virtual void* Alloc() override {
+			std::lock_guard< std::mutex > lock( mutex );
+			return allocator.Alloc();
+		}
+
+		virtual void Free( void* const ptr ) override {
+			std::lock_guard< std::mutex > lock( mutex );
+			allocator.Free( ptr );
+		}
+
+	private:
+		FixedAllocator allocator;
+		std::mutex mutex;
+	};
+
+	class SystemBlocks: public SharedBlockAllocator {
+	public:
+		explicit SystemBlocks( const unsigned long sizeParam ): size( sizeParam ) {}
+		virtual void* Alloc() override { return std::malloc( size ); }
+		virtual void Free( void* const ptr ) override { std::free( ptr ); }
+	private:
+		const unsigned long size;
+	};
+
+	template <typename T>
+	std::unique_ptr< SharedBlockAllocator > CreateBlocks( const unsigned long size ) {
+		return std::unique_ptr< SharedBlockAllocator >( new T( size ) );
+	}
+
+	struct ContentionTarget {
+		const char* name;
+		std::unique_ptr< SharedBlockAllocator > ( *create )( const unsigned long size );
+	};
+
+	const ContentionTarget contentionTargets[] = {
+		{ "ThreadCachedFixedAllocator", CreateBlocks< ThreadCachedBlocks > },
+		{ "ConcurrentFixedAllocator", CreateBlocks< ConcurrentBlocks > },
+		{ "mutex + FixedAllocator", CreateBlocks< MutexBlocks > },
+		{ "malloc", CreateBlocks< SystemBlocks > }
+	};
+}
+
+/*
+Vsechna vlakna alokuji z jednoho sdileneho alokatoru 64 bajtovych bloku:
+kazde vlakno opakovane alokuje davku BATCH bloku, zapise do nich a uvolni je, kazda ctvrta davka je uvolnena
+az v dalsi iteraci sousednim vlaknem (bloky uvolnene jinym vlaknem, nez ktere je alokovalo).
+*/
+int RunContentionBenchmark( const BenchmarkOptions& options ) {
+	const unsigned long BLOCK_SIZE = 64;
+	const std::size_t BATCH = 32;
+	const std::size_t iterations = Iterations( options, 100000 );
+	const std::vector< int > threadCounts = GetThreadCounts( options );
+
+	std::printf( "%-28s", "threads" );
+	for ( const int threadsCount : threadCounts ) {
+		std::printf( " %7d", threadsCount );
+	}
+	std::printf( "   (Mops/s, %zu alloc + free per thread)\n", iterations * BATCH );
+
+	for ( const ContentionTarget& target : contentionTargets ) {
+		std::printf( "%-28s", target.name );
+		for ( const int threadsCount : threadCounts ) {
+			std::unique_ptr< SharedBlockAllocator > allocator = target.create( BLOCK_SIZE );
+			std::vector< std::atomic< void** > > handoff( threadsCount );
+			std::vector< std::vector< void* > > handoffBlocks( threadsCount, std::vector< void* >( BATCH ) );
+			for ( std::atomic< void** >& slot : handoff ) {
+				slot.store( nullptr );
+			}
+			const double seconds = RunThreads( threadsCount, [ & ]( const int thread ) {
+				void* blocks[ BATCH ];
+				std::atomic< void** >& outgoing = handoff[ thread ];
+				std::atomic< void** >& incoming = handoff[ ( thread + 1 ) % threadsCount ];
+				for ( std::size_t i = 0; i < iterations; i++ ) {
+					for ( std::size_t j = 0; j < BATCH; j++ ) {
+						blocks[ j ] = allocator->Alloc();
+						static_cast< Byte* >( blocks[ j ] )[ 0 ] = static_cast< Byte >( j );
+					}
+					// predat davku sousednimu vlaknu, pokud si prevzalo predchozi
+					if ( ( i & 3 ) == 0 && outgoing.load( std::memory_order_acquire ) == nullptr ) {
+						std::copy( blocks, blocks + BATCH, handoffBlocks[ thread ].begin() );
+						outgoing.store( handoffBlocks[ thread ].data(), std::memory_order_release );
+					} else {
+						for ( std::size_t j = 0; j < BATCH; j++ ) {
+							allocator->Free( blocks[ BATCH - 1 - j ] );
+						}
+					}
+					void** const received = incoming.load( std::memory_order_acquire );
+					if ( received != nullptr ) {
+						for ( std::size_t j = 0; j < BATCH; j++ ) {
+							allocator->Free( received[ j ] );
+						}
+						incoming.store( nullptr, std::memory_order_release );
+					}
+				}
+			} );
+			// neprevzate davky
+			for ( std::atomic< void** >& slot : handoff ) {
+				void** const blocks = slot.load();
+				if ( blocks != nullptr ) {
+					for ( std::size_t j = 0; j < BATCH; j++ ) {
+						allocator->Free( blocks[ j ] );
+					}
+				}
+			}
+			std::printf( " %7.1f", 2.0 * iterations * BATCH * threadsCount / seconds / 1e6 );
+			std::fflush( stdout );
+		}
+		std::printf( "\n" );
+	}
+	return 0;
+}
+
+/*
+Kratce zijici vlakna: THREADS_AT_ONCE vlaken soucasne, kazde alokuje a uvolni bloky ThreadCachedFixedAllocator
+a male bloky operatoru new vsech size class. Magaziny ukoncenych vlaken se musi znovu pouzit,
+obsazena pamet v druhe polovine behu tedy nesmi rust (bez vraceni magazinu roste o kilobajty na vlakno).
+*/
+int RunThreadExitBenchmark( const BenchmarkOptions& options ) {
+	const int THREADS_AT_ONCE = 8;
+	const std::size_t GROWTH_LIMIT = 64 * 1024;
+	const int rounds = static_cast< int >( Iterations( options, 2000 ) ) / THREADS_AT_ONCE;
+	ThreadCachedFixedAllocator allocator( 64 );
+	unsigned long halfway = 0;
+	std::size_t halfwayHeap = 0;
+	const BenchmarkClock::time_point begin = BenchmarkClock::now();
+	for ( int round = 0; round < rounds; round++ ) {
+		RunThreads( THREADS_AT_ONCE, [ & ]( const int ) {
+			void* blocks[ 100 ];
+			for ( void*& block : blocks ) {
+				block = allocator.Alloc();
+			}
+			// cast bloku zustane v magazinu vlakna
+			for ( void* const block : blocks ) {
+				allocator.Free( block );
+			}
+			void* heapBlocks[ SMALL_ALLOCATION_MAX_SIZE ];
+			for ( std::size_t i = 0; i < SMALL_ALLOCATION_MAX_SIZE; i++ ) {
+				heapBlocks[ i ] = ::operator new( i + 1 );
+			}
+			for ( std::size_t i = 0; i < SMALL_ALLOCATION_MAX_SIZE; i++ ) {
+				::operator delete( heapBlocks[ i ], i + 1 );
+			}
+		} );
+		if ( round == rounds / 2 ) {
+			halfway = allocator.MemoryOccupied();
+			halfwayHeap = GetSmallAllocationsMemoryOccupied();
+		}
+	}
+	const double seconds = Seconds( begin, BenchmarkClock::now() );
+	const unsigned long occupied = allocator.MemoryOccupied();
+	const std::size_t heap = GetSmallAllocationsMemoryOccupied();
+	std::printf(
+		"%d threads (%.1f us per thread), occupied memory halfway -> after all threads:\n",
+		rounds * THREADS_AT_ONCE,
+		seconds * 1e6 / ( rounds * THREADS_AT_ONCE )
+	);
+	std::printf( "  ThreadCachedFixedAllocator  %lu KB -> %lu KB\n", halfway / 1024, occupied / 1024 );
+	std::printf( "  operator new pools          %zu KB -> %zu KB\n", halfwayHeap / 1024, heap / 1024 );
+	if ( allocator.Allocated() != 0 || occupied > halfway + GROWTH_LIMIT || heap > halfwayHeap + GROWTH_LIMIT ) {
+		std::printf( "thread caches of exited threads were not reclaimed\n" );
+		return 1;
+	}
+	return 0;
+}
+
+// operator new
+
+/*
+Male alokace operatoru new: obsazena pamet size class poolu na blok a propustnost
+new + sized delete a new + unsized delete pro bloky 16 az 256 bajtu.
+*/
+int RunHeapBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 1000000 );
+	std::vector< void* > blocks( count );
+	std::mt19937 random( 5 );
+	std::printf( "%zu blocks\n", count );
+	for ( const std::size_t size : { 16, 32, 48, 64, 128, 256 } ) {
+		const std::size_t occupiedBefore = GetSmallAllocationsMemoryOccupied();
+		BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			blocks[ i ] = ::operator new( size );
+			static_cast< Byte* >( blocks[ i ] )[ 0 ] = 1;
+		}
+		const double allocSeconds = Seconds( begin, BenchmarkClock::now() );
+		const std::size_t occupied = GetSmallAllocationsMemoryOccupied() - occupiedBefore;
+		std::shuffle( blocks.begin(), blocks.end(), random );
+		begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			::operator delete( blocks[ i ], size );
+		}
+		const double sizedSeconds = Seconds( begin, BenchmarkClock::now() );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			blocks[ i ] = ::operator new( size );
+			static_cast< Byte* >( blocks[ i ] )[ 0 ] = 1;
+		}
+		std::shuffle( blocks.begin(), blocks.end(), random );
+		begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			::operator delete( blocks[ i ] );
+		}
+		const double unsizedSeconds = Seconds( begin, BenchmarkClock::now() );
+		std::printf(
+			"  %3zu B  %6.2f B/block  new %6.1f Mops/s  sized delete %6.1f Mops/s  unsized delete %6.1f Mops/s\n",
+			size,
+			static_cast< double >( occupied ) / static_cast< double >( count ),
+			count / allocSeconds / 1e6,
+			count / sizedSeconds / 1e6,
+			count / unsizedSeconds / 1e6
+		);
+	}
+	return 0;
+}
+
+
+// huge pages
+
+namespace {
+
+	// objekt poolu velikosti cache line, odkaz na dalsi objekt pruchodu
+	struct WalkObject {
+		WalkObject* next;
+		uint64_t value;
+		Byte padding[ 48 ];
+	};
+
+	/*
+	Pruchod objekty ObjectAllocator< WalkObject > s chunky z providera (nullptr = GetHeapChunkProvider()):
+	- sekvencni pruchod v poradi alokace
+	- nahodny pruchod (retezec odkazu v nahodnem poradi, kazdy krok ceka na predchozi, meri latenci vcetne TLB miss)
+	Vraci false, pokud pruchod nenavstivil vsechny objekty.
+	*/
+	bool WalkObjects( const std::size_t count, const char* const name, ChunkProvider* const provider ) {
+		ObjectAllocator< WalkObject > allocator( DEFAULT_ALLOCATOR_CHUNK_SIZE, provider );
+		std::vector< WalkObject* > objects( count );
+		const std::size_t hugeBefore = GetHugePageBytes();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			objects[ i ] = allocator.New();
+			objects[ i ]->value = 1;
+		}
+		const std::size_t hugeAfter = GetHugePageBytes();
+		const std::size_t hugeBytes = hugeAfter > hugeBefore ? hugeAfter - hugeBefore : 0;
+
+		// sekvencni pruchod
+		uint64_t sequentialSum = 0;
+		BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			sequentialSum += objects[ i ]->value;
+		}
+		const double sequentialSeconds = Seconds( begin, BenchmarkClock::now() );
+
+		// nahodny retezec pres vsechny objekty
+		std::vector< WalkObject* > order( objects );
+		std::mt19937 random( 13 );
+		std::shuffle( order.begin(), order.end(), random );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			order[ i ]->next = order[ ( i + 1 ) % count ];
+		}
+		uint64_t randomSum = 0;
+		WalkObject* object = order[ 0 ];
+		begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			randomSum += object->value;
+			object = object->next;
+		}
+		const double randomSeconds = Seconds( begin, BenchmarkClock::now() );
+		DoNotOptimize( object );
+
+		std::printf(
+			"  %-32s sequential %6.2f ns/object  random %6.1f ns/object  huge pages %zu MB\n",
+			name,
+			sequentialSeconds * 1e9 / static_cast< double >( count ),
+			randomSeconds * 1e9 / static_cast< double >( count ),
+			hugeBytes / ( 1024 * 1024 )
+		);
+		for ( std::size_t i = 0; i < count; i++ ) {
+			allocator.Delete( objects[ i ] );
+		}
+		allocator.Flush();
+		return sequentialSum == count && randomSum == count && object == order[ 0 ];
+	}
+}
+
+/*
+Pruchod objekty poolu (64 B) s chunky z VirtualChunkProvider s huge pages a bez nich a z GetHeapChunkProvider().
+Plny beh prochazi 4M objektu (256 MB, vice nez pokryje TLB s 4 kB strankami), quick 256k objektu.
+Huge pages jsou transparent huge pages (madvise), jejich skutecne pouziti zavisi na nastaveni systemu.
+*/
+int RunHugePagesBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 4 * 1024 * 1024 );
+	// rezerva na zaokrouhleni chunku na granularitu providera
+	const std::size_t reserve = count * sizeof( WalkObject ) * 2 + 64 * 1024 * 1024;
+	std::printf( "%zu objects, %zu MB\n", count, count * sizeof( WalkObject ) / ( 1024 * 1024 ) );
+	bool passed = true;
+	for ( const bool largePages : { false, true } ) {
+		VirtualChunkProvider provider( reserve, largePages );
+		if ( !provider.IsValid() ) {
+			std::printf( "  VirtualChunkProvider( largePages = %d ): reservation failed\n", largePages ? 1 : 0 );
+			passed = false;
+			continue;
+		}
+		passed &= WalkObjects( count, largePages ? "VirtualChunkProvider, huge pages" : "VirtualChunkProvider", &provider );
+	}
+	passed &= WalkObjects( count, "GetHeapChunkProvider()", nullptr );
+	return passed ? 0 : 1;
+}
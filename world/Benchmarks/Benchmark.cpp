@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include "Benchmark.h"
+
+#ifdef _LINUX
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+LatencyRecorder::LatencyRecorder( const std::size_t capacity ) {
+	samples.reserve( capacity );
+}
+
+void LatencyRecorder::Add( const uint64_t nanoseconds ) {
+	if ( samples.size() < samples.capacity() ) {
+		samples.push_back( nanoseconds );
+	}
+}
+
+void LatencyRecorder::Clear() {
+	samples.clear();
+}
+
+void LatencyRecorder::Print( const char* const label ) {
+	if ( samples.empty() ) {
+		std::printf( "  %-24s no samples\n", label );
+		return;
+	}
+	std::sort( samples.begin(), samples.end() );
+	const auto percentile = [ this ]( const double p ) {
+		const std::size_t index = static_cast< std::size_t >( p * static_cast< double >( samples.size() - 1 ) );
+		return static_cast< unsigned long long >( samples[ index ] );
+	};
+	std::printf(
+		"  %-24s p50 %4llu ns  p90 %4llu ns  p99 %5llu ns  p99.9 %6llu ns  max %8llu ns\n",
+		label,
+		percentile( 0.5 ),
+		percentile( 0.9 ),
+		percentile( 0.99 ),
+		percentile( 0.999 ),
+		static_cast< unsigned long long >( samples.back() )
+	);
+}
+
+double RunThreads( const int threadsCount, const std::function< void( const int thread ) >& function ) {
+	std::atomic< int > ready( 0 );
+	std::atomic< bool > start( false );
+	std::vector< std::thread > threads;
+	threads.reserve( threadsCount );
+	for ( int i = 0; i < threadsCount; i++ ) {
+		threads.emplace_back( [ &, i ] {
+			ready.fetch_add( 1 );
+			while ( !start.load( std::memory_order_acquire ) ) {
+				std::this_thread::yield();
+			}
+			function( i );
+		} );
+	}
+	while ( ready.load() < threadsCount ) {
+		std::this_thread::yield();
+	}
+	const BenchmarkClock::time_point begin = BenchmarkClock::now();
+	start.store( true, std::memory_order_release );
+	for ( std::thread& thread : threads ) {
+		thread.join();
+	}
+	return Seconds( begin, BenchmarkClock::now() );
+}
+
+std::vector< int > GetThreadCounts( const BenchmarkOptions& options, const int maxThreads ) {
+	std::vector< int > counts;
+	const int limit = options.quick ? std::min( maxThreads, 4 ) : maxThreads;
+	for ( int count = 1; count <= limit; count *= 2 ) {
+		counts.push_back( count );
+	}
+	return counts;
+}
+
+std::size_t GetSystemHeapBytes() {
+#if defined( _LINUX ) && defined( __GLIBC__ ) && ( __GLIBC__ > 2 || ( __GLIBC__ == 2 && __GLIBC_MINOR__ >= 33 ) )
+	const struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+std::size_t GetResidentBytes() {
+#ifdef _LINUX
+	// druhe pole /proc/self/statm: rezidentni stranky procesu
+	FILE* const file = std::fopen( "/proc/self/statm", "r" );
+	if ( file == nullptr ) {
+		return 0;
+	}
+	unsigned long size = 0;
+	unsigned long resident = 0;
+	const int fields = std::fscanf( file, "%lu %lu", &size, &resident );
+	std::fclose( file );
+	if ( fields != 2 ) {
+		return 0;
+	}
+	return resident * static_cast< std::size_t >( sysconf( _SC_PAGESIZE ) );
+#else
+	return 0;
+#endif
+}
+
+std::size_t GetHugePageBytes() {
+#ifdef _LINUX
+	// radek AnonHugePages v /proc/self/smaps_rollup (kB)
+	FILE* const file = std::fopen( "/proc/self/smaps_rollup", "r" );
+	if ( file == nullptr ) {
+		return 0;
+	}
+	char line[ 256 ];
+	unsigned long kilobytes = 0;
+	while ( std::fgets( line, sizeof( line ), file ) != nullptr ) {
+		if ( std::sscanf( line, "AnonHugePages: %lu kB", &kilobytes ) == 1 ) {
+			break;
+		}
+	}
+	std::fclose( file );
+	return kilobytes * 1024;
+#else
+	return 0;
+#endif
+}
+
+void TrimSystemHeap() {
+#if defined( _LINUX ) && defined( __GLIBC__ )
+	malloc_trim( 0 );
+#endif
+}
+
+void DoNotOptimize( const void* const ptr ) {
+	static std::atomic< const void* > sink( nullptr );
+	sink.store( ptr, std::memory_order_relaxed );
+}
\ No newline at end of file
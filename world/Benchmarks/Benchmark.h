@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/*
+Spolecne funkce benchmarku (bench <nazev> [--quick] [parametry]).
+Benchmark vraci 0 pri uspechu, nenulova hodnota ukonci program s chybou (pouziva ctest).
+*/
+struct BenchmarkOptions {
+	bool quick;							// zkraceny beh (smoke test)
+	std::vector< const char* > args;	// parametry bez prepinacu
+};
+
+// pocet iteraci podle rezimu, quick zmensi count 16x
+inline std::size_t Iterations( const BenchmarkOptions& options, const std::size_t count ) {
+	return options.quick ? ( count + 15 ) / 16 : count;
+}
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+inline double Seconds( const BenchmarkClock::time_point begin, const BenchmarkClock::time_point end ) {
+	return std::chrono::duration< double >( end - begin ).count();
+}
+
+inline uint64_t Nanoseconds( const BenchmarkClock::time_point begin, const BenchmarkClock::time_point end ) {
+	return static_cast< uint64_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( end - begin ).count() );
+}
+
+/*
+Zaznam latenci jednotlivych operaci.
+Kapacita je rezervovana predem, zaznam behem mereni nealokuje.
+*/
+class LatencyRecorder {
+public:
+	explicit LatencyRecorder( const std::size_t capacity );
+
+	void Add( const uint64_t nanoseconds );
+	void Clear();
+
+	// vypise p50, p90, p99, p99.9 a max (seradi zaznamy)
+	void Print( const char* const label );
+
+private:
+	std::vector< uint64_t > samples;
+};
+
+/*
+Spusti function( threadIndex ) v threadsCount vlaknech soucasne.
+Vlakna zacnou az po vytvoreni vsech vlaken, vraci dobu od startu do dokonceni posledniho vlakna.
+*/
+double RunThreads( const int threadsCount, const std::function< void( const int thread ) >& function );
+
+// pocty vlaken pro mereni skalovani: 1, 2, 4 ... maxThreads
+std::vector< int > GetThreadCounts( const BenchmarkOptions& options, const int maxThreads = 64 );
+
+// bajty obsazene systemovou haldou (malloc), 0 pokud je nelze zjistit
+std::size_t GetSystemHeapBytes();
+
+// rezidentni pamet procesu vcetne rezie systemovych alokaci (zarovnani, mmap), 0 pokud ji nelze zjistit
+std::size_t GetResidentBytes();
+
+// pamet procesu v transparent huge pages, 0 pokud ji nelze zjistit
+std::size_t GetHugePageBytes();
+
+// vrati volnou pamet haldy systemu (malloc_trim), zpresnuje GetSystemHeapBytes() po uvolneni
+void TrimSystemHeap();
+
+// zabrani odstraneni vypoctu prekladacem
+void DoNotOptimize( const void* const ptr );
+
+// benchmarky
+int RunObjectAllocatorBenchmark( const BenchmarkOptions& options );
+int RunHeapBenchmark( const BenchmarkOptions& options );
+int RunHugePagesBenchmark( const BenchmarkOptions& options );
+int RunChurnBenchmark( const BenchmarkOptions& options );
+int RunContentionBenchmark( const BenchmarkOptions& options );
+int RunThreadExitBenchmark( const BenchmarkOptions& options );
+int RunTrackingBenchmark( const BenchmarkOptions& options );
+int RunStringBenchmark( const BenchmarkOptions& options );
+int RunReplayBenchmark( const BenchmarkOptions& options );
+int RunMathAccuracyBenchmark( const BenchmarkOptions& options );
+int RunMathBenchmark( const BenchmarkOptions& options );
+int RunTransformBenchmark( const BenchmarkOptions& options );
+int RunMatrixArrayBenchmark( const BenchmarkOptions& options );
+int RunTransformHierarchyBenchmark( const BenchmarkOptions& options );
+int RunCullingBenchmark( const BenchmarkOptions& options );
+int RunBvhBenchmark( const BenchmarkOptions& options );
+int RunMipsBenchmark( const BenchmarkOptions& options );
+int RunCompressionBenchmark( const BenchmarkOptions& options );
+int RunFormatsBenchmark( const BenchmarkOptions& options );
+int RunHalfBenchmark( const BenchmarkOptions& options );
+int RunColorsBenchmark( const BenchmarkOptions& options );
+int RunRenderStateBenchmark( const BenchmarkOptions& options );
+int RunVertexBenchmark( const BenchmarkOptions& options );
+int RunPackedArrayBenchmark( const BenchmarkOptions& options );
\ No newline at end of file
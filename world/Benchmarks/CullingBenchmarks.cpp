@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "Framework/Bvh.h"
+#include "Framework/Frustum.h"
+#include "Framework/Parallel.h"
+#include "Benchmark.h"
+
+// frustum culling
+
+namespace {
+
+	// vzdalenost objektu od roviny frustum, pod kterou se muze vysledek jednotlivych testu lisit zaokrouhlenim
+	const double CULLING_MARGIN = 0.01;
+
+	// kamera v pocatku, pohled ve smeru osy z
+	Frustum MakeCameraFrustum() {
+		Matrix view;
+		view.LookToLH( Vector( 0, 0, 0, 1.0f ), Vector( 0.3f, 0.1f, 1.0f, 0 ), Vector( 0, 1.0f, 0, 0 ) );
+		Matrix projection;
+		projection.PerspectiveLH( 1.0f, 16.0f / 9.0f, 0.5f, 400.0f );
+		view.Mul( projection );
+		return Frustum( view );
+	}
+
+	// nejmensi absolutni vzdalenost ( a, b, c, d ) . ( x, y, z, 1 ) + offset od roviny v double
+	double GetPlanesMargin( const Frustum& frustum, const Vector& min, const Vector& max, const double offset ) {
+		double margin = INFINITY;
+		for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+			const Float4& plane = frustum.GetPlane( p );
+			const double x = plane.x >= 0 ? max.x : min.x;
+			const double y = plane.y >= 0 ? max.y : min.y;
+			const double z = plane.z >= 0 ? max.z : min.z;
+			const double distance = plane.x * x + plane.y * y + plane.z * z + plane.w + offset;
+			margin = std::fmin( margin, std::fabs( distance ) );
+		}
+		return margin;
+	}
+
+	/*
+	Nahodne objekty v krychli o hrane 1000 kolem kamery (priblizne 5 % viditelnych).
+	Objekty blize nez CULLING_MARGIN k nektere rovine jsou vygenerovany znovu, jednotlive testy a kernely
+	secitaji v jinem poradi (a s FMA) a objekt na hranici muze byt jednou viditelny a jednou ne.
+	*/
+	struct CullingScene {
+		std::vector< float > x, y, z, radius;
+		std::vector< float > minX, minY, minZ, maxX, maxY, maxZ;
+
+		CullingScene( const Frustum& frustum, const std::size_t count ) {
+			std::mt19937 random( 17 );
+			std::uniform_real_distribution< float > position( -500.0f, 500.0f );
+			std::uniform_real_distribution< float > size( 0.5f, 10.0f );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				Vector center;
+				float r = 0;
+				do {
+					center = Vector( position( random ), position( random ), position( random ), 0 );
+					r = size( random );
+				} while ( GetPlanesMargin( frustum, center, center, r ) < CULLING_MARGIN );
+				x.push_back( center.x );
+				y.push_back( center.y );
+				z.push_back( center.z );
+				radius.push_back( r );
+
+				Vector min, max;
+				do {
+					min = Vector( position( random ), position( random ), position( random ), 0 );
+					max = min + Vector( size( random ), size( random ), size( random ), 0 );
+				} while ( GetPlanesMargin( frustum, min, max, 0 ) < CULLING_MARGIN );
+				minX.push_back( min.x );
+				minY.push_back( min.y );
+				minZ.push_back( min.z );
+				maxX.push_back( max.x );
+				maxY.push_back( max.y );
+				maxZ.push_back( max.z );
+			}
+		}
+
+		BoundingSphereArrays GetSpheres() const {
+			return BoundingSphereArrays{ x.data(), y.data(), z.data(), radius.data() };
+		}
+
+		BoundingBoxArrays GetBoxes() const {
+			return BoundingBoxArrays{ minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data() };
+		}
+	};
+
+	/*
+	Zmeri rounds volani cull( visible ) nad count objekty, cull vraci pocet viditelnych objektu, vypise ns na objekt.
+	Vraci false, pokud se indexy viditelnych objektu lisi od reference.
+	*/
+	template <typename Function>
+	bool MeasureCulling( const char* const name, const std::size_t count, const int rounds, const std::vector< uint32_t >& reference, Function cull ) {
+		std::vector< uint32_t > visible( count );
+		std::size_t visibleCount = 0;
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			visibleCount = cull( visible.data() );
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		const bool passed = visibleCount == reference.size() && std::equal( reference.begin(), reference.end(), visible.begin() );
+		std::printf(
+			"  %-32s %6.2f ns/object  %zu visible %s\n",
+			name,
+			seconds * 1e9 / static_cast< double >( rounds ) / static_cast< double >( count ),
+			visibleCount,
+			passed ? "" : "MISMATCH"
+		);
+		return passed;
+	}
+}
+
+/*
+Frustum culling 1M objektu (quick 64k): test po objektech (Frustum::TestSphere a TestBox) proti CullSpheres a CullBoxes
+serialne a paralelne. Vraci 1, pokud se seznamy viditelnych objektu lisi.
+*/
+int RunCullingBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 1024 * 1024 );
+	const int rounds = 8;
+	const Frustum frustum = MakeCameraFrustum();
+	const CullingScene scene( frustum, count );
+	const BoundingSphereArrays spheres = scene.GetSpheres();
+	const BoundingBoxArrays boxes = scene.GetBoxes();
+	std::printf( "%zu objects, %u threads\n", count, GetParallelThreadsCount() );
+
+	// reference: test po objektech
+	std::vector< uint32_t > sphereReference;
+	std::vector< uint32_t > boxReference;
+	sphereReference.reserve( count );
+	boxReference.reserve( count );
+	for ( std::size_t i = 0; i < count; i++ ) {
+		if ( frustum.TestSphere( Vector( spheres.x[ i ], spheres.y[ i ], spheres.z[ i ], 0 ), spheres.radius[ i ] ) ) {
+			sphereReference.push_back( static_cast< uint32_t >( i ) );
+		}
+		if ( frustum.TestBox( Vector( boxes.minX[ i ], boxes.minY[ i ], boxes.minZ[ i ], 0 ), Vector( boxes.maxX[ i ], boxes.maxY[ i ], boxes.maxZ[ i ], 0 ) ) ) {
+			boxReference.push_back( static_cast< uint32_t >( i ) );
+		}
+	}
+
+	bool passed = true;
+	passed &= MeasureCulling( "Frustum::TestSphere", count, rounds, sphereReference, [ & ]( uint32_t* const visible ) {
+		std::size_t n = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			if ( frustum.TestSphere( Vector( spheres.x[ i ], spheres.y[ i ], spheres.z[ i ], 0 ), spheres.radius[ i ] ) ) {
+				visible[ n++ ] = static_cast< uint32_t >( i );
+			}
+		}
+		return n;
+	} );
+	passed &= MeasureCulling( "CullSpheres", count, rounds, sphereReference, [ & ]( uint32_t* const visible ) {
+		return CullSpheres( frustum, spheres, count, visible );
+	} );
+	passed &= MeasureCulling( "CullSpheres parallel", count, rounds, sphereReference, [ & ]( uint32_t* const visible ) {
+		return CullSpheres( frustum, spheres, count, visible, true );
+	} );
+	passed &= MeasureCulling( "Frustum::TestBox", count, rounds, boxReference, [ & ]( uint32_t* const visible ) {
+		std::size_t n = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			if ( frustum.TestBox( Vector( boxes.minX[ i ], boxes.minY[ i ], boxes.minZ[ i ], 0 ), Vector( boxes.maxX[ i ], boxes.maxY[ i ], boxes.maxZ[ i ], 0 ) ) ) {
+				visible[ n++ ] = static_cast< uint32_t >( i );
+			}
+		}
+		return n;
+	} );
+	passed &= MeasureCulling( "CullBoxes", count, rounds, boxReference, [ & ]( uint32_t* const visible ) {
+		return CullBoxes( frustum, boxes, count, visible );
+	} );
+	passed &= MeasureCulling( "CullBoxes parallel", count, rounds, boxReference, [ & ]( uint32_t* const visible ) {
+		return CullBoxes( frustum, boxes, count, visible, true );
+	} );
+	return passed ? 0 : 1;
+}
+
+// BVH
+
+namespace {
+
+	/*
+	Kontrola vysledku dotazu proti testu vsech objektu v double. margin( i ) vraci kladne cislo pro objekt v dotazu,
+	zaporne pro objekt mimo dotaz. Objekty blize hranici nez BVH_MARGIN mohou byt ve vysledku (zaokrouhleni), ostatni
+	musi odpovidat presne, zadny objekt nesmi byt ve vysledku dvakrat.
+	*/
+	const double BVH_MARGIN = 1e-3;
+
+	template <typename Margin>
+	bool CheckQuery( const std::size_t count, const std::vector< uint32_t >& result, Margin margin ) {
+		std::vector< uint8_t > found( count, 0 );
+		for ( const uint32_t object : result ) {
+			if ( object >= count || found[ object ] != 0 || margin( object ) < -BVH_MARGIN ) {
+				return false;
+			}
+			found[ object ] = 1;
+		}
+		for ( std::size_t i = 0; i < count; i++ ) {
+			if ( found[ i ] == 0 && margin( i ) > BVH_MARGIN ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	double GetFrustumMargin( const Frustum& frustum, const BoundingBox& box ) {
+		double margin = INFINITY;
+		for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+			const Float4& plane = frustum.GetPlane( p );
+			const double x = plane.x >= 0 ? box.max.x : box.min.x;
+			const double y = plane.y >= 0 ? box.max.y : box.min.y;
+			const double z = plane.z >= 0 ? box.max.z : box.min.z;
+			margin = std::fmin( margin, plane.x * x + plane.y * y + plane.z * z + plane.w );
+		}
+		return margin;
+	}
+
+	double GetSphereMargin( const Vector& center, const float radius, const BoundingBox& box ) {
+		const double dx = std::fmax( std::fmax( box.min.x - center.x, center.x - box.max.x ), 0.0 );
+		const double dy = std::fmax( std::fmax( box.min.y - center.y, center.y - box.max.y ), 0.0 );
+		const double dz = std::fmax( std::fmax( box.min.z - center.z, center.z - box.max.z ), 0.0 );
+		return radius - std::sqrt( dx * dx + dy * dy + dz * dz );
+	}
+
+	double GetBoxMargin( const Vector& min, const Vector& max, const BoundingBox& box ) {
+		double margin = std::fmin( std::fmin( box.max.x - min.x, max.x - box.min.x ), std::fmin( box.max.y - min.y, max.y - box.min.y ) );
+		return std::fmin( margin, std::fmin( box.max.z - min.z, max.z - box.min.z ) );
+	}
+
+	// vstup a vystup paprsku z boxu v double (slaby), enter > leave pokud paprsek box neprotina
+	void IntersectRay( const Vector& origin, const Vector& direction, const float length, const BoundingBox& box, double& enter, double& leave ) {
+		enter = 0;
+		leave = length;
+		const float* const boxMin = &box.min.x;
+		const float* const boxMax = &box.max.x;
+		for ( int axis = 0; axis < 3; axis++ ) {
+			const double o = ( &origin.x )[ axis ];
+			const double d = ( &direction.x )[ axis ];
+			const double t1 = ( boxMin[ axis ] - o ) / d;
+			const double t2 = ( boxMax[ axis ] - o ) / d;
+			enter = std::fmax( enter, std::fmin( t1, t2 ) );
+			leave = std::fmin( leave, std::fmax( t1, t2 ) );
+		}
+	}
+
+	// nahodne boxy v krychli o hrane 1000, hrana boxu 0.5 - 5
+	std::vector< BoundingBox > MakeBoxes( const std::size_t count ) {
+		std::mt19937 random( 19 );
+		std::uniform_real_distribution< float > position( -500.0f, 500.0f );
+		std::uniform_real_distribution< float > size( 0.5f, 5.0f );
+		std::vector< BoundingBox > boxes( count );
+		for ( BoundingBox& box : boxes ) {
+			box.min = Float3( position( random ), position( random ), position( random ) );
+			box.max = Float3( box.min.x + size( random ), box.min.y + size( random ), box.min.z + size( random ) );
+		}
+		return boxes;
+	}
+
+	// dotazy pro mereni i kontrolu
+	struct BvhQueries {
+		std::vector< Vector > centers;
+		std::vector< float > radii;
+		std::vector< Vector > boxMins;
+		std::vector< Vector > boxMaxs;
+		std::vector< Vector > origins;
+		std::vector< Vector > directions;
+
+		explicit BvhQueries( const std::size_t count ) {
+			std::mt19937 random( 23 );
+			std::uniform_real_distribution< float > position( -500.0f, 500.0f );
+			std::uniform_real_distribution< float > size( 10.0f, 30.0f );
+			std::uniform_real_distribution< float > axis( -1.0f, 1.0f );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				centers.push_back( Vector( position( random ), position( random ), position( random ), 0 ) );
+				radii.push_back( size( random ) );
+				const Vector min( position( random ), position( random ), position( random ), 0 );
+				boxMins.push_back( min );
+				boxMaxs.push_back( min + Vector( size( random ), size( random ), size( random ), 0 ) );
+				origins.push_back( Vector( position( random ), position( random ), position( random ), 0 ) );
+				Vector direction( axis( random ), axis( random ), axis( random ), 0 );
+				direction.Normalize();
+				directions.push_back( direction );
+			}
+		}
+	};
+
+	const float BVH_RAY_LENGTH = 2000.0f;
+
+	// kontrola checksCount dotazu kazdeho typu proti testu vsech objektu
+	bool CheckBvh( const Bvh& bvh, const std::vector< BoundingBox >& boxes, const Frustum& frustum, const BvhQueries& queries, const std::size_t checksCount ) {
+		const std::size_t count = boxes.size();
+		bool passed = true;
+		std::vector< uint32_t > result;
+		bvh.QueryFrustum( frustum, result );
+		passed &= CheckQuery( count, result, [ & ]( const std::size_t i ) { return GetFrustumMargin( frustum, boxes[ i ] ); } );
+		for ( std::size_t q = 0; q < checksCount; q++ ) {
+			result.clear();
+			bvh.QuerySphere( queries.centers[ q ], queries.radii[ q ], result );
+			passed &= CheckQuery( count, result, [ & ]( const std::size_t i ) { return GetSphereMargin( queries.centers[ q ], queries.radii[ q ], boxes[ i ] ); } );
+
+			result.clear();
+			bvh.QueryBox( queries.boxMins[ q ], queries.boxMaxs[ q ], result );
+			passed &= CheckQuery( count, result, [ & ]( const std::size_t i ) { return GetBoxMargin( queries.boxMins[ q ], queries.boxMaxs[ q ], boxes[ i ] ); } );
+
+			// paprsek: rozdil vystupu a vstupu, nejblizsi objekt s jistym pruseciskem
+			result.clear();
+			bvh.QueryRay( queries.origins[ q ], queries.directions[ q ], BVH_RAY_LENGTH, result );
+			double nearest = INFINITY;
+			passed &= CheckQuery( count, result, [ & ]( const std::size_t i ) {
+				double enter, leave;
+				IntersectRay( queries.origins[ q ], queries.directions[ q ], BVH_RAY_LENGTH, boxes[ i ], enter, leave );
+				if ( leave - enter > BVH_MARGIN ) {
+					nearest = std::fmin( nearest, enter );
+				}
+				return leave - enter;
+			} );
+			BvhRayHit hit = {};
+			const bool hitFound = bvh.Raycast( queries.origins[ q ], queries.directions[ q ], BVH_RAY_LENGTH, hit );
+			if ( hitFound ) {
+				double enter, leave;
+				IntersectRay( queries.origins[ q ], queries.directions[ q ], BVH_RAY_LENGTH, boxes[ hit.object ], enter, leave );
+				passed &= hit.object < count && leave - enter >= -BVH_MARGIN && std::fabs( enter - hit.distance ) <= BVH_MARGIN && enter <= nearest + BVH_MARGIN;
+			} else {
+				passed &= nearest == INFINITY;
+			}
+		}
+		return passed;
+	}
+
+	// rounds volani function( i ), vypise us na volani a prumerny pocet nalezenych objektu
+	template <typename Function>
+	void MeasureQuery( const char* const name, const std::size_t rounds, Function function ) {
+		std::size_t found = 0;
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < rounds; i++ ) {
+			found += function( i );
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		std::printf( "  %-24s %9.2f us/query  %8.1f objects/query\n", name, seconds * 1e6 / static_cast< double >( rounds ), static_cast< double >( found ) / static_cast< double >( rounds ) );
+	}
+}
+
+/*
+Bvh nad 1M boxy (quick 64k): Build, Refit po posunu objektu a dotazy QueryFrustum, QuerySphere, QueryBox, QueryRay a Raycast.
+Vysledky dotazu po Build i po Refit jsou porovnany s testem vsech objektu, vraci 1 pri rozdilu.
+*/
+int RunBvhBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 1024 * 1024 );
+	const std::size_t queriesCount = 4096;
+	const std::size_t checksCount = options.quick ? 4 : 16;
+	std::vector< BoundingBox > boxes = MakeBoxes( count );
+	const Frustum frustum = MakeCameraFrustum();
+	const BvhQueries queries( queriesCount );
+	std::printf( "%zu boxes\n", count );
+
+	Bvh bvh;
+	BenchmarkClock::time_point begin = BenchmarkClock::now();
+	bvh.Build( boxes.data(), count );
+	std::printf( "  %-24s %9.2f ms, %zu nodes\n", "Build", Seconds( begin, BenchmarkClock::now() ) * 1e3, bvh.GetNodesCount() );
+	bool passed = CheckBvh( bvh, boxes, frustum, queries, checksCount );
+
+	// posun vsech objektu
+	std::mt19937 random( 29 );
+	std::uniform_real_distribution< float > offset( -2.0f, 2.0f );
+	for ( BoundingBox& box : boxes ) {
+		const Float3 move( offset( random ), offset( random ), offset( random ) );
+		box.min = Float3( box.min.x + move.x, box.min.y + move.y, box.min.z + move.z );
+		box.max = Float3( box.max.x + move.x, box.max.y + move.y, box.max.z + move.z );
+	}
+	begin = BenchmarkClock::now();
+	bvh.Refit( boxes.data() );
+	std::printf( "  %-24s %9.2f ms\n", "Refit", Seconds( begin, BenchmarkClock::now() ) * 1e3 );
+	passed &= CheckBvh( bvh, boxes, frustum, queries, checksCount );
+
+	std::vector< uint32_t > result;
+	MeasureQuery( "QueryFrustum", 16, [ & ]( const std::size_t ) {
+		result.clear();
+		bvh.QueryFrustum( frustum, result );
+		return result.size();
+	} );
+	MeasureQuery( "QuerySphere", queriesCount, [ & ]( const std::size_t i ) {
+		result.clear();
+		bvh.QuerySphere( queries.centers[ i ], queries.radii[ i ], result );
+		return result.size();
+	} );
+	MeasureQuery( "QueryBox", queriesCount, [ & ]( const std::size_t i ) {
+		result.clear();
+		bvh.QueryBox( queries.boxMins[ i ], queries.boxMaxs[ i ], result );
+		return result.size();
+	} );
+	MeasureQuery( "QueryRay", queriesCount, [ & ]( const std::size_t i ) {
+		result.clear();
+		bvh.QueryRay( queries.origins[ i ], queries.directions[ i ], BVH_RAY_LENGTH, result );
+		return result.size();
+	} );
+	MeasureQuery( "Raycast", queriesCount, [ & ]( const std::size_t i ) {
+		BvhRayHit hit;
+		return bvh.Raycast( queries.origins[ i ], queries.directions[ i ], BVH_RAY_LENGTH, hit ) ? std::size_t( 1 ) : std::size_t( 0 );
+	} );
+	if ( !passed ) {
+		std::printf( "query results differ from brute force test\n" );
+	}
+	return passed ? 0 : 1;
+}
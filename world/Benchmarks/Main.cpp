@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <cstring>
+#include "Benchmark.h"
+
+namespace {
+
+	struct BenchmarkEntry {
+		const char* name;
+		const char* description;
+		int ( *run )( const BenchmarkOptions& options );
+	};
+
+	const BenchmarkEntry benchmarks[] = {
+		{ "object", "ObjectAllocator<T>: latency, throughput, bytes per object, Flush() reclaim", RunObjectAllocatorBenchmark },
+		{ "heap", "small operator new allocations: pool bytes per block, new, sized and unsized delete", RunHeapBenchmark },
+		{ "hugepages", "walk over pooled objects: VirtualChunkProvider with and without huge pages, heap chunk provider", RunHugePagesBenchmark },
+		{ "churn", "random churn across thread counts: operator new and malloc, fragmentation and reclaim", RunChurnBenchmark },
+		{ "contention", "one shared 64 B block allocator, 1 to 64 threads: ThreadCached, Concurrent, mutex + FixedAllocator, malloc", RunContentionBenchmark },
+		{ "threads", "short-lived threads, thread caches must be reclaimed at thread exit", RunThreadExitBenchmark },
+		{ "tracking", "allocation tracking cost and peak live bytes between snapshots", RunTrackingBenchmark },
+		{ "string", "String copy, move, concatenation and Join: latency, throughput, allocations per operation", RunStringBenchmark },
+		{ "replay", "replay of allocation trace [file] (recorded workload when no file is given)", RunReplayBenchmark },
+		{ "accuracy", "MathArray PRECISE (ulp) and FAST (documented absolute/relative error) functions against libm over the whole domain, SinCos == Sin/Cos", RunMathAccuracyBenchmark },
+		{ "math", "Matrix and Vector against DirectXMath reference results, Mul, Inverse, Transform and Normalize cost", RunMathBenchmark },
+		{ "transform", "1M points: Vector::Transform loop against TransformPoints for Float3 and SoA arrays, serial and parallel", RunTransformBenchmark },
+		{ "matrices", "MultiplyMatrices, InverseAffineMatrices and StoreColumnMajor against Matrix::Mul, Inverse and StoreColumnMajor: serial, parallel, streaming, tails of 1-7", RunMatrixArrayBenchmark },
+		{ "hierarchy", "Transform and Quaternion against the Matrix path: StoreMatrix, Mul, Inverse, Slerp, Nlerp; ComposeHierarchy of 256k nodes against Matrix::Mul chains", RunTransformHierarchyBenchmark },
+		{ "culling", "frustum culling of 1M objects: TestSphere and TestBox per object, CullSpheres and CullBoxes serial and parallel", RunCullingBenchmark },
+		{ "bvh", "Bvh over 1M boxes: Build, Refit, frustum, sphere, box and ray queries, Raycast, checked against brute force", RunBvhBenchmark },
+		{ "mips", "mip chain of 4096x4096 and 8192x8192 RGBA8 textures: BOX, KAISER and LANCZOS, linear and sRGB, serial and parallel", RunMipsBenchmark },
+		{ "compression", "RGBA8 -> BC1/BC3 -> DecodeBlock round trip for FAST, NORMAL and HIGH: PSNR floor, serial and parallel output", RunCompressionBenchmark },
+		{ "formats", "DecodePixels, EncodePixels and ConvertTexture round trip for every format: exact 8/16-bit values, sRGB, row pitch, BC", RunFormatsBenchmark },
+		{ "half", "FloatToHalf/HalfToFloat arrays (F16C, SSE2 or scalar) against the scalar functions: bit exact over all halves, float bit patterns and unaligned subarrays", RunHalfBenchmark },
+		{ "colors", "ConvertColors to sRGB for every float in [0, 1]: error against the exact transfer function, SIMD kernel == scalar tail, clamping, decode", RunColorsBenchmark },
+		{ "render", "HandlePool checks and state record/resolve; on Windows 100k DX11 state-setting calls: shared_ptr API and handle API, null program and vertex stream handles", RunRenderStateBenchmark },
+		{ "vertex", "PackNormals and PackTangentFrames: angular error after unpacking against documented bounds, handedness, subarrays and stride", RunVertexBenchmark },
+		{ "packed", "LoadPacked/StorePacked round trip for every overload: counts 0, 1 and odd, unaligned sources, no writes outside the array", RunPackedArrayBenchmark }
+	};
+
+	void PrintUsage() {
+		std::printf( "usage: bench [all | <benchmark>] [--quick] [args]\n" );
+		for ( const BenchmarkEntry& entry : benchmarks ) {
+			std::printf( "  %-10s %s\n", entry.name, entry.description );
+		}
+	}
+}
+
+int main( int argc, char** argv ) {
+	BenchmarkOptions options;
+	options.quick = false;
+	const char* name = "all";
+	for ( int i = 1; i < argc; i++ ) {
+		if ( std::strcmp( argv[ i ], "--quick" ) == 0 ) {
+			options.quick = true;
+		} else if ( std::strcmp( argv[ i ], "--help" ) == 0 ) {
+			PrintUsage();
+			return 0;
+		} else if ( i == 1 ) {
+			name = argv[ i ];
+		} else {
+			options.args.push_back( argv[ i ] );
+		}
+	}
+	bool found = false;
+	int result = 0;
+	for ( const BenchmarkEntry& entry : benchmarks ) {
+		if ( std::strcmp( name, "all" ) != 0 && std::strcmp( name, entry.name ) != 0 ) {
+			continue;
+		}
+		found = true;
+		std::printf( "== %s ==\n", entry.name );
+		std::fflush( stdout );
+		if ( entry.run( options ) != 0 ) {
+			std::printf( "%s FAILED\n", entry.name );
+			result = 1;
+		}
+	}
+	if ( !found ) {
+		PrintUsage();
+		return 1;
+	}
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,528 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Framework/MathArray.h"
+#include "Framework/Simd.h"
+#include "Framework/Vector.h"
+#include "Benchmark.h"
+
+namespace {
+
+	const std::size_t BATCH = 4096;
+
+	inline float FromBits( const uint32_t bits ) {
+		float value;
+		std::memcpy( &value, &bits, sizeof( value ) );
+		return value;
+	}
+
+	/*
+	Chyba vysledku v ulp oproti presnemu vysledku v double (ulp presneho vysledku ve float, vcetne denormalnich cisel).
+	Nekonecno a NaN musi odpovidat presne, jinak je chyba nekonecna.
+	*/
+	double GetUlpError( const float result, const double exact ) {
+		if ( std::isnan( exact ) ) {
+			return std::isnan( result ) ? 0.0 : INFINITY;
+		}
+		// vysledek mimo rozsah float se zaokrouhli na nekonecno
+		const double rounded = static_cast< double >( static_cast< float >( exact ) );
+		if ( std::isinf( rounded ) || std::isinf( result ) ) {
+			return rounded == static_cast< double >( result ) ? 0.0 : INFINITY;
+		}
+		if ( std::isnan( result ) ) {
+			return INFINITY;
+		}
+		int exponent = 0;
+		std::frexp( exact, &exponent );
+		const double ulp = std::ldexp( 1.0, exponent - 24 > -149 ? exponent - 24 : -149 );
+		return std::fabs( static_cast< double >( result ) - exact ) / ulp;
+	}
+
+	// NaN musi odpovidat presne, nekonecno jen presnemu vysledku, ktery je nekonecny i ve float (jinak je chyba nekonecna)
+	bool GetSpecialError( const float result, const double exact, double& error ) {
+		if ( std::isnan( exact ) || std::isnan( result ) ) {
+			error = std::isnan( exact ) && std::isnan( result ) ? 0.0 : INFINITY;
+			return true;
+		}
+		if ( std::isinf( exact ) ) {
+			error = static_cast< double >( result ) == exact ? 0.0 : INFINITY;
+			return true;
+		}
+		if ( std::isinf( result ) && std::isinf( static_cast< float >( exact ) ) ) {
+			error = static_cast< double >( result ) == static_cast< double >( static_cast< float >( exact ) ) ? 0.0 : INFINITY;
+			return true;
+		}
+		return false;
+	}
+
+	// absolutni chyba (FAST Sin, Cos, Log)
+	double GetAbsoluteError( const float result, const double exact ) {
+		double error;
+		if ( GetSpecialError( result, exact, error ) ) {
+			return error;
+		}
+		return std::isinf( result ) ? INFINITY : std::fabs( static_cast< double >( result ) - exact );
+	}
+
+	/*
+	Relativni chyba (FAST Exp, RSqrt, Atan2, Pow) vztazena k max( |exact|, FLT_MIN ): denormalni vysledky maji chybu
+	zaokrouhleni radove 2^-149, ktera relativne k sobe neni omezena. Nekonecny vysledek konecneho presneho vysledku
+	se pocita jako 2^128 (preteceni tesne nad FLT_MAX je tak jen mala chyba).
+	*/
+	double GetRelativeError( const float result, const double exact ) {
+		double error;
+		if ( GetSpecialError( result, exact, error ) ) {
+			return error;
+		}
+		const double value = std::isinf( result ) ? std::copysign( 0x1p128, static_cast< double >( result ) ) : static_cast< double >( result );
+		return std::fabs( value - exact ) / std::fmax( std::fabs( exact ), 0x1p-126 );
+	}
+
+	double UlpError( const float result, const double exact, const float, const float ) {
+		return GetUlpError( result, exact );
+	}
+
+	double AbsoluteError( const float result, const double exact, const float, const float ) {
+		return GetAbsoluteError( result, exact );
+	}
+
+	double RelativeError( const float result, const double exact, const float, const float ) {
+		return GetRelativeError( result, exact );
+	}
+
+	// FAST RSqrt: pro denormalni x muze vracet nekonecno (odhad instrukce rsqrtps), tyto hodnoty se nepocitaji
+	double RSqrtFastError( const float result, const double exact, const float x, const float ) {
+		return x != 0.0f && std::fabs( x ) < 0x1p-126f ? 0.0 : GetRelativeError( result, exact );
+	}
+
+	// FAST Pow: relativni chyba vydelena max( 1, |exponent * log( base )| ), chyba logaritmu se nasobi exponentem
+	double PowFastError( const float result, const double exact, const float base, const float exponent ) {
+		const double scale = std::fmax( 1.0, std::fabs( static_cast< double >( exponent ) * std::log( std::fabs( static_cast< double >( base ) ) ) ) );
+		return GetRelativeError( result, exact ) / scale;
+	}
+
+	using ErrorFunction = double ( * )( const float result, const double exact, const float a, const float b );
+
+	// nejvetsi zmerena chyba funkce a argumenty, pri kterych nastala
+	struct AccuracyResult {
+		double error;
+		float a;
+		float b;
+		std::size_t count;
+	};
+
+	void Update( AccuracyResult& result, const double error, const float a, const float b ) {
+		if ( !( error <= result.error ) ) {
+			result.error = error;
+			result.a = a;
+			result.b = b;
+		}
+		result.count += 1;
+	}
+
+	/*
+	Unarni funkce pro vsechna float cisla intervalu < 0; limit > obou znamenek s krokem stride bitovych vzoru.
+	Krok je lichy, projdou se tak ruzne bity mantisy ve vsech exponentech.
+	*/
+	template <typename Function, typename Reference>
+	AccuracyResult MeasureUnary( const float limit, const uint32_t stride, Function function, Reference reference, const ErrorFunction error = UlpError ) {
+		AccuracyResult result = { 0.0, 0.0f, 0.0f, 0 };
+		std::vector< float > in( BATCH );
+		std::vector< float > out( BATCH );
+		uint32_t limitBits;
+		std::memcpy( &limitBits, &limit, sizeof( limitBits ) );
+		for ( const uint32_t sign : { 0u, 0x80000000u } ) {
+			uint64_t bits = 0;
+			while ( bits <= limitBits ) {
+				std::size_t count = 0;
+				for ( ; count < BATCH && bits <= limitBits; count++, bits += stride ) {
+					in[ count ] = FromBits( static_cast< uint32_t >( bits ) | sign );
+				}
+				function( in.data(), out.data(), count );
+				for ( std::size_t i = 0; i < count; i++ ) {
+					Update( result, error( out[ i ], reference( static_cast< double >( in[ i ] ) ), in[ i ], 0.0f ), in[ i ], 0.0f );
+				}
+			}
+		}
+		return result;
+	}
+
+	/*
+	Binarni funkce:
+	- prvni argument pres vsechna float cisla (krok stride) pri druhem argumentu z fixed
+	- druhy argument pres vsechna float cisla pri prvnim argumentu z fixed
+	- randomCount dvojic nahodnych bitovych vzoru (vsechny kombinace exponentu a znamenek)
+	*/
+	template <typename Function, typename Reference>
+	AccuracyResult MeasureBinary( const std::vector< float >& fixed, const uint32_t stride, const std::size_t randomCount, Function function, Reference reference, const ErrorFunction error = UlpError ) {
+		AccuracyResult result = { 0.0, 0.0f, 0.0f, 0 };
+		std::vector< float > a( BATCH );
+		std::vector< float > b( BATCH );
+		std::vector< float > out( BATCH );
+		const auto check = [ & ]( const std::size_t count ) {
+			function( a.data(), b.data(), out.data(), count );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				Update( result, error( out[ i ], reference( static_cast< double >( a[ i ] ), static_cast< double >( b[ i ] ) ), a[ i ], b[ i ] ), a[ i ], b[ i ] );
+			}
+		};
+		for ( const float value : fixed ) {
+			for ( const bool swap : { false, true } ) {
+				for ( const uint32_t sign : { 0u, 0x80000000u } ) {
+					uint64_t bits = 0;
+					while ( bits <= 0x7f800000u ) {
+						std::size_t count = 0;
+						for ( ; count < BATCH && bits <= 0x7f800000u; count++, bits += stride ) {
+							const float sweep = FromBits( static_cast< uint32_t >( bits ) | sign );
+							a[ count ] = swap ? value : sweep;
+							b[ count ] = swap ? sweep : value;
+						}
+						check( count );
+					}
+				}
+			}
+		}
+		std::mt19937 random( 5 );
+		for ( std::size_t done = 0; done < randomCount; ) {
+			std::size_t count = 0;
+			for ( ; count < BATCH && done < randomCount; count++, done++ ) {
+				a[ count ] = FromBits( random() );
+				b[ count ] = FromBits( random() );
+			}
+			check( count );
+		}
+		return result;
+	}
+
+	// vypise vysledek (chyba v jednotkach unit: ulp, abs, rel), vraci false pri prekroceni dokumentovane chyby
+	bool Report( const char* const name, const AccuracyResult& result, const double bound, const char* const unit = "ulp" ) {
+		const bool passed = result.error <= bound;
+		std::printf(
+			"  %-24s max %.4g %s (bound %.4g) at ( %.9g, %.9g ), %zu values %s\n",
+			name, result.error, unit, bound, result.a, result.b, result.count, passed ? "" : "EXCEEDED"
+		);
+		return passed;
+	}
+
+	// SinCos musi dat stejne bity jako Sin a Cos se stejnou presnosti (|x| <= 8192 s krokem stride, obe znamenka)
+	bool CheckSinCos( const MathAccuracy accuracy, const uint32_t stride ) {
+		std::vector< float > in( BATCH );
+		std::vector< float > sin( BATCH );
+		std::vector< float > cos( BATCH );
+		std::vector< float > sinCos( BATCH * 2 );
+		const uint32_t limitBits = 0x46000000;
+		bool passed = true;
+		for ( const uint32_t sign : { 0u, 0x80000000u } ) {
+			uint64_t bits = 0;
+			while ( bits <= limitBits ) {
+				std::size_t count = 0;
+				for ( ; count < BATCH && bits <= limitBits; count++, bits += stride ) {
+					in[ count ] = FromBits( static_cast< uint32_t >( bits ) | sign );
+				}
+				Math::Sin( in.data(), sin.data(), count, accuracy );
+				Math::Cos( in.data(), cos.data(), count, accuracy );
+				Math::SinCos( in.data(), sinCos.data(), sinCos.data() + BATCH, count, accuracy );
+				passed &= std::memcmp( sin.data(), sinCos.data(), count * sizeof( float ) ) == 0;
+				passed &= std::memcmp( cos.data(), sinCos.data() + BATCH, count * sizeof( float ) ) == 0;
+			}
+		}
+		std::printf( "  %-24s %s\n", accuracy == MathAccuracy::PRECISE ? "SinCos == Sin, Cos" : "SinCos FAST == Sin, Cos", passed ? "bit exact" : "MISMATCH" );
+		return passed;
+	}
+
+	const char* GetSimdName() {
+#if defined( SIMD_AVX2 ) && defined( SIMD_FMA )
+		return "AVX2 + FMA";
+#elif defined( SIMD_AVX2 )
+		return "AVX2";
+#elif defined( SIMD_SSE4 )
+		return "SSE4.1";
+#elif defined( SIMD_SSE2 )
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+}
+
+/*
+Chyby PRECISE (ulp) a FAST (absolutni nebo relativni chyba podle dokumentace) funkci MathArray.h oproti libm v double
+pres cely definicni obor a shoda SinCos se Sin a Cos, vraci 1 pri prekroceni dokumentovane chyby.
+Merena je instrukcni sada, se kterou je prelozen framework (skalarni implementace: SIMD_FORCE_SCALAR).
+Plny beh prochazi kazdy 17. bitovy vzor float (Pow a Atan2 kazdy 69. a 64 milionu nahodnych dvojic), quick kazdy 4099.
+*/
+int RunMathAccuracyBenchmark( const BenchmarkOptions& options ) {
+	const uint32_t stride = options.quick ? 4099 : 17;
+	const std::size_t randomCount = Iterations( options, 64000000 );
+	std::printf( "%s, every %u. float\n", GetSimdName(), stride );
+
+	bool passed = true;
+	const auto precise = MathAccuracy::PRECISE;
+	passed &= Report( "Sin |x| <= 8192", MeasureUnary( 8192.0f, stride,
+		[ precise ]( const float* in, float* out, std::size_t count ) { Math::Sin( in, out, count, precise ); },
+		[]( const double x ) { return std::sin( x ); } ), 2.5 );
+	passed &= Report( "Cos |x| <= 8192", MeasureUnary( 8192.0f, stride,
+		[ precise ]( const float* in, float* out, std::size_t count ) { Math::Cos( in, out, count, precise ); },
+		[]( const double x ) { return std::cos( x ); } ), 2.5 );
+	passed &= Report( "Exp", MeasureUnary( INFINITY, stride,
+		[ precise ]( const float* in, float* out, std::size_t count ) { Math::Exp( in, out, count, precise ); },
+		[]( const double x ) { return std::exp( x ); } ), 1.5 );
+	passed &= Report( "Log", MeasureUnary( INFINITY, stride,
+		[ precise ]( const float* in, float* out, std::size_t count ) { Math::Log( in, out, count, precise ); },
+		[]( const double x ) { return std::log( x ); } ), 1.0 );
+	passed &= Report( "RSqrt", MeasureUnary( INFINITY, stride,
+		[ precise ]( const float* in, float* out, std::size_t count ) { Math::RSqrt( in, out, count, precise ); },
+		[]( const double x ) { return 1.0 / std::sqrt( x ); } ), 1.5 );
+	passed &= Report( "Pow", MeasureBinary( { 2.0f, -1.0f, 0.5f, 3.0f }, stride * 4 + 1, randomCount,
+		[ precise ]( const float* base, const float* exponent, float* out, std::size_t count ) { Math::Pow( base, exponent, out, count, precise ); },
+		[]( const double base, const double exponent ) { return std::pow( base, exponent ); } ), 1.0 );
+	passed &= Report( "Atan2", MeasureBinary( { 1.0f, -1.0f, 3.0e-30f, 7.0e25f }, stride * 4 + 1, randomCount,
+		[ precise ]( const float* y, const float* x, float* out, std::size_t count ) { Math::Atan2( y, x, out, count, precise ); },
+		[]( const double y, const double x ) { return std::atan2( y, x ); } ), 2.5 );
+	passed &= CheckSinCos( precise, stride );
+
+	// FAST: absolutni nebo relativni chyba podle dokumentace funkci
+	const auto fast = MathAccuracy::FAST;
+	passed &= Report( "Sin FAST |x| <= 8192", MeasureUnary( 8192.0f, stride,
+		[ fast ]( const float* in, float* out, std::size_t count ) { Math::Sin( in, out, count, fast ); },
+		[]( const double x ) { return std::sin( x ); }, AbsoluteError ), 1.5e-5, "abs" );
+	passed &= Report( "Cos FAST |x| <= 8192", MeasureUnary( 8192.0f, stride,
+		[ fast ]( const float* in, float* out, std::size_t count ) { Math::Cos( in, out, count, fast ); },
+		[]( const double x ) { return std::cos( x ); }, AbsoluteError ), 1.5e-5, "abs" );
+	passed &= Report( "Exp FAST", MeasureUnary( INFINITY, stride,
+		[ fast ]( const float* in, float* out, std::size_t count ) { Math::Exp( in, out, count, fast ); },
+		[]( const double x ) { return std::exp( x ); }, RelativeError ), std::ldexp( 1.0, -17 ), "rel" );
+	passed &= Report( "Log FAST", MeasureUnary( INFINITY, stride,
+		[ fast ]( const float* in, float* out, std::size_t count ) { Math::Log( in, out, count, fast ); },
+		[]( const double x ) { return std::log( x ); }, AbsoluteError ), 1e-5, "abs" );
+	passed &= Report( "RSqrt FAST", MeasureUnary( INFINITY, stride,
+		[ fast ]( const float* in, float* out, std::size_t count ) { Math::RSqrt( in, out, count, fast ); },
+		[]( const double x ) { return 1.0 / std::sqrt( x ); }, RSqrtFastError ), std::ldexp( 1.0, -21 ), "rel" );
+	passed &= Report( "Pow FAST", MeasureBinary( { 2.0f, -1.0f, 0.5f, 3.0f }, stride * 4 + 1, randomCount,
+		[ fast ]( const float* base, const float* exponent, float* out, std::size_t count ) { Math::Pow( base, exponent, out, count, fast ); },
+		[]( const double base, const double exponent ) { return std::pow( base, exponent ); }, PowFastError ), std::ldexp( 1.0, -15 ), "rel" );
+	passed &= Report( "Atan2 FAST", MeasureBinary( { 1.0f, -1.0f, 3.0e-30f, 7.0e25f }, stride * 4 + 1, randomCount,
+		[ fast ]( const float* y, const float* x, float* out, std::size_t count ) { Math::Atan2( y, x, out, count, fast ); },
+		[]( const double y, const double x ) { return std::atan2( y, x ); }, RelativeError ), std::ldexp( 1.0, -17 ), "rel" );
+	passed &= CheckSinCos( fast, stride );
+	return passed ? 0 : 1;
+}
+
+// shoda Matrix a Vector s DirectXMath
+
+namespace {
+
+	/*
+	Referencni vysledky funkci DirectXMath, ktere Matrix a Vector puvodne volaly
+	(XMMatrixMultiply, XMMatrixInverse, XMVector3Transform, XMVector3Normalize),
+	spocitane v double z float vstupu a zaokrouhlene na float.
+	*/
+	const Matrix CONFORMANCE_MATRICES[] = {
+		// rotace s posunem
+		Matrix(
+			0.8f, 0.36f, -0.48f, 0.0f,
+			-0.6f, 0.48f, -0.64f, 0.0f,
+			0.0f, 0.8f, 0.6f, 0.0f,
+			3.0f, -2.0f, 5.0f, 1.0f
+		),
+		// perspektivni projekce
+		Matrix(
+			1.5f, 0.0f, 0.0f, 0.0f,
+			0.0f, 2.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.001f, 1.0f,
+			0.0f, 0.0f, -0.1001f, 0.0f
+		),
+		// obecna matice
+		Matrix(
+			2.0f, -1.0f, 0.5f, 3.0f,
+			1.0f, 4.0f, -2.0f, 0.25f,
+			0.5f, 1.0f, 3.0f, -1.0f,
+			-2.0f, 0.5f, 1.0f, 2.0f
+		),
+		// nerovnomerne meritko se zkosenim
+		Matrix(
+			3.0f, 0.0f, 0.0f, 0.0f,
+			0.5f, 0.25f, 0.0f, 0.0f,
+			0.0f, -1.0f, 7.0f, 0.0f,
+			-10.0f, 20.0f, 0.125f, 1.0f
+		)
+	};
+
+	struct MulReference {
+		int a;
+		int b;
+		float result[ 16 ];
+	};
+
+	const MulReference MUL_REFERENCES[] = {
+		{ 0, 2, { 1.72000004f, 0.160000056f, -1.75999999f, 2.97000003f, -1.04000005f, 1.88f, -3.17999995f, -1.04000009f, 1.10000002f, 3.80000007f, 0.200000048f, -0.400000021f, 4.5f, -5.5f, 21.5f, 5.5f } },
+		{ 2, 1, { 3.0f, -2.0f, 0.200200014f, 0.5f, 1.5f, 8.0f, -2.02702509f, -2.0f, 0.75f, 2.0f, 3.10310014f, 3.0f, -3.0f, 1.0f, 0.80080004f, 1.0f } },
+		{ 1, 0, { 1.20000002f, 0.540000021f, -0.719999984f, 0.0f, -1.20000005f, 0.959999979f, -1.27999997f, 0.0f, 3.0f, -1.19919995f, 5.60060005f, 1.0f, 0.0f, -0.0800800037f, -0.0600600043f, 0.0f } },
+		{ 3, 3, { 9.0f, 0.0f, 0.0f, 0.0f, 1.625f, 0.0625f, 0.0f, 0.0f, -0.5f, -7.25f, 49.0f, 0.0f, -30.0f, 24.875f, 1.0f, 1.0f } },
+		{ 2, 2, { -2.75f, -4.0f, 7.5f, 11.25f, 4.5f, 13.125f, -13.25f, 6.5f, 5.5f, 6.0f, 6.25f, -3.25f, -7.0f, 6.0f, 3.0f, -2.875f } }
+	};
+
+	struct InverseReference {
+		int matrix;
+		float result[ 16 ];
+	};
+
+	const InverseReference INVERSE_REFERENCES[] = {
+		{ 0, { 0.799999974f, -0.599999994f, -1.4305114e-08f, 0.0f, 0.360000017f, 0.48000001f, 0.799999974f, 0.0f, -0.48000001f, -0.639999998f, 0.599999994f, 0.0f, 0.720000161f, 5.95999999f, -1.39999998f, 1.0f } },
+		{ 1, { 0.666666667f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -9.99000967f, 0.0f, 0.0f, 1.0f, 10.0000001f } },
+		{ 2, { 0.194634598f, 0.0577243293f, 0.0906567993f, -0.253839038f, -0.0392229417f, 0.201295097f, 0.111008326f, 0.0891766883f, 0.041813136f, -0.0636447734f, 0.259019426f, 0.0747456059f, 0.183533765f, 0.0392229417f, -0.0666049954f, 0.186493987f } },
+		{ 3, { 0.333333333f, 1.11022302e-15f, 0.0f, 0.0f, -0.666666667f, 4.0f, 1.08420217e-19f, 0.0f, -0.0952380952f, 0.571428571f, 0.142857143f, 0.0f, 16.6785714f, -80.0714286f, -0.0178571429f, 1.0f } }
+	};
+
+	struct TransformReference {
+		int matrix;
+		float point[ 3 ];
+		float result[ 3 ];
+	};
+
+	const TransformReference TRANSFORM_REFERENCES[] = {
+		{ 0, { 1.0f, 2.0f, 3.0f }, { 2.59999996f, 1.72000003f, 5.04000011f } },
+		{ 0, { -4.5f, 0.25f, 8.0f }, { -0.75000006f, 2.90000003f, 11.8000001f } },
+		{ 0, { 1000.0f, -2000.0f, 0.00100000005f }, { 2003.00006f, -601.999164f, 805.000582f } },
+		{ 0, { 0.0f, 0.0f, 0.0f }, { 3.0f, -2.0f, 5.0f } },
+		{ 2, { 1.0f, 2.0f, 3.0f }, { 3.5f, 10.5f, 6.5f } },
+		{ 2, { -4.5f, 0.25f, 8.0f }, { -6.75f, 14.0f, 22.25f } },
+		{ 2, { 1000.0f, -2000.0f, 0.00100000005f }, { -1.9995f, -8999.499f, 4501.003f } },
+		{ 2, { 0.0f, 0.0f, 0.0f }, { -2.0f, 0.5f, 1.0f } },
+		{ 3, { 1.0f, 2.0f, 3.0f }, { -6.0f, 17.5f, 21.125f } },
+		{ 3, { -4.5f, 0.25f, 8.0f }, { -23.375f, 12.0625f, 56.125f } },
+		{ 3, { 1000.0f, -2000.0f, 0.00100000005f }, { 1990.0f, -480.001f, 0.132f } },
+		{ 3, { 0.0f, 0.0f, 0.0f }, { -10.0f, 20.0f, 0.125f } }
+	};
+
+	struct NormalizeReference {
+		float vector[ 4 ];
+		float result[ 4 ];
+	};
+
+	const NormalizeReference NORMALIZE_REFERENCES[] = {
+		{ { 3.0f, 4.0f, 12.0f, 2.0f }, { 0.230769231f, 0.307692308f, 0.923076923f, 0.153846154f } },
+		{ { -1.0f, 0.00100000005f, 0.5f, 1.0f }, { -0.894426833f, 0.000894426876f, 0.447213417f, 0.894426833f } },
+		{ { 9.99999984e+17f, -1.99999997e+18f, 2.99999988e+18f, 0.0f }, { 0.267261246f, -0.534522492f, 0.801783719f, 0.0f } },
+		{ { 0.0f, 0.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } },
+		{ { 1e-15f, 2.00000001e-15f, -2.00000001e-15f, 0.0f }, { 0.333333333f, 0.666666667f, -0.666666667f, 0.0f } }
+	};
+
+	/*
+	Nejvetsi odchylka vysledku od reference vztazena k nejvetsi absolutni hodnote reference (nejmene 1).
+	Float vysledek se od presneho lisi zaokrouhlenim mezivysledku, DirectXMath stejne.
+	*/
+	double GetConformanceError( const float* const result, const float* const reference, const std::size_t count ) {
+		double scale = 1.0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			scale = std::fmax( scale, std::fabs( static_cast< double >( reference[ i ] ) ) );
+		}
+		double error = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const double difference = std::fabs( static_cast< double >( result[ i ] ) - static_cast< double >( reference[ i ] ) ) / scale;
+			// NaN je nekonecna chyba (fmax by ho ignorovalo)
+			error = std::fmax( error, difference <= INFINITY ? difference : INFINITY );
+		}
+		return error;
+	}
+
+	bool ReportConformance( const char* const name, const double error, const double bound ) {
+		const bool passed = error <= bound;
+		std::printf( "  %-24s max relative error %.2e (bound %.1e) %s\n", name, error, bound, passed ? "" : "EXCEEDED" );
+		return passed;
+	}
+
+	bool CheckConformance() {
+		double mulError = 0;
+		for ( const MulReference& reference : MUL_REFERENCES ) {
+			Matrix result = CONFORMANCE_MATRICES[ reference.a ];
+			result.Mul( CONFORMANCE_MATRICES[ reference.b ] );
+			mulError = std::fmax( mulError, GetConformanceError( &result.m[ 0 ][ 0 ], reference.result, 16 ) );
+		}
+		double inverseError = 0;
+		for ( const InverseReference& reference : INVERSE_REFERENCES ) {
+			Matrix result = CONFORMANCE_MATRICES[ reference.matrix ];
+			result.Inverse();
+			inverseError = std::fmax( inverseError, GetConformanceError( &result.m[ 0 ][ 0 ], reference.result, 16 ) );
+		}
+		double transformError = 0;
+		for ( const TransformReference& reference : TRANSFORM_REFERENCES ) {
+			Vector result( reference.point[ 0 ], reference.point[ 1 ], reference.point[ 2 ], 0 );
+			result.Transform( CONFORMANCE_MATRICES[ reference.matrix ] );
+			transformError = std::fmax( transformError, GetConformanceError( &result.x, reference.result, 3 ) );
+			// w vysledku je vynulovano
+			transformError = result.w == 0 ? transformError : INFINITY;
+		}
+		double normalizeError = 0;
+		for ( const NormalizeReference& reference : NORMALIZE_REFERENCES ) {
+			Vector result( reference.vector[ 0 ], reference.vector[ 1 ], reference.vector[ 2 ], reference.vector[ 3 ] );
+			result.Normalize();
+			normalizeError = std::fmax( normalizeError, GetConformanceError( &result.x, reference.result, 4 ) );
+		}
+		bool passed = true;
+		passed &= ReportConformance( "Matrix::Mul", mulError, 2.5e-7 );
+		passed &= ReportConformance( "Matrix::Inverse", inverseError, 1e-6 );
+		passed &= ReportConformance( "Vector::Transform", transformError, 2.5e-7 );
+		passed &= ReportConformance( "Vector::Normalize", normalizeError, 2.5e-7 );
+		return passed;
+	}
+
+	// count operaci nad polem MATRICES_COUNT matic (v L1 cache), vypise ns na operaci
+	const std::size_t MATRICES_COUNT = 256;
+
+	template <typename Function>
+	void MeasureOperation( const char* const name, const std::size_t count, Function function ) {
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			function( i % MATRICES_COUNT );
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		std::printf( "  %-24s %6.2f ns/op\n", name, seconds * 1e9 / static_cast< double >( count ) );
+	}
+}
+
+/*
+Matrix a Vector proti referencnim vysledkum DirectXMath (chyba vztazena k velikosti vysledku)
+a doba Mul, Inverse, Transform a Normalize. Vraci 1 pri prekroceni povolene odchylky.
+Merena je instrukcni sada, se kterou je prelozen bench, ctest spousti i varianty bench_scalar, bench_sse4 a bench_avx2.
+*/
+int RunMathBenchmark( const BenchmarkOptions& options ) {
+	std::printf( "%s\n", GetSimdName() );
+	const bool passed = CheckConformance();
+
+	const std::size_t count = Iterations( options, 16000000 );
+	std::vector< Matrix > matrices( MATRICES_COUNT );
+	std::vector< Vector > vectors( MATRICES_COUNT );
+	std::mt19937 random( 11 );
+	std::uniform_real_distribution< float > distribution( -1.0f, 1.0f );
+	for ( std::size_t i = 0; i < MATRICES_COUNT; i++ ) {
+		matrices[ i ] = CONFORMANCE_MATRICES[ i % 4 ];
+		matrices[ i ].m30 += distribution( random );
+		vectors[ i ] = Vector( distribution( random ), distribution( random ), distribution( random ), 0 );
+	}
+	std::printf( "%zu operations\n", count );
+	Matrix accumulator;
+	MeasureOperation( "Matrix::Mul", count, [ & ]( const std::size_t i ) {
+		accumulator = matrices[ i ];
+		accumulator.Mul( matrices[ ( i + 1 ) % MATRICES_COUNT ] );
+		DoNotOptimize( &accumulator );
+	} );
+	MeasureOperation( "Matrix::Inverse", count, [ & ]( const std::size_t i ) {
+		accumulator = matrices[ i ];
+		accumulator.Inverse();
+		DoNotOptimize( &accumulator );
+	} );
+	Vector vector;
+	MeasureOperation( "Vector::Transform", count, [ & ]( const std::size_t i ) {
+		vector = vectors[ i ];
+		vector.Transform( matrices[ i ] );
+		DoNotOptimize( &vector );
+	} );
+	MeasureOperation( "Vector::Normalize", count, [ & ]( const std::size_t i ) {
+		vector = vectors[ i ];
+		vector.Normalize();
+		DoNotOptimize( &vector );
+	} );
+	return passed ? 0 : 1;
+}
\ No newline at end of file
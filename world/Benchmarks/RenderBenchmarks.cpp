@@ -0,0 +1,258 @@
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "Core/Windows/ComPtr.h"
+#include "Framework/HandlePool.h"
+#include "Benchmark.h"
+
+// HandlePool a ComPtr (bez DX11 zarizeni, na vsech platformach)
+
+namespace {
+
+	// objekt s pocitanim referenci jako COM objekt, kontroluje reference drzene pres ComPtr v HandlePool
+	struct CountedObject {
+		int references = 1;
+
+		unsigned long AddRef() {
+			return static_cast< unsigned long >( ++references );
+		}
+
+		unsigned long Release() {
+			return static_cast< unsigned long >( --references );
+		}
+	};
+
+	/*
+	Platnost handle po Remove() a Clear(), znovupouziti slotu s novou generaci (i po preteceni generace, handle 0 se nevyda)
+	a vyvazene reference ComPtr v poolu (registrace v DX11 zarizeni drzi objekt pres ComPtr( T* )).
+	*/
+	bool CheckHandlePool() {
+		using Pool = HandlePool< ComPtr< CountedObject > >;
+		CountedObject object;
+		bool passed = true;
+		{
+			Pool pool;
+			const Pool::HandleType handle = pool.Add( ComPtr< CountedObject >( &object ) );
+			passed &= object.references == 2 && pool.IsValid( handle ) && pool.Resolve( handle ).Raw() == &object;
+			passed &= !pool.IsValid( Pool::HandleType() ) && pool.Get( Pool::HandleType() ) == nullptr;
+			passed &= pool.Remove( handle ) && object.references == 1 && !pool.IsValid( handle ) && pool.Get( handle ) == nullptr && !pool.Remove( handle );
+
+			Pool::HandleType last = pool.Add( ComPtr< CountedObject >( &object ) );
+			passed &= last.GetIndex() == handle.GetIndex() && last != handle && !pool.IsValid( handle );
+			for ( uint32_t i = 0; i <= HANDLE_GENERATION_MASK; i++ ) {
+				passed &= pool.Remove( last );
+				last = pool.Add( ComPtr< CountedObject >( &object ) );
+				passed &= !last.IsNull() && last.GetGeneration() != 0 && pool.IsValid( last );
+			}
+			const Pool::HandleType second = pool.Add( ComPtr< CountedObject >( &object ) );
+			passed &= object.references == 3 && pool.GetCount() == 2;
+			pool.Clear();
+			passed &= object.references == 1 && pool.GetCount() == 0 && !pool.IsValid( last ) && !pool.IsValid( second );
+			const Pool::HandleType third = pool.Add( ComPtr< CountedObject >( &object ) );
+			passed &= pool.IsValid( third ) && object.references == 2;
+		}
+		passed &= object.references == 1;
+		std::printf( "  %-40s %s\n", "HandlePool< ComPtr > handles, references", passed ? "valid" : "MISMATCH" );
+		return passed;
+	}
+
+	// objekt rozhrani a jeho implementace (jako RenderInterface::BlendState a Directx11RenderInterface::BlendState)
+	class StateInterface {
+	public:
+		virtual ~StateInterface() {}
+	};
+
+	class StateImplementation: public StateInterface {
+	public:
+		explicit StateImplementation( CountedObject* const native ): native( native ) {}
+
+		CountedObject* GetNative() const {
+			return native;
+		}
+
+	private:
+		CountedObject* native;
+	};
+
+	/*
+	Zaznam count nastaveni stavu do pole prikazu (kopie shared_ptr s pocitanim referenci proti kopii 32 bit handle)
+	a nasledne ziskani nativniho objektu (static_cast jako down_cast proti Resolve()), vypise ns na volani.
+	*/
+	void MeasureResolve( const std::size_t count ) {
+		CountedObject natives[ 2 ];
+		const std::shared_ptr< StateInterface > states[ 2 ] = {
+			std::make_shared< StateImplementation >( &natives[ 0 ] ),
+			std::make_shared< StateImplementation >( &natives[ 1 ] )
+		};
+		HandlePool< ComPtr< CountedObject >, StateInterface > pool;
+		const Handle< StateInterface > handles[ 2 ] = { pool.Add( ComPtr< CountedObject >( &natives[ 0 ] ) ), pool.Add( ComPtr< CountedObject >( &natives[ 1 ] ) ) };
+
+		std::vector< std::shared_ptr< StateInterface > > pointerCommands;
+		std::vector< Handle< StateInterface > > handleCommands;
+		pointerCommands.reserve( count );
+		handleCommands.reserve( count );
+
+		BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			pointerCommands.push_back( states[ i & 1 ] );
+		}
+		CountedObject* current = nullptr;
+		for ( const std::shared_ptr< StateInterface >& state : pointerCommands ) {
+			current = static_cast< StateImplementation* >( state.get() )->GetNative();
+			DoNotOptimize( current );
+		}
+		const double pointerSeconds = Seconds( begin, BenchmarkClock::now() );
+
+		begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			handleCommands.push_back( handles[ i & 1 ] );
+		}
+		for ( const Handle< StateInterface > handle : handleCommands ) {
+			current = pool.Resolve( handle ).Raw();
+			DoNotOptimize( current );
+		}
+		const double handleSeconds = Seconds( begin, BenchmarkClock::now() );
+
+		std::printf( "  %-40s %6.1f ns/call\n", "record + resolve, shared_ptr", pointerSeconds * 1e9 / static_cast< double >( count ) );
+		std::printf( "  %-40s %6.1f ns/call\n", "record + resolve, handle", handleSeconds * 1e9 / static_cast< double >( count ) );
+	}
+}
+
+#ifdef _WIN32
+#include <d3d11.h>
+#include <dxgi1_2.h>
+#include "Core/Windows/WindowsGraphicsInfrastructure.h"
+
+namespace {
+
+	// dvojice ruznych stavu, aby CommandInterface nefiltroval opakovane nastaveni stejneho stavu
+	struct StatePair {
+		RenderInterface::PBlendState blend[ 2 ];
+		RenderInterface::PRasterizerState rasterizer[ 2 ];
+		RenderInterface::PDepthStencilState depthStencil[ 2 ];
+		RenderInterface::BlendStateHandle blendHandle[ 2 ];
+		RenderInterface::RasterizerStateHandle rasterizerHandle[ 2 ];
+		RenderInterface::DepthStencilStateHandle depthStencilHandle[ 2 ];
+	};
+
+	bool CreateStates( RenderInterface::Device& device, StatePair& states ) {
+		for ( int i = 0; i < 2; i++ ) {
+			RenderInterface::BlendStateParams blend = {};
+			blend.uniformBlending = true;
+			blend.renderTargets[ 0 ].enable = i == 1;
+			blend.renderTargets[ 0 ].srcRGB = RenderInterface::Blend::SRC_ALPHA;
+			blend.renderTargets[ 0 ].destRGB = RenderInterface::Blend::INV_SRC_ALPHA;
+			blend.renderTargets[ 0 ].opRGB = RenderInterface::BlendOp::ADD;
+			blend.renderTargets[ 0 ].srcAlpha = RenderInterface::Blend::ONE;
+			blend.renderTargets[ 0 ].destAlpha = RenderInterface::Blend::ZERO;
+			blend.renderTargets[ 0 ].opAlpha = RenderInterface::BlendOp::ADD;
+			states.blend[ i ] = device.CreateBlendState( blend );
+
+			RenderInterface::RasterizerStateParams rasterizer = {};
+			rasterizer.cullMode = i == 0 ? RenderInterface::CullMode::BACK_FACE : RenderInterface::CullMode::DISABLED;
+			rasterizer.depthClipping = true;
+			states.rasterizer[ i ] = device.CreateRasterizerState( rasterizer );
+
+			RenderInterface::DepthStencilStateParams depthStencil = {};
+			depthStencil.depthUsage = i == 0 ? RenderInterface::DepthStencilUsage::STANDARD : RenderInterface::DepthStencilUsage::READONLY;
+			depthStencil.stencilUsage = RenderInterface::DepthStencilUsage::DISABLED;
+			depthStencil.depthFunc = RenderInterface::DepthStencilComparsion::LESS;
+			depthStencil.stencilFunc = RenderInterface::DepthStencilComparsion::ALWAYS;
+			depthStencil.stencilPassOp = RenderInterface::StencilOperation::KEEP;
+			depthStencil.stencilFailOp = RenderInterface::StencilOperation::KEEP;
+			depthStencil.stencilDepthFailOp = RenderInterface::StencilOperation::KEEP;
+			states.depthStencil[ i ] = device.CreateDepthStencilState( depthStencil );
+
+			if ( states.blend[ i ] == nullptr || states.rasterizer[ i ] == nullptr || states.depthStencil[ i ] == nullptr ) {
+				return false;
+			}
+			states.blendHandle[ i ] = device.RegisterBlendState( states.blend[ i ] );
+			states.rasterizerHandle[ i ] = device.RegisterRasterizerState( states.rasterizer[ i ] );
+			states.depthStencilHandle[ i ] = device.RegisterDepthStencilState( states.depthStencil[ i ] );
+		}
+		return true;
+	}
+
+	// count volani function( i ), vypise ns na volani
+	template <typename Function>
+	void Measure( const char* const name, const std::size_t count, Function function ) {
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			function( i );
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		std::printf( "  %-40s %6.1f ns/call\n", name, seconds * 1e9 / static_cast< double >( count ) );
+	}
+}
+
+/*
+Kontrola HandlePool a zaznam stavu pres shared_ptr a handle bez zarizeni, pak nastaveni stavu pres shared_ptr API a handle API
+(100k volani, stridani dvou stavu a opakovani stejneho stavu), neplatny handle programu a vertex streamu (odpojeni).
+Vyzaduje DX11 zarizeni na vychozim adapteru.
+*/
+int RunRenderStateBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 100000 );
+	if ( !CheckHandlePool() ) {
+		return 1;
+	}
+	MeasureResolve( count );
+	ComPtr< IDXGIFactory1 > factory;
+	if ( FAILED( CreateDXGIFactory1( __uuidof( IDXGIFactory1 ), reinterpret_cast< void** >( &factory ) ) ) ) {
+		std::printf( "CreateDXGIFactory1() failed\n" );
+		return 1;
+	}
+	ComPtr< IDXGIAdapter1 > dxgiAdapter;
+	if ( factory->EnumAdapters1( 0, &dxgiAdapter ) == DXGI_ERROR_NOT_FOUND ) {
+		std::printf( "no DXGI adapter\n" );
+		return 1;
+	}
+	WindowsAdapter adapter( dxgiAdapter );
+	std::shared_ptr< Directx11RenderInterface::Device > device = adapter.CreateDirectx11Device();
+	if ( device == nullptr ) {
+		std::printf( "failed to create DX11 device\n" );
+		return 1;
+	}
+	StatePair states;
+	if ( !CreateStates( *device, states ) ) {
+		std::printf( "failed to create states\n" );
+		return 1;
+	}
+	RenderInterface::PCommandInterface commands = device->CreateCommandInterface();
+	if ( commands == nullptr ) {
+		std::printf( "failed to create command interface\n" );
+		return 1;
+	}
+	commands->Begin( device );
+	std::printf( "%zu calls\n", count );
+
+	Measure( "SetBlendState( PBlendState )", count, [ & ]( const std::size_t i ) { commands->SetBlendState( states.blend[ i & 1 ] ); } );
+	Measure( "SetBlendState( BlendStateHandle )", count, [ & ]( const std::size_t i ) { commands->SetBlendState( states.blendHandle[ i & 1 ] ); } );
+	Measure( "SetRasterizerState( PRasterizerState )", count, [ & ]( const std::size_t i ) { commands->SetRasterizerState( states.rasterizer[ i & 1 ] ); } );
+	Measure( "SetRasterizerState( handle )", count, [ & ]( const std::size_t i ) { commands->SetRasterizerState( states.rasterizerHandle[ i & 1 ] ); } );
+	Measure( "SetDepthStencilState( PDepthStencilState )", count, [ & ]( const std::size_t i ) { commands->SetDepthStencilState( states.depthStencil[ i & 1 ], 0 ); } );
+	Measure( "SetDepthStencilState( handle )", count, [ & ]( const std::size_t i ) { commands->SetDepthStencilState( states.depthStencilHandle[ i & 1 ], 0 ); } );
+
+	// stejny stav, meri se jen predani objektu a porovnani s aktualnim stavem
+	Measure( "same blend state, PBlendState", count, [ & ]( const std::size_t ) { commands->SetBlendState( states.blend[ 0 ] ); } );
+	Measure( "same blend state, BlendStateHandle", count, [ & ]( const std::size_t ) { commands->SetBlendState( states.blendHandle[ 0 ] ); } );
+
+	// neplatny handle odpoji program a vertex stream
+	Measure( "SetRenderProgram( null handle )", count, [ & ]( const std::size_t ) { commands->SetRenderProgram( RenderInterface::RenderProgramHandle() ); } );
+	Measure( "SetVertexStream( null handle )", count, [ & ]( const std::size_t ) { commands->SetVertexStream( RenderInterface::VertexStreamHandle() ); } );
+
+	commands->End();
+	return 0;
+}
+
+#else
+
+// bez DX11 jen kontrola HandlePool a zaznam stavu bez zarizeni
+int RunRenderStateBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 100000 );
+	std::printf( "%zu calls, DX11 device part requires Windows\n", count );
+	const bool passed = CheckHandlePool();
+	MeasureResolve( count );
+	return passed ? 0 : 1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include <cstdio>
+#include "Framework/AllocationTracking.h"
+#include "Framework/String.h"
+#include "Benchmark.h"
+
+namespace {
+
+	// pocet alokaci operatoru new vsech tagu od startu aplikace
+	uint64_t GetAllocationsCount() {
+		AllocationSnapshot snapshot;
+		GetAllocationSnapshot( snapshot );
+		uint64_t count = 0;
+		for ( const AllocationTagStats& stats : snapshot.tags ) {
+			count += stats.allocations;
+		}
+		return count;
+	}
+
+	// vytvori retezec length znaku
+	String MakeString( const int length ) {
+		String result;
+		result.Alloc( length + 1 );
+		for ( int i = 0; i < length; i++ ) {
+			result.Append( String( u"x" ) );
+		}
+		return result;
+	}
+
+	/*
+	Zmeri operaci function( i ) count krat: latence kazdeho volani, propustnost a pocet alokaci na operaci.
+	Propustnost se meri samostatnym behem bez mereni latenci.
+	*/
+	template <typename Function>
+	void Measure( const char* const name, const std::size_t count, Function function ) {
+		LatencyRecorder latency( count );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const BenchmarkClock::time_point begin = BenchmarkClock::now();
+			function( i );
+			latency.Add( Nanoseconds( begin, BenchmarkClock::now() ) );
+		}
+		const uint64_t allocations = GetAllocationsCount();
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( std::size_t i = 0; i < count; i++ ) {
+			function( i );
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		const double perOperation = static_cast< double >( GetAllocationsCount() - allocations ) / static_cast< double >( count );
+		latency.Print( name );
+		std::printf( "  %-24s %.2f Mops/s, %.2f allocations per operation\n", "", count / seconds / 1e6, perOperation );
+	}
+}
+
+/*
+String: kratke retezce (do SHORT_LENGTH znaku) nealokuji, dlouhe alokuji operatorem new.
+Meri vytvoreni, kopii, move, spojeni a Join kratkych i dlouhych retezcu.
+*/
+int RunStringBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 500000 );
+	const String shortString = MakeString( 32 );
+	const String longString = MakeString( 1000 );
+	const String separator( u", " );
+
+	for ( const String* source : { &shortString, &longString } ) {
+		std::printf( "%d characters, %zu operations\n", source->Length(), count );
+		Measure( "copy", count, [ & ]( const std::size_t ) {
+			String copy( *source );
+			DoNotOptimize( copy.Raw() );
+		} );
+		Measure( "copy + move", count, [ & ]( const std::size_t ) {
+			String copy( *source );
+			String moved( static_cast< String&& >( copy ) );
+			DoNotOptimize( moved.Raw() );
+		} );
+		Measure( "operator+", count, [ & ]( const std::size_t ) {
+			String joined = *source + *source;
+			DoNotOptimize( joined.Raw() );
+		} );
+		Measure( "Append x4", count, [ & ]( const std::size_t ) {
+			String result( *source );
+			for ( int i = 0; i < 3; i++ ) {
+				result.Append( *source );
+			}
+			DoNotOptimize( result.Raw() );
+		} );
+		Measure( "substring", count, [ & ]( const std::size_t i ) {
+			String part( *source, static_cast< int >( i % 8 ), source->Length() / 2 );
+			DoNotOptimize( part.Raw() );
+		} );
+	}
+
+	// Join 16 retezcu ruzne delky
+	String parts[ 16 ];
+	for ( int i = 0; i < 16; i++ ) {
+		parts[ i ] = MakeString( 4 + i * 8 );
+	}
+	std::printf( "Join of 16 strings, %zu operations\n", count / 4 );
+	Measure( "Join", count / 4, [ & ]( const std::size_t ) {
+		String result;
+		String::Join( parts, 16, separator, result );
+		DoNotOptimize( result.Raw() );
+	} );
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,891 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Core/BlockCompression.h"
+#include "Core/FormatConversion.h"
+#include "Core/MipGenerator.h"
+#include "Framework/ColorArray.h"
+#include "Framework/Half.h"
+#include "Framework/Parallel.h"
+#include "Framework/Simd.h"
+#include "Benchmark.h"
+
+using namespace RenderInterface;
+
+// mip mapy
+
+namespace {
+
+	// mip retezec 2D textury R8G8B8A8_UNORM, mips[ i ] je uroven i + 1
+	struct MipChain {
+		int width;
+		int height;
+		int levels;
+		std::vector< std::vector< uint8_t > > data;
+		std::vector< void* > mips;
+
+		MipChain( const int width, const int height ): width( width ), height( height ), levels( GetMipLevelsCount( width, height ) ) {
+			data.resize( static_cast< std::size_t >( levels - 1 ) );
+			for ( int level = 1; level < levels; level++ ) {
+				data[ level - 1 ].resize( static_cast< std::size_t >( GetMipDataSize( Format::R8G8B8A8_UNORM, width, height, level ) ) );
+				mips.push_back( data[ level - 1 ].data() );
+			}
+		}
+	};
+
+	// prechody barev se sumem (ostre hrany i plynule oblasti), alfa je sachovnice
+	std::vector< uint8_t > MakeImage( const int width, const int height ) {
+		std::vector< uint8_t > image( static_cast< std::size_t >( width ) * height * 4 );
+		std::mt19937 random( 37 );
+		for ( int y = 0; y < height; y++ ) {
+			for ( int x = 0; x < width; x++ ) {
+				uint8_t* const pixel = &image[ ( static_cast< std::size_t >( y ) * width + x ) * 4 ];
+				const uint32_t noise = random();
+				pixel[ 0 ] = static_cast< uint8_t >( x * 255 / width );
+				pixel[ 1 ] = static_cast< uint8_t >( y * 255 / height );
+				pixel[ 2 ] = static_cast< uint8_t >( noise & 0xff );
+				pixel[ 3 ] = ( ( x >> 4 ) ^ ( y >> 4 ) ) & 1 ? 255 : 0;
+			}
+		}
+		return image;
+	}
+
+	const char* GetFilterName( const MipFilter filter ) {
+		switch ( filter ) {
+		case MipFilter::BOX:		return "BOX";
+		case MipFilter::KAISER:		return "KAISER";
+		default:					return "LANCZOS";
+		}
+	}
+
+	/*
+	Konstantni textura s lichymi rozmery musi mit konstantni vsechny mip urovne (vahy filtru jsou normalizovane),
+	pro vsechny filtry a adresovani.
+	*/
+	bool CheckConstantMips() {
+		const int width = 37;
+		const int height = 19;
+		const uint8_t color[ 4 ] = { 100, 7, 250, 128 };
+		std::vector< uint8_t > image( static_cast< std::size_t >( width ) * height * 4 );
+		for ( std::size_t i = 0; i < image.size(); i++ ) {
+			image[ i ] = color[ i % 4 ];
+		}
+		bool passed = true;
+		for ( const MipFilter filter : { MipFilter::BOX, MipFilter::KAISER, MipFilter::LANCZOS } ) {
+			for ( const TextureAddressing addressing : { TextureAddressing::WRAP, TextureAddressing::MIRROR, TextureAddressing::CLAMP } ) {
+				MipChain chain( width, height );
+				const MipGeneratorParams params = { filter, addressing, false, false, false };
+				passed &= GenerateMips( Format::R8G8B8A8_UNORM, width, height, chain.levels, image.data(), chain.mips.data(), params );
+				for ( const std::vector< uint8_t >& level : chain.data ) {
+					for ( std::size_t i = 0; i < level.size(); i++ ) {
+						passed &= level[ i ] == color[ i % 4 ];
+					}
+				}
+			}
+		}
+		std::printf( "  constant 37x19 texture, all filters and addressing modes: %s\n", passed ? "constant mips" : "MISMATCH" );
+		return passed;
+	}
+}
+
+/*
+Mip retezec textur R8G8B8A8_UNORM 4096x4096 a 8192x8192 (quick 512x512 a 1024x1024) pro filtry BOX, KAISER a LANCZOS,
+linearni a sRGB barvy, serialne a paralelne. Vraci 1, pokud se paralelni vysledek lisi od serioveho
+nebo konstantni textura nema konstantni mip urovne.
+*/
+int RunMipsBenchmark( const BenchmarkOptions& options ) {
+	std::printf( "R8G8B8A8_UNORM, %u threads\n", GetParallelThreadsCount() );
+	bool passed = CheckConstantMips();
+	for ( const int size : { 4096, 8192 } ) {
+		const int dimension = options.quick ? size / 8 : size;
+		const std::vector< uint8_t > image = MakeImage( dimension, dimension );
+		MipChain serial( dimension, dimension );
+		MipChain parallel( dimension, dimension );
+		for ( const MipFilter filter : { MipFilter::BOX, MipFilter::KAISER, MipFilter::LANCZOS } ) {
+			for ( const bool srgb : { false, true } ) {
+				MipGeneratorParams params = { filter, TextureAddressing::WRAP, srgb, false, false };
+				BenchmarkClock::time_point begin = BenchmarkClock::now();
+				passed &= GenerateMips( Format::R8G8B8A8_UNORM, dimension, dimension, serial.levels, image.data(), serial.mips.data(), params );
+				const double serialSeconds = Seconds( begin, BenchmarkClock::now() );
+
+				params.parallel = true;
+				begin = BenchmarkClock::now();
+				passed &= GenerateMips( Format::R8G8B8A8_UNORM, dimension, dimension, parallel.levels, image.data(), parallel.mips.data(), params );
+				const double parallelSeconds = Seconds( begin, BenchmarkClock::now() );
+
+				bool equal = true;
+				for ( std::size_t level = 0; level < serial.data.size(); level++ ) {
+					equal &= serial.data[ level ] == parallel.data[ level ];
+				}
+				passed &= equal;
+				std::printf(
+					"  %4dx%-4d %-8s %-6s serial %8.1f ms  parallel %8.1f ms  %6.1f Mpixel/s %s\n",
+					dimension, dimension, GetFilterName( filter ), srgb ? "sRGB" : "linear",
+					serialSeconds * 1e3, parallelSeconds * 1e3,
+					static_cast< double >( dimension ) * dimension / parallelSeconds / 1e6,
+					equal ? "" : "PARALLEL MISMATCH"
+				);
+			}
+		}
+	}
+	return passed ? 0 : 1;
+}
+
+// komprese BC1 a BC3
+
+namespace {
+
+	// plynule prechody (stejne strme pro vsechny rozmery) se sumem +-8, alfa je pomalejsi prechod bez sumu
+	std::vector< uint8_t > MakeCompressionImage( const int width, const int height ) {
+		std::vector< uint8_t > image( static_cast< std::size_t >( width ) * height * 4 );
+		std::mt19937 random( 41 );
+		std::uniform_int_distribution< int > noise( -8, 8 );
+		const auto wave = []( const double phase ) { return static_cast< int >( 128.0 + 96.0 * std::sin( phase ) ); };
+		const auto clamp = []( const int value ) { return static_cast< uint8_t >( value < 0 ? 0 : ( value > 255 ? 255 : value ) ); };
+		for ( int y = 0; y < height; y++ ) {
+			for ( int x = 0; x < width; x++ ) {
+				uint8_t* const pixel = &image[ ( static_cast< std::size_t >( y ) * width + x ) * 4 ];
+				pixel[ 0 ] = clamp( wave( x * 0.05 ) + noise( random ) );
+				pixel[ 1 ] = clamp( wave( y * 0.04 + 1.0 ) + noise( random ) );
+				pixel[ 2 ] = clamp( wave( ( x + y ) * 0.03 + 2.0 ) + noise( random ) );
+				pixel[ 3 ] = clamp( wave( ( x - y ) * 0.02 ) );
+			}
+		}
+		return image;
+	}
+
+	/*
+	Dekomprese textury funkci DecodeBlock() a PSNR oproti zdroji (RGB pro BC1, RGBA pro BC3).
+	BC1 alfa se neporovnava, zdroj ma pro BC1 alfu 255 (zadne pruhledne pixely).
+	*/
+	double GetCompressionPsnr( const Format format, const int width, const int height, const std::vector< uint8_t >& image, const std::vector< uint8_t >& compressed ) {
+		const FormatInfo info = GetFormatInfo( format );
+		const int blocksX = ( width + 3 ) / 4;
+		const int blocksY = ( height + 3 ) / 4;
+		const int channels = format == Format::BC1 ? 3 : 4;
+		double squaredError = 0;
+		for ( int by = 0; by < blocksY; by++ ) {
+			for ( int bx = 0; bx < blocksX; bx++ ) {
+				UNorm4x8 pixels[ 16 ];
+				if ( !DecodeBlock( format, &compressed[ static_cast< std::size_t >( by * blocksX + bx ) * info.blockByteWidth ], pixels ) ) {
+					return 0;
+				}
+				for ( int y = by * 4; y < by * 4 + 4 && y < height; y++ ) {
+					for ( int x = bx * 4; x < bx * 4 + 4 && x < width; x++ ) {
+						const uint8_t* const decoded = &pixels[ ( y - by * 4 ) * 4 + x - bx * 4 ].x;
+						const uint8_t* const original = &image[ ( static_cast< std::size_t >( y ) * width + x ) * 4 ];
+						for ( int c = 0; c < channels; c++ ) {
+							const double difference = static_cast< double >( decoded[ c ] ) - original[ c ];
+							squaredError += difference * difference;
+						}
+					}
+				}
+			}
+		}
+		const double mse = squaredError / ( static_cast< double >( width ) * height * channels );
+		return mse > 0 ? 10.0 * std::log10( 255.0 * 255.0 / mse ) : INFINITY;
+	}
+
+	const char* GetQualityName( const BlockCompressionQuality quality ) {
+		switch ( quality ) {
+		case BlockCompressionQuality::FAST:		return "FAST";
+		case BlockCompressionQuality::NORMAL:	return "NORMAL";
+		default:								return "HIGH";
+		}
+	}
+
+	// nejmensi PSNR pro obrazek MakeCompressionImage() (BC1 a BC3 pro kvality FAST, NORMAL, HIGH)
+	double GetPsnrFloor( const Format format, const BlockCompressionQuality quality ) {
+		const double bc1[] = { 33.0, 34.0, 34.0 };
+		const double bc3[] = { 34.0, 35.0, 35.0 };
+		return ( format == Format::BC1 ? bc1 : bc3 )[ static_cast< int >( quality ) ];
+	}
+}
+
+/*
+Komprese RGBA8 do BC1 a BC3 a dekomprese DecodeBlock() pro kvality FAST, NORMAL a HIGH: textura 1024x1024 (quick 256x256)
+a male textury s rozmery, ktere nejsou nasobkem bloku (37x19, 5x3, 1x1). Vraci 1, pokud PSNR klesne pod mez
+nebo se paralelni komprese lisi od seriove.
+*/
+int RunCompressionBenchmark( const BenchmarkOptions& options ) {
+	const int size = options.quick ? 256 : 1024;
+	const int sizes[][ 2 ] = { { size, size }, { 37, 19 }, { 5, 3 }, { 1, 1 } };
+	std::printf( "%u threads\n", GetParallelThreadsCount() );
+	bool passed = true;
+	for ( const auto& dimensions : sizes ) {
+		const int width = dimensions[ 0 ];
+		const int height = dimensions[ 1 ];
+		for ( const Format format : { Format::BC1, Format::BC3 } ) {
+			std::vector< uint8_t > image = MakeCompressionImage( width, height );
+			if ( format == Format::BC1 ) {
+				for ( std::size_t i = 3; i < image.size(); i += 4 ) {
+					image[ i ] = 255;
+				}
+			}
+			const std::size_t bytes = static_cast< std::size_t >( GetMipDataSize( format, width, height, 0 ) );
+			std::vector< uint8_t > serial( bytes );
+			std::vector< uint8_t > parallel( bytes );
+			for ( const BlockCompressionQuality quality : { BlockCompressionQuality::FAST, BlockCompressionQuality::NORMAL, BlockCompressionQuality::HIGH } ) {
+				BlockCompressionParams params = { format, quality, false };
+				BenchmarkClock::time_point begin = BenchmarkClock::now();
+				passed &= CompressTexture( width, height, image.data(), serial.data(), params );
+				const double serialSeconds = Seconds( begin, BenchmarkClock::now() );
+				params.parallel = true;
+				begin = BenchmarkClock::now();
+				passed &= CompressTexture( width, height, image.data(), parallel.data(), params );
+				const double parallelSeconds = Seconds( begin, BenchmarkClock::now() );
+
+				const double psnr = GetCompressionPsnr( format, width, height, image, serial );
+				const double floor = GetPsnrFloor( format, quality );
+				const bool equal = serial == parallel;
+				passed &= equal && psnr >= floor;
+				std::printf(
+					"  %4dx%-4d %s %-6s PSNR %6.2f dB (floor %.1f)  serial %7.2f Mpixel/s  parallel %7.2f Mpixel/s %s%s\n",
+					width, height, format == Format::BC1 ? "BC1" : "BC3", GetQualityName( quality ), psnr, floor,
+					static_cast< double >( width ) * height / serialSeconds / 1e6,
+					static_cast< double >( width ) * height / parallelSeconds / 1e6,
+					psnr >= floor ? "" : "BELOW FLOOR ",
+					equal ? "" : "PARALLEL MISMATCH"
+				);
+			}
+		}
+	}
+	return passed ? 0 : 1;
+}
+
+
+// prevody formatu
+
+namespace {
+
+	enum class ComponentKind {
+		FLOAT,
+		UNORM,
+		SNORM,
+		UINT,
+		SINT,
+		DEPTH_STENCIL,
+		BLOCK
+	};
+
+	struct FormatCase {
+		Format format;
+		const char* name;
+		ComponentKind kind;
+		float low;		// rozsah nahodnych hodnot kanalu (DEPTH_STENCIL: hloubka < 0; 1 >, stencil < 0; 255 >)
+		float high;
+	};
+
+	const FormatCase FORMAT_CASES[] = {
+		{ Format::R32G32B32A32_FLOAT,				"R32G32B32A32_FLOAT",				ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R32G32B32A32_UINT,				"R32G32B32A32_UINT",				ComponentKind::UINT,			0,			1e6f },
+		{ Format::R32G32B32_FLOAT,					"R32G32B32_FLOAT",					ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R32G32B32_UINT,					"R32G32B32_UINT",					ComponentKind::UINT,			0,			1e6f },
+		{ Format::R32G32_FLOAT,						"R32G32_FLOAT",						ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R32G32_UINT,						"R32G32_UINT",						ComponentKind::UINT,			0,			1e6f },
+		{ Format::R32_FLOAT,						"R32_FLOAT",						ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R32_UINT,							"R32_UINT",							ComponentKind::UINT,			0,			1e6f },
+		{ Format::R16G16B16A16_FLOAT,				"R16G16B16A16_FLOAT",				ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R16G16B16A16_UINT,				"R16G16B16A16_UINT",				ComponentKind::UINT,			0,			65535.0f },
+		{ Format::R16G16B16A16_UNORM,				"R16G16B16A16_UNORM",				ComponentKind::UNORM,			0,			1.0f },
+		{ Format::R16G16B16A16_SINT,				"R16G16B16A16_SINT",				ComponentKind::SINT,			-32768.0f,	32767.0f },
+		{ Format::R16G16B16A16_SNORM,				"R16G16B16A16_SNORM",				ComponentKind::SNORM,			-1.0f,		1.0f },
+		{ Format::R16G16_FLOAT,						"R16G16_FLOAT",						ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R16G16_UINT,						"R16G16_UINT",						ComponentKind::UINT,			0,			65535.0f },
+		{ Format::R16G16_UNORM,						"R16G16_UNORM",						ComponentKind::UNORM,			0,			1.0f },
+		{ Format::R16G16_SINT,						"R16G16_SINT",						ComponentKind::SINT,			-32768.0f,	32767.0f },
+		{ Format::R16G16_SNORM,						"R16G16_SNORM",						ComponentKind::SNORM,			-1.0f,		1.0f },
+		{ Format::R16_FLOAT,						"R16_FLOAT",						ComponentKind::FLOAT,			-1000.0f,	1000.0f },
+		{ Format::R16_UINT,							"R16_UINT",							ComponentKind::UINT,			0,			65535.0f },
+		{ Format::R16_UNORM,						"R16_UNORM",						ComponentKind::UNORM,			0,			1.0f },
+		{ Format::R16_SINT,							"R16_SINT",							ComponentKind::SINT,			-32768.0f,	32767.0f },
+		{ Format::R16_SNORM,						"R16_SNORM",						ComponentKind::SNORM,			-1.0f,		1.0f },
+		{ Format::R8G8B8A8_UINT,					"R8G8B8A8_UINT",					ComponentKind::UINT,			0,			255.0f },
+		{ Format::R8G8B8A8_UNORM,					"R8G8B8A8_UNORM",					ComponentKind::UNORM,			0,			1.0f },
+		{ Format::R8G8B8A8_SINT,					"R8G8B8A8_SINT",					ComponentKind::SINT,			-128.0f,	127.0f },
+		{ Format::R8G8B8A8_SNORM,					"R8G8B8A8_SNORM",					ComponentKind::SNORM,			-1.0f,		1.0f },
+		{ Format::R8G8_UINT,						"R8G8_UINT",						ComponentKind::UINT,			0,			255.0f },
+		{ Format::R8G8_UNORM,						"R8G8_UNORM",						ComponentKind::UNORM,			0,			1.0f },
+		{ Format::R8G8_SINT,						"R8G8_SINT",						ComponentKind::SINT,			-128.0f,	127.0f },
+		{ Format::R8G8_SNORM,						"R8G8_SNORM",						ComponentKind::SNORM,			-1.0f,		1.0f },
+		{ Format::R8_UINT,							"R8_UINT",							ComponentKind::UINT,			0,			255.0f },
+		{ Format::R8_UNORM,							"R8_UNORM",							ComponentKind::UNORM,			0,			1.0f },
+		{ Format::R8_SINT,							"R8_SINT",							ComponentKind::SINT,			-128.0f,	127.0f },
+		{ Format::R8_SNORM,							"R8_SNORM",							ComponentKind::SNORM,			-1.0f,		1.0f },
+		{ Format::DEPTH_24_UNORM_STENCIL_8_UINT,	"DEPTH_24_UNORM_STENCIL_8_UINT",	ComponentKind::DEPTH_STENCIL,	0,			1.0f },
+		{ Format::BC1,								"BC1",								ComponentKind::BLOCK,			0,			1.0f },
+		{ Format::BC3,								"BC3",								ComponentKind::BLOCK,			0,			1.0f }
+	};
+	static_assert( sizeof( FORMAT_CASES ) / sizeof( FORMAT_CASES[ 0 ] ) == static_cast< std::size_t >( Format::BC3 ), "FORMAT_CASES must list every format except UNKNOWN" );
+
+	// mezera za kazdym radkem (nenulovy rowPitch) a jeji vypln, prevod ji nesmi prepsat
+	const int ROW_PADDING = 16;
+	const uint8_t PADDING_BYTE = 0xcd;
+
+	// shoda bitu (NaN se porovnava bitove)
+	bool IsSameFloat( const float a, const float b ) {
+		return std::memcmp( &a, &b, sizeof( float ) ) == 0;
+	}
+
+	// hodnota slozky po DecodePixels(): value je cislo ulozene v bits bitech (dvojkovy doplnek pro SNORM a SINT)
+	float GetExactComponent( const ComponentKind kind, const int bits, const int32_t value ) {
+		switch ( kind ) {
+		case ComponentKind::UNORM:
+			return static_cast< float >( value ) / static_cast< float >( ( 1 << bits ) - 1 );
+		case ComponentKind::SNORM:
+			return std::fmax( static_cast< float >( value ) / static_cast< float >( ( 1 << ( bits - 1 ) ) - 1 ), -1.0f );
+		default:
+			return static_cast< float >( value );
+		}
+	}
+
+	/*
+	Vsechny hodnoty 8 a 16 bitovych slozek: DecodePixels() musi vratit presnou hodnotu (c / max pro UNORM a SNORM, c pro UINT a SINT,
+	HalfToFloat() pro FLOAT), chybejici kanaly ( 0, 0, 0, 1 ), a EncodePixels() puvodni bity
+	(krome nejmensi SNORM hodnoty, ktera se zapise jako -max, a signaling NaN, ktery se zapise jako quiet NaN).
+	*/
+	bool CheckExactDecode( const FormatCase& test ) {
+		const FormatInfo info = GetFormatInfo( test.format );
+		const int bits = info.channelByteWidth * 8;
+		const int count = 1 << bits;
+		const bool signedValues = test.kind == ComponentKind::SNORM || test.kind == ComponentKind::SINT;
+		std::vector< uint8_t > raw( static_cast< std::size_t >( count ) * info.blockByteWidth );
+		std::vector< uint8_t > expectedRaw( raw.size() );
+		std::vector< float > expected( static_cast< std::size_t >( count ) * info.channelsCount );
+		for ( int pixel = 0; pixel < count; pixel++ ) {
+			for ( int c = 0; c < info.channelsCount; c++ ) {
+				const uint32_t stored = static_cast< uint32_t >( pixel + c * 37 ) & static_cast< uint32_t >( count - 1 );
+				const int32_t value = signedValues && stored >= static_cast< uint32_t >( count / 2 ) ? static_cast< int32_t >( stored ) - count : static_cast< int32_t >( stored );
+				const std::size_t index = static_cast< std::size_t >( pixel ) * info.channelsCount + c;
+				uint32_t encoded = stored;
+				if ( test.kind == ComponentKind::FLOAT ) {
+					expected[ index ] = HalfToFloat( static_cast< uint16_t >( stored ) );
+					encoded = FloatToHalf( expected[ index ] );
+				} else {
+					expected[ index ] = GetExactComponent( test.kind, bits, value );
+					if ( test.kind == ComponentKind::SNORM && value == -count / 2 ) {
+						encoded = stored + 1;
+					}
+				}
+				for ( int b = 0; b < info.channelByteWidth; b++ ) {
+					raw[ index * info.channelByteWidth + b ] = static_cast< uint8_t >( stored >> ( b * 8 ) );
+					expectedRaw[ index * info.channelByteWidth + b ] = static_cast< uint8_t >( encoded >> ( b * 8 ) );
+				}
+			}
+		}
+
+		std::vector< Float4 > pixels( count );
+		bool passed = DecodePixels( test.format, raw.data(), pixels.data(), count );
+		for ( int pixel = 0; pixel < count && passed; pixel++ ) {
+			const float* const values = &pixels[ pixel ].x;
+			for ( int c = 0; c < 4; c++ ) {
+				passed &= IsSameFloat( values[ c ], c < info.channelsCount ? expected[ static_cast< std::size_t >( pixel ) * info.channelsCount + c ] : ( c == 3 ? 1.0f : 0.0f ) );
+			}
+		}
+		std::vector< uint8_t > encoded( raw.size() );
+		passed &= EncodePixels( test.format, pixels.data(), encoded.data(), count );
+		return passed && encoded == expectedRaw;
+	}
+
+	// sRGB R8G8B8A8_UNORM: presne hodnoty prenosove funkce pro vsech 256 hodnot, linearni alfa a zpetny prevod na puvodni bity
+	bool CheckSrgbDecode() {
+		const int count = 256;
+		std::vector< UNorm4x8 > raw( count );
+		for ( int i = 0; i < count; i++ ) {
+			raw[ i ] = { static_cast< uint8_t >( i ), static_cast< uint8_t >( i + 37 ), static_cast< uint8_t >( i + 74 ), static_cast< uint8_t >( i + 111 ) };
+		}
+		std::vector< Float4 > pixels( count );
+		bool passed = DecodePixels( Format::R8G8B8A8_UNORM, raw.data(), pixels.data(), count, ColorEncoding::SRGB );
+		for ( int i = 0; i < count && passed; i++ ) {
+			const uint8_t* const bytes = &raw[ i ].x;
+			const float* const values = &pixels[ i ].x;
+			for ( int c = 0; c < 3; c++ ) {
+				const double linear = bytes[ c ] / 255.0;
+				const double expected = linear <= 0.04045 ? linear / 12.92 : std::pow( ( linear + 0.055 ) / 1.055, 2.4 );
+				passed &= std::fabs( values[ c ] - expected ) <= 1e-7;
+			}
+			passed &= IsSameFloat( values[ 3 ], bytes[ 3 ] / 255.0f );
+		}
+		std::vector< UNorm4x8 > encoded( count );
+		passed &= EncodePixels( Format::R8G8B8A8_UNORM, pixels.data(), encoded.data(), count, ColorEncoding::SRGB );
+		return passed && std::memcmp( encoded.data(), raw.data(), count * sizeof( UNorm4x8 ) ) == 0;
+	}
+
+	// kodovani SRGB jen pro R8G8B8A8_UNORM a BC, BC jen pres ConvertTexture(), prilis maly rowPitch
+	bool CheckUnsupported() {
+		Float4 pixel;
+		uint8_t bytes[ 64 ] = {};
+		const FormatConversionParams srgb = { ColorEncoding::SRGB, ColorEncoding::LINEAR, BlockCompressionQuality::NORMAL, false };
+		const FormatConversionParams linear = { ColorEncoding::LINEAR, ColorEncoding::LINEAR, BlockCompressionQuality::NORMAL, false };
+		return !DecodePixels( Format::R16_UNORM, bytes, &pixel, 1, ColorEncoding::SRGB ) && !EncodePixels( Format::R8G8B8A8_SNORM, &pixel, bytes, 1, ColorEncoding::SRGB )
+			&& !DecodePixels( Format::BC1, bytes, &pixel, 1 ) && !EncodePixels( Format::BC3, &pixel, bytes, 1 ) && !DecodePixels( Format::UNKNOWN, bytes, &pixel, 1 )
+			&& !ConvertTexture( 2, 2, Format::R16G16_UNORM, bytes, 0, Format::R32G32B32A32_FLOAT, bytes, 0, srgb )
+			&& !ConvertTexture( 2, 2, Format::R16G16_UNORM, bytes, 4, Format::R16G16_UNORM, bytes, 0, linear );
+	}
+
+	// radky height x rowBytes zacinajici po rowPitch bajtech maji nezmenenou mezeru
+	bool IsPaddingIntact( const std::vector< uint8_t >& data, const std::size_t rowBytes, const std::size_t rowPitch, const int rows ) {
+		for ( int y = 0; y < rows; y++ ) {
+			for ( std::size_t i = rowBytes; i < rowPitch; i++ ) {
+				if ( data[ y * rowPitch + i ] != PADDING_BYTE ) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// nahodny obraz formatu (zapsany funkci EncodePixels(), tedy v kanonickem tvaru) s mezerou za kazdym radkem
+	std::vector< uint8_t > MakeFormatImage( const FormatCase& test, const int width, const int height, const std::size_t rowPitch ) {
+		std::vector< uint8_t > image( rowPitch * height, PADDING_BYTE );
+		std::vector< Float4 > row( width );
+		std::mt19937 random( 43 );
+		std::uniform_real_distribution< float > value( test.low, test.high );
+		std::uniform_real_distribution< float > stencil( 0, 255.0f );
+		for ( int y = 0; y < height; y++ ) {
+			for ( Float4& pixel : row ) {
+				pixel = Float4( value( random ), value( random ), value( random ), value( random ) );
+				if ( test.kind == ComponentKind::DEPTH_STENCIL ) {
+					pixel.y = stencil( random );
+				}
+			}
+			EncodePixels( test.format, row.data(), &image[ y * rowPitch ], width );
+		}
+		return image;
+	}
+
+	/*
+	ConvertTexture() s nenulovym rowPitch: format -> R32G32B32A32_FLOAT se musi shodovat s DecodePixels() po radcich,
+	zpetny prevod (paralelne) a kopie do stejneho formatu musi vratit puvodni bajty. Celociselne formaty navic
+	presnym prevodem pres R32G32B32A32_UINT (UINT) nebo R16G16B16A16_SINT (SINT). Mezery za radky se nesmi zmenit.
+	*/
+	bool CheckTextureRoundTrip( const FormatCase& test, const int width, const int height, double& decodeSeconds, double& encodeSeconds ) {
+		const std::size_t rowBytes = static_cast< std::size_t >( width ) * GetFormatInfo( test.format ).blockByteWidth;
+		const std::size_t rowPitch = rowBytes + ROW_PADDING;
+		const std::size_t floatRowBytes = static_cast< std::size_t >( width ) * sizeof( Float4 );
+		const std::size_t floatRowPitch = floatRowBytes + ROW_PADDING;
+		const std::vector< uint8_t > image = MakeFormatImage( test, width, height, rowPitch );
+		FormatConversionParams params = { ColorEncoding::LINEAR, ColorEncoding::LINEAR, BlockCompressionQuality::NORMAL, false };
+
+		std::vector< uint8_t > floats( floatRowPitch * height, PADDING_BYTE );
+		BenchmarkClock::time_point begin = BenchmarkClock::now();
+		bool passed = ConvertTexture( width, height, test.format, image.data(), static_cast< int >( rowPitch ), Format::R32G32B32A32_FLOAT, floats.data(), static_cast< int >( floatRowPitch ), params );
+		decodeSeconds = Seconds( begin, BenchmarkClock::now() );
+		passed &= IsPaddingIntact( floats, floatRowBytes, floatRowPitch, height );
+		std::vector< Float4 > row( width );
+		for ( int y = 0; y < height && passed; y++ ) {
+			passed &= DecodePixels( test.format, &image[ y * rowPitch ], row.data(), width );
+			passed &= std::memcmp( row.data(), &floats[ y * floatRowPitch ], floatRowBytes ) == 0;
+		}
+
+		std::vector< uint8_t > back( image.size(), PADDING_BYTE );
+		params.parallel = true;
+		begin = BenchmarkClock::now();
+		passed &= ConvertTexture( width, height, Format::R32G32B32A32_FLOAT, floats.data(), static_cast< int >( floatRowPitch ), test.format, back.data(), static_cast< int >( rowPitch ), params );
+		encodeSeconds = Seconds( begin, BenchmarkClock::now() );
+		passed &= back == image;
+
+		std::vector< uint8_t > copy( image.size(), PADDING_BYTE );
+		passed &= ConvertTexture( width, height, test.format, image.data(), static_cast< int >( rowPitch ), test.format, copy.data(), static_cast< int >( rowPitch ), params );
+		passed &= copy == image;
+
+		if ( test.kind == ComponentKind::UINT || test.kind == ComponentKind::SINT ) {
+			const Format wide = test.kind == ComponentKind::UINT ? Format::R32G32B32A32_UINT : Format::R16G16B16A16_SINT;
+			const std::size_t wideRowPitch = static_cast< std::size_t >( width ) * GetFormatInfo( wide ).blockByteWidth + ROW_PADDING;
+			std::vector< uint8_t > integers( wideRowPitch * height, PADDING_BYTE );
+			std::vector< uint8_t > narrow( image.size(), PADDING_BYTE );
+			passed &= ConvertTexture( width, height, test.format, image.data(), static_cast< int >( rowPitch ), wide, integers.data(), static_cast< int >( wideRowPitch ), params );
+			passed &= ConvertTexture( width, height, wide, integers.data(), static_cast< int >( wideRowPitch ), test.format, narrow.data(), static_cast< int >( rowPitch ), params );
+			passed &= narrow == image;
+		}
+		return passed;
+	}
+
+	/*
+	BC s nenulovym rowPitch: RGBA8 -> BC musi dat stejne bloky jako CompressTexture(), BC -> RGBA8 stejne pixely jako DecodeBlock(),
+	BC (SRGB) -> RGBA8 (SRGB) stejne bajty a BC (SRGB) -> R32G32B32A32_FLOAT stejne hodnoty jako ConvertColors() s SRGB.
+	*/
+	bool CheckBlockConversion( const Format format, const int width, const int height ) {
+		const FormatInfo info = GetFormatInfo( format );
+		const int blocksX = ( width + 3 ) / 4;
+		const int blocksY = ( height + 3 ) / 4;
+		const std::size_t pixelRowBytes = static_cast< std::size_t >( width ) * 4;
+		const std::size_t pixelRowPitch = pixelRowBytes + ROW_PADDING;
+		const std::size_t blockRowBytes = static_cast< std::size_t >( blocksX ) * info.blockByteWidth;
+		const std::size_t blockRowPitch = blockRowBytes + ROW_PADDING;
+		const std::vector< uint8_t > image = MakeCompressionImage( width, height );
+		std::vector< uint8_t > pitched( pixelRowPitch * height, PADDING_BYTE );
+		for ( int y = 0; y < height; y++ ) {
+			std::memcpy( &pitched[ y * pixelRowPitch ], &image[ y * pixelRowBytes ], pixelRowBytes );
+		}
+
+		const BlockCompressionParams compression = { format, BlockCompressionQuality::NORMAL, false };
+		std::vector< uint8_t > reference( blockRowBytes * blocksY );
+		bool passed = CompressTexture( width, height, image.data(), reference.data(), compression );
+		FormatConversionParams params = { ColorEncoding::LINEAR, ColorEncoding::LINEAR, BlockCompressionQuality::NORMAL, true };
+		std::vector< uint8_t > blocks( blockRowPitch * blocksY, PADDING_BYTE );
+		passed &= ConvertTexture( width, height, Format::R8G8B8A8_UNORM, pitched.data(), static_cast< int >( pixelRowPitch ), format, blocks.data(), static_cast< int >( blockRowPitch ), params );
+		passed &= IsPaddingIntact( blocks, blockRowBytes, blockRowPitch, blocksY );
+		for ( int by = 0; by < blocksY; by++ ) {
+			passed &= std::memcmp( &blocks[ by * blockRowPitch ], &reference[ by * blockRowBytes ], blockRowBytes ) == 0;
+		}
+
+		std::vector< uint8_t > decoded( pixelRowPitch * height, PADDING_BYTE );
+		passed &= ConvertTexture( width, height, format, blocks.data(), static_cast< int >( blockRowPitch ), Format::R8G8B8A8_UNORM, decoded.data(), static_cast< int >( pixelRowPitch ), params );
+		passed &= IsPaddingIntact( decoded, pixelRowBytes, pixelRowPitch, height );
+		for ( int by = 0; by < blocksY; by++ ) {
+			for ( int bx = 0; bx < blocksX; bx++ ) {
+				UNorm4x8 pixels[ 16 ];
+				passed &= DecodeBlock( format, &reference[ by * blockRowBytes + bx * info.blockByteWidth ], pixels );
+				for ( int y = by * 4; y < by * 4 + 4 && y < height; y++ ) {
+					for ( int x = bx * 4; x < bx * 4 + 4 && x < width; x++ ) {
+						passed &= std::memcmp( &decoded[ y * pixelRowPitch + x * 4 ], &pixels[ ( y - by * 4 ) * 4 + x - bx * 4 ], 4 ) == 0;
+					}
+				}
+			}
+		}
+
+		params.srcEncoding = ColorEncoding::SRGB;
+		params.destEncoding = ColorEncoding::SRGB;
+		std::vector< uint8_t > decodedSrgb( decoded.size(), PADDING_BYTE );
+		passed &= ConvertTexture( width, height, format, blocks.data(), static_cast< int >( blockRowPitch ), Format::R8G8B8A8_UNORM, decodedSrgb.data(), static_cast< int >( pixelRowPitch ), params );
+		passed &= decodedSrgb == decoded;
+
+		params.destEncoding = ColorEncoding::LINEAR;
+		const std::size_t floatRowPitch = static_cast< std::size_t >( width ) * sizeof( Float4 ) + ROW_PADDING;
+		std::vector< uint8_t > floats( floatRowPitch * height, PADDING_BYTE );
+		passed &= ConvertTexture( width, height, format, blocks.data(), static_cast< int >( blockRowPitch ), Format::R32G32B32A32_FLOAT, floats.data(), static_cast< int >( floatRowPitch ), params );
+		std::vector< Color > colors( width );
+		for ( int y = 0; y < height; y++ ) {
+			ConvertColors( reinterpret_cast< const UNorm4x8* >( &decoded[ y * pixelRowPitch ] ), colors.data(), width, ColorEncoding::SRGB );
+			passed &= std::memcmp( &floats[ y * floatRowPitch ], colors.data(), static_cast< std::size_t >( width ) * sizeof( Color ) ) == 0;
+		}
+		return passed;
+	}
+
+	// R8G8B8A8_UNORM (SRGB) -> R32G32B32A32_FLOAT (linearni) -> R8G8B8A8_UNORM (SRGB) s nenulovym rowPitch vrati puvodni bajty
+	bool CheckSrgbRoundTrip( const int width, const int height ) {
+		const std::size_t rowPitch = static_cast< std::size_t >( width ) * 4 + ROW_PADDING;
+		const std::size_t floatRowPitch = static_cast< std::size_t >( width ) * sizeof( Float4 ) + ROW_PADDING;
+		const std::vector< uint8_t > image = MakeFormatImage( FORMAT_CASES[ static_cast< int >( Format::R8G8B8A8_UNORM ) - 1 ], width, height, rowPitch );
+		std::vector< uint8_t > floats( floatRowPitch * height, PADDING_BYTE );
+		std::vector< uint8_t > back( image.size(), PADDING_BYTE );
+		FormatConversionParams params = { ColorEncoding::SRGB, ColorEncoding::LINEAR, BlockCompressionQuality::NORMAL, false };
+		bool passed = ConvertTexture( width, height, Format::R8G8B8A8_UNORM, image.data(), static_cast< int >( rowPitch ), Format::R32G32B32A32_FLOAT, floats.data(), static_cast< int >( floatRowPitch ), params );
+		params.srcEncoding = ColorEncoding::LINEAR;
+		params.destEncoding = ColorEncoding::SRGB;
+		passed &= ConvertTexture( width, height, Format::R32G32B32A32_FLOAT, floats.data(), static_cast< int >( floatRowPitch ), Format::R8G8B8A8_UNORM, back.data(), static_cast< int >( rowPitch ), params );
+		return passed && back == image;
+	}
+}
+
+/*
+Prevody vsech formatu GetFormatInfo(): presne hodnoty vsech 8 a 16 bitovych slozek a sRGB (DecodePixels(), EncodePixels()),
+ConvertTexture() s nenulovym rowPitch tam i zpet pro texturu 37x19 a 1024x1024 (quick 256x256), BC1 a BC3 proti CompressTexture()
+a DecodeBlock(). Vypise rychlost prevodu do R32G32B32A32_FLOAT a zpet. Vraci 1 pri jakemkoli rozdilu.
+*/
+int RunFormatsBenchmark( const BenchmarkOptions& options ) {
+	const int size = options.quick ? 256 : 1024;
+	std::printf( "%dx%d, row padding %d bytes, %u threads\n", size, size, ROW_PADDING, GetParallelThreadsCount() );
+	bool passed = true;
+	for ( const FormatCase& test : FORMAT_CASES ) {
+		const FormatInfo info = GetFormatInfo( test.format );
+		if ( test.kind == ComponentKind::BLOCK ) {
+			const bool converted = CheckBlockConversion( test.format, 37, 19 ) && CheckBlockConversion( test.format, size, size );
+			passed &= converted;
+			std::printf( "  %-30s %-11s %s\n", test.name, "", converted ? "" : "MISMATCH" );
+			continue;
+		}
+		const bool exactCase = info.channelByteWidth <= 2 && test.kind != ComponentKind::DEPTH_STENCIL;
+		const bool exact = !exactCase || CheckExactDecode( test );
+		double decodeSeconds;
+		double encodeSeconds;
+		bool roundTrip = CheckTextureRoundTrip( test, 37, 19, decodeSeconds, encodeSeconds );
+		roundTrip &= CheckTextureRoundTrip( test, size, size, decodeSeconds, encodeSeconds );
+		passed &= exact && roundTrip;
+		std::printf(
+			"  %-30s %-11s decode %7.1f Mpixel/s  encode %7.1f Mpixel/s %s%s\n",
+			test.name, exactCase ? "exact" : "", static_cast< double >( size ) * size / decodeSeconds / 1e6, static_cast< double >( size ) * size / encodeSeconds / 1e6,
+			exact ? "" : "INEXACT DECODE ", roundTrip ? "" : "ROUND TRIP MISMATCH"
+		);
+	}
+	const bool srgb = CheckSrgbDecode() && CheckSrgbRoundTrip( 37, 19 ) && CheckSrgbRoundTrip( size, size );
+	const bool unsupported = CheckUnsupported();
+	passed &= srgb && unsupported;
+	std::printf( "  %-30s %s\n", "R8G8B8A8_UNORM sRGB", srgb ? "exact" : "MISMATCH" );
+	std::printf( "  %-30s %s\n", "unsupported conversions", unsupported ? "rejected" : "ACCEPTED" );
+	return passed ? 0 : 1;
+}
+
+// prevod float <-> half
+
+namespace {
+
+	// hodnota okolo vystupu, prevod pole ji nesmi prepsat
+	const uint16_t GUARD_HALF = 0xbeef;
+	const uint32_t GUARD_FLOAT = 0xdeadbeef;
+
+	const char* GetHalfKernelName() {
+#if defined( SIMD_F16C )
+		return "F16C";
+#elif defined( SIMD_SSE2 )
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+	// HalfToFloat( pole ) pro vsech 65536 hodnot musi dat stejne bity jako skalarni HalfToFloat()
+	bool CheckHalfToFloat() {
+		std::vector< uint16_t > halves( 65536 );
+		for ( std::size_t i = 0; i < halves.size(); i++ ) {
+			halves[ i ] = static_cast< uint16_t >( i );
+		}
+		std::vector< float > floats( halves.size() );
+		HalfToFloat( halves.data(), floats.data(), halves.size() );
+		bool passed = true;
+		for ( std::size_t i = 0; i < halves.size(); i++ ) {
+			const float expected = HalfToFloat( halves[ i ] );
+			passed &= std::memcmp( &floats[ i ], &expected, sizeof( float ) ) == 0;
+		}
+		return passed;
+	}
+
+	// FloatToHalf( pole ) pro bitove vzory float s krokem stride musi dat stejne bity jako skalarni FloatToHalf()
+	bool CheckFloatToHalf( const uint32_t stride ) {
+		const std::size_t batch = 65536;
+		std::vector< float > floats( batch );
+		std::vector< uint16_t > halves( batch );
+		bool passed = true;
+		uint64_t bits = 0;
+		while ( bits <= 0xffffffffu ) {
+			std::size_t count = 0;
+			for ( ; count < batch && bits <= 0xffffffffu; count++, bits += stride ) {
+				const uint32_t pattern = static_cast< uint32_t >( bits );
+				std::memcpy( &floats[ count ], &pattern, sizeof( float ) );
+			}
+			FloatToHalf( floats.data(), halves.data(), count );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				passed &= halves[ i ] == FloatToHalf( floats[ i ] );
+			}
+		}
+		return passed;
+	}
+
+	/*
+	Podpole zacinajici na kazdem offsetu 0 - 7 (nezarovnane ukazatele) se vsemi delkami 0 - 33 (vektorova cast i skalarni zbytek):
+	vysledek musi odpovidat skalarnim funkcim a hodnoty pred a za vystupem se nesmi zmenit (zapis do namapovaneho bufferu).
+	*/
+	bool CheckHalfSubarrays() {
+		const std::size_t size = 48;
+		std::mt19937 random( 47 );
+		std::vector< float > floats( size );
+		std::vector< uint16_t > halves( size );
+		for ( std::size_t i = 0; i < size; i++ ) {
+			const uint32_t pattern = random();
+			std::memcpy( &floats[ i ], &pattern, sizeof( float ) );
+			halves[ i ] = static_cast< uint16_t >( random() );
+		}
+		bool passed = true;
+		for ( std::size_t offset = 0; offset < 8; offset++ ) {
+			for ( std::size_t count = 0; count <= 33; count++ ) {
+				std::vector< uint16_t > halfOut( size, GUARD_HALF );
+				std::vector< uint32_t > floatOut( size, GUARD_FLOAT );
+				FloatToHalf( floats.data() + offset, halfOut.data() + offset, count );
+				HalfToFloat( halves.data() + offset, reinterpret_cast< float* >( floatOut.data() + offset ), count );
+				for ( std::size_t i = 0; i < size; i++ ) {
+					const bool inside = i >= offset && i < offset + count;
+					const float value = HalfToFloat( halves[ i ] );
+					uint32_t expectedFloat;
+					std::memcpy( &expectedFloat, &value, sizeof( expectedFloat ) );
+					passed &= halfOut[ i ] == ( inside ? FloatToHalf( floats[ i ] ) : GUARD_HALF );
+					passed &= floatOut[ i ] == ( inside ? expectedFloat : GUARD_FLOAT );
+				}
+			}
+		}
+		return passed;
+	}
+}
+
+/*
+Prevod float <-> half: pole (F16C, SSE2 nebo skalarni podle prekladu) proti skalarnim funkcim Half.h bit po bitu,
+vsech 65536 half hodnot, bitove vzory float s lichym krokem (plny beh vsechny, quick kazdy 257.) a nezarovnana podpole
+vsech delek. Vypise rychlost pole a skalarni smycky. Vraci 1 pri rozdilu.
+*/
+int RunHalfBenchmark( const BenchmarkOptions& options ) {
+	const uint32_t stride = options.quick ? 257 : 1;
+	std::printf( "%s kernel, every %u. float\n", GetHalfKernelName(), stride );
+	const bool halfToFloat = CheckHalfToFloat();
+	const bool floatToHalf = CheckFloatToHalf( stride );
+	const bool subarrays = CheckHalfSubarrays();
+	std::printf( "  %-40s %s\n", "HalfToFloat, all 65536 halves", halfToFloat ? "bit exact" : "MISMATCH" );
+	std::printf( "  %-40s %s\n", "FloatToHalf, float bit patterns", floatToHalf ? "bit exact" : "MISMATCH" );
+	std::printf( "  %-40s %s\n", "unaligned subarrays, lengths 0 - 33", subarrays ? "bit exact, guards intact" : "MISMATCH" );
+
+	const std::size_t count = Iterations( options, 16 * 1024 * 1024 );
+	std::mt19937 random( 53 );
+	std::uniform_real_distribution< float > value( -70000.0f, 70000.0f );
+	std::vector< float > floats( count );
+	for ( float& f : floats ) {
+		f = value( random );
+	}
+	std::vector< uint16_t > halves( count );
+	std::vector< float > back( count );
+	const auto measure = [ & ]( const char* const name, const std::function< void() >& function ) {
+		function();
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		function();
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		std::printf( "  %-40s %6.3f ns/value\n", name, seconds * 1e9 / static_cast< double >( count ) );
+	};
+	measure( "FloatToHalf( array )", [ & ]() { FloatToHalf( floats.data(), halves.data(), count ); DoNotOptimize( halves.data() ); } );
+	measure( "FloatToHalf( float ) loop", [ & ]() {
+		for ( std::size_t i = 0; i < count; i++ ) {
+			halves[ i ] = FloatToHalf( floats[ i ] );
+		}
+		DoNotOptimize( halves.data() );
+	} );
+	measure( "HalfToFloat( array )", [ & ]() { HalfToFloat( halves.data(), back.data(), count ); DoNotOptimize( back.data() ); } );
+	measure( "HalfToFloat( uint16_t ) loop", [ & ]() {
+		for ( std::size_t i = 0; i < count; i++ ) {
+			back[ i ] = HalfToFloat( halves[ i ] );
+		}
+		DoNotOptimize( back.data() );
+	} );
+	return halfToFloat && floatToHalf && subarrays ? 0 : 1;
+}
+
+// prevod barev do sRGB
+
+namespace {
+
+	// dokumentovana chyba kodovani do sRGB (ColorArray.h) v jednotkach 8 bitove hodnoty
+	const double SRGB_ERROR_BOUND = 0.57;
+
+	// pixelu v jedne davce, nasobek 16 (cele pole zpracuje SIMD kernel) i 3 (skalarni zbytek po 3 pixelech)
+	const std::size_t SRGB_BATCH = 16 * 3 * 256;
+
+	// presna hodnota 255 * sRGB( x )
+	double GetExactSrgb( const double x ) {
+		return 255.0 * ( x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow( x, 1.0 / 2.4 ) - 0.055 );
+	}
+
+	/*
+	Float hodnoty < 0; 1 > s krokem stride (1 = vsechny) v kanalech r, g, b: kazda davka se prevede celym polem (SIMD kernel)
+	a po 3 pixelech (skalarni zbytek pole), vysledky musi byt shodne. Vysledek n pokryva souvisly interval vstupu
+	mezi nejmensi a nejvetsi hodnotou s timto vysledkem, sRGB je rostouci, nejvetsi chyba je proto v krajnich hodnotach.
+	*/
+	bool CheckColorsEncode( const uint32_t stride, double& maxError, std::size_t& mismatches ) {
+		float minValue[ 256 ];
+		float maxValue[ 256 ];
+		bool seen[ 256 ] = {};
+		std::vector< Color > colors( SRGB_BATCH );
+		std::vector< UNorm4x8 > simd( SRGB_BATCH );
+		const uint32_t last = 0x3f800000;
+		mismatches = 0;
+		uint64_t bits = 0;
+		while ( bits <= last ) {
+			float values[ 3 ];
+			std::size_t count = 0;
+			for ( ; count < SRGB_BATCH; count++ ) {
+				for ( float& value : values ) {
+					const uint32_t pattern = bits <= last ? static_cast< uint32_t >( bits ) : last;
+					bits += stride;
+					std::memcpy( &value, &pattern, sizeof( value ) );
+				}
+				colors[ count ] = Color( values[ 0 ], values[ 1 ], values[ 2 ], 1.0f );
+			}
+			ConvertColors( colors.data(), simd.data(), SRGB_BATCH, ColorEncoding::SRGB );
+			for ( std::size_t i = 0; i < SRGB_BATCH; i += 3 ) {
+				UNorm4x8 scalar[ 3 ];
+				ConvertColors( &colors[ i ], scalar, 3, ColorEncoding::SRGB );
+				mismatches += std::memcmp( scalar, &simd[ i ], sizeof( scalar ) ) != 0 ? 1 : 0;
+			}
+			for ( std::size_t i = 0; i < SRGB_BATCH; i++ ) {
+				const float channels[ 3 ] = { colors[ i ].r, colors[ i ].g, colors[ i ].b };
+				const uint8_t results[ 3 ] = { simd[ i ].x, simd[ i ].y, simd[ i ].z };
+				for ( int c = 0; c < 3; c++ ) {
+					const uint8_t n = results[ c ];
+					if ( !seen[ n ] || channels[ c ] < minValue[ n ] ) {
+						minValue[ n ] = channels[ c ];
+					}
+					if ( !seen[ n ] || channels[ c ] > maxValue[ n ] ) {
+						maxValue[ n ] = channels[ c ];
+					}
+					seen[ n ] = true;
+				}
+			}
+		}
+		maxError = 0;
+		for ( int n = 0; n < 256; n++ ) {
+			if ( seen[ n ] ) {
+				maxError = std::fmax( maxError, std::fabs( n - GetExactSrgb( minValue[ n ] ) ) );
+				maxError = std::fmax( maxError, std::fabs( n - GetExactSrgb( maxValue[ n ] ) ) );
+			}
+		}
+		return maxError <= SRGB_ERROR_BOUND && mismatches == 0;
+	}
+
+	// hodnoty mimo < 0; 1 > jsou orezany, NaN je 0, alfa je linearni (SIMD kernel i skalarni zbytek)
+	bool CheckColorsSpecial() {
+		const float values[] = { -1.0f, -0.0f, 2.0f, INFINITY, -INFINITY, NAN, 1e-30f, 0.5f };
+		const uint8_t expected[] = { 0, 0, 255, 255, 0, 0, 0, 188 };
+		const std::size_t count = sizeof( values ) / sizeof( values[ 0 ] );
+		bool passed = true;
+		for ( const std::size_t pixels : { std::size_t( 16 ), std::size_t( 1 ) } ) {
+			std::vector< Color > colors( pixels );
+			std::vector< UNorm4x8 > result( pixels );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				for ( Color& color : colors ) {
+					color = Color( values[ i ], values[ i ], values[ i ], 0.5f );
+				}
+				ConvertColors( colors.data(), result.data(), pixels, ColorEncoding::SRGB );
+				for ( const UNorm4x8& pixel : result ) {
+					passed &= pixel.x == expected[ i ] && pixel.y == expected[ i ] && pixel.z == expected[ i ] && pixel.w == 128;
+				}
+			}
+		}
+		return passed;
+	}
+
+	// dekodovani vsech 256 hodnot: float nejblize presne inverzni prenosove funkci, alfa c / 255
+	bool CheckColorsDecode() {
+		std::vector< UNorm4x8 > pixels( 256 );
+		for ( std::size_t i = 0; i < pixels.size(); i++ ) {
+			const uint8_t c = static_cast< uint8_t >( i );
+			pixels[ i ] = UNorm4x8{ c, c, c, c };
+		}
+		std::vector< Color > colors( pixels.size() );
+		ConvertColors( pixels.data(), colors.data(), pixels.size(), ColorEncoding::SRGB );
+		bool passed = true;
+		for ( std::size_t i = 0; i < colors.size(); i++ ) {
+			const double c = static_cast< double >( i ) / 255.0;
+			const float expected = static_cast< float >( c <= 0.04045 ? c / 12.92 : std::pow( ( c + 0.055 ) / 1.055, 2.4 ) );
+			passed &= colors[ i ].r == expected && colors[ i ].g == expected && colors[ i ].b == expected && colors[ i ].a == static_cast< float >( i ) / 255.0f;
+		}
+		return passed;
+	}
+}
+
+/*
+Prevod barev do sRGB (ColorArray.h): float hodnoty < 0; 1 > (plny beh vsechny, quick kazda 61.) proti presne
+prenosove funkci (nejvetsi chyba nejvyse 0.57 jednotky), SIMD kernel proti skalarnimu zbytku pole pro kazdou hodnotu,
+orezani a NaN, dekodovani vsech 256 hodnot. Vraci 1 pri prekroceni chyby nebo rozdilu.
+*/
+int RunColorsBenchmark( const BenchmarkOptions& options ) {
+	const uint32_t stride = options.quick ? 61 : 1;
+	std::printf( "every %u. float\n", stride );
+	double maxError = 0;
+	std::size_t mismatches = 0;
+	const BenchmarkClock::time_point begin = BenchmarkClock::now();
+	const bool encode = CheckColorsEncode( stride, maxError, mismatches );
+	const double seconds = Seconds( begin, BenchmarkClock::now() );
+	const bool special = CheckColorsSpecial();
+	const bool decode = CheckColorsDecode();
+	std::printf( "  %-40s max error %.3f (bound %.2f), %zu SIMD/scalar mismatches (%.1f s) %s\n", "sRGB encode, floats in < 0; 1 >", maxError, SRGB_ERROR_BOUND, mismatches, seconds, encode ? "" : "FAILED" );
+	std::printf( "  %-40s %s\n", "sRGB encode, clamping and NaN", special ? "exact" : "FAILED" );
+	std::printf( "  %-40s %s\n", "sRGB decode, all 256 values", decode ? "exact" : "FAILED" );
+	return encode && special && decode ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "Framework/AllocationTrace.h"
+#include "Framework/String.h"
+#include "Benchmark.h"
+
+namespace {
+
+	const char* const RECORDED_TRACE_PATH = "bench_trace.bin";
+
+	/*
+	Zatez pro zaznam, pokud neni zadan soubor se zaznamem:
+	kontejnery s rostoucimi poli, uzly map, retezce a kratce zijici docasne buffery ve 4 vlaknech.
+	*/
+	void RunRecordedWorkload( const std::size_t frames ) {
+		RunThreads( 4, [ frames ]( const int thread ) {
+			std::mt19937 random( 11 + thread );
+			std::map< uint32_t, String > names;
+			std::unordered_map< uint32_t, std::vector< float > > components;
+			std::vector< std::unique_ptr< std::vector< uint32_t > > > lists;
+			for ( std::size_t frame = 0; frame < frames; frame++ ) {
+				// docasna data snimku
+				std::vector< std::unique_ptr< Byte[] > > temporary;
+				for ( int i = 0; i < 32; i++ ) {
+					temporary.emplace_back( new Byte[ 16 + random() % 240 ] );
+				}
+				// objekty sceny vznikaji a zanikaji
+				const uint32_t key = random() % 4096;
+				if ( random() % 3 != 0 ) {
+					String name( u"entity_" );
+					for ( uint32_t i = 0; i < key % 200; i++ ) {
+						name.Append( String( u"x" ) );
+					}
+					names[ key ] = name;
+					components[ key ].resize( 4 + random() % 64 );
+				} else {
+					names.erase( key );
+					components.erase( key );
+				}
+				if ( random() % 8 == 0 ) {
+					lists.emplace_back( new std::vector< uint32_t >( random() % 1024 ) );
+				}
+				if ( lists.size() > 256 ) {
+					lists.erase( lists.begin(), lists.begin() + 128 );
+				}
+			}
+		} );
+	}
+
+	void PrintStats( const char* const name, const AllocationReplayStats& stats ) {
+		std::printf( "%s\n", name );
+		std::printf(
+			"  %llu allocations, %llu frees, %llu failed, %.3f s, %.2f Mops/s\n",
+			static_cast< unsigned long long >( stats.allocations ),
+			static_cast< unsigned long long >( stats.frees ),
+			static_cast< unsigned long long >( stats.failedAllocations ),
+			stats.seconds,
+			stats.operationsPerSecond / 1e6
+		);
+		std::printf(
+			"  alloc latency            p50 %4.0f ns  p90 %4.0f ns  p99 %5.0f ns  p99.9 %6.0f ns  max %8.0f ns\n",
+			stats.allocLatency.p50, stats.allocLatency.p90, stats.allocLatency.p99, stats.allocLatency.p999, stats.allocLatency.max
+		);
+		std::printf(
+			"  free latency             p50 %4.0f ns  p90 %4.0f ns  p99 %5.0f ns  p99.9 %6.0f ns  max %8.0f ns\n",
+			stats.freeLatency.p50, stats.freeLatency.p90, stats.freeLatency.p99, stats.freeLatency.p999, stats.freeLatency.max
+		);
+		if ( stats.endOccupiedBytes == 0 ) {
+			std::printf( "  peak live %llu KB, end live %llu KB, occupied memory not reported\n",
+				static_cast< unsigned long long >( stats.peakLiveBytes / 1024 ),
+				static_cast< unsigned long long >( stats.endLiveBytes / 1024 )
+			);
+			return;
+		}
+		std::printf(
+			"  peak live %llu KB, end live %llu KB, occupied %llu KB (%.2fx), after Flush() %llu KB\n",
+			static_cast< unsigned long long >( stats.peakLiveBytes / 1024 ),
+			static_cast< unsigned long long >( stats.endLiveBytes / 1024 ),
+			static_cast< unsigned long long >( stats.endOccupiedBytes / 1024 ),
+			stats.endLiveBytes > 0 ? static_cast< double >( stats.endOccupiedBytes ) / static_cast< double >( stats.endLiveBytes ) : 0.0,
+			static_cast< unsigned long long >( stats.flushedOccupiedBytes / 1024 )
+		);
+	}
+}
+
+/*
+Prehraje zaznam alokaci proti operatoru new, malloc a FixedAllocator poolum.
+Bez parametru nejdrive zaznamena vlastni zatez do souboru bench_trace.bin (vyzaduje ALLOCATION_TRACKING).
+Kazdy target se prehraje dvakrat: s merenim latenci a bez mereni (propustnost).
+*/
+int RunReplayBenchmark( const BenchmarkOptions& options ) {
+	const char* path = options.args.empty() ? nullptr : options.args[ 0 ];
+	if ( path == nullptr ) {
+		if ( !StartAllocationTrace( RECORDED_TRACE_PATH ) ) {
+			std::printf( "allocation trace is not available (ALLOCATION_TRACKING disabled)\n" );
+			return 0;
+		}
+		RunRecordedWorkload( Iterations( options, 200000 ) );
+		StopAllocationTrace();
+		path = RECORDED_TRACE_PATH;
+	}
+	AllocationTrace trace;
+	if ( !trace.Load( path ) ) {
+		std::printf( "failed to load allocation trace %s\n", path );
+		return 1;
+	}
+	std::printf( "trace %s: %lu operations, %lu slots\n", path, trace.GetOperationsCount(), trace.GetSlotsCount() );
+
+	HeapReplayTarget heap;
+	SystemReplayTarget system;
+	PoolReplayTarget pools;
+	const std::pair< const char*, AllocationReplayTarget* > targets[] = {
+		{ "operator new", &heap },
+		{ "malloc", &system },
+		{ "FixedAllocator pools", &pools }
+	};
+	for ( const std::pair< const char*, AllocationReplayTarget* >& target : targets ) {
+		AllocationReplayStats stats;
+		ReplayAllocationTrace( trace, *target.second, stats, true );
+		PrintStats( target.first, stats );
+		if ( stats.failedAllocations > 0 ) {
+			return 1;
+		}
+		ReplayAllocationTrace( trace, *target.second, stats, false );
+		std::printf( "  without latency sampling %.2f Mops/s\n", stats.operationsPerSecond / 1e6 );
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "Framework/Allocation.h"
+#include "Framework/AllocationTracking.h"
+#include "Benchmark.h"
+
+/*
+Sledovani alokaci: cena TrackAllocation() + TrackFree() a zachyceni spicky mezi snapshoty.
+Vlakna alokuji s tagem SCENE, po dosazeni spicky vse uvolni, teprve potom se porizuje snapshot.
+Spicka musi byt zachycena s presnosti ALLOCATION_PEAK_GRANULARITY na vlakno.
+StackAllocator s tagem RESOURCES: spicka musi odpovidat nejvetsi obsazenosti zasobniku (vnorene znacky pres vice stranek).
+*/
+int RunTrackingBenchmark( const BenchmarkOptions& options ) {
+#ifdef ALLOCATION_TRACKING
+	const std::size_t count = Iterations( options, 10000000 );
+	BenchmarkClock::time_point begin = BenchmarkClock::now();
+	for ( std::size_t i = 0; i < count; i++ ) {
+		TrackAllocation( AllocationTag::SCENE, 64 + ( i & 63 ) );
+		TrackFree( AllocationTag::SCENE, 64 + ( i & 63 ) );
+	}
+	std::printf( "TrackAllocation + TrackFree  %.2f ns per pair\n", Seconds( begin, BenchmarkClock::now() ) * 1e9 / count );
+
+	const int THREADS = 4;
+	const std::size_t BLOCK_BYTES = 64;
+	const std::size_t blocksPerThread = Iterations( options, 1 << 16 );
+	AllocationSnapshot before;
+	GetAllocationSnapshot( before );
+	const int scene = static_cast< int >( AllocationTag::SCENE );
+	std::atomic< int > allocated( 0 );
+	begin = BenchmarkClock::now();
+	RunThreads( THREADS, [ & ]( const int ) {
+		for ( std::size_t i = 0; i < blocksPerThread; i++ ) {
+			TrackAllocation( AllocationTag::SCENE, BLOCK_BYTES );
+		}
+		// vsechna vlakna dosahla spicky
+		allocated.fetch_add( 1 );
+		while ( allocated.load() < THREADS ) {
+			std::this_thread::yield();
+		}
+		for ( std::size_t i = 0; i < blocksPerThread; i++ ) {
+			TrackFree( AllocationTag::SCENE, BLOCK_BYTES );
+		}
+	} );
+	AllocationSnapshot after;
+	GetAllocationSnapshot( after );
+	const int64_t expected = before.tags[ scene ].liveBytes + static_cast< int64_t >( THREADS * blocksPerThread * BLOCK_BYTES );
+	const int64_t peak = after.tags[ scene ].peakBytes;
+	std::printf(
+		"peak between snapshots     expected %lld KB, reported %lld KB, live after %lld KB\n",
+		static_cast< long long >( expected / 1024 ),
+		static_cast< long long >( peak / 1024 ),
+		static_cast< long long >( after.tags[ scene ].liveBytes / 1024 )
+	);
+	if ( peak < expected - THREADS * ALLOCATION_PEAK_GRANULARITY || peak > expected ) {
+		std::printf( "peak was not tracked at allocation time\n" );
+		return 1;
+	}
+	
+	const unsigned long STACK_PAGE = 16 * 1024;
+	const unsigned long STACK_BLOCK = 1024;
+	const int resources = static_cast< int >( AllocationTag::RESOURCES );
+	GetAllocationSnapshot( before );
+	{
+		StackAllocator stack( STACK_PAGE );
+		stack.SetTag( AllocationTag::RESOURCES );
+		ScopedStackMarker outer( stack );
+		for ( unsigned long i = 0; i < 3 * STACK_PAGE / STACK_BLOCK; i++ ) {
+			DoNotOptimize( stack.Alloc( STACK_BLOCK ) );
+		}
+		ScopedStackMarker inner( stack );
+		for ( unsigned long i = 0; i < STACK_PAGE / STACK_BLOCK; i++ ) {
+			DoNotOptimize( stack.Alloc( STACK_BLOCK ) );
+		}
+	}
+	GetAllocationSnapshot( after );
+	const int64_t stackExpected = before.tags[ resources ].liveBytes + static_cast< int64_t >( 4 * STACK_PAGE );
+	const int64_t stackPeak = after.tags[ resources ].peakBytes;
+	std::printf(
+		"stack allocator peak       expected %lld KB, reported %lld KB, live after %lld KB\n",
+		static_cast< long long >( stackExpected / 1024 ),
+		static_cast< long long >( stackPeak / 1024 ),
+		static_cast< long long >( after.tags[ resources ].liveBytes / 1024 )
+	);
+	if ( stackPeak < stackExpected - ALLOCATION_PEAK_GRANULARITY || after.tags[ resources ].liveBytes != before.tags[ resources ].liveBytes ) {
+		std::printf( "stack allocator usage was not tracked\n" );
+		return 1;
+	}
+#else
+	static_cast< void >( options );
+	std::printf( "allocation tracking is disabled (DISABLE_ALLOCATION_TRACKING)\n" );
+#endif
+	return 0;
+}
@@ -0,0 +1,511 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Framework/MatrixArray.h"
+#include "Framework/Parallel.h"
+#include "Framework/Transform.h"
+#include "Framework/VectorArray.h"
+#include "Benchmark.h"
+
+// transformace poli vektoru
+
+namespace {
+
+	// vysledky kernelu se od Vector::Transform mohou lisit jen zaokrouhlenim (poradi scitani, FMA)
+	const float TRANSFORM_TOLERANCE = 1e-5f;
+
+	bool IsClose( const Vector& a, const Vector& b ) {
+		const float scale = std::fmax( 1.0f, std::fmax( std::fabs( b.x ), std::fmax( std::fabs( b.y ), std::fabs( b.z ) ) ) );
+		return std::fabs( a.x - b.x ) <= TRANSFORM_TOLERANCE * scale && std::fabs( a.y - b.y ) <= TRANSFORM_TOLERANCE * scale && std::fabs( a.z - b.z ) <= TRANSFORM_TOLERANCE * scale;
+	}
+
+	// rounds volani function() po jednom volani bez mereni (prvni zapis do vystupu), vypise ns na vektor, vraci false pri rozdilu od reference
+	template <typename Function, typename Result>
+	bool MeasureTransform( const char* const name, const std::size_t count, const int rounds, const std::vector< Vector >& reference, Function function, Result result ) {
+		function();
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			function();
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		bool passed = true;
+		for ( std::size_t i = 0; i < count && passed; i++ ) {
+			passed = IsClose( result( i ), reference[ i ] );
+		}
+		std::printf( "  %-40s %6.2f ns/vector %s\n", name, seconds * 1e9 / static_cast< double >( rounds ) / static_cast< double >( count ), passed ? "" : "MISMATCH" );
+		return passed;
+	}
+
+	/*
+	Zvetseni VectorArray v ramci kapacity po transformaci: transformace zapisuji i do doplneni,
+	nove vektory musi byt presto nulove.
+	*/
+	bool CheckResize() {
+		VectorArray array( 5 );
+		TransformPoints( Matrix::MakeTranslation( 7.0f, 8.0f, 9.0f ), array, array );
+		array.Resize( 6 );
+		const Vector added = array.Get( 5 );
+		const Vector kept = array.Get( 4 );
+		const bool passed = added == Vector( 0, 0, 0, 0 ) && kept == Vector( 7.0f, 8.0f, 9.0f, 0 );
+		std::printf( "  %-40s %s\n", "VectorArray::Resize after transform", passed ? "zeroed" : "NOT ZEROED" );
+		return passed;
+	}
+}
+
+/*
+Transformace 1M bodu (quick 64k): smycka Vector::Transform proti TransformPoints pro pole Float3 a VectorArray (SoA),
+serialne a paralelne. Vraci 1, pokud se vysledky lisi vic nez zaokrouhlenim.
+*/
+int RunTransformBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 1024 * 1024 );
+	const int rounds = 8;
+	std::printf( "%zu points, %u threads\n", count, GetParallelThreadsCount() );
+
+	Matrix matrix;
+	matrix.RotateAxis( Vector( 0.3f, 1.0f, -0.2f, 0 ), 0.7f );
+	matrix.Scale( 1.5f, 0.5f, 2.0f );
+	matrix.Translate( 10.0f, -20.0f, 5.0f );
+
+	std::mt19937 random( 31 );
+	std::uniform_real_distribution< float > position( -100.0f, 100.0f );
+	std::vector< Float3 > points( count );
+	VectorArray array( count );
+	for ( std::size_t i = 0; i < count; i++ ) {
+		points[ i ] = Float3( position( random ), position( random ), position( random ) );
+		array.Set( i, Vector( points[ i ] ) );
+	}
+	std::vector< Vector > reference( count );
+	for ( std::size_t i = 0; i < count; i++ ) {
+		reference[ i ] = Vector( points[ i ] );
+		reference[ i ].Transform( matrix );
+	}
+
+	bool passed = CheckResize();
+	std::vector< Vector > vectors( count );
+	passed &= MeasureTransform( "Vector::Transform loop", count, rounds, reference, [ & ]() {
+		for ( std::size_t i = 0; i < count; i++ ) {
+			vectors[ i ] = Vector( points[ i ] );
+			vectors[ i ].Transform( matrix );
+		}
+		DoNotOptimize( vectors.data() );
+	}, [ & ]( const std::size_t i ) { return vectors[ i ]; } );
+
+	std::vector< Float3 > out( count );
+	const auto float3Result = [ & ]( const std::size_t i ) { return Vector( out[ i ] ); };
+	passed &= MeasureTransform( "TransformPoints( Float3 )", count, rounds, reference, [ & ]() {
+		TransformPoints( matrix, points.data(), out.data(), count );
+	}, float3Result );
+	passed &= MeasureTransform( "TransformPoints( Float3 ) parallel", count, rounds, reference, [ & ]() {
+		TransformPoints( matrix, points.data(), out.data(), count, true );
+	}, float3Result );
+
+	VectorArray arrayOut;
+	const auto arrayResult = [ & ]( const std::size_t i ) { return arrayOut.Get( i ); };
+	passed &= MeasureTransform( "TransformPoints( VectorArray )", count, rounds, reference, [ & ]() {
+		TransformPoints( matrix, array, arrayOut );
+	}, arrayResult );
+	passed &= MeasureTransform( "TransformPoints( VectorArray ) parallel", count, rounds, reference, [ & ]() {
+		TransformPoints( matrix, array, arrayOut, true );
+	}, arrayResult );
+	return passed ? 0 : 1;
+}
+
+// pole matic
+
+namespace {
+
+	// posuny vstupnich podpoli pri kontrole zbytku pole, pokryva vsechny pozice vuci davkam po 4 a 8 maticich
+	const std::size_t TAIL_OFFSETS = 16;
+	const std::size_t MAX_TAIL = 7;
+
+	// nahodne afinni matice: rotace, meritko < 0.5; 2 > (i zaporne) a posun
+	std::vector< Matrix > MakeAffineMatrices( const std::size_t count, std::mt19937& random ) {
+		std::uniform_real_distribution< float > component( -1.0f, 1.0f );
+		std::uniform_real_distribution< float > scale( 0.5f, 2.0f );
+		std::uniform_real_distribution< float > position( -100.0f, 100.0f );
+		std::vector< Matrix > matrices( count );
+		for ( Matrix& matrix : matrices ) {
+			Vector axis( component( random ), component( random ), component( random ), 0 );
+			axis.Normalize();
+			matrix.RotateAxis( axis, component( random ) * 3.0f );
+			matrix.Scale( scale( random ) * ( component( random ) < 0 ? -1.0f : 1.0f ), scale( random ), scale( random ) );
+			matrix.Translate( position( random ), position( random ), position( random ) );
+		}
+		return matrices;
+	}
+
+	// nejvetsi odchylka prvku vztazena k nejvetsi absolutni hodnote prvku reference (nejmene 1)
+	double GetMatrixError( const float* const result, const float* const reference ) {
+		double scale = 1.0;
+		for ( std::size_t i = 0; i < 16; i++ ) {
+			scale = std::fmax( scale, std::fabs( static_cast< double >( reference[ i ] ) ) );
+		}
+		double error = 0;
+		for ( std::size_t i = 0; i < 16; i++ ) {
+			const double difference = std::fabs( static_cast< double >( result[ i ] ) - static_cast< double >( reference[ i ] ) ) / scale;
+			error = std::fmax( error, difference <= INFINITY ? difference : INFINITY );
+		}
+		return error;
+	}
+
+	/*
+	Kontrola operace nad polem matic function( in, out, count, streaming, parallel ):
+	chyba proti vysledkum operaci Matrix (bound 0 vyzaduje shodne bajty), paralelni a streaming vysledek
+	musi byt shodny se serialnim a stejne tak podpole o 1 - MAX_TAIL maticich na kazdem z TAIL_OFFSETS posunu.
+	*/
+	template < typename Out, typename Function >
+	bool CheckMatrixOperation( const char* const name, const std::vector< Matrix >& in, const std::vector< Out >& reference, const double bound, const int rounds, Function function ) {
+		static_assert( sizeof( Out ) == 16 * sizeof( float ), "Out must be a 4x4 float matrix" );
+		const std::size_t count = in.size();
+		std::vector< Out > serial( count );
+		function( in.data(), serial.data(), count, false, false );
+		BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			function( in.data(), serial.data(), count, false, false );
+		}
+		const double serialSeconds = Seconds( begin, BenchmarkClock::now() );
+
+		std::vector< Out > parallel( count );
+		function( in.data(), parallel.data(), count, false, true );
+		begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			function( in.data(), parallel.data(), count, false, true );
+		}
+		const double parallelSeconds = Seconds( begin, BenchmarkClock::now() );
+
+		double error = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const float* const result = &serial[ i ].m[ 0 ][ 0 ];
+			const float* const expected = &reference[ i ].m[ 0 ][ 0 ];
+			error = std::fmax( error, bound > 0 ? GetMatrixError( result, expected ) : ( std::memcmp( result, expected, sizeof( Out ) ) == 0 ? 0 : INFINITY ) );
+		}
+
+		std::size_t mismatches = std::memcmp( parallel.data(), serial.data(), count * sizeof( Out ) ) != 0 ? 1 : 0;
+		std::vector< Out > streamed( count );
+		function( in.data(), streamed.data(), count, true, false );
+		mismatches += std::memcmp( streamed.data(), serial.data(), count * sizeof( Out ) ) != 0 ? 1 : 0;
+		function( in.data(), streamed.data(), count, true, true );
+		mismatches += std::memcmp( streamed.data(), serial.data(), count * sizeof( Out ) ) != 0 ? 1 : 0;
+		Out part[ MAX_TAIL ];
+		for ( std::size_t partCount = 1; partCount <= MAX_TAIL; partCount++ ) {
+			for ( std::size_t offset = 0; offset < TAIL_OFFSETS; offset++ ) {
+				for ( int streaming = 0; streaming < 2; streaming++ ) {
+					function( &in[ offset ], part, partCount, streaming != 0, false );
+					mismatches += std::memcmp( part, &serial[ offset ], partCount * sizeof( Out ) ) != 0 ? 1 : 0;
+				}
+			}
+		}
+
+		const bool passed = error <= bound && mismatches == 0;
+		const double scale = 1e9 / static_cast< double >( rounds ) / static_cast< double >( count );
+		std::printf( "  %-40s %6.2f ns/matrix, parallel %6.2f ns/matrix, max error %.2e (bound %.1e), %zu mismatches %s\n",
+			name, serialSeconds * scale, parallelSeconds * scale, error, bound, mismatches, passed ? "" : "FAILED" );
+		return passed;
+	}
+}
+
+/*
+Operace MatrixArray.h nad 256k afinnimi maticemi (quick 16k) proti operacim tridy Matrix:
+MultiplyMatrices a StoreColumnMajor bez nasobeni musi dat shodne bajty jako Matrix::Mul a Matrix::StoreColumnMajor,
+InverseAffineMatrices a StoreColumnMajor s nasobenim se lisi jen zaokrouhlenim (jiny postup a poradi FMA).
+Paralelni a streaming varianty a zbytky pole o 1 - 7 maticich musi dat stejny vysledek jako serialni beh.
+Vraci 1, pokud nektera kontrola selze.
+*/
+int RunMatrixArrayBenchmark( const BenchmarkOptions& options ) {
+	// pocet neni nasobkem 8, konec pole prochazi zbytkem za davkami
+	const std::size_t count = Iterations( options, 256 * 1024 ) + 5;
+	const int rounds = 8;
+	std::printf( "%zu matrices, %u threads\n", count, GetParallelThreadsCount() );
+
+	std::mt19937 random( 53 );
+	const std::vector< Matrix > matrices = MakeAffineMatrices( count, random );
+
+	// obecna (neafinni) matice, napr. view * projection
+	std::uniform_real_distribution< float > component( -1.0f, 1.0f );
+	Matrix m;
+	for ( std::size_t i = 0; i < 16; i++ ) {
+		m.m[ i / 4 ][ i % 4 ] = component( random );
+	}
+
+	std::vector< Matrix > products( count );
+	std::vector< Matrix > inverses( count );
+	std::vector< Float4x4 > columns( count );
+	std::vector< Float4x4 > productColumns( count );
+	for ( std::size_t i = 0; i < count; i++ ) {
+		products[ i ] = matrices[ i ];
+		products[ i ].Mul( m );
+		inverses[ i ] = matrices[ i ];
+		inverses[ i ].Inverse();
+		matrices[ i ].StoreColumnMajor( columns[ i ] );
+		products[ i ].StoreColumnMajor( productColumns[ i ] );
+	}
+
+	bool passed = true;
+	passed &= CheckMatrixOperation( "MultiplyMatrices", matrices, products, 0, rounds,
+		[ & ]( const Matrix* const in, Matrix* const out, const std::size_t n, const bool, const bool parallel ) {
+			MultiplyMatrices( in, m, out, n, parallel );
+		} );
+	passed &= CheckMatrixOperation( "InverseAffineMatrices", matrices, inverses, 2e-6, rounds,
+		[]( const Matrix* const in, Matrix* const out, const std::size_t n, const bool, const bool parallel ) {
+			InverseAffineMatrices( in, out, n, parallel );
+		} );
+	passed &= CheckMatrixOperation( "StoreColumnMajor", matrices, columns, 0, rounds,
+		[]( const Matrix* const in, Float4x4* const out, const std::size_t n, const bool streaming, const bool parallel ) {
+			StoreColumnMajor( in, out, n, streaming, parallel );
+		} );
+	passed &= CheckMatrixOperation( "StoreColumnMajor( m )", matrices, productColumns, 5e-7, rounds,
+		[ & ]( const Matrix* const in, Float4x4* const out, const std::size_t n, const bool streaming, const bool parallel ) {
+			StoreColumnMajor( in, m, out, n, streaming, parallel );
+		} );
+	return passed ? 0 : 1;
+}
+
+// transformace a kvaterniony proti maticim
+
+namespace {
+
+	const float PI = 3.14159265358979323846f;
+
+	// odchylky od maticoveho vypoctu (chyba vztazena k nejvetsi hodnote matice, GetMatrixError)
+	const double ROTATION_BOUND = 2e-6;
+	const double TRANSFORM_BOUND = 6e-6;
+	const double INTERPOLATION_BOUND = 4e-6;
+	const double HIERARCHY_BOUND = 2e-5;
+
+	// uzly jedne hierarchie (kazdy HIERARCHY_SIZE uzel je koren), omezuje hloubku a tim hromadeni zaokrouhleni
+	const std::size_t HIERARCHY_SIZE = 32;
+
+	// rotace zadana osou a uhlem, stejna rotace vytvorena kvaternionem a matici
+	struct Rotation {
+		Quaternion quaternion;
+		Matrix matrix;
+	};
+
+	struct TransformSample {
+		Transform transform;
+		Matrix matrix;
+	};
+
+	Vector MakeAxis( std::mt19937& random ) {
+		std::uniform_real_distribution< float > component( -1.0f, 1.0f );
+		Vector axis;
+		do {
+			axis = Vector( component( random ), component( random ), component( random ), 0 );
+		} while ( axis.GetLength() < 0.1f );
+		return axis;
+	}
+
+	Rotation MakeRotation( std::mt19937& random ) {
+		std::uniform_real_distribution< float > angle( -PI, PI );
+		const Vector axis = MakeAxis( random );
+		const float rad = angle( random );
+		Rotation rotation;
+		rotation.quaternion.RotateAxis( axis, rad );
+		rotation.matrix.RotateAxis( axis, rad );
+		return rotation;
+	}
+
+	// transformace a odpovidajici matice scale * rotation * translation, pri uniform je meritko uniformni
+	TransformSample MakeTransform( std::mt19937& random, const bool uniform ) {
+		std::uniform_real_distribution< float > scale( 0.8f, 1.25f );
+		std::uniform_real_distribution< float > position( -10.0f, 10.0f );
+		const Rotation rotation = MakeRotation( random );
+		const float sx = scale( random );
+		const Vector scaling = uniform ? Vector( sx, sx, sx, 0 ) : Vector( sx, scale( random ), scale( random ), 0 );
+		const Vector translation( position( random ), position( random ), position( random ), 0 );
+		TransformSample sample;
+		sample.transform = Transform( translation, rotation.quaternion, scaling );
+		sample.matrix.Scale( scaling );
+		sample.matrix.Mul( rotation.matrix );
+		sample.matrix.Translate( translation );
+		return sample;
+	}
+
+	Matrix GetMatrix( const Transform& transform ) {
+		Matrix matrix;
+		transform.StoreMatrix( matrix );
+		return matrix;
+	}
+
+	Matrix GetMatrix( const Quaternion& quaternion ) {
+		Matrix matrix;
+		quaternion.StoreMatrix( matrix );
+		return matrix;
+	}
+
+	// aktualizuje nejvetsi chybu result proti reference
+	void UpdateError( double& error, const Matrix& result, const Matrix& reference ) {
+		error = std::fmax( error, GetMatrixError( &result.m[ 0 ][ 0 ], &reference.m[ 0 ][ 0 ] ) );
+	}
+
+	bool ReportError( const char* const name, const double error, const double bound ) {
+		const bool passed = error <= bound;
+		std::printf( "  %-40s max error %.2e (bound %.1e) %s\n", name, error, bound, passed ? "" : "FAILED" );
+		return passed;
+	}
+
+	/*
+	Rotace kvaternionu proti Matrix::RotateAxis a Matrix::Rotate, Quaternion( const Matrix& ) a zpet,
+	Transform::StoreMatrix, rozklad Transform( const Matrix& ) (i se zrcadlenim), Mul a Inverse pro uniformni meritko.
+	*/
+	bool CheckTransforms( const std::size_t count, std::mt19937& random ) {
+		std::uniform_real_distribution< float > angle( -PI, PI );
+		double rotationError = 0;
+		double rollPitchYawError = 0;
+		double fromMatrixError = 0;
+		double storeError = 0;
+		double decomposeError = 0;
+		double mulError = 0;
+		double inverseError = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const Rotation rotation = MakeRotation( random );
+			UpdateError( rotationError, GetMatrix( rotation.quaternion ), rotation.matrix );
+			UpdateError( fromMatrixError, GetMatrix( Quaternion( rotation.matrix ) ), rotation.matrix );
+
+			const float roll = angle( random );
+			const float pitch = angle( random );
+			const float yaw = angle( random );
+			Quaternion quaternion;
+			quaternion.Rotate( roll, pitch, yaw );
+			Matrix matrix;
+			matrix.Rotate( roll, pitch, yaw );
+			UpdateError( rollPitchYawError, GetMatrix( quaternion ), matrix );
+
+			const TransformSample a = MakeTransform( random, ( i & 1 ) != 0 );
+			UpdateError( storeError, GetMatrix( a.transform ), a.matrix );
+			Matrix mirrored = a.matrix;
+			mirrored.Scale( ( i & 2 ) != 0 ? -1.0f : 1.0f, 1.0f, 1.0f );
+			UpdateError( decomposeError, GetMatrix( Transform( mirrored ) ), mirrored );
+
+			const TransformSample b = MakeTransform( random, true );
+			Transform product = a.transform;
+			product.Mul( b.transform );
+			Matrix productMatrix = a.matrix;
+			productMatrix.Mul( b.matrix );
+			UpdateError( mulError, GetMatrix( product ), productMatrix );
+
+			Transform inverse = b.transform;
+			inverse.Inverse();
+			Matrix inverseMatrix = b.matrix;
+			inverseMatrix.Inverse();
+			UpdateError( inverseError, GetMatrix( inverse ), inverseMatrix );
+		}
+		bool passed = true;
+		passed &= ReportError( "Quaternion::RotateAxis", rotationError, ROTATION_BOUND );
+		passed &= ReportError( "Quaternion::Rotate", rollPitchYawError, ROTATION_BOUND );
+		passed &= ReportError( "Quaternion( const Matrix& )", fromMatrixError, ROTATION_BOUND );
+		passed &= ReportError( "Transform::StoreMatrix", storeError, TRANSFORM_BOUND );
+		passed &= ReportError( "Transform( const Matrix& )", decomposeError, TRANSFORM_BOUND );
+		passed &= ReportError( "Transform::Mul", mulError, TRANSFORM_BOUND );
+		passed &= ReportError( "Transform::Inverse", inverseError, TRANSFORM_BOUND );
+		return passed;
+	}
+
+	/*
+	Interpolace mezi a a b = a nasledovana rotaci o uhel angle (|angle| < pi, kratsi cesta) proti matici a
+	nasledovane rotaci o cast uhlu: Slerp t * angle, Nlerp 2 * atan2( t * sin( phi ), 1 - t + t * cos( phi ) ), phi = angle / 2.
+	Kvaternion b je nahodne obracen (-b je stejna rotace), male uhly pokryvaji vetev Slerp pres Nlerp.
+	*/
+	bool CheckInterpolation( const std::size_t count, std::mt19937& random ) {
+		std::uniform_real_distribution< float > angle( -3.1f, 3.1f );
+		std::uniform_real_distribution< float > small( -0.1f, 0.1f );
+		std::uniform_real_distribution< float > parameter( 0, 1.0f );
+		double slerpError = 0;
+		double nlerpError = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const Rotation a = MakeRotation( random );
+			const Vector axis = MakeAxis( random );
+			const float rad = ( i & 1 ) != 0 ? angle( random ) : small( random );
+			Quaternion b = a.quaternion;
+			b.RotateAxis( axis, rad );
+			if ( ( i & 2 ) != 0 ) {
+				b = Quaternion( -b.x, -b.y, -b.z, -b.w );
+			}
+			const float t = ( i & 12 ) == 0 ? static_cast< float >( ( i >> 4 ) & 1 ) : parameter( random );
+
+			Matrix slerp = a.matrix;
+			slerp.RotateAxis( axis, t * rad );
+			UpdateError( slerpError, GetMatrix( Quaternion::Slerp( a.quaternion, b, t ) ), slerp );
+
+			const double phi = std::fabs( static_cast< double >( rad ) ) * 0.5;
+			const double alpha = std::atan2( t * std::sin( phi ), 1.0 - t + t * std::cos( phi ) );
+			Matrix nlerp = a.matrix;
+			nlerp.RotateAxis( axis, static_cast< float >( rad < 0 ? -2.0 * alpha : 2.0 * alpha ) );
+			UpdateError( nlerpError, GetMatrix( Quaternion::Nlerp( a.quaternion, b, t ) ), nlerp );
+		}
+		bool passed = true;
+		passed &= ReportError( "Quaternion::Slerp", slerpError, INTERPOLATION_BOUND );
+		passed &= ReportError( "Quaternion::Nlerp", nlerpError, INTERPOLATION_BOUND );
+		return passed;
+	}
+}
+
+/*
+Transform a Quaternion proti maticovemu vypoctu (Matrix::RotateAxis, Rotate, Mul, Inverse): rotace, StoreMatrix, rozklad matice,
+Mul, Inverse, Slerp a Nlerp. ComposeHierarchy nad 256k uzly (quick 16k) proti soucinu matic lokalnich transformaci,
+ulozene matice musi byt shodne s Transform::StoreMatrix world transformaci. Vraci 1, pokud nektera kontrola selze.
+*/
+int RunTransformHierarchyBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 256 * 1024 );
+	const int rounds = 8;
+	std::printf( "%zu nodes\n", count );
+
+	std::mt19937 random( 59 );
+	bool passed = CheckTransforms( Iterations( options, 64 * 1024 ), random );
+	passed &= CheckInterpolation( Iterations( options, 64 * 1024 ), random );
+
+	// rodic je nahodny drivejsi uzel stejne hierarchie, meritko rodicu je uniformni (presny soucin transformaci)
+	std::vector< uint32_t > parents( count );
+	std::vector< bool > hasChildren( count, false );
+	for ( std::size_t i = 0; i < count; i++ ) {
+		const std::size_t root = i - i % HIERARCHY_SIZE;
+		parents[ i ] = i == root ? TRANSFORM_ROOT : static_cast< uint32_t >( std::uniform_int_distribution< std::size_t >( root, i - 1 )( random ) );
+		if ( parents[ i ] != TRANSFORM_ROOT ) {
+			hasChildren[ parents[ i ] ] = true;
+		}
+	}
+	std::vector< Transform > local( count );
+	std::vector< Matrix > localMatrices( count );
+	for ( std::size_t i = 0; i < count; i++ ) {
+		const TransformSample sample = MakeTransform( random, hasChildren[ i ] );
+		local[ i ] = sample.transform;
+		localMatrices[ i ] = sample.matrix;
+	}
+
+	std::vector< Matrix > reference( count );
+	const BenchmarkClock::time_point matrixBegin = BenchmarkClock::now();
+	for ( int round = 0; round < rounds; round++ ) {
+		for ( std::size_t i = 0; i < count; i++ ) {
+			reference[ i ] = localMatrices[ i ];
+			if ( parents[ i ] != TRANSFORM_ROOT ) {
+				reference[ i ].Mul( reference[ parents[ i ] ] );
+			}
+		}
+		DoNotOptimize( reference.data() );
+	}
+	const double matrixSeconds = Seconds( matrixBegin, BenchmarkClock::now() );
+
+	std::vector< Transform > world( count );
+	std::vector< Matrix > worldMatrices( count );
+	const BenchmarkClock::time_point begin = BenchmarkClock::now();
+	for ( int round = 0; round < rounds; round++ ) {
+		ComposeHierarchy( local.data(), parents.data(), world.data(), worldMatrices.data(), count );
+		DoNotOptimize( worldMatrices.data() );
+	}
+	const double seconds = Seconds( begin, BenchmarkClock::now() );
+	const double scale = 1e9 / static_cast< double >( rounds ) / static_cast< double >( count );
+	std::printf( "  %-40s %6.2f ns/node (Matrix::Mul chain %6.2f ns/node)\n", "ComposeHierarchy", seconds * scale, matrixSeconds * scale );
+
+	double error = 0;
+	std::size_t mismatches = 0;
+	for ( std::size_t i = 0; i < count; i++ ) {
+		UpdateError( error, worldMatrices[ i ], reference[ i ] );
+		const Matrix stored = GetMatrix( world[ i ] );
+		mismatches += std::memcmp( &stored, &worldMatrices[ i ], sizeof( Matrix ) ) != 0 ? 1 : 0;
+	}
+	passed &= ReportError( "ComposeHierarchy", error, HIERARCHY_BOUND );
+	std::printf( "  %-40s %zu mismatches %s\n", "ComposeHierarchy matrices", mismatches, mismatches == 0 ? "" : "FAILED" );
+	return passed && mismatches == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,380 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Framework/Half.h"
+#include "Framework/PackedArray.h"
+#include "Framework/VertexPacking.h"
+#include "Benchmark.h"
+
+// kodovani vertexu
+
+namespace {
+
+	// dokumentovane uhlove chyby (VertexPacking.h) ve stupnich
+	const double NORMAL_ERROR_BOUND = 0.005;
+	const double TANGENT_FRAME_ERROR_BOUND = 0.01;
+
+	// tangenty s |cos| uhlu k normale nad touto hodnotou se negeneruji (chybu tam urcuje uz ortogonalizace ve float)
+	const float PARALLEL_LIMIT = 0.99f;
+
+	const double DEGREES = 180.0 / 3.14159265358979323846;
+
+	struct Axis {
+		double x, y, z;
+	};
+
+	Axis Normalized( const double x, const double y, const double z ) {
+		const double length = std::sqrt( x * x + y * y + z * z );
+		return Axis{ x / length, y / length, z / length };
+	}
+
+	Axis Cross( const Axis& a, const Axis& b ) {
+		return Axis{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	// uhel mezi jednotkovymi vektory ve stupnich (atan2 je presny i pro male uhly)
+	double GetAngle( const Axis& a, const Axis& b ) {
+		const Axis cross = Cross( a, b );
+		const double sin = std::sqrt( cross.x * cross.x + cross.y * cross.y + cross.z * cross.z );
+		return std::atan2( sin, a.x * b.x + a.y * b.y + a.z * b.z ) * DEGREES;
+	}
+
+	// osy ( tangent, bitangent, normal ) z nezakodovanych dat, tangenta ortogonalizovana k normale v double
+	void GetFrame( const Float3& normal, const Float4& tangent, Axis& t, Axis& b, Axis& n ) {
+		n = Normalized( normal.x, normal.y, normal.z );
+		const double d = n.x * tangent.x + n.y * tangent.y + n.z * tangent.z;
+		t = Normalized( tangent.x - n.x * d, tangent.y - n.y * d, tangent.z - n.z * d );
+		const Axis cross = Cross( n, t );
+		const double w = tangent.w < 0 ? -1.0 : 1.0;
+		b = Axis{ cross.x * w, cross.y * w, cross.z * w };
+	}
+
+	// |cos| uhlu mezi vektory (NaN pro nulovy vektor)
+	double GetCos( const Float3& a, const Float3& b ) {
+		const Axis na = Normalized( a.x, a.y, a.z );
+		const Axis nb = Normalized( b.x, b.y, b.z );
+		return std::fabs( na.x * nb.x + na.y * nb.y + na.z * nb.z );
+	}
+
+	/*
+	Nahodne nenormalizovane normaly a tangenty s nahodnou orientaci bitangenty,
+	na zacatku osy a jejich zaporne smery (vetve kodovani podle nejvetsi slozky, dolni polokoule, -0).
+	*/
+	void MakeVertices( const std::size_t count, std::vector< Float3 >& normals, std::vector< Float4 >& tangents ) {
+		const Float3 axes[] = {
+			Float3( 1.0f, 0, 0 ), Float3( -1.0f, 0, 0 ), Float3( 0, 1.0f, 0 ), Float3( 0, -1.0f, 0 ),
+			Float3( 0, 0, 1.0f ), Float3( 0, 0, -1.0f ), Float3( -0.0f, -0.0f, -1.0f ), Float3( 1.0f, 1.0f, -1.0f )
+		};
+		const std::size_t axesCount = sizeof( axes ) / sizeof( axes[ 0 ] );
+		std::mt19937 random( 47 );
+		std::uniform_real_distribution< float > component( -1.0f, 1.0f );
+		std::uniform_real_distribution< float > scale( 0.25f, 4.0f );
+		normals.resize( count );
+		tangents.resize( count );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			Float3 normal;
+			Float3 tangent;
+			if ( i < axesCount * axesCount ) {
+				// rovnobezna dvojice os, tangenta je nahrazena nasledujici nerovnobeznou osou
+				normal = axes[ i / axesCount ];
+				std::size_t j = i % axesCount;
+				while ( GetCos( normal, axes[ j ] ) > PARALLEL_LIMIT ) {
+					j = ( j + 1 ) % axesCount;
+				}
+				tangent = axes[ j ];
+			} else {
+				do {
+					const float normalScale = scale( random );
+					const float tangentScale = scale( random );
+					normal = Float3( component( random ) * normalScale, component( random ) * normalScale, component( random ) * normalScale );
+					tangent = Float3( component( random ) * tangentScale, component( random ) * tangentScale, component( random ) * tangentScale );
+				} while ( !( GetCos( normal, tangent ) <= PARALLEL_LIMIT ) );
+			}
+			normals[ i ] = normal;
+			tangents[ i ] = Float4( tangent.x, tangent.y, tangent.z, ( random() & 1 ) != 0 ? 1.0f : -1.0f );
+		}
+	}
+
+	// count opakovani function(), vypise ns na vertex
+	template < typename Function >
+	void MeasurePacking( const char* const name, const std::size_t count, const int rounds, Function function ) {
+		function();
+		const BenchmarkClock::time_point begin = BenchmarkClock::now();
+		for ( int round = 0; round < rounds; round++ ) {
+			function();
+		}
+		const double seconds = Seconds( begin, BenchmarkClock::now() );
+		std::printf( "  %-40s %6.2f ns/vertex\n", name, seconds * 1e9 / static_cast< double >( rounds ) / static_cast< double >( count ) );
+	}
+
+	bool CheckNormals( const std::vector< Float3 >& normals, const std::vector< SNorm2x16 >& packed ) {
+		std::vector< Float3 > decoded( normals.size() );
+		UnpackNormals( packed.data(), decoded.data(), normals.size() );
+		double maxError = 0;
+		for ( std::size_t i = 0; i < normals.size(); i++ ) {
+			const Axis n = Normalized( normals[ i ].x, normals[ i ].y, normals[ i ].z );
+			maxError = std::fmax( maxError, GetAngle( n, Axis{ decoded[ i ].x, decoded[ i ].y, decoded[ i ].z } ) );
+		}
+		const bool passed = maxError <= NORMAL_ERROR_BOUND;
+		std::printf( "  %-40s %.5f deg (bound %.3f) %s\n", "PackNormals max angular error", maxError, NORMAL_ERROR_BOUND, passed ? "" : "FAILED" );
+		return passed;
+	}
+
+	bool CheckTangentFrames( const std::vector< Float3 >& normals, const std::vector< Float4 >& tangents, const std::vector< SNorm4x16 >& packed ) {
+		const std::size_t count = normals.size();
+		std::vector< Float3 > decodedNormals( count );
+		std::vector< Float4 > decodedTangents( count );
+		UnpackTangentFrames( packed.data(), decodedNormals.data(), decodedTangents.data(), count );
+		double maxError = 0;
+		std::size_t handednessErrors = 0;
+		for ( std::size_t i = 0; i < count; i++ ) {
+			Axis t, b, n;
+			GetFrame( normals[ i ], tangents[ i ], t, b, n );
+			Axis decodedT, decodedB, decodedN;
+			GetFrame( decodedNormals[ i ], decodedTangents[ i ], decodedT, decodedB, decodedN );
+			maxError = std::fmax( maxError, std::fmax( GetAngle( t, decodedT ), std::fmax( GetAngle( b, decodedB ), GetAngle( n, decodedN ) ) ) );
+			handednessErrors += ( decodedTangents[ i ].w < 0 ) != ( tangents[ i ].w < 0 ) ? 1 : 0;
+		}
+		const bool passed = maxError <= TANGENT_FRAME_ERROR_BOUND && handednessErrors == 0;
+		std::printf( "  %-40s %.5f deg (bound %.3f), %zu handedness errors %s\n", "PackTangentFrames max angular error", maxError, TANGENT_FRAME_ERROR_BOUND, handednessErrors, passed ? "" : "FAILED" );
+		return passed;
+	}
+
+	/*
+	Vysledek nesmi zaviset na pozici vertexu v poli: podpole o 1 - 7 prvcich (zbytek pole za SSE2 kernelem)
+	na kazdem posunu a zapis se stride vertexu musi dat stejne bajty jako kodovani celeho pole.
+	*/
+	bool CheckTangentFramePositions( const std::vector< Float3 >& normals, const std::vector< Float4 >& tangents, const std::vector< SNorm4x16 >& packed, const std::size_t checked ) {
+		std::size_t mismatches = 0;
+		SNorm4x16 part[ 7 ];
+		for ( std::size_t count = 1; count <= 7; count++ ) {
+			for ( std::size_t offset = 0; offset + count <= checked; offset++ ) {
+				PackTangentFrames( &normals[ offset ], &tangents[ offset ], part, count );
+				mismatches += std::memcmp( part, &packed[ offset ], count * sizeof( SNorm4x16 ) ) != 0 ? 1 : 0;
+			}
+		}
+
+		// prokladany vertex ( pozice, tangentni prostor ), stride neni nasobkem 16
+		const std::size_t stride = 20;
+		std::vector< char > interleaved( checked * stride );
+		PackTangentFrames( normals.data(), tangents.data(), reinterpret_cast< SNorm4x16* >( interleaved.data() ), checked, stride );
+		for ( std::size_t i = 0; i < checked; i++ ) {
+			mismatches += std::memcmp( &interleaved[ i * stride ], &packed[ i ], sizeof( SNorm4x16 ) ) != 0 ? 1 : 0;
+		}
+		const bool passed = mismatches == 0;
+		std::printf( "  %-40s %zu mismatches %s\n", "PackTangentFrames subarrays and stride", mismatches, passed ? "" : "FAILED" );
+		return passed;
+	}
+}
+
+/*
+Kodovani 1M vertexu (quick 64k): uhlova chyba normal a tangentnich prostoru po dekodovani proti mezim z VertexPacking.h,
+zachovani orientace bitangenty, nezavislost vysledku na pozici v poli a stride, cena kodovani.
+Pocet vertexu neni nasobkem 4, posledni prvky prochazi zbytkem pole. Vraci 1, pokud nektera kontrola selze.
+*/
+int RunVertexBenchmark( const BenchmarkOptions& options ) {
+	const std::size_t count = Iterations( options, 1024 * 1024 ) + 3;
+	const int rounds = 8;
+	std::printf( "%zu vertices\n", count );
+
+	std::vector< Float3 > normals;
+	std::vector< Float4 > tangents;
+	MakeVertices( count, normals, tangents );
+
+	std::vector< SNorm2x16 > packedNormals( count );
+	MeasurePacking( "PackNormals", count, rounds, [ & ]() {
+		PackNormals( normals.data(), packedNormals.data(), count );
+		DoNotOptimize( packedNormals.data() );
+	} );
+	std::vector< SNorm4x16 > packedFrames( count );
+	MeasurePacking( "PackTangentFrames", count, rounds, [ & ]() {
+		PackTangentFrames( normals.data(), tangents.data(), packedFrames.data(), count );
+		DoNotOptimize( packedFrames.data() );
+	} );
+
+	bool passed = CheckNormals( normals, packedNormals );
+	passed &= CheckTangentFrames( normals, tangents, packedFrames );
+	passed &= CheckTangentFramePositions( normals, tangents, packedFrames, options.quick ? 1024 : 16 * 1024 );
+	return passed ? 0 : 1;
+}
+
+// prevod mezi typy pro ukladani a vypocty
+
+namespace {
+
+	// pocty prvku: prazdne pole, jeden prvek (PackedFloat3 zpracovava posledni prvek zvlast), liche pocty, vice bloku Half2
+	const std::size_t PACKED_COUNTS[] = { 0, 1, 2, 3, 5, 7, 255, 257, 1001 };
+
+	// posuny zacatku zdrojoveho pole, PackedFloat3 se tak cte ze vsech zarovnani vuci 16 bajtum
+	const std::size_t PACKED_OFFSETS = 4;
+
+	// slozka w vektoru nacteneho z PackedFloat3
+	const float PACKED_W = 7.0f;
+
+	// vyplne poli pred nactenim a zapisem se lisi, aby zapis vyplne FloatN za koncem pole nevypadal jako neprepsany prvek
+	const unsigned char UNPACKED_GUARD = 0xab;
+	const unsigned char PACKED_GUARD = 0xcd;
+
+	bool SameBits( const float a, const float b ) {
+		return std::memcmp( &a, &b, sizeof( float ) ) == 0;
+	}
+
+	// nahodne bity bez NaN (bity NaN se pri prevodu zachovat nemusi)
+	float RandomFloat( std::mt19937& random ) {
+		float value;
+		do {
+			const uint32_t bits = random();
+			std::memcpy( &value, &bits, sizeof( value ) );
+		} while ( std::isnan( value ) );
+		return value;
+	}
+
+	uint16_t RandomHalf( std::mt19937& random ) {
+		uint16_t value;
+		do {
+			value = static_cast< uint16_t >( random() );
+		} while ( ( value & 0x7c00 ) == 0x7c00 && ( value & 0x03ff ) != 0 );
+		return value;
+	}
+
+	void Randomize( PackedFloat2& value, std::mt19937& random ) {
+		value = PackedFloat2( RandomFloat( random ), RandomFloat( random ) );
+	}
+
+	void Randomize( PackedFloat3& value, std::mt19937& random ) {
+		value = PackedFloat3( RandomFloat( random ), RandomFloat( random ), RandomFloat( random ) );
+	}
+
+	void Randomize( PackedFloat4& value, std::mt19937& random ) {
+		value = PackedFloat4( RandomFloat( random ), RandomFloat( random ), RandomFloat( random ), RandomFloat( random ) );
+	}
+
+	void Randomize( Half2& value, std::mt19937& random ) {
+		value = Half2{ RandomHalf( random ), RandomHalf( random ) };
+	}
+
+	void Randomize( Half4& value, std::mt19937& random ) {
+		value = Half4{ RandomHalf( random ), RandomHalf( random ), RandomHalf( random ), RandomHalf( random ) };
+	}
+
+	void Randomize( UNorm4x8& value, std::mt19937& random ) {
+		const uint32_t bits = random();
+		std::memcpy( &value, &bits, sizeof( value ) );
+	}
+
+	// nacteny prvek odpovida ulozenemu
+	bool Matches( const PackedFloat2& packed, const Float2& value ) {
+		return SameBits( packed.x, value.x ) && SameBits( packed.y, value.y );
+	}
+
+	bool Matches( const PackedFloat3& packed, const Float3& value ) {
+		return SameBits( packed.x, value.x ) && SameBits( packed.y, value.y ) && SameBits( packed.z, value.z );
+	}
+
+	bool Matches( const PackedFloat4& packed, const Float4& value ) {
+		return SameBits( packed.x, value.x ) && SameBits( packed.y, value.y ) && SameBits( packed.z, value.z ) && SameBits( packed.w, value.w );
+	}
+
+	bool Matches( const PackedFloat3& packed, const Vector& value ) {
+		return SameBits( packed.x, value.x ) && SameBits( packed.y, value.y ) && SameBits( packed.z, value.z ) && value.w == PACKED_W;
+	}
+
+	bool Matches( const PackedFloat4& packed, const Vector& value ) {
+		return SameBits( packed.x, value.x ) && SameBits( packed.y, value.y ) && SameBits( packed.z, value.z ) && SameBits( packed.w, value.w );
+	}
+
+	bool Matches( const Half2& packed, const Float2& value ) {
+		return SameBits( HalfToFloat( packed.x ), value.x ) && SameBits( HalfToFloat( packed.y ), value.y );
+	}
+
+	bool Matches( const Half4& packed, const Float4& value ) {
+		return SameBits( HalfToFloat( packed.x ), value.x ) && SameBits( HalfToFloat( packed.y ), value.y ) && SameBits( HalfToFloat( packed.z ), value.z ) && SameBits( HalfToFloat( packed.w ), value.w );
+	}
+
+	bool Matches( const UNorm4x8& packed, const Float4& value ) {
+		return value.x == packed.x / 255.0f && value.y == packed.y / 255.0f && value.z == packed.z / 255.0f && value.w == packed.w / 255.0f;
+	}
+
+	bool IsGuardIntact( const void* const data, const std::size_t bytes, const unsigned char value ) {
+		const unsigned char* const guard = static_cast< const unsigned char* >( data );
+		for ( std::size_t i = 0; i < bytes; i++ ) {
+			if ( guard[ i ] != value ) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	LoadPacked a StorePacked pro dvojici typu pro vsechny PACKED_COUNTS a posuny zdroje: nactene prvky odpovidaji
+	ulozenym, zpetny zapis dava shodne bajty a prvky pred a za polem (i pri count 0) zustanou neprepsany.
+	*/
+	template < typename Packed, typename Unpacked, typename Load, typename Store >
+	bool CheckRoundTrip( const char* const name, std::mt19937& random, Load load, Store store ) {
+		const std::size_t maxCount = PACKED_COUNTS[ sizeof( PACKED_COUNTS ) / sizeof( PACKED_COUNTS[ 0 ] ) - 1 ];
+		std::vector< Packed > source( maxCount + PACKED_OFFSETS );
+		for ( Packed& value : source ) {
+			Randomize( value, random );
+		}
+		std::size_t loadErrors = 0;
+		std::size_t storeErrors = 0;
+		std::size_t guardErrors = 0;
+		for ( const std::size_t count : PACKED_COUNTS ) {
+			for ( std::size_t offset = 0; offset < PACKED_OFFSETS; offset++ ) {
+				const Packed* const src = &source[ offset ];
+				std::vector< Unpacked > unpacked( count + 2 );
+				std::memset( static_cast< void* >( unpacked.data() ), UNPACKED_GUARD, unpacked.size() * sizeof( Unpacked ) );
+				load( src, &unpacked[ 1 ], count );
+				for ( std::size_t i = 0; i < count; i++ ) {
+					loadErrors += Matches( src[ i ], unpacked[ i + 1 ] ) ? 0 : 1;
+				}
+				guardErrors += IsGuardIntact( &unpacked[ 0 ], sizeof( Unpacked ), UNPACKED_GUARD ) && IsGuardIntact( &unpacked[ count + 1 ], sizeof( Unpacked ), UNPACKED_GUARD ) ? 0 : 1;
+
+				std::vector< Packed > packed( count + 2 );
+				std::memset( static_cast< void* >( packed.data() ), PACKED_GUARD, packed.size() * sizeof( Packed ) );
+				store( &unpacked[ 1 ], &packed[ 1 ], count );
+				storeErrors += std::memcmp( &packed[ 1 ], src, count * sizeof( Packed ) ) != 0 ? 1 : 0;
+				guardErrors += IsGuardIntact( &packed[ 0 ], sizeof( Packed ), PACKED_GUARD ) && IsGuardIntact( &packed[ count + 1 ], sizeof( Packed ), PACKED_GUARD ) ? 0 : 1;
+			}
+		}
+		const bool passed = loadErrors == 0 && storeErrors == 0 && guardErrors == 0;
+		std::printf( "  %-40s %zu load, %zu store, %zu guard errors %s\n", name, loadErrors, storeErrors, guardErrors, passed ? "" : "FAILED" );
+		return passed;
+	}
+}
+
+/*
+Round trip LoadPacked -> StorePacked pro kazdou dvojici pretizeni (PackedArray.h) s nahodnymi bity (bez NaN):
+pocty 0, 1, liche a pres vice bloku, zdroj na ruznych zarovnanich, zapis mimo pole. Vraci 1 pri rozdilu.
+*/
+int RunPackedArrayBenchmark( const BenchmarkOptions& ) {
+	std::mt19937 random( 61 );
+	bool passed = true;
+	passed &= CheckRoundTrip< PackedFloat2, Float2 >( "PackedFloat2 <-> Float2", random,
+		[]( const PackedFloat2* const src, Float2* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Float2* const src, PackedFloat2* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< PackedFloat3, Float3 >( "PackedFloat3 <-> Float3", random,
+		[]( const PackedFloat3* const src, Float3* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Float3* const src, PackedFloat3* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< PackedFloat4, Float4 >( "PackedFloat4 <-> Float4", random,
+		[]( const PackedFloat4* const src, Float4* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Float4* const src, PackedFloat4* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< PackedFloat3, Vector >( "PackedFloat3 <-> Vector", random,
+		[]( const PackedFloat3* const src, Vector* const dest, const std::size_t count ) { LoadPacked( src, dest, count, PACKED_W ); },
+		[]( const Vector* const src, PackedFloat3* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< PackedFloat4, Vector >( "PackedFloat4 <-> Vector", random,
+		[]( const PackedFloat4* const src, Vector* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Vector* const src, PackedFloat4* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< Half2, Float2 >( "Half2 <-> Float2", random,
+		[]( const Half2* const src, Float2* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Float2* const src, Half2* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< Half4, Float4 >( "Half4 <-> Float4", random,
+		[]( const Half4* const src, Float4* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Float4* const src, Half4* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	passed &= CheckRoundTrip< UNorm4x8, Float4 >( "UNorm4x8 <-> Float4", random,
+		[]( const UNorm4x8* const src, Float4* const dest, const std::size_t count ) { LoadPacked( src, dest, count ); },
+		[]( const Float4* const src, UNorm4x8* const dest, const std::size_t count ) { StorePacked( src, dest, count ); } );
+	return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,743 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "BlockCompression.h"
+#include "Framework/Parallel.h"
+#include "Framework/Simd.h"
+
+using namespace RenderInterface;
+
+namespace {
+
+	// radky bloku zpracovane jednou casti ParallelFor
+	const std::size_t BLOCK_ROWS_BATCH = 4;
+
+	// iterace mocninne metody (hlavni osa) a zpresneni nejmensimi ctverci
+	const int POWER_ITERATIONS = 8;
+	const int REFINE_ITERATIONS = 2;
+
+	// mensi determinant soustavy nejmensich ctvercu cluster fit se nahradi touto hodnotou
+	const float MIN_DETERMINANT = 1e-6f;
+
+	/*
+	Ruzne barvy bloku, weight je pocet pixelu bloku s danou barvou (shodne pixely se pri hledani zpracuji jednou).
+	pointIndex[ i ] je barva pixelu i, pruhledne pixely BC1 nemaji barvu (-1).
+	*/
+	struct ColorSet {
+		Simd::Vec4 points[ 16 ];
+		float weights[ 16 ];
+		int count;
+		int pointIndex[ 16 ];
+		bool transparent;
+	};
+
+	// koncove body barevneho bloku a indexy barev ColorSet (kody BC1)
+	struct ColorBlockFit {
+		uint16_t color0;
+		uint16_t color1;
+		uint8_t indices[ 16 ];
+		float error;
+	};
+
+	struct AlphaBlockFit {
+		uint8_t alpha0;
+		uint8_t alpha1;
+		uint8_t indices[ 16 ];
+		float error;
+	};
+
+	void BuildColorSet( const uint8_t* const pixels, const bool alphaMask, ColorSet& set ) {
+		uint32_t keys[ 16 ];
+		set.count = 0;
+		set.transparent = false;
+		for ( int i = 0; i < 16; i++ ) {
+			const uint8_t* const pixel = pixels + i * 4;
+			if ( alphaMask && pixel[ 3 ] < 128 ) {
+				set.pointIndex[ i ] = -1;
+				set.transparent = true;
+				continue;
+			}
+			const uint32_t key = pixel[ 0 ] | ( pixel[ 1 ] << 8 ) | ( pixel[ 2 ] << 16 );
+			int point = 0;
+			while ( point < set.count && keys[ point ] != key ) {
+				point++;
+			}
+			if ( point == set.count ) {
+				keys[ point ] = key;
+				set.points[ point ] = Simd::Set( pixel[ 0 ] / 255.0f, pixel[ 1 ] / 255.0f, pixel[ 2 ] / 255.0f, 0 );
+				set.weights[ point ] = 0;
+				set.count++;
+			}
+			set.weights[ point ] += 1.0f;
+			set.pointIndex[ i ] = point;
+		}
+	}
+
+	// mrizka barev 5:6:5
+	inline Simd::Vec4 GetGrid() {
+		return Simd::Set( 31.0f, 63.0f, 31.0f, 0 );
+	}
+
+	inline Simd::Vec4 GetGridInverse() {
+		return Simd::Set( 1.0f / 31.0f, 1.0f / 63.0f, 1.0f / 31.0f, 0 );
+	}
+
+	inline Simd::Vec4 Saturate( const Simd::Vec4 v ) {
+		return Simd::Min( Simd::Max( v, Simd::Zero() ), Simd::Replicate( 1.0f ) );
+	}
+
+	uint16_t PackColor( const Simd::Vec4 color ) {
+		alignas( 16 ) float quantized[ 4 ];
+		Simd::Store( quantized, Simd::Round( Simd::Mul( Saturate( color ), GetGrid() ) ) );
+		return static_cast< uint16_t >( ( static_cast< int >( quantized[ 0 ] ) << 11 ) | ( static_cast< int >( quantized[ 1 ] ) << 5 ) | static_cast< int >( quantized[ 2 ] ) );
+	}
+
+	// rozsireni na 8 bitu opakovanim hornich bitu (jako pri dekodovani GPU)
+	Simd::Vec4 UnpackColor( const uint16_t color ) {
+		const int r = ( color >> 11 ) & 0x1f;
+		const int g = ( color >> 5 ) & 0x3f;
+		const int b = color & 0x1f;
+		return Simd::Set( ( ( r << 3 ) | ( r >> 2 ) ) / 255.0f, ( ( g << 2 ) | ( g >> 4 ) ) / 255.0f, ( ( b << 3 ) | ( b >> 2 ) ) / 255.0f, 0 );
+	}
+
+	inline float SumXYZ( const Simd::Vec4 v ) {
+		return Simd::GetX( Simd::Dot3( v, Simd::Replicate( 1.0f ) ) );
+	}
+
+	/*
+	Vyhodnoti koncove body: kvantovani do 5:6:5, poradi podle rezimu bloku
+	(4 barvy: color0 > color1, 3 barvy a pruhledna: color0 <= color1), indexy nejblizsich barev palety.
+	Pri mensi chybe nez best prepise best.
+	*/
+	void TryEndpoints( const ColorSet& set, const Simd::Vec4 a, const Simd::Vec4 b, const bool threeColor, ColorBlockFit& best ) {
+		uint16_t color0 = PackColor( a );
+		uint16_t color1 = PackColor( b );
+		if ( threeColor ? color0 > color1 : color0 < color1 ) {
+			const uint16_t swap = color0;
+			color0 = color1;
+			color1 = swap;
+		}
+
+		// paleta po slozkach (r, g, b pro 4 indexy), nepouzity index 3 rezimu 3 barev je mimo dosah
+		Simd::Vec4 p0 = UnpackColor( color0 );
+		Simd::Vec4 p1 = UnpackColor( color1 );
+		Simd::Vec4 p2;
+		Simd::Vec4 p3;
+		if ( color0 > color1 ) {
+			p2 = Simd::Mul( Simd::Add( Simd::Add( p0, p0 ), p1 ), Simd::Replicate( 1.0f / 3.0f ) );
+			p3 = Simd::Mul( Simd::Add( Simd::Add( p1, p1 ), p0 ), Simd::Replicate( 1.0f / 3.0f ) );
+		} else {
+			p2 = Simd::Mul( Simd::Add( p0, p1 ), Simd::Replicate( 0.5f ) );
+			p3 = Simd::Replicate( 16.0f );
+		}
+		Simd::Transpose( p0, p1, p2, p3 );
+
+		ColorBlockFit fit;
+		fit.color0 = color0;
+		fit.color1 = color1;
+		fit.error = 0;
+		alignas( 16 ) float distances[ 4 ];
+		for ( int i = 0; i < set.count; i++ ) {
+			const Simd::Vec4 point = set.points[ i ];
+			const Simd::Vec4 dr = Simd::Sub( p0, Simd::SplatX( point ) );
+			const Simd::Vec4 dg = Simd::Sub( p1, Simd::SplatY( point ) );
+			const Simd::Vec4 db = Simd::Sub( p2, Simd::SplatZ( point ) );
+			Simd::Store( distances, Simd::MulAdd( db, db, Simd::MulAdd( dg, dg, Simd::Mul( dr, dr ) ) ) );
+			int index = 0;
+			for ( int k = 1; k < 4; k++ ) {
+				if ( distances[ k ] < distances[ index ] ) {
+					index = k;
+				}
+			}
+			fit.indices[ i ] = static_cast< uint8_t >( index );
+			fit.error += distances[ index ] * set.weights[ i ];
+			if ( fit.error >= best.error ) {
+				return;
+			}
+		}
+		best = fit;
+	}
+
+	/*
+	Koncove body pro blok jedne barvy: pro kazdou 8 bitovou hodnotu kanalu dvojice koncovych bodu,
+	jejichz interpolovana hodnota (1/3 pro 4 barvy, 1/2 pro 3 barvy) je nejblize (presnejsi nez kvantovani barvy).
+	*/
+	struct SingleColorTables {
+		uint8_t endpoints[ 2 ][ 2 ][ 256 ][ 2 ];	// [ 3 barvy ][ 6 bitu ][ hodnota ][ koncovy bod ]
+	};
+
+	const SingleColorTables& GetSingleColorTables() {
+		static const SingleColorTables tables = []() {
+			SingleColorTables result;
+			for ( int threeColor = 0; threeColor < 2; threeColor++ ) {
+				for ( int wide = 0; wide < 2; wide++ ) {
+					const int bits = wide != 0 ? 6 : 5;
+					const int levels = 1 << bits;
+					for ( int value = 0; value < 256; value++ ) {
+						int bestError = 0x7fffffff;
+						for ( int e0 = 0; e0 < levels; e0++ ) {
+							for ( int e1 = 0; e1 < levels; e1++ ) {
+								const int v0 = ( e0 << ( 8 - bits ) ) | ( e0 >> ( bits * 2 - 8 ) );
+								const int v1 = ( e1 << ( 8 - bits ) ) | ( e1 >> ( bits * 2 - 8 ) );
+								// chyba v sestinach jednotky: ( 2 * v0 + v1 ) / 3, resp. ( v0 + v1 ) / 2
+								const int interpolated = threeColor != 0 ? ( v0 + v1 ) * 3 : ( v0 * 2 + v1 ) * 2;
+								const int error = std::abs( interpolated - value * 6 );
+								if ( error < bestError ) {
+									bestError = error;
+									result.endpoints[ threeColor ][ wide ][ value ][ 0 ] = static_cast< uint8_t >( v0 );
+									result.endpoints[ threeColor ][ wide ][ value ][ 1 ] = static_cast< uint8_t >( v1 );
+								}
+							}
+						}
+					}
+				}
+			}
+			return result;
+		}();
+		return tables;
+	}
+
+	void SingleColorFit( const ColorSet& set, const uint8_t* const color, const bool threeColor, ColorBlockFit& best ) {
+		const SingleColorTables& tables = GetSingleColorTables();
+		const int mode = threeColor ? 1 : 0;
+		const uint8_t* const r = tables.endpoints[ mode ][ 0 ][ color[ 0 ] ];
+		const uint8_t* const g = tables.endpoints[ mode ][ 1 ][ color[ 1 ] ];
+		const uint8_t* const b = tables.endpoints[ mode ][ 0 ][ color[ 2 ] ];
+		const Simd::Vec4 a = Simd::Set( r[ 0 ] / 255.0f, g[ 0 ] / 255.0f, b[ 0 ] / 255.0f, 0 );
+		const Simd::Vec4 c = Simd::Set( r[ 1 ] / 255.0f, g[ 1 ] / 255.0f, b[ 1 ] / 255.0f, 0 );
+		TryEndpoints( set, a, c, threeColor, best );
+	}
+
+	// hlavni osa vazene kovariancni matice (mocninna metoda)
+	Simd::Vec4 GetPrincipalAxis( const ColorSet& set ) {
+		Simd::Vec4 sum = Simd::Zero();
+		float total = 0;
+		for ( int i = 0; i < set.count; i++ ) {
+			sum = Simd::MulAdd( set.points[ i ], Simd::Replicate( set.weights[ i ] ), sum );
+			total += set.weights[ i ];
+		}
+		const Simd::Vec4 centroid = Simd::Mul( sum, Simd::Replicate( 1.0f / total ) );
+
+		// ( xx, yy, zz ) a ( xy, yz, zx )
+		Simd::Vec4 diagonal = Simd::Zero();
+		Simd::Vec4 offDiagonal = Simd::Zero();
+		for ( int i = 0; i < set.count; i++ ) {
+			const Simd::Vec4 d = Simd::Sub( set.points[ i ], centroid );
+			const Simd::Vec4 wd = Simd::Mul( d, Simd::Replicate( set.weights[ i ] ) );
+			diagonal = Simd::MulAdd( wd, d, diagonal );
+			offDiagonal = Simd::MulAdd( wd, Simd::Swizzle< 1, 2, 0, 3 >( d ), offDiagonal );
+		}
+		alignas( 16 ) float dg[ 4 ];
+		alignas( 16 ) float od[ 4 ];
+		Simd::Store( dg, diagonal );
+		Simd::Store( od, offDiagonal );
+		const float m[ 3 ][ 3 ] = {
+			{ dg[ 0 ], od[ 0 ], od[ 2 ] },
+			{ od[ 0 ], dg[ 1 ], od[ 1 ] },
+			{ od[ 2 ], od[ 1 ], dg[ 2 ] }
+		};
+
+		// pocatecni vektor: radek s nejvetsim prvkem na diagonale (nemuze byt kolmy na hlavni osu)
+		int row = 0;
+		for ( int i = 1; i < 3; i++ ) {
+			if ( m[ i ][ i ] > m[ row ][ row ] ) {
+				row = i;
+			}
+		}
+		float v[ 3 ] = { m[ row ][ 0 ], m[ row ][ 1 ], m[ row ][ 2 ] };
+		for ( int iteration = 0; iteration < POWER_ITERATIONS; iteration++ ) {
+			float next[ 3 ];
+			for ( int i = 0; i < 3; i++ ) {
+				next[ i ] = m[ i ][ 0 ] * v[ 0 ] + m[ i ][ 1 ] * v[ 1 ] + m[ i ][ 2 ] * v[ 2 ];
+			}
+			const float length = fmaxf( fabsf( next[ 0 ] ), fmaxf( fabsf( next[ 1 ] ), fabsf( next[ 2 ] ) ) );
+			if ( length == 0 ) {
+				break;
+			}
+			for ( int i = 0; i < 3; i++ ) {
+				v[ i ] = next[ i ] / length;
+			}
+		}
+		return Simd::Set( v[ 0 ], v[ 1 ], v[ 2 ], 0 );
+	}
+
+	void RangeFit( const ColorSet& set, const Simd::Vec4 axis, const bool threeColor, ColorBlockFit& best ) {
+		int minPoint = 0;
+		int maxPoint = 0;
+		float minProjection = FLT_MAX;
+		float maxProjection = -FLT_MAX;
+		for ( int i = 0; i < set.count; i++ ) {
+			const float projection = Simd::GetX( Simd::Dot3( set.points[ i ], axis ) );
+			if ( projection < minProjection ) {
+				minProjection = projection;
+				minPoint = i;
+			}
+			if ( projection > maxProjection ) {
+				maxProjection = projection;
+				maxPoint = i;
+			}
+		}
+		TryEndpoints( set, set.points[ minPoint ], set.points[ maxPoint ], threeColor, best );
+	}
+
+	/*
+	Koncove body a, b minimalizujici soucet w * | x - ( alpha * a + ( 1 - alpha ) * b ) |^2 pro dane vahy alpha.
+	Vraci false, pokud soustava nema jedine reseni (vsechny body maji stejnou vahu alpha).
+	*/
+	bool SolveEndpoints( const ColorSet& set, const float* const alphas, Simd::Vec4& a, Simd::Vec4& b ) {
+		float alpha2 = 0;
+		float beta2 = 0;
+		float alphaBeta = 0;
+		Simd::Vec4 alphaX = Simd::Zero();
+		Simd::Vec4 betaX = Simd::Zero();
+		for ( int i = 0; i < set.count; i++ ) {
+			const float w = set.weights[ i ];
+			const float alpha = alphas[ i ];
+			const float beta = 1.0f - alpha;
+			alpha2 += w * alpha * alpha;
+			beta2 += w * beta * beta;
+			alphaBeta += w * alpha * beta;
+			alphaX = Simd::MulAdd( set.points[ i ], Simd::Replicate( w * alpha ), alphaX );
+			betaX = Simd::MulAdd( set.points[ i ], Simd::Replicate( w * beta ), betaX );
+		}
+		const float determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+		if ( fabsf( determinant ) < 1e-6f ) {
+			return false;
+		}
+		const Simd::Vec4 inverse = Simd::Replicate( 1.0f / determinant );
+		a = Saturate( Simd::Mul( Simd::Sub( Simd::Mul( alphaX, Simd::Replicate( beta2 ) ), Simd::Mul( betaX, Simd::Replicate( alphaBeta ) ) ), inverse ) );
+		b = Saturate( Simd::Mul( Simd::Sub( Simd::Mul( betaX, Simd::Replicate( alpha2 ) ), Simd::Mul( alphaX, Simd::Replicate( alphaBeta ) ) ), inverse ) );
+		return true;
+	}
+
+	// zpresneni koncovych bodu podle indexu nejlepsiho reseni
+	void RefineFit( const ColorSet& set, ColorBlockFit& best ) {
+		for ( int iteration = 0; iteration < REFINE_ITERATIONS; iteration++ ) {
+			const bool fourColor = best.color0 > best.color1;
+			static const float FOUR_COLOR_ALPHAS[ 4 ] = { 1.0f, 0, 2.0f / 3.0f, 1.0f / 3.0f };
+			static const float THREE_COLOR_ALPHAS[ 4 ] = { 1.0f, 0, 0.5f, 0 };
+			float alphas[ 16 ];
+			for ( int i = 0; i < set.count; i++ ) {
+				alphas[ i ] = fourColor ? FOUR_COLOR_ALPHAS[ best.indices[ i ] ] : THREE_COLOR_ALPHAS[ best.indices[ i ] ];
+			}
+			Simd::Vec4 a;
+			Simd::Vec4 b;
+			if ( !SolveEndpoints( set, alphas, a, b ) ) {
+				return;
+			}
+			const float error = best.error;
+			TryEndpoints( set, a, b, !fourColor, best );
+			if ( best.error >= error ) {
+				return;
+			}
+		}
+	}
+
+	/*
+	Cluster fit 4 barev: vsechna rozdeleni < 0; i ), < i; j ), < j; k ), < k; n ), 4 hodnoty k najednou
+	(slozky vektoru). Soucty jsou ulozeny po kanalech a doplneny hodnotou pro n, slozky s k > n tak opakuji k = n.
+	Vypocet odpovida ClusterFit() (vyhodnoceni jednoho rozdeleni).
+	*/
+	void SearchFourClusters( const Simd::Vec4* const sumX, const float* const sumW, const int n, int& bestI, int& bestJ, int& bestK ) {
+		alignas( 16 ) float sums[ 4 ][ 20 ];
+		for ( int m = 0; m < 20; m++ ) {
+			alignas( 16 ) float x[ 4 ];
+			Simd::Store( x, sumX[ Math::Min( m, n ) ] );
+			sums[ 0 ][ m ] = x[ 0 ];
+			sums[ 1 ][ m ] = x[ 1 ];
+			sums[ 2 ][ m ] = x[ 2 ];
+			sums[ 3 ][ m ] = sumW[ Math::Min( m, n ) ];
+		}
+		const Simd::Vec4 total[ 3 ] = { Simd::Replicate( sums[ 0 ][ n ] ), Simd::Replicate( sums[ 1 ][ n ] ), Simd::Replicate( sums[ 2 ][ n ] ) };
+		const Simd::Vec4 grid[ 3 ] = { Simd::Replicate( 31.0f ), Simd::Replicate( 63.0f ), Simd::Replicate( 31.0f ) };
+		const Simd::Vec4 gridInverse[ 3 ] = { Simd::Replicate( 1.0f / 31.0f ), Simd::Replicate( 1.0f / 63.0f ), Simd::Replicate( 1.0f / 31.0f ) };
+		const Simd::Vec4 one = Simd::Replicate( 1.0f );
+		const Simd::Vec4 two = Simd::Replicate( 2.0f );
+		const Simd::Vec4 third = Simd::Replicate( 1.0f / 3.0f );
+		const Simd::Vec4 ninth = Simd::Replicate( 1.0f / 9.0f );
+		const Simd::Vec4 twoNinths = Simd::Replicate( 2.0f / 9.0f );
+		const Simd::Vec4 minusFiveNinths = Simd::Replicate( -5.0f / 9.0f );
+		const Simd::Vec4 minDeterminant = Simd::Replicate( MIN_DETERMINANT );
+		const float totalW = sumW[ n ];
+
+		float bestError = FLT_MAX;
+		alignas( 16 ) float errors[ 4 ];
+		for ( int i = 0; i <= n; i++ ) {
+			for ( int j = i; j <= n; j++ ) {
+				// cleny nezavisle na k, w2 = W[ k ] - W[ j ], w3 = W[ n ] - W[ k ], X2 = X[ k ] - X[ j ]
+				const float w0 = sumW[ i ];
+				const float w1 = sumW[ j ] - sumW[ i ];
+				const Simd::Vec4 alpha2Base = Simd::Replicate( w0 + ( w1 * 4.0f - sumW[ j ] ) * ( 1.0f / 9.0f ) );
+				const Simd::Vec4 beta2Base = Simd::Replicate( totalW + ( w1 - sumW[ j ] * 4.0f ) * ( 1.0f / 9.0f ) );
+				const Simd::Vec4 alphaBetaBase = Simd::Replicate( ( w1 - sumW[ j ] ) * ( 2.0f / 9.0f ) );
+				Simd::Vec4 alphaXBase[ 3 ];
+				for ( int c = 0; c < 3; c++ ) {
+					alphaXBase[ c ] = Simd::Replicate( sums[ c ][ i ] + ( sums[ c ][ j ] - sums[ c ][ i ] ) * ( 2.0f / 3.0f ) - sums[ c ][ j ] * ( 1.0f / 3.0f ) );
+				}
+				for ( int k = j; k <= n; k += 4 ) {
+					const Simd::Vec4 wk = Simd::LoadUnaligned( sums[ 3 ] + k );
+					const Simd::Vec4 alpha2 = Simd::MulAdd( wk, ninth, alpha2Base );
+					const Simd::Vec4 beta2 = Simd::MulAdd( wk, minusFiveNinths, beta2Base );
+					const Simd::Vec4 alphaBeta = Simd::MulAdd( wk, twoNinths, alphaBetaBase );
+					const Simd::Vec4 determinant = Simd::NegMulAdd( alphaBeta, alphaBeta, Simd::Mul( alpha2, beta2 ) );
+					const Simd::Vec4 inverse = Simd::Div( one, Simd::Max( determinant, minDeterminant ) );
+					Simd::Vec4 error = Simd::Zero();
+					for ( int c = 0; c < 3; c++ ) {
+						const Simd::Vec4 alphaX = Simd::MulAdd( Simd::LoadUnaligned( sums[ c ] + k ), third, alphaXBase[ c ] );
+						const Simd::Vec4 betaX = Simd::Sub( total[ c ], alphaX );
+						Simd::Vec4 a = Simd::Mul( Simd::NegMulAdd( betaX, alphaBeta, Simd::Mul( alphaX, beta2 ) ), inverse );
+						Simd::Vec4 b = Simd::Mul( Simd::NegMulAdd( alphaX, alphaBeta, Simd::Mul( betaX, alpha2 ) ), inverse );
+						a = Simd::Mul( Simd::Round( Simd::Mul( Saturate( a ), grid[ c ] ) ), gridInverse[ c ] );
+						b = Simd::Mul( Simd::Round( Simd::Mul( Saturate( b ), grid[ c ] ) ), gridInverse[ c ] );
+						const Simd::Vec4 e2 = Simd::NegMulAdd( b, betaX, Simd::NegMulAdd( a, alphaX, Simd::Mul( Simd::Mul( a, b ), alphaBeta ) ) );
+						error = Simd::Add( error, Simd::MulAdd( e2, two, Simd::MulAdd( Simd::Mul( a, a ), alpha2, Simd::Mul( Simd::Mul( b, b ), beta2 ) ) ) );
+					}
+					Simd::Store( errors, error );
+					for ( int lane = 0; lane < 4; lane++ ) {
+						if ( errors[ lane ] < bestError ) {
+							bestError = errors[ lane ];
+							bestI = i;
+							bestJ = j;
+							bestK = Math::Min( k + lane, n );
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	Cluster fit: body serazene podle hlavni osy se rozdeli do 4 (3) souvislych skupin s vahami alpha
+	1, 2/3, 1/3, 0 (1, 1/2, 0), pro kazde rozdeleni se koncove body spocitaji nejmensimi ctverci z prefixovych
+	souctu, kvantuji se do mrizky 5:6:5 a chyba se vyhodnoti bez pruchodu body.
+	*/
+	void ClusterFit( const ColorSet& set, const Simd::Vec4 axis, const bool threeColor, ColorBlockFit& best ) {
+		// serazeni podle projekce na hlavni osu
+		int order[ 16 ];
+		float projections[ 16 ];
+		for ( int i = 0; i < set.count; i++ ) {
+			const float projection = Simd::GetX( Simd::Dot3( set.points[ i ], axis ) );
+			int j = i;
+			while ( j > 0 && projections[ j - 1 ] > projection ) {
+				projections[ j ] = projections[ j - 1 ];
+				order[ j ] = order[ j - 1 ];
+				j--;
+			}
+			projections[ j ] = projection;
+			order[ j ] = i;
+		}
+
+		// prefixove soucty w * x a w
+		Simd::Vec4 sumX[ 17 ];
+		float sumW[ 17 ];
+		sumX[ 0 ] = Simd::Zero();
+		sumW[ 0 ] = 0;
+		for ( int i = 0; i < set.count; i++ ) {
+			const float w = set.weights[ order[ i ] ];
+			sumX[ i + 1 ] = Simd::MulAdd( set.points[ order[ i ] ], Simd::Replicate( w ), sumX[ i ] );
+			sumW[ i + 1 ] = sumW[ i ] + w;
+		}
+		const int n = set.count;
+		const Simd::Vec4 totalX = sumX[ n ];
+		const Simd::Vec4 grid = GetGrid();
+		const Simd::Vec4 gridInverse = GetGridInverse();
+		const Simd::Vec4 two = Simd::Replicate( 2.0f );
+
+		float bestError = FLT_MAX;
+		Simd::Vec4 bestA = Simd::Zero();
+		Simd::Vec4 bestB = Simd::Zero();
+		auto evaluate = [ & ]( const float alpha2, const float beta2, const float alphaBeta, const Simd::Vec4 alphaX ) {
+			// degenerovane rozdeleni (jedna skupina) da libovolne koncove body, chyba je pro ne spravna
+			const float determinant = fmaxf( alpha2 * beta2 - alphaBeta * alphaBeta, MIN_DETERMINANT );
+			const Simd::Vec4 betaX = Simd::Sub( totalX, alphaX );
+			const Simd::Vec4 inverse = Simd::Replicate( 1.0f / determinant );
+			const Simd::Vec4 vAlpha2 = Simd::Replicate( alpha2 );
+			const Simd::Vec4 vBeta2 = Simd::Replicate( beta2 );
+			const Simd::Vec4 vAlphaBeta = Simd::Replicate( alphaBeta );
+			Simd::Vec4 a = Simd::Mul( Simd::NegMulAdd( betaX, vAlphaBeta, Simd::Mul( alphaX, vBeta2 ) ), inverse );
+			Simd::Vec4 b = Simd::Mul( Simd::NegMulAdd( alphaX, vAlphaBeta, Simd::Mul( betaX, vAlpha2 ) ), inverse );
+			a = Simd::Mul( Simd::Round( Simd::Mul( Saturate( a ), grid ) ), gridInverse );
+			b = Simd::Mul( Simd::Round( Simd::Mul( Saturate( b ), grid ) ), gridInverse );
+
+			// chyba bez konstanty sum( w * x^2 ): a^2 alpha2 + b^2 beta2 + 2 ab alphaBeta - 2 a alphaX - 2 b betaX
+			const Simd::Vec4 e1 = Simd::MulAdd( Simd::Mul( a, a ), vAlpha2, Simd::Mul( Simd::Mul( b, b ), vBeta2 ) );
+			const Simd::Vec4 e2 = Simd::NegMulAdd( a, alphaX, Simd::Mul( Simd::Mul( a, b ), vAlphaBeta ) );
+			const float error = SumXYZ( Simd::MulAdd( Simd::NegMulAdd( b, betaX, e2 ), two, e1 ) );
+			if ( error < bestError ) {
+				bestError = error;
+				bestA = a;
+				bestB = b;
+			}
+		};
+
+		if ( threeColor ) {
+			const Simd::Vec4 half = Simd::Replicate( 0.5f );
+			for ( int i = 0; i <= n; i++ ) {
+				for ( int j = i; j <= n; j++ ) {
+					// skupiny < 0; i ), < i; j ), < j; n )
+					const float w1 = sumW[ j ] - sumW[ i ];
+					const float w2 = sumW[ n ] - sumW[ j ];
+					const Simd::Vec4 alphaX = Simd::MulAdd( Simd::Sub( sumX[ j ], sumX[ i ] ), half, sumX[ i ] );
+					evaluate( sumW[ i ] + w1 * 0.25f, w2 + w1 * 0.25f, w1 * 0.25f, alphaX );
+				}
+			}
+		} else {
+			// skupiny < 0; i ), < i; j ), < j; k ), < k; n )
+			int i = 0;
+			int j = 0;
+			int k = 0;
+			SearchFourClusters( sumX, sumW, n, i, j, k );
+			const float w1 = sumW[ j ] - sumW[ i ];
+			const float w2 = sumW[ k ] - sumW[ j ];
+			const float w3 = sumW[ n ] - sumW[ k ];
+			const Simd::Vec4 alphaX = Simd::MulAdd( Simd::Sub( sumX[ k ], sumX[ j ] ), Simd::Replicate( 1.0f / 3.0f ), Simd::MulAdd( Simd::Sub( sumX[ j ], sumX[ i ] ), Simd::Replicate( 2.0f / 3.0f ), sumX[ i ] ) );
+			evaluate( sumW[ i ] + ( w1 * 4.0f + w2 ) * ( 1.0f / 9.0f ), w3 + ( w2 * 4.0f + w1 ) * ( 1.0f / 9.0f ), ( w1 + w2 ) * ( 2.0f / 9.0f ), alphaX );
+		}
+		TryEndpoints( set, bestA, bestB, threeColor, best );
+	}
+
+	// barevny blok BC1, pro BC3 vzdy 4 barvy bez pruhlednosti
+	void EncodeColorBlock( const uint8_t* const pixels, const BlockCompressionQuality quality, const bool bc1, uint8_t* const dest ) {
+		ColorSet set;
+		BuildColorSet( pixels, bc1, set );
+		ColorBlockFit best;
+		best.color0 = 0;
+		best.color1 = 0;
+		best.error = FLT_MAX;
+		for ( int i = 0; i < 16; i++ ) {
+			best.indices[ i ] = 0;
+		}
+
+		if ( set.count == 1 ) {
+			int pixel = 0;
+			while ( set.pointIndex[ pixel ] != 0 ) {
+				pixel++;
+			}
+			SingleColorFit( set, pixels + pixel * 4, set.transparent, best );
+		} else if ( set.count > 1 ) {
+			const Simd::Vec4 axis = GetPrincipalAxis( set );
+			RangeFit( set, axis, set.transparent, best );
+			if ( bc1 && !set.transparent && quality != BlockCompressionQuality::FAST ) {
+				RangeFit( set, axis, true, best );
+			}
+			if ( quality != BlockCompressionQuality::FAST ) {
+				RefineFit( set, best );
+			}
+			if ( quality == BlockCompressionQuality::HIGH ) {
+				ClusterFit( set, axis, set.transparent, best );
+				if ( bc1 && !set.transparent ) {
+					ClusterFit( set, axis, true, best );
+				}
+			}
+		}
+
+		// pruhledne pixely: index 3 rezimu 3 barev (blok jen z pruhlednych pixelu ma color0 == color1)
+		uint32_t indices = 0;
+		for ( int i = 0; i < 16; i++ ) {
+			const int point = set.pointIndex[ i ];
+			indices |= static_cast< uint32_t >( point < 0 ? 3 : best.indices[ point ] ) << ( i * 2 );
+		}
+		dest[ 0 ] = static_cast< uint8_t >( best.color0 );
+		dest[ 1 ] = static_cast< uint8_t >( best.color0 >> 8 );
+		dest[ 2 ] = static_cast< uint8_t >( best.color1 );
+		dest[ 3 ] = static_cast< uint8_t >( best.color1 >> 8 );
+		for ( int i = 0; i < 4; i++ ) {
+			dest[ 4 + i ] = static_cast< uint8_t >( indices >> ( i * 8 ) );
+		}
+	}
+
+	/*
+	Alfa blok BC3: alpha0 > alpha1: 8 hodnot (koncove body a 6 interpolovanych),
+	jinak 6 hodnot (koncove body a 4 interpolovane) a hodnoty 0 a 255.
+	*/
+	void TryAlphaEndpoints( const uint8_t* const alphas, const int alpha0, const int alpha1, AlphaBlockFit& best ) {
+		float palette[ 8 ];
+		palette[ 0 ] = static_cast< float >( alpha0 );
+		palette[ 1 ] = static_cast< float >( alpha1 );
+		if ( alpha0 > alpha1 ) {
+			for ( int k = 2; k < 8; k++ ) {
+				palette[ k ] = ( ( 8 - k ) * alpha0 + ( k - 1 ) * alpha1 ) / 7.0f;
+			}
+		} else {
+			for ( int k = 2; k < 6; k++ ) {
+				palette[ k ] = ( ( 6 - k ) * alpha0 + ( k - 1 ) * alpha1 ) / 5.0f;
+			}
+			palette[ 6 ] = 0;
+			palette[ 7 ] = 255.0f;
+		}
+		AlphaBlockFit fit;
+		fit.alpha0 = static_cast< uint8_t >( alpha0 );
+		fit.alpha1 = static_cast< uint8_t >( alpha1 );
+		fit.error = 0;
+		for ( int i = 0; i < 16; i++ ) {
+			int index = 0;
+			float error = FLT_MAX;
+			for ( int k = 0; k < 8; k++ ) {
+				const float d = palette[ k ] - alphas[ i ];
+				if ( d * d < error ) {
+					error = d * d;
+					index = k;
+				}
+			}
+			fit.indices[ i ] = static_cast< uint8_t >( index );
+			fit.error += error;
+		}
+		if ( fit.error < best.error ) {
+			best = fit;
+		}
+	}
+
+	void EncodeAlphaBlock( const uint8_t* const pixels, const BlockCompressionQuality quality, uint8_t* const dest ) {
+		uint8_t alphas[ 16 ];
+		int minAlpha = 255;
+		int maxAlpha = 0;
+		int minInner = 255;
+		int maxInner = 0;
+		for ( int i = 0; i < 16; i++ ) {
+			const int alpha = pixels[ i * 4 + 3 ];
+			alphas[ i ] = static_cast< uint8_t >( alpha );
+			minAlpha = Math::Min( minAlpha, alpha );
+			maxAlpha = Math::Max( maxAlpha, alpha );
+			if ( alpha != 0 && alpha != 255 ) {
+				minInner = Math::Min( minInner, alpha );
+				maxInner = Math::Max( maxInner, alpha );
+			}
+		}
+
+		AlphaBlockFit best;
+		best.error = FLT_MAX;
+		if ( minAlpha == maxAlpha ) {
+			TryAlphaEndpoints( alphas, minAlpha, minAlpha, best );
+		} else {
+			TryAlphaEndpoints( alphas, maxAlpha, minAlpha, best );
+			if ( minInner <= maxInner ) {
+				TryAlphaEndpoints( alphas, minInner, maxInner, best );
+			} else {
+				TryAlphaEndpoints( alphas, 0, 0, best );
+			}
+		}
+
+		// zpresneni rezimu 8 hodnot nejmensimi ctverci
+		for ( int iteration = 0; quality != BlockCompressionQuality::FAST && iteration < REFINE_ITERATIONS && best.alpha0 > best.alpha1 && best.error > 0; iteration++ ) {
+			float alpha2 = 0;
+			float beta2 = 0;
+			float alphaBeta = 0;
+			float alphaX = 0;
+			float betaX = 0;
+			for ( int i = 0; i < 16; i++ ) {
+				const int index = best.indices[ i ];
+				const float alpha = index == 0 ? 1.0f : ( index == 1 ? 0 : ( 8 - index ) / 7.0f );
+				const float beta = 1.0f - alpha;
+				alpha2 += alpha * alpha;
+				beta2 += beta * beta;
+				alphaBeta += alpha * beta;
+				alphaX += alpha * alphas[ i ];
+				betaX += beta * alphas[ i ];
+			}
+			const float determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+			if ( determinant < 1e-6f ) {
+				break;
+			}
+			const int alpha0 = static_cast< int >( std::lrint( fminf( fmaxf( ( alphaX * beta2 - betaX * alphaBeta ) / determinant, 0 ), 255.0f ) ) );
+			const int alpha1 = static_cast< int >( std::lrint( fminf( fmaxf( ( betaX * alpha2 - alphaX * alphaBeta ) / determinant, 0 ), 255.0f ) ) );
+			if ( alpha0 <= alpha1 ) {
+				break;
+			}
+			const float error = best.error;
+			TryAlphaEndpoints( alphas, alpha0, alpha1, best );
+			if ( best.error >= error ) {
+				break;
+			}
+		}
+
+		// 16 indexu po 3 bitech
+		uint64_t indices = 0;
+		for ( int i = 0; i < 16; i++ ) {
+			indices |= static_cast< uint64_t >( best.indices[ i ] ) << ( i * 3 );
+		}
+		dest[ 0 ] = best.alpha0;
+		dest[ 1 ] = best.alpha1;
+		for ( int i = 0; i < 6; i++ ) {
+			dest[ 2 + i ] = static_cast< uint8_t >( indices >> ( i * 8 ) );
+		}
+	}
+
+	void CompressBlockRows( const int width, const int height, const uint8_t* const source, uint8_t* const dest, const BlockCompressionParams& params, const int beginRow, const int endRow ) {
+		const bool bc1 = params.format == Format::BC1;
+		const int blockSize = bc1 ? 8 : 16;
+		const int columns = ( width + 3 ) / 4;
+		uint8_t pixels[ 64 ];
+		for ( int row = beginRow; row < endRow; row++ ) {
+			uint8_t* block = dest + static_cast< std::size_t >( row ) * columns * blockSize;
+			for ( int column = 0; column < columns; column++ ) {
+				// pixely mimo texturu opakuji posledni radek a sloupec
+				for ( int y = 0; y < 4; y++ ) {
+					const int sy = Math::Min( row * 4 + y, height - 1 );
+					for ( int x = 0; x < 4; x++ ) {
+						const int sx = Math::Min( column * 4 + x, width - 1 );
+						const uint8_t* const pixel = source + ( static_cast< std::size_t >( sy ) * width + sx ) * 4;
+						for ( int c = 0; c < 4; c++ ) {
+							pixels[ ( y * 4 + x ) * 4 + c ] = pixel[ c ];
+						}
+					}
+				}
+				if ( bc1 ) {
+					EncodeColorBlock( pixels, params.quality, true, block );
+				} else {
+					EncodeAlphaBlock( pixels, params.quality, block );
+					EncodeColorBlock( pixels, params.quality, false, block + 8 );
+				}
+				block += blockSize;
+			}
+		}
+	}
+}
+
+bool RenderInterface::CompressTexture( const int width, const int height, const void* const source, void* const dest, const BlockCompressionParams& params ) {
+	if ( ( params.format != Format::BC1 && params.format != Format::BC3 ) || width < 1 || height < 1 || source == nullptr || dest == nullptr ) {
+		return false;
+	}
+	const int rows = ( height + 3 ) / 4;
+	auto function = [ & ]( const std::size_t begin, const std::size_t end ) {
+		CompressBlockRows( width, height, static_cast< const uint8_t* >( source ), static_cast< uint8_t* >( dest ), params, static_cast< int >( begin ), static_cast< int >( end ) );
+	};
+	if ( params.parallel ) {
+		ParallelFor( rows, BLOCK_ROWS_BATCH, function );
+		return true;
+	}
+	function( 0, rows );
+	return true;
+}
+
+bool RenderInterface::CompressTextureMips( const int width, const int height, const int mipLevels, const void* const source, void* const* const levels, const MipGeneratorParams& mipParams, const BlockCompressionParams& params ) {
+	if ( mipLevels < 1 || mipLevels > GetMipLevelsCount( width, height ) || levels == nullptr ) {
+		return false;
+	}
+	if ( !CompressTexture( width, height, source, levels[ 0 ], params ) ) {
+		return false;
+	}
+	if ( mipLevels == 1 ) {
+		return true;
+	}
+
+	// nekomprimovane mip urovne
+	std::vector< std::vector< uint8_t > > mips( mipLevels - 1 );
+	std::vector< void* > pointers( mipLevels - 1 );
+	for ( int level = 1; level < mipLevels; level++ ) {
+		mips[ level - 1 ].resize( GetMipDataSize( Format::R8G8B8A8_UNORM, width, height, level ) );
+		pointers[ level - 1 ] = mips[ level - 1 ].data();
+	}
+	if ( !GenerateMips( Format::R8G8B8A8_UNORM, width, height, mipLevels, source, pointers.data(), mipParams ) ) {
+		return false;
+	}
+	for ( int level = 1; level < mipLevels; level++ ) {
+		TextureDimmensions dimmensions;
+		GetMipDimmensions( width, height, 1, level, dimmensions );
+		if ( !CompressTexture( dimmensions.width, dimmensions.height, mips[ level - 1 ].data(), levels[ level ], params ) ) {
+			return false;
+		}
+	}
+	return true;
+}
\ No newline at end of file
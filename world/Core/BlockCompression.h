@@ -0,0 +1,42 @@
+#pragma once
+
+#include "RenderInterface.h"
+#include "MipGenerator.h"
+
+namespace RenderInterface {
+
+	/*
+	Kvalita komprese, vyssi kvalita je pomalejsi
+	*/
+	enum class BlockCompressionQuality {
+		FAST,		// range fit: koncove body z krajnich bodu bloku na hlavni ose
+		NORMAL,		// range fit zpresneny metodou nejmensich ctvercu
+		HIGH		// cluster fit: vsechna rozdeleni bodu serazenych podle hlavni osy
+	};
+
+	/*
+	Parametry funkci CompressTexture() a CompressTextureMips()
+	*/
+	struct BlockCompressionParams {
+		Format format;						// BC1 nebo BC3
+		BlockCompressionQuality quality;
+		bool parallel;						// rozdelit radky bloku mezi vlakna ParallelFor
+	};
+
+	/*
+	Komprese textury R8G8B8A8_UNORM (radky bez mezer) do BC1 nebo BC3, dest ma velikost GetMipDataSize( format, width, height, 0 ).
+	Bloky na okraji textury jsou doplneny opakovanim posledniho radku a sloupce.
+	BC1: pixely s alfou < 128 jsou pruhledne (blok pak pouziva 3 barvy), ostatni alfa se ignoruje.
+	BC3: alfa je komprimovana samostatne (8 nebo 6 interpolovanych hodnot, vybira se mensi chyba).
+	Barvy se komprimuji tak, jak jsou ulozeny (sRGB data pro texturu BC1_UNORM_SRGB se neprevadi).
+	Vraci false pro jiny format nez BC1 a BC3 nebo neplatne rozmery.
+	*/
+	bool CompressTexture( const int width, const int height, const void* const source, void* const dest, const BlockCompressionParams& params );
+
+	/*
+	Vytvori a zkomprimuje mip urovne 0 az mipLevels - 1, levels[ i ] je buffer urovne i
+	o velikosti GetMipDataSize( format, width, height, i ), pole levels lze primo pouzit jako TextureBufferParams::data.
+	Mip urovne vznikaji z nekomprimovane urovne 0 (source, R8G8B8A8_UNORM) funkci GenerateMips() s parametry mipParams.
+	*/
+	bool CompressTextureMips( const int width, const int height, const int mipLevels, const void* const source, void* const* const levels, const MipGeneratorParams& mipParams, const BlockCompressionParams& params );
+}
\ No newline at end of file
@@ -438,6 +438,70 @@ ID3D11DeviceContext* Directx11RenderInterface::Device::GetD3D11DeviceContext() n
 	return context.Raw();
 }
 
+Directx11RenderInterface::ObjectTables* Directx11RenderInterface::Device::GetObjectTables() noexcept {
+	return &tables;
+}
+
+RenderInterface::BlendStateHandle Directx11RenderInterface::Device::RegisterBlendState( const RenderInterface::PBlendState& state ) noexcept {
+	if ( state == nullptr ) {
+		return RenderInterface::BlendStateHandle();
+	}
+	return tables.blendStates.Add( ComPtr< ID3D11BlendState >( down_cast< Directx11RenderInterface::BlendState >( state )->GetD3D11BlendState() ) );
+}
+
+RenderInterface::RasterizerStateHandle Directx11RenderInterface::Device::RegisterRasterizerState( const RenderInterface::PRasterizerState& state ) noexcept {
+	if ( state == nullptr ) {
+		return RenderInterface::RasterizerStateHandle();
+	}
+	return tables.rasterizerStates.Add( ComPtr< ID3D11RasterizerState >( down_cast< Directx11RenderInterface::RasterizerState >( state )->GetD3D11RasterizerState() ) );
+}
+
+RenderInterface::DepthStencilStateHandle Directx11RenderInterface::Device::RegisterDepthStencilState( const RenderInterface::PDepthStencilState& state ) noexcept {
+	if ( state == nullptr ) {
+		return RenderInterface::DepthStencilStateHandle();
+	}
+	return tables.depthStencilStates.Add( ComPtr< ID3D11DepthStencilState >( down_cast< Directx11RenderInterface::DepthStencilState >( state )->GetD3D11DepthStencilState() ) );
+}
+
+RenderInterface::RenderProgramHandle Directx11RenderInterface::Device::RegisterRenderProgram( const RenderInterface::PRenderProgram& program ) noexcept {
+	if ( program == nullptr ) {
+		return RenderInterface::RenderProgramHandle();
+	}
+	auto* const dx11Program = down_cast< Directx11RenderInterface::RenderProgram >( program );
+	RenderProgramObjects objects;
+	objects.vs = dx11Program->GetD3D11VertexShader();
+	objects.ps = dx11Program->GetD3D11PixelShader();
+	objects.gs = dx11Program->GetD3D11GeometryShader();
+	return tables.renderPrograms.Add( objects );
+}
+
+RenderInterface::VertexStreamHandle Directx11RenderInterface::Device::RegisterVertexStream( const RenderInterface::PVertexStream& stream ) noexcept {
+	if ( stream == nullptr ) {
+		return RenderInterface::VertexStreamHandle();
+	}
+	return tables.vertexStreams.Add( std::static_pointer_cast< Directx11RenderInterface::VertexStream >( stream ) );
+}
+
+void Directx11RenderInterface::Device::ReleaseBlendState( const RenderInterface::BlendStateHandle state ) noexcept {
+	tables.blendStates.Remove( state );
+}
+
+void Directx11RenderInterface::Device::ReleaseRasterizerState( const RenderInterface::RasterizerStateHandle state ) noexcept {
+	tables.rasterizerStates.Remove( state );
+}
+
+void Directx11RenderInterface::Device::ReleaseDepthStencilState( const RenderInterface::DepthStencilStateHandle state ) noexcept {
+	tables.depthStencilStates.Remove( state );
+}
+
+void Directx11RenderInterface::Device::ReleaseRenderProgram( const RenderInterface::RenderProgramHandle program ) noexcept {
+	tables.renderPrograms.Remove( program );
+}
+
+void Directx11RenderInterface::Device::ReleaseVertexStream( const RenderInterface::VertexStreamHandle stream ) noexcept {
+	tables.vertexStreams.Remove( stream );
+}
+
 // DX11SwapChain
 
 Directx11RenderInterface::SwapChain::SwapChain() {
@@ -1840,6 +1904,7 @@ DXGI_FORMAT Directx11RenderInterface::VertexStream::GetIndexFormat() const noexc
 
 Directx11RenderInterface::CommandInterface::CommandInterface() {
 	context = nullptr;
+	tables = nullptr;
 	currentInputLayout = nullptr;
 	currentVertexShader = nullptr;
 	currentPixelShader = nullptr;
@@ -1859,6 +1924,7 @@ bool Directx11RenderInterface::CommandInterface::Create() noexcept {
 
 void Directx11RenderInterface::CommandInterface::Begin( const RenderInterface::PDevice& device ) noexcept {
 	context = down_cast< Directx11RenderInterface::Device >( device )->GetD3D11DeviceContext();
+	tables = down_cast< Directx11RenderInterface::Device >( device )->GetObjectTables();
 	context->ClearState();
 	currentInputLayout = nullptr;
 	currentVertexShader = nullptr;
@@ -1875,6 +1941,7 @@ void Directx11RenderInterface::CommandInterface::Begin( const RenderInterface::P
 
 void Directx11RenderInterface::CommandInterface::End() noexcept {
 	context = nullptr;
+	tables = nullptr;
 
 	// UNIMPLEMENTED command list!
 }
@@ -2047,42 +2114,75 @@ void Directx11RenderInterface::CommandInterface::SetConstantBuffers( const Rende
 	context->GSSetConstantBuffers( 0, RenderInterface::MAX_CBUFFER_SLOTS, gsBuffers );
 }
 
-void Directx11RenderInterface::CommandInterface::SetVertexStream( const RenderInterface::PVertexStream& stream ) noexcept {
-	ID3D11InputLayout* const inputLayout = down_cast< Directx11RenderInterface::VertexStream >( stream )->GetD3D11InputLayout();
+void Directx11RenderInterface::CommandInterface::ApplyVertexStream( Directx11RenderInterface::VertexStream* const stream ) noexcept {
+	ID3D11InputLayout* const inputLayout = stream != nullptr ? stream->GetD3D11InputLayout() : nullptr;
 	if ( currentInputLayout != inputLayout ) {
 		context->IASetInputLayout( inputLayout );
 		currentInputLayout = inputLayout;
 	}
+	// odpojit vertex buffery a index buffer
+	if ( stream == nullptr ) {
+		ID3D11Buffer* const buffers[ RenderInterface::MAX_VERTEX_INPUT_SLOTS ] = { nullptr };
+		const UINT zeros[ RenderInterface::MAX_VERTEX_INPUT_SLOTS ] = { 0 };
+		context->IASetVertexBuffers( 0, RenderInterface::MAX_VERTEX_INPUT_SLOTS, buffers, zeros, zeros );
+		context->IASetIndexBuffer( nullptr, DXGI_FORMAT_UNKNOWN, 0 );
+		return;
+	}
 	context->IASetVertexBuffers(
 		0,
 		RenderInterface::MAX_VERTEX_INPUT_SLOTS,
-		down_cast< Directx11RenderInterface::VertexStream >( stream )->GetVertexBuffers(),
+		stream->GetVertexBuffers(),
 		NULL,
 		NULL
 	);
 	context->IASetIndexBuffer(
-		down_cast< Directx11RenderInterface::VertexStream >( stream )->GetIndexBuffer(),
-		down_cast< Directx11RenderInterface::VertexStream >( stream )->GetIndexFormat(),
+		stream->GetIndexBuffer(),
+		stream->GetIndexFormat(),
 		0
 	);
 }
 
-void Directx11RenderInterface::CommandInterface::SetRenderProgram( const RenderInterface::PRenderProgram& program ) noexcept {
-	ID3D11VertexShader* const vertexShader = down_cast< Directx11RenderInterface::RenderProgram >( program )->GetD3D11VertexShader();
-	if ( currentVertexShader != vertexShader ) {
-		context->VSSetShader( vertexShader, NULL, 0 );
-		currentVertexShader = vertexShader;
+void Directx11RenderInterface::CommandInterface::SetVertexStream( const RenderInterface::PVertexStream& stream ) noexcept {
+	ApplyVertexStream( stream != nullptr ? down_cast< Directx11RenderInterface::VertexStream >( stream ) : nullptr );
+}
+
+void Directx11RenderInterface::CommandInterface::SetVertexStream( const RenderInterface::VertexStreamHandle stream ) noexcept {
+	// uvolneny slot obsahuje prazdny shared_ptr, stream se odpoji stejne jako pro neplatny handle
+	ApplyVertexStream( !stream.IsNull() ? tables->vertexStreams.Resolve( stream ).get() : nullptr );
+}
+
+void Directx11RenderInterface::CommandInterface::ApplyRenderProgram( ID3D11VertexShader* const vs, ID3D11PixelShader* const ps, ID3D11GeometryShader* const gs ) noexcept {
+	if ( currentVertexShader != vs ) {
+		context->VSSetShader( vs, NULL, 0 );
+		currentVertexShader = vs;
+	}
+	if ( currentPixelShader != ps ) {
+		context->PSSetShader( ps, NULL, 0 );
+		currentPixelShader = ps;
+	}
+	if ( currentGeometryShader != gs ) {
+		context->GSSetShader( gs, NULL, 0 );
+		currentGeometryShader = gs;
 	}
-	ID3D11PixelShader* const pixelShader = down_cast< Directx11RenderInterface::RenderProgram >( program )->GetD3D11PixelShader();
-	if ( currentPixelShader != pixelShader ) {
-		context->PSSetShader( pixelShader, NULL, 0 );
-		currentPixelShader = pixelShader;
+}
+
+void Directx11RenderInterface::CommandInterface::SetRenderProgram( const RenderInterface::PRenderProgram& program ) noexcept {
+	if ( program == nullptr ) {
+		ApplyRenderProgram( nullptr, nullptr, nullptr );
+		return;
 	}
-	ID3D11GeometryShader* const geometryShader = down_cast< Directx11RenderInterface::RenderProgram >( program )->GetD3D11GeometryShader();
-	if ( currentGeometryShader != geometryShader ) {
-		context->GSSetShader( geometryShader, NULL, 0 );
-		currentGeometryShader = geometryShader;
+	auto* const dx11Program = down_cast< Directx11RenderInterface::RenderProgram >( program );
+	ApplyRenderProgram( dx11Program->GetD3D11VertexShader(), dx11Program->GetD3D11PixelShader(), dx11Program->GetD3D11GeometryShader() );
+}
+
+void Directx11RenderInterface::CommandInterface::SetRenderProgram( const RenderInterface::RenderProgramHandle program ) noexcept {
+	if ( program.IsNull() ) {
+		ApplyRenderProgram( nullptr, nullptr, nullptr );
+		return;
 	}
+	// uvolneny slot obsahuje prazdne ComPtr, shadery se odpoji
+	const RenderProgramObjects& objects = tables->renderPrograms.Resolve( program );
+	ApplyRenderProgram( objects.vs.Raw(), objects.ps.Raw(), objects.gs.Raw() );
 }
 
 void Directx11RenderInterface::CommandInterface::Draw( const int verticesCount, const int startVertex ) noexcept {
@@ -2116,49 +2216,49 @@ void Directx11RenderInterface::CommandInterface::SetPrimitiveTopology( const Ren
 	context->IASetPrimitiveTopology( GetD3D11PrimitiveTopology( topology ) );
 }
 
-void Directx11RenderInterface::CommandInterface::SetBlendState( const RenderInterface::PBlendState& state ) noexcept {
-	if ( state == nullptr ) {
-		if ( currentBlendState != nullptr ) {
-			context->OMSetBlendState( NULL, NULL, 0 );
-			currentBlendState = nullptr;
-		}
-		return;
+void Directx11RenderInterface::CommandInterface::ApplyBlendState( ID3D11BlendState* const state ) noexcept {
+	if ( currentBlendState != state ) {
+		context->OMSetBlendState( state, NULL, state != nullptr ? 0xffffffff : 0 );
+		currentBlendState = state;
 	}
-	ID3D11BlendState* const blendState = down_cast< Directx11RenderInterface::BlendState >( state )->GetD3D11BlendState();
-	if ( currentBlendState != blendState ) {
-		context->OMSetBlendState( blendState, NULL, 0xffffffff );
-		currentBlendState = blendState;
+}
+
+void Directx11RenderInterface::CommandInterface::SetBlendState( const RenderInterface::PBlendState& state ) noexcept {
+	ApplyBlendState( state != nullptr ? down_cast< Directx11RenderInterface::BlendState >( state )->GetD3D11BlendState() : nullptr );
+}
+
+void Directx11RenderInterface::CommandInterface::SetBlendState( const RenderInterface::BlendStateHandle state ) noexcept {
+	ApplyBlendState( !state.IsNull() ? tables->blendStates.Resolve( state ).Raw() : nullptr );
+}
+
+void Directx11RenderInterface::CommandInterface::ApplyDepthStencilState( ID3D11DepthStencilState* const state, const uint32_t stencilRef ) noexcept {
+	if ( currentDepthStencilState != state ) {
+		context->OMSetDepthStencilState( state, state != nullptr ? static_cast< UINT >( stencilRef ) : 0 );
+		currentDepthStencilState = state;
 	}
 }
 
 void Directx11RenderInterface::CommandInterface::SetDepthStencilState( const RenderInterface::PDepthStencilState& state, const uint32_t stencilRef ) noexcept {
-	if ( state == nullptr ) {
-		if ( currentDepthStencilState != nullptr ) {
-			context->OMSetDepthStencilState( NULL, 0 );
-			currentDepthStencilState = nullptr;
-		}
-		return;
-	}
-	ID3D11DepthStencilState* const depthStencilState = down_cast< Directx11RenderInterface::DepthStencilState >( state )->GetD3D11DepthStencilState();
-	if ( currentDepthStencilState != depthStencilState ) {
-		context->OMSetDepthStencilState( depthStencilState, static_cast< UINT >( stencilRef ) );
-		currentDepthStencilState = depthStencilState;
+	ApplyDepthStencilState( state != nullptr ? down_cast< Directx11RenderInterface::DepthStencilState >( state )->GetD3D11DepthStencilState() : nullptr, stencilRef );
+}
+
+void Directx11RenderInterface::CommandInterface::SetDepthStencilState( const RenderInterface::DepthStencilStateHandle state, const uint32_t stencilRef ) noexcept {
+	ApplyDepthStencilState( !state.IsNull() ? tables->depthStencilStates.Resolve( state ).Raw() : nullptr, stencilRef );
+}
+
+void Directx11RenderInterface::CommandInterface::ApplyRasterizerState( ID3D11RasterizerState* const state ) noexcept {
+	if ( currentRasterizerState != state ) {
+		context->RSSetState( state );
+		currentRasterizerState = state;
 	}
 }
 
 void Directx11RenderInterface::CommandInterface::SetRasterizerState( const RenderInterface::PRasterizerState& state ) noexcept {
-	if ( state == nullptr ) {
-		if ( currentRasterizerState != nullptr ) {
-			context->RSSetState( NULL );
-			currentRasterizerState = nullptr;
-		}
-		return;
-	}
-	ID3D11RasterizerState* const rasterizerState = down_cast< Directx11RenderInterface::RasterizerState >( state )->GetD3D11RasterizerState();
-	if ( currentRasterizerState != rasterizerState ) {
-		context->RSSetState( rasterizerState );
-		currentRasterizerState = rasterizerState;
-	}
+	ApplyRasterizerState( state != nullptr ? down_cast< Directx11RenderInterface::RasterizerState >( state )->GetD3D11RasterizerState() : nullptr );
+}
+
+void Directx11RenderInterface::CommandInterface::SetRasterizerState( const RenderInterface::RasterizerStateHandle state ) noexcept {
+	ApplyRasterizerState( !state.IsNull() ? tables->rasterizerStates.Resolve( state ).Raw() : nullptr );
 }
 
 void Directx11RenderInterface::CommandInterface::SetVSTextures( const int startSlot, const int count, const RenderInterface::PTextureView* const views ) noexcept {
@@ -30,6 +30,22 @@ namespace Directx11RenderInterface {
 	class VertexLayout;
 	class VertexStream;
 
+	// shadery render programu zaregistrovaneho pro handle API
+	struct RenderProgramObjects {
+		ComPtr< ID3D11VertexShader > vs;
+		ComPtr< ID3D11PixelShader > ps;
+		ComPtr< ID3D11GeometryShader > gs;
+	};
+
+	// tabulky objektu zaregistrovanych pro handle API, handle je index do tabulky
+	struct ObjectTables {
+		HandlePool< ComPtr< ID3D11BlendState >, RenderInterface::BlendState > blendStates;
+		HandlePool< ComPtr< ID3D11RasterizerState >, RenderInterface::RasterizerState > rasterizerStates;
+		HandlePool< ComPtr< ID3D11DepthStencilState >, RenderInterface::DepthStencilState > depthStencilStates;
+		HandlePool< RenderProgramObjects, RenderInterface::RenderProgram > renderPrograms;
+		HandlePool< std::shared_ptr< VertexStream >, RenderInterface::VertexStream > vertexStreams;
+	};
+
 	class Device: public RenderInterface::Device {
 	public:
 		Device();
@@ -61,14 +77,30 @@ namespace Directx11RenderInterface {
 		virtual RenderInterface::PRasterizerState CreateRasterizerState( const RenderInterface::RasterizerStateParams& params ) noexcept override;
 		virtual RenderInterface::PDepthStencilState CreateDepthStencilState( const RenderInterface::DepthStencilStateParams& params ) noexcept override;
 
+		virtual RenderInterface::BlendStateHandle RegisterBlendState( const RenderInterface::PBlendState& state ) noexcept override;
+		virtual RenderInterface::RasterizerStateHandle RegisterRasterizerState( const RenderInterface::PRasterizerState& state ) noexcept override;
+		virtual RenderInterface::DepthStencilStateHandle RegisterDepthStencilState( const RenderInterface::PDepthStencilState& state ) noexcept override;
+		virtual RenderInterface::RenderProgramHandle RegisterRenderProgram( const RenderInterface::PRenderProgram& program ) noexcept override;
+		virtual RenderInterface::VertexStreamHandle RegisterVertexStream( const RenderInterface::PVertexStream& stream ) noexcept override;
+
+		virtual void ReleaseBlendState( const RenderInterface::BlendStateHandle state ) noexcept override;
+		virtual void ReleaseRasterizerState( const RenderInterface::RasterizerStateHandle state ) noexcept override;
+		virtual void ReleaseDepthStencilState( const RenderInterface::DepthStencilStateHandle state ) noexcept override;
+		virtual void ReleaseRenderProgram( const RenderInterface::RenderProgramHandle program ) noexcept override;
+		virtual void ReleaseVertexStream( const RenderInterface::VertexStreamHandle stream ) noexcept override;
+
 		virtual int GetMaxMultisampleQuality( const int samplesCount ) const noexcept override;
 
 		// directx accessors
 		ID3D11DeviceContext* GetD3D11DeviceContext() noexcept;
 
+		// tabulky handle API
+		ObjectTables* GetObjectTables() noexcept;
+
 	private:
 		ComPtr< ID3D11Device > device;
 		ComPtr< ID3D11DeviceContext > context;
+		ObjectTables tables;
 	};
 
 	class CommandInterface: public RenderInterface::CommandInterface {
@@ -101,6 +133,11 @@ namespace Directx11RenderInterface {
 		virtual void SetBlendState( const RenderInterface::PBlendState& state ) noexcept override;
 		virtual void SetDepthStencilState( const RenderInterface::PDepthStencilState& state, const uint32_t stencilRef ) noexcept override;
 		virtual void SetRasterizerState( const RenderInterface::PRasterizerState& state ) noexcept override;
+		virtual void SetVertexStream( const RenderInterface::VertexStreamHandle stream ) noexcept override;
+		virtual void SetRenderProgram( const RenderInterface::RenderProgramHandle program ) noexcept override;
+		virtual void SetBlendState( const RenderInterface::BlendStateHandle state ) noexcept override;
+		virtual void SetDepthStencilState( const RenderInterface::DepthStencilStateHandle state, const uint32_t stencilRef ) noexcept override;
+		virtual void SetRasterizerState( const RenderInterface::RasterizerStateHandle state ) noexcept override;
 		virtual void SetViewports( const RenderInterface::Viewport* const viewports[], const int count ) noexcept override;
 		virtual void SetScissorRects( const RenderInterface::ScissorRect* rects, const int count ) noexcept override;
 		virtual void SetVSTextures( const int startSlot, const int count, const RenderInterface::PTextureView* const views ) noexcept override;
@@ -114,9 +151,20 @@ namespace Directx11RenderInterface {
 		virtual void DrawInstanced( const int verticesCount, const int startVertex, const int instancesCount, const int startInstance ) noexcept override;
 		virtual void DrawIndexedInstanced( const int indicesCount, const int startIndex, const int instancesCount, const int startInstance ) noexcept override;
 
+	private:
+		// nastaveni objektu do pipeline, spolecne pro shared_ptr a handle API
+		void ApplyVertexStream( VertexStream* const stream ) noexcept;
+		void ApplyRenderProgram( ID3D11VertexShader* const vs, ID3D11PixelShader* const ps, ID3D11GeometryShader* const gs ) noexcept;
+		void ApplyBlendState( ID3D11BlendState* const state ) noexcept;
+		void ApplyDepthStencilState( ID3D11DepthStencilState* const state, const uint32_t stencilRef ) noexcept;
+		void ApplyRasterizerState( ID3D11RasterizerState* const state ) noexcept;
+
 	private:
 		ComPtr< ID3D11DeviceContext > context;
 
+		// tabulky handle API zarizeni predaneho funkci Begin(), platne do volani End()
+		ObjectTables* tables;
+
 		// ulozene state objekty (provadi se test, aby nedochazelo k prenastaveni stejnych objektu)
 		ComPtr< ID3D11InputLayout > currentInputLayout;
 		ComPtr< ID3D11VertexShader > currentVertexShader;
@@ -0,0 +1,643 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "FormatConversion.h"
+#include "Framework/Half.h"
+#include "Framework/Parallel.h"
+#include "Framework/Simd.h"
+
+using namespace RenderInterface;
+
+namespace {
+
+	// pocet pixelu prevedenych pres pomocne pole (formaty s mene nez 4 kanaly)
+	const int PIXELS_CHUNK = 64;
+
+	// velikost pomocneho pole pro zaokrouhleni slozek
+	const std::size_t QUANTIZE_CHUNK = 64;
+
+	// priblizny pocet pixelu zpracovanych jednou casti ParallelFor
+	const int BATCH_PIXELS = 65536;
+
+	enum class ComponentType {
+		FLOAT32,
+		FLOAT16,
+		UNORM16,
+		SNORM16,
+		UNORM8,
+		SNORM8,
+		UINT32,
+		UINT16,
+		SINT16,
+		UINT8,
+		SINT8,
+		DEPTH_STENCIL,
+		BLOCK,
+		UNSUPPORTED
+	};
+
+	ComponentType GetComponentType( const Format format ) {
+		switch ( format ) {
+		case Format::R32G32B32A32_FLOAT:
+		case Format::R32G32B32_FLOAT:
+		case Format::R32G32_FLOAT:
+		case Format::R32_FLOAT:
+			return ComponentType::FLOAT32;
+		case Format::R16G16B16A16_FLOAT:
+		case Format::R16G16_FLOAT:
+		case Format::R16_FLOAT:
+			return ComponentType::FLOAT16;
+		case Format::R16G16B16A16_UNORM:
+		case Format::R16G16_UNORM:
+		case Format::R16_UNORM:
+			return ComponentType::UNORM16;
+		case Format::R16G16B16A16_SNORM:
+		case Format::R16G16_SNORM:
+		case Format::R16_SNORM:
+			return ComponentType::SNORM16;
+		case Format::R8G8B8A8_UNORM:
+		case Format::R8G8_UNORM:
+		case Format::R8_UNORM:
+			return ComponentType::UNORM8;
+		case Format::R8G8B8A8_SNORM:
+		case Format::R8G8_SNORM:
+		case Format::R8_SNORM:
+			return ComponentType::SNORM8;
+		case Format::R32G32B32A32_UINT:
+		case Format::R32G32B32_UINT:
+		case Format::R32G32_UINT:
+		case Format::R32_UINT:
+			return ComponentType::UINT32;
+		case Format::R16G16B16A16_UINT:
+		case Format::R16G16_UINT:
+		case Format::R16_UINT:
+			return ComponentType::UINT16;
+		case Format::R16G16B16A16_SINT:
+		case Format::R16G16_SINT:
+		case Format::R16_SINT:
+			return ComponentType::SINT16;
+		case Format::R8G8B8A8_UINT:
+		case Format::R8G8_UINT:
+		case Format::R8_UINT:
+			return ComponentType::UINT8;
+		case Format::R8G8B8A8_SINT:
+		case Format::R8G8_SINT:
+		case Format::R8_SINT:
+			return ComponentType::SINT8;
+		case Format::DEPTH_24_UNORM_STENCIL_8_UINT:
+			return ComponentType::DEPTH_STENCIL;
+		case Format::BC1:
+		case Format::BC3:
+			return ComponentType::BLOCK;
+		default:
+			return ComponentType::UNSUPPORTED;
+		}
+	}
+
+	bool IsInteger( const ComponentType type ) {
+		return type == ComponentType::UINT32 || type == ComponentType::UINT16 || type == ComponentType::SINT16 || type == ComponentType::UINT8 || type == ComponentType::SINT8;
+	}
+
+	// hodnota chybejiciho kanalu
+	inline float GetDefaultComponent( const int channel ) {
+		return channel == 3 ? 1.0f : 0;
+	}
+
+	// prevod slozek
+
+#ifdef SIMD_SSE2
+	// 8 hodnot -> 2x 4 int32
+
+	inline void Widen( const uint8_t* const src, __m128i& low, __m128i& high ) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i v = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast< const __m128i* >( src ) ), zero );
+		low = _mm_unpacklo_epi16( v, zero );
+		high = _mm_unpackhi_epi16( v, zero );
+	}
+
+	inline void Widen( const int8_t* const src, __m128i& low, __m128i& high ) {
+		const __m128i bytes = _mm_loadl_epi64( reinterpret_cast< const __m128i* >( src ) );
+		const __m128i v = _mm_srai_epi16( _mm_unpacklo_epi8( bytes, bytes ), 8 );
+		low = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+		high = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+	}
+
+	inline void Widen( const uint16_t* const src, __m128i& low, __m128i& high ) {
+		const __m128i v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( src ) );
+		low = _mm_unpacklo_epi16( v, _mm_setzero_si128() );
+		high = _mm_unpackhi_epi16( v, _mm_setzero_si128() );
+	}
+
+	inline void Widen( const int16_t* const src, __m128i& low, __m128i& high ) {
+		const __m128i v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( src ) );
+		low = _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 );
+		high = _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 );
+	}
+#endif
+
+	// value / scale, nejmene low (SNORM: nejmensi hodnota -128, -32768 je take -1)
+	template < typename T >
+	void DecodeComponents( const T* const src, float* const dest, const std::size_t count, const float scale, const float low ) {
+		std::size_t i = 0;
+	#ifdef SIMD_SSE2
+		const __m128 vScale = _mm_set1_ps( scale );
+		const __m128 vLow = _mm_set1_ps( low );
+		for ( ; i + 8 <= count; i += 8 ) {
+			__m128i a;
+			__m128i b;
+			Widen( src + i, a, b );
+			_mm_storeu_ps( dest + i, _mm_max_ps( _mm_div_ps( _mm_cvtepi32_ps( a ), vScale ), vLow ) );
+			_mm_storeu_ps( dest + i + 4, _mm_max_ps( _mm_div_ps( _mm_cvtepi32_ps( b ), vScale ), vLow ) );
+		}
+	#endif
+		for ( ; i < count; i++ ) {
+			dest[ i ] = fmaxf( static_cast< float >( src[ i ] ) / scale, low );
+		}
+	}
+
+	// value * scale zaokrouhleno k nejblizsimu celemu cislu a oriznuto do < low; high >, NaN na low
+	template < typename T >
+	void QuantizeComponents( const float* const src, T* const dest, const std::size_t count, const float scale, const float low, const float high ) {
+		int32_t chunk[ QUANTIZE_CHUNK ];
+		for ( std::size_t begin = 0; begin < count; begin += QUANTIZE_CHUNK ) {
+			const std::size_t n = count - begin < QUANTIZE_CHUNK ? count - begin : QUANTIZE_CHUNK;
+			std::size_t i = 0;
+		#ifdef SIMD_SSE2
+			for ( ; i + 4 <= n; i += 4 ) {
+				const __m128 value = _mm_mul_ps( _mm_loadu_ps( src + begin + i ), _mm_set1_ps( scale ) );
+				const __m128 clamped = _mm_min_ps( _mm_max_ps( value, _mm_set1_ps( low ) ), _mm_set1_ps( high ) );
+				_mm_storeu_si128( reinterpret_cast< __m128i* >( chunk + i ), _mm_cvtps_epi32( clamped ) );
+			}
+		#endif
+			for ( ; i < n; i++ ) {
+				chunk[ i ] = static_cast< int32_t >( std::lrint( fminf( fmaxf( src[ begin + i ] * scale, low ), high ) ) );
+			}
+			for ( i = 0; i < n; i++ ) {
+				dest[ begin + i ] = static_cast< T >( chunk[ i ] );
+			}
+		}
+	}
+
+	void DecodeComponents( const ComponentType type, const void* const src, float* const dest, const std::size_t count ) {
+		switch ( type ) {
+		case ComponentType::FLOAT32:
+			std::memcpy( dest, src, count * sizeof( float ) );
+			break;
+		case ComponentType::FLOAT16:
+			HalfToFloat( static_cast< const uint16_t* >( src ), dest, count );
+			break;
+		case ComponentType::UNORM16:
+			DecodeComponents( static_cast< const uint16_t* >( src ), dest, count, 65535.0f, 0 );
+			break;
+		case ComponentType::SNORM16:
+			DecodeComponents( static_cast< const int16_t* >( src ), dest, count, 32767.0f, -1.0f );
+			break;
+		case ComponentType::UNORM8:
+			DecodeComponents( static_cast< const uint8_t* >( src ), dest, count, 255.0f, 0 );
+			break;
+		case ComponentType::SNORM8:
+			DecodeComponents( static_cast< const int8_t* >( src ), dest, count, 127.0f, -1.0f );
+			break;
+		case ComponentType::UINT32: {
+			const uint32_t* const values = static_cast< const uint32_t* >( src );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				dest[ i ] = static_cast< float >( values[ i ] );
+			}
+			break;
+		}
+		case ComponentType::UINT16:
+			DecodeComponents( static_cast< const uint16_t* >( src ), dest, count, 1.0f, 0 );
+			break;
+		case ComponentType::SINT16:
+			DecodeComponents( static_cast< const int16_t* >( src ), dest, count, 1.0f, -32768.0f );
+			break;
+		case ComponentType::UINT8:
+			DecodeComponents( static_cast< const uint8_t* >( src ), dest, count, 1.0f, 0 );
+			break;
+		case ComponentType::SINT8:
+			DecodeComponents( static_cast< const int8_t* >( src ), dest, count, 1.0f, -128.0f );
+			break;
+		default:
+			break;
+		}
+	}
+
+	void EncodeComponents( const ComponentType type, const float* const src, void* const dest, const std::size_t count ) {
+		switch ( type ) {
+		case ComponentType::FLOAT32:
+			std::memcpy( dest, src, count * sizeof( float ) );
+			break;
+		case ComponentType::FLOAT16:
+			FloatToHalf( src, static_cast< uint16_t* >( dest ), count );
+			break;
+		case ComponentType::UNORM16:
+			QuantizeComponents( src, static_cast< uint16_t* >( dest ), count, 65535.0f, 0, 65535.0f );
+			break;
+		case ComponentType::SNORM16:
+			QuantizeComponents( src, static_cast< int16_t* >( dest ), count, 32767.0f, -32767.0f, 32767.0f );
+			break;
+		case ComponentType::UNORM8:
+			QuantizeComponents( src, static_cast< uint8_t* >( dest ), count, 255.0f, 0, 255.0f );
+			break;
+		case ComponentType::SNORM8:
+			QuantizeComponents( src, static_cast< int8_t* >( dest ), count, 127.0f, -127.0f, 127.0f );
+			break;
+		case ComponentType::UINT32: {
+			// rozsah uint32 neni presne vyjadritelny ve float, orezani v double
+			uint32_t* const values = static_cast< uint32_t* >( dest );
+			for ( std::size_t i = 0; i < count; i++ ) {
+				const double value = src[ i ];
+				values[ i ] = value > 0 ? ( value < 4294967295.0 ? static_cast< uint32_t >( std::llrint( value ) ) : 0xffffffff ) : 0;
+			}
+			break;
+		}
+		case ComponentType::UINT16:
+			QuantizeComponents( src, static_cast< uint16_t* >( dest ), count, 1.0f, 0, 65535.0f );
+			break;
+		case ComponentType::SINT16:
+			QuantizeComponents( src, static_cast< int16_t* >( dest ), count, 1.0f, -32768.0f, 32767.0f );
+			break;
+		case ComponentType::UINT8:
+			QuantizeComponents( src, static_cast< uint8_t* >( dest ), count, 1.0f, 0, 255.0f );
+			break;
+		case ComponentType::SINT8:
+			QuantizeComponents( src, static_cast< int8_t* >( dest ), count, 1.0f, -128.0f, 127.0f );
+			break;
+		default:
+			break;
+		}
+	}
+
+	// presny prevod mezi celociselnymi formaty
+
+	int64_t ReadInteger( const ComponentType type, const uint8_t* const src, const int index ) {
+		switch ( type ) {
+		case ComponentType::UINT32: {
+			uint32_t value;
+			std::memcpy( &value, src + index * 4, sizeof( value ) );
+			return value;
+		}
+		case ComponentType::UINT16: {
+			uint16_t value;
+			std::memcpy( &value, src + index * 2, sizeof( value ) );
+			return value;
+		}
+		case ComponentType::SINT16: {
+			int16_t value;
+			std::memcpy( &value, src + index * 2, sizeof( value ) );
+			return value;
+		}
+		case ComponentType::SINT8:
+			return static_cast< int8_t >( src[ index ] );
+		default:
+			return src[ index ];
+		}
+	}
+
+	void WriteInteger( const ComponentType type, uint8_t* const dest, const int index, const int64_t value ) {
+		switch ( type ) {
+		case ComponentType::UINT32: {
+			const uint32_t clamped = static_cast< uint32_t >( Math::Min( Math::Max( value, int64_t( 0 ) ), int64_t( 0xffffffff ) ) );
+			std::memcpy( dest + index * 4, &clamped, sizeof( clamped ) );
+			break;
+		}
+		case ComponentType::UINT16: {
+			const uint16_t clamped = static_cast< uint16_t >( Math::Min( Math::Max( value, int64_t( 0 ) ), int64_t( 65535 ) ) );
+			std::memcpy( dest + index * 2, &clamped, sizeof( clamped ) );
+			break;
+		}
+		case ComponentType::SINT16: {
+			const int16_t clamped = static_cast< int16_t >( Math::Min( Math::Max( value, int64_t( -32768 ) ), int64_t( 32767 ) ) );
+			std::memcpy( dest + index * 2, &clamped, sizeof( clamped ) );
+			break;
+		}
+		case ComponentType::SINT8:
+			dest[ index ] = static_cast< uint8_t >( static_cast< int8_t >( Math::Min( Math::Max( value, int64_t( -128 ) ), int64_t( 127 ) ) ) );
+			break;
+		default:
+			dest[ index ] = static_cast< uint8_t >( Math::Min( Math::Max( value, int64_t( 0 ) ), int64_t( 255 ) ) );
+			break;
+		}
+	}
+
+	void ConvertIntegers( const Format srcFormat, const uint8_t* const src, const Format destFormat, uint8_t* const dest, const int count ) {
+		const ComponentType srcType = GetComponentType( srcFormat );
+		const ComponentType destType = GetComponentType( destFormat );
+		const int srcChannels = GetFormatInfo( srcFormat ).channelsCount;
+		const int destChannels = GetFormatInfo( destFormat ).channelsCount;
+		for ( int x = 0; x < count; x++ ) {
+			for ( int c = 0; c < destChannels; c++ ) {
+				const int64_t value = c < srcChannels ? ReadInteger( srcType, src, x * srcChannels + c ) : ( c == 3 ? 1 : 0 );
+				WriteInteger( destType, dest, x * destChannels + c, value );
+			}
+		}
+	}
+
+	// dekomprese BC
+
+	// 5:6:5 -> 8 bitu na kanal (opakovani hornich bitu)
+	inline UNorm4x8 UnpackColor( const uint16_t color ) {
+		const int r = ( color >> 11 ) & 31;
+		const int g = ( color >> 5 ) & 63;
+		const int b = color & 31;
+		return { static_cast< uint8_t >( ( r << 3 ) | ( r >> 2 ) ), static_cast< uint8_t >( ( g << 2 ) | ( g >> 4 ) ), static_cast< uint8_t >( ( b << 3 ) | ( b >> 2 ) ), 255 };
+	}
+
+	// ( a * weightA + b * weightB ) / divisor zaokrouhleno k nejblizsi hodnote
+	inline uint8_t Interpolate( const int a, const int b, const int weightA, const int weightB, const int divisor ) {
+		return static_cast< uint8_t >( ( a * weightA + b * weightB + divisor / 2 ) / divisor );
+	}
+
+	inline UNorm4x8 InterpolateColor( const UNorm4x8 a, const UNorm4x8 b, const int weightA, const int weightB, const int divisor ) {
+		return {
+			Interpolate( a.x, b.x, weightA, weightB, divisor ),
+			Interpolate( a.y, b.y, weightA, weightB, divisor ),
+			Interpolate( a.z, b.z, weightA, weightB, divisor ),
+			255
+		};
+	}
+
+	void DecodeColorBlock( const uint8_t* const block, UNorm4x8* const pixels, const bool fourColors ) {
+		const uint16_t color0 = static_cast< uint16_t >( block[ 0 ] | ( block[ 1 ] << 8 ) );
+		const uint16_t color1 = static_cast< uint16_t >( block[ 2 ] | ( block[ 3 ] << 8 ) );
+		UNorm4x8 palette[ 4 ];
+		palette[ 0 ] = UnpackColor( color0 );
+		palette[ 1 ] = UnpackColor( color1 );
+		if ( fourColors || color0 > color1 ) {
+			palette[ 2 ] = InterpolateColor( palette[ 0 ], palette[ 1 ], 2, 1, 3 );
+			palette[ 3 ] = InterpolateColor( palette[ 0 ], palette[ 1 ], 1, 2, 3 );
+		} else {
+			palette[ 2 ] = InterpolateColor( palette[ 0 ], palette[ 1 ], 1, 1, 2 );
+			palette[ 3 ] = { 0, 0, 0, 0 };
+		}
+		const uint32_t indices = block[ 4 ] | ( block[ 5 ] << 8 ) | ( block[ 6 ] << 16 ) | ( static_cast< uint32_t >( block[ 7 ] ) << 24 );
+		for ( int i = 0; i < 16; i++ ) {
+			pixels[ i ] = palette[ ( indices >> ( i * 2 ) ) & 3 ];
+		}
+	}
+
+	// prepise alfu pixelu
+	void DecodeAlphaBlock( const uint8_t* const block, UNorm4x8* const pixels ) {
+		const int alpha0 = block[ 0 ];
+		const int alpha1 = block[ 1 ];
+		uint8_t palette[ 8 ];
+		palette[ 0 ] = block[ 0 ];
+		palette[ 1 ] = block[ 1 ];
+		if ( alpha0 > alpha1 ) {
+			for ( int i = 1; i < 7; i++ ) {
+				palette[ i + 1 ] = Interpolate( alpha0, alpha1, 7 - i, i, 7 );
+			}
+		} else {
+			for ( int i = 1; i < 5; i++ ) {
+				palette[ i + 1 ] = Interpolate( alpha0, alpha1, 5 - i, i, 5 );
+			}
+			palette[ 6 ] = 0;
+			palette[ 7 ] = 255;
+		}
+		uint64_t indices = 0;
+		for ( int i = 0; i < 6; i++ ) {
+			indices |= static_cast< uint64_t >( block[ 2 + i ] ) << ( i * 8 );
+		}
+		for ( int i = 0; i < 16; i++ ) {
+			pixels[ i ].w = palette[ ( indices >> ( i * 3 ) ) & 7 ];
+		}
+	}
+
+	// radek bloku -> rows radku pixelu o sirce width (bez mezer)
+	void DecodeBlockRow( const Format format, const uint8_t* const blocks, UNorm4x8* const dest, const int width, const int rows ) {
+		const int blockByteWidth = GetFormatInfo( format ).blockByteWidth;
+		UNorm4x8 pixels[ 16 ];
+		for ( int bx = 0; bx * 4 < width; bx++ ) {
+			DecodeBlock( format, blocks + bx * blockByteWidth, pixels );
+			const int columns = Math::Min( width - bx * 4, 4 );
+			for ( int y = 0; y < rows; y++ ) {
+				std::memcpy( dest + y * width + bx * 4, pixels + y * 4, columns * sizeof( UNorm4x8 ) );
+			}
+		}
+	}
+
+	/*
+	Prevod po skupinach radku, skupina je jeden radek pixelu nebo radek bloku (4 radky), pokud je jeden z formatu BC.
+	Radky BC jsou prevadeny pres pomocny pruh R8G8B8A8 (strip).
+	*/
+	struct ConversionJob {
+		int width;
+		int height;
+		Format srcFormat;
+		const uint8_t* src;
+		std::size_t srcRowPitch;
+		Format destFormat;
+		uint8_t* dest;
+		std::size_t destRowPitch;
+		const FormatConversionParams* params;
+		int groupRows;
+	};
+
+	void ConvertGroups( const ConversionJob& job, const int beginGroup, const int endGroup ) {
+		const int width = job.width;
+		const FormatConversionParams& params = *job.params;
+		const bool srcBlocks = GetComponentType( job.srcFormat ) == ComponentType::BLOCK;
+		const bool destBlocks = GetComponentType( job.destFormat ) == ComponentType::BLOCK;
+		const bool integers = IsInteger( GetComponentType( job.srcFormat ) ) && IsInteger( GetComponentType( job.destFormat ) );
+		const bool sameEncoding = params.srcEncoding == params.destEncoding;
+		std::vector< Float4 > values( width );
+		std::vector< UNorm4x8 > strip( srcBlocks || destBlocks ? static_cast< std::size_t >( width ) * 4 : 0 );
+		Color* const colors = reinterpret_cast< Color* >( values.data() );
+
+		for ( int group = beginGroup; group < endGroup; group++ ) {
+			const int firstRow = group * job.groupRows;
+			const int rows = Math::Min( job.groupRows, job.height - firstRow );
+			if ( srcBlocks ) {
+				DecodeBlockRow( job.srcFormat, job.src + group * job.srcRowPitch, strip.data(), width, rows );
+			}
+			for ( int r = 0; r < rows; r++ ) {
+				UNorm4x8* const stripRow = strip.data() + r * width;
+				const uint8_t* const src = job.src + ( firstRow + r ) * job.srcRowPitch;
+				uint8_t* const dest = job.dest + ( firstRow + r ) * job.destRowPitch;
+				if ( srcBlocks && destBlocks ) {
+					if ( !sameEncoding ) {
+						ConvertColors( stripRow, colors, width, params.srcEncoding );
+						ConvertColors( colors, stripRow, width, params.destEncoding );
+					}
+				} else if ( srcBlocks ) {
+					if ( job.destFormat == Format::R8G8B8A8_UNORM && sameEncoding ) {
+						std::memcpy( dest, stripRow, width * sizeof( UNorm4x8 ) );
+					} else {
+						ConvertColors( stripRow, colors, width, params.srcEncoding );
+						EncodePixels( job.destFormat, values.data(), dest, width, params.destEncoding );
+					}
+				} else if ( destBlocks ) {
+					if ( job.srcFormat == Format::R8G8B8A8_UNORM && sameEncoding ) {
+						std::memcpy( stripRow, src, width * sizeof( UNorm4x8 ) );
+					} else {
+						DecodePixels( job.srcFormat, src, values.data(), width, params.srcEncoding );
+						ConvertColors( colors, stripRow, width, params.destEncoding );
+					}
+				} else if ( integers ) {
+					ConvertIntegers( job.srcFormat, src, job.destFormat, dest, width );
+				} else {
+					DecodePixels( job.srcFormat, src, values.data(), width, params.srcEncoding );
+					EncodePixels( job.destFormat, values.data(), dest, width, params.destEncoding );
+				}
+			}
+			if ( destBlocks ) {
+				const BlockCompressionParams compression = { job.destFormat, params.quality, false };
+				CompressTexture( width, rows, strip.data(), job.dest + group * job.destRowPitch, compression );
+			}
+		}
+	}
+
+	// bajtu na radek (radek bloku)
+	std::size_t GetRowByteWidth( const Format format, const int width ) {
+		const FormatInfo info = GetFormatInfo( format );
+		return static_cast< std::size_t >( ( width + info.blockSize - 1 ) / info.blockSize ) * info.blockByteWidth;
+	}
+
+	bool IsEncodingSupported( const Format format, const ColorEncoding encoding ) {
+		return encoding == ColorEncoding::LINEAR || format == Format::R8G8B8A8_UNORM || format == Format::BC1 || format == Format::BC3;
+	}
+}
+
+bool RenderInterface::DecodePixels( const Format format, const void* const src, Float4* const dest, const int count, const ColorEncoding encoding ) {
+	const ComponentType type = GetComponentType( format );
+	if ( type == ComponentType::BLOCK || type == ComponentType::UNSUPPORTED || count < 0 || ( encoding == ColorEncoding::SRGB && format != Format::R8G8B8A8_UNORM ) ) {
+		return false;
+	}
+	if ( format == Format::R8G8B8A8_UNORM ) {
+		ConvertColors( static_cast< const UNorm4x8* >( src ), reinterpret_cast< Color* >( dest ), count, encoding );
+		return true;
+	}
+	const uint8_t* const bytes = static_cast< const uint8_t* >( src );
+	if ( type == ComponentType::DEPTH_STENCIL ) {
+		for ( int x = 0; x < count; x++ ) {
+			uint32_t value;
+			std::memcpy( &value, bytes + x * 4, sizeof( value ) );
+			dest[ x ] = { static_cast< float >( value & 0x00ffffff ) / 16777215.0f, static_cast< float >( value >> 24 ), 0, 1.0f };
+		}
+		return true;
+	}
+	const FormatInfo info = GetFormatInfo( format );
+	if ( info.channelsCount == 4 ) {
+		DecodeComponents( type, src, reinterpret_cast< float* >( dest ), static_cast< std::size_t >( count ) * 4 );
+		return true;
+	}
+	float components[ PIXELS_CHUNK * 4 ];
+	for ( int begin = 0; begin < count; begin += PIXELS_CHUNK ) {
+		const int n = Math::Min( count - begin, PIXELS_CHUNK );
+		DecodeComponents( type, bytes + begin * info.blockByteWidth, components, static_cast< std::size_t >( n ) * info.channelsCount );
+		for ( int x = 0; x < n; x++ ) {
+			float* const values = &dest[ begin + x ].x;
+			for ( int c = 0; c < 4; c++ ) {
+				values[ c ] = c < info.channelsCount ? components[ x * info.channelsCount + c ] : GetDefaultComponent( c );
+			}
+		}
+	}
+	return true;
+}
+
+bool RenderInterface::EncodePixels( const Format format, const Float4* const src, void* const dest, const int count, const ColorEncoding encoding ) {
+	const ComponentType type = GetComponentType( format );
+	if ( type == ComponentType::BLOCK || type == ComponentType::UNSUPPORTED || count < 0 || ( encoding == ColorEncoding::SRGB && format != Format::R8G8B8A8_UNORM ) ) {
+		return false;
+	}
+	if ( format == Format::R8G8B8A8_UNORM ) {
+		ConvertColors( reinterpret_cast< const Color* >( src ), static_cast< UNorm4x8* >( dest ), count, encoding );
+		return true;
+	}
+	uint8_t* const bytes = static_cast< uint8_t* >( dest );
+	if ( type == ComponentType::DEPTH_STENCIL ) {
+		for ( int x = 0; x < count; x++ ) {
+			const uint32_t depth = static_cast< uint32_t >( std::lrint( Math::Clamp( src[ x ].x, 0, 1.0f ) * 16777215.0f ) );
+			const uint32_t stencil = static_cast< uint32_t >( std::lrint( Math::Clamp( src[ x ].y, 0, 255.0f ) ) );
+			const uint32_t value = depth | ( stencil << 24 );
+			std::memcpy( bytes + x * 4, &value, sizeof( value ) );
+		}
+		return true;
+	}
+	const FormatInfo info = GetFormatInfo( format );
+	if ( info.channelsCount == 4 ) {
+		EncodeComponents( type, reinterpret_cast< const float* >( src ), dest, static_cast< std::size_t >( count ) * 4 );
+		return true;
+	}
+	float components[ PIXELS_CHUNK * 4 ];
+	for ( int begin = 0; begin < count; begin += PIXELS_CHUNK ) {
+		const int n = Math::Min( count - begin, PIXELS_CHUNK );
+		for ( int x = 0; x < n; x++ ) {
+			const float* const values = &src[ begin + x ].x;
+			for ( int c = 0; c < info.channelsCount; c++ ) {
+				components[ x * info.channelsCount + c ] = values[ c ];
+			}
+		}
+		EncodeComponents( type, components, bytes + begin * info.blockByteWidth, static_cast< std::size_t >( n ) * info.channelsCount );
+	}
+	return true;
+}
+
+bool RenderInterface::DecodeBlock( const Format format, const void* const block, UNorm4x8* const pixels ) {
+	const uint8_t* const bytes = static_cast< const uint8_t* >( block );
+	if ( format == Format::BC1 ) {
+		DecodeColorBlock( bytes, pixels, false );
+		return true;
+	}
+	if ( format == Format::BC3 ) {
+		DecodeColorBlock( bytes + 8, pixels, true );
+		DecodeAlphaBlock( bytes, pixels );
+		return true;
+	}
+	return false;
+}
+
+bool RenderInterface::ConvertTexture( const int width, const int height, const Format srcFormat, const void* const src, const int srcRowPitch, const Format destFormat, void* const dest, const int destRowPitch, const FormatConversionParams& params ) {
+	if ( GetComponentType( srcFormat ) == ComponentType::UNSUPPORTED || GetComponentType( destFormat ) == ComponentType::UNSUPPORTED ) {
+		return false;
+	}
+	if ( width < 1 || height < 1 || src == nullptr || dest == nullptr ) {
+		return false;
+	}
+	if ( !IsEncodingSupported( srcFormat, params.srcEncoding ) || !IsEncodingSupported( destFormat, params.destEncoding ) ) {
+		return false;
+	}
+	const std::size_t srcRowByteWidth = GetRowByteWidth( srcFormat, width );
+	const std::size_t destRowByteWidth = GetRowByteWidth( destFormat, width );
+	const std::size_t srcPitch = srcRowPitch == 0 ? srcRowByteWidth : static_cast< std::size_t >( srcRowPitch );
+	const std::size_t destPitch = destRowPitch == 0 ? destRowByteWidth : static_cast< std::size_t >( destRowPitch );
+	if ( srcRowPitch < 0 || destRowPitch < 0 || srcPitch < srcRowByteWidth || destPitch < destRowByteWidth ) {
+		return false;
+	}
+
+	// stejny format, jen kopie radku
+	if ( srcFormat == destFormat && params.srcEncoding == params.destEncoding ) {
+		const int blockSize = GetFormatInfo( srcFormat ).blockSize;
+		const int rows = ( height + blockSize - 1 ) / blockSize;
+		for ( int y = 0; y < rows; y++ ) {
+			std::memcpy( static_cast< uint8_t* >( dest ) + y * destPitch, static_cast< const uint8_t* >( src ) + y * srcPitch, srcRowByteWidth );
+		}
+		return true;
+	}
+
+	const bool blocks = GetComponentType( srcFormat ) == ComponentType::BLOCK || GetComponentType( destFormat ) == ComponentType::BLOCK;
+	ConversionJob job;
+	job.width = width;
+	job.height = height;
+	job.srcFormat = srcFormat;
+	job.src = static_cast< const uint8_t* >( src );
+	job.srcRowPitch = srcPitch;
+	job.destFormat = destFormat;
+	job.dest = static_cast< uint8_t* >( dest );
+	job.destRowPitch = destPitch;
+	job.params = &params;
+	job.groupRows = blocks ? 4 : 1;
+
+	const int groupsCount = ( height + job.groupRows - 1 ) / job.groupRows;
+	auto function = [ & ]( const std::size_t begin, const std::size_t end ) {
+		ConvertGroups( job, static_cast< int >( begin ), static_cast< int >( end ) );
+	};
+	if ( params.parallel ) {
+		const int batch = Math::Max( BATCH_PIXELS / ( width * job.groupRows ), 1 );
+		ParallelFor( groupsCount, batch, function );
+		return true;
+	}
+	function( 0, groupsCount );
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "RenderInterface.h"
+#include "BlockCompression.h"
+#include "Framework/ColorArray.h"
+
+namespace RenderInterface {
+
+	/*
+	Parametry funkce ConvertTexture()
+	*/
+	struct FormatConversionParams {
+		ColorEncoding srcEncoding;			// SRGB jen pro R8G8B8A8_UNORM, BC1 a BC3 (data textur *_SRGB)
+		ColorEncoding destEncoding;
+		BlockCompressionQuality quality;	// cilovy format BC1 nebo BC3
+		bool parallel;						// rozdelit radky mezi vlakna ParallelFor
+	};
+
+	/*
+	Prevod count pixelu formatu textury na Float4 a zpet (vsechny formaty krome UNKNOWN a BC).
+	Chybejici kanaly maji hodnotu ( 0, 0, 0, 1 ).
+	UNORM, SNORM: hodnoty v rozsahu < 0; 1 >, < -1; 1 > (nejmensi SNORM hodnota je take -1), pri zapisu jsou orezany
+	a zaokrouhleny k nejblizsi hodnote (NaN na 0, SNORM na -1). FLOAT: half viz FloatToHalf().
+	UINT, SINT: ciselna hodnota (32 bitove hodnoty nad 2^24 ztrati presnost), pri zapisu zaokrouhlena a orezana do rozsahu formatu.
+	DEPTH_24_UNORM_STENCIL_8_UINT: x je hloubka (UNORM), y je hodnota stencil.
+	R8G8B8A8_UNORM se prevadi funkci ConvertColors(), jen tento format podporuje kodovani SRGB.
+	Pixely se ctou a zapisuji postupne, src i dest muze byt namapovany buffer. Vraci false pro nepodporovany format.
+	*/
+	bool DecodePixels( const Format format, const void* const src, Float4* const dest, const int count, const ColorEncoding encoding = ColorEncoding::LINEAR );
+	bool EncodePixels( const Format format, const Float4* const src, void* const dest, const int count, const ColorEncoding encoding = ColorEncoding::LINEAR );
+
+	/*
+	Dekomprese jednoho bloku BC1 nebo BC3 (8 nebo 16 bajtu) na 4x4 pixelu R8G8B8A8_UNORM, pixels[ y * 4 + x ].
+	Interpolovane barvy jsou zaokrouhleny k nejblizsi hodnote (( 2 * c0 + c1 + 1 ) / 3 pro kazdy kanal po rozsireni 5:6:5 na 8 bitu).
+	BC1 s color0 <= color1 pouziva 3 barvy a pruhlednou cernou ( 0, 0, 0, 0 ), barevny blok BC3 ma vzdy 4 barvy.
+	Vraci false pro jiny format nez BC1 a BC3.
+	*/
+	bool DecodeBlock( const Format format, const void* const block, UNorm4x8* const pixels );
+
+	/*
+	Prevod 2D obrazu (jedne subresource) width x height mezi libovolnymi formaty krome UNKNOWN.
+	Radky se zpracuji postupne: rowPitch je vzdalenost radku v bajtech (napr. MappedBuffer::rowPitch),
+	pro BC formaty vzdalenost radku bloku, 0 znamena radky bez mezer.
+	Nekomprimovane formaty se prevadi pres Float4 (DecodePixels(), EncodePixels()), shodny format a kodovani se kopiruje,
+	mezi celociselnymi formaty (UINT, SINT) se prevadi presne s orezanim do rozsahu ciloveho formatu.
+	BC zdroj se dekomprimuje funkci DecodeBlock() po radcich bloku, BC cil se komprimuje funkci CompressTexture()
+	(kvalita params.quality, pro BC1 jsou pixely s alfou < 0.5 pruhledne).
+	Vraci false pro nepodporovany format, neplatne rozmery nebo prilis maly rowPitch.
+	*/
+	bool ConvertTexture( const int width, const int height, const Format srcFormat, const void* const src, const int srcRowPitch, const Format destFormat, void* const dest, const int destRowPitch, const FormatConversionParams& params );
+}
\ No newline at end of file
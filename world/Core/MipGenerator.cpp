@@ -0,0 +1,436 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "MipGenerator.h"
+#include "FormatConversion.h"
+#include "Framework/Parallel.h"
+#include "Framework/Simd.h"
+
+using namespace RenderInterface;
+
+namespace {
+
+	// pocet radku zmensene urovne zpracovanych jednim volanim (cast ParallelFor)
+	const int BAND_ROWS = 32;
+
+	// filtry KAISER a LANCZOS
+	const double FILTER_RADIUS = 3.0;
+	const double KAISER_ALPHA = 4.0;
+
+	enum class ComponentType {
+		FLOAT32,
+		FLOAT16,
+		UNORM16,
+		SNORM16,
+		UNORM8,
+		SNORM8,
+		INTEGER,		// celociselne formaty a depth stencil, bodove vzorkovani
+		UNSUPPORTED
+	};
+
+	ComponentType GetComponentType( const Format format ) {
+		switch ( format ) {
+		case Format::R32G32B32A32_FLOAT:
+		case Format::R32G32B32_FLOAT:
+		case Format::R32G32_FLOAT:
+		case Format::R32_FLOAT:
+			return ComponentType::FLOAT32;
+		case Format::R16G16B16A16_FLOAT:
+		case Format::R16G16_FLOAT:
+		case Format::R16_FLOAT:
+			return ComponentType::FLOAT16;
+		case Format::R16G16B16A16_UNORM:
+		case Format::R16G16_UNORM:
+		case Format::R16_UNORM:
+			return ComponentType::UNORM16;
+		case Format::R16G16B16A16_SNORM:
+		case Format::R16G16_SNORM:
+		case Format::R16_SNORM:
+			return ComponentType::SNORM16;
+		case Format::R8G8B8A8_UNORM:
+		case Format::R8G8_UNORM:
+		case Format::R8_UNORM:
+			return ComponentType::UNORM8;
+		case Format::R8G8B8A8_SNORM:
+		case Format::R8G8_SNORM:
+		case Format::R8_SNORM:
+			return ComponentType::SNORM8;
+		case Format::R32G32B32A32_UINT:
+		case Format::R32G32B32_UINT:
+		case Format::R32G32_UINT:
+		case Format::R32_UINT:
+		case Format::R16G16B16A16_UINT:
+		case Format::R16G16B16A16_SINT:
+		case Format::R16G16_UINT:
+		case Format::R16G16_SINT:
+		case Format::R16_UINT:
+		case Format::R16_SINT:
+		case Format::R8G8B8A8_UINT:
+		case Format::R8G8B8A8_SINT:
+		case Format::R8G8_UINT:
+		case Format::R8G8_SINT:
+		case Format::R8_UINT:
+		case Format::R8_SINT:
+		case Format::DEPTH_24_UNORM_STENCIL_8_UINT:
+			return ComponentType::INTEGER;
+		default:
+			return ComponentType::UNSUPPORTED;
+		}
+	}
+
+	// filtry
+
+	double Sinc( const double x ) {
+		if ( x == 0 ) {
+			return 1.0;
+		}
+		const double a = x * 3.14159265358979323846;
+		return std::sin( a ) / a;
+	}
+
+	// modifikovana Besselova funkce prvniho druhu radu 0 (Taylorova rada)
+	double BesselI0( const double x ) {
+		const double q = x * x * 0.25;
+		double sum = 1.0;
+		double term = 1.0;
+		for ( int k = 1; term > sum * 1e-12; k++ ) {
+			term *= q / ( static_cast< double >( k ) * k );
+			sum += term;
+		}
+		return sum;
+	}
+
+	// x je vzdalenost v pixelech zmensene urovne
+	double GetFilterWeight( const MipFilter filter, const double x ) {
+		if ( std::fabs( x ) >= FILTER_RADIUS ) {
+			return 0;
+		}
+		if ( filter == MipFilter::KAISER ) {
+			const double t = x / FILTER_RADIUS;
+			return Sinc( x ) * BesselI0( KAISER_ALPHA * std::sqrt( 1.0 - t * t ) ) / BesselI0( KAISER_ALPHA );
+		}
+		return Sinc( x ) * Sinc( x / FILTER_RADIUS );
+	}
+
+	int Address( const int index, const int size, const TextureAddressing addressing ) {
+		switch ( addressing ) {
+		case TextureAddressing::WRAP:
+			return ( ( index % size ) + size ) % size;
+		case TextureAddressing::MIRROR: {
+			const int period = ( ( index % ( size * 2 ) ) + size * 2 ) % ( size * 2 );
+			return period < size ? period : size * 2 - 1 - period;
+		}
+		default:
+			return index < 0 ? 0 : ( index >= size ? size - 1 : index );
+		}
+	}
+
+	/*
+	Vahy filtru v jedne ose. Pixel i zmensene urovne je soucet zdrojovych pixelu first[ i ] + k, k < count( i ),
+	(index pred adresovanim, first je neklesajici), jejich adresovane indexy a vahy jsou ulozeny od offset[ i ].
+	*/
+	struct FilterTaps {
+		std::vector< int > first;
+		std::vector< int > offset;
+		std::vector< int > index;
+		std::vector< float > weight;
+		int maxCount;
+	};
+
+	void BuildTaps( const MipFilter filter, const TextureAddressing addressing, const int srcSize, const int dstSize, FilterTaps& taps ) {
+		const double scale = static_cast< double >( srcSize ) / dstSize;
+		const double support = filter == MipFilter::BOX ? scale * 0.5 : FILTER_RADIUS * scale;
+		taps.first.resize( dstSize );
+		taps.offset.resize( dstSize + 1 );
+		taps.index.clear();
+		taps.weight.clear();
+		taps.maxCount = 0;
+
+		std::vector< double > weights;
+		for ( int i = 0; i < dstSize; i++ ) {
+			const double center = ( i + 0.5 ) * scale;
+			int begin = 0;
+			int end = 0;
+			if ( filter == MipFilter::BOX ) {
+				// pixely, ktere s intervalem filtru sdileji nenulovou plochu
+				begin = static_cast< int >( std::floor( center - support ) );
+				end = static_cast< int >( std::ceil( center + support ) );
+			} else {
+				// stredy pixelu uvnitr polomeru filtru
+				begin = static_cast< int >( std::floor( center - support - 0.5 ) ) + 1;
+				end = static_cast< int >( std::ceil( center + support - 0.5 ) );
+			}
+			weights.clear();
+			double sum = 0;
+			for ( int j = begin; j < end; j++ ) {
+				double weight = 0;
+				if ( filter == MipFilter::BOX ) {
+					weight = std::fmin( j + 1.0, center + support ) - std::fmax( static_cast< double >( j ), center - support );
+				} else {
+					weight = GetFilterWeight( filter, ( j + 0.5 - center ) / scale );
+				}
+				weights.push_back( weight );
+				sum += weight;
+			}
+			taps.first[ i ] = begin;
+			taps.offset[ i ] = static_cast< int >( taps.index.size() );
+			for ( int j = begin; j < end; j++ ) {
+				taps.index.push_back( Address( j, srcSize, addressing ) );
+				taps.weight.push_back( static_cast< float >( weights[ j - begin ] / sum ) );
+			}
+			taps.maxCount = Math::Max( taps.maxCount, end - begin );
+		}
+		taps.offset[ dstSize ] = static_cast< int >( taps.index.size() );
+	}
+
+	// prevod radku mezi formatem textury a Float4 (linearni hodnoty, normaly v rozsahu < -1; 1 >)
+
+	struct RowCodec {
+		Format format;
+		int channels;
+		int pixelSize;
+		bool srgb;
+		bool normalMap;
+		bool unorm;
+	};
+
+	void DecodeRow( const RowCodec& codec, const void* const src, Float4* const dest, const int width ) {
+		DecodePixels( codec.format, src, dest, width, codec.srgb ? ColorEncoding::SRGB : ColorEncoding::LINEAR );
+		if ( !codec.normalMap ) {
+			return;
+		}
+		const Simd::Vec4 scale = codec.unorm ? Simd::Set( 2.0f, 2.0f, 2.0f, 1.0f ) : Simd::Replicate( 1.0f );
+		const Simd::Vec4 bias = codec.unorm ? Simd::Set( -1.0f, -1.0f, -1.0f, 0 ) : Simd::Zero();
+		for ( int x = 0; x < width; x++ ) {
+			Simd::Store( &dest[ x ].x, Simd::MulAdd( Simd::Load( &dest[ x ].x ), scale, bias ) );
+			if ( codec.channels == 2 ) {
+				dest[ x ].z = std::sqrt( fmaxf( 1.0f - dest[ x ].x * dest[ x ].x - dest[ x ].y * dest[ x ].y, 0 ) );
+			}
+		}
+	}
+
+	// values jsou zmeneny (normalizace normal)
+	void EncodeRow( const RowCodec& codec, Float4* const values, void* const dest, const int width ) {
+		if ( codec.normalMap ) {
+			const Simd::Vec4 scale = codec.unorm ? Simd::Set( 0.5f, 0.5f, 0.5f, 1.0f ) : Simd::Replicate( 1.0f );
+			const Simd::Vec4 bias = codec.unorm ? Simd::Set( 0.5f, 0.5f, 0.5f, 0 ) : Simd::Zero();
+			for ( int x = 0; x < width; x++ ) {
+				Simd::Vec4 v = Simd::Load( &values[ x ].x );
+				const float lengthSq = Simd::GetX( Simd::Dot3( v, v ) );
+				if ( lengthSq > 0 ) {
+					// ( x, y, z ) / length, slozka w zustava
+					const Simd::Vec4 normal = Simd::Mul( v, Simd::Replicate( 1.0f / std::sqrt( lengthSq ) ) );
+					v = Simd::Shuffle< 0, 1, 0, 2 >( normal, Simd::Shuffle< 2, 2, 3, 3 >( normal, v ) );
+				} else {
+					v = Simd::Set( 0, 0, 1.0f, values[ x ].w );
+				}
+				Simd::Store( &values[ x ].x, Simd::MulAdd( v, scale, bias ) );
+			}
+		}
+		EncodePixels( codec.format, values, dest, width, codec.srgb ? ColorEncoding::SRGB : ColorEncoding::LINEAR );
+	}
+
+	/*
+	Zmenseni jedne urovne. Zdrojem je bud uroven 0 ve formatu textury (source), nebo float data predchozi urovne.
+	Radky se filtruji horizontalne do kruhoveho bufferu (kazdy zdrojovy radek jednou v ramci casti),
+	vertikalni filtr pak kombinuje radky bufferu.
+	*/
+	struct LevelJob {
+		const RowCodec* codec;
+		const FilterTaps* tapsX;
+		const FilterTaps* tapsY;
+		TextureAddressing addressing;
+		int srcWidth;
+		int srcHeight;
+		int dstWidth;
+		int dstHeight;
+		const uint8_t* source;
+		const Float4* sourceValues;
+		uint8_t* dest;
+		Float4* destValues;			// float data pro dalsi uroven, muze byt nullptr
+	};
+
+	void FilterRow( const Float4* const src, const FilterTaps& taps, Float4* const dest, const int width ) {
+		for ( int x = 0; x < width; x++ ) {
+			Simd::Vec4 sum = Simd::Zero();
+			for ( int t = taps.offset[ x ]; t < taps.offset[ x + 1 ]; t++ ) {
+				sum = Simd::MulAdd( Simd::Load( &src[ taps.index[ t ] ].x ), Simd::Replicate( taps.weight[ t ] ), sum );
+			}
+			Simd::Store( &dest[ x ].x, sum );
+		}
+	}
+
+	void FilterBand( const LevelJob& job, const int beginRow, const int endRow ) {
+		const FilterTaps& tapsY = *job.tapsY;
+		const int ringSize = tapsY.maxCount;
+		const int dstWidth = job.dstWidth;
+		std::vector< Float4 > ring( static_cast< std::size_t >( ringSize ) * dstWidth );
+		std::vector< Float4 > decoded( job.source != nullptr ? job.srcWidth : 0 );
+		std::vector< Float4 > row( dstWidth );
+		std::vector< const Float4* > rows( ringSize );
+		const std::size_t srcPitch = static_cast< std::size_t >( job.srcWidth ) * job.codec->pixelSize;
+		const std::size_t dstPitch = static_cast< std::size_t >( dstWidth ) * job.codec->pixelSize;
+
+		int nextRow = tapsY.first[ beginRow ];
+		for ( int y = beginRow; y < endRow; y++ ) {
+			const int first = tapsY.first[ y ];
+			const int count = tapsY.offset[ y + 1 ] - tapsY.offset[ y ];
+
+			// horizontalni filtr chybejicich radku
+			nextRow = Math::Max( nextRow, first );
+			for ( ; nextRow < first + count; nextRow++ ) {
+				const int sourceRow = Address( nextRow, job.srcHeight, job.addressing );
+				const Float4* src = nullptr;
+				if ( job.source != nullptr ) {
+					DecodeRow( *job.codec, job.source + sourceRow * srcPitch, decoded.data(), job.srcWidth );
+					src = decoded.data();
+				} else {
+					src = job.sourceValues + static_cast< std::size_t >( sourceRow ) * job.srcWidth;
+				}
+				const int slot = ( ( nextRow % ringSize ) + ringSize ) % ringSize;
+				FilterRow( src, *job.tapsX, ring.data() + static_cast< std::size_t >( slot ) * dstWidth, dstWidth );
+			}
+
+			// vertikalni filtr
+			for ( int k = 0; k < count; k++ ) {
+				const int slot = ( ( ( first + k ) % ringSize ) + ringSize ) % ringSize;
+				rows[ k ] = ring.data() + static_cast< std::size_t >( slot ) * dstWidth;
+			}
+			const float* const weights = tapsY.weight.data() + tapsY.offset[ y ];
+			for ( int x = 0; x < dstWidth; x++ ) {
+				Simd::Vec4 sum = Simd::Zero();
+				for ( int k = 0; k < count; k++ ) {
+					sum = Simd::MulAdd( Simd::Load( &rows[ k ][ x ].x ), Simd::Replicate( weights[ k ] ), sum );
+				}
+				Simd::Store( &row[ x ].x, sum );
+			}
+			if ( job.destValues != nullptr ) {
+				std::memcpy( job.destValues + static_cast< std::size_t >( y ) * dstWidth, row.data(), dstWidth * sizeof( Float4 ) );
+			}
+			EncodeRow( *job.codec, row.data(), job.dest + y * dstPitch, dstWidth );
+		}
+	}
+
+	// bodove vzorkovani (celociselne formaty), pixel nejblize stredu zmenseneho pixelu
+	void SampleBand( const uint8_t* const src, const int srcWidth, const int srcHeight, uint8_t* const dest, const int dstWidth, const int dstHeight, const int pixelSize, const int beginRow, const int endRow ) {
+		const std::size_t srcPitch = static_cast< std::size_t >( srcWidth ) * pixelSize;
+		const std::size_t dstPitch = static_cast< std::size_t >( dstWidth ) * pixelSize;
+		for ( int y = beginRow; y < endRow; y++ ) {
+			const int sy = static_cast< int >( ( y * 2 + 1 ) * static_cast< int64_t >( srcHeight ) / ( dstHeight * 2 ) );
+			const uint8_t* const srcRow = src + sy * srcPitch;
+			uint8_t* const destRow = dest + y * dstPitch;
+			for ( int x = 0; x < dstWidth; x++ ) {
+				const int sx = static_cast< int >( ( x * 2 + 1 ) * static_cast< int64_t >( srcWidth ) / ( dstWidth * 2 ) );
+				std::memcpy( destRow + x * pixelSize, srcRow + sx * pixelSize, pixelSize );
+			}
+		}
+	}
+
+	// zpracuje radky < 0; rowsCount ) po castech BAND_ROWS
+	template < typename FUNCTION >
+	void ProcessBands( const int rowsCount, const bool parallel, const FUNCTION& function ) {
+		const std::size_t bandsCount = static_cast< std::size_t >( ( rowsCount + BAND_ROWS - 1 ) / BAND_ROWS );
+		auto bands = [ & ]( const std::size_t begin, const std::size_t end ) {
+			for ( std::size_t band = begin; band < end; band++ ) {
+				const int beginRow = static_cast< int >( band ) * BAND_ROWS;
+				function( beginRow, Math::Min( beginRow + BAND_ROWS, rowsCount ) );
+			}
+		};
+		if ( parallel ) {
+			ParallelFor( bandsCount, 1, bands );
+			return;
+		}
+		bands( 0, bandsCount );
+	}
+}
+
+int RenderInterface::GetMipLevelsCount( const int width, const int height ) noexcept {
+	return Math::GetHighestBit( static_cast< uint32_t >( Math::Max( Math::Max( width, height ), 1 ) ) ) + 1;
+}
+
+int RenderInterface::GetMipDataSize( const Format format, const int width, const int height, const int mipLevel ) noexcept {
+	TextureDimmensions dimmensions;
+	GetMipDimmensions( width, height, 1, mipLevel, dimmensions );
+	const FormatInfo info = GetFormatInfo( format );
+	const int columns = ( dimmensions.width + info.blockSize - 1 ) / info.blockSize;
+	const int rows = ( dimmensions.height + info.blockSize - 1 ) / info.blockSize;
+	return columns * rows * info.blockByteWidth;
+}
+
+bool RenderInterface::GenerateMips( const Format format, const int width, const int height, const int mipLevels, const void* const source, void* const* const mips, const MipGeneratorParams& params ) {
+	const ComponentType type = GetComponentType( format );
+	const FormatInfo info = GetFormatInfo( format );
+	if ( type == ComponentType::UNSUPPORTED || width < 1 || height < 1 || mipLevels < 1 || mipLevels > GetMipLevelsCount( width, height ) || source == nullptr ) {
+		return false;
+	}
+	if ( params.srgb && ( format != Format::R8G8B8A8_UNORM || params.normalMap ) ) {
+		return false;
+	}
+	if ( params.normalMap && ( type == ComponentType::INTEGER || info.channelsCount < 2 ) ) {
+		return false;
+	}
+	for ( int level = 1; level < mipLevels; level++ ) {
+		if ( mips == nullptr || mips[ level - 1 ] == nullptr ) {
+			return false;
+		}
+	}
+
+	// celociselne formaty
+	if ( type == ComponentType::INTEGER ) {
+		const uint8_t* src = static_cast< const uint8_t* >( source );
+		TextureDimmensions srcSize = { width, height, 1 };
+		for ( int level = 1; level < mipLevels; level++ ) {
+			TextureDimmensions dstSize;
+			GetMipDimmensions( width, height, 1, level, dstSize );
+			uint8_t* const dest = static_cast< uint8_t* >( mips[ level - 1 ] );
+			ProcessBands( dstSize.height, params.parallel, [ & ]( const int beginRow, const int endRow ) {
+				SampleBand( src, srcSize.width, srcSize.height, dest, dstSize.width, dstSize.height, info.blockByteWidth, beginRow, endRow );
+			} );
+			src = dest;
+			srcSize = dstSize;
+		}
+		return true;
+	}
+
+	RowCodec codec;
+	codec.format = format;
+	codec.channels = info.channelsCount;
+	codec.pixelSize = info.blockByteWidth;
+	codec.srgb = params.srgb;
+	codec.normalMap = params.normalMap;
+	codec.unorm = type == ComponentType::UNORM8 || type == ComponentType::UNORM16;
+
+	FilterTaps tapsX;
+	FilterTaps tapsY;
+	std::vector< Float4 > values;
+	std::vector< Float4 > nextValues;
+	TextureDimmensions srcSize = { width, height, 1 };
+	for ( int level = 1; level < mipLevels; level++ ) {
+		TextureDimmensions dstSize;
+		GetMipDimmensions( width, height, 1, level, dstSize );
+		BuildTaps( params.filter, params.addressing, srcSize.width, dstSize.width, tapsX );
+		BuildTaps( params.filter, params.addressing, srcSize.height, dstSize.height, tapsY );
+		nextValues.resize( level + 1 < mipLevels ? static_cast< std::size_t >( dstSize.width ) * dstSize.height : 0 );
+
+		LevelJob job;
+		job.codec = &codec;
+		job.tapsX = &tapsX;
+		job.tapsY = &tapsY;
+		job.addressing = params.addressing;
+		job.srcWidth = srcSize.width;
+		job.srcHeight = srcSize.height;
+		job.dstWidth = dstSize.width;
+		job.dstHeight = dstSize.height;
+		job.source = level == 1 ? static_cast< const uint8_t* >( source ) : nullptr;
+		job.sourceValues = values.data();
+		job.dest = static_cast< uint8_t* >( mips[ level - 1 ] );
+		job.destValues = nextValues.empty() ? nullptr : nextValues.data();
+		ProcessBands( dstSize.height, params.parallel, [ & ]( const int beginRow, const int endRow ) {
+			FilterBand( job, beginRow, endRow );
+		} );
+		values.swap( nextValues );
+		srcSize = dstSize;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "RenderInterface.h"
+
+namespace RenderInterface {
+
+	/*
+	Filtr pro zmenseni mip urovne
+	*/
+	enum class MipFilter {
+		BOX,		// prumer pokryte plochy (2x2 pixelu pro sudy rozmer), nejrychlejsi
+		KAISER,		// sinc s Kaiserovym oknem, polomer 3 pixely zmensene urovne
+		LANCZOS		// Lanczos3, nejostrejsi, na kontrastnich hranach mirne prekmity
+	};
+
+	/*
+	Parametry funkce GenerateMips()
+	*/
+	struct MipGeneratorParams {
+		MipFilter filter;
+		TextureAddressing addressing;	// hodnoty za okrajem textury (WRAP pro opakovane textury)
+		bool srgb;						// jen R8G8B8A8_UNORM: barvy v sRGB (textura R8G8B8A8_UNORM_SRGB), filtruje se linearne
+		bool normalMap;					// kanaly xyz jsou normala (dvoukanalove formaty: xy, z = sqrt( 1 - x^2 - y^2 ))
+		bool parallel;					// rozdelit radky mezi vlakna ParallelFor
+	};
+
+	// pocet mip urovni kompletniho retezce (posledni uroven ma rozmery 1x1)
+	int GetMipLevelsCount( const int width, const int height ) noexcept;
+
+	// velikost dat mip urovne v bajtech, radky jsou ulozeny bez mezer (rowPitch = pointPitch * sirka, viz FormatInfo)
+	int GetMipDataSize( const Format format, const int width, const int height, const int mipLevel ) noexcept;
+
+	/*
+	Vytvori mip urovne 1 az mipLevels - 1 2D textury z urovne 0 (source).
+	mips[ i ] je buffer urovne i + 1 o velikosti GetMipDataSize( format, width, height, i + 1 ),
+	TextureBufferParams::data pak obsahuje source a pole mips.
+	Kazda uroven vznika filtrovanim predchozi urovne ve float (oddelitelny filtr, 4 kanaly v jednom vektoru),
+	normalizovane formaty jsou zaokrouhleny k nejblizsi hodnote. UNORM normaly jsou prevedeny do rozsahu < -1; 1 >,
+	po filtrovani jsou normalizovany (nulova normala je ( 0, 0, 1 )).
+	Celociselne formaty a DEPTH_24_UNORM_STENCIL_8_UINT nelze prumerovat, uroven se vytvori bodovym vzorkovanim.
+	Docasna pamet: float data urovne 1 (16 bajtu na pixel, pro texturu 8192x8192 256 MB).
+	Vraci false pro BC formaty, neplatne rozmery nebo kombinace parametru.
+	*/
+	bool GenerateMips( const Format format, const int width, const int height, const int mipLevels, const void* const source, void* const* const mips, const MipGeneratorParams& params );
+}
\ No newline at end of file
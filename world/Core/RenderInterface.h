@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include "Graphicsinfrastructure.h"
 #include "Framework/Math.h"
 #include "Framework/Color.h"
+#include "Framework/HandlePool.h"
 
 // forward declarations
 class Window;
@@ -48,6 +50,13 @@ namespace RenderInterface {
 	using PVertexLayout			= std::shared_ptr< VertexLayout >;
 	using PVertexStream			= std::shared_ptr< VertexStream >;
 
+	// device object handles (viz Device::RegisterBlendState...)
+	using BlendStateHandle			= Handle< BlendState >;
+	using RasterizerStateHandle		= Handle< RasterizerState >;
+	using DepthStencilStateHandle	= Handle< DepthStencilState >;
+	using RenderProgramHandle		= Handle< RenderProgram >;
+	using VertexStreamHandle		= Handle< VertexStream >;
+
 	// Maximalni kvalita multisamplingu
 	const int MAX_MULTISAMPLE_QUALITY = -1;
 
@@ -138,7 +147,51 @@ namespace RenderInterface {
 		int blockByteWidth;		// pocet bytes na blok
 	};
 	
-	const FormatInfo GetFormatInfo( const Format format );
+	// vyhodnotitelne pri prekladu (kontrola usporadani vertexu)
+	constexpr FormatInfo GetFormatInfo( const Format format ) {
+		switch ( format ) {									//channels	chan.bytes	blockSize	blockBytes
+		case Format::UNKNOWN:						return { 0,			0,			1,			0 };
+		case Format::R32G32B32A32_FLOAT:			return { 4,			4,			1,			16 };
+		case Format::R32G32B32A32_UINT:				return { 4,			4,			1,			16 };
+		case Format::R32G32B32_FLOAT:				return { 3,			4,			1,			12 };
+		case Format::R32G32B32_UINT:				return { 3,			4,			1,			12 };
+		case Format::R32G32_FLOAT:					return { 2,			4,			1,			8 };
+		case Format::R32G32_UINT:					return { 2,			4,			1,			8 };
+		case Format::R32_FLOAT:						return { 1,			4,			1,			4 };
+		case Format::R32_UINT:						return { 1,			4,			1,			4 };
+		case Format::R16G16B16A16_FLOAT:			return { 4,			2,			1,			8 };
+		case Format::R16G16B16A16_UINT:				return { 4,			2,			1,			8 };
+		case Format::R16G16B16A16_UNORM:			return { 4,			2,			1,			8 };
+		case Format::R16G16B16A16_SINT:				return { 4,			2,			1,			8 };
+		case Format::R16G16B16A16_SNORM:			return { 4,			2,			1,			8 };
+		case Format::R16G16_FLOAT:					return { 2,			2,			1,			4 };
+		case Format::R16G16_UINT:					return { 2,			2,			1,			4 };
+		case Format::R16G16_UNORM:					return { 2,			2,			1,			4 };
+		case Format::R16G16_SINT:					return { 2,			2,			1,			4 };
+		case Format::R16G16_SNORM:					return { 2,			2,			1,			4 };
+		case Format::R16_FLOAT:						return { 1,			2,			1,			2 };
+		case Format::R16_UINT:						return { 1,			2,			1,			2 };
+		case Format::R16_UNORM:						return { 1,			2,			1,			2 };
+		case Format::R16_SINT:						return { 1,			2,			1,			2 };
+		case Format::R16_SNORM:						return { 1,			2,			1,			2 };
+		case Format::R8G8B8A8_UINT:					return { 4,			1,			1,			4 };
+		case Format::R8G8B8A8_UNORM:				return { 4,			1,			1,			4 };
+		case Format::R8G8B8A8_SINT:					return { 4,			1,			1,			4 };
+		case Format::R8G8B8A8_SNORM:				return { 4,			1,			1,			4 };
+		case Format::R8G8_UINT:						return { 2,			1,			1,			2 };
+		case Format::R8G8_UNORM:					return { 2,			1,			1,			2 };
+		case Format::R8G8_SINT:						return { 2,			1,			1,			2 };
+		case Format::R8G8_SNORM:					return { 2,			1,			1,			2 };
+		case Format::R8_UINT:						return { 1,			1,			1,			1 };
+		case Format::R8_UNORM:						return { 1,			1,			1,			1 };
+		case Format::R8_SINT:						return { 1,			1,			1,			1 };
+		case Format::R8_SNORM:						return { 1,			1,			1,			1 };
+		case Format::DEPTH_24_UNORM_STENCIL_8_UINT:	return { 1,			4,			1,			4 };
+		case Format::BC1:							return { 0,			0,			4,			8 };
+		case Format::BC3:							return { 0,			0,			4,			16 };
+		}
+		return { 0, 0, 1, 0 };
+	}
 
 	/*
 	Zpusob pristupu do bufferu
@@ -390,6 +443,42 @@ namespace RenderInterface {
 		int instanceCount;		// pocet instanci se stejnym atributem (0 pro per vertex attribute; >0 pro per instance attribute)
 	};
 
+	/*
+	Kontrola usporadani vertexu pri prekladu (static_assert).
+	IsVertexAttributeAt(): atribut lezi na offsetu clenu struktury vertexu a velikost formatu odpovida velikosti clenu,
+	napr. IsVertexAttributeAt( attributes[ 1 ], offsetof( Vertex, color ), sizeof( Vertex::color ) ).
+	IsVertexLayoutValid(): atributy slotu slot lezi uvnitr vertexu velikosti vertexSize, neprekryvaji se
+	a jsou zarovnany na velikost atributu (nejvyse na 4 bajty).
+	*/
+	constexpr int GetVertexAttributeSize( const VertexAttribute& attribute ) {
+		return GetFormatInfo( attribute.format ).blockByteWidth * attribute.elementsCount;
+	}
+
+	constexpr bool IsVertexAttributeAt( const VertexAttribute& attribute, const std::size_t offset, const std::size_t size ) {
+		return attribute.offset == static_cast< int >( offset ) && GetVertexAttributeSize( attribute ) == static_cast< int >( size );
+	}
+
+	template < std::size_t N >
+	constexpr bool IsVertexLayoutValid( const VertexAttribute ( &attributes )[ N ], const std::size_t vertexSize, const int slot = 0 ) {
+		for ( std::size_t i = 0; i < N; i++ ) {
+			if ( attributes[ i ].slot != slot ) {
+				continue;
+			}
+			const int begin = attributes[ i ].offset;
+			const int size = GetVertexAttributeSize( attributes[ i ] );
+			const int alignment = size < 4 ? size : 4;
+			if ( begin < 0 || size <= 0 || begin % alignment != 0 || begin + size > static_cast< int >( vertexSize ) ) {
+				return false;
+			}
+			for ( std::size_t j = 0; j < i; j++ ) {
+				if ( attributes[ j ].slot == slot && begin < attributes[ j ].offset + GetVertexAttributeSize( attributes[ j ] ) && attributes[ j ].offset < begin + size ) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
 	struct VertexStreamParams {
 		const PVertexLayout vertexLayout;
 		const PBuffer vertexBuffers[ MAX_VERTEX_INPUT_SLOTS ];
@@ -539,7 +628,7 @@ namespace RenderInterface {
 	class DeviceObject {
 	public:
 		DeviceObject() = default;
-		virtual ~DeviceObject() = 0 {};
+		virtual ~DeviceObject() = 0;
 		
 		// Neni mozne vytvaret kopie device objektu
 		DeviceObject( const DeviceObject& ) = delete;
@@ -580,6 +669,24 @@ namespace RenderInterface {
 		virtual PRasterizerState CreateRasterizerState( const RasterizerStateParams& params ) noexcept = 0;
 		virtual PDepthStencilState CreateDepthStencilState( const DepthStencilStateParams& params ) noexcept = 0;
 
+		/*
+		Handle API: objekt je zaregistrovan do tabulky zarizeni (slot map) a CommandInterface ho nastavuje pomoci 32 bit handle,
+		bez pocitani referenci shared_ptr a bez down_cast. Tabulka drzi vlastni reference na objekty API (napr. ID3D11BlendState),
+		shared_ptr muze byt po registraci uvolnen. Handle je platny do volani odpovidajici funkce Release*().
+		Pokud registrace selze, vraci neplatny handle (IsNull()).
+		*/
+		virtual BlendStateHandle RegisterBlendState( const PBlendState& state ) noexcept = 0;
+		virtual RasterizerStateHandle RegisterRasterizerState( const PRasterizerState& state ) noexcept = 0;
+		virtual DepthStencilStateHandle RegisterDepthStencilState( const PDepthStencilState& state ) noexcept = 0;
+		virtual RenderProgramHandle RegisterRenderProgram( const PRenderProgram& program ) noexcept = 0;
+		virtual VertexStreamHandle RegisterVertexStream( const PVertexStream& stream ) noexcept = 0;
+
+		virtual void ReleaseBlendState( const BlendStateHandle state ) noexcept = 0;
+		virtual void ReleaseRasterizerState( const RasterizerStateHandle state ) noexcept = 0;
+		virtual void ReleaseDepthStencilState( const DepthStencilStateHandle state ) noexcept = 0;
+		virtual void ReleaseRenderProgram( const RenderProgramHandle program ) noexcept = 0;
+		virtual void ReleaseVertexStream( const VertexStreamHandle stream ) noexcept = 0;
+
 		/*
 		Vrati max quality pro pozadovany pocet samplu.
 		Pokud neni hodnota samplesCount podporovana, vraci 0.
@@ -659,10 +766,10 @@ namespace RenderInterface {
 		// Binduje konstant buffery do odpovidajicich slotu. Pokud je parametr descriptors nullptr, jsou vsechny buffery odpojeny.
 		virtual void SetConstantBuffers( const PConstantBufferView* const views, const int count ) noexcept = 0;
 
-		// Nastavi vertex buffer, index buffer a input layout (podobne jako OpenGL VAO)
+		// Nastavi vertex buffer, index buffer a input layout (podobne jako OpenGL VAO), nullptr je odpoji.
 		virtual void SetVertexStream( const PVertexStream& stream ) noexcept = 0;
 
-		// nastavi render program (vertex shader, pixel shader a geometry shader)
+		// nastavi render program (vertex shader, pixel shader a geometry shader), nullptr shadery odpoji
 		virtual void SetRenderProgram( const PRenderProgram& program ) noexcept = 0;
 
 		virtual void SetPrimitiveTopology( const PrimitiveTopology topology ) noexcept = 0;
@@ -676,6 +783,18 @@ namespace RenderInterface {
 		// Pokud je parametr state nullptr, pouzije se vychozi state.
 		virtual void SetRasterizerState( const PRasterizerState& state ) noexcept = 0;
 
+		/*
+		Varianty pro objekty zaregistrovane v Device (handle API), handle musi patrit zarizeni predanemu funkci Begin().
+		Neplatny handle (IsNull()) state objektu nastavi vychozi state, neplatny handle programu a vertex streamu je odpoji
+		(stejne jako nullptr). Platnost handle se kontroluje pouze v debug buildu, handle uvolneneho objektu
+		v release buildu objekt odpoji (dokud neni slot znovu pouzit).
+		*/
+		virtual void SetVertexStream( const VertexStreamHandle stream ) noexcept = 0;
+		virtual void SetRenderProgram( const RenderProgramHandle program ) noexcept = 0;
+		virtual void SetBlendState( const BlendStateHandle state ) noexcept = 0;
+		virtual void SetDepthStencilState( const DepthStencilStateHandle state, const uint32_t stencilRef ) noexcept = 0;
+		virtual void SetRasterizerState( const RasterizerStateHandle state ) noexcept = 0;
+
 		// Nastavi viewporty.
 		virtual void SetViewports( const Viewport* const viewports[], const int count ) noexcept = 0;
 
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include "Framework/Core.h"
 #include "Platform/Window.h"
 #include "Platform/File.h"
@@ -34,6 +35,16 @@ enum {
 RenderInterface::Sampler *samplers[ SAMPLERS_COUNT ];
 */
 
+// vertex layouty, usporadani atributu odpovida strukturam vertexu (Renderer.h)
+constexpr RenderInterface::VertexAttribute COLOR_LINE_ATTRIBUTES[] = {
+	{ "position",	"POSITION", 0, RenderInterface::Format::R32G32B32_FLOAT,	offsetof( VertexColorLine, position ),	1, 0, 0 },
+	{ "color",		"COLOR",	0, RenderInterface::Format::R8G8B8A8_UNORM,		offsetof( VertexColorLine, color ),		1, 0, 0 }
+};
+static_assert( RenderInterface::IsVertexLayoutValid( COLOR_LINE_ATTRIBUTES, sizeof( VertexColorLine ) ), "VertexColorLine layout mismatch" );
+static_assert( RenderInterface::IsVertexAttributeAt( COLOR_LINE_ATTRIBUTES[ 0 ], offsetof( VertexColorLine, position ), sizeof( VertexColorLine::position ) ), "VertexColorLine::position mismatch" );
+static_assert( RenderInterface::IsVertexAttributeAt( COLOR_LINE_ATTRIBUTES[ 1 ], offsetof( VertexColorLine, color ), sizeof( VertexColorLine::color ) ), "VertexColorLine::color mismatch" );
+static_assert( sizeof( VertexColorLine ) == 16, "VertexColorLine must be packed" );
+
 // Renderer::RenderBuffer
 
 bool Renderer::RenderBuffer::Create(
@@ -341,14 +352,16 @@ bool Renderer::CreateDepthStencilStates() {
 }
 
 RenderInterface::PShader LoadShaderFromFile( std::shared_ptr< RenderInterface::Device > device, const String& path, const RenderInterface::ShaderType type ) {
-	// nacist soubor
-	auto source = LoadCharFile( path );
-	if ( !source ) {
+	// nacist soubor, zdrojovy kod je potreba jen behem kompilace
+	StackAllocator& allocator = GetThreadStackAllocator();
+	ScopedStackMarker marker( allocator );
+	const char* const source = LoadCharFile( path, allocator );
+	if ( source == nullptr ) {
 		return nullptr;
 	}
 	// parametry kompilace
 	RenderInterface::ShaderParams params;
-	params.string	= source.get();
+	params.string	= source;
 	params.defines	= nullptr;
 	params.type		= type;
 	params.version	= RenderInterface::ShaderVersion::HLSL_50_GLSL_430;
@@ -505,11 +518,7 @@ bool Renderer::CreateVertexLayouts() {
 	std::vector< RenderInterface::PVertexLayout > layouts( LAYOUT_COUNT );
 	/*
 	// VertexColorLine
-	const RenderInterface::VertexAttribute colorLineAttribs[] = {
-		{ "position",	"POSITION", 0, RenderInterface::Format::R32G32B32_FLOAT,	0,	1, 0, 0 },
-		{ "color",		"COLOR",	0, RenderInterface::Format::R32G32B32A32_FLOAT, 12,	1, 0, 0 }
-	};
-	layouts[ LAYOUT_COLORLINE ] = device->CreateVertexLayout( colorLineAttribs, sizeof( colorLineAttribs ) / sizeof( *colorLineAttribs ), GetRenderProgram( RENDER_PROGRAM_COLOR_LINE ) );
+	layouts[ LAYOUT_COLORLINE ] = device->CreateVertexLayout( COLOR_LINE_ATTRIBUTES, sizeof( COLOR_LINE_ATTRIBUTES ) / sizeof( *COLOR_LINE_ATTRIBUTES ), GetRenderProgram( RENDER_PROGRAM_COLOR_LINE ) );
 	if ( !layouts[ LAYOUT_COLORLINE ] ) {
 		return false;
 	}
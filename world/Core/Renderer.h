@@ -47,9 +47,11 @@ struct RendererAttributes {
 Formaty vertexu
 */
 
+// typy pro ukladani bez zarovnani (Types.h), usporadani odpovida atributum vertex layoutu (kontrolovano v Renderer.cpp)
+
 struct VertexColorLine {
-	Float3 position;	// float4: POSITION0
-	Float4 color;		// float4: COLOR0
+	PackedFloat3 position;	// float4: POSITION0 (R32G32B32_FLOAT, w = 1)
+	UNorm4x8 color;			// float4: COLOR0 (R8G8B8A8_UNORM)
 };
 
 /*
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 /*
 COM smart pointer.
 */
@@ -18,11 +20,11 @@ public:
 		ptr = cp.GetRef();
 	}
 	
+	// prida referenci (novy ComPtr jeste nic nedrzi, nesmi volat Release())
 	explicit ComPtr( T* const ptr ) {
 		if ( ptr != nullptr ) {
 			ptr->AddRef();
 		}
-		Release();
 		this->ptr = ptr;
 	}
 
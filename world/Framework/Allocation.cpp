@@ -1,18 +1,31 @@
+#include <cstring>
+#include <thread>
 #include "Allocation.h"
+#include "AllocationTrace.h"
 #include "String.h"
+#include "Math.h"
 #include "Platform/Application.h"
 
-// 16 byte aligned heap allocations
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+#ifdef _LINUX
+#include <sys/mman.h>
+#endif
+
+// aligned heap allocations, alignment je mocnina 2 a nejmene 16
 
 // windows allocation
 #ifdef _WIN32
-#define ALLOC_16
+#define ALLOC_ALIGNED
 
-inline void* alloc_16( const std::size_t size ) {
-	return _aligned_malloc( size, 16 );
+inline void* alloc_aligned( const std::size_t size, const std::size_t alignment ) {
+	return _aligned_malloc( size, alignment );
 }
 
-inline void free_16( void* const ptr ) {
+inline void free_aligned( void* const ptr ) {
 	_aligned_free( ptr );
 }
 
@@ -20,33 +33,35 @@ inline void free_16( void* const ptr ) {
 
 // linux allocation
 #ifdef _LINUX
-#define ALLOC_16
+#define ALLOC_ALIGNED
 
-inline void* alloc_16( const std::size_t size ) {
+inline void* alloc_aligned( const std::size_t size, const std::size_t alignment ) {
 	void* storage = nullptr;
-	posix_memalign( &storage, 16, size );
+	if ( posix_memalign( &storage, alignment, size ) != 0 ) {
+		return nullptr;
+	}
 	return storage;
 }
 
-inline void free_16( void* const ptr ) {
+inline void free_aligned( void* const ptr ) {
 	free( ptr );
 }
 
 #endif // _LINUX
 
 // custom allocation
-#ifndef ALLOC_16
-#define ALLOC_16
+#ifndef ALLOC_ALIGNED
+#define ALLOC_ALIGNED
 
-inline void* alloc_16( const std::size_t size ) {
-	// storage = [ offset 0-15 bytes ][ void *storage ][ aligned returned storage ][ 15 minus offset bytes ]
-	void* storage = malloc( size + sizeof( void* ) + 15 );
+inline void* alloc_aligned( const std::size_t size, const std::size_t alignment ) {
+	// storage = [ offset 0 - (alignment - 1) bytes ][ void *storage ][ aligned returned storage ][ alignment - 1 minus offset bytes ]
+	void* storage = malloc( size + sizeof( void* ) + alignment - 1 );
 	if ( storage == nullptr ) {
 		return nullptr;
 	}
 	// vypocitat zacatek aligned bloku
 	char* aligned = reinterpret_cast< char* >( storage ) + sizeof( void* );
-	aligned += ( 16 - ( reinterpret_cast< std::size_t >( aligned ) % 16 ) ) & 0x0f;
+	aligned += ( alignment - ( reinterpret_cast< std::size_t >( aligned ) % alignment ) ) % alignment;
 	
 	// vlozit pred aligned blok ukazatel na storage (pro potreby operator delete)
 	*reinterpret_cast< void** >( aligned - sizeof( char* ) ) = storage;
@@ -54,160 +69,1894 @@ inline void* alloc_16( const std::size_t size ) {
 	return aligned;
 }
 
-inline void free_16( void * const ptr ) {
+inline void free_aligned( void * const ptr ) {
 	char* storage = reinterpret_cast< char* >( ptr ) - sizeof( char* );
 	free( *reinterpret_cast< char** >( storage ) );
 }
 
-#endif // ALLOC_16
+#endif // ALLOC_ALIGNED
 
-inline void* Alloc( const std::size_t size ) {
+// Alokace systemove pameti (alloc_aligned), pri nedostatku pameti vola new handler
+inline void* AllocSystem( const std::size_t size, const std::size_t alignment = 16 ) {
 	std::size_t bytes = size;
 	if ( bytes == 0 ) {
 		bytes = 1;
 	}
-	void* storage = alloc_16( bytes );
+	void* storage = alloc_aligned( bytes, alignment );
 	while ( storage == nullptr ) {
 		std::new_handler handler = std::get_new_handler();
 		if ( handler == nullptr ) {
 			return nullptr;
 		}
 		handler();
-		storage = alloc_16( bytes );
+		storage = alloc_aligned( bytes, alignment );
 	}
 	return storage;
 }
 
+inline void FreeSystem( void* const ptr ) {
+	if ( ptr != nullptr ) {
+		free_aligned( ptr );
+	}
+}
+
+/*
+Global operator new
+
+Alokace do SMALL_ALLOCATION_MAX_SIZE bajtu jsou obslouzeny pooly (ThreadCachedFixedAllocator) po 16 bajtovych size class,
+kazdy tag alokaci ma vlastni sadu poolu. Bloky poolu nemaji hlavicku: chunky poolu maji velikost SIZE_CLASS_CHUNK_BYTES
+a jsou na ni zarovnany, operator delete najde pool bloku v mape chunku (index poolu pro kazdy zarovnany usek adres).
+Vetsi alokace jsou alokovany funkci alloc_aligned, pred blokem je 16 bajtova hlavicka AllocationHeader.
+Sized operator delete urci size class z velikosti, mapu chunku cte jen kvuli tagu pri sledovani alokaci.
+Male alokace se zapocitavaji velikosti size class (unsized delete pozadovanou velikost nezna).
+*/
+
+const uint16_t SIZE_CLASSES_COUNT = SMALL_ALLOCATION_MAX_SIZE / 16;
+
+// hlavicka LARGE alokace
+struct alignas( 16 ) AllocationHeader {
+	std::size_t size;		// pozadovana velikost alokace
+	uint32_t offset;		// vzdalenost hlavicky od zacatku systemove alokace
+	AllocationTag tag;		// tag vlakna v dobe alokace
+};
+
+static_assert( sizeof( AllocationHeader ) == 16, "AllocationHeader must preserve 16 byte alignment" );
+
+// velikost chunku size class poolu (mocnina 2), granularita mapy chunku
+const unsigned int SIZE_CLASS_CHUNK_SHIFT = 16;
+const std::size_t SIZE_CLASS_CHUNK_BYTES = std::size_t( 1 ) << SIZE_CLASS_CHUNK_SHIFT;
+
+// pocet sad poolu, pri sledovani alokaci ma kazdy tag (vcetne UNTRACKED) vlastni sadu
+#ifdef ALLOCATION_TRACKING
+const int HEAP_TAGS_COUNT = ALLOCATION_TAGS_COUNT + 1;
+#else
+const int HEAP_TAGS_COUNT = 1;
+#endif
+
+static_assert( HEAP_TAGS_COUNT * SIZE_CLASSES_COUNT < 256, "pool index must fit the chunk map entry" );
+
+inline uint16_t GetSizeClass( const std::size_t size ) {
+	return size == 0 ? 0 : static_cast< uint16_t >( ( size - 1 ) / 16 );
+}
+
+inline std::size_t GetSizeClassBytes( const uint16_t sizeClass ) {
+	return ( static_cast< std::size_t >( sizeClass ) + 1 ) * 16;
+}
+
+namespace {
+	
+	/*
+	Mapa chunku: pro kazdy SIZE_CLASS_CHUNK_BYTES usek adresniho prostoru index poolu + 1, 0 pro pamet mimo pooly.
+	Dvouurovnova tabulka pokryva 48 bitovy adresni prostor, usek druhe urovne (4 GB adres) se alokuje pri prvnim chunku v nem.
+	Zaznam se zapise pred predanim prvniho bloku chunku, vlakno uvolnujici blok ho tedy vzdy vidi.
+	*/
+	const unsigned int CHUNK_MAP_BITS = 16;
+	const std::size_t CHUNK_MAP_SIZE = std::size_t( 1 ) << CHUNK_MAP_BITS;
+	
+	std::atomic< uint8_t* > chunkMap[ CHUNK_MAP_SIZE ];
+	
+	inline std::size_t GetChunkMapRoot( const void* const ptr ) {
+		return static_cast< std::size_t >( ( static_cast< uint64_t >( reinterpret_cast< std::uintptr_t >( ptr ) ) >> ( SIZE_CLASS_CHUNK_SHIFT + CHUNK_MAP_BITS ) ) & ( CHUNK_MAP_SIZE - 1 ) );
+	}
+	
+	inline std::size_t GetChunkMapLeaf( const void* const ptr ) {
+		return static_cast< std::size_t >( ( reinterpret_cast< std::uintptr_t >( ptr ) >> SIZE_CLASS_CHUNK_SHIFT ) & ( CHUNK_MAP_SIZE - 1 ) );
+	}
+	
+	// vrati index poolu + 1 pro blok ptr, 0 pokud blok nepatri zadnemu poolu
+	inline uint8_t GetChunkPool( const void* const ptr ) {
+		const uint8_t* const leaf = chunkMap[ GetChunkMapRoot( ptr ) ].load( std::memory_order_acquire );
+		return leaf == nullptr ? 0 : leaf[ GetChunkMapLeaf( ptr ) ];
+	}
+	
+	// zapise zaznam chunku, vraci false pokud nelze alokovat usek mapy
+	bool SetChunkPool( const void* const chunk, const uint8_t value ) {
+		std::atomic< uint8_t* >& root = chunkMap[ GetChunkMapRoot( chunk ) ];
+		uint8_t* leaf = root.load( std::memory_order_acquire );
+		if ( leaf == nullptr ) {
+			// usek mapy neni alokovan operatorem new, funkci vola jeho implementace
+			uint8_t* const created = static_cast< uint8_t* >( AllocSystem( CHUNK_MAP_SIZE ) );
+			if ( created == nullptr ) {
+				return false;
+			}
+			std::memset( created, 0, CHUNK_MAP_SIZE );
+			if ( root.compare_exchange_strong( leaf, created, std::memory_order_acq_rel, std::memory_order_acquire ) ) {
+				leaf = created;
+			} else {
+				FreeSystem( created );
+			}
+		}
+		leaf[ GetChunkMapLeaf( chunk ) ] = value;
+		return true;
+	}
+	
+	// provider chunku jednoho poolu, chunky alokuje GetHeapChunkProvider() a zapisuje je do mapy chunku
+	class SizeClassChunkProvider: public ChunkProvider {
+	public:
+		explicit SizeClassChunkProvider( const uint8_t poolParam ): pool( poolParam ) {}
+		
+		virtual void* AllocChunk( const std::size_t bytes, const std::size_t alignment ) override {
+			void* const chunk = GetHeapChunkProvider()->AllocChunk( bytes, alignment );
+			if ( chunk != nullptr && !SetChunkPool( chunk, pool + 1 ) ) {
+				GetHeapChunkProvider()->FreeChunk( chunk, bytes );
+				return nullptr;
+			}
+			return chunk;
+		}
+		
+		virtual void FreeChunk( void* const chunk, const std::size_t bytes ) override {
+			SetChunkPool( chunk, 0 );
+			GetHeapChunkProvider()->FreeChunk( chunk, bytes );
+		}
+		
+		virtual std::size_t GetGranularity() const override {
+			return SIZE_CLASS_CHUNK_BYTES;
+		}
+		
+	private:
+		const uint8_t pool;
+	};
+	
+	struct HeapPool {
+		SizeClassChunkProvider provider;
+		ThreadCachedFixedAllocator allocator;
+		
+		explicit HeapPool( const uint8_t index ):
+			provider( index ),
+			// jeden blok a hlavicka se vejdou do granularity providera, chunk ma tedy presne SIZE_CLASS_CHUNK_BYTES
+			allocator( static_cast< unsigned long >( GetSizeClassBytes( index % SIZE_CLASSES_COUNT ) ), 1, &provider )
+		{
+			// alokace zapocitava operator new
+			allocator.SetTag( AllocationTag::UNTRACKED );
+		}
+	};
+	
+	/*
+	Sady poolu jsou vytvoreny pri prvni alokaci s danym tagem (muze probehnout pred inicializaci statickych objektu)
+	a nejsou nikdy zniceny, protoze operator delete muze byt volan i behem destrukce statickych objektu.
+	Zamek nemuze byt std::mutex ze stejneho duvodu.
+	*/
+	std::atomic< HeapPool* > heapPools[ HEAP_TAGS_COUNT ];
+	std::atomic_flag heapPoolsLock = ATOMIC_FLAG_INIT;
+	alignas( HeapPool ) Byte heapPoolsStorage[ HEAP_TAGS_COUNT ][ SIZE_CLASSES_COUNT * sizeof( HeapPool ) ];
+	
+	HeapPool* CreateHeapPools( const int tagIndex ) {
+		while ( heapPoolsLock.test_and_set( std::memory_order_acquire ) ) {
+			std::this_thread::yield();
+		}
+		HeapPool* pools = heapPools[ tagIndex ].load( std::memory_order_relaxed );
+		if ( pools == nullptr ) {
+			pools = reinterpret_cast< HeapPool* >( heapPoolsStorage[ tagIndex ] );
+			for ( uint16_t i = 0; i < SIZE_CLASSES_COUNT; i++ ) {
+				new ( pools + i ) HeapPool( static_cast< uint8_t >( tagIndex * SIZE_CLASSES_COUNT + i ) );
+			}
+			heapPools[ tagIndex ].store( pools, std::memory_order_release );
+		}
+		heapPoolsLock.clear( std::memory_order_release );
+		return pools;
+	}
+	
+	// index sady poolu pro tag
+	inline int GetHeapTagIndex( const AllocationTag tag ) {
+#ifdef ALLOCATION_TRACKING
+		return static_cast< int >( tag );
+#else
+		static_cast< void >( tag );
+		return 0;
+#endif
+	}
+	
+	inline HeapPool& GetHeapPool( const int tagIndex, const uint16_t sizeClass ) {
+		HeapPool* pools = heapPools[ tagIndex ].load( std::memory_order_acquire );
+		if ( pools == nullptr ) {
+			pools = CreateHeapPools( tagIndex );
+		}
+		return pools[ sizeClass ];
+	}
+	
+	// pool podle indexu z mapy chunku, sada poolu uz existuje
+	inline HeapPool& GetHeapPool( const uint8_t index ) {
+		return heapPools[ index / SIZE_CLASSES_COUNT ].load( std::memory_order_acquire )[ index % SIZE_CLASSES_COUNT ];
+	}
+}
+
+inline void* AllocLarge( const std::size_t size ) {
+	AllocationHeader* const header = static_cast< AllocationHeader* >( AllocSystem( sizeof( AllocationHeader ) + size ) );
+	if ( header == nullptr ) {
+		return nullptr;
+	}
+	header->offset = 0;
+	return header + 1;
+}
+
+// doplni hlavicku LARGE alokace a zapocita alokaci do statistik
+inline void* TrackLarge( void* const ptr, const std::size_t size ) {
+	if ( ptr == nullptr ) {
+		return nullptr;
+	}
+	AllocationHeader* const header = static_cast< AllocationHeader* >( ptr ) - 1;
+	header->size = size;
+	header->tag = GetAllocationTag();
+	TrackAllocation( header->tag, size );
+	if ( IsAllocationTraceActive() ) {
+		TraceAllocation( ptr, size, header->tag );
+	}
+	return ptr;
+}
+
+inline void* AllocSmall( const std::size_t size ) {
+	const AllocationTag tag = GetAllocationTag();
+	const uint16_t sizeClass = GetSizeClass( size );
+	ThreadCachedFixedAllocator& pool = GetHeapPool( GetHeapTagIndex( tag ), sizeClass ).allocator;
+	void* block = pool.Alloc();
+	while ( block == nullptr ) {
+		std::new_handler handler = std::get_new_handler();
+		if ( handler == nullptr ) {
+			return nullptr;
+		}
+		handler();
+		block = pool.Alloc();
+	}
+	TrackAllocation( tag, GetSizeClassBytes( sizeClass ) );
+	if ( IsAllocationTraceActive() ) {
+		TraceAllocation( block, size, tag );
+	}
+	return block;
+}
+
+inline void* AllocHeap( const std::size_t size ) {
+	if ( size > SMALL_ALLOCATION_MAX_SIZE ) {
+		return TrackLarge( AllocLarge( size ), size );
+	}
+	return AllocSmall( size );
+}
+
+// uvolni blok poolu index (index poolu z mapy chunku)
+inline void FreeSmall( void* const ptr, const uint8_t index ) {
+#ifdef ALLOCATION_TRACKING
+	const std::size_t bytes = GetSizeClassBytes( index % SIZE_CLASSES_COUNT );
+	const AllocationTag tag = static_cast< AllocationTag >( index / SIZE_CLASSES_COUNT );
+	TrackFree( tag, bytes );
+	if ( IsAllocationTraceActive() ) {
+		TraceFree( ptr, bytes, tag );
+	}
+#endif
+	GetHeapPool( index ).allocator.Free( ptr );
+}
+
+inline void FreeLarge( void* const ptr ) {
+	AllocationHeader* const header = static_cast< AllocationHeader* >( ptr ) - 1;
+	TrackFree( header->tag, header->size );
+	if ( IsAllocationTraceActive() ) {
+		TraceFree( ptr, header->size, header->tag );
+	}
+	FreeSystem( reinterpret_cast< Byte* >( header ) - header->offset );
+}
+
+inline void FreeHeap( void* const ptr ) {
+	if ( ptr == nullptr ) {
+		return;
+	}
+	const uint8_t pool = GetChunkPool( ptr );
+	if ( pool != 0 ) {
+		FreeSmall( ptr, pool - 1 );
+		return;
+	}
+	FreeLarge( ptr );
+}
+
+// velikost bloku je znama, mapa chunku se cte jen pri sledovani alokaci (tag poolu)
+inline void FreeHeap( void* const ptr, const std::size_t size ) {
+	if ( ptr == nullptr ) {
+		return;
+	}
+	if ( size > SMALL_ALLOCATION_MAX_SIZE ) {
+		FreeLarge( ptr );
+		return;
+	}
+#ifdef ALLOCATION_TRACKING
+	FreeSmall( ptr, GetChunkPool( ptr ) - 1 );
+#else
+	FreeSmall( ptr, static_cast< uint8_t >( GetSizeClass( size ) ) );
+#endif
+}
+
 void* operator new( std::size_t size ) {
-	return Alloc( size );
+	return AllocHeap( size );
 }
 
 void* operator new[]( std::size_t size ) {
-	return Alloc( size );
+	return AllocHeap( size );
 }
 
 void operator delete( void* ptr ) noexcept {
-	if ( ptr != nullptr ) {
-		free_16( ptr );
-	}
+	FreeHeap( ptr );
 }
 
 void operator delete[]( void* ptr ) noexcept {
-	if ( ptr != nullptr ) {
-		free_16( ptr );
-	}
+	FreeHeap( ptr );
 }
 
-// FixedAllocator
+void operator delete( void* ptr, std::size_t size ) noexcept {
+	FreeHeap( ptr, size );
+}
 
-FixedAllocator::FixedAllocator( const unsigned long blockSizeParam, const unsigned long chunkSizeParam ):
-	chunks( nullptr ),
-	free( nullptr ),
-	size( ( blockSizeParam + 15 ) & ( ~0x0f ) ), // 16 byte alignment
-	chunkSize( chunkSizeParam ),
-	allocated( 0 )
-{}
+void operator delete[]( void* ptr, std::size_t size ) noexcept {
+	FreeHeap( ptr, size );
+}
 
-FixedAllocator::~FixedAllocator() {
-	// Chyba, je alokovana nejaka pamet!
-	if ( allocated > 0 ) {
-		Application::Abort( String( u"FixedAllocator destruction failed, there is still allocated memory!" ) );
+std::size_t GetSmallAllocationsMemoryOccupied() {
+	std::size_t bytes = 0;
+	for ( int tag = 0; tag < HEAP_TAGS_COUNT; tag++ ) {
+		const HeapPool* const pools = heapPools[ tag ].load( std::memory_order_acquire );
+		if ( pools == nullptr ) {
+			continue;
+		}
+		for ( uint16_t i = 0; i < SIZE_CLASSES_COUNT; i++ ) {
+			bytes += pools[ i ].allocator.MemoryOccupied();
+		}
 	}
-	Chunk* chunk = chunks;
-	while ( chunk != nullptr ) {
-		Chunk* next = chunk->next;
-		delete [] chunk;
-		chunk = next;
+	return bytes;
+}
+
+#ifdef __cpp_aligned_new
+
+// alokace se zarovnanim vetsim nez 16 bajtu jsou vzdy LARGE alokace s hlavickou
+inline void* AllocHeapAligned( const std::size_t size, const std::align_val_t alignment ) {
+	const std::size_t align = static_cast< std::size_t >( alignment );
+	if ( align <= 16 ) {
+		return AllocHeap( size );
+	}
+	Byte* const storage = static_cast< Byte* >( AllocSystem( sizeof( AllocationHeader ) + size + align ) );
+	if ( storage == nullptr ) {
+		return nullptr;
 	}
+	const std::size_t address = reinterpret_cast< std::size_t >( storage + sizeof( AllocationHeader ) );
+	Byte* const aligned = storage + sizeof( AllocationHeader ) + ( ( align - ( address % align ) ) % align );
+	AllocationHeader* const header = reinterpret_cast< AllocationHeader* >( aligned ) - 1;
+	header->offset = static_cast< uint32_t >( reinterpret_cast< Byte* >( header ) - storage );
+	return TrackLarge( aligned, size );
 }
 
-void FixedAllocator::Reserve( const unsigned long bytes ) {
-	Expand( ( bytes / size ) + 1 );
+void* operator new( std::size_t size, std::align_val_t alignment ) {
+	return AllocHeapAligned( size, alignment );
 }
 
-void FixedAllocator::Expand( const unsigned long count ) {
-	// alokovat pamet
-	Byte* storage = new Byte[ sizeof( Chunk ) + count * ( sizeof( Block ) + size ) ];
-	
-	// inicializovat chunk
-	Chunk* chunk = reinterpret_cast< Chunk* >( storage );
-	chunk->allocated = 0;
-	chunk->count = count;
-	
-	// vlozit novy chunk na vrchol seznamu
-	chunk->next = chunks;
-	chunks = chunk;
-	
-	// inicializovat bloky
-	unsigned long blockWidth = sizeof( Block ) + size;
-	Byte* ptr = storage + sizeof( Chunk );
-	for ( unsigned long i = 0; i < count - 1; i++ ) {
-		reinterpret_cast< Block* >( ptr )->chunk = chunk;
-		reinterpret_cast< Block* >( ptr )->next = reinterpret_cast< Block* >( ptr + blockWidth );
-		ptr += blockWidth;
+void* operator new[]( std::size_t size, std::align_val_t alignment ) {
+	return AllocHeapAligned( size, alignment );
+}
+
+void operator delete( void* ptr, std::align_val_t ) noexcept {
+	FreeHeap( ptr );
+}
+
+void operator delete[]( void* ptr, std::align_val_t ) noexcept {
+	FreeHeap( ptr );
+}
+
+void operator delete( void* ptr, std::size_t size, std::align_val_t alignment ) noexcept {
+	if ( static_cast< std::size_t >( alignment ) <= 16 ) {
+		FreeHeap( ptr, size );
+		return;
 	}
-	reinterpret_cast< Block* >( ptr )->chunk = chunk;
-	reinterpret_cast< Block* >( ptr )->next = nullptr;
-	
-	// nastavi free prvni blok
-	free = reinterpret_cast< Block* >( storage + sizeof( Chunk ) );
+	FreeHeap( ptr );
 }
 
-void* FixedAllocator::Alloc() {
-	if ( free == nullptr ) {
-		Expand( chunkSize );
+void operator delete[]( void* ptr, std::size_t size, std::align_val_t alignment ) noexcept {
+	if ( static_cast< std::size_t >( alignment ) <= 16 ) {
+		FreeHeap( ptr, size );
+		return;
+	}
+	FreeHeap( ptr );
+}
+
+#endif // __cpp_aligned_new
+
+// virtualni pamet
+
+const std::size_t VIRTUAL_PAGE_SIZE = 64 * 1024;
+const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+// rezervace rozsahu virtualni pameti bez fyzickych stranek
+#ifdef _WIN32
+#define VIRTUAL_MEMORY
+
+inline Byte* ReserveVirtual( const std::size_t bytes, const std::size_t alignment ) {
+	// VirtualAlloc zarovnava rezervace na 64 kB
+	if ( alignment <= VIRTUAL_PAGE_SIZE ) {
+		return static_cast< Byte* >( VirtualAlloc( nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS ) );
+	}
+	// vetsi zarovnani: najit volny rozsah, uvolnit ho a rezervovat jeho zarovnanou cast (jine vlakno muze adresu obsadit)
+	for ( int attempt = 0; attempt < 16; attempt++ ) {
+		Byte* const range = static_cast< Byte* >( VirtualAlloc( nullptr, bytes + alignment, MEM_RESERVE, PAGE_NOACCESS ) );
+		if ( range == nullptr ) {
+			return nullptr;
+		}
+		VirtualFree( range, 0, MEM_RELEASE );
+		Byte* const aligned = range + ( alignment - reinterpret_cast< std::size_t >( range ) % alignment ) % alignment;
+		Byte* const storage = static_cast< Byte* >( VirtualAlloc( aligned, bytes, MEM_RESERVE, PAGE_NOACCESS ) );
+		if ( storage != nullptr ) {
+			return storage;
+		}
 	}
-	// nepodarilo se volani funkce Expand()
-	if ( free == nullptr ) {
+	return nullptr;
+}
+
+inline void ReleaseVirtual( Byte* const ptr, const std::size_t ) {
+	VirtualFree( ptr, 0, MEM_RELEASE );
+}
+
+inline bool CommitVirtual( Byte* const ptr, const std::size_t bytes, const bool ) {
+	return VirtualAlloc( ptr, bytes, MEM_COMMIT, PAGE_READWRITE ) != nullptr;
+}
+
+inline void DecommitVirtual( Byte* const ptr, const std::size_t bytes ) {
+	VirtualFree( ptr, bytes, MEM_DECOMMIT );
+}
+
+#elif defined( _LINUX )
+#define VIRTUAL_MEMORY
+
+inline Byte* ReserveVirtual( const std::size_t bytes, const std::size_t alignment ) {
+	// rezervovat vetsi rozsah a odriznout nezarovnany zacatek a prebyvajici konec
+	const std::size_t reserved = bytes + alignment;
+	void* const ptr = mmap( nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+	if ( ptr == MAP_FAILED ) {
 		return nullptr;
 	}
-	Block* block = free;
-	free = block->next;
-	block->chunk->allocated += 1;
-	allocated += 1;
-	return reinterpret_cast< Byte* >( block ) + sizeof( Block );
+	Byte* const storage = static_cast< Byte* >( ptr );
+	const std::size_t offset = ( alignment - reinterpret_cast< std::size_t >( storage ) % alignment ) % alignment;
+	if ( offset > 0 ) {
+		munmap( storage, offset );
+	}
+	munmap( storage + offset + bytes, reserved - offset - bytes );
+	return storage + offset;
 }
 
-void FixedAllocator::Free( void* const ptr ) {
-	if ( ptr == nullptr ) {
+inline void ReleaseVirtual( Byte* const ptr, const std::size_t bytes ) {
+	munmap( ptr, bytes );
+}
+
+inline bool CommitVirtual( Byte* const ptr, const std::size_t bytes, const bool hugePages ) {
+	if ( mprotect( ptr, bytes, PROT_READ | PROT_WRITE ) != 0 ) {
+		return false;
+	}
+#ifdef MADV_HUGEPAGE
+	// pouze doporuceni, pri selhani jadro pouzije bezne stranky
+	if ( hugePages ) {
+		madvise( ptr, bytes, MADV_HUGEPAGE );
+	}
+#endif
+	return true;
+}
+
+inline void DecommitVirtual( Byte* const ptr, const std::size_t bytes ) {
+	// vratit fyzicke stranky systemu, dalsi commit vrati vynulovanou pamet
+	madvise( ptr, bytes, MADV_DONTNEED );
+	mprotect( ptr, bytes, PROT_NONE );
+}
+
+#else
+
+inline Byte* ReserveVirtual( const std::size_t, const std::size_t ) {
+	return nullptr;
+}
+
+inline void ReleaseVirtual( Byte* const, const std::size_t ) {}
+
+inline bool CommitVirtual( Byte* const, const std::size_t, const bool ) {
+	return false;
+}
+
+inline void DecommitVirtual( Byte* const, const std::size_t ) {}
+
+#endif
+
+// HeapChunkProvider
+
+const std::size_t CHUNK_ARENA_BYTES = VIRTUAL_PAGE_SIZE;
+const std::size_t CHUNK_ARENA_MIN_CHUNK = 32;
+const int CHUNK_ARENA_CLASSES = 11;	// chunky 32 B - 32 kB
+
+namespace {
+	
+	/*
+	Chunky velikosti mocniny 2 (FixedAllocator) jsou zarovnany na svou velikost. Nejsou alokovany funkci alloc_aligned,
+	ta pro zarovnani rezervuje az dvojnasobek velikosti chunku (_aligned_malloc, posix_memalign).
+	- chunky od CHUNK_ARENA_BYTES jsou samostatne rezervovany a commitovany ve virtualni pameti,
+	  nezarovnane okraje rezervace se vrati systemu a nezabiraji fyzickou pamet
+	- mensi chunky jsou vykrajovany z aren velikosti CHUNK_ARENA_BYTES zarovnanych na svou velikost,
+	  arena obsahuje chunky jedne velikosti a vrati se systemu po uvolneni vsech svych chunku
+	Areny s volnymi chunky jsou na zacatku seznamu sve velikosti, AllocChunk() bere chunk z prvni areny,
+	FreeChunk() hleda arenu linearne (chunky se uvolnuji zridka, Flush() nebo destrukce alokatoru).
+	Ostatni bloky (velikost neni mocnina 2) alokuje AllocSystem().
+	*/
+	class HeapChunkProvider: public ChunkProvider {
+	public:
+		HeapChunkProvider() {
+			for ( int i = 0; i < CHUNK_ARENA_CLASSES; i++ ) {
+				arenas[ i ] = nullptr;
+				lastArenas[ i ] = nullptr;
+			}
+		}
+		
+		virtual void* AllocChunk( const std::size_t bytes, const std::size_t alignment ) override {
+#ifdef VIRTUAL_MEMORY
+			if ( IsSelfAligned( bytes ) ) {
+				if ( bytes >= CHUNK_ARENA_BYTES ) {
+					return AllocVirtual( bytes, bytes );
+				}
+				return AllocArenaChunk( bytes );
+			}
+#endif
+			return AllocSystem( bytes, alignment );
+		}
+		
+		virtual void FreeChunk( void* const chunk, const std::size_t bytes ) override {
+#ifdef VIRTUAL_MEMORY
+			if ( IsSelfAligned( bytes ) ) {
+				if ( bytes >= CHUNK_ARENA_BYTES ) {
+					ReleaseVirtual( static_cast< Byte* >( chunk ), bytes );
+				} else {
+					FreeArenaChunk( static_cast< Byte* >( chunk ), bytes );
+				}
+				return;
+			}
+#endif
+			FreeSystem( chunk );
+		}
+		
+		virtual std::size_t GetGranularity() const override {
+			return 16;
+		}
+		
+	private:
+		struct Arena {
+			Arena* next;
+			Byte* storage;
+			Byte* untouched;	// zacatek dosud nepouzitych chunku
+			void* free;			// seznam uvolnenych chunku (ukazatel na dalsi je v prvnich bajtech chunku)
+			std::size_t used;	// pocet pridelenych chunku
+		};
+		
+		// chunky velikosti mocniny 2 jsou vzdy zarovnany na svou velikost (zarovnani chunku neni vetsi nez velikost)
+		static bool IsSelfAligned( const std::size_t bytes ) {
+			return bytes > 16 && ( bytes & ( bytes - 1 ) ) == 0;
+		}
+		
+		static Byte* AllocVirtual( const std::size_t bytes, const std::size_t alignment ) {
+			Byte* const storage = ReserveVirtual( bytes, alignment );
+			if ( storage == nullptr ) {
+				return nullptr;
+			}
+			if ( !CommitVirtual( storage, bytes, false ) ) {
+				ReleaseVirtual( storage, bytes );
+				return nullptr;
+			}
+			return storage;
+		}
+		
+		static int GetArenaClass( const std::size_t bytes ) {
+			int index = 0;
+			for ( std::size_t size = CHUNK_ARENA_MIN_CHUNK; size < bytes; size *= 2 ) {
+				index += 1;
+			}
+			return index;
+		}
+		
+		static bool IsFull( const Arena* const arena ) {
+			return arena->free == nullptr && arena->untouched == arena->storage + CHUNK_ARENA_BYTES;
+		}
+		
+		void* AllocArenaChunk( const std::size_t bytes ) {
+			const int index = GetArenaClass( bytes );
+			std::lock_guard< std::mutex > lock( mutex );
+			Arena* arena = arenas[ index ];
+			if ( arena == nullptr || IsFull( arena ) ) {
+				// popis areny neni alokovan operatorem new, provider pouzivaji i pooly operatoru new
+				arena = static_cast< Arena* >( AllocSystem( sizeof( Arena ) ) );
+				if ( arena == nullptr ) {
+					return nullptr;
+				}
+				arena->storage = AllocVirtual( CHUNK_ARENA_BYTES, CHUNK_ARENA_BYTES );
+				if ( arena->storage == nullptr ) {
+					FreeSystem( arena );
+					return nullptr;
+				}
+				arena->untouched = arena->storage;
+				arena->free = nullptr;
+				arena->used = 0;
+				arena->next = arenas[ index ];
+				if ( arenas[ index ] == nullptr ) {
+					lastArenas[ index ] = arena;
+				}
+				arenas[ index ] = arena;
+			}
+			void* chunk = arena->free;
+			if ( chunk != nullptr ) {
+				arena->free = *static_cast< void** >( chunk );
+			} else {
+				chunk = arena->untouched;
+				arena->untouched += bytes;
+			}
+			arena->used += 1;
+			
+			// plna arena se presune na konec seznamu
+			if ( IsFull( arena ) && arena->next != nullptr ) {
+				arenas[ index ] = arena->next;
+				arena->next = nullptr;
+				lastArenas[ index ]->next = arena;
+				lastArenas[ index ] = arena;
+			}
+			return chunk;
+		}
+		
+		void FreeArenaChunk( Byte* const chunk, const std::size_t bytes ) {
+			const int index = GetArenaClass( bytes );
+			Byte* const storage = reinterpret_cast< Byte* >( reinterpret_cast< std::size_t >( chunk ) & ~( CHUNK_ARENA_BYTES - 1 ) );
+			std::lock_guard< std::mutex > lock( mutex );
+			Arena* prev = nullptr;
+			Arena* arena = arenas[ index ];
+			while ( arena != nullptr && arena->storage != storage ) {
+				prev = arena;
+				arena = arena->next;
+			}
+			// Chyba, chunk nebyl alokovan providerem!
+			if ( arena == nullptr ) {
+				Application::Abort( String( u"HeapChunkProvider::FreeChunk() failed, chunk does not belong to any arena!" ) );
+			}
+			*reinterpret_cast< void** >( chunk ) = arena->free;
+			arena->free = chunk;
+			arena->used -= 1;
+			
+			// prazdna arena se vrati systemu, arena s volnym chunkem se presune na zacatek seznamu
+			if ( arena->used == 0 || prev != nullptr ) {
+				if ( prev != nullptr ) {
+					prev->next = arena->next;
+				} else {
+					arenas[ index ] = arena->next;
+				}
+				if ( lastArenas[ index ] == arena ) {
+					lastArenas[ index ] = prev;
+				}
+				if ( arena->used == 0 ) {
+					ReleaseVirtual( arena->storage, CHUNK_ARENA_BYTES );
+					FreeSystem( arena );
+					return;
+				}
+				arena->next = arenas[ index ];
+				if ( arenas[ index ] == nullptr ) {
+					lastArenas[ index ] = arena;
+				}
+				arenas[ index ] = arena;
+			}
+		}
+		
+	private:
+		Arena* arenas[ CHUNK_ARENA_CLASSES ];
+		Arena* lastArenas[ CHUNK_ARENA_CLASSES ];
+		std::mutex mutex;
+	};
+}
+
+// provider neni nikdy znicen, alokatory mohou byt niceny behem destrukce statickych objektu
+ChunkProvider* GetHeapChunkProvider() {
+	alignas( HeapChunkProvider ) static Byte storage[ sizeof( HeapChunkProvider ) ];
+	static ChunkProvider* const provider = new ( storage ) HeapChunkProvider();
+	return provider;
+}
+
+// VirtualChunkProvider
+
+VirtualChunkProvider::VirtualChunkProvider( const std::size_t reserveBytes, const bool largePages ):
+	base( nullptr ),
+	reserved( 0 ),
+	pageSize( VIRTUAL_PAGE_SIZE ),
+	pagesCount( 0 ),
+	committedPages( 0 ),
+	pagesUsed( nullptr ),
+	hugePages( false )
+{
+#ifdef _LINUX
+	if ( largePages ) {
+		pageSize = HUGE_PAGE_SIZE;
+		hugePages = true;
+	}
+#endif
+	pagesCount = ( reserveBytes + pageSize - 1 ) / pageSize;
+	if ( pagesCount == 0 ) {
 		return;
 	}
-	Block* block = reinterpret_cast< Block* >( reinterpret_cast< Byte* >( ptr ) - sizeof( Block ) );
-	block->next = free;
-	free = block;
-	block->chunk->allocated -= 1;
-	allocated -= 1;
+	base = ReserveVirtual( pagesCount * pageSize, pageSize );
+	if ( base == nullptr ) {
+		pagesCount = 0;
+		return;
+	}
+	reserved = pagesCount * pageSize;
+	
+	// tabulka neni alokovana operatorem new, provider muze byt pouzit i pro pooly operatoru new
+	pagesUsed = static_cast< bool* >( AllocSystem( pagesCount * sizeof( bool ) ) );
+	if ( pagesUsed == nullptr ) {
+		ReleaseVirtual( base, reserved );
+		base = nullptr;
+		reserved = 0;
+		pagesCount = 0;
+		return;
+	}
+	for ( std::size_t i = 0; i < pagesCount; i++ ) {
+		pagesUsed[ i ] = false;
+	}
 }
 
-void FixedAllocator::Flush() {
-	Chunk* chunk = chunks;
-	while ( chunk != nullptr ) {
-		if ( chunk->allocated > 0 ) {
-			chunk = chunk->next;
+VirtualChunkProvider::~VirtualChunkProvider() {
+	// Chyba, nektery alokator stale pouziva chunky providera!
+	if ( committedPages > 0 ) {
+		Application::Abort( String( u"VirtualChunkProvider destruction failed, there are still allocated chunks!" ) );
+	}
+	if ( base != nullptr ) {
+		ReleaseVirtual( base, reserved );
+	}
+	FreeSystem( pagesUsed );
+}
+
+bool VirtualChunkProvider::IsValid() const {
+	return base != nullptr;
+}
+
+std::size_t VirtualChunkProvider::GetCommitted() const {
+	std::lock_guard< std::mutex > lock( mutex );
+	return committedPages * pageSize;
+}
+
+std::size_t VirtualChunkProvider::GetPagesCount( const std::size_t bytes ) const {
+	return ( bytes + pageSize - 1 ) / pageSize;
+}
+
+void* VirtualChunkProvider::AllocChunk( const std::size_t bytes, const std::size_t alignment ) {
+	const std::size_t count = GetPagesCount( bytes );
+	if ( count == 0 || count > pagesCount ) {
+		return nullptr;
+	}
+	std::lock_guard< std::mutex > lock( mutex );
+	
+	// najit prvni volny souvisly rozsah stranek zacinajici na zarovnane adrese
+	std::size_t first = 0;
+	std::size_t length = 0;
+	for ( std::size_t i = 0; i < pagesCount && length < count; i++ ) {
+		if ( pagesUsed[ i ] ) {
+			length = 0;
 			continue;
 		}
-		if ( chunks == chunk ) {
-			chunks = chunk->next;
+		if ( length == 0 ) {
+			if ( reinterpret_cast< std::size_t >( base + i * pageSize ) % alignment != 0 ) {
+				continue;
+			}
+			first = i;
 		}
-		Chunk *empty = chunk;
-		chunk = chunk->next;
-		delete [] empty;
+		length += 1;
+	}
+	// rezervovany rozsah je vycerpan
+	if ( length < count ) {
+		return nullptr;
+	}
+	Byte* const chunk = base + first * pageSize;
+	if ( !CommitVirtual( chunk, count * pageSize, hugePages ) ) {
+		return nullptr;
+	}
+	for ( std::size_t i = first; i < first + count; i++ ) {
+		pagesUsed[ i ] = true;
 	}
+	committedPages += count;
+	return chunk;
 }
 
-unsigned long FixedAllocator::Allocated() const {
-	return allocated;
+void VirtualChunkProvider::FreeChunk( void* const chunk, const std::size_t bytes ) {
+	if ( chunk == nullptr ) {
+		return;
+	}
+	const std::size_t first = static_cast< std::size_t >( static_cast< Byte* >( chunk ) - base ) / pageSize;
+	const std::size_t count = GetPagesCount( bytes );
+	std::lock_guard< std::mutex > lock( mutex );
+	DecommitVirtual( static_cast< Byte* >( chunk ), count * pageSize );
+	for ( std::size_t i = first; i < first + count; i++ ) {
+		pagesUsed[ i ] = false;
+	}
+	committedPages -= count;
 }
 
-unsigned long FixedAllocator::MemoryOccupied() const {
-	unsigned long bytes = 0;
-	Chunk* chunk = chunks;
-	while ( chunk != nullptr ) {
-		bytes += sizeof( Chunk ) + chunk->count * ( sizeof( Block ) + size );
+std::size_t VirtualChunkProvider::GetGranularity() const {
+	return pageSize;
+}
+
+// FixedAllocator
+
+// zaokrouhli bytes nahoru na nasobek alignment (mocnina 2)
+inline std::size_t AlignSize( const std::size_t bytes, const std::size_t alignment ) {
+	return ( bytes + alignment - 1 ) & ~( alignment - 1 );
+}
+
+// nejmensi mocnina 2 vetsi nebo rovna bytes
+inline std::size_t GetUpperPow2( const std::size_t bytes ) {
+	std::size_t result = 16;
+	while ( result < bytes ) {
+		result <<= 1;
 	}
-	return bytes;
+	return result;
+}
+
+FixedAllocator::FixedAllocator(
+	const unsigned long blockSizeParam,
+	const unsigned long chunkSizeParam,
+	ChunkProvider* const providerParam,
+	const unsigned long alignmentParam
+):
+	provider( providerParam != nullptr ? providerParam : GetHeapChunkProvider() ),
+	partial( nullptr ),
+	full( nullptr ),
+	empty( nullptr ),
+	size( static_cast< unsigned long >( AlignSize( Math::Max( blockSizeParam, 1ul ), Math::Max( alignmentParam, 16ul ) ) ) ),
+	alignment( Math::Max( alignmentParam, 16ul ) ),
+	chunksCount( 0 ),
+	allocated( 0 )
+{
+	// chunk musi byt zarovnan na svou velikost, aby slo z adresy bloku urcit chunk
+	chunkHeader = static_cast< unsigned long >( AlignSize( sizeof( Chunk ), alignment ) );
+	const std::size_t bytes = chunkHeader + static_cast< std::size_t >( Math::Max( chunkSizeParam, 1ul ) ) * size;
+	chunkBytes = GetUpperPow2( Math::Max( bytes, provider->GetGranularity() ) );
+	blocksPerChunk = static_cast< unsigned long >( ( chunkBytes - chunkHeader ) / size );
+}
+
+FixedAllocator::~FixedAllocator() {
+	// Chyba, je alokovana nejaka pamet!
+	if ( allocated > 0 ) {
+		Application::Abort( String( u"FixedAllocator destruction failed, there is still allocated memory!" ) );
+	}
+	for ( Chunk* list : { partial, full, empty } ) {
+		Chunk* chunk = list;
+		while ( chunk != nullptr ) {
+			Chunk* next = chunk->next;
+			provider->FreeChunk( chunk, chunkBytes );
+			chunk = next;
+		}
+	}
+}
+
+void FixedAllocator::Unlink( Chunk*& list, Chunk* const chunk ) {
+	if ( chunk->prev != nullptr ) {
+		chunk->prev->next = chunk->next;
+	} else {
+		list = chunk->next;
+	}
+	if ( chunk->next != nullptr ) {
+		chunk->next->prev = chunk->prev;
+	}
+}
+
+void FixedAllocator::PushFront( Chunk*& list, Chunk* const chunk ) {
+	chunk->prev = nullptr;
+	chunk->next = list;
+	if ( list != nullptr ) {
+		list->prev = chunk;
+	}
+	list = chunk;
+}
+
+inline FixedAllocator::Chunk* FixedAllocator::GetChunk( const void* const ptr ) const {
+	return reinterpret_cast< Chunk* >( reinterpret_cast< std::size_t >( ptr ) & ~( chunkBytes - 1 ) );
+}
+
+void FixedAllocator::Reserve( const unsigned long bytes ) {
+	// pocet volnych bloku musi pokryt bytes bajtu
+	while ( static_cast< std::size_t >( chunksCount * blocksPerChunk - allocated ) * size < bytes ) {
+		if ( !Expand() ) {
+			return;
+		}
+	}
+}
+
+bool FixedAllocator::Expand() {
+	Byte* storage = static_cast< Byte* >( provider->AllocChunk( chunkBytes, chunkBytes ) );
+	if ( storage == nullptr ) {
+		return false;
+	}
+	// bloky se inicializuji az pri alokaci
+	Chunk* chunk = reinterpret_cast< Chunk* >( storage );
+	chunk->free = nullptr;
+	chunk->untouched = storage + chunkHeader;
+	chunk->allocated = 0;
+	PushFront( empty, chunk );
+	chunksCount += 1;
+	return true;
+}
+
+inline FixedAllocator::Block* FixedAllocator::AllocFromChunk( Chunk* const chunk ) {
+	Block* block = chunk->free;
+	if ( block != nullptr ) {
+		chunk->free = block->next;
+	} else {
+		block = reinterpret_cast< Block* >( chunk->untouched );
+		chunk->untouched += size;
+	}
+	chunk->allocated += 1;
+	return block;
+}
+
+void* FixedAllocator::Alloc() {
+	Chunk* chunk = partial;
+	if ( chunk == nullptr ) {
+		// nepodarilo se volani funkce Expand()
+		if ( empty == nullptr && !Expand() ) {
+			return nullptr;
+		}
+		chunk = empty;
+		Unlink( empty, chunk );
+		PushFront( partial, chunk );
+	}
+	Block* block = AllocFromChunk( chunk );
+	if ( chunk->allocated == blocksPerChunk ) {
+		Unlink( partial, chunk );
+		PushFront( full, chunk );
+	}
+	allocated += 1;
+	TrackAllocation( tag, size );
+	return block;
+}
+
+unsigned long FixedAllocator::AllocBatch( void** const blocks, const unsigned long count ) {
+	unsigned long done = 0;
+	while ( done < count ) {
+		Chunk* chunk = partial;
+		if ( chunk == nullptr ) {
+			if ( empty == nullptr && !Expand() ) {
+				break;
+			}
+			chunk = empty;
+			Unlink( empty, chunk );
+			PushFront( partial, chunk );
+		}
+		while ( done < count && chunk->allocated < blocksPerChunk ) {
+			blocks[ done ] = AllocFromChunk( chunk );
+			done += 1;
+		}
+		if ( chunk->allocated == blocksPerChunk ) {
+			Unlink( partial, chunk );
+			PushFront( full, chunk );
+		}
+	}
+	allocated += done;
+	TrackAllocations( tag, static_cast< std::size_t >( done ) * size, done );
+	return done;
+}
+
+inline void FixedAllocator::FreeBlock( void* const ptr ) {
+	Chunk* chunk = GetChunk( ptr );
+	Block* block = static_cast< Block* >( ptr );
+	block->next = chunk->free;
+	chunk->free = block;
+	
+	// chunk s uvolnenym blokem je skoro plny, bude pouzit pro dalsi alokace
+	if ( chunk->allocated == blocksPerChunk ) {
+		Unlink( full, chunk );
+		PushFront( partial, chunk );
+	}
+	chunk->allocated -= 1;
+	
+	// prazdny chunk pouzit az nakonec, pri dalsim pouziti se bloky alokuji opet od zacatku chunku
+	if ( chunk->allocated == 0 ) {
+		Unlink( partial, chunk );
+		PushFront( empty, chunk );
+		chunk->free = nullptr;
+		chunk->untouched = reinterpret_cast< Byte* >( chunk ) + chunkHeader;
+	}
+	allocated -= 1;
+}
+
+void FixedAllocator::Free( void* const ptr ) {
+	if ( ptr == nullptr ) {
+		return;
+	}
+	FreeBlock( ptr );
+	TrackFree( tag, size );
+}
+
+void FixedAllocator::FreeBatch( void* const* const blocks, const unsigned long count ) {
+	unsigned long freed = 0;
+	for ( unsigned long i = 0; i < count; i++ ) {
+		if ( blocks[ i ] != nullptr ) {
+			FreeBlock( blocks[ i ] );
+			freed += 1;
+		}
+	}
+	TrackFrees( tag, static_cast< std::size_t >( freed ) * size, freed );
+}
+
+void FixedAllocator::Flush() {
+	// vratit prazdne chunky providerovi
+	while ( empty != nullptr ) {
+		Chunk* chunk = empty;
+		empty = chunk->next;
+		provider->FreeChunk( chunk, chunkBytes );
+		chunksCount -= 1;
+	}
+}
+
+unsigned long FixedAllocator::GetBlockSize() const {
+	return size;
+}
+
+unsigned long FixedAllocator::Allocated() const {
+	return allocated;
+}
+
+unsigned long FixedAllocator::MemoryOccupied() const {
+	return static_cast< unsigned long >( chunksCount * chunkBytes );
 }
 
 unsigned long FixedAllocator::MemoryAllocated() const {
 	return allocated * size;
+}
+
+// ConcurrentFixedAllocator
+
+// na x64 je vyuzito jen 48 bitu adresy, horni bity muze obsahovat tag
+#if UINTPTR_MAX > 0xffffffffu
+const unsigned int TAG_SHIFT = 48;
+#else
+const unsigned int TAG_SHIFT = 32;
+#endif
+
+const uint64_t TAG_POINTER_MASK = ( uint64_t( 1 ) << TAG_SHIFT ) - 1;
+
+inline ConcurrentFixedAllocator::TaggedBlock ConcurrentFixedAllocator::Tag( Block* const block, const TaggedBlock previous ) {
+	const uint64_t generation = ( previous >> TAG_SHIFT ) + 1;
+	return ( generation << TAG_SHIFT ) | ( static_cast< uint64_t >( reinterpret_cast< uintptr_t >( block ) ) & TAG_POINTER_MASK );
+}
+
+inline ConcurrentFixedAllocator::Block* ConcurrentFixedAllocator::Untag( const TaggedBlock tagged ) {
+	return reinterpret_cast< Block* >( static_cast< uintptr_t >( tagged & TAG_POINTER_MASK ) );
+}
+
+ConcurrentFixedAllocator::ConcurrentFixedAllocator(
+	const unsigned long blockSizeParam,
+	const unsigned long chunkSizeParam,
+	ChunkProvider* const providerParam,
+	const unsigned long alignmentParam
+):
+	provider( providerParam != nullptr ? providerParam : GetHeapChunkProvider() ),
+	free( 0 ),
+	chunks( nullptr ),
+	size( ( blockSizeParam + 15 ) & ( ~0x0f ) ), // 16 byte alignment
+	chunkSize( chunkSizeParam ),
+	alignment( Math::Max( alignmentParam, 16ul ) )
+{
+	// hlavicka bloku lezi tesne pred zarovnanymi daty bloku
+	stride = static_cast< unsigned long >( AlignSize( sizeof( Block ) + size, alignment ) );
+	blocksOffset = static_cast< unsigned long >( AlignSize( sizeof( Chunk ) + sizeof( Block ), alignment ) );
+}
+
+ConcurrentFixedAllocator::~ConcurrentFixedAllocator() {
+	// Chyba, je alokovana nejaka pamet!
+	if ( Allocated() > 0 ) {
+		Application::Abort( String( u"ConcurrentFixedAllocator destruction failed, there is still allocated memory!" ) );
+	}
+	Chunk* chunk = chunks;
+	while ( chunk != nullptr ) {
+		Chunk* next = chunk->next;
+		const std::size_t bytes = GetChunkBytes( chunk->count );
+		chunk->~Chunk();
+		provider->FreeChunk( chunk, bytes );
+		chunk = next;
+	}
+}
+
+std::size_t ConcurrentFixedAllocator::GetChunkBytes( const unsigned long count ) const {
+	return blocksOffset - sizeof( Block ) + static_cast< std::size_t >( count ) * stride;
+}
+
+void ConcurrentFixedAllocator::Push( Block* const first, Block* const last ) {
+	TaggedBlock head = free.load( std::memory_order_relaxed );
+	do {
+		last->next.store( Untag( head ), std::memory_order_relaxed );
+	} while ( !free.compare_exchange_weak( head, Tag( first, head ), std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+ConcurrentFixedAllocator::Block* ConcurrentFixedAllocator::Pop() {
+	TaggedBlock head = free.load( std::memory_order_acquire );
+	for ( ;; ) {
+		Block* const block = Untag( head );
+		if ( block == nullptr ) {
+			return nullptr;
+		}
+		// blok mohlo mezitim odebrat jine vlakno, pak je next neplatny, ale CAS selze diky zmene tagu
+		Block* const next = block->next.load( std::memory_order_relaxed );
+		if ( free.compare_exchange_weak( head, Tag( next, head ), std::memory_order_acquire, std::memory_order_acquire ) ) {
+			return block;
+		}
+	}
+}
+
+void ConcurrentFixedAllocator::Reserve( const unsigned long bytes ) {
+	std::lock_guard< std::mutex > lock( mutex );
+	Expand( ( bytes / size ) + 1 );
+}
+
+bool ConcurrentFixedAllocator::Expand( const unsigned long countParam ) {
+	// chunk zaokrouhleny na granularitu providera je vyplnen bloky cely
+	const std::size_t granularity = provider->GetGranularity();
+	const std::size_t bytes = ( ( GetChunkBytes( countParam ) + granularity - 1 ) / granularity ) * granularity;
+	const unsigned long count = static_cast< unsigned long >( ( bytes - ( blocksOffset - sizeof( Block ) ) ) / stride );
+	
+	// alokovat pamet
+	Byte* storage = static_cast< Byte* >( provider->AllocChunk( GetChunkBytes( count ), alignment ) );
+	if ( storage == nullptr ) {
+		return false;
+	}
+	// inicializovat chunk
+	Chunk* chunk = new ( storage ) Chunk();
+	chunk->allocated.store( 0, std::memory_order_relaxed );
+	chunk->count = count;
+	chunk->released = 0;
+	
+	// vlozit novy chunk na vrchol seznamu
+	chunk->next = chunks;
+	chunks = chunk;
+	
+	// inicializovat bloky
+	Byte* ptr = storage + blocksOffset - sizeof( Block );
+	Block* first = reinterpret_cast< Block* >( ptr );
+	Block* last = first;
+	for ( unsigned long i = 0; i < count; i++ ) {
+		Block* block = new ( ptr ) Block();
+		block->chunk = chunk;
+		block->next.store( reinterpret_cast< Block* >( ptr + stride ), std::memory_order_relaxed );
+		last = block;
+		ptr += stride;
+	}
+	// bloky nejsou do publikovani viditelne jinym vlaknum, release v Push() zajisti viditelnost inicializace
+	Push( first, last );
+	return true;
+}
+
+void* ConcurrentFixedAllocator::Alloc() {
+	Block* block = Pop();
+	while ( block == nullptr ) {
+		std::lock_guard< std::mutex > lock( mutex );
+		
+		// jine vlakno mohlo mezitim rozsirit alokator
+		block = Pop();
+		if ( block != nullptr ) {
+			break;
+		}
+		// nepodarilo se volani funkce Expand()
+		if ( !Expand( chunkSize ) ) {
+			return nullptr;
+		}
+		block = Pop();
+	}
+	block->chunk->allocated.fetch_add( 1, std::memory_order_relaxed );
+	TrackAllocation( tag, size );
+	return reinterpret_cast< Byte* >( block ) + sizeof( Block );
+}
+
+void ConcurrentFixedAllocator::Free( void* const ptr ) {
+	if ( ptr == nullptr ) {
+		return;
+	}
+	Block* block = reinterpret_cast< Block* >( reinterpret_cast< Byte* >( ptr ) - sizeof( Block ) );
+	block->chunk->allocated.fetch_sub( 1, std::memory_order_relaxed );
+	TrackFree( tag, size );
+	Push( block, block );
+}
+
+void ConcurrentFixedAllocator::Flush() {
+	std::lock_guard< std::mutex > lock( mutex );
+	
+	// odebrat vsechny volne bloky, soucasne volana Free() vklada bloky do prazdneho zasobniku
+	TaggedBlock head = free.load( std::memory_order_acquire );
+	while ( !free.compare_exchange_weak( head, Tag( nullptr, head ), std::memory_order_acquire, std::memory_order_relaxed ) ) {}
+	
+	// chunk je prazdny, pokud jsou v zasobniku vsechny jeho bloky
+	for ( Block* block = Untag( head ); block != nullptr; block = block->next.load( std::memory_order_relaxed ) ) {
+		block->chunk->released += 1;
+	}
+	// vratit do zasobniku bloky chunku, ktere zustanou alokovany
+	Block* first = nullptr;
+	Block* last = nullptr;
+	Block* block = Untag( head );
+	while ( block != nullptr ) {
+		Block* next = block->next.load( std::memory_order_relaxed );
+		if ( block->chunk->released < block->chunk->count ) {
+			block->next.store( first, std::memory_order_relaxed );
+			if ( last == nullptr ) {
+				last = block;
+			}
+			first = block;
+		}
+		block = next;
+	}
+	if ( first != nullptr ) {
+		Push( first, last );
+	}
+	// uvolnit prazdne chunky
+	Chunk** link = &chunks;
+	while ( *link != nullptr ) {
+		Chunk* chunk = *link;
+		if ( chunk->released < chunk->count ) {
+			chunk->released = 0;
+			link = &chunk->next;
+			continue;
+		}
+		*link = chunk->next;
+		const std::size_t bytes = GetChunkBytes( chunk->count );
+		chunk->~Chunk();
+		provider->FreeChunk( chunk, bytes );
+	}
+}
+
+unsigned long ConcurrentFixedAllocator::GetBlockSize() const {
+	return size;
+}
+
+unsigned long ConcurrentFixedAllocator::Allocated() const {
+	std::lock_guard< std::mutex > lock( mutex );
+	unsigned long allocated = 0;
+	for ( Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next ) {
+		allocated += chunk->allocated.load( std::memory_order_relaxed );
+	}
+	return allocated;
+}
+
+unsigned long ConcurrentFixedAllocator::MemoryOccupied() const {
+	std::lock_guard< std::mutex > lock( mutex );
+	unsigned long bytes = 0;
+	for ( Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next ) {
+		bytes += static_cast< unsigned long >( GetChunkBytes( chunk->count ) );
+	}
+	return bytes;
+}
+
+unsigned long ConcurrentFixedAllocator::MemoryAllocated() const {
+	return Allocated() * size;
+}
+
+// FrameAllocator
+
+FrameAllocator::FrameAllocator( const unsigned long pageSizeParam, const unsigned long framesCountParam ):
+	pageSize( pageSizeParam ),
+	framesCount( Math::Min( Math::Max( framesCountParam, 1ul ), MAX_FRAME_ALLOCATOR_FRAMES ) ),
+	frame( 0 )
+{
+	for ( Arena& arena : arenas ) {
+		arena.first = nullptr;
+		SetCurrentPage( arena, nullptr );
+		arena.allocated = 0;
+		arena.used = 0;
+	}
+}
+
+FrameAllocator::~FrameAllocator() {
+	// alokace aktualniho snimku jeste nebyly zapocitany
+	for ( unsigned long i = 0; i < framesCount; i++ ) {
+		if ( i != frame ) {
+			TrackFrees( tag, arenas[ i ].used, arenas[ i ].allocated );
+		}
+	}
+	for ( Arena& arena : arenas ) {
+		Page* page = arena.first;
+		while ( page != nullptr ) {
+			Page* next = page->next;
+			FreeSystem( page );
+			page = next;
+		}
+	}
+}
+
+void FrameAllocator::SetCurrentPage( Arena& arena, Page* const page ) {
+	arena.current = page;
+	if ( page == nullptr ) {
+		arena.top = nullptr;
+		arena.end = nullptr;
+		return;
+	}
+	arena.top = reinterpret_cast< Byte* >( page ) + sizeof( Page );
+	arena.end = arena.top + page->size;
+}
+
+FrameAllocator::Page* FrameAllocator::CreatePage( const unsigned long bytes ) {
+	const unsigned long size = Math::Max( pageSize, bytes );
+	Byte* storage = static_cast< Byte* >( AllocSystem( sizeof( Page ) + size ) );
+	if ( storage == nullptr ) {
+		return nullptr;
+	}
+	Page* page = reinterpret_cast< Page* >( storage );
+	page->next = nullptr;
+	page->size = size;
+	return page;
+}
+
+void* FrameAllocator::AllocFromNextPage( const unsigned long bytes ) {
+	Arena& arena = arenas[ frame ];
+	
+	// prvni alokace bufferu
+	if ( arena.first == nullptr ) {
+		arena.first = CreatePage( bytes );
+		if ( arena.first == nullptr ) {
+			return nullptr;
+		}
+		SetCurrentPage( arena, arena.first );
+		return Alloc( bytes );
+	}
+	// pouzit nasledujici stranku z predchozich snimku, pokud je dost velka
+	Page* next = arena.current->next;
+	if ( next == nullptr || next->size < bytes ) {
+		Page* page = CreatePage( bytes );
+		if ( page == nullptr ) {
+			return nullptr;
+		}
+		page->next = next;
+		arena.current->next = page;
+		next = page;
+	}
+	SetCurrentPage( arena, next );
+	return Alloc( bytes );
+}
+
+void FrameAllocator::NextFrame() {
+	TrackAllocations( tag, arenas[ frame ].used, arenas[ frame ].allocated );
+	frame = ( frame + 1 ) % framesCount;
+	Arena& arena = arenas[ frame ];
+	TrackFrees( tag, arena.used, arena.allocated );
+	SetCurrentPage( arena, arena.first );
+	arena.allocated = 0;
+	arena.used = 0;
+}
+
+void FrameAllocator::Reserve( const unsigned long bytes ) {
+	for ( unsigned long i = 0; i < framesCount; i++ ) {
+		Arena& arena = arenas[ i ];
+		
+		// kapacita existujicich stranek
+		unsigned long capacity = 0;
+		Page** link = &arena.first;
+		while ( *link != nullptr ) {
+			capacity += ( *link )->size;
+			link = &( *link )->next;
+		}
+		if ( capacity >= bytes ) {
+			continue;
+		}
+		*link = CreatePage( bytes - capacity );
+		if ( arena.current == nullptr ) {
+			SetCurrentPage( arena, arena.first );
+		}
+	}
+}
+
+void FrameAllocator::Flush() {
+	// stranky za aktualni strankou bufferu neobsahuji zadna platna data
+	for ( Arena& arena : arenas ) {
+		Page* page = nullptr;
+		if ( arena.current != nullptr ) {
+			page = arena.current->next;
+			arena.current->next = nullptr;
+		} else {
+			page = arena.first;
+			arena.first = nullptr;
+		}
+		while ( page != nullptr ) {
+			Page* next = page->next;
+			FreeSystem( page );
+			page = next;
+		}
+	}
+}
+
+unsigned long FrameAllocator::Allocated() const {
+	unsigned long allocated = 0;
+	for ( unsigned long i = 0; i < framesCount; i++ ) {
+		allocated += arenas[ i ].allocated;
+	}
+	return allocated;
+}
+
+unsigned long FrameAllocator::MemoryOccupied() const {
+	unsigned long bytes = 0;
+	for ( const Arena& arena : arenas ) {
+		for ( Page* page = arena.first; page != nullptr; page = page->next ) {
+			bytes += sizeof( Page ) + page->size;
+		}
+	}
+	return bytes;
+}
+
+unsigned long FrameAllocator::MemoryAllocated() const {
+	unsigned long bytes = 0;
+	for ( unsigned long i = 0; i < framesCount; i++ ) {
+		bytes += arenas[ i ].used;
+	}
+	return bytes;
+}
+
+// StackAllocator
+
+namespace {
+	
+	// nejvetsi high-water mark vsech StackAllocatoru
+	std::atomic< unsigned long > stackHighWaterMark( 0 );
+	
+	void UpdateStackHighWaterMark( const unsigned long bytes ) {
+		unsigned long peak = stackHighWaterMark.load( std::memory_order_relaxed );
+		while ( bytes > peak && !stackHighWaterMark.compare_exchange_weak( peak, bytes, std::memory_order_relaxed ) ) {}
+	}
+}
+
+StackAllocator::StackAllocator( const unsigned long pageSizeParam ):
+	first( nullptr ),
+	current( nullptr ),
+	top( nullptr ),
+	end( nullptr ),
+	allocated( 0 ),
+	used( 0 ),
+	trackedAllocated( 0 ),
+	trackedUsed( 0 ),
+	highWaterMark( 0 ),
+	pageSize( pageSizeParam )
+{}
+
+StackAllocator::~StackAllocator() {
+	FreeAll();
+	Page* page = first;
+	while ( page != nullptr ) {
+		Page* next = page->next;
+		FreeSystem( page );
+		page = next;
+	}
+}
+
+void StackAllocator::SetCurrentPage( Page* const page ) {
+	current = page;
+	if ( page == nullptr ) {
+		top = nullptr;
+		end = nullptr;
+		return;
+	}
+	top = reinterpret_cast< Byte* >( page ) + sizeof( Page );
+	end = top + page->size;
+}
+
+StackAllocator::Page* StackAllocator::CreatePage( const unsigned long bytes ) {
+	const unsigned long size = Math::Max( pageSize, bytes );
+	Byte* storage = static_cast< Byte* >( AllocSystem( sizeof( Page ) + size ) );
+	if ( storage == nullptr ) {
+		return nullptr;
+	}
+	Page* page = reinterpret_cast< Page* >( storage );
+	page->next = nullptr;
+	page->size = size;
+	return page;
+}
+
+void StackAllocator::TrackPending() {
+	TrackAllocations( tag, used - trackedUsed, allocated - trackedAllocated );
+	trackedAllocated = allocated;
+	trackedUsed = used;
+}
+
+void* StackAllocator::AllocFromNextPage( const unsigned long bytes ) {
+	TrackPending();
+	
+	// prvni alokace
+	if ( first == nullptr ) {
+		first = CreatePage( bytes );
+		if ( first == nullptr ) {
+			return nullptr;
+		}
+		SetCurrentPage( first );
+		return Alloc( bytes );
+	}
+	// alokator byl uvolnen k prazdne znacce
+	if ( current == nullptr ) {
+		SetCurrentPage( first );
+		return Alloc( bytes );
+	}
+	// pouzit nasledujici stranku, pokud je dost velka
+	Page* next = current->next;
+	if ( next == nullptr || next->size < bytes ) {
+		Page* page = CreatePage( bytes );
+		if ( page == nullptr ) {
+			return nullptr;
+		}
+		page->next = next;
+		current->next = page;
+		next = page;
+	}
+	SetCurrentPage( next );
+	return Alloc( bytes );
+}
+
+StackAllocator::Marker StackAllocator::GetMarker() {
+	// bloky pred znackou zustanou alokovane po celou dobu vnoreneho bloku
+	TrackPending();
+	
+	Marker marker;
+	marker.page = current;
+	marker.top = top;
+	marker.allocated = allocated;
+	marker.used = used;
+	return marker;
+}
+
+void StackAllocator::FreeToMarker( const Marker& marker ) {
+	// pocet alokovanych bajtu od posledniho uvolneni jen roste, maximum je tedy prave ted
+	if ( used > highWaterMark ) {
+		highWaterMark = used;
+		UpdateStackHighWaterMark( used );
+	}
+	TrackPending();
+	TrackFrees( tag, used - marker.used, allocated - marker.allocated );
+	trackedAllocated = marker.allocated;
+	trackedUsed = marker.used;
+	
+	current = static_cast< Page* >( marker.page );
+	top = marker.top;
+	end = current != nullptr ? reinterpret_cast< Byte* >( current ) + sizeof( Page ) + current->size : nullptr;
+	allocated = marker.allocated;
+	used = marker.used;
+}
+
+void StackAllocator::FreeAll() {
+	Marker marker;
+	marker.page = nullptr;
+	marker.top = nullptr;
+	marker.allocated = 0;
+	marker.used = 0;
+	FreeToMarker( marker );
+}
+
+unsigned long StackAllocator::GetHighWaterMark() const {
+	return Math::Max( highWaterMark, used );
+}
+
+void StackAllocator::ResetHighWaterMark() {
+	highWaterMark = used;
+}
+
+void StackAllocator::Reserve( const unsigned long bytes ) {
+	// kapacita existujicich stranek
+	unsigned long capacity = 0;
+	Page** link = &first;
+	while ( *link != nullptr ) {
+		capacity += ( *link )->size;
+		link = &( *link )->next;
+	}
+	if ( capacity < bytes ) {
+		*link = CreatePage( bytes - capacity );
+	}
+}
+
+void StackAllocator::Flush() {
+	// stranky za aktualni strankou neobsahuji zadna platna data
+	Page* page = nullptr;
+	if ( current != nullptr ) {
+		page = current->next;
+		current->next = nullptr;
+	} else {
+		page = first;
+		first = nullptr;
+	}
+	while ( page != nullptr ) {
+		Page* next = page->next;
+		FreeSystem( page );
+		page = next;
+	}
+}
+
+unsigned long StackAllocator::Allocated() const {
+	return allocated;
+}
+
+unsigned long StackAllocator::MemoryOccupied() const {
+	unsigned long bytes = 0;
+	for ( Page* page = first; page != nullptr; page = page->next ) {
+		bytes += sizeof( Page ) + page->size;
+	}
+	return bytes;
+}
+
+unsigned long StackAllocator::MemoryAllocated() const {
+	return used;
+}
+
+// class ScopedStackMarker
+
+ScopedStackMarker::ScopedStackMarker( StackAllocator& allocatorParam ):
+	allocator( allocatorParam ),
+	marker( allocatorParam.GetMarker() )
+{}
+
+ScopedStackMarker::~ScopedStackMarker() {
+	allocator.FreeToMarker( marker );
+}
+
+StackAllocator& GetThreadStackAllocator() {
+	thread_local StackAllocator allocator( THREAD_STACK_ALLOCATOR_PAGE_SIZE );
+	return allocator;
+}
+
+unsigned long GetStackAllocatorsHighWaterMark() {
+	return stackHighWaterMark.load( std::memory_order_relaxed );
+}
+
+// ThreadCachedFixedAllocator
+
+namespace {
+	
+	// Polozka tabulky magazinu vlakna; magazin je platny jen pokud serial odpovida alokatoru ve slotu
+	struct ThreadCacheEntry {
+		uint64_t serial;
+		void* magazine;
+	};
+	
+	// POD tabulka bez dynamicke inicializace, pristup k ni je jen TLS offset
+	thread_local ThreadCacheEntry threadCache[ MAX_THREAD_CACHED_ALLOCATORS ];
+	
+	const unsigned long NO_CACHE_SLOT = MAX_THREAD_CACHED_ALLOCATORS;
+	
+	// alokatory podle slotu, chrani cacheSlotsMutex (vlakno pri ukonceni najde alokatory svych magazinu)
+	std::mutex cacheSlotsMutex;
+	ThreadCachedFixedAllocator* cacheSlots[ MAX_THREAD_CACHED_ALLOCATORS ];
+	std::atomic< uint64_t > cacheSerials( 1 );
+	
+	// magaziny vlakna uz byly uvolneny destruktorem ThreadCacheOwner, dalsi alokace pouzivaji primo depo
+	thread_local bool threadCacheReleased = false;
+	
+	// Pri ukonceni vlakna vrati jeho magaziny alokatorum
+	struct ThreadCacheOwner {
+		~ThreadCacheOwner() {
+			ThreadCachedFixedAllocator::ReleaseThreadCaches();
+			threadCacheReleased = true;
+		}
+	};
+	
+	thread_local ThreadCacheOwner threadCacheOwner;
+	
+	unsigned long AcquireCacheSlot( ThreadCachedFixedAllocator* const allocator ) {
+		std::lock_guard< std::mutex > lock( cacheSlotsMutex );
+		for ( unsigned long i = 0; i < MAX_THREAD_CACHED_ALLOCATORS; i++ ) {
+			if ( cacheSlots[ i ] == nullptr ) {
+				cacheSlots[ i ] = allocator;
+				return i;
+			}
+		}
+		return NO_CACHE_SLOT;
+	}
+	
+	void ReleaseCacheSlot( const unsigned long slot ) {
+		if ( slot == NO_CACHE_SLOT ) {
+			return;
+		}
+		std::lock_guard< std::mutex > lock( cacheSlotsMutex );
+		cacheSlots[ slot ] = nullptr;
+	}
+}
+
+ThreadCachedFixedAllocator::ThreadCachedFixedAllocator(
+	const unsigned long blockSizeParam,
+	const unsigned long chunkSizeParam,
+	ChunkProvider* const providerParam,
+	const unsigned long alignmentParam,
+	const unsigned long magazineSizeParam
+):
+	depot( blockSizeParam, chunkSizeParam, providerParam, alignmentParam ),
+	magazines( nullptr ),
+	unusedMagazines( nullptr ),
+	magazineSize( magazineSizeParam > 0 ? magazineSizeParam : 1 ),
+	serial( cacheSerials.fetch_add( 1, std::memory_order_relaxed ) ),
+	slot( AcquireCacheSlot( this ) )
+{
+	// alokace zapocitava ThreadCachedFixedAllocator
+	depot.SetTag( AllocationTag::UNTRACKED );
+}
+
+ThreadCachedFixedAllocator::~ThreadCachedFixedAllocator() {
+	// po uvolneni slotu uz zadne ukoncovane vlakno nepristupuje k magazinum
+	ReleaseCacheSlot( slot );
+	
+	// bloky v magazinech patri depu, jinak by destruktor depa hlasil alokovanou pamet
+	Magazine* magazine = magazines;
+	while ( magazine != nullptr ) {
+		Magazine* next = magazine->next;
+		Drain( magazine, magazine->count.load( std::memory_order_relaxed ) );
+		std::free( magazine );
+		magazine = next;
+	}
+}
+
+ThreadCachedFixedAllocator::Magazine* ThreadCachedFixedAllocator::GetMagazine() {
+	if ( slot == NO_CACHE_SLOT ) {
+		return nullptr;
+	}
+	ThreadCacheEntry& entry = threadCache[ slot ];
+	if ( entry.serial == serial ) {
+		return static_cast< Magazine* >( entry.magazine );
+	}
+	// vlakno se ukoncuje a jeho magaziny uz byly vraceny
+	if ( threadCacheReleased ) {
+		return nullptr;
+	}
+	// pouzit magazin ukonceneho vlakna
+	Magazine* magazine = nullptr;
+	{
+		std::lock_guard< std::mutex > lock( mutex );
+		magazine = unusedMagazines;
+		if ( magazine != nullptr ) {
+			unusedMagazines = magazine->nextUnused;
+		}
+	}
+	if ( magazine == nullptr ) {
+		// magazin neni alokovan operatorem new, alokator muze byt pouzit i v implementaci operatoru new
+		void* storage = std::malloc( sizeof( Magazine ) + ( 2 * magazineSize - 1 ) * sizeof( void* ) );
+		if ( storage == nullptr ) {
+			return nullptr;
+		}
+		magazine = static_cast< Magazine* >( storage );
+		magazine->count.store( 0, std::memory_order_relaxed );
+		std::lock_guard< std::mutex > lock( mutex );
+		magazine->next = magazines;
+		magazines = magazine;
+	}
+	entry.serial = serial;
+	entry.magazine = magazine;
+	
+	// prvni pouziti thread_local objektu zaregistruje jeho destruktor
+	static_cast< void >( &threadCacheOwner );
+	return magazine;
+}
+
+void ThreadCachedFixedAllocator::ReleaseMagazine( Magazine* const magazine ) {
+	std::lock_guard< std::mutex > lock( mutex );
+	Drain( magazine, magazine->count.load( std::memory_order_relaxed ) );
+	magazine->nextUnused = unusedMagazines;
+	unusedMagazines = magazine;
+}
+
+void ThreadCachedFixedAllocator::Refill( Magazine* const magazine, const unsigned long count ) {
+	const unsigned long filled = magazine->count.load( std::memory_order_relaxed );
+	const unsigned long added = depot.AllocBatch( magazine->blocks + filled, count );
+	magazine->count.store( filled + added, std::memory_order_relaxed );
+}
+
+void ThreadCachedFixedAllocator::Drain( Magazine* const magazine, const unsigned long count ) {
+	const unsigned long filled = magazine->count.load( std::memory_order_relaxed );
+	const unsigned long drained = Math::Min( count, filled );
+	depot.FreeBatch( magazine->blocks + filled - drained, drained );
+	magazine->count.store( filled - drained, std::memory_order_relaxed );
+}
+
+void* ThreadCachedFixedAllocator::Alloc() {
+	Magazine* const magazine = GetMagazine();
+	if ( magazine == nullptr ) {
+		std::lock_guard< std::mutex > lock( mutex );
+		void* const block = depot.Alloc();
+		if ( block != nullptr ) {
+			TrackAllocation( tag, depot.GetBlockSize() );
+		}
+		return block;
+	}
+	unsigned long count = magazine->count.load( std::memory_order_relaxed );
+	if ( count == 0 ) {
+		std::lock_guard< std::mutex > lock( mutex );
+		Refill( magazine, magazineSize );
+		count = magazine->count.load( std::memory_order_relaxed );
+		
+		// nepodarilo se doplnit magazin
+		if ( count == 0 ) {
+			return nullptr;
+		}
+	}
+	count -= 1;
+	magazine->count.store( count, std::memory_order_relaxed );
+	TrackAllocation( tag, depot.GetBlockSize() );
+	return magazine->blocks[ count ];
+}
+
+void ThreadCachedFixedAllocator::Free( void* const ptr ) {
+	if ( ptr == nullptr ) {
+		return;
+	}
+	TrackFree( tag, depot.GetBlockSize() );
+	Magazine* const magazine = GetMagazine();
+	if ( magazine == nullptr ) {
+		std::lock_guard< std::mutex > lock( mutex );
+		depot.Free( ptr );
+		return;
+	}
+	unsigned long count = magazine->count.load( std::memory_order_relaxed );
+	if ( count == 2 * magazineSize ) {
+		std::lock_guard< std::mutex > lock( mutex );
+		Drain( magazine, magazineSize );
+		count = magazine->count.load( std::memory_order_relaxed );
+	}
+	magazine->blocks[ count ] = ptr;
+	magazine->count.store( count + 1, std::memory_order_relaxed );
+}
+
+void ThreadCachedFixedAllocator::ReleaseThreadCache() {
+	if ( slot == NO_CACHE_SLOT || threadCache[ slot ].serial != serial ) {
+		return;
+	}
+	Magazine* const magazine = static_cast< Magazine* >( threadCache[ slot ].magazine );
+	std::lock_guard< std::mutex > lock( mutex );
+	Drain( magazine, magazine->count.load( std::memory_order_relaxed ) );
+}
+
+void ThreadCachedFixedAllocator::ReleaseThreadCaches() {
+	// zamek slotu zabrani zaniku alokatoru behem vraceni magazinu
+	std::lock_guard< std::mutex > lock( cacheSlotsMutex );
+	for ( unsigned long i = 0; i < MAX_THREAD_CACHED_ALLOCATORS; i++ ) {
+		ThreadCacheEntry& entry = threadCache[ i ];
+		ThreadCachedFixedAllocator* const allocator = cacheSlots[ i ];
+		
+		// magazin zanikleho alokatoru uz byl uvolnen jeho destruktorem
+		if ( allocator != nullptr && entry.serial == allocator->serial ) {
+			allocator->ReleaseMagazine( static_cast< Magazine* >( entry.magazine ) );
+		}
+		entry.serial = 0;
+		entry.magazine = nullptr;
+	}
+}
+
+void ThreadCachedFixedAllocator::Reserve( const unsigned long bytes ) {
+	std::lock_guard< std::mutex > lock( mutex );
+	depot.Reserve( bytes );
+}
+
+unsigned long ThreadCachedFixedAllocator::Allocated() const {
+	std::lock_guard< std::mutex > lock( mutex );
+	unsigned long cached = 0;
+	for ( Magazine* magazine = magazines; magazine != nullptr; magazine = magazine->next ) {
+		cached += magazine->count.load( std::memory_order_relaxed );
+	}
+	return depot.Allocated() - cached;
+}
+
+void ThreadCachedFixedAllocator::Flush() {
+	std::lock_guard< std::mutex > lock( mutex );
+	for ( Magazine* magazine = magazines; magazine != nullptr; magazine = magazine->next ) {
+		Drain( magazine, magazine->count.load( std::memory_order_relaxed ) );
+	}
+	depot.Flush();
+}
+
+unsigned long ThreadCachedFixedAllocator::MemoryOccupied() const {
+	std::lock_guard< std::mutex > lock( mutex );
+	unsigned long bytes = depot.MemoryOccupied();
+	for ( Magazine* magazine = magazines; magazine != nullptr; magazine = magazine->next ) {
+		bytes += sizeof( Magazine ) + ( 2 * magazineSize - 1 ) * sizeof( void* );
+	}
+	return bytes;
+}
+
+unsigned long ThreadCachedFixedAllocator::MemoryAllocated() const {
+	return Allocated() * depot.GetBlockSize();
 }
\ No newline at end of file
@@ -2,21 +2,63 @@
 
 #include <new>
 #include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include "Types.h"
+#include "AllocationTracking.h"
+
+// alokace do teto velikosti jsou obslouzeny size class pooly, vetsi alokace primo systemovou pameti
+const std::size_t SMALL_ALLOCATION_MAX_SIZE = 256;
 
 // 16 byte aligned allocations
 void* operator new( std::size_t size );
 void* operator new[]( std::size_t size );
 void operator delete( void* ptr ) noexcept;
 void operator delete[]( void* ptr ) noexcept;
+void operator delete( void* ptr, std::size_t size ) noexcept;
+void operator delete[]( void* ptr, std::size_t size ) noexcept;
+
+// C++17 aligned allocations (alignment > 16)
+#ifdef __cpp_aligned_new
+void* operator new( std::size_t size, std::align_val_t alignment );
+void* operator new[]( std::size_t size, std::align_val_t alignment );
+void operator delete( void* ptr, std::align_val_t alignment ) noexcept;
+void operator delete[]( void* ptr, std::align_val_t alignment ) noexcept;
+void operator delete( void* ptr, std::size_t size, std::align_val_t alignment ) noexcept;
+void operator delete[]( void* ptr, std::size_t size, std::align_val_t alignment ) noexcept;
+#endif
+
+// pamet obsazena size class pooly operatoru new (vcetne volnych bloku a magazinu vlaken)
+std::size_t GetSmallAllocationsMemoryOccupied();
 
 const unsigned long DEFAULT_ALLOCATOR_CHUNK_SIZE = 128;
 
+// vychozi pocet bloku presouvanych mezi magazinem vlakna a sdilenym depem
+const unsigned long DEFAULT_MAGAZINE_SIZE = 32;
+
+// maximalni pocet soucasne existujicich alokatoru s per-thread cache, dalsi alokatory pracuji bez cache
+// (pooly operatoru new pouzivaji 16 alokatoru pro kazdy pouzity tag)
+const unsigned long MAX_THREAD_CACHED_ALLOCATORS = 256;
+
+// pocet rotujicich bufferu FrameAllocatoru, data alokovana ve snimku N jsou platna do konce snimku N + 2
+const unsigned long DEFAULT_FRAME_ALLOCATOR_FRAMES = 3;
+const unsigned long MAX_FRAME_ALLOCATOR_FRAMES = 4;
+
+// vychozi velikost stranky FrameAllocatoru v bajtech
+const unsigned long DEFAULT_FRAME_ALLOCATOR_PAGE_SIZE = 256 * 1024;
+
+// vychozi velikost stranky StackAllocatoru a velikost stranky alokatoru vlakna (GetThreadStackAllocator)
+const unsigned long DEFAULT_STACK_ALLOCATOR_PAGE_SIZE = 64 * 1024;
+const unsigned long THREAD_STACK_ALLOCATOR_PAGE_SIZE = 1024 * 1024;
+
 // Rozhrani obecneho alokatoru
 // Allocatory pouzivaji typ unsigned long, vetsinou odpovida typu std::size_t, tedy i sizeof()
+// Alokace se zapocitavaji do tagu aktualniho vlakna v dobe vytvoreni alokatoru (viz ALLOC_SCOPE)
 //
 class Allocator {
 public:
-	Allocator() {}
+	Allocator(): tag( GetAllocationTag() ) {}
 	virtual ~Allocator() {}
 	
 	// neni povoleno vytvaret kopie
@@ -38,14 +80,106 @@ public:
 	
 	// vrati pocet bajtu pameti poskytnute alokatorem, tj. pameti primo vyuzitelne klientem tridy Allocator
 	virtual unsigned long MemoryAllocated() const = 0;
+	
+	// tag, do ktereho se zapocitavaji alokace
+	virtual void SetTag( const AllocationTag tagParam );
+	AllocationTag GetTag() const;
+	
+protected:
+	AllocationTag tag;
 };
 
-// FixedAllocator Alokuje bloky pameti stejne velikosti.
-// Alokovany blok pameti je vzdy 16 byte aligned.
-//
+inline void Allocator::SetTag( const AllocationTag tagParam ) {
+	tag = tagParam;
+}
+
+inline AllocationTag Allocator::GetTag() const {
+	return tag;
+}
+
+/*
+ChunkProvider: zdroj systemove pameti pro chunky alokatoru (FixedAllocator a odvozene alokatory).
+Implementace musi byt thread safe, jeden provider muze pouzivat vice alokatoru.
+*/
+class ChunkProvider {
+public:
+	ChunkProvider() {}
+	virtual ~ChunkProvider() {}
+	
+	// neni povoleno vytvaret kopie
+	ChunkProvider( const ChunkProvider& ) = delete;
+	ChunkProvider &operator=( const ChunkProvider& ) = delete;
+	
+	// vrati blok pameti velikosti bytes zarovnany na alignment (mocnina 2, nejmene 16, nejvyse bytes), pri selhani vraci nullptr
+	virtual void* AllocChunk( const std::size_t bytes, const std::size_t alignment ) = 0;
+	
+	// vrati pamet systemu, bytes musi odpovidat velikosti pozadovane funkci AllocChunk()
+	virtual void FreeChunk( void* const chunk, const std::size_t bytes ) = 0;
+	
+	// Velikost, na kterou provider zaokrouhluje chunky. Alokator muze chunk zvetsit a vyuzit celou stranku.
+	virtual std::size_t GetGranularity() const = 0;
+};
+
+// Vychozi provider. Chunky velikosti mocniny 2 vykrajuje z aren ve virtualni pameti (bez rezie zarovnani), ostatni alokuje na heapu.
+// Objekt neni nikdy znicen.
+ChunkProvider* GetHeapChunkProvider();
+
+/*
+VirtualChunkProvider: rezervuje souvisly rozsah virtualni pameti, fyzicke stranky commituje az pri alokaci chunku.
+FreeChunk() vraci stranky systemu (decommit), rozsah zustava rezervovany pro dalsi chunky.
+Parametr largePages pozaduje huge pages, aby data v poolech zabirala mene polozek TLB:
+- Linux: rozsah je zarovnan na 2 MB a commitovane stranky jsou oznaceny madvise( MADV_HUGEPAGE ) (transparent huge pages)
+- Windows: large pages vyzaduji SeLockMemoryPrivilege a nelze je commitovat postupne, proto se pouziji bezne stranky
+Chunky jsou zaokrouhleny na granularitu providera (2 MB s huge pages, jinak 64 kB).
+*/
+class VirtualChunkProvider: public ChunkProvider {
+public:
+	VirtualChunkProvider( const std::size_t reserveBytes, const bool largePages );
+	~VirtualChunkProvider();
+	
+	// vraci false, pokud se nepodarilo rezervovat virtualni pamet
+	bool IsValid() const;
+	
+	// vrati pocet bajtu commitovane pameti
+	std::size_t GetCommitted() const;
+	
+	// implementace rozhrani ChunkProvider
+	virtual void* AllocChunk( const std::size_t bytes, const std::size_t alignment ) override;
+	virtual void FreeChunk( void* const chunk, const std::size_t bytes ) override;
+	virtual std::size_t GetGranularity() const override;
+	
+private:
+	// pocet stranek potrebnych pro bytes bajtu
+	std::size_t GetPagesCount( const std::size_t bytes ) const;
+	
+private:
+	Byte* base;
+	std::size_t reserved;
+	std::size_t pageSize;
+	std::size_t pagesCount;
+	std::size_t committedPages;
+	bool* pagesUsed;
+	bool hugePages;
+	mutable std::mutex mutex;
+};
+
+/*
+FixedAllocator: alokuje bloky pameti stejne velikosti.
+Bloky nemaji hlavicku, chunky maji velikost mocniny 2 a jsou na ni zarovnany, chunk bloku se zjisti maskovanim adresy.
+Alokovany blok je zarovnan na alignmentParam (mocnina 2, nejmene 16), napr. 64 pro bloky na samostatnych cache lines.
+Chunky alokuje providerParam (nullptr = GetHeapChunkProvider()), velikost chunku je nejmene chunkSizeParam bloku.
+Bloky chunku se inicializuji postupne pri alokaci, nova stranka chunku se tedy zapise az pri prvnim pouziti.
+Alokace prednostne pouzivaji nejvice zaplnene chunky: chunk, ve kterem se uvolni blok, se zaradi na zacatek seznamu,
+zcela prazdne chunky se pouziji az nakonec. Prazdne chunky tak mohou byt vraceny providerovi funkci Flush().
+*/
 class FixedAllocator: public Allocator {
 public:
-	explicit FixedAllocator( const unsigned long blockSizeParam, const unsigned long chunkSizeParam = DEFAULT_ALLOCATOR_CHUNK_SIZE );
+	explicit FixedAllocator(
+		const unsigned long blockSizeParam,
+		const unsigned long chunkSizeParam = DEFAULT_ALLOCATOR_CHUNK_SIZE,
+		ChunkProvider* const providerParam = nullptr,
+		const unsigned long alignmentParam = 16
+	);
 	~FixedAllocator();
 	
 	// vrati ukazatel na blok pameti
@@ -54,6 +188,15 @@ public:
 	// uvolni blok pameti
 	void Free( void* const ptr );
 	
+	// alokuje az count bloku do pole blocks, vraci pocet alokovanych bloku (mensi nez count jen pri nedostatku pameti)
+	unsigned long AllocBatch( void** const blocks, const unsigned long count );
+	
+	// uvolni count bloku z pole blocks
+	void FreeBatch( void* const* const blocks, const unsigned long count );
+	
+	// velikost bloku po zarovnani
+	unsigned long GetBlockSize() const;
+	
 	// implementace rozhrani tridy Allocator
 	virtual void Reserve( const unsigned long bytes );
 	virtual unsigned long Allocated() const;
@@ -62,34 +205,418 @@ public:
 	virtual unsigned long MemoryAllocated() const;
 	
 private:
+	struct Block {
+		Block* next;
+	};
+	
 	struct alignas( 16 ) Chunk {
+		Chunk* prev;
 		Chunk* next;
-		unsigned long count;		// pocet bloku v chunku
+		Block* free;				// uvolnene bloky
+		Byte* untouched;			// bloky od teto adresy jeste nebyly nikdy alokovany
 		unsigned long allocated;	// pocet alokovanych bloku
 	};
 	
+	// seznam chunku, ve kterem je chunk zarazen podle poctu alokovanych bloku
+	static void Unlink( Chunk*& list, Chunk* const chunk );
+	static void PushFront( Chunk*& list, Chunk* const chunk );
+	
+	// vytvori novy prazdny chunk
+	bool Expand();
+	
+	// alokuje blok z chunku, ktery neni plny
+	Block* AllocFromChunk( Chunk* const chunk );
+	
+	// vrati blok do chunku, bez zapocitani do statistik
+	void FreeBlock( void* const ptr );
+	
+	Chunk* GetChunk( const void* const ptr ) const;
+	
+private:
+	ChunkProvider* const provider;
+	Chunk* partial;		// chunky s volnymi i alokovanymi bloky, na zacatku nejvice zaplnene
+	Chunk* full;		// chunky bez volnych bloku
+	Chunk* empty;		// chunky bez alokovanych bloku
+	const unsigned long size;
+	const unsigned long alignment;
+	std::size_t chunkBytes;			// velikost chunku (mocnina 2)
+	unsigned long chunkHeader;		// velikost hlavicky chunku zarovnana na alignment
+	unsigned long blocksPerChunk;
+	unsigned long chunksCount;
+	unsigned long allocated;
+};
+
+/*
+ConcurrentFixedAllocator: lock-free varianta FixedAllocator.
+Volne bloky tvori Treiberuv zasobnik. Hlava zasobniku obsahuje krome ukazatele i generacni tag,
+ktery se zvysi pri kazde zmene hlavy, CAS proto selze i kdyz se mezitim vrati stejny blok (ABA problem).
+Alloc() a Free() muzou volat libovolna vlakna soucasne, napr. loader vlakno alokuje a hlavni vlakno uvolnuje.
+Mutex se zamyka jen pri rozsireni o novy chunk (Expand) a ve funkcich, ktere prochazeji seznam chunku.
+Flush() muze bezet soucasne s Free(), ale ne soucasne s Alloc() (Alloc cte volne bloky, ktere muze Flush uvolnit).
+Bloky jsou zarovnany na alignmentParam (mocnina 2, nejmene 16).
+*/
+class ConcurrentFixedAllocator: public Allocator {
+public:
+	explicit ConcurrentFixedAllocator(
+		const unsigned long blockSizeParam,
+		const unsigned long chunkSizeParam = DEFAULT_ALLOCATOR_CHUNK_SIZE,
+		ChunkProvider* const providerParam = nullptr,
+		const unsigned long alignmentParam = 16
+	);
+	~ConcurrentFixedAllocator();
+	
+	// vrati ukazatel na blok pameti
+	void* Alloc();
+	
+	// uvolni blok pameti
+	void Free( void* const ptr );
+	
+	// velikost bloku po zarovnani
+	unsigned long GetBlockSize() const;
+	
+	// implementace rozhrani tridy Allocator
+	virtual void Reserve( const unsigned long bytes );
+	virtual unsigned long Allocated() const;
+	virtual void Flush();
+	virtual unsigned long MemoryOccupied() const;
+	virtual unsigned long MemoryAllocated() const;
+	
+private:
+	struct alignas( 16 ) Chunk {
+		Chunk* next;
+		unsigned long count;					// pocet bloku v chunku
+		std::atomic< unsigned long > allocated;	// pocet alokovanych bloku
+		unsigned long released;					// pocitadlo volnych bloku pouzivane funkci Flush()
+	};
+	
 	struct alignas( 16 ) Block {
-		Block* next;
+		std::atomic< Block* > next;
 		Chunk* chunk;
 	};
 	
-	// alokuje systemovou pamet pro count bloku
-	void Expand( const unsigned long count );
+	// ukazatel na blok (spodni bity) a generacni tag (horni bity) v jedne 64 bit hodnote
+	using TaggedBlock = uint64_t;
+	
+	static TaggedBlock Tag( Block* const block, const TaggedBlock previous );
+	static Block* Untag( const TaggedBlock tagged );
+	
+	// vlozi retez bloku first...last na vrchol zasobniku
+	void Push( Block* const first, Block* const last );
+	
+	// odebere blok z vrcholu zasobniku, pokud je zasobnik prazdny, vraci nullptr
+	Block* Pop();
+	
+	// alokuje systemovou pamet pro count bloku (mutex musi byt zamcen)
+	bool Expand( const unsigned long count );
+	
+	// velikost chunku s count bloky
+	std::size_t GetChunkBytes( const unsigned long count ) const;
 	
 private:
+	ChunkProvider* const provider;
+	std::atomic< TaggedBlock > free;
+	mutable std::mutex mutex;
 	Chunk* chunks;
-	Block* free;
 	const unsigned long size;
 	const unsigned long chunkSize;
+	const unsigned long alignment;
+	unsigned long stride;			// vzdalenost bloku v chunku (hlavicka a data zarovnana na alignment)
+	unsigned long blocksOffset;		// pozice dat prvniho bloku od zacatku chunku
+};
+
+/*
+ThreadCachedFixedAllocator: thread safe varianta FixedAllocator.
+Kazde vlakno ma vlastni magazin bloku, Alloc() a Free() pracuji bez synchronizace jen s timto magazinem.
+Prazdny magazin se doplni ze sdileneho depa (FixedAllocator chraneny mutexem) po magazineSize blocich,
+plny magazin vrati do depa magazineSize bloku. Blok muze byt uvolnen jinym vlaknem, nez ktere ho alokovalo.
+Pri ukonceni vlakna se bloky jeho magazinu vrati do depa a magazin prevezme dalsi vlakno,
+pocet magazinu tedy odpovida nejvetsimu poctu soucasne bezicich vlaken, ne poctu vsech vlaken.
+Alokace se zapocitavaji pri predani bloku klientovi, ne pri presunu mezi magazinem a depem.
+Flush() a destruktor nesmi byt volany soucasne s Alloc() nebo Free() z jineho vlakna.
+*/
+class ThreadCachedFixedAllocator: public Allocator {
+public:
+	explicit ThreadCachedFixedAllocator(
+		const unsigned long blockSizeParam,
+		const unsigned long chunkSizeParam = DEFAULT_ALLOCATOR_CHUNK_SIZE,
+		ChunkProvider* const providerParam = nullptr,
+		const unsigned long alignmentParam = 16,
+		const unsigned long magazineSizeParam = DEFAULT_MAGAZINE_SIZE
+	);
+	~ThreadCachedFixedAllocator();
+	
+	// vrati ukazatel na blok pameti
+	void* Alloc();
+	
+	// uvolni blok pameti
+	void Free( void* const ptr );
+	
+	// vrati vsechny bloky z magazinu volajiciho vlakna do depa
+	void ReleaseThreadCache();
+	
+	/*
+	Vrati bloky magazinu volajiciho vlakna do dep vsech alokatoru a uvolni magaziny pro jina vlakna.
+	Vola se automaticky pri ukonceni vlakna, vlakno muze alokovat i potom (dostane novy magazin).
+	*/
+	static void ReleaseThreadCaches();
+	
+	// implementace rozhrani tridy Allocator
+	virtual void Reserve( const unsigned long bytes );
+	virtual unsigned long Allocated() const;
+	virtual void Flush();
+	virtual unsigned long MemoryOccupied() const;
+	virtual unsigned long MemoryAllocated() const;
+	
+private:
+	// Magazin jednoho vlakna, pole blocks ma kapacitu 2 * magazineSize
+	struct Magazine {
+		Magazine* next;						// seznam vsech magazinu alokatoru
+		Magazine* nextUnused;				// seznam magazinu ukoncenych vlaken
+		std::atomic< unsigned long > count;	// zapisuje pouze vlastnici vlakno
+		void* blocks[ 1 ];
+	};
+	
+	// vrati magazin volajiciho vlakna, pokud alokator nema cache slot, vraci nullptr
+	Magazine* GetMagazine();
+	
+	// vrati bloky magazinu do depa a zaradi magazin mezi nepouzite
+	void ReleaseMagazine( Magazine* const magazine );
+	
+	// presune count bloku mezi magazinem a depem (mutex musi byt zamcen)
+	void Refill( Magazine* const magazine, const unsigned long count );
+	void Drain( Magazine* const magazine, const unsigned long count );
+	
+private:
+	FixedAllocator depot;
+	mutable std::mutex mutex;
+	Magazine* magazines;
+	Magazine* unusedMagazines;
+	const unsigned long magazineSize;
+	const uint64_t serial;
+	const unsigned long slot;
+};
+
+/*
+FrameAllocator: linearni alokator docasnych dat jednoho snimku (render packety, seznamy viditelnych objektu...).
+Alokace pouze posune ukazatel v aktualnim bufferu, jednotlive bloky se neuvolnuji.
+Alokator ma framesCount rotujicich bufferu, NextFrame() v O(1) prepne na nejstarsi buffer a zacne ho prepisovat.
+Data zapsana ve snimku N jsou tedy platna az do konce snimku N + framesCount - 1 (napr. pro upload do GPU).
+Buffer se sklada ze stranek, pokud stranka nestaci, pripoji se dalsi. Stranky se mezi snimky neuvolnuji.
+Alokovane bloky jsou vzdy 16 byte aligned. Objekt neni thread safe, kazde vlakno potrebuje vlastni instanci.
+Do statistik alokaci se snimek zapocita az ve funkci NextFrame() (hromadne, bez histogramu velikosti).
+*/
+class FrameAllocator: public Allocator {
+public:
+	explicit FrameAllocator(
+		const unsigned long pageSizeParam = DEFAULT_FRAME_ALLOCATOR_PAGE_SIZE,
+		const unsigned long framesCountParam = DEFAULT_FRAME_ALLOCATOR_FRAMES
+	);
+	~FrameAllocator();
+	
+	// vrati ukazatel na blok pameti velikosti bytes, Alloc( 0 ) vraci samostatny blok 16 bajtu (ne nullptr ani ukazatel na nasledujici blok)
+	void* Alloc( const unsigned long bytes );
+	
+	// vrati ukazatel na neinicializovane pole count objektu typu T, destruktory objektu nejsou nikdy volany
+	template <typename T>
+	T* AllocArray( const unsigned long count );
+	
+	// ukonci aktualni snimek, uvolni vsechny bloky alokovane pred framesCount snimky
+	void NextFrame();
+	
+	// implementace rozhrani tridy Allocator
+	virtual void Reserve( const unsigned long bytes );
+	virtual unsigned long Allocated() const;
+	virtual void Flush();
+	virtual unsigned long MemoryOccupied() const;
+	virtual unsigned long MemoryAllocated() const;
+	
+private:
+	struct alignas( 16 ) Page {
+		Page* next;
+		unsigned long size;		// pocet bajtu pouzitelnych pro alokace
+	};
+	
+	struct Arena {
+		Page* first;
+		Page* current;
+		Byte* top;
+		Byte* end;
+		unsigned long allocated;	// pocet alokaci ve snimku
+		unsigned long used;			// pocet alokovanych bajtu ve snimku
+	};
+	
+	// alokace, pro kterou nestaci aktualni stranka
+	void* AllocFromNextPage( const unsigned long bytes );
+	
+	// vytvori stranku s nejmene bytes pouzitelnymi bajty
+	Page* CreatePage( const unsigned long bytes );
+	
+	// nastavi stranku jako aktualni stranku bufferu
+	static void SetCurrentPage( Arena& arena, Page* const page );
+	
+private:
+	Arena arenas[ MAX_FRAME_ALLOCATOR_FRAMES ];
+	const unsigned long pageSize;
+	const unsigned long framesCount;
+	unsigned long frame;
+};
+
+inline void* FrameAllocator::Alloc( const unsigned long bytes ) {
+	// 16 byte alignment, prazdny blok zabira 16 bajtu
+	const unsigned long aligned = bytes != 0 ? ( bytes + 15 ) & ( ~0x0f ) : 16;
+	Arena& arena = arenas[ frame ];
+	if ( static_cast< unsigned long >( arena.end - arena.top ) < aligned ) {
+		return AllocFromNextPage( aligned );
+	}
+	void* ptr = arena.top;
+	arena.top += aligned;
+	arena.allocated += 1;
+	arena.used += aligned;
+	return ptr;
+}
+
+template <typename T>
+inline T* FrameAllocator::AllocArray( const unsigned long count ) {
+	static_assert( alignof( T ) <= 16, "FrameAllocator supports max 16 byte alignment" );
+	return static_cast< T* >( Alloc( count * sizeof( T ) ) );
+}
+
+/*
+StackAllocator: LIFO alokator docasne pameti (nacitani souboru, culling...).
+Alokace pouze posune ukazatel, bloky se uvolnuji najednou k znacce ziskane funkci GetMarker().
+Vnorene znacky musi byt uvolnovany v opacnem poradi, nez byly ziskany (nejlepe pomoci ScopedStackMarker).
+Stranky se pri uvolneni neuvolnuji a jsou pouzity pro dalsi alokace, systemu je vraci az Flush().
+Alokovane bloky jsou vzdy 16 byte aligned. Objekt neni thread safe, kazde vlakno ma vlastni instanci (GetThreadStackAllocator).
+Do statistik alokaci se bloky zapocitaji hromadne (bez histogramu velikosti) pri ziskani znacky, prechodu na dalsi stranku
+a uvolneni funkci FreeToMarker(), spicka tagu tak odpovida skutecne obsazenosti zasobniku.
+High-water mark je nejvetsi pocet soucasne alokovanych bajtu, slouzi k nastaveni velikosti stranek podle realnych dat.
+*/
+class StackAllocator: public Allocator {
+public:
+	// Stav alokatoru, ke kteremu je mozne uvolnit vsechny pozdejsi alokace
+	struct Marker {
+		void* page;
+		Byte* top;
+		unsigned long allocated;
+		unsigned long used;
+	};
+	
+	explicit StackAllocator( const unsigned long pageSizeParam = DEFAULT_STACK_ALLOCATOR_PAGE_SIZE );
+	~StackAllocator();
+	
+	// vrati ukazatel na blok pameti velikosti bytes, Alloc( 0 ) vraci samostatny blok 16 bajtu (ne nullptr ani ukazatel na nasledujici blok)
+	void* Alloc( const unsigned long bytes );
+	
+	// vrati ukazatel na neinicializovane pole count objektu typu T, destruktory objektu nejsou nikdy volany
+	template <typename T>
+	T* AllocArray( const unsigned long count );
+	
+	// vrati znacku aktualniho stavu alokatoru, dosud nezapocitane bloky zapocita do statistik alokaci
+	Marker GetMarker();
+	
+	// uvolni vsechny bloky alokovane po ziskani znacky
+	void FreeToMarker( const Marker& marker );
+	
+	// uvolni vsechny bloky
+	void FreeAll();
+	
+	// nejvetsi pocet soucasne alokovanych bajtu od vytvoreni alokatoru nebo volani ResetHighWaterMark()
+	unsigned long GetHighWaterMark() const;
+	void ResetHighWaterMark();
+	
+	// implementace rozhrani tridy Allocator
+	virtual void Reserve( const unsigned long bytes );
+	virtual unsigned long Allocated() const;
+	virtual void Flush();
+	virtual unsigned long MemoryOccupied() const;
+	virtual unsigned long MemoryAllocated() const;
+	
+private:
+	struct alignas( 16 ) Page {
+		Page* next;
+		unsigned long size;		// pocet bajtu pouzitelnych pro alokace
+	};
+	
+	// alokace, pro kterou nestaci aktualni stranka
+	void* AllocFromNextPage( const unsigned long bytes );
+	
+	// vytvori stranku s nejmene bytes pouzitelnymi bajty
+	Page* CreatePage( const unsigned long bytes );
+	
+	// nastavi stranku jako aktualni stranku
+	void SetCurrentPage( Page* const page );
+	
+	// zapocita do statistik bloky alokovane od posledniho zapoctu
+	void TrackPending();
+	
+private:
+	Page* first;
+	Page* current;
+	Byte* top;
+	Byte* end;
 	unsigned long allocated;
+	unsigned long used;
+	unsigned long trackedAllocated;		// pocet bloku a bajtu jiz zapocitanych do statistik alokaci
+	unsigned long trackedUsed;
+	unsigned long highWaterMark;
+	const unsigned long pageSize;
 };
 
-// Vrati ukazatel na novou instanci objektu typu T, ekvivalent operatoru new a delete
-//
+inline void* StackAllocator::Alloc( const unsigned long bytes ) {
+	// 16 byte alignment, prazdny blok zabira 16 bajtu
+	const unsigned long aligned = bytes != 0 ? ( bytes + 15 ) & ( ~0x0f ) : 16;
+	if ( static_cast< unsigned long >( end - top ) < aligned ) {
+		return AllocFromNextPage( aligned );
+	}
+	void* ptr = top;
+	top += aligned;
+	allocated += 1;
+	used += aligned;
+	return ptr;
+}
+
 template <typename T>
+inline T* StackAllocator::AllocArray( const unsigned long count ) {
+	static_assert( alignof( T ) <= 16, "StackAllocator supports max 16 byte alignment" );
+	return static_cast< T* >( Alloc( count * sizeof( T ) ) );
+}
+
+/*
+ScopedStackMarker: ziska znacku v konstruktoru a uvolni k ni alokator v destruktoru.
+Pouziti:
+	ScopedStackMarker marker( GetThreadStackAllocator() );
+	char* buffer = GetThreadStackAllocator().AllocArray< char >( size );
+*/
+class ScopedStackMarker {
+public:
+	explicit ScopedStackMarker( StackAllocator& allocatorParam );
+	~ScopedStackMarker();
+	
+	// neni povoleno vytvaret kopie
+	ScopedStackMarker( const ScopedStackMarker& ) = delete;
+	ScopedStackMarker& operator=( const ScopedStackMarker& ) = delete;
+	
+private:
+	StackAllocator& allocator;
+	const StackAllocator::Marker marker;
+};
+
+// Vrati StackAllocator aktualniho vlakna, alokator je vytvoren pri prvnim volani a znicen pri ukonceni vlakna
+StackAllocator& GetThreadStackAllocator();
+
+// Nejvetsi high-water mark ze vsech StackAllocatoru, aktualizuje se pri volani FreeToMarker() a zaniku alokatoru
+unsigned long GetStackAllocatorsHighWaterMark();
+
+/*
+Vrati ukazatel na novou instanci objektu typu T, ekvivalent operatoru new a delete.
+Parametr BlockAllocator urcuje alokator bloku (FixedAllocator, ThreadCachedFixedAllocator...),
+musi mit konstruktor ( blockSize, chunkSize, provider, alignment ) a metody Alloc() a Free().
+Bloky jsou zarovnany na alignof( T ), nejmene vsak na 16 bajtu.
+*/
+template <typename T, typename BlockAllocator = FixedAllocator>
 class ObjectAllocator: public Allocator {
 public:
-	explicit ObjectAllocator( const unsigned long chunkSize = DEFAULT_ALLOCATOR_CHUNK_SIZE );
+	explicit ObjectAllocator( const unsigned long chunkSize = DEFAULT_ALLOCATOR_CHUNK_SIZE, ChunkProvider* const provider = nullptr );
 	
 	T* New();
 	void Delete( T* const ptr );
@@ -100,25 +627,26 @@ public:
 	virtual unsigned long Allocated() const;
 	virtual unsigned long MemoryOccupied() const;
 	virtual unsigned long MemoryAllocated() const;
+	virtual void SetTag( const AllocationTag tagParam );
 	
 private:
-	FixedAllocator allocator;
+	BlockAllocator allocator;
 };
 
-template <typename T>
-ObjectAllocator<T>::ObjectAllocator( const unsigned long chunkSize ):
-	allocator( sizeof( T ), chunkSize )
+template <typename T, typename BlockAllocator>
+ObjectAllocator< T, BlockAllocator >::ObjectAllocator( const unsigned long chunkSize, ChunkProvider* const provider ):
+	allocator( sizeof( T ), chunkSize, provider, alignof( T ) > 16 ? alignof( T ) : 16 )
 {
 	// vsechny members jsou inicializovany v member initializer list
 }
 
-template <typename T>
-inline T* ObjectAllocator<T>::New() {
+template <typename T, typename BlockAllocator>
+inline T* ObjectAllocator< T, BlockAllocator >::New() {
 	return new ( allocator.Alloc() ) T();
 }
 
-template <typename T>
-inline void ObjectAllocator<T>::Delete( T* const ptr ) {
+template <typename T, typename BlockAllocator>
+inline void ObjectAllocator< T, BlockAllocator >::Delete( T* const ptr ) {
 	if ( ptr == nullptr ) {
 		return;
 	}
@@ -126,27 +654,33 @@ inline void ObjectAllocator<T>::Delete( T* const ptr ) {
 	allocator.Free( ptr );
 }
 
-template <typename T>
-inline void ObjectAllocator<T>::Reserve( const unsigned long bytes ) {
+template <typename T, typename BlockAllocator>
+inline void ObjectAllocator< T, BlockAllocator >::Reserve( const unsigned long bytes ) {
 	allocator.Reserve( bytes );
 }
 
-template <typename T>
-inline unsigned long ObjectAllocator<T>::Allocated() const {
+template <typename T, typename BlockAllocator>
+inline unsigned long ObjectAllocator< T, BlockAllocator >::Allocated() const {
 	return allocator.Allocated();
 }
 
-template <typename T>
-inline void ObjectAllocator<T>::Flush() {
+template <typename T, typename BlockAllocator>
+inline void ObjectAllocator< T, BlockAllocator >::Flush() {
 	allocator.Flush();
 }
 
-template <typename T>
-inline unsigned long ObjectAllocator<T>::MemoryOccupied() const {
+template <typename T, typename BlockAllocator>
+inline unsigned long ObjectAllocator< T, BlockAllocator >::MemoryOccupied() const {
 	return allocator.MemoryOccupied();
 }
 
-template <typename T>
-inline unsigned long ObjectAllocator<T>::MemoryAllocated() const {
+template <typename T, typename BlockAllocator>
+inline unsigned long ObjectAllocator< T, BlockAllocator >::MemoryAllocated() const {
 	return allocator.MemoryAllocated();
+}
+
+template <typename T, typename BlockAllocator>
+inline void ObjectAllocator< T, BlockAllocator >::SetTag( const AllocationTag tagParam ) {
+	Allocator::SetTag( tagParam );
+	allocator.SetTag( tagParam );
 }
\ No newline at end of file
@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#include "AllocationTrace.h"
+#include "Allocation.h"
+
+std::atomic< bool > allocationTraceActive( false );
+
+#ifdef ALLOCATION_TRACKING
+
+namespace {
+
+	// pocet udalosti v bufferu, buffer je zapsan do souboru az po zaplneni
+	const unsigned long TRACE_BUFFER_SIZE = 4096;
+
+	/*
+	Zamek zaznamu. Nelze pouzit std::mutex, operator delete muze byt volan i po destrukci statickych objektu.
+	Zamek je drzen jen po dobu zapisu udalosti do bufferu, pripadne zapisu plneho bufferu do souboru.
+	*/
+	std::atomic_flag traceLock = ATOMIC_FLAG_INIT;
+
+	std::FILE* traceFile = nullptr;
+	AllocationTraceEvent traceBuffer[ TRACE_BUFFER_SIZE ];
+	unsigned long traceBufferCount = 0;
+	std::atomic< uint32_t > traceThreadsCount( 0 );
+
+	thread_local uint32_t traceThread = 0;
+
+	// zabranuje zaznamu alokaci provedenych behem zaznamu (napr. funkci fwrite)
+	thread_local bool traceRecording = false;
+
+	class TraceLock {
+	public:
+		TraceLock() {
+			while ( traceLock.test_and_set( std::memory_order_acquire ) ) {
+				std::this_thread::yield();
+			}
+		}
+
+		~TraceLock() {
+			traceLock.clear( std::memory_order_release );
+		}
+	};
+
+	void FlushTraceBuffer() {
+		if ( traceBufferCount > 0 ) {
+			std::fwrite( traceBuffer, sizeof( AllocationTraceEvent ), traceBufferCount, traceFile );
+			traceBufferCount = 0;
+		}
+	}
+
+	void Trace( const void* const ptr, const std::size_t size, const AllocationTag tag, const AllocationTraceEventType type ) {
+		if ( traceRecording ) {
+			return;
+		}
+		traceRecording = true;
+		if ( traceThread == 0 ) {
+			traceThread = traceThreadsCount.fetch_add( 1, std::memory_order_relaxed ) + 1;
+		}
+		{
+			TraceLock lock;
+
+			// zaznam mohl byt mezitim ukoncen
+			if ( traceFile != nullptr ) {
+				AllocationTraceEvent& event = traceBuffer[ traceBufferCount ];
+				event.address = reinterpret_cast< uint64_t >( ptr );
+				event.size = size;
+				event.thread = traceThread;
+				event.type = type;
+				event.tag = tag;
+				traceBufferCount += 1;
+				if ( traceBufferCount == TRACE_BUFFER_SIZE ) {
+					FlushTraceBuffer();
+				}
+			}
+		}
+		traceRecording = false;
+	}
+}
+
+bool StartAllocationTrace( const char* const path ) {
+	traceRecording = true;
+	bool result = false;
+	{
+		TraceLock lock;
+		if ( traceFile == nullptr ) {
+			traceFile = std::fopen( path, "wb" );
+			if ( traceFile != nullptr ) {
+				AllocationTraceHeader header = {};
+				header.magic = ALLOCATION_TRACE_MAGIC;
+				header.version = ALLOCATION_TRACE_VERSION;
+				header.eventSize = sizeof( AllocationTraceEvent );
+				std::fwrite( &header, sizeof( AllocationTraceHeader ), 1, traceFile );
+				traceBufferCount = 0;
+				allocationTraceActive.store( true, std::memory_order_relaxed );
+				result = true;
+			}
+		}
+	}
+	traceRecording = false;
+	return result;
+}
+
+void StopAllocationTrace() {
+	traceRecording = true;
+	{
+		TraceLock lock;
+		allocationTraceActive.store( false, std::memory_order_relaxed );
+		if ( traceFile != nullptr ) {
+			FlushTraceBuffer();
+			std::fclose( traceFile );
+			traceFile = nullptr;
+		}
+	}
+	traceRecording = false;
+}
+
+void TraceAllocation( const void* const ptr, const std::size_t size, const AllocationTag tag ) {
+	Trace( ptr, size, tag, AllocationTraceEventType::ALLOC );
+}
+
+void TraceFree( const void* const ptr, const std::size_t size, const AllocationTag tag ) {
+	Trace( ptr, size, tag, AllocationTraceEventType::FREE );
+}
+
+#else
+
+bool StartAllocationTrace( const char* const ) {
+	return false;
+}
+
+void StopAllocationTrace() {}
+
+#endif // ALLOCATION_TRACKING
+
+// class AllocationTrace
+
+AllocationTrace::AllocationTrace() {
+	slotsCount = 0;
+}
+
+bool AllocationTrace::Load( const char* const path ) {
+	operations.clear();
+	slotsCount = 0;
+
+	std::FILE* const file = std::fopen( path, "rb" );
+	if ( file == nullptr ) {
+		return false;
+	}
+	AllocationTraceHeader header;
+	if (
+		std::fread( &header, sizeof( AllocationTraceHeader ), 1, file ) != 1 ||
+		header.magic != ALLOCATION_TRACE_MAGIC ||
+		header.version != ALLOCATION_TRACE_VERSION ||
+		header.eventSize != sizeof( AllocationTraceEvent )
+	) {
+		std::fclose( file );
+		return false;
+	}
+
+	// prevod adres na sloty
+	std::unordered_map< uint64_t, uint32_t > slots;
+	std::vector< uint32_t > freeSlots;
+
+	std::vector< AllocationTraceEvent > events( 4096 );
+	for ( ;; ) {
+		const std::size_t count = std::fread( events.data(), sizeof( AllocationTraceEvent ), events.size(), file );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			const AllocationTraceEvent& event = events[ i ];
+			Operation operation;
+			if ( event.type == AllocationTraceEventType::ALLOC ) {
+				if ( freeSlots.empty() ) {
+					operation.slot = static_cast< uint32_t >( slotsCount );
+					slotsCount += 1;
+				} else {
+					operation.slot = freeSlots.back();
+					freeSlots.pop_back();
+				}
+				operation.size = static_cast< uint32_t >( std::min< uint64_t >( event.size, FREE_OPERATION - 1 ) );
+
+				// uvolneni bloku nemusi byt zaznamenano (napr. alokator mimo operator new), puvodni slot se uz nepouzije
+				slots[ event.address ] = operation.slot;
+			} else {
+				const auto slot = slots.find( event.address );
+				if ( slot == slots.end() ) {
+					continue;
+				}
+				operation.slot = slot->second;
+				operation.size = FREE_OPERATION;
+				freeSlots.push_back( slot->second );
+				slots.erase( slot );
+			}
+			operations.push_back( operation );
+		}
+		if ( count < events.size() ) {
+			break;
+		}
+	}
+	const bool error = std::ferror( file ) != 0;
+	std::fclose( file );
+	return !error;
+}
+
+const AllocationTrace::Operation* AllocationTrace::GetOperations() const {
+	return operations.data();
+}
+
+unsigned long AllocationTrace::GetOperationsCount() const {
+	return static_cast< unsigned long >( operations.size() );
+}
+
+unsigned long AllocationTrace::GetSlotsCount() const {
+	return slotsCount;
+}
+
+// class AllocationReplayTarget
+
+std::size_t AllocationReplayTarget::GetMemoryOccupied() const {
+	return 0;
+}
+
+void AllocationReplayTarget::Flush() {}
+
+// class HeapReplayTarget
+
+HeapReplayTarget::HeapReplayTarget() {
+	largeBytes = 0;
+}
+
+// operator new pri nedostatku pameti vraci nullptr
+void* HeapReplayTarget::Alloc( const std::size_t size ) {
+	void* const ptr = ::operator new( size );
+	if ( ptr != nullptr && size > SMALL_ALLOCATION_MAX_SIZE ) {
+		largeBytes += size;
+	}
+	return ptr;
+}
+
+void HeapReplayTarget::Free( void* const ptr, const std::size_t size ) {
+	if ( size > SMALL_ALLOCATION_MAX_SIZE ) {
+		largeBytes -= size;
+	}
+	::operator delete( ptr, size );
+}
+
+std::size_t HeapReplayTarget::GetMemoryOccupied() const {
+	return GetSmallAllocationsMemoryOccupied() + largeBytes;
+}
+
+// class SystemReplayTarget
+
+void* SystemReplayTarget::Alloc( const std::size_t size ) {
+	return std::malloc( size );
+}
+
+void SystemReplayTarget::Free( void* const ptr, const std::size_t ) {
+	std::free( ptr );
+}
+
+// class PoolReplayTarget
+
+PoolReplayTarget::PoolReplayTarget( const unsigned long chunkSize ) {
+	largeBytes = 0;
+	for ( std::size_t size = 16; size <= SMALL_ALLOCATION_MAX_SIZE; size += 16 ) {
+		pools.emplace_back( new FixedAllocator( static_cast< unsigned long >( size ), chunkSize ) );
+	}
+}
+
+PoolReplayTarget::~PoolReplayTarget() {}
+
+void* PoolReplayTarget::Alloc( const std::size_t size ) {
+	if ( size > SMALL_ALLOCATION_MAX_SIZE ) {
+		void* const ptr = std::malloc( size );
+		if ( ptr != nullptr ) {
+			largeBytes += size;
+		}
+		return ptr;
+	}
+	return pools[ size == 0 ? 0 : ( size - 1 ) / 16 ]->Alloc();
+}
+
+void PoolReplayTarget::Free( void* const ptr, const std::size_t size ) {
+	if ( size > SMALL_ALLOCATION_MAX_SIZE ) {
+		largeBytes -= size;
+		std::free( ptr );
+		return;
+	}
+	pools[ size == 0 ? 0 : ( size - 1 ) / 16 ]->Free( ptr );
+}
+
+std::size_t PoolReplayTarget::GetMemoryOccupied() const {
+	std::size_t bytes = largeBytes;
+	for ( const auto& pool : pools ) {
+		bytes += pool->MemoryOccupied();
+	}
+	return bytes;
+}
+
+void PoolReplayTarget::Flush() {
+	for ( auto& pool : pools ) {
+		pool->Flush();
+	}
+}
+
+// ReplayAllocationTrace
+
+namespace {
+
+	void GetLatency( std::vector< uint32_t >& samples, AllocationLatency& result ) {
+		result = AllocationLatency();
+		if ( samples.empty() ) {
+			return;
+		}
+		std::sort( samples.begin(), samples.end() );
+		const std::size_t last = samples.size() - 1;
+		result.p50 = samples[ last * 500 / 1000 ];
+		result.p90 = samples[ last * 900 / 1000 ];
+		result.p99 = samples[ last * 990 / 1000 ];
+		result.p999 = samples[ last * 999 / 1000 ];
+		result.max = samples[ last ];
+	}
+
+	inline uint32_t GetNanoseconds( const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end ) {
+		return static_cast< uint32_t >( std::chrono::duration_cast< std::chrono::nanoseconds >( end - start ).count() );
+	}
+}
+
+void ReplayAllocationTrace( const AllocationTrace& trace, AllocationReplayTarget& target, AllocationReplayStats& result, const bool measureLatency ) {
+	result = AllocationReplayStats();
+
+	const AllocationTrace::Operation* const operations = trace.GetOperations();
+	const unsigned long count = trace.GetOperationsCount();
+
+	// vsechna pamet pro prehravani je alokovana predem
+	std::vector< void* > blocks( trace.GetSlotsCount(), nullptr );
+	std::vector< uint32_t > sizes( trace.GetSlotsCount(), 0 );
+	std::vector< uint32_t > allocSamples;
+	std::vector< uint32_t > freeSamples;
+	if ( measureLatency ) {
+		allocSamples.reserve( count );
+		freeSamples.reserve( count );
+	}
+
+	uint64_t liveBytes = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for ( unsigned long i = 0; i < count; i++ ) {
+		const AllocationTrace::Operation& operation = operations[ i ];
+		if ( operation.size == AllocationTrace::FREE_OPERATION ) {
+			void* const block = blocks[ operation.slot ];
+			if ( block == nullptr ) {
+				continue;
+			}
+			if ( measureLatency ) {
+				const auto begin = std::chrono::steady_clock::now();
+				target.Free( block, sizes[ operation.slot ] );
+				freeSamples.push_back( GetNanoseconds( begin, std::chrono::steady_clock::now() ) );
+			} else {
+				target.Free( block, sizes[ operation.slot ] );
+			}
+			blocks[ operation.slot ] = nullptr;
+			liveBytes -= sizes[ operation.slot ];
+			result.frees += 1;
+			continue;
+		}
+
+		// blok, jehoz uvolneni nebylo zaznamenano
+		if ( blocks[ operation.slot ] != nullptr ) {
+			target.Free( blocks[ operation.slot ], sizes[ operation.slot ] );
+			liveBytes -= sizes[ operation.slot ];
+		}
+		void* block = nullptr;
+		if ( measureLatency ) {
+			const auto begin = std::chrono::steady_clock::now();
+			block = target.Alloc( operation.size );
+			allocSamples.push_back( GetNanoseconds( begin, std::chrono::steady_clock::now() ) );
+		} else {
+			block = target.Alloc( operation.size );
+		}
+		blocks[ operation.slot ] = block;
+		sizes[ operation.slot ] = operation.size;
+		if ( block == nullptr ) {
+			result.failedAllocations += 1;
+			continue;
+		}
+		liveBytes += operation.size;
+		result.peakLiveBytes = std::max( result.peakLiveBytes, liveBytes );
+		result.allocations += 1;
+	}
+	result.seconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - start ).count();
+	result.operationsPerSecond = result.seconds > 0 ? static_cast< double >( result.allocations + result.frees ) / result.seconds : 0;
+
+	result.endLiveBytes = liveBytes;
+	result.endOccupiedBytes = target.GetMemoryOccupied();
+	for ( std::size_t i = 0; i < blocks.size(); i++ ) {
+		if ( blocks[ i ] != nullptr ) {
+			target.Free( blocks[ i ], sizes[ i ] );
+		}
+	}
+	target.Flush();
+	result.flushedOccupiedBytes = target.GetMemoryOccupied();
+
+	GetLatency( allocSamples, result.allocLatency );
+	GetLatency( freeSamples, result.freeLatency );
+}
\ No newline at end of file
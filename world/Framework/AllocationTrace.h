@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "AllocationTracking.h"
+
+class FixedAllocator;
+
+/*
+Zaznam alokaci globalniho operatoru new do binarniho souboru.
+Soubor obsahuje hlavicku AllocationTraceHeader a posloupnost udalosti AllocationTraceEvent v poradi, v jakem probehly
+(udalosti vsech vlaken jsou serializovany zamkem). Zaznam slouzi k prehrani realne zateze proti ruznym alokatorum.
+Zaznam je dostupny jen pri zapnutem sledovani alokaci (ALLOCATION_TRACKING), jinak StartAllocationTrace() vraci false.
+Pokud zaznam neprobiha, stoji kazda alokace jen jedno cteni atomicke promenne.
+*/
+
+const uint32_t ALLOCATION_TRACE_MAGIC = 0x52544157;	// "WATR"
+const uint32_t ALLOCATION_TRACE_VERSION = 1;
+
+enum class AllocationTraceEventType: uint8_t {
+	ALLOC = 0,
+	FREE
+};
+
+struct AllocationTraceHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t eventSize;		// sizeof( AllocationTraceEvent )
+	uint32_t reserved;
+};
+
+struct AllocationTraceEvent {
+	uint64_t address;		// adresa bloku, slouzi jen k parovani alokace a uvolneni
+	uint64_t size;			// pozadovana velikost bloku
+	uint32_t thread;		// poradove cislo vlakna v ramci zaznamu
+	AllocationTraceEventType type;
+	AllocationTag tag;
+};
+
+static_assert( sizeof( AllocationTraceEvent ) == 24, "AllocationTraceEvent layout is part of the trace file format" );
+
+// zahaji zaznam do souboru, vraci false pokud zaznam uz probiha nebo soubor nelze vytvorit
+bool StartAllocationTrace( const char* const path );
+
+// ukonci zaznam a zavre soubor
+void StopAllocationTrace();
+
+// interni stav zaznamu, pouzivat IsAllocationTraceActive()
+extern std::atomic< bool > allocationTraceActive;
+
+inline bool IsAllocationTraceActive() {
+	return allocationTraceActive.load( std::memory_order_relaxed );
+}
+
+// zaznam udalosti, vola globalni operator new a delete (pouze pokud IsAllocationTraceActive() vraci true)
+#ifdef ALLOCATION_TRACKING
+void TraceAllocation( const void* const ptr, const std::size_t size, const AllocationTag tag );
+void TraceFree( const void* const ptr, const std::size_t size, const AllocationTag tag );
+#else
+inline void TraceAllocation( const void* const, const std::size_t, const AllocationTag ) {}
+inline void TraceFree( const void* const, const std::size_t, const AllocationTag ) {}
+#endif
+
+/*
+AllocationTrace: zaznam nacteny pro prehravani.
+Adresy bloku jsou pri nacteni prevedeny na indexy slotu (uvolnene sloty jsou znovu pouzity),
+pocet slotu tedy odpovida nejvetsimu poctu soucasne alokovanych bloku.
+Uvolneni bloku alokovanych pred zahajenim zaznamu jsou vynechana.
+*/
+class AllocationTrace {
+public:
+	// hodnota Operation::size pro uvolneni bloku
+	static const uint32_t FREE_OPERATION = 0xffffffff;
+
+	struct Operation {
+		uint32_t slot;
+		uint32_t size;		// velikost alokace nebo FREE_OPERATION
+	};
+
+	AllocationTrace();
+
+	// nacte soubor vytvoreny funkci StartAllocationTrace(), vraci false pri chybe cteni nebo neplatnem formatu
+	bool Load( const char* const path );
+
+	const Operation* GetOperations() const;
+	unsigned long GetOperationsCount() const;
+	unsigned long GetSlotsCount() const;
+
+private:
+	std::vector< Operation > operations;
+	unsigned long slotsCount;
+};
+
+/*
+AllocationReplayTarget: alokator, proti kteremu se prehrava zaznam.
+GetMemoryOccupied() vraci pocet bajtu systemove pameti obsazene alokatorem, 0 pokud ji nelze zjistit.
+*/
+class AllocationReplayTarget {
+public:
+	virtual ~AllocationReplayTarget() {}
+	virtual void* Alloc( const std::size_t size ) = 0;
+	virtual void Free( void* const ptr, const std::size_t size ) = 0;
+	virtual std::size_t GetMemoryOccupied() const;
+	virtual void Flush();
+};
+
+/*
+Globalni operator new a delete (size class pooly).
+GetMemoryOccupied() vraci pamet vsech poolu operatoru new (i alokace mimo prehravani) a velikost LARGE alokaci.
+*/
+class HeapReplayTarget: public AllocationReplayTarget {
+public:
+	HeapReplayTarget();
+
+	virtual void* Alloc( const std::size_t size );
+	virtual void Free( void* const ptr, const std::size_t size );
+	virtual std::size_t GetMemoryOccupied() const;
+
+private:
+	std::size_t largeBytes;
+};
+
+// std::malloc a std::free, referencni hodnoty
+class SystemReplayTarget: public AllocationReplayTarget {
+public:
+	virtual void* Alloc( const std::size_t size );
+	virtual void Free( void* const ptr, const std::size_t size );
+};
+
+// FixedAllocator pro kazdou 16 bajtovou size class do SMALL_ALLOCATION_MAX_SIZE, vetsi bloky std::malloc
+class PoolReplayTarget: public AllocationReplayTarget {
+public:
+	explicit PoolReplayTarget( const unsigned long chunkSize = 256 );
+	~PoolReplayTarget();
+
+	virtual void* Alloc( const std::size_t size );
+	virtual void Free( void* const ptr, const std::size_t size );
+	virtual std::size_t GetMemoryOccupied() const;
+	virtual void Flush();
+
+private:
+	std::vector< std::unique_ptr< FixedAllocator > > pools;
+	std::size_t largeBytes;
+};
+
+// latence v nanosekundach
+struct AllocationLatency {
+	double p50;
+	double p90;
+	double p99;
+	double p999;
+	double max;
+};
+
+struct AllocationReplayStats {
+	uint64_t allocations;
+	uint64_t frees;
+	uint64_t failedAllocations;
+	double seconds;					// celkova doba prehravani (vcetne mereni latenci)
+	double operationsPerSecond;
+	AllocationLatency allocLatency;	// pouze pokud bylo mereni latenci zapnuto
+	AllocationLatency freeLatency;
+	uint64_t peakLiveBytes;			// nejvetsi soucet velikosti soucasne alokovanych bloku
+	uint64_t endLiveBytes;			// bloky alokovane na konci zaznamu
+	uint64_t endOccupiedBytes;		// pamet obsazena alokatorem na konci zaznamu (fragmentace = endOccupiedBytes / endLiveBytes)
+	uint64_t flushedOccupiedBytes;	// pamet obsazena po uvolneni vsech bloku a volani Flush()
+};
+
+/*
+Prehraje zaznam proti alokatoru target v jednom vlakne, v poradi zaznamu.
+Pri measureLatency je mereno kazde volani Alloc() a Free() zvlast, mereni zvysuje celkovou dobu prehravani.
+Bloky alokovane na konci zaznamu jsou uvolneny a na target je zavolana funkce Flush().
+*/
+void ReplayAllocationTrace( const AllocationTrace& trace, AllocationReplayTarget& target, AllocationReplayStats& result, const bool measureLatency = true );
\ No newline at end of file
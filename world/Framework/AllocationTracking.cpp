@@ -0,0 +1,269 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "AllocationTracking.h"
+
+namespace {
+
+	thread_local AllocationTag threadTag = AllocationTag::DEFAULT;
+}
+
+AllocationTag GetAllocationTag() {
+	return threadTag;
+}
+
+// class AllocationScope
+
+AllocationScope::AllocationScope( const AllocationTag tag ) {
+	previous = threadTag;
+	threadTag = tag;
+}
+
+AllocationScope::~AllocationScope() {
+	threadTag = previous;
+}
+
+#ifdef ALLOCATION_TRACKING
+
+namespace {
+
+	struct TagCounters {
+		std::atomic< uint64_t > allocations;
+		std::atomic< uint64_t > frees;
+		std::atomic< uint64_t > allocatedBytes;
+		std::atomic< uint64_t > freedBytes;
+		std::atomic< uint64_t > histogram[ ALLOCATION_HISTOGRAM_SIZE ];
+		std::atomic< int64_t > pendingBytes;	// zmena zivych bajtu, ktera jeste nebyla zverejnena
+	};
+
+	/*
+	Pocitadla jednoho vlakna. Do pocitadel zapisuje vzdy jen jedno vlakno, zapis je proto jen load + store bez lock prefixu.
+	Po ukonceni vlakna pocitadla prevezme jine vlakno, hodnoty se nenuluji (snapshot scita vsechna pocitadla).
+	*/
+	struct ThreadCounters {
+		ThreadCounters* next;
+		std::atomic< bool > used;
+		TagCounters tags[ ALLOCATION_TAGS_COUNT ];
+	};
+
+	// seznam pocitadel vsech vlaken, polozky nejsou nikdy odstraneny
+	std::atomic< ThreadCounters* > threadCountersList( nullptr );
+
+	// pocitadla pro alokace behem destrukce thread_local objektu ukoncovaneho vlakna (zapisuje vice vlaken)
+	TagCounters exitedThreadsCounters[ ALLOCATION_TAGS_COUNT ];
+
+	// zive bajty zverejnene vlakny a jejich nejvetsi hodnota (peakBytes) pro kazdy tag
+	std::atomic< int64_t > liveBytes[ ALLOCATION_TAGS_COUNT ];
+	std::atomic< int64_t > peaks[ ALLOCATION_TAGS_COUNT ];
+	
+	inline void UpdatePeak( const int tag, const int64_t live ) {
+		int64_t peak = peaks[ tag ].load( std::memory_order_relaxed );
+		while ( live > peak && !peaks[ tag ].compare_exchange_weak( peak, live, std::memory_order_relaxed ) ) {}
+	}
+	
+	// pricte zmenu zivych bajtu ke sdilenemu pocitadlu tagu a aktualizuje spicku
+	void PublishLiveBytes( const int tag, const int64_t bytes ) {
+		UpdatePeak( tag, liveBytes[ tag ].fetch_add( bytes, std::memory_order_relaxed ) + bytes );
+	}
+	
+	// zmena zivych bajtu vlakna, do sdileneho pocitadla se zapise az po ALLOCATION_PEAK_GRANULARITY bajtech
+	inline void AddPendingBytes( TagCounters* const counters, const int tag, const int64_t bytes ) {
+		const int64_t pending = counters->pendingBytes.load( std::memory_order_relaxed ) + bytes;
+		if ( pending < ALLOCATION_PEAK_GRANULARITY && pending > -ALLOCATION_PEAK_GRANULARITY ) {
+			counters->pendingBytes.store( pending, std::memory_order_relaxed );
+			return;
+		}
+		counters->pendingBytes.store( 0, std::memory_order_relaxed );
+		PublishLiveBytes( tag, pending );
+	}
+	
+	// zverejni zbyvajici zmeny ukoncovaneho vlakna
+	void PublishPendingBytes( ThreadCounters* const counters ) {
+		for ( int i = 0; i < ALLOCATION_TAGS_COUNT; i++ ) {
+			const int64_t pending = counters->tags[ i ].pendingBytes.exchange( 0, std::memory_order_relaxed );
+			if ( pending != 0 ) {
+				PublishLiveBytes( i, pending );
+			}
+		}
+	}
+
+	thread_local ThreadCounters* threadCounters = nullptr;
+	thread_local bool threadExited = false;
+
+	// Pri ukonceni vlakna uvolni pocitadla pro dalsi vlakna
+	struct ThreadCountersOwner {
+		~ThreadCountersOwner() {
+			if ( threadCounters != nullptr ) {
+				PublishPendingBytes( threadCounters );
+				threadCounters->used.store( false, std::memory_order_release );
+				threadCounters = nullptr;
+			}
+			threadExited = true;
+		}
+	};
+
+	thread_local ThreadCountersOwner threadCountersOwner;
+
+	ThreadCounters* AcquireThreadCounters() {
+		// pouzit pocitadla ukonceneho vlakna
+		for ( ThreadCounters* counters = threadCountersList.load( std::memory_order_acquire ); counters != nullptr; counters = counters->next ) {
+			bool used = false;
+			if ( counters->used.compare_exchange_strong( used, true, std::memory_order_acquire, std::memory_order_relaxed ) ) {
+				return counters;
+			}
+		}
+		// pocitadla nesmi byt alokovana operatorem new, funkce je volana z jeho implementace
+		void* const storage = std::calloc( 1, sizeof( ThreadCounters ) );
+		if ( storage == nullptr ) {
+			return nullptr;
+		}
+		ThreadCounters* const counters = new ( storage ) ThreadCounters();
+		counters->used.store( true, std::memory_order_relaxed );
+		ThreadCounters* head = threadCountersList.load( std::memory_order_relaxed );
+		do {
+			counters->next = head;
+		} while ( !threadCountersList.compare_exchange_weak( head, counters, std::memory_order_release, std::memory_order_relaxed ) );
+		return counters;
+	}
+
+	// vrati pocitadla tagu aktualniho vlakna, pro ukoncene vlakno vraci nullptr
+	inline TagCounters* GetThreadCounters( const AllocationTag tag ) {
+		ThreadCounters* counters = threadCounters;
+		if ( counters == nullptr ) {
+			if ( threadExited ) {
+				return nullptr;
+			}
+			counters = AcquireThreadCounters();
+			if ( counters == nullptr ) {
+				return nullptr;
+			}
+			threadCounters = counters;
+
+			// prvni pouziti thread_local objektu zaregistruje jeho destruktor
+			static_cast< void >( &threadCountersOwner );
+		}
+		return &counters->tags[ static_cast< int >( tag ) ];
+	}
+
+	inline int GetHistogramIndex( const std::size_t bytes ) {
+		int index = 0;
+		std::size_t limit = 16;
+		while ( bytes > limit && index < ALLOCATION_HISTOGRAM_SIZE - 1 ) {
+			limit <<= 1;
+			index += 1;
+		}
+		return index;
+	}
+
+	// pricte hodnotu k pocitadlu, do ktereho zapisuje jen jedno vlakno
+	inline void Add( std::atomic< uint64_t >& counter, const uint64_t value ) {
+		counter.store( counter.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+	}
+
+	void Track( const AllocationTag tag, const std::size_t bytes, const std::size_t count, const bool allocation, const bool histogram ) {
+		if ( tag >= AllocationTag::COUNT ) {
+			return;
+		}
+		TagCounters* const counters = GetThreadCounters( tag );
+
+		// ukoncene vlakno
+		if ( counters == nullptr ) {
+			TagCounters& shared = exitedThreadsCounters[ static_cast< int >( tag ) ];
+			if ( allocation ) {
+				shared.allocations.fetch_add( count, std::memory_order_relaxed );
+				shared.allocatedBytes.fetch_add( bytes, std::memory_order_relaxed );
+				PublishLiveBytes( static_cast< int >( tag ), static_cast< int64_t >( bytes ) );
+			} else {
+				shared.frees.fetch_add( count, std::memory_order_relaxed );
+				shared.freedBytes.fetch_add( bytes, std::memory_order_relaxed );
+				PublishLiveBytes( static_cast< int >( tag ), -static_cast< int64_t >( bytes ) );
+			}
+			return;
+		}
+		if ( allocation ) {
+			Add( counters->allocations, count );
+			Add( counters->allocatedBytes, bytes );
+			if ( histogram ) {
+				Add( counters->histogram[ GetHistogramIndex( bytes ) ], 1 );
+			}
+			AddPendingBytes( counters, static_cast< int >( tag ), static_cast< int64_t >( bytes ) );
+		} else {
+			Add( counters->frees, count );
+			Add( counters->freedBytes, bytes );
+			AddPendingBytes( counters, static_cast< int >( tag ), -static_cast< int64_t >( bytes ) );
+		}
+	}
+
+	void Accumulate( const TagCounters* const counters, AllocationSnapshot& result ) {
+		for ( int i = 0; i < ALLOCATION_TAGS_COUNT; i++ ) {
+			AllocationTagStats& stats = result.tags[ i ];
+			stats.allocations += counters[ i ].allocations.load( std::memory_order_relaxed );
+			stats.frees += counters[ i ].frees.load( std::memory_order_relaxed );
+			stats.allocatedBytes += counters[ i ].allocatedBytes.load( std::memory_order_relaxed );
+			stats.freedBytes += counters[ i ].freedBytes.load( std::memory_order_relaxed );
+			for ( int j = 0; j < ALLOCATION_HISTOGRAM_SIZE; j++ ) {
+				stats.histogram[ j ] += counters[ i ].histogram[ j ].load( std::memory_order_relaxed );
+			}
+		}
+	}
+}
+
+void TrackAllocation( const AllocationTag tag, const std::size_t bytes ) {
+	Track( tag, bytes, 1, true, true );
+}
+
+void TrackFree( const AllocationTag tag, const std::size_t bytes ) {
+	Track( tag, bytes, 1, false, false );
+}
+
+void TrackAllocations( const AllocationTag tag, const std::size_t bytes, const std::size_t count ) {
+	Track( tag, bytes, count, true, false );
+}
+
+void TrackFrees( const AllocationTag tag, const std::size_t bytes, const std::size_t count ) {
+	Track( tag, bytes, count, false, false );
+}
+
+#endif // ALLOCATION_TRACKING
+
+void GetAllocationSnapshot( AllocationSnapshot& result ) {
+	std::memset( &result, 0, sizeof( AllocationSnapshot ) );
+	result.time = std::chrono::duration< double >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+
+#ifdef ALLOCATION_TRACKING
+	for ( ThreadCounters* counters = threadCountersList.load( std::memory_order_acquire ); counters != nullptr; counters = counters->next ) {
+		Accumulate( counters->tags, result );
+	}
+	Accumulate( exitedThreadsCounters, result );
+
+	for ( int i = 0; i < ALLOCATION_TAGS_COUNT; i++ ) {
+		AllocationTagStats& stats = result.tags[ i ];
+		stats.liveBytes = static_cast< int64_t >( stats.allocatedBytes - stats.freedBytes );
+
+		// presna hodnota snapshotu muze prekrocit spicku zverejnenych zmen
+		UpdatePeak( i, stats.liveBytes );
+		stats.peakBytes = peaks[ i ].load( std::memory_order_relaxed );
+	}
+#endif
+}
+
+void GetAllocationDelta( const AllocationSnapshot& previous, const AllocationSnapshot& current, AllocationSnapshot& result ) {
+	result.time = current.time - previous.time;
+	for ( int i = 0; i < ALLOCATION_TAGS_COUNT; i++ ) {
+		const AllocationTagStats& prev = previous.tags[ i ];
+		const AllocationTagStats& curr = current.tags[ i ];
+		AllocationTagStats& stats = result.tags[ i ];
+		stats.allocations = curr.allocations - prev.allocations;
+		stats.frees = curr.frees - prev.frees;
+		stats.allocatedBytes = curr.allocatedBytes - prev.allocatedBytes;
+		stats.freedBytes = curr.freedBytes - prev.freedBytes;
+		stats.liveBytes = curr.liveBytes;
+		stats.peakBytes = curr.peakBytes;
+		stats.allocationsPerSecond = result.time > 0 ? static_cast< double >( stats.allocations ) / result.time : 0;
+		for ( int j = 0; j < ALLOCATION_HISTOGRAM_SIZE; j++ ) {
+			stats.histogram[ j ] = curr.histogram[ j ] - prev.histogram[ j ];
+		}
+	}
+}
\ No newline at end of file
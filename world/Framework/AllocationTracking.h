@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+// Sledovani alokaci je mozne vypnout definici DISABLE_ALLOCATION_TRACKING
+#ifndef DISABLE_ALLOCATION_TRACKING
+#define ALLOCATION_TRACKING
+#endif
+
+/*
+Kategorie alokaci, do kterych se zapocitava spotreba pameti.
+Alokace s tagem UNTRACKED se nezapocitavaji (interni alokatory, jejichz pamet uz zapocital jiny alokator).
+*/
+enum class AllocationTag: uint16_t {
+	DEFAULT = 0,
+	FRAMEWORK,
+	PLATFORM,
+	RENDERER,
+	RESOURCES,
+	SCENE,
+	COUNT,
+	UNTRACKED = COUNT
+};
+
+const int ALLOCATION_TAGS_COUNT = static_cast< int >( AllocationTag::COUNT );
+
+// Histogram velikosti alokaci, interval i obsahuje alokace do velikosti ( 16 << i ), posledni interval vsechny vetsi
+const int ALLOCATION_HISTOGRAM_SIZE = 16;
+
+// Vlakno zverejni zmenu svych zivych bajtu tagu az po dosazeni teto hodnoty (viz AllocationTagStats::peakBytes)
+const int64_t ALLOCATION_PEAK_GRANULARITY = 4 * 1024;
+
+/*
+Statistiky jednoho tagu.
+Pocitadla jsou kumulativni od startu aplikace, v delte (GetAllocationDelta) obsahuji jen prirustek za interval.
+peakBytes je nejvetsi hodnota liveBytes od startu aplikace, sleduje se pri alokaci i mezi snapshoty.
+Kazde vlakno pricita zmenu zivych bajtu do sdileneho pocitadla po ALLOCATION_PEAK_GRANULARITY bajtech,
+spicka tedy muze byt podhodnocena nejvyse o ALLOCATION_PEAK_GRANULARITY na kazde alokujici vlakno.
+*/
+struct AllocationTagStats {
+	uint64_t allocations;
+	uint64_t frees;
+	uint64_t allocatedBytes;
+	uint64_t freedBytes;
+	int64_t liveBytes;
+	int64_t peakBytes;
+	double allocationsPerSecond;	// pouze v delte
+	uint64_t histogram[ ALLOCATION_HISTOGRAM_SIZE ];
+};
+
+struct AllocationSnapshot {
+	double time;	// cas snapshotu v sekundach, v delte delka intervalu
+	AllocationTagStats tags[ ALLOCATION_TAGS_COUNT ];
+};
+
+/*
+Vrati soucet pocitadel vsech vlaken. Funkce nezamyka, muze byt volana kazdy snimek (napr. profilerem).
+Pocitadla jednotlivych vlaken jsou ctena bez synchronizace, snapshot tedy nemusi byt konzistentni mezi tagy.
+*/
+void GetAllocationSnapshot( AllocationSnapshot& result );
+
+// Vrati rozdil dvou snapshotu, liveBytes a peakBytes jsou hodnoty snapshotu current
+void GetAllocationDelta( const AllocationSnapshot& previous, const AllocationSnapshot& current, AllocationSnapshot& result );
+
+// Vrati tag aktualniho vlakna (viz AllocationScope)
+AllocationTag GetAllocationTag();
+
+/*
+Nastavi tag alokaci aktualniho vlakna do konce bloku, obnovi puvodni tag v destruktoru.
+Pouziti: ALLOC_SCOPE( RENDERER );
+*/
+class AllocationScope {
+public:
+	explicit AllocationScope( const AllocationTag tag );
+	~AllocationScope();
+
+	// neni povoleno vytvaret kopie
+	AllocationScope( const AllocationScope& ) = delete;
+	AllocationScope& operator=( const AllocationScope& ) = delete;
+
+private:
+	AllocationTag previous;
+};
+
+#define ALLOC_SCOPE_CONCAT_( a, b ) a##b
+#define ALLOC_SCOPE_CONCAT( a, b ) ALLOC_SCOPE_CONCAT_( a, b )
+#define ALLOC_SCOPE( tag ) AllocationScope ALLOC_SCOPE_CONCAT( allocationScope, __LINE__ )( AllocationTag::tag )
+
+/*
+Zaznamenani alokaci, volaji globalni operator new a implementace tridy Allocator.
+Kazde vlakno zapisuje do vlastnich pocitadel, zaznam neobsahuje zadnou synchronizaci.
+TrackAllocations() a TrackFrees() zaznamenaji najednou count alokaci o celkove velikosti bytes (bez histogramu).
+*/
+#ifdef ALLOCATION_TRACKING
+void TrackAllocation( const AllocationTag tag, const std::size_t bytes );
+void TrackFree( const AllocationTag tag, const std::size_t bytes );
+void TrackAllocations( const AllocationTag tag, const std::size_t bytes, const std::size_t count );
+void TrackFrees( const AllocationTag tag, const std::size_t bytes, const std::size_t count );
+#else
+inline void TrackAllocation( const AllocationTag, const std::size_t ) {}
+inline void TrackFree( const AllocationTag, const std::size_t ) {}
+inline void TrackAllocations( const AllocationTag, const std::size_t, const std::size_t ) {}
+inline void TrackFrees( const AllocationTag, const std::size_t, const std::size_t ) {}
+#endif
\ No newline at end of file
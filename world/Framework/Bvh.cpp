@@ -0,0 +1,652 @@
+#include <algorithm>
+#include <limits>
+#include "Bvh.h"
+#include "Simd.h"
+
+namespace {
+
+	const float INFINITY_FLOAT = std::numeric_limits< float >::infinity();
+
+	// pocet intervalu pro vypocet SAH v kazde ose
+	const int SAH_BINS = 16;
+
+	inline float GetAxis( const Float3& v, const int axis ) {
+		return ( &v.x )[ axis ];
+	}
+
+	inline BoundingBox EmptyBox() {
+		BoundingBox box;
+		box.min = Float3( INFINITY_FLOAT, INFINITY_FLOAT, INFINITY_FLOAT );
+		box.max = Float3( -INFINITY_FLOAT, -INFINITY_FLOAT, -INFINITY_FLOAT );
+		return box;
+	}
+
+	// Float3 ma velikost 16 bytu, lze pouzit SIMD operace (slozka w je ignorovana)
+	inline void Grow( BoundingBox& box, const BoundingBox& b ) {
+		Simd::Store( &box.min.x, Simd::Min( Simd::Load( &box.min.x ), Simd::Load( &b.min.x ) ) );
+		Simd::Store( &box.max.x, Simd::Max( Simd::Load( &box.max.x ), Simd::Load( &b.max.x ) ) );
+	}
+
+	inline void Grow( BoundingBox& box, const Float3& p ) {
+		const Simd::Vec4 v = Simd::Load( &p.x );
+		Simd::Store( &box.min.x, Simd::Min( Simd::Load( &box.min.x ), v ) );
+		Simd::Store( &box.max.x, Simd::Max( Simd::Load( &box.max.x ), v ) );
+	}
+
+	// polovina povrchu boxu, prazdny box ma povrch 0
+	inline float GetArea( const BoundingBox& box ) {
+		const float dx = box.max.x - box.min.x;
+		const float dy = box.max.y - box.min.y;
+		const float dz = box.max.z - box.min.z;
+		if ( dx < 0 || dy < 0 || dz < 0 ) {
+			return 0;
+		}
+		return dx * dy + dy * dz + dz * dx;
+	}
+
+	BvhNode EmptyNode() {
+		BvhNode node;
+		for ( uint32_t i = 0; i < BVH_WIDTH; i++ ) {
+			node.minX[ i ] = node.minY[ i ] = node.minZ[ i ] = INFINITY_FLOAT;
+			node.maxX[ i ] = node.maxY[ i ] = node.maxZ[ i ] = -INFINITY_FLOAT;
+			node.child[ i ] = BVH_INVALID_NODE;
+			node.count[ i ] = 0;
+		}
+		return node;
+	}
+
+	void SetChildBox( BvhNode& node, const uint32_t index, const BoundingBox& box ) {
+		node.minX[ index ] = box.min.x;
+		node.minY[ index ] = box.min.y;
+		node.minZ[ index ] = box.min.z;
+		node.maxX[ index ] = box.max.x;
+		node.maxY[ index ] = box.max.y;
+		node.maxZ[ index ] = box.max.z;
+	}
+
+	// maska existujicich potomku
+	inline int GetValidMask( const BvhNode& node ) {
+		int mask = 0;
+		for ( uint32_t i = 0; i < BVH_WIDTH; i++ ) {
+			mask |= ( node.child[ i ] != BVH_INVALID_NODE ? 1 : 0 ) << i;
+		}
+		return mask;
+	}
+
+	struct Range {
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	/*
+	Vytvoreni stromu. Objekty jsou rozdelovany podle stredu bounding boxu: pro kazdou osu jsou stredy rozdeleny do SAH_BINS intervalu
+	a vybrano je rozdeleni s nejnizsi cenou SAH (soucet povrch * pocet objektu obou casti).
+	Objekty jsou pri deleni presouvany v jednom poli vcetne bounding boxu, pristup do pameti je tak sekvencni.
+	*/
+	class Builder {
+	public:
+		struct Primitive {
+			BoundingBox box;
+			Float3 centroid;
+			uint32_t object;
+		};
+
+	public:
+		Builder( const BoundingBox* const boxes, const std::size_t count );
+
+		// rozdeli interval objektu, vraci index prvniho objektu druhe casti
+		uint32_t Split( const Range& range );
+
+		BoundingBox GetBounds( const Range& range ) const;
+		const Primitive& GetPrimitive( const uint32_t index ) const;
+
+	private:
+		std::vector< Primitive > primitives;
+	};
+
+	Builder::Builder( const BoundingBox* const boxes, const std::size_t count ) {
+		primitives.resize( count );
+		for ( std::size_t i = 0; i < count; i++ ) {
+			Primitive& primitive = primitives[ i ];
+			primitive.box = boxes[ i ];
+			primitive.centroid = Float3(
+				( boxes[ i ].min.x + boxes[ i ].max.x ) * 0.5f,
+				( boxes[ i ].min.y + boxes[ i ].max.y ) * 0.5f,
+				( boxes[ i ].min.z + boxes[ i ].max.z ) * 0.5f
+			);
+			primitive.object = static_cast< uint32_t >( i );
+		}
+	}
+
+	BoundingBox Builder::GetBounds( const Range& range ) const {
+		BoundingBox bounds = EmptyBox();
+		for ( uint32_t i = range.begin; i < range.end; i++ ) {
+			Grow( bounds, primitives[ i ].box );
+		}
+		return bounds;
+	}
+
+	inline const Builder::Primitive& Builder::GetPrimitive( const uint32_t index ) const {
+		return primitives[ index ];
+	}
+
+	uint32_t Builder::Split( const Range& range ) {
+		BoundingBox centroidBounds = EmptyBox();
+		for ( uint32_t i = range.begin; i < range.end; i++ ) {
+			Grow( centroidBounds, primitives[ i ].centroid );
+		}
+
+		// vsechny osy jsou rozdeleny do intervalu jednim pruchodem objektu, osy s nulovym rozsahem jsou preskoceny
+		float offset[ 3 ];
+		float scale[ 3 ];
+		for ( int axis = 0; axis < 3; axis++ ) {
+			offset[ axis ] = GetAxis( centroidBounds.min, axis );
+			const float extent = GetAxis( centroidBounds.max, axis ) - offset[ axis ];
+			scale[ axis ] = extent > 0 ? SAH_BINS / extent : 0;
+		}
+		uint32_t counts[ 3 ][ SAH_BINS ] = {};
+		BoundingBox bins[ 3 ][ SAH_BINS ];
+		for ( int axis = 0; axis < 3; axis++ ) {
+			for ( int bin = 0; bin < SAH_BINS; bin++ ) {
+				bins[ axis ][ bin ] = EmptyBox();
+			}
+		}
+		for ( uint32_t i = range.begin; i < range.end; i++ ) {
+			const Primitive& primitive = primitives[ i ];
+			for ( int axis = 0; axis < 3; axis++ ) {
+				const int bin = std::min( static_cast< int >( ( GetAxis( primitive.centroid, axis ) - offset[ axis ] ) * scale[ axis ] ), SAH_BINS - 1 );
+				counts[ axis ][ bin ] += 1;
+				Grow( bins[ axis ][ bin ], primitive.box );
+			}
+		}
+
+		float bestCost = INFINITY_FLOAT;
+		int bestAxis = -1;
+		int bestBin = 0;
+		for ( int axis = 0; axis < 3; axis++ ) {
+			if ( scale[ axis ] == 0 ) {
+				continue;
+			}
+
+			// cena rozdeleni za intervalem bin: pravou cast je potreba spocitat predem
+			float rightCost[ SAH_BINS ];
+			BoundingBox right = EmptyBox();
+			uint32_t rightCount = 0;
+			for ( int bin = SAH_BINS - 1; bin > 0; bin-- ) {
+				Grow( right, bins[ axis ][ bin ] );
+				rightCount += counts[ axis ][ bin ];
+				rightCost[ bin ] = rightCount > 0 ? GetArea( right ) * rightCount : INFINITY_FLOAT;
+			}
+			BoundingBox left = EmptyBox();
+			uint32_t leftCount = 0;
+			for ( int bin = 0; bin < SAH_BINS - 1; bin++ ) {
+				Grow( left, bins[ axis ][ bin ] );
+				leftCount += counts[ axis ][ bin ];
+				if ( leftCount == 0 ) {
+					continue;
+				}
+				const float cost = GetArea( left ) * leftCount + rightCost[ bin + 1 ];
+				if ( cost < bestCost ) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = bin;
+				}
+			}
+		}
+
+		// vsechny stredy jsou shodne, objekty se rozdeli na poloviny
+		const uint32_t half = range.begin + ( range.end - range.begin ) / 2;
+		if ( bestAxis < 0 ) {
+			return half;
+		}
+		const auto middle = std::partition( primitives.begin() + range.begin, primitives.begin() + range.end, [ & ]( const Primitive& primitive ) {
+			return std::min( static_cast< int >( ( GetAxis( primitive.centroid, bestAxis ) - offset[ bestAxis ] ) * scale[ bestAxis ] ), SAH_BINS - 1 ) <= bestBin;
+		} );
+		const uint32_t split = static_cast< uint32_t >( middle - primitives.begin() );
+		return split > range.begin && split < range.end ? split : half;
+	}
+
+	/*
+	Zasobnik pro pruchod stromem, hloubka zasobniku je omezena hloubkou stromu.
+	Pro obvykle hloubky staci pamet na zasobniku volajiciho vlakna.
+	*/
+	template < typename T >
+	class TraversalStack {
+	public:
+		explicit TraversalStack( const std::size_t capacity ) {
+			data = local;
+			if ( capacity > LOCAL_CAPACITY ) {
+				heap.resize( capacity );
+				data = heap.data();
+			}
+			size = 0;
+		}
+
+		void Push( const T& value ) {
+			data[ size++ ] = value;
+		}
+
+		T Pop() {
+			return data[ --size ];
+		}
+
+		bool IsEmpty() const {
+			return size == 0;
+		}
+
+	private:
+		static const std::size_t LOCAL_CAPACITY = 128;
+		T local[ LOCAL_CAPACITY ];
+		std::vector< T > heap;
+		T* data;
+		std::size_t size;
+	};
+
+	// bounding box objektu
+	inline bool BoxesOverlap( const BoundingBox& box, const Vector& min, const Vector& max ) {
+		return box.min.x <= max.x && box.max.x >= min.x && box.min.y <= max.y && box.max.y >= min.y && box.min.z <= max.z && box.max.z >= min.z;
+	}
+
+	inline float SquaredDistance( const BoundingBox& box, const Vector& p ) {
+		const float dx = std::max( std::max( box.min.x - p.x, p.x - box.max.x ), 0.0f );
+		const float dy = std::max( std::max( box.min.y - p.y, p.y - box.max.y ), 0.0f );
+		const float dz = std::max( std::max( box.min.z - p.z, p.z - box.max.z ), 0.0f );
+		return dx * dx + dy * dy + dz * dz;
+	}
+
+	/*
+	Paprsek pro test se slaby boxu. Nulove slozky smeru jsou nahrazeny velmi malym cislem,
+	aby pri vypoctu ( min - origin ) / direction nevznikalo NaN.
+	*/
+	struct Ray {
+		Float3 origin;
+		Float3 inverseDirection;
+		float length;
+
+		Ray( const Vector& origin, const Vector& direction, const float length ) {
+			const float minimum = 1e-20f;
+			this->origin = Float3( origin.x, origin.y, origin.z );
+			inverseDirection = Float3(
+				1.0f / ( std::abs( direction.x ) > minimum ? direction.x : minimum ),
+				1.0f / ( std::abs( direction.y ) > minimum ? direction.y : minimum ),
+				1.0f / ( std::abs( direction.z ) > minimum ? direction.z : minimum )
+			);
+			this->length = length;
+		}
+
+		// vraci vzdalenost vstupu do boxu nebo INFINITY_FLOAT, pokud paprsek box neprotina
+		float Intersect( const BoundingBox& box ) const {
+			const float x1 = ( box.min.x - origin.x ) * inverseDirection.x;
+			const float x2 = ( box.max.x - origin.x ) * inverseDirection.x;
+			const float y1 = ( box.min.y - origin.y ) * inverseDirection.y;
+			const float y2 = ( box.max.y - origin.y ) * inverseDirection.y;
+			const float z1 = ( box.min.z - origin.z ) * inverseDirection.z;
+			const float z2 = ( box.max.z - origin.z ) * inverseDirection.z;
+			const float enter = std::max( std::max( std::min( x1, x2 ), std::min( y1, y2 ) ), std::max( std::min( z1, z2 ), 0.0f ) );
+			const float leave = std::min( std::min( std::max( x1, x2 ), std::max( y1, y2 ) ), std::min( std::max( z1, z2 ), length ) );
+			return enter <= leave ? enter : INFINITY_FLOAT;
+		}
+
+		// vzdalenosti vstupu do boxu potomku uzlu, vraci masku protnutych potomku
+		int Intersect( const BvhNode& node, Simd::Vec4& distance ) const {
+			const Simd::Vec4 ox = Simd::Replicate( origin.x );
+			const Simd::Vec4 oy = Simd::Replicate( origin.y );
+			const Simd::Vec4 oz = Simd::Replicate( origin.z );
+			const Simd::Vec4 ix = Simd::Replicate( inverseDirection.x );
+			const Simd::Vec4 iy = Simd::Replicate( inverseDirection.y );
+			const Simd::Vec4 iz = Simd::Replicate( inverseDirection.z );
+			const Simd::Vec4 x1 = Simd::Mul( Simd::Sub( Simd::Load( node.minX ), ox ), ix );
+			const Simd::Vec4 x2 = Simd::Mul( Simd::Sub( Simd::Load( node.maxX ), ox ), ix );
+			const Simd::Vec4 y1 = Simd::Mul( Simd::Sub( Simd::Load( node.minY ), oy ), iy );
+			const Simd::Vec4 y2 = Simd::Mul( Simd::Sub( Simd::Load( node.maxY ), oy ), iy );
+			const Simd::Vec4 z1 = Simd::Mul( Simd::Sub( Simd::Load( node.minZ ), oz ), iz );
+			const Simd::Vec4 z2 = Simd::Mul( Simd::Sub( Simd::Load( node.maxZ ), oz ), iz );
+			const Simd::Vec4 enter = Simd::Max( Simd::Max( Simd::Min( x1, x2 ), Simd::Min( y1, y2 ) ), Simd::Max( Simd::Min( z1, z2 ), Simd::Zero() ) );
+			const Simd::Vec4 leave = Simd::Min( Simd::Min( Simd::Max( x1, x2 ), Simd::Max( y1, y2 ) ), Simd::Min( Simd::Max( z1, z2 ), Simd::Replicate( length ) ) );
+			distance = enter;
+			return ~Simd::LessMask( leave, enter ) & GetValidMask( node );
+		}
+	};
+}
+
+// class Bvh
+
+Bvh::Bvh() {
+	depth = 0;
+}
+
+void Bvh::Clear() {
+	nodes.clear();
+	objects.clear();
+	boxes.clear();
+	depth = 0;
+}
+
+void Bvh::Build( const BoundingBox* const source, const std::size_t count ) {
+	Clear();
+	if ( count == 0 ) {
+		return;
+	}
+	Builder builder( source, count );
+
+	struct Task {
+		uint32_t node;
+		Range range;
+		uint32_t depth;
+	};
+	std::vector< Task > tasks;
+	nodes.push_back( EmptyNode() );
+	tasks.push_back( Task{ 0, Range{ 0, static_cast< uint32_t >( count ) }, 1 } );
+
+	while ( !tasks.empty() ) {
+		const Task task = tasks.back();
+		tasks.pop_back();
+		depth = std::max( depth, task.depth );
+
+		// interval uzlu se rozdeli na az 4 casti, vzdy se deli nejvetsi cast
+		Range ranges[ BVH_WIDTH ] = { task.range };
+		uint32_t rangesCount = 1;
+		while ( rangesCount < BVH_WIDTH ) {
+			uint32_t largest = 0;
+			for ( uint32_t i = 1; i < rangesCount; i++ ) {
+				if ( ranges[ i ].end - ranges[ i ].begin > ranges[ largest ].end - ranges[ largest ].begin ) {
+					largest = i;
+				}
+			}
+			if ( ranges[ largest ].end - ranges[ largest ].begin <= BVH_LEAF_SIZE ) {
+				break;
+			}
+			const uint32_t split = builder.Split( ranges[ largest ] );
+			ranges[ rangesCount++ ] = Range{ split, ranges[ largest ].end };
+			ranges[ largest ].end = split;
+		}
+		std::sort( ranges, ranges + rangesCount, []( const Range& a, const Range& b ) {
+			return a.begin < b.begin;
+		} );
+
+		for ( uint32_t i = 0; i < rangesCount; i++ ) {
+			const Range& range = ranges[ i ];
+			SetChildBox( nodes[ task.node ], i, builder.GetBounds( range ) );
+			const uint32_t objectsCount = range.end - range.begin;
+			if ( objectsCount <= BVH_LEAF_SIZE ) {
+				nodes[ task.node ].child[ i ] = range.begin;
+				nodes[ task.node ].count[ i ] = objectsCount;
+			} else {
+				const uint32_t child = static_cast< uint32_t >( nodes.size() );
+				nodes[ task.node ].child[ i ] = child;
+				nodes.push_back( EmptyNode() );
+				tasks.push_back( Task{ child, range, task.depth + 1 } );
+			}
+		}
+	}
+
+	objects.resize( count );
+	boxes.resize( count );
+	for ( uint32_t i = 0; i < count; i++ ) {
+		objects[ i ] = builder.GetPrimitive( i ).object;
+		boxes[ i ] = builder.GetPrimitive( i ).box;
+	}
+}
+
+void Bvh::Refit( const BoundingBox* const source ) {
+	for ( std::size_t i = 0; i < objects.size(); i++ ) {
+		boxes[ i ] = source[ objects[ i ] ];
+	}
+
+	// potomci maji vyssi index nez rodic, pri pruchodu od konce jsou boxy potomku vzdy aktualni
+	for ( std::size_t n = nodes.size(); n > 0; n-- ) {
+		BvhNode& node = nodes[ n - 1 ];
+		for ( uint32_t i = 0; i < BVH_WIDTH; i++ ) {
+			if ( node.child[ i ] == BVH_INVALID_NODE ) {
+				continue;
+			}
+			BoundingBox bounds = EmptyBox();
+			if ( node.count[ i ] > 0 ) {
+				for ( uint32_t object = node.child[ i ]; object < node.child[ i ] + node.count[ i ]; object++ ) {
+					Grow( bounds, boxes[ object ] );
+				}
+			} else {
+				const BvhNode& child = nodes[ node.child[ i ] ];
+				for ( uint32_t j = 0; j < BVH_WIDTH; j++ ) {
+					Grow( bounds, BoundingBox{ Float3( child.minX[ j ], child.minY[ j ], child.minZ[ j ] ), Float3( child.maxX[ j ], child.maxY[ j ], child.maxZ[ j ] ) } );
+				}
+			}
+			SetChildBox( node, i, bounds );
+		}
+	}
+}
+
+std::size_t Bvh::GetStackSize() const {
+	// kazda uroven prida nejvyse BVH_WIDTH - 1 uzlu
+	return depth * ( BVH_WIDTH - 1 ) + 2;
+}
+
+void Bvh::AppendSubtree( const uint32_t node, std::vector< uint32_t >& result ) const {
+	// objekty podstromu tvori souvisly interval, staci najit prvni a posledni list
+	uint32_t first = node;
+	uint32_t slot = 0;
+	while ( nodes[ first ].count[ 0 ] == 0 ) {
+		first = nodes[ first ].child[ 0 ];
+	}
+	uint32_t last = node;
+	for ( ;; ) {
+		slot = BVH_WIDTH - 1;
+		while ( nodes[ last ].child[ slot ] == BVH_INVALID_NODE ) {
+			slot--;
+		}
+		if ( nodes[ last ].count[ slot ] > 0 ) {
+			break;
+		}
+		last = nodes[ last ].child[ slot ];
+	}
+	const uint32_t begin = nodes[ first ].child[ 0 ];
+	const uint32_t end = nodes[ last ].child[ slot ] + nodes[ last ].count[ slot ];
+	result.insert( result.end(), objects.begin() + begin, objects.begin() + end );
+}
+
+/*
+Obecny pruchod stromem. NodeTest( node, outside, partial ) nastavi masky potomku, ktere lezi cele mimo dotaz
+a ktere lezi v dotazu jen castecne. Potomci cele uvnitr dotazu jsou pridani bez dalsich testu,
+u castecne protnutych listu se testuje kazdy objekt funkci ObjectTest( box ).
+*/
+template < typename NodeTest, typename ObjectTest >
+void Bvh::Query( const NodeTest& nodeTest, const ObjectTest& objectTest, std::vector< uint32_t >& result ) const {
+	if ( nodes.empty() ) {
+		return;
+	}
+	TraversalStack< uint32_t > stack( GetStackSize() );
+	stack.Push( 0 );
+	while ( !stack.IsEmpty() ) {
+		const BvhNode& node = nodes[ stack.Pop() ];
+		int outside = 0;
+		int partial = 0;
+		nodeTest( node, outside, partial );
+		const int visible = GetValidMask( node ) & ~outside;
+		for ( uint32_t i = 0; i < BVH_WIDTH; i++ ) {
+			if ( ( visible & ( 1 << i ) ) == 0 ) {
+				continue;
+			}
+			const bool inside = ( partial & ( 1 << i ) ) == 0;
+			if ( node.count[ i ] > 0 ) {
+				for ( uint32_t object = node.child[ i ]; object < node.child[ i ] + node.count[ i ]; object++ ) {
+					if ( inside || objectTest( boxes[ object ] ) ) {
+						result.push_back( objects[ object ] );
+					}
+				}
+			} else if ( inside ) {
+				AppendSubtree( node.child[ i ], result );
+			} else {
+				stack.Push( node.child[ i ] );
+			}
+		}
+	}
+}
+
+void Bvh::QueryFrustum( const Frustum& frustum, std::vector< uint32_t >& result ) const {
+	Float4 planes[ FRUSTUM_PLANES_COUNT ];
+	Simd::Vec4 a[ FRUSTUM_PLANES_COUNT ], b[ FRUSTUM_PLANES_COUNT ], c[ FRUSTUM_PLANES_COUNT ], d[ FRUSTUM_PLANES_COUNT ];
+	for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+		planes[ p ] = frustum.GetPlane( p );
+		a[ p ] = Simd::Replicate( planes[ p ].x );
+		b[ p ] = Simd::Replicate( planes[ p ].y );
+		c[ p ] = Simd::Replicate( planes[ p ].z );
+		d[ p ] = Simd::Replicate( planes[ p ].w );
+	}
+
+	// box je mimo, pokud je za nekterou rovinou i vrchol nejdale ve smeru normaly,
+	// cely uvnitr, pokud je pred vsemi rovinami i vrchol nejdale proti smeru normaly
+	auto nodeTest = [ & ]( const BvhNode& node, int& outside, int& partial ) {
+		for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+			const bool px = planes[ p ].x >= 0;
+			const bool py = planes[ p ].y >= 0;
+			const bool pz = planes[ p ].z >= 0;
+			const Simd::Vec4 positive = Simd::MulAdd(
+				Simd::Load( px ? node.maxX : node.minX ), a[ p ],
+				Simd::MulAdd( Simd::Load( py ? node.maxY : node.minY ), b[ p ], Simd::MulAdd( Simd::Load( pz ? node.maxZ : node.minZ ), c[ p ], d[ p ] ) )
+			);
+			const Simd::Vec4 negative = Simd::MulAdd(
+				Simd::Load( px ? node.minX : node.maxX ), a[ p ],
+				Simd::MulAdd( Simd::Load( py ? node.minY : node.maxY ), b[ p ], Simd::MulAdd( Simd::Load( pz ? node.minZ : node.maxZ ), c[ p ], d[ p ] ) )
+			);
+			outside |= Simd::LessMask( positive, Simd::Zero() );
+			partial |= Simd::LessMask( negative, Simd::Zero() );
+		}
+	};
+	auto objectTest = [ & ]( const BoundingBox& box ) {
+		return frustum.TestBox( Vector( box.min ), Vector( box.max ) );
+	};
+	Query( nodeTest, objectTest, result );
+}
+
+void Bvh::QuerySphere( const Vector& center, const float radius, std::vector< uint32_t >& result ) const {
+	const Simd::Vec4 cx = Simd::Replicate( center.x );
+	const Simd::Vec4 cy = Simd::Replicate( center.y );
+	const Simd::Vec4 cz = Simd::Replicate( center.z );
+	const Simd::Vec4 radiusSq = Simd::Replicate( radius * radius );
+
+	// box je mimo, pokud je nejblizsi bod boxu dal nez radius, cely uvnitr, pokud je blize nejvzdalenejsi vrchol
+	auto nodeTest = [ & ]( const BvhNode& node, int& outside, int& partial ) {
+		const Simd::Vec4 minX = Simd::Sub( Simd::Load( node.minX ), cx );
+		const Simd::Vec4 minY = Simd::Sub( Simd::Load( node.minY ), cy );
+		const Simd::Vec4 minZ = Simd::Sub( Simd::Load( node.minZ ), cz );
+		const Simd::Vec4 maxX = Simd::Sub( cx, Simd::Load( node.maxX ) );
+		const Simd::Vec4 maxY = Simd::Sub( cy, Simd::Load( node.maxY ) );
+		const Simd::Vec4 maxZ = Simd::Sub( cz, Simd::Load( node.maxZ ) );
+		const Simd::Vec4 nearX = Simd::Max( Simd::Max( minX, maxX ), Simd::Zero() );
+		const Simd::Vec4 nearY = Simd::Max( Simd::Max( minY, maxY ), Simd::Zero() );
+		const Simd::Vec4 nearZ = Simd::Max( Simd::Max( minZ, maxZ ), Simd::Zero() );
+		const Simd::Vec4 nearSq = Simd::MulAdd( nearX, nearX, Simd::MulAdd( nearY, nearY, Simd::Mul( nearZ, nearZ ) ) );
+		const Simd::Vec4 farX = Simd::Max( Simd::Max( minX, maxX ), Simd::Max( Simd::Sub( Simd::Zero(), minX ), Simd::Sub( Simd::Zero(), maxX ) ) );
+		const Simd::Vec4 farY = Simd::Max( Simd::Max( minY, maxY ), Simd::Max( Simd::Sub( Simd::Zero(), minY ), Simd::Sub( Simd::Zero(), maxY ) ) );
+		const Simd::Vec4 farZ = Simd::Max( Simd::Max( minZ, maxZ ), Simd::Max( Simd::Sub( Simd::Zero(), minZ ), Simd::Sub( Simd::Zero(), maxZ ) ) );
+		const Simd::Vec4 farSq = Simd::MulAdd( farX, farX, Simd::MulAdd( farY, farY, Simd::Mul( farZ, farZ ) ) );
+		outside = Simd::LessMask( radiusSq, nearSq );
+		partial = Simd::LessMask( radiusSq, farSq );
+	};
+	auto objectTest = [ & ]( const BoundingBox& box ) {
+		return SquaredDistance( box, center ) <= radius * radius;
+	};
+	Query( nodeTest, objectTest, result );
+}
+
+void Bvh::QueryBox( const Vector& min, const Vector& max, std::vector< uint32_t >& result ) const {
+	const Simd::Vec4 qminX = Simd::Replicate( min.x );
+	const Simd::Vec4 qminY = Simd::Replicate( min.y );
+	const Simd::Vec4 qminZ = Simd::Replicate( min.z );
+	const Simd::Vec4 qmaxX = Simd::Replicate( max.x );
+	const Simd::Vec4 qmaxY = Simd::Replicate( max.y );
+	const Simd::Vec4 qmaxZ = Simd::Replicate( max.z );
+	auto nodeTest = [ & ]( const BvhNode& node, int& outside, int& partial ) {
+		const Simd::Vec4 minX = Simd::Load( node.minX );
+		const Simd::Vec4 minY = Simd::Load( node.minY );
+		const Simd::Vec4 minZ = Simd::Load( node.minZ );
+		const Simd::Vec4 maxX = Simd::Load( node.maxX );
+		const Simd::Vec4 maxY = Simd::Load( node.maxY );
+		const Simd::Vec4 maxZ = Simd::Load( node.maxZ );
+		outside = Simd::LessMask( maxX, qminX ) | Simd::LessMask( maxY, qminY ) | Simd::LessMask( maxZ, qminZ ) |
+			Simd::LessMask( qmaxX, minX ) | Simd::LessMask( qmaxY, minY ) | Simd::LessMask( qmaxZ, minZ );
+		partial = Simd::LessMask( minX, qminX ) | Simd::LessMask( minY, qminY ) | Simd::LessMask( minZ, qminZ ) |
+			Simd::LessMask( qmaxX, maxX ) | Simd::LessMask( qmaxY, maxY ) | Simd::LessMask( qmaxZ, maxZ );
+	};
+	auto objectTest = [ & ]( const BoundingBox& box ) {
+		return BoxesOverlap( box, min, max );
+	};
+	Query( nodeTest, objectTest, result );
+}
+
+void Bvh::QueryRay( const Vector& origin, const Vector& direction, const float length, std::vector< uint32_t >& result ) const {
+	const Ray ray( origin, direction, length );
+
+	// paprsek nemuze cely box obsahovat, vsechny protnute boxy jsou castecne
+	auto nodeTest = [ & ]( const BvhNode& node, int& outside, int& partial ) {
+		Simd::Vec4 distance;
+		outside = ~ray.Intersect( node, distance );
+		partial = ~0;
+	};
+	auto objectTest = [ & ]( const BoundingBox& box ) {
+		return ray.Intersect( box ) != INFINITY_FLOAT;
+	};
+	Query( nodeTest, objectTest, result );
+}
+
+bool Bvh::Raycast( const Vector& origin, const Vector& direction, const float length, BvhRayHit& hit ) const {
+	if ( nodes.empty() ) {
+		return false;
+	}
+	const Ray ray( origin, direction, length );
+	struct Entry {
+		uint32_t node;
+		float distance;
+	};
+
+	// uzly jsou zpracovavany od nejblizsiho, uzly dale nez nejblizsi nalezeny objekt jsou preskoceny
+	TraversalStack< Entry > stack( GetStackSize() );
+	stack.Push( Entry{ 0, 0 } );
+	float nearest = INFINITY_FLOAT;
+	uint32_t nearestObject = BVH_INVALID_NODE;
+	while ( !stack.IsEmpty() ) {
+		const Entry entry = stack.Pop();
+		if ( entry.distance > nearest ) {
+			continue;
+		}
+		const BvhNode& node = nodes[ entry.node ];
+		Simd::Vec4 distances;
+		const int mask = ray.Intersect( node, distances );
+		float distance[ BVH_WIDTH ];
+		Simd::StoreUnaligned( distance, distances );
+
+		// protnute uzly serazene od nejvzdalenejsiho, aby nejblizsi byl na vrcholu zasobniku
+		Entry children[ BVH_WIDTH ];
+		uint32_t childrenCount = 0;
+		for ( uint32_t i = 0; i < BVH_WIDTH; i++ ) {
+			if ( ( mask & ( 1 << i ) ) == 0 || distance[ i ] > nearest ) {
+				continue;
+			}
+			if ( node.count[ i ] > 0 ) {
+				for ( uint32_t object = node.child[ i ]; object < node.child[ i ] + node.count[ i ]; object++ ) {
+					const float t = ray.Intersect( boxes[ object ] );
+					if ( t < nearest ) {
+						nearest = t;
+						nearestObject = objects[ object ];
+					}
+				}
+				continue;
+			}
+			uint32_t position = childrenCount++;
+			while ( position > 0 && children[ position - 1 ].distance < distance[ i ] ) {
+				children[ position ] = children[ position - 1 ];
+				position--;
+			}
+			children[ position ] = Entry{ node.child[ i ], distance[ i ] };
+		}
+		for ( uint32_t i = 0; i < childrenCount; i++ ) {
+			stack.Push( children[ i ] );
+		}
+	}
+	if ( nearestObject == BVH_INVALID_NODE ) {
+		return false;
+	}
+	hit.object = nearestObject;
+	hit.distance = nearest;
+	return true;
+}
\ No newline at end of file
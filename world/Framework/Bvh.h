@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Types.h"
+#include "Vector.h"
+#include "Frustum.h"
+
+struct BoundingBox {
+	Float3 min;
+	Float3 max;
+};
+
+// pocet potomku uzlu a maximalni pocet objektu v listu
+const uint32_t BVH_WIDTH = 4;
+const uint32_t BVH_LEAF_SIZE = 4;
+const uint32_t BVH_INVALID_NODE = 0xffffffff;
+
+/*
+Uzel BVH: bounding boxy potomku ulozene po slozkach, vsechny potomky lze testovat jednou SIMD operaci.
+count[ i ] == 0: potomek je uzel s indexem child[ i ]
+count[ i ] > 0: potomek je list s objekty < child[ i ]; child[ i ] + count[ i ] ) v poradi BVH
+child[ i ] == BVH_INVALID_NODE: potomek neexistuje
+Potomci jsou serazeni podle objektu, ktere obsahuji, kazdy uzel tak obsahuje souvisly interval objektu.
+Uzel ma velikost dvou cache line.
+*/
+struct alignas( 64 ) BvhNode {
+	float minX[ BVH_WIDTH ];
+	float minY[ BVH_WIDTH ];
+	float minZ[ BVH_WIDTH ];
+	float maxX[ BVH_WIDTH ];
+	float maxY[ BVH_WIDTH ];
+	float maxZ[ BVH_WIDTH ];
+	uint32_t child[ BVH_WIDTH ];
+	uint32_t count[ BVH_WIDTH ];
+};
+
+struct BvhRayHit {
+	uint32_t object;
+	float distance;
+};
+
+/*
+Bvh: hierarchie bounding boxu objektu (bounding volume hierarchy) pro dotazy na viditelnost, okoli a paprsky.
+Strom je vytvoren metodou SAH (surface area heuristic) s rozdelenim objektu do intervalu (binned SAH),
+uzly maji 4 potomky a jsou ulozeny v jednom poli (koren ma index 0, potomci maji vyssi index nez rodic).
+Dotazy pridavaji indexy objektu (indexy v poli predanem do Build) na konec pole result, poradi neni urceno.
+*/
+class Bvh {
+public:
+	Bvh();
+
+	// neni povoleno vytvaret kopie
+	Bvh( const Bvh& ) = delete;
+	Bvh& operator=( const Bvh& ) = delete;
+
+	// vytvori strom pro count objektu, boxes[ i ] je bounding box objektu i
+	void Build( const BoundingBox* const boxes, const std::size_t count );
+
+	/*
+	Aktualizuje bounding boxy pohnutych objektu bez zmeny struktury stromu (pole boxes ma stejny pocet prvku jako pri Build).
+	Pri velkych zmenach poloh objektu se zhorsuje kvalita stromu, pak je vhodne zavolat Build.
+	*/
+	void Refit( const BoundingBox* const boxes );
+
+	void Clear();
+
+	std::size_t GetObjectsCount() const;
+	std::size_t GetNodesCount() const;
+	const BvhNode* GetNodes() const;
+
+	// objekty, jejichz bounding box protina frustum, kouli nebo box
+	void QueryFrustum( const Frustum& frustum, std::vector< uint32_t >& result ) const;
+	void QuerySphere( const Vector& center, const float radius, std::vector< uint32_t >& result ) const;
+	void QueryBox( const Vector& min, const Vector& max, std::vector< uint32_t >& result ) const;
+
+	/*
+	Paprsek origin + t * direction, t < 0; length >. Smer nemusi byt normalizovany, vzdalenost je pak v nasobcich direction.
+	QueryRay() vraci vsechny objekty, jejichz bounding box paprsek protina (napr. test viditelnosti),
+	Raycast() nejblizsi takovy objekt (napr. vyber objektu mysi), vraci false, pokud paprsek zadny objekt neprotina.
+	*/
+	void QueryRay( const Vector& origin, const Vector& direction, const float length, std::vector< uint32_t >& result ) const;
+	bool Raycast( const Vector& origin, const Vector& direction, const float length, BvhRayHit& hit ) const;
+
+private:
+	template < typename NodeTest, typename ObjectTest >
+	void Query( const NodeTest& nodeTest, const ObjectTest& objectTest, std::vector< uint32_t >& result ) const;
+
+	// prida vsechny objekty podstromu
+	void AppendSubtree( const uint32_t node, std::vector< uint32_t >& result ) const;
+
+	// velikost zasobniku pro pruchod stromem
+	std::size_t GetStackSize() const;
+
+private:
+	std::vector< BvhNode > nodes;
+
+	// indexy objektu a jejich bounding boxy v poradi listu
+	std::vector< uint32_t > objects;
+	std::vector< BoundingBox > boxes;
+
+	uint32_t depth;
+};
+
+inline std::size_t Bvh::GetObjectsCount() const {
+	return objects.size();
+}
+
+inline std::size_t Bvh::GetNodesCount() const {
+	return nodes.size();
+}
+
+inline const BvhNode* Bvh::GetNodes() const {
+	return nodes.data();
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Color.h"
 #include "Math.h"
+#include "ColorArray.h"
 
 // class ColorUnorm
 
@@ -150,55 +151,13 @@ bool Color::operator!=( const Color& color ) {
 }
 
 void Color::SetHSV( const float h, const float s, const float v ) {
-	// oriznout vstupni hodnoty do rozsahu <0; 1>
-	float hc = Math::Clamp( h, 0.0f, 1.0f );
-	float sc = Math::Clamp( s, 0.0f, 1.0f );
-	float vc = Math::Clamp( v, 0.0f, 1.0f );
-	
-	float hdeg = float( int( hc * 360.0f ) % 360 );
-	int hi = int( hdeg / 60.0f ) % 6;
-	float f = ( hdeg / 60.0f ) - float( hi );
-	float p = vc * ( 1.0f - sc );
-	float q = vc * ( 1.0f - f * sc );
-	float t = vc * ( 1.0f - ( 1.0f - f ) * sc );
-	
-	switch ( hi ) {
-	case 0: SetRGBA( vc, t, p, 1.0f ); return;
-	case 1: SetRGBA( q, vc, p, 1.0f ); return;
-	case 2: SetRGBA( p, vc, t, 1.0f ); return;
-	case 3: SetRGBA( p, q, vc, 1.0f ); return;
-	case 4: SetRGBA( t, p, vc, 1.0f ); return;
-	case 5: SetRGBA( vc, p, q, 1.0f ); return;
-	};
+	// hromadny prevod pro jednu barvu, stejny vypocet jako ConvertHSVToRGB()
+	const Vector hsv( h, s, v, 1.0f );
+	ConvertHSVToRGB( &hsv, this, 1 );
 }
 
 Vector Color::GetHSV() const {
-	// hodnoty rgba museji byt v rozsahu <0; 1>
-	Color color = *this;
-	color.Clamp();
-	
-	float maxc = Math::Max( color.r, color.g, color.b );
-	float minc = Math::Min( color.r, color.g, color.b );
-	
-	// Hue
-	float h = 0.0f;
-	if ( maxc == minc ) {
-		h = 0;
-	} else if ( maxc == color.r ) {
-		if ( color.g >= color.b ) {
-			h = 60.0f * ( color.g - color.b ) / ( maxc - minc );
-		} else {
-			h = 60.0f * ( color.g - color.b ) / ( maxc - minc ) + 360.0f;
-		}
-	} else if ( maxc == color.g ) {
-		h = 60.0f * ( color.b - color.r ) / ( maxc - minc ) + 120.0f;
-	} else if ( maxc == color.b ) {
-		h = 60.0f * ( color.r - color.g ) / ( maxc - minc ) + 240.0f;
-	}
-	// Saturation
-	float s = 0.0f;
-	if ( maxc != 0 ) {
-		s = 1.0f - minc / maxc;
-	}
-	return Vector( h / 360.0f, s, maxc, color.a );
+	Vector hsv;
+	ConvertRGBToHSV( this, &hsv, 1 );
+	return hsv;
 }
\ No newline at end of file
@@ -54,7 +54,7 @@ public:
 	// vytvori RGB barvu z HSV; h<0; 1); s<0;1>; v<0;1>
 	void SetHSV( const float h, const float s, const float v );
 	
-	// vrati Vector( h<0; 1), s<0;1>, v<0;1>, a<0;1> );
+	// vrati Vector( h<0; 1>, s<0;1>, v<0;1>, a ); viz ConvertRGBToHSV()
 	Vector GetHSV() const;
 	
 	// cast to
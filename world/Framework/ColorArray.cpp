@@ -0,0 +1,352 @@
+#include <cmath>
+#include <cstring>
+#include "ColorArray.h"
+#include "Simd.h"
+
+// Color se nacita jednou 16 bajtovou operaci
+static_assert( sizeof( Color ) == 16 && sizeof( ColorUnorm ) == 4 && sizeof( UNorm4x8 ) == 4, "color size mismatch" );
+
+namespace {
+
+	/*
+	Linearni hodnota -> sRGB: rozsah < 2^-13; 1 ) je rozdelen na 104 useku (1/8 exponentu), v kazdem je funkce
+	255 * sRGB( x ) + 0.5 nahrazena primkou (rozdil od nejlepsi primky je nejvyse 0.07 jednotky).
+	Polozka: ( bias << 16 ) | scale, vysledek = ( bias * 512 + scale * t ) >> 16, t je dalsich 8 bitu mantisy.
+	Hodnoty < 2^-13 maji sRGB hodnotu < 0.5 a jsou prevedeny na 0.
+	*/
+	const uint32_t SRGB_TABLE[ 104 ] = {
+		0x0073000d, 0x007a000d, 0x0080000d, 0x0087000c, 0x008d000d, 0x0094000c, 0x009a000d, 0x00a1000b,
+		0x00a7001a, 0x00b40019, 0x00c10019, 0x00ce0019, 0x00da001a, 0x00e7001a, 0x00f4001a, 0x0101001a,
+		0x010e0033, 0x01280033, 0x01410034, 0x015b0034, 0x01750033, 0x018f0033, 0x01a80034, 0x01c20034,
+		0x01dc0067, 0x020f0067, 0x02430067, 0x02760067, 0x02aa0067, 0x02dd0067, 0x03110067, 0x03440067,
+		0x037800ce, 0x03df00ce, 0x044600cd, 0x04ad00cd, 0x051400cd, 0x057a00c6, 0x05dd00bb, 0x063b00b5,
+		0x06960158, 0x07420142, 0x07e3012f, 0x087b011f, 0x090b0111, 0x09940105, 0x0a1700fb, 0x0a9400f4,
+		0x0b0e01cc, 0x0bf401ad, 0x0cca0197, 0x0d950181, 0x0e55016f, 0x0f0c015f, 0x0fbb0151, 0x10630144,
+		0x11060264, 0x1238023e, 0x1357021c, 0x14650202, 0x156601e7, 0x165a01d3, 0x174301c2, 0x182401ae,
+		0x18fd0331, 0x1a9502ff, 0x1c1402d3, 0x1d7d02ad, 0x1ed3028e, 0x201a026e, 0x21510258, 0x227c0241,
+		0x239e0445, 0x25c003fd, 0x27be03c6, 0x29a00394, 0x2b690369, 0x2d1d0341, 0x2ebd031f, 0x304c0302,
+		0x31cf05b2, 0x34a70555, 0x37510508, 0x39d404c6, 0x3c36048c, 0x3e7c0456, 0x40a7042b, 0x42bc0402,
+		0x44c10798, 0x488c071f, 0x4c1a06b8, 0x4f75065e, 0x52a30612, 0x55ab05cd, 0x58910590, 0x5b58055a,
+		0x5e0a0a24, 0x631a0982, 0x67da08f5, 0x6c54087f, 0x70930818, 0x749e07be, 0x787c076e, 0x7c320724,
+	};
+
+	const float SRGB_MIN = 1.220703125e-04f;		// 2^-13
+	const float SRGB_ALMOST_ONE = 0.99999994f;		// nejvetsi float < 1
+	const uint32_t SRGB_MIN_BITS = 0x39000000;
+
+	// 8 bit -> float, presne hodnoty c / 255 a inverzni prenosova funkce sRGB
+	struct DecodeTables {
+		float linear[ 256 ];
+		float srgb[ 256 ];
+	};
+
+	const DecodeTables& GetDecodeTables() {
+		static const DecodeTables tables = []() {
+			DecodeTables result;
+			for ( int i = 0; i < 256; i++ ) {
+				const double c = static_cast< double >( i ) / 255.0;
+				result.linear[ i ] = static_cast< float >( i ) / 255.0f;
+				result.srgb[ i ] = static_cast< float >( c <= 0.04045 ? c / 12.92 : std::pow( ( c + 0.055 ) / 1.055, 2.4 ) );
+			}
+			return result;
+		}();
+		return tables;
+	}
+
+	// skalarni kodovani, zaokrouhleni lrint odpovida instrukci cvtps2dq
+
+	inline uint8_t LinearToUnorm8( const float value ) {
+		return static_cast< uint8_t >( std::lrint( fminf( fmaxf( value, 0 ), 1.0f ) * 255.0f ) );
+	}
+
+	inline uint8_t LinearToSrgb8( const float value ) {
+		// fmaxf vraci pro NaN druhy operand
+		const float clamped = fminf( fmaxf( value, SRGB_MIN ), SRGB_ALMOST_ONE );
+		uint32_t bits;
+		std::memcpy( &bits, &clamped, sizeof( bits ) );
+		const uint32_t entry = SRGB_TABLE[ ( bits - SRGB_MIN_BITS ) >> 20 ];
+		const uint32_t t = ( bits >> 12 ) & 0xff;
+		return static_cast< uint8_t >( ( ( entry >> 16 ) * 512 + ( entry & 0xffff ) * t ) >> 16 );
+	}
+
+	inline uint8_t EncodeChannel( const float value, const ColorEncoding encoding ) {
+		return encoding == ColorEncoding::SRGB ? LinearToSrgb8( value ) : LinearToUnorm8( value );
+	}
+
+	// RGB -> HSV, skalarni a SSE2 implementace pocitaji stejne
+	inline void RGBToHSV( const Color& color, Vector& hsv ) {
+		const float r = fminf( fmaxf( color.r, 0 ), 1.0f );
+		const float g = fminf( fmaxf( color.g, 0 ), 1.0f );
+		const float b = fminf( fmaxf( color.b, 0 ), 1.0f );
+		const float maxc = fmaxf( r, fmaxf( g, b ) );
+		const float minc = fminf( r, fminf( g, b ) );
+		const float delta = maxc - minc;
+
+		// sektor barevneho kruhu (0 - 6)
+		float h = 0;
+		if ( delta > 0 ) {
+			if ( maxc == r ) {
+				h = ( g - b ) / delta;
+			} else if ( maxc == g ) {
+				h = ( b - r ) / delta + 2.0f;
+			} else {
+				h = ( r - g ) / delta + 4.0f;
+			}
+			if ( h < 0 ) {
+				h += 6.0f;
+			}
+		}
+		hsv.x = h / 6.0f;
+		hsv.y = maxc > 0 ? delta / maxc : 0;
+		hsv.z = maxc;
+		hsv.w = color.a;
+	}
+
+	/*
+	HSV -> RGB: kanal = v - v * s * max( 0, min( k, 4 - k, 1 ) ), k = ( n + 6 * h ) mod 6, n = 5, 3, 1 pro r, g, b
+	*/
+	inline float HSVChannel( const float n, const float h6, const float vs, const float v ) {
+		float k = n + h6;
+		if ( k >= 6.0f ) {
+			k -= 6.0f;
+		}
+		return v - vs * fmaxf( fminf( fminf( k, 4.0f - k ), 1.0f ), 0 );
+	}
+
+	inline void HSVToRGB( const Vector& hsv, Color& color ) {
+		const float h6 = fminf( fmaxf( hsv.x, 0 ), 1.0f ) * 6.0f;
+		const float s = fminf( fmaxf( hsv.y, 0 ), 1.0f );
+		const float v = fminf( fmaxf( hsv.z, 0 ), 1.0f );
+		const float vs = v * s;
+		color.r = HSVChannel( 5.0f, h6, vs, v );
+		color.g = HSVChannel( 3.0f, h6, vs, v );
+		color.b = HSVChannel( 1.0f, h6, vs, v );
+		color.a = hsv.w;
+	}
+
+#ifdef SIMD_SSE2
+
+	inline __m128 Select( const __m128 mask, const __m128 a, const __m128 b ) {
+		return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+	}
+
+	inline __m128 Clamp01( const __m128 v ) {
+		return _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps( 1.0f ) );
+	}
+
+	// 4 hodnoty -> sRGB (int32), polozky tabulky se nacitaji jednotlive (SSE2 nema gather)
+	inline __m128i LinearToSrgb8( const __m128 v ) {
+		const __m128 clamped = _mm_min_ps( _mm_max_ps( v, _mm_set1_ps( SRGB_MIN ) ), _mm_set1_ps( SRGB_ALMOST_ONE ) );
+		const __m128i bits = _mm_castps_si128( clamped );
+		alignas( 16 ) uint32_t index[ 4 ];
+		_mm_store_si128( reinterpret_cast< __m128i* >( index ), _mm_srli_epi32( _mm_sub_epi32( bits, _mm_set1_epi32( SRGB_MIN_BITS ) ), 20 ) );
+		const __m128i entry = _mm_setr_epi32(
+			static_cast< int >( SRGB_TABLE[ index[ 0 ] ] ),
+			static_cast< int >( SRGB_TABLE[ index[ 1 ] ] ),
+			static_cast< int >( SRGB_TABLE[ index[ 2 ] ] ),
+			static_cast< int >( SRGB_TABLE[ index[ 3 ] ] )
+		);
+
+		// madd: scale * t + bias * 512 (dvojice 16 bitovych slozek)
+		const __m128i t = _mm_or_si128( _mm_and_si128( _mm_srli_epi32( bits, 12 ), _mm_set1_epi32( 0xff ) ), _mm_set1_epi32( 0x02000000 ) );
+		return _mm_srli_epi32( _mm_madd_epi16( entry, t ), 16 );
+	}
+
+	/*
+	Jeden pixel v registru, REVERSED: poradi kanalu ColorUnorm ( a, b, g, r ).
+	Alfa je vzdy linearni, v registru je na pozici 3 (pro REVERSED na pozici 0).
+	*/
+	template < bool REVERSED >
+	inline __m128i EncodePixel( const Color* const src, const ColorEncoding encoding ) {
+		__m128 color = _mm_loadu_ps( &src->r );
+		if ( REVERSED ) {
+			color = _mm_shuffle_ps( color, color, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+		}
+		const __m128i linear = _mm_cvtps_epi32( _mm_mul_ps( Clamp01( color ), _mm_set1_ps( 255.0f ) ) );
+		if ( encoding == ColorEncoding::LINEAR ) {
+			return linear;
+		}
+		const __m128i alpha = REVERSED ? _mm_setr_epi32( -1, 0, 0, 0 ) : _mm_setr_epi32( 0, 0, 0, -1 );
+		return _mm_or_si128( _mm_and_si128( alpha, linear ), _mm_andnot_si128( alpha, LinearToSrgb8( color ) ) );
+	}
+
+	// 4 pixely do 16 bajtu
+	template < bool REVERSED >
+	inline void EncodeQuad( const Color* const src, void* const dest, const ColorEncoding encoding ) {
+		const __m128i low = _mm_packs_epi32( EncodePixel< REVERSED >( src, encoding ), EncodePixel< REVERSED >( src + 1, encoding ) );
+		const __m128i high = _mm_packs_epi32( EncodePixel< REVERSED >( src + 2, encoding ), EncodePixel< REVERSED >( src + 3, encoding ) );
+		_mm_storeu_si128( reinterpret_cast< __m128i* >( dest ), _mm_packus_epi16( low, high ) );
+	}
+
+	// 4 pixely ze 16 bajtu, linearni kodovani
+	template < bool REVERSED >
+	inline void DecodeQuad( const void* const src, Color* const dest ) {
+		const __m128i bytes = _mm_loadu_si128( reinterpret_cast< const __m128i* >( src ) );
+		const __m128i low = _mm_unpacklo_epi8( bytes, _mm_setzero_si128() );
+		const __m128i high = _mm_unpackhi_epi8( bytes, _mm_setzero_si128() );
+		const __m128i pixels[ 4 ] = {
+			_mm_unpacklo_epi16( low, _mm_setzero_si128() ),
+			_mm_unpackhi_epi16( low, _mm_setzero_si128() ),
+			_mm_unpacklo_epi16( high, _mm_setzero_si128() ),
+			_mm_unpackhi_epi16( high, _mm_setzero_si128() )
+		};
+		for ( int i = 0; i < 4; i++ ) {
+			__m128 color = _mm_div_ps( _mm_cvtepi32_ps( pixels[ i ] ), _mm_set1_ps( 255.0f ) );
+			if ( REVERSED ) {
+				color = _mm_shuffle_ps( color, color, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+			}
+			_mm_storeu_ps( &dest[ i ].r, color );
+		}
+	}
+
+	inline void Transpose( __m128& r0, __m128& r1, __m128& r2, __m128& r3 ) {
+		_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+	}
+
+#endif
+
+	template < bool REVERSED >
+	void EncodeColors( const Color* const src, uint8_t* const dest, const std::size_t count, const ColorEncoding encoding ) {
+		std::size_t i = 0;
+	#ifdef SIMD_SSE2
+		for ( ; i + 16 <= count; i += 16 ) {
+			EncodeQuad< REVERSED >( src + i, dest + i * 4, encoding );
+			EncodeQuad< REVERSED >( src + i + 4, dest + i * 4 + 16, encoding );
+			EncodeQuad< REVERSED >( src + i + 8, dest + i * 4 + 32, encoding );
+			EncodeQuad< REVERSED >( src + i + 12, dest + i * 4 + 48, encoding );
+		}
+		for ( ; i + 4 <= count; i += 4 ) {
+			EncodeQuad< REVERSED >( src + i, dest + i * 4, encoding );
+		}
+	#endif
+		for ( ; i < count; i++ ) {
+			const Color& color = src[ i ];
+			const uint8_t pixel[ 4 ] = { EncodeChannel( color.r, encoding ), EncodeChannel( color.g, encoding ), EncodeChannel( color.b, encoding ), LinearToUnorm8( color.a ) };
+			uint8_t* const target = dest + i * 4;
+			for ( int c = 0; c < 4; c++ ) {
+				target[ REVERSED ? 3 - c : c ] = pixel[ c ];
+			}
+		}
+	}
+
+	template < bool REVERSED >
+	void DecodeColors( const uint8_t* const src, Color* const dest, const std::size_t count, const ColorEncoding encoding ) {
+		const DecodeTables& tables = GetDecodeTables();
+		std::size_t i = 0;
+		if ( encoding == ColorEncoding::LINEAR ) {
+		#ifdef SIMD_SSE2
+			for ( ; i + 16 <= count; i += 16 ) {
+				DecodeQuad< REVERSED >( src + i * 4, dest + i );
+				DecodeQuad< REVERSED >( src + i * 4 + 16, dest + i + 4 );
+				DecodeQuad< REVERSED >( src + i * 4 + 32, dest + i + 8 );
+				DecodeQuad< REVERSED >( src + i * 4 + 48, dest + i + 12 );
+			}
+			for ( ; i + 4 <= count; i += 4 ) {
+				DecodeQuad< REVERSED >( src + i * 4, dest + i );
+			}
+		#endif
+		}
+		const float* const table = encoding == ColorEncoding::SRGB ? tables.srgb : tables.linear;
+		for ( ; i < count; i++ ) {
+			const uint8_t* const pixel = src + i * 4;
+			dest[ i ] = Color(
+				table[ pixel[ REVERSED ? 3 : 0 ] ],
+				table[ pixel[ REVERSED ? 2 : 1 ] ],
+				table[ pixel[ REVERSED ? 1 : 2 ] ],
+				tables.linear[ pixel[ REVERSED ? 0 : 3 ] ]
+			);
+		}
+	}
+
+}
+
+void ConvertColors( const Color* const src, UNorm4x8* const dest, const std::size_t count, const ColorEncoding encoding ) {
+	EncodeColors< false >( src, reinterpret_cast< uint8_t* >( dest ), count, encoding );
+}
+
+void ConvertColors( const Color* const src, ColorUnorm* const dest, const std::size_t count, const ColorEncoding encoding ) {
+	EncodeColors< true >( src, reinterpret_cast< uint8_t* >( dest ), count, encoding );
+}
+
+void ConvertColors( const UNorm4x8* const src, Color* const dest, const std::size_t count, const ColorEncoding encoding ) {
+	DecodeColors< false >( reinterpret_cast< const uint8_t* >( src ), dest, count, encoding );
+}
+
+void ConvertColors( const ColorUnorm* const src, Color* const dest, const std::size_t count, const ColorEncoding encoding ) {
+	DecodeColors< true >( reinterpret_cast< const uint8_t* >( src ), dest, count, encoding );
+}
+
+void ConvertRGBToHSV( const Color* const src, Vector* const hsv, const std::size_t count ) {
+	std::size_t i = 0;
+#ifdef SIMD_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128 r = _mm_loadu_ps( &src[ i ].r );
+		__m128 g = _mm_loadu_ps( &src[ i + 1 ].r );
+		__m128 b = _mm_loadu_ps( &src[ i + 2 ].r );
+		__m128 a = _mm_loadu_ps( &src[ i + 3 ].r );
+		Transpose( r, g, b, a );
+		r = Clamp01( r );
+		g = Clamp01( g );
+		b = Clamp01( b );
+		const __m128 maxc = _mm_max_ps( r, _mm_max_ps( g, b ) );
+		const __m128 minc = _mm_min_ps( r, _mm_min_ps( g, b ) );
+		const __m128 delta = _mm_sub_ps( maxc, minc );
+
+		// sektor barevneho kruhu, pro delta = 0 je vysledek maskovan
+		const __m128 isR = _mm_cmpeq_ps( maxc, r );
+		const __m128 isG = _mm_cmpeq_ps( maxc, g );
+		const __m128 numerator = Select( isR, _mm_sub_ps( g, b ), Select( isG, _mm_sub_ps( b, r ), _mm_sub_ps( r, g ) ) );
+		const __m128 offset = Select( isR, zero, Select( isG, _mm_set1_ps( 2.0f ), _mm_set1_ps( 4.0f ) ) );
+		__m128 h = _mm_add_ps( _mm_div_ps( numerator, delta ), offset );
+		h = _mm_add_ps( h, _mm_and_ps( _mm_cmplt_ps( h, zero ), _mm_set1_ps( 6.0f ) ) );
+		h = _mm_and_ps( _mm_cmpgt_ps( delta, zero ), h );
+
+		__m128 x = _mm_div_ps( h, _mm_set1_ps( 6.0f ) );
+		__m128 y = _mm_and_ps( _mm_cmpgt_ps( maxc, zero ), _mm_div_ps( delta, maxc ) );
+		__m128 z = maxc;
+		__m128 w = a;
+		Transpose( x, y, z, w );
+		Simd::Store( &hsv[ i ].x, x );
+		Simd::Store( &hsv[ i + 1 ].x, y );
+		Simd::Store( &hsv[ i + 2 ].x, z );
+		Simd::Store( &hsv[ i + 3 ].x, w );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		RGBToHSV( src[ i ], hsv[ i ] );
+	}
+}
+
+void ConvertHSVToRGB( const Vector* const hsv, Color* const dest, const std::size_t count ) {
+	std::size_t i = 0;
+#ifdef SIMD_SSE2
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128 h = Simd::Load( &hsv[ i ].x );
+		__m128 s = Simd::Load( &hsv[ i + 1 ].x );
+		__m128 v = Simd::Load( &hsv[ i + 2 ].x );
+		__m128 a = Simd::Load( &hsv[ i + 3 ].x );
+		Transpose( h, s, v, a );
+		const __m128 h6 = _mm_mul_ps( Clamp01( h ), _mm_set1_ps( 6.0f ) );
+		v = Clamp01( v );
+		const __m128 vs = _mm_mul_ps( v, Clamp01( s ) );
+
+		__m128 channels[ 3 ];
+		const float n[ 3 ] = { 5.0f, 3.0f, 1.0f };
+		for ( int c = 0; c < 3; c++ ) {
+			__m128 k = _mm_add_ps( _mm_set1_ps( n[ c ] ), h6 );
+			k = _mm_sub_ps( k, _mm_and_ps( _mm_cmpge_ps( k, _mm_set1_ps( 6.0f ) ), _mm_set1_ps( 6.0f ) ) );
+			const __m128 ramp = _mm_max_ps( _mm_min_ps( _mm_min_ps( k, _mm_sub_ps( _mm_set1_ps( 4.0f ), k ) ), _mm_set1_ps( 1.0f ) ), _mm_setzero_ps() );
+			channels[ c ] = _mm_sub_ps( v, _mm_mul_ps( vs, ramp ) );
+		}
+		Transpose( channels[ 0 ], channels[ 1 ], channels[ 2 ], a );
+		_mm_storeu_ps( &dest[ i ].r, channels[ 0 ] );
+		_mm_storeu_ps( &dest[ i + 1 ].r, channels[ 1 ] );
+		_mm_storeu_ps( &dest[ i + 2 ].r, channels[ 2 ] );
+		_mm_storeu_ps( &dest[ i + 3 ].r, a );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		HSVToRGB( hsv[ i ], dest[ i ] );
+	}
+}
\ No newline at end of file
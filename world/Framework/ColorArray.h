@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include "Types.h"
+#include "Vector.h"
+#include "Color.h"
+
+/*
+Kodovani 8 bitovych barev.
+LINEAR: hodnoty kanalu jsou ulozeny primo (R8G8B8A8_UNORM).
+SRGB: kanaly r, g, b jsou ulozeny s prenosovou funkci sRGB (data textur a back bufferu R8G8B8A8_UNORM_SRGB,
+obrazky, screenshoty), alfa je vzdy linearni.
+*/
+enum class ColorEncoding {
+	LINEAR,
+	SRGB
+};
+
+/*
+Hromadny prevod barev, 16 pixelu v jedne iteraci (SSE2), zbytek pole skalarne se stejnym vysledkem.
+Color -> 8 bit: kanaly jsou orezany do rozsahu < 0; 1 > (NaN na 0) a zaokrouhleny k nejblizsi hodnote
+(Color::ToUnorm() zaokrouhluje dolu). Prevod do sRGB pouziva tabulku linearnich useku po 1/8 exponentu,
+chyba je nejvyse 0.57 jednotky (nespravne zaokrouhleny mohou byt jen hodnoty do 0.07 jednotky od poloviny).
+8 bit -> Color: presne hodnoty (c / 255, pro SRGB prevedene inverzni prenosovou funkci).
+Vystup se jen zapisuje postupne, lze zapisovat primo do namapovaneho bufferu. Pole se nesmi prekryvat.
+*/
+void ConvertColors( const Color* const src, UNorm4x8* const dest, const std::size_t count, const ColorEncoding encoding = ColorEncoding::LINEAR );
+void ConvertColors( const Color* const src, ColorUnorm* const dest, const std::size_t count, const ColorEncoding encoding = ColorEncoding::LINEAR );
+void ConvertColors( const UNorm4x8* const src, Color* const dest, const std::size_t count, const ColorEncoding encoding = ColorEncoding::LINEAR );
+void ConvertColors( const ColorUnorm* const src, Color* const dest, const std::size_t count, const ColorEncoding encoding = ColorEncoding::LINEAR );
+
+/*
+Prevod mezi RGB a HSV, hsv[ i ] = ( h, s, v, a ), vsechny slozky v rozsahu < 0; 1 > (h = 1 odpovida 360 stupnum).
+Vstupni hodnoty jsou orezany do rozsahu < 0; 1 >, alfa se kopiruje beze zmeny. Stejny vypocet pouzivaji Color::SetHSV() a Color::GetHSV().
+*/
+void ConvertRGBToHSV( const Color* const src, Vector* const hsv, const std::size_t count );
+void ConvertHSVToRGB( const Vector* const hsv, Color* const dest, const std::size_t count );
\ No newline at end of file
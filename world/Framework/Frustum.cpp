@@ -0,0 +1,258 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "Frustum.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+static_assert( CULL_PARALLEL_BATCH % 8 == 0, "CULL_PARALLEL_BATCH must be a multiple of 8" );
+
+// class Frustum
+
+Frustum::Frustum() {
+	for ( int i = 0; i < FRUSTUM_PLANES_COUNT; i++ ) {
+		planes[ i ] = Float4( 0, 0, 0, 1.0f );
+	}
+}
+
+Frustum::Frustum( const Matrix& viewProjection ) {
+	Set( viewProjection );
+}
+
+void Frustum::Set( const Matrix& m ) {
+	// bod v je uvnitr, pokud pro v * m = ( x, y, z, w ) plati -w <= x <= w, -w <= y <= w, 0 <= z <= w
+	// roviny jsou tedy soucty a rozdily sloupcu matice
+	const float sign[ FRUSTUM_PLANES_COUNT ] = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+	const int column[ FRUSTUM_PLANES_COUNT ] = { 0, 0, 1, 1, 2, 2 };
+	for ( int i = 0; i < FRUSTUM_PLANES_COUNT; i++ ) {
+		const int j = column[ i ];
+		const float w = i == 4 ? 0 : 1.0f;
+		Float4 plane(
+			m.m[ 0 ][ 3 ] * w + m.m[ 0 ][ j ] * sign[ i ],
+			m.m[ 1 ][ 3 ] * w + m.m[ 1 ][ j ] * sign[ i ],
+			m.m[ 2 ][ 3 ] * w + m.m[ 2 ][ j ] * sign[ i ],
+			m.m[ 3 ][ 3 ] * w + m.m[ 3 ][ j ] * sign[ i ]
+		);
+		const float length = std::sqrt( plane.x * plane.x + plane.y * plane.y + plane.z * plane.z );
+		plane.x /= length;
+		plane.y /= length;
+		plane.z /= length;
+		plane.w /= length;
+		planes[ i ] = plane;
+	}
+}
+
+bool Frustum::TestSphere( const Vector& center, const float radius ) const {
+	for ( int i = 0; i < FRUSTUM_PLANES_COUNT; i++ ) {
+		const Float4& p = planes[ i ];
+		if ( p.x * center.x + p.y * center.y + p.z * center.z + p.w + radius < 0 ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::TestBox( const Vector& min, const Vector& max ) const {
+	// testuje se vrchol boxu nejdale ve smeru normaly roviny
+	for ( int i = 0; i < FRUSTUM_PLANES_COUNT; i++ ) {
+		const Float4& p = planes[ i ];
+		const float x = p.x >= 0 ? max.x : min.x;
+		const float y = p.y >= 0 ? max.y : min.y;
+		const float z = p.z >= 0 ? max.z : min.z;
+		if ( p.x * x + p.y * y + p.z * z + p.w < 0 ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// kernely
+
+namespace {
+
+#ifdef SIMD_AVX2
+	inline __m256 MulAdd( const __m256 a, const __m256 b, const __m256 c ) {
+	#ifdef SIMD_FMA
+		return _mm256_fmadd_ps( a, b, c );
+	#else
+		return _mm256_add_ps( _mm256_mul_ps( a, b ), c );
+	#endif
+	}
+#endif
+
+	/*
+	Zapise indexy base + k objektu, ktere maji v masce nastaven bit k. Zapisuje se bez vetveni, kazdy index je zapsan
+	a pozice se posune jen pro viditelny objekt. Zapis nikdy neprekroci index testovaneho objektu.
+	*/
+	inline std::size_t Emit( uint32_t* const visible, std::size_t n, const std::size_t base, const int mask, const int lanes ) {
+		for ( int k = 0; k < lanes; k++ ) {
+			visible[ n ] = static_cast< uint32_t >( base + k );
+			n += ( mask >> k ) & 1;
+		}
+		return n;
+	}
+
+	// objekt je viditelny, pokud neni vzdalenost od zadne roviny zaporna (NaN je povazovan za viditelny)
+	std::size_t CullSpheres( const Float4* const planes, const BoundingSphereArrays& spheres, const std::size_t begin, const std::size_t end, uint32_t* const visible ) {
+		std::size_t n = 0;
+		std::size_t i = begin;
+	#ifdef SIMD_AVX2
+		{
+			__m256 a[ FRUSTUM_PLANES_COUNT ], b[ FRUSTUM_PLANES_COUNT ], c[ FRUSTUM_PLANES_COUNT ], d[ FRUSTUM_PLANES_COUNT ];
+			for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+				a[ p ] = _mm256_set1_ps( planes[ p ].x );
+				b[ p ] = _mm256_set1_ps( planes[ p ].y );
+				c[ p ] = _mm256_set1_ps( planes[ p ].z );
+				d[ p ] = _mm256_set1_ps( planes[ p ].w );
+			}
+			for ( ; i + 8 <= end; i += 8 ) {
+				const __m256 x = _mm256_loadu_ps( spheres.x + i );
+				const __m256 y = _mm256_loadu_ps( spheres.y + i );
+				const __m256 z = _mm256_loadu_ps( spheres.z + i );
+				const __m256 r = _mm256_loadu_ps( spheres.radius + i );
+				__m256 distance = MulAdd( x, a[ 0 ], MulAdd( y, b[ 0 ], MulAdd( z, c[ 0 ], _mm256_add_ps( d[ 0 ], r ) ) ) );
+				for ( int p = 1; p < FRUSTUM_PLANES_COUNT; p++ ) {
+					distance = _mm256_min_ps( distance, MulAdd( x, a[ p ], MulAdd( y, b[ p ], MulAdd( z, c[ p ], _mm256_add_ps( d[ p ], r ) ) ) ) );
+				}
+				const int outside = _mm256_movemask_ps( _mm256_cmp_ps( distance, _mm256_setzero_ps(), _CMP_LT_OQ ) );
+				n = Emit( visible, n, i, ~outside, 8 );
+			}
+		}
+	#endif
+		{
+			Simd::Vec4 a[ FRUSTUM_PLANES_COUNT ], b[ FRUSTUM_PLANES_COUNT ], c[ FRUSTUM_PLANES_COUNT ], d[ FRUSTUM_PLANES_COUNT ];
+			for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+				a[ p ] = Simd::Replicate( planes[ p ].x );
+				b[ p ] = Simd::Replicate( planes[ p ].y );
+				c[ p ] = Simd::Replicate( planes[ p ].z );
+				d[ p ] = Simd::Replicate( planes[ p ].w );
+			}
+			for ( ; i + 4 <= end; i += 4 ) {
+				const Simd::Vec4 x = Simd::LoadUnaligned( spheres.x + i );
+				const Simd::Vec4 y = Simd::LoadUnaligned( spheres.y + i );
+				const Simd::Vec4 z = Simd::LoadUnaligned( spheres.z + i );
+				const Simd::Vec4 r = Simd::LoadUnaligned( spheres.radius + i );
+				Simd::Vec4 distance = Simd::MulAdd( x, a[ 0 ], Simd::MulAdd( y, b[ 0 ], Simd::MulAdd( z, c[ 0 ], Simd::Add( d[ 0 ], r ) ) ) );
+				for ( int p = 1; p < FRUSTUM_PLANES_COUNT; p++ ) {
+					distance = Simd::Min( distance, Simd::MulAdd( x, a[ p ], Simd::MulAdd( y, b[ p ], Simd::MulAdd( z, c[ p ], Simd::Add( d[ p ], r ) ) ) ) );
+				}
+				n = Emit( visible, n, i, ~Simd::LessMask( distance, Simd::Zero() ), 4 );
+			}
+		}
+
+		// konec pole
+		for ( ; i < end; i++ ) {
+			float distance = 0;
+			for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+				const float dp = spheres.x[ i ] * planes[ p ].x + ( spheres.y[ i ] * planes[ p ].y + ( spheres.z[ i ] * planes[ p ].z + ( planes[ p ].w + spheres.radius[ i ] ) ) );
+				distance = p == 0 || dp < distance ? dp : distance;
+			}
+			n = Emit( visible, n, i, distance < 0 ? 0 : 1, 1 );
+		}
+		return n;
+	}
+
+	// pro kazdou rovinu se testuje vrchol boxu nejdale ve smeru normaly, tj. slozky se vybiraji z min nebo max podle znamenka normaly
+	std::size_t CullBoxes( const Float4* const planes, const BoundingBoxArrays& boxes, const std::size_t begin, const std::size_t end, uint32_t* const visible ) {
+		const float* px[ FRUSTUM_PLANES_COUNT ];
+		const float* py[ FRUSTUM_PLANES_COUNT ];
+		const float* pz[ FRUSTUM_PLANES_COUNT ];
+		for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+			px[ p ] = planes[ p ].x >= 0 ? boxes.maxX : boxes.minX;
+			py[ p ] = planes[ p ].y >= 0 ? boxes.maxY : boxes.minY;
+			pz[ p ] = planes[ p ].z >= 0 ? boxes.maxZ : boxes.minZ;
+		}
+
+		std::size_t n = 0;
+		std::size_t i = begin;
+	#ifdef SIMD_AVX2
+		{
+			__m256 a[ FRUSTUM_PLANES_COUNT ], b[ FRUSTUM_PLANES_COUNT ], c[ FRUSTUM_PLANES_COUNT ], d[ FRUSTUM_PLANES_COUNT ];
+			for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+				a[ p ] = _mm256_set1_ps( planes[ p ].x );
+				b[ p ] = _mm256_set1_ps( planes[ p ].y );
+				c[ p ] = _mm256_set1_ps( planes[ p ].z );
+				d[ p ] = _mm256_set1_ps( planes[ p ].w );
+			}
+			for ( ; i + 8 <= end; i += 8 ) {
+				__m256 distance = MulAdd( _mm256_loadu_ps( px[ 0 ] + i ), a[ 0 ], MulAdd( _mm256_loadu_ps( py[ 0 ] + i ), b[ 0 ], MulAdd( _mm256_loadu_ps( pz[ 0 ] + i ), c[ 0 ], d[ 0 ] ) ) );
+				for ( int p = 1; p < FRUSTUM_PLANES_COUNT; p++ ) {
+					distance = _mm256_min_ps( distance, MulAdd( _mm256_loadu_ps( px[ p ] + i ), a[ p ], MulAdd( _mm256_loadu_ps( py[ p ] + i ), b[ p ], MulAdd( _mm256_loadu_ps( pz[ p ] + i ), c[ p ], d[ p ] ) ) ) );
+				}
+				const int outside = _mm256_movemask_ps( _mm256_cmp_ps( distance, _mm256_setzero_ps(), _CMP_LT_OQ ) );
+				n = Emit( visible, n, i, ~outside, 8 );
+			}
+		}
+	#endif
+		{
+			Simd::Vec4 a[ FRUSTUM_PLANES_COUNT ], b[ FRUSTUM_PLANES_COUNT ], c[ FRUSTUM_PLANES_COUNT ], d[ FRUSTUM_PLANES_COUNT ];
+			for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+				a[ p ] = Simd::Replicate( planes[ p ].x );
+				b[ p ] = Simd::Replicate( planes[ p ].y );
+				c[ p ] = Simd::Replicate( planes[ p ].z );
+				d[ p ] = Simd::Replicate( planes[ p ].w );
+			}
+			for ( ; i + 4 <= end; i += 4 ) {
+				Simd::Vec4 distance = Simd::MulAdd( Simd::LoadUnaligned( px[ 0 ] + i ), a[ 0 ], Simd::MulAdd( Simd::LoadUnaligned( py[ 0 ] + i ), b[ 0 ], Simd::MulAdd( Simd::LoadUnaligned( pz[ 0 ] + i ), c[ 0 ], d[ 0 ] ) ) );
+				for ( int p = 1; p < FRUSTUM_PLANES_COUNT; p++ ) {
+					distance = Simd::Min( distance, Simd::MulAdd( Simd::LoadUnaligned( px[ p ] + i ), a[ p ], Simd::MulAdd( Simd::LoadUnaligned( py[ p ] + i ), b[ p ], Simd::MulAdd( Simd::LoadUnaligned( pz[ p ] + i ), c[ p ], d[ p ] ) ) ) );
+				}
+				n = Emit( visible, n, i, ~Simd::LessMask( distance, Simd::Zero() ), 4 );
+			}
+		}
+
+		// konec pole
+		for ( ; i < end; i++ ) {
+			float distance = 0;
+			for ( int p = 0; p < FRUSTUM_PLANES_COUNT; p++ ) {
+				const float dp = px[ p ][ i ] * planes[ p ].x + ( py[ p ][ i ] * planes[ p ].y + ( pz[ p ][ i ] * planes[ p ].z + planes[ p ].w ) );
+				distance = p == 0 || dp < distance ? dp : distance;
+			}
+			n = Emit( visible, n, i, distance < 0 ? 0 : 1, 1 );
+		}
+		return n;
+	}
+
+	/*
+	Pri paralelnim zpracovani zapisuje kazda cast indexy do pole visible od indexu sveho prvniho objektu,
+	vysledky casti jsou nakonec presunuty za sebe.
+	*/
+	template < typename Function >
+	std::size_t Cull( const std::size_t count, uint32_t* const visible, const bool parallel, const Function& cullRange ) {
+		if ( !parallel || count <= CULL_PARALLEL_BATCH ) {
+			return cullRange( 0, count, visible );
+		}
+		std::vector< std::size_t > counts( ( count + CULL_PARALLEL_BATCH - 1 ) / CULL_PARALLEL_BATCH, 0 );
+		ParallelFor( count, CULL_PARALLEL_BATCH, [ & ]( const std::size_t begin, const std::size_t end ) {
+			counts[ begin / CULL_PARALLEL_BATCH ] = cullRange( begin, end, visible + begin );
+		} );
+		std::size_t n = counts[ 0 ];
+		for ( std::size_t batch = 1; batch < counts.size(); batch++ ) {
+			if ( counts[ batch ] > 0 ) {
+				std::memmove( visible + n, visible + batch * CULL_PARALLEL_BATCH, counts[ batch ] * sizeof( uint32_t ) );
+				n += counts[ batch ];
+			}
+		}
+		return n;
+	}
+}
+
+std::size_t CullSpheres( const Frustum& frustum, const BoundingSphereArrays& spheres, const std::size_t count, uint32_t* const visible, const bool parallel ) {
+	Float4 planes[ FRUSTUM_PLANES_COUNT ];
+	for ( int i = 0; i < FRUSTUM_PLANES_COUNT; i++ ) {
+		planes[ i ] = frustum.GetPlane( i );
+	}
+	return Cull( count, visible, parallel, [ & ]( const std::size_t begin, const std::size_t end, uint32_t* const dest ) {
+		return CullSpheres( planes, spheres, begin, end, dest );
+	} );
+}
+
+std::size_t CullBoxes( const Frustum& frustum, const BoundingBoxArrays& boxes, const std::size_t count, uint32_t* const visible, const bool parallel ) {
+	Float4 planes[ FRUSTUM_PLANES_COUNT ];
+	for ( int i = 0; i < FRUSTUM_PLANES_COUNT; i++ ) {
+		planes[ i ] = frustum.GetPlane( i );
+	}
+	return Cull( count, visible, parallel, [ & ]( const std::size_t begin, const std::size_t end, uint32_t* const dest ) {
+		return CullBoxes( planes, boxes, begin, end, dest );
+	} );
+}
\ No newline at end of file
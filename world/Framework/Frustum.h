@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Types.h"
+#include "Vector.h"
+#include "Matrix.h"
+
+const int FRUSTUM_PLANES_COUNT = 6;
+
+/*
+Frustum: roviny orezoveho objemu ( a, b, c, d ), bod ( x, y, z ) je uvnitr, pokud a * x + b * y + c * z + d >= 0 pro vsechny roviny.
+Roviny jsou ziskany z matice view * projection (projekce s hloubkou 0 - 1 jako PerspectiveLH),
+v poradi left, right, bottom, top, near, far. Normaly rovin jsou normalizovane.
+Testy jsou konzervativni: objekt muze byt oznacen za viditelny, i kdyz lezi mimo frustum blizko jeho rohu.
+*/
+class alignas( 16 ) Frustum {
+public:
+	// frustum obsahujici cely prostor
+	Frustum();
+	explicit Frustum( const Matrix& viewProjection );
+
+	void Set( const Matrix& viewProjection );
+
+	const Float4& GetPlane( const int index ) const;
+
+	// test jednoho objektu
+	bool TestSphere( const Vector& center, const float radius ) const;
+	bool TestBox( const Vector& min, const Vector& max ) const;
+
+private:
+	Float4 planes[ FRUSTUM_PLANES_COUNT ];
+};
+
+inline const Float4& Frustum::GetPlane( const int index ) const {
+	return planes[ index ];
+}
+
+// pole bounding spheres ulozene po slozkach
+struct BoundingSphereArrays {
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* radius;
+};
+
+// pole axis aligned bounding boxes ulozene po slozkach
+struct BoundingBoxArrays {
+	const float* minX;
+	const float* minY;
+	const float* minZ;
+	const float* maxX;
+	const float* maxY;
+	const float* maxZ;
+};
+
+/*
+Test viditelnosti pole objektu. Indexy viditelnych objektu jsou zapsany vzestupne do pole visible, vraci pocet viditelnych objektu.
+Pole visible musi mit velikost alespon count (je pouzito i jako pracovni pamet), count musi byt mensi nez 2^32.
+Objekty jsou testovany po 8 (AVX2) nebo 4 (SSE) najednou, pole nemusi byt zarovnana.
+Pri parallel jsou pole delsi nez CULL_PARALLEL_BATCH rozdelena mezi vlakna ParallelFor.
+*/
+const std::size_t CULL_PARALLEL_BATCH = 16 * 1024;
+
+std::size_t CullSpheres( const Frustum& frustum, const BoundingSphereArrays& spheres, const std::size_t count, uint32_t* const visible, const bool parallel = false );
+std::size_t CullBoxes( const Frustum& frustum, const BoundingBoxArrays& boxes, const std::size_t count, uint32_t* const visible, const bool parallel = false );
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "Half.h"
+#include "Simd.h"
+
+/*
+Vektorove kernely zpracovavaji 8 hodnot najednou, zbytek pole prevadi skalarni funkce.
+SSE2 implementace pocita stejne jako skalarni funkce (viz Half.h), vetve jsou nahrazeny vyberem podle masky.
+*/
+namespace {
+
+#if defined( SIMD_SSE2 ) && !defined( SIMD_F16C )
+
+	inline __m128i Select( const __m128i mask, const __m128i a, const __m128i b ) {
+		return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+	}
+
+	inline __m128i Constant( const uint32_t value ) {
+		return _mm_set1_epi32( static_cast< int >( value ) );
+	}
+
+	// 4 hodnoty float -> half v dolnich 16 bitech kazde slozky
+	inline __m128i FloatToHalf4( const __m128 value ) {
+		__m128i bits = _mm_castps_si128( value );
+		const __m128i sign = _mm_and_si128( bits, Constant( 0x80000000 ) );
+		bits = _mm_xor_si128( bits, sign );
+
+		// nekonecno a NaN
+		const __m128i huge = _mm_cmpgt_epi32( bits, Constant( 0x477fffff ) );
+		const __m128i nan = _mm_cmpgt_epi32( bits, Constant( 0x7f800000 ) );
+		const __m128i payload = _mm_or_si128( Constant( 0x0200 ), _mm_and_si128( _mm_srli_epi32( bits, 13 ), Constant( 0x03ff ) ) );
+		const __m128i infinity = _mm_or_si128( Constant( 0x7c00 ), _mm_and_si128( nan, payload ) );
+
+		// denormalni vysledek
+		const __m128i small = _mm_cmplt_epi32( bits, Constant( 0x38800000 ) );
+		const __m128 shifted = _mm_add_ps( _mm_castsi128_ps( bits ), _mm_set1_ps( 0.5f ) );
+		const __m128i denormal = _mm_sub_epi32( _mm_castps_si128( shifted ), Constant( 0x3f000000 ) );
+
+		// normalni vysledek
+		const __m128i odd = _mm_and_si128( _mm_srli_epi32( bits, 13 ), Constant( 1 ) );
+		const __m128i normal = _mm_srli_epi32( _mm_add_epi32( _mm_add_epi32( bits, Constant( 0xc8000fff ) ), odd ), 13 );
+
+		const __m128i result = Select( huge, infinity, Select( small, denormal, normal ) );
+		return _mm_or_si128( result, _mm_srli_epi32( sign, 16 ) );
+	}
+
+	// 4 hodnoty half v dolnich 16 bitech kazde slozky -> float
+	inline __m128 HalfToFloat4( const __m128i value ) {
+		const __m128i sign = _mm_slli_epi32( _mm_and_si128( value, Constant( 0x8000 ) ), 16 );
+		const __m128i exponent = _mm_and_si128( value, Constant( 0x7c00 ) );
+		const __m128i bits = _mm_slli_epi32( _mm_and_si128( value, Constant( 0x7fff ) ), 13 );
+
+		// nekonecno a NaN
+		const __m128i special = _mm_cmpeq_epi32( exponent, Constant( 0x7c00 ) );
+		const __m128i quiet = _mm_and_si128( _mm_cmpgt_epi32( bits, Constant( 0x0f800000 ) ), Constant( 0x00400000 ) );
+		const __m128i infinity = _mm_or_si128( _mm_add_epi32( bits, Constant( 0x70000000 ) ), quiet );
+
+		// denormalni cislo
+		const __m128i zero = _mm_cmpeq_epi32( exponent, _mm_setzero_si128() );
+		const __m128 denormal = _mm_sub_ps( _mm_castsi128_ps( _mm_add_epi32( bits, Constant( 0x38800000 ) ) ), _mm_set1_ps( 6.103515625e-05f ) );
+
+		const __m128i normal = _mm_add_epi32( bits, Constant( 0x38000000 ) );
+		const __m128i result = Select( special, infinity, Select( zero, _mm_castps_si128( denormal ), normal ) );
+		return _mm_castsi128_ps( _mm_or_si128( result, sign ) );
+	}
+
+	// prevede 32 bitove slozky na 16 bitove (packs saturuje se znamenkem, proto nejdrive znamenkove rozsireni)
+	inline __m128i Pack( const __m128i low, const __m128i high ) {
+		return _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( low, 16 ), 16 ), _mm_srai_epi32( _mm_slli_epi32( high, 16 ), 16 ) );
+	}
+
+#endif
+
+}
+
+void FloatToHalf( const float* const in, uint16_t* const out, const std::size_t count ) {
+	std::size_t i = 0;
+#if defined( SIMD_F16C )
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m128i result = _mm256_cvtps_ph( _mm256_loadu_ps( in + i ), _MM_FROUND_TO_NEAREST_INT );
+		_mm_storeu_si128( reinterpret_cast< __m128i* >( out + i ), result );
+	}
+#elif defined( SIMD_SSE2 )
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m128i low = FloatToHalf4( _mm_loadu_ps( in + i ) );
+		const __m128i high = FloatToHalf4( _mm_loadu_ps( in + i + 4 ) );
+		_mm_storeu_si128( reinterpret_cast< __m128i* >( out + i ), Pack( low, high ) );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		out[ i ] = FloatToHalf( in[ i ] );
+	}
+}
+
+void HalfToFloat( const uint16_t* const in, float* const out, const std::size_t count ) {
+	std::size_t i = 0;
+#if defined( SIMD_F16C )
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m128i value = _mm_loadu_si128( reinterpret_cast< const __m128i* >( in + i ) );
+		_mm256_storeu_ps( out + i, _mm256_cvtph_ps( value ) );
+	}
+#elif defined( SIMD_SSE2 )
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m128i value = _mm_loadu_si128( reinterpret_cast< const __m128i* >( in + i ) );
+		_mm_storeu_ps( out + i, HalfToFloat4( _mm_unpacklo_epi16( value, _mm_setzero_si128() ) ) );
+		_mm_storeu_ps( out + i + 4, HalfToFloat4( _mm_unpackhi_epi16( value, _mm_setzero_si128() ) ) );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		out[ i ] = HalfToFloat( in[ i ] );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+Prevod mezi float a half (IEEE 754 binary16) pro formaty R16G16B16A16_FLOAT, R16G16_FLOAT a R16_FLOAT.
+Float -> half zaokrouhluje k nejblizsi hodnote (pri shode k sude), hodnoty nad 65504 prevadi na nekonecno,
+male hodnoty na denormalni cisla nebo 0. NaN zustava NaN (quiet) se zachovanym znamenkem a hornimi bity mantisy.
+Half -> float je presny (kazdou half hodnotu lze vyjadrit ve float).
+Vysledky jsou shodne s instrukcemi F16C, skalarni i vektorove implementace davaji stejne bity.
+*/
+
+inline uint16_t FloatToHalf( const float value ) {
+	uint32_t bits;
+	std::memcpy( &bits, &value, sizeof( bits ) );
+	const uint32_t sign = ( bits >> 16 ) & 0x8000;
+	bits &= 0x7fffffff;
+
+	// nekonecno a NaN, hodnoty >= 65536 (hodnoty od 65520 prevede na nekonecno zaokrouhleni v posledni vetvi)
+	if ( bits >= 0x47800000 ) {
+		if ( bits > 0x7f800000 ) {
+			return static_cast< uint16_t >( sign | 0x7e00 | ( ( bits >> 13 ) & 0x03ff ) );
+		}
+		return static_cast< uint16_t >( sign | 0x7c00 );
+	}
+
+	// vysledek je denormalni (< 2^-14): pricteni 0.5 posune mantisu na spravne misto a zaokrouhli ji
+	if ( bits < 0x38800000 ) {
+		float f;
+		std::memcpy( &f, &bits, sizeof( f ) );
+		f += 0.5f;
+		std::memcpy( &bits, &f, sizeof( bits ) );
+		return static_cast< uint16_t >( sign | ( bits - 0x3f000000 ) );
+	}
+
+	// zmena biasu exponentu a zaokrouhleni mantisy, preteceni mantisy zvysi exponent
+	const uint32_t odd = ( bits >> 13 ) & 1;
+	bits += 0xc8000fff + odd;
+	return static_cast< uint16_t >( sign | ( bits >> 13 ) );
+}
+
+inline float HalfToFloat( const uint16_t value ) {
+	const uint32_t sign = static_cast< uint32_t >( value & 0x8000 ) << 16;
+	const uint32_t exponent = value & 0x7c00;
+	uint32_t bits = static_cast< uint32_t >( value & 0x7fff ) << 13;
+	float result;
+	if ( exponent == 0x7c00 ) {
+		// nekonecno a NaN (signaling NaN je preveden na quiet)
+		bits += 0x70000000;
+		if ( bits != 0x7f800000 ) {
+			bits |= 0x00400000;
+		}
+	} else if ( exponent == 0 ) {
+		// denormalni cislo: mantisa * 2^-24 pres odecteni 2^-14
+		bits += 0x38800000;
+		std::memcpy( &result, &bits, sizeof( result ) );
+		result -= 6.103515625e-05f;
+		std::memcpy( &bits, &result, sizeof( bits ) );
+	} else {
+		bits += 0x38000000;
+	}
+	bits |= sign;
+	std::memcpy( &result, &bits, sizeof( result ) );
+	return result;
+}
+
+/*
+Prevod pole hodnot, 8 hodnot najednou s F16C (SIMD_F16C), 4 hodnoty najednou s SSE2.
+Pole nemusi byt zarovnana. Vystupni pole se jen zapisuje postupne (nikdy se z nej necte),
+lze tedy zapisovat primo do namapovaneho bufferu (write-combined pamet).
+Pole float lze prevadet po slozkach, napr. count = 4 * pocet pixelu pro R16G16B16A16_FLOAT.
+*/
+void FloatToHalf( const float* const in, uint16_t* const out, const std::size_t count );
+void HalfToFloat( const uint16_t* const in, float* const out, const std::size_t count );
\ No newline at end of file
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+
+// Handle: spodnich HANDLE_INDEX_BITS bitu je index slotu, horni bity generace slotu
+const uint32_t HANDLE_INDEX_BITS = 20;
+const uint32_t HANDLE_INDEX_MASK = ( 1u << HANDLE_INDEX_BITS ) - 1;
+const uint32_t HANDLE_GENERATION_MASK = ( 1u << ( 32 - HANDLE_INDEX_BITS ) ) - 1;
+
+// maximalni pocet objektu v jednom HandlePool
+const uint32_t MAX_HANDLE_POOL_SIZE = HANDLE_INDEX_MASK + 1;
+
+/*
+Handle: 32 bitovy identifikator objektu ulozeneho v HandlePool.
+Handle s hodnotou 0 je vzdy neplatny (generace slotu zacinaji od 1), vychozi konstruktor vytvori neplatny handle.
+Parametr T slouzi jen k typove kontrole, handle ruznych typu nelze zamenit.
+*/
+template <typename T>
+class Handle {
+public:
+	Handle();
+	Handle( const uint32_t index, const uint32_t generation );
+
+	uint32_t GetIndex() const;
+	uint32_t GetGeneration() const;
+	uint32_t GetValue() const;
+
+	// vraci true pro handle s hodnotou 0
+	bool IsNull() const;
+
+	bool operator==( const Handle& handle ) const;
+	bool operator!=( const Handle& handle ) const;
+
+private:
+	uint32_t value;
+};
+
+template <typename T>
+inline Handle< T >::Handle(): value( 0 ) {}
+
+template <typename T>
+inline Handle< T >::Handle( const uint32_t index, const uint32_t generation ):
+	value( ( ( generation & HANDLE_GENERATION_MASK ) << HANDLE_INDEX_BITS ) | ( index & HANDLE_INDEX_MASK ) )
+{}
+
+template <typename T>
+inline uint32_t Handle< T >::GetIndex() const {
+	return value & HANDLE_INDEX_MASK;
+}
+
+template <typename T>
+inline uint32_t Handle< T >::GetGeneration() const {
+	return value >> HANDLE_INDEX_BITS;
+}
+
+template <typename T>
+inline uint32_t Handle< T >::GetValue() const {
+	return value;
+}
+
+template <typename T>
+inline bool Handle< T >::IsNull() const {
+	return value == 0;
+}
+
+template <typename T>
+inline bool Handle< T >::operator==( const Handle& handle ) const {
+	return value == handle.value;
+}
+
+template <typename T>
+inline bool Handle< T >::operator!=( const Handle& handle ) const {
+	return value != handle.value;
+}
+
+/*
+HandlePool (slot map): objekty jsou ulozeny primo v souvislem poli slotu, handle obsahuje index slotu a jeho generaci.
+Odstraneni objektu zvysi generaci slotu, vsechny drive vydane handle na slot jsou tak neplatne.
+Uvolnene sloty jsou znovu pouzity (LIFO), pole tedy zustava huste a pristup k objektu je jeden indexovany load.
+Resolve() kontroluje platnost handle pouze v debug buildu, Get() kontroluje vzdy.
+Objekt musi mit vychozi konstruktor, odstraneny objekt je nahrazen hodnotou T() (napr. uvolni COM objekty).
+T muze pretezovat operator & (ComPtr), Get() pouziva std::addressof().
+Ukazatele vracene funkcemi Get() a Resolve() jsou platne jen do dalsiho volani Add().
+Trida neni thread safe.
+*/
+template <typename T, typename Tag = T>
+class HandlePool {
+public:
+	using HandleType = Handle< Tag >;
+
+	HandlePool();
+
+	// vlozi objekt do poolu, pokud je pool plny (MAX_HANDLE_POOL_SIZE), vraci neplatny handle
+	HandleType Add( const T& object );
+
+	// odstrani objekt, vraci false pro neplatny handle
+	bool Remove( const HandleType handle );
+
+	// vraci true, pokud handle odkazuje na existujici objekt
+	bool IsValid( const HandleType handle ) const;
+
+	// vrati ukazatel na objekt, pro neplatny handle vraci nullptr
+	T* Get( const HandleType handle );
+	const T* Get( const HandleType handle ) const;
+
+	// vrati objekt bez kontroly platnosti handle (kontroluje se pouze v debug buildu)
+	T& Resolve( const HandleType handle );
+	const T& Resolve( const HandleType handle ) const;
+
+	// pocet objektu v poolu
+	uint32_t GetCount() const;
+
+	// odstrani vsechny objekty, vsechny vydane handle jsou neplatne
+	void Clear();
+
+private:
+	static const uint32_t USED_SLOT = 0xffffffff;
+	static const uint32_t NO_FREE_SLOT = 0xfffffffe;
+
+	struct Slot {
+		T object;
+		uint32_t generation;
+		uint32_t nextFree;		// USED_SLOT pro obsazeny slot
+	};
+
+	// zvysi generaci slotu, generace 0 se nepouziva
+	static uint32_t NextGeneration( const uint32_t generation );
+
+private:
+	std::vector< Slot > slots;
+	uint32_t firstFree;
+	uint32_t count;
+};
+
+template <typename T, typename Tag>
+HandlePool< T, Tag >::HandlePool():
+	firstFree( NO_FREE_SLOT ),
+	count( 0 )
+{}
+
+template <typename T, typename Tag>
+inline uint32_t HandlePool< T, Tag >::NextGeneration( const uint32_t generation ) {
+	const uint32_t next = ( generation + 1 ) & HANDLE_GENERATION_MASK;
+	return next == 0 ? 1 : next;
+}
+
+template <typename T, typename Tag>
+typename HandlePool< T, Tag >::HandleType HandlePool< T, Tag >::Add( const T& object ) {
+	uint32_t index = firstFree;
+	if ( index != NO_FREE_SLOT ) {
+		firstFree = slots[ index ].nextFree;
+	} else {
+		if ( slots.size() >= MAX_HANDLE_POOL_SIZE ) {
+			return HandleType();
+		}
+		index = static_cast< uint32_t >( slots.size() );
+		Slot slot;
+		slot.generation = 1;
+		slots.push_back( slot );
+	}
+	Slot& slot = slots[ index ];
+	slot.object = object;
+	slot.nextFree = USED_SLOT;
+	count += 1;
+	return HandleType( index, slot.generation );
+}
+
+template <typename T, typename Tag>
+bool HandlePool< T, Tag >::Remove( const HandleType handle ) {
+	if ( !IsValid( handle ) ) {
+		return false;
+	}
+	Slot& slot = slots[ handle.GetIndex() ];
+	slot.object = T();
+	slot.generation = NextGeneration( slot.generation );
+	slot.nextFree = firstFree;
+	firstFree = handle.GetIndex();
+	count -= 1;
+	return true;
+}
+
+template <typename T, typename Tag>
+inline bool HandlePool< T, Tag >::IsValid( const HandleType handle ) const {
+	const uint32_t index = handle.GetIndex();
+	if ( index >= slots.size() ) {
+		return false;
+	}
+	const Slot& slot = slots[ index ];
+	return slot.nextFree == USED_SLOT && slot.generation == handle.GetGeneration();
+}
+
+template <typename T, typename Tag>
+inline T* HandlePool< T, Tag >::Get( const HandleType handle ) {
+	if ( !IsValid( handle ) ) {
+		return nullptr;
+	}
+	return std::addressof( slots[ handle.GetIndex() ].object );
+}
+
+template <typename T, typename Tag>
+inline const T* HandlePool< T, Tag >::Get( const HandleType handle ) const {
+	if ( !IsValid( handle ) ) {
+		return nullptr;
+	}
+	return std::addressof( slots[ handle.GetIndex() ].object );
+}
+
+template <typename T, typename Tag>
+inline T& HandlePool< T, Tag >::Resolve( const HandleType handle ) {
+#ifdef _DEBUG
+	assert( IsValid( handle ) );
+#endif
+	return slots[ handle.GetIndex() ].object;
+}
+
+template <typename T, typename Tag>
+inline const T& HandlePool< T, Tag >::Resolve( const HandleType handle ) const {
+#ifdef _DEBUG
+	assert( IsValid( handle ) );
+#endif
+	return slots[ handle.GetIndex() ].object;
+}
+
+template <typename T, typename Tag>
+inline uint32_t HandlePool< T, Tag >::GetCount() const {
+	return count;
+}
+
+template <typename T, typename Tag>
+void HandlePool< T, Tag >::Clear() {
+	firstFree = NO_FREE_SLOT;
+	for ( uint32_t i = 0; i < slots.size(); i++ ) {
+		Slot& slot = slots[ i ];
+		if ( slot.nextFree == USED_SLOT ) {
+			slot.object = T();
+			slot.generation = NextGeneration( slot.generation );
+		}
+		slot.nextFree = firstFree;
+		firstFree = i;
+	}
+	count = 0;
+}
\ No newline at end of file
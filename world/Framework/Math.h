@@ -1,51 +1,56 @@
 #pragma once
 
 #include <cmath>
-#include <DirectXMath.h>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace Math {
 	
 	// constants
-	const float PI = DirectX::XM_PI;
-	const float PI2 = DirectX::XM_PI * 2.0f;
-	const float PIDIV2 = DirectX::XM_PIDIV2;
+	constexpr float PI = 3.141592654f;
+	constexpr float PI2 = PI * 2.0f;
+	constexpr float PIDIV2 = 1.570796327f;
 
 	inline float Clamp( const float value, const float min, const float max ) {
 		return fminf( fmaxf( value, min ), max );
 	}
 	
-	//template< typename T>
-	inline int Abs( const int value ) {
-		return abs( value );
+	constexpr int Abs( const int value ) {
+		return value < 0 ? -value : value;
 	}
 
 	template< typename T>
-	inline T Max( const T& a, const T& b ) {
+	constexpr T Max( const T& a, const T& b ) {
 		return a > b ? a : b;
 	}
 
 	template< typename T>
-	inline T Max( const T& a, const T& b, const T& c ) {
+	constexpr T Max( const T& a, const T& b, const T& c ) {
 		return std::max( std::max( a, b ), c );
 	}
 
 	template< typename T>
-	inline T Max( const T& a, const T& b, const T& c, const T& d ) {
+	constexpr T Max( const T& a, const T& b, const T& c, const T& d ) {
 		return std::max( std::max( a, b ), std::max( c, d ) );
 	}
 
 	template< typename T>
-	inline T Min( const T& a, const T& b ) {
+	constexpr T Min( const T& a, const T& b ) {
 		return a < b ? a : b;
 	}
 
 	template< typename T>
-	inline T Min( const T& a, const T& b, const T& c ) {
+	constexpr T Min( const T& a, const T& b, const T& c ) {
 		return std::min( std::min( a, b ), c );
 	}
 
 	template< typename T>
-	inline T Min( const T& a, const T& b, const T& c, const T& d ) {
+	constexpr T Min( const T& a, const T& b, const T& c, const T& d ) {
 		return std::min( std::min( a, b ), std::min( c, d ) );
 	}
 
@@ -76,19 +81,19 @@ namespace Math {
 	// goniometric functions
 
 	inline float Sin( const float rad ) {
-		return DirectX::XMScalarSin( rad );
+		return std::sin( rad );
 	}
 
 	inline float Cos( const float rad ) {
-		return DirectX::XMScalarCos( rad );
+		return std::cos( rad );
 	}
 
 	inline float ASin( const float value ) {
-		return DirectX::XMScalarASin( value );
+		return std::asin( value );
 	}
 
 	inline float ACos( const float value ) {
-		return DirectX::XMScalarACos( value );
+		return std::acos( value );
 	}
 
 	inline float Atan2( const float y, const float x ) {
@@ -105,19 +110,73 @@ namespace Math {
 		return pow( base, exponent );
 	}
 	
-	inline int Pow2( const int exponent ) {
+	constexpr int Pow2( const int exponent ) {
 		return 0x01 << static_cast< unsigned int >( exponent );
 	}
 
 	// help functions
 
-	inline bool IsPow2( const int value ) {
+	/*
+	Index nejvyssiho nastaveneho bitu (bit scan reverse), value nesmi byt 0.
+	GCC a Clang maji __builtin_clz pouzitelny i pri prekladu, MSVC pouzije _BitScanReverse jen s C++20
+	(std::is_constant_evaluated), jinak binarni vyhledavani bez cyklu.
+	*/
+	constexpr int GetHighestBit( const uint32_t value ) {
+	#if defined( __GNUC__ ) || defined( __clang__ )
+		return 31 - __builtin_clz( value );
+	#else
+		#if defined( _MSC_VER ) && defined( __cpp_lib_is_constant_evaluated )
+		if ( !std::is_constant_evaluated() ) {
+			unsigned long index = 0;
+			_BitScanReverse( &index, value );
+			return static_cast< int >( index );
+		}
+		#endif
+		uint32_t v = value;
+		int bit = 0;
+		if ( v >= 0x00010000 ) {
+			v >>= 16;
+			bit += 16;
+		}
+		if ( v >= 0x00000100 ) {
+			v >>= 8;
+			bit += 8;
+		}
+		if ( v >= 0x00000010 ) {
+			v >>= 4;
+			bit += 4;
+		}
+		if ( v >= 0x00000004 ) {
+			v >>= 2;
+			bit += 2;
+		}
+		if ( v >= 0x00000002 ) {
+			bit += 1;
+		}
+		return bit;
+	#endif
+	}
+
+	constexpr bool IsPow2( const int value ) {
 		if ( value <= 0 ) {
 			return false;
 		}
 		return ( value & ( value - 1 ) ) == 0;
 	}
 
-	int NearestUpperPow2( const int value );
-	int NearestLowerPow2( const int value );
+	// nejmensi mocnina 2 >= value (value <= 2^30), pro value <= 0 vraci 1
+	constexpr int NearestUpperPow2( const int value ) {
+		if ( value <= 1 ) {
+			return 1;
+		}
+		return 1 << ( GetHighestBit( static_cast< uint32_t >( value - 1 ) ) + 1 );
+	}
+
+	// nejvetsi mocnina 2 <= value, pro value <= 0 vraci 1
+	constexpr int NearestLowerPow2( const int value ) {
+		if ( value <= 0 ) {
+			return 1;
+		}
+		return 1 << GetHighestBit( static_cast< uint32_t >( value ) );
+	}
 }
\ No newline at end of file
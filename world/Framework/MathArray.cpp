@@ -0,0 +1,1078 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "MathArray.h"
+#include "Simd.h"
+
+/*
+Operace nad registrem LANES hodnot (8 pro AVX2, 4 pro SSE, 1 pro skalarni implementaci):
+Float (float), Int (int32) a Double (polovina hodnot registru Float prevedena na double).
+Masky porovnani maji vsechny bity 1 (true) nebo 0 (false).
+Round() a ToInt() zaokrouhluji k nejblizsimu celemu cislu (pri shode k sudemu),
+ToInt() vraci 0x80000000 pro hodnoty mimo rozsah int32 a NaN (shodne s instrukci cvtps2dq).
+*/
+namespace {
+
+#if defined( SIMD_AVX2 )
+
+	using Float = __m256;
+	using Int = __m256i;
+	using Double = __m256d;
+	const std::size_t LANES = 8;
+
+	inline Float Splat( const float value ) {
+		return _mm256_set1_ps( value );
+	}
+
+	inline Float Load( const float* const src ) {
+		return _mm256_loadu_ps( src );
+	}
+
+	inline void Store( float* const dest, const Float v ) {
+		_mm256_storeu_ps( dest, v );
+	}
+
+	inline Float Add( const Float a, const Float b ) {
+		return _mm256_add_ps( a, b );
+	}
+
+	inline Float Sub( const Float a, const Float b ) {
+		return _mm256_sub_ps( a, b );
+	}
+
+	inline Float Mul( const Float a, const Float b ) {
+		return _mm256_mul_ps( a, b );
+	}
+
+	inline Float Div( const Float a, const Float b ) {
+		return _mm256_div_ps( a, b );
+	}
+
+	// a * b + c
+	inline Float MulAdd( const Float a, const Float b, const Float c ) {
+	#ifdef SIMD_FMA
+		return _mm256_fmadd_ps( a, b, c );
+	#else
+		return _mm256_add_ps( _mm256_mul_ps( a, b ), c );
+	#endif
+	}
+
+	// c - a * b
+	inline Float NegMulAdd( const Float a, const Float b, const Float c ) {
+	#ifdef SIMD_FMA
+		return _mm256_fnmadd_ps( a, b, c );
+	#else
+		return _mm256_sub_ps( c, _mm256_mul_ps( a, b ) );
+	#endif
+	}
+
+	// pri NaN vraci b
+	inline Float Min( const Float a, const Float b ) {
+		return _mm256_min_ps( a, b );
+	}
+
+	inline Float Max( const Float a, const Float b ) {
+		return _mm256_max_ps( a, b );
+	}
+
+	inline Float Sqrt( const Float v ) {
+		return _mm256_sqrt_ps( v );
+	}
+
+	// relativni chyba < 1.5 * 2^-12
+	inline Float RSqrtEstimate( const Float v ) {
+		return _mm256_rsqrt_ps( v );
+	}
+
+	inline Float And( const Float a, const Float b ) {
+		return _mm256_and_ps( a, b );
+	}
+
+	inline Float Or( const Float a, const Float b ) {
+		return _mm256_or_ps( a, b );
+	}
+
+	inline Float Xor( const Float a, const Float b ) {
+		return _mm256_xor_ps( a, b );
+	}
+
+	// ~a & b
+	inline Float AndNot( const Float a, const Float b ) {
+		return _mm256_andnot_ps( a, b );
+	}
+
+	// mask ? a : b
+	inline Float Select( const Float mask, const Float a, const Float b ) {
+		return _mm256_blendv_ps( b, a, mask );
+	}
+
+	inline Float Less( const Float a, const Float b ) {
+		return _mm256_cmp_ps( a, b, _CMP_LT_OQ );
+	}
+
+	inline Float LessEqual( const Float a, const Float b ) {
+		return _mm256_cmp_ps( a, b, _CMP_LE_OQ );
+	}
+
+	inline Float Equal( const Float a, const Float b ) {
+		return _mm256_cmp_ps( a, b, _CMP_EQ_OQ );
+	}
+
+	inline Float IsNan( const Float v ) {
+		return _mm256_cmp_ps( v, v, _CMP_UNORD_Q );
+	}
+
+	inline Float Round( const Float v ) {
+		return _mm256_round_ps( v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+	}
+
+	inline Int ToInt( const Float v ) {
+		return _mm256_cvtps_epi32( v );
+	}
+
+	inline Float ToFloat( const Int v ) {
+		return _mm256_cvtepi32_ps( v );
+	}
+
+	inline Int AsInt( const Float v ) {
+		return _mm256_castps_si256( v );
+	}
+
+	inline Float AsFloat( const Int v ) {
+		return _mm256_castsi256_ps( v );
+	}
+
+	inline Int SplatInt( const int32_t value ) {
+		return _mm256_set1_epi32( value );
+	}
+
+	inline Int Add( const Int a, const Int b ) {
+		return _mm256_add_epi32( a, b );
+	}
+
+	inline Int Sub( const Int a, const Int b ) {
+		return _mm256_sub_epi32( a, b );
+	}
+
+	inline Int And( const Int a, const Int b ) {
+		return _mm256_and_si256( a, b );
+	}
+
+	template < int N >
+	inline Int ShiftLeft( const Int v ) {
+		return _mm256_slli_epi32( v, N );
+	}
+
+	// aritmeticky posun (zachovava znamenko)
+	template < int N >
+	inline Int ShiftRight( const Int v ) {
+		return _mm256_srai_epi32( v, N );
+	}
+
+	inline Double SplatDouble( const double value ) {
+		return _mm256_set1_pd( value );
+	}
+
+	inline Double ToDoubleLow( const Float v ) {
+		return _mm256_cvtps_pd( _mm256_castps256_ps128( v ) );
+	}
+
+	inline Double ToDoubleHigh( const Float v ) {
+		return _mm256_cvtps_pd( _mm256_extractf128_ps( v, 1 ) );
+	}
+
+	inline Float ToFloat( const Double low, const Double high ) {
+		return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm256_cvtpd_ps( low ) ), _mm256_cvtpd_ps( high ), 1 );
+	}
+
+	inline Double Add( const Double a, const Double b ) {
+		return _mm256_add_pd( a, b );
+	}
+
+	inline Double Sub( const Double a, const Double b ) {
+		return _mm256_sub_pd( a, b );
+	}
+
+	inline Double Mul( const Double a, const Double b ) {
+		return _mm256_mul_pd( a, b );
+	}
+
+	inline Double Div( const Double a, const Double b ) {
+		return _mm256_div_pd( a, b );
+	}
+
+	inline Double MulAdd( const Double a, const Double b, const Double c ) {
+	#ifdef SIMD_FMA
+		return _mm256_fmadd_pd( a, b, c );
+	#else
+		return _mm256_add_pd( _mm256_mul_pd( a, b ), c );
+	#endif
+	}
+
+	inline Double Min( const Double a, const Double b ) {
+		return _mm256_min_pd( a, b );
+	}
+
+	inline Double Max( const Double a, const Double b ) {
+		return _mm256_max_pd( a, b );
+	}
+
+	// 2^n z hodnoty n + DOUBLE_ROUND (n je cele cislo, -1023 < n < 1024)
+	inline Double Exp2Rounded( const Double rounded ) {
+		return _mm256_castsi256_pd( _mm256_slli_epi64( _mm256_add_epi64( _mm256_castpd_si256( rounded ), _mm256_set1_epi64x( 1023 ) ), 52 ) );
+	}
+
+#elif defined( SIMD_SSE2 )
+
+	using Float = __m128;
+	using Int = __m128i;
+	using Double = __m128d;
+	const std::size_t LANES = 4;
+
+	inline Float Splat( const float value ) {
+		return _mm_set1_ps( value );
+	}
+
+	inline Float Load( const float* const src ) {
+		return _mm_loadu_ps( src );
+	}
+
+	inline void Store( float* const dest, const Float v ) {
+		_mm_storeu_ps( dest, v );
+	}
+
+	inline Float Add( const Float a, const Float b ) {
+		return _mm_add_ps( a, b );
+	}
+
+	inline Float Sub( const Float a, const Float b ) {
+		return _mm_sub_ps( a, b );
+	}
+
+	inline Float Mul( const Float a, const Float b ) {
+		return _mm_mul_ps( a, b );
+	}
+
+	inline Float Div( const Float a, const Float b ) {
+		return _mm_div_ps( a, b );
+	}
+
+	inline Float MulAdd( const Float a, const Float b, const Float c ) {
+		return _mm_add_ps( _mm_mul_ps( a, b ), c );
+	}
+
+	inline Float NegMulAdd( const Float a, const Float b, const Float c ) {
+		return _mm_sub_ps( c, _mm_mul_ps( a, b ) );
+	}
+
+	inline Float Min( const Float a, const Float b ) {
+		return _mm_min_ps( a, b );
+	}
+
+	inline Float Max( const Float a, const Float b ) {
+		return _mm_max_ps( a, b );
+	}
+
+	inline Float Sqrt( const Float v ) {
+		return _mm_sqrt_ps( v );
+	}
+
+	inline Float RSqrtEstimate( const Float v ) {
+		return _mm_rsqrt_ps( v );
+	}
+
+	inline Float And( const Float a, const Float b ) {
+		return _mm_and_ps( a, b );
+	}
+
+	inline Float Or( const Float a, const Float b ) {
+		return _mm_or_ps( a, b );
+	}
+
+	inline Float Xor( const Float a, const Float b ) {
+		return _mm_xor_ps( a, b );
+	}
+
+	inline Float AndNot( const Float a, const Float b ) {
+		return _mm_andnot_ps( a, b );
+	}
+
+	inline Float Select( const Float mask, const Float a, const Float b ) {
+	#ifdef SIMD_SSE4
+		return _mm_blendv_ps( b, a, mask );
+	#else
+		return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+	#endif
+	}
+
+	inline Float Less( const Float a, const Float b ) {
+		return _mm_cmplt_ps( a, b );
+	}
+
+	inline Float LessEqual( const Float a, const Float b ) {
+		return _mm_cmple_ps( a, b );
+	}
+
+	inline Float Equal( const Float a, const Float b ) {
+		return _mm_cmpeq_ps( a, b );
+	}
+
+	inline Float IsNan( const Float v ) {
+		return _mm_cmpunord_ps( v, v );
+	}
+
+	inline Float Round( const Float v ) {
+	#ifdef SIMD_SSE4
+		return _mm_round_ps( v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+	#else
+		// hodnoty |v| >= 2^23 jsou cela cisla, prevod na int32 by u nich pretekl
+		const Float rounded = _mm_cvtepi32_ps( _mm_cvtps_epi32( v ) );
+		const Float small = _mm_cmplt_ps( _mm_andnot_ps( _mm_set1_ps( -0.0f ), v ), _mm_set1_ps( 8388608.0f ) );
+		return _mm_or_ps( _mm_and_ps( small, rounded ), _mm_andnot_ps( small, v ) );
+	#endif
+	}
+
+	inline Int ToInt( const Float v ) {
+		return _mm_cvtps_epi32( v );
+	}
+
+	inline Float ToFloat( const Int v ) {
+		return _mm_cvtepi32_ps( v );
+	}
+
+	inline Int AsInt( const Float v ) {
+		return _mm_castps_si128( v );
+	}
+
+	inline Float AsFloat( const Int v ) {
+		return _mm_castsi128_ps( v );
+	}
+
+	inline Int SplatInt( const int32_t value ) {
+		return _mm_set1_epi32( value );
+	}
+
+	inline Int Add( const Int a, const Int b ) {
+		return _mm_add_epi32( a, b );
+	}
+
+	inline Int Sub( const Int a, const Int b ) {
+		return _mm_sub_epi32( a, b );
+	}
+
+	inline Int And( const Int a, const Int b ) {
+		return _mm_and_si128( a, b );
+	}
+
+	template < int N >
+	inline Int ShiftLeft( const Int v ) {
+		return _mm_slli_epi32( v, N );
+	}
+
+	template < int N >
+	inline Int ShiftRight( const Int v ) {
+		return _mm_srai_epi32( v, N );
+	}
+
+	inline Double SplatDouble( const double value ) {
+		return _mm_set1_pd( value );
+	}
+
+	inline Double ToDoubleLow( const Float v ) {
+		return _mm_cvtps_pd( v );
+	}
+
+	inline Double ToDoubleHigh( const Float v ) {
+		return _mm_cvtps_pd( _mm_movehl_ps( v, v ) );
+	}
+
+	inline Float ToFloat( const Double low, const Double high ) {
+		return _mm_movelh_ps( _mm_cvtpd_ps( low ), _mm_cvtpd_ps( high ) );
+	}
+
+	inline Double Add( const Double a, const Double b ) {
+		return _mm_add_pd( a, b );
+	}
+
+	inline Double Sub( const Double a, const Double b ) {
+		return _mm_sub_pd( a, b );
+	}
+
+	inline Double Mul( const Double a, const Double b ) {
+		return _mm_mul_pd( a, b );
+	}
+
+	inline Double Div( const Double a, const Double b ) {
+		return _mm_div_pd( a, b );
+	}
+
+	inline Double MulAdd( const Double a, const Double b, const Double c ) {
+		return _mm_add_pd( _mm_mul_pd( a, b ), c );
+	}
+
+	inline Double Min( const Double a, const Double b ) {
+		return _mm_min_pd( a, b );
+	}
+
+	inline Double Max( const Double a, const Double b ) {
+		return _mm_max_pd( a, b );
+	}
+
+	inline Double Exp2Rounded( const Double rounded ) {
+		return _mm_castsi128_pd( _mm_slli_epi64( _mm_add_epi64( _mm_castpd_si128( rounded ), _mm_set_epi32( 0, 1023, 0, 1023 ) ), 52 ) );
+	}
+
+#else // SIMD_SCALAR
+
+	using Float = float;
+	using Int = int32_t;
+	using Double = double;
+	const std::size_t LANES = 1;
+
+	inline uint32_t GetBits( const float v ) {
+		uint32_t bits;
+		std::memcpy( &bits, &v, sizeof( bits ) );
+		return bits;
+	}
+
+	inline float FromBits( const uint32_t bits ) {
+		float v;
+		std::memcpy( &v, &bits, sizeof( v ) );
+		return v;
+	}
+
+	inline Float Mask( const bool value ) {
+		return FromBits( value ? 0xffffffff : 0 );
+	}
+
+	inline Float Splat( const float value ) {
+		return value;
+	}
+
+	inline Float Load( const float* const src ) {
+		return *src;
+	}
+
+	inline void Store( float* const dest, const Float v ) {
+		*dest = v;
+	}
+
+	inline Float Add( const Float a, const Float b ) {
+		return a + b;
+	}
+
+	inline Float Sub( const Float a, const Float b ) {
+		return a - b;
+	}
+
+	inline Float Mul( const Float a, const Float b ) {
+		return a * b;
+	}
+
+	inline Float Div( const Float a, const Float b ) {
+		return a / b;
+	}
+
+	inline Float MulAdd( const Float a, const Float b, const Float c ) {
+		return a * b + c;
+	}
+
+	inline Float NegMulAdd( const Float a, const Float b, const Float c ) {
+		return c - a * b;
+	}
+
+	inline Float Min( const Float a, const Float b ) {
+		return a < b ? a : b;
+	}
+
+	inline Float Max( const Float a, const Float b ) {
+		return a > b ? a : b;
+	}
+
+	inline Float Sqrt( const Float v ) {
+		return std::sqrt( v );
+	}
+
+	inline Float RSqrtEstimate( const Float v ) {
+		return 1.0f / std::sqrt( v );
+	}
+
+	inline Float And( const Float a, const Float b ) {
+		return FromBits( GetBits( a ) & GetBits( b ) );
+	}
+
+	inline Float Or( const Float a, const Float b ) {
+		return FromBits( GetBits( a ) | GetBits( b ) );
+	}
+
+	inline Float Xor( const Float a, const Float b ) {
+		return FromBits( GetBits( a ) ^ GetBits( b ) );
+	}
+
+	inline Float AndNot( const Float a, const Float b ) {
+		return FromBits( ~GetBits( a ) & GetBits( b ) );
+	}
+
+	inline Float Select( const Float mask, const Float a, const Float b ) {
+		return GetBits( mask ) != 0 ? a : b;
+	}
+
+	inline Float Less( const Float a, const Float b ) {
+		return Mask( a < b );
+	}
+
+	inline Float LessEqual( const Float a, const Float b ) {
+		return Mask( a <= b );
+	}
+
+	inline Float Equal( const Float a, const Float b ) {
+		return Mask( a == b );
+	}
+
+	inline Float IsNan( const Float v ) {
+		return Mask( v != v );
+	}
+
+	inline Float Round( const Float v ) {
+		return std::nearbyint( v );
+	}
+
+	inline Int ToInt( const Float v ) {
+		return std::fabs( v ) < 2147483648.0f ? static_cast< Int >( std::nearbyint( v ) ) : INT32_MIN;
+	}
+
+	inline Float ToFloat( const Int v ) {
+		return static_cast< float >( v );
+	}
+
+	inline Int AsInt( const Float v ) {
+		return static_cast< Int >( GetBits( v ) );
+	}
+
+	inline Float AsFloat( const Int v ) {
+		return FromBits( static_cast< uint32_t >( v ) );
+	}
+
+	inline Int SplatInt( const int32_t value ) {
+		return value;
+	}
+
+	inline Int Add( const Int a, const Int b ) {
+		return static_cast< Int >( static_cast< uint32_t >( a ) + static_cast< uint32_t >( b ) );
+	}
+
+	inline Int Sub( const Int a, const Int b ) {
+		return static_cast< Int >( static_cast< uint32_t >( a ) - static_cast< uint32_t >( b ) );
+	}
+
+	inline Int And( const Int a, const Int b ) {
+		return a & b;
+	}
+
+	template < int N >
+	inline Int ShiftLeft( const Int v ) {
+		return static_cast< Int >( static_cast< uint32_t >( v ) << N );
+	}
+
+	template < int N >
+	inline Int ShiftRight( const Int v ) {
+		return v >> N;
+	}
+
+	inline Double SplatDouble( const double value ) {
+		return value;
+	}
+
+	// skalarni implementace ma jedinou hodnotu, horni polovina je ignorovana
+	inline Double ToDoubleLow( const Float v ) {
+		return v;
+	}
+
+	inline Double ToDoubleHigh( const Float v ) {
+		return v;
+	}
+
+	inline Float ToFloat( const Double low, const Double ) {
+		return static_cast< float >( low );
+	}
+
+	inline Double Add( const Double a, const Double b ) {
+		return a + b;
+	}
+
+	inline Double Sub( const Double a, const Double b ) {
+		return a - b;
+	}
+
+	inline Double Mul( const Double a, const Double b ) {
+		return a * b;
+	}
+
+	inline Double Div( const Double a, const Double b ) {
+		return a / b;
+	}
+
+	inline Double MulAdd( const Double a, const Double b, const Double c ) {
+		return a * b + c;
+	}
+
+	inline Double Min( const Double a, const Double b ) {
+		return a < b ? a : b;
+	}
+
+	inline Double Max( const Double a, const Double b ) {
+		return a > b ? a : b;
+	}
+
+	inline Double Exp2Rounded( const Double rounded ) {
+		uint64_t bits;
+		std::memcpy( &bits, &rounded, sizeof( bits ) );
+		bits = ( bits + 1023 ) << 52;
+		double result;
+		std::memcpy( &result, &bits, sizeof( result ) );
+		return result;
+	}
+
+#endif
+
+	// konstanty
+
+	const float INFINITY_FLOAT = std::numeric_limits< float >::infinity();
+	const float NAN_FLOAT = std::numeric_limits< float >::quiet_NaN();
+	const float SIGN_MASK = -0.0f;
+	const float LOG2E = 1.44269504089f;
+	const float TWO_DIV_PI = 0.636619772368f;
+
+	// pi / 2 rozdelene na casti s nejvyse 11 bity mantisy (Cody-Waite), soucin s kvadrantem < 2^13 je presny
+	const float PIDIV2_1 = 1.5703125f;
+	const float PIDIV2_2 = 4.83751296997070312e-4f;
+	const float PIDIV2_3 = 7.54953362047672272e-8f;
+	const float PIDIV2_4 = 2.56334406825708960e-12f;
+
+	// ln( 2 ) rozdeleny na presnou a opravnou cast
+	const float LN2_1 = 0.693359375f;
+	const float LN2_2 = -2.12194440e-4f;
+
+	// konstanty zaokrouhlene na float a jejich zbytky
+	const float PI_HIGH = 3.14159274f;
+	const float PI_LOW = -8.74227766e-8f;
+	const float PIDIV2_HIGH = 1.57079637f;
+	const float PIDIV2_LOW = -4.37113883e-8f;
+	const float PIDIV4_HIGH = 0.785398185f;
+	const float PIDIV4_LOW = -2.18556941e-8f;
+
+	// n + DOUBLE_ROUND zaokrouhli n na cele cislo ulozene v nejnizsich bitech mantisy (1.5 * 2^52)
+	const double DOUBLE_ROUND = 6755399441055744.0;
+	const double LN2_DOUBLE = 0.6931471805599453;
+	const double LOG2E_DOUBLE = 1.4426950408889634;
+
+	inline Float Abs( const Float v ) {
+		return AndNot( Splat( SIGN_MASK ), v );
+	}
+
+	// maska zapornych hodnot vcetne -0
+	inline Float SignMask( const Float v ) {
+		return AsFloat( ShiftRight< 31 >( AsInt( v ) ) );
+	}
+
+	template < bool PRECISE >
+	inline Float SinPolynomial( const Float r, const Float z ) {
+		Float p;
+		if ( PRECISE ) {
+			p = MulAdd( z, Splat( -1.9515295891e-4f ), Splat( 8.3321608736e-3f ) );
+			p = MulAdd( z, p, Splat( -1.6666654611e-1f ) );
+		} else {
+			p = MulAdd( z, Splat( 8.163281716e-3f ), Splat( -1.666339040e-1f ) );
+		}
+		return MulAdd( Mul( r, z ), p, r );
+	}
+
+	template < bool PRECISE >
+	inline Float CosPolynomial( const Float z ) {
+		if ( PRECISE ) {
+			Float p = MulAdd( z, Splat( 2.443315711809948e-5f ), Splat( -1.388731625493765e-3f ) );
+			p = MulAdd( z, p, Splat( 4.166664568298827e-2f ) );
+			return MulAdd( Mul( z, z ), p, NegMulAdd( z, Splat( 0.5f ), Splat( 1.0f ) ) );
+		}
+		const Float p = MulAdd( z, Splat( 4.045845196e-2f ), Splat( -4.997605681e-1f ) );
+		return MulAdd( z, p, Splat( 1.0f ) );
+	}
+
+	/*
+	Redukce argumentu na r v < -pi / 4; pi / 4 > a kvadrant q, x = r + q * pi / 2.
+	sin( x ) je podle kvadrantu sin( r ), cos( r ), -sin( r ), -cos( r ).
+	*/
+	inline Float ReduceQuadrant( const Float x, Int& quadrant ) {
+		const Float q = Round( Mul( x, Splat( TWO_DIV_PI ) ) );
+		quadrant = ToInt( q );
+		Float r = NegMulAdd( q, Splat( PIDIV2_1 ), x );
+		r = NegMulAdd( q, Splat( PIDIV2_2 ), r );
+		r = NegMulAdd( q, Splat( PIDIV2_3 ), r );
+		return NegMulAdd( q, Splat( PIDIV2_4 ), r );
+	}
+
+	// sin( r ) pro sudy kvadrant, cos( r ) pro lichy, znamenko podle druheho bitu kvadrantu
+	inline Float SelectQuadrant( const Int quadrant, const Float sin, const Float cos ) {
+		const Float odd = AsFloat( ShiftRight< 31 >( ShiftLeft< 31 >( quadrant ) ) );
+		const Float sign = AsFloat( ShiftLeft< 30 >( quadrant ) );
+		return Xor( Select( odd, cos, sin ), And( sign, Splat( SIGN_MASK ) ) );
+	}
+
+	template < bool PRECISE >
+	inline Float SinKernel( const Float x ) {
+		Int quadrant;
+		const Float r = ReduceQuadrant( x, quadrant );
+		const Float z = Mul( r, r );
+		return SelectQuadrant( quadrant, SinPolynomial< PRECISE >( r, z ), CosPolynomial< PRECISE >( z ) );
+	}
+
+	// cos( x ) = sin( x + pi / 2 )
+	template < bool PRECISE >
+	inline Float CosKernel( const Float x ) {
+		Int quadrant;
+		const Float r = ReduceQuadrant( x, quadrant );
+		const Float z = Mul( r, r );
+		return SelectQuadrant( Add( quadrant, SplatInt( 1 ) ), SinPolynomial< PRECISE >( r, z ), CosPolynomial< PRECISE >( z ) );
+	}
+
+	template < bool PRECISE >
+	inline void SinCosKernel( const Float x, Float& sin, Float& cos ) {
+		Int quadrant;
+		const Float r = ReduceQuadrant( x, quadrant );
+		const Float z = Mul( r, r );
+		const Float s = SinPolynomial< PRECISE >( r, z );
+		const Float c = CosPolynomial< PRECISE >( z );
+		sin = SelectQuadrant( quadrant, s, c );
+		cos = SelectQuadrant( Add( quadrant, SplatInt( 1 ) ), s, c );
+	}
+
+	/*
+	exp( x ) = 2^n * exp( r ), n = round( x / ln( 2 ) ), |r| <= ln( 2 ) / 2.
+	Nasobeni 2^n je rozdeleno na dva kroky, aby bylo mozne vyjadrit n = 128 (vysledek blizko FLT_MAX)
+	i n < -126 (denormalni vysledky).
+	*/
+	template < bool PRECISE >
+	inline Float ExpKernel( const Float x ) {
+		const Float clamped = Min( Max( x, Splat( -104.0f ) ), Splat( 89.0f ) );
+		const Float n = Round( Mul( clamped, Splat( LOG2E ) ) );
+		Float r = NegMulAdd( n, Splat( LN2_1 ), clamped );
+		r = NegMulAdd( n, Splat( LN2_2 ), r );
+
+		Float p;
+		if ( PRECISE ) {
+			p = MulAdd( r, Splat( 1.9875691500e-4f ), Splat( 1.3981999507e-3f ) );
+			p = MulAdd( r, p, Splat( 8.3334519073e-3f ) );
+			p = MulAdd( r, p, Splat( 4.1665795894e-2f ) );
+			p = MulAdd( r, p, Splat( 1.6666665459e-1f ) );
+			p = MulAdd( r, p, Splat( 5.0000001201e-1f ) );
+		} else {
+			p = MulAdd( r, Splat( 4.127774760e-2f ), Splat( 1.675351411e-1f ) );
+			p = MulAdd( r, p, Splat( 5.000511408e-1f ) );
+		}
+		p = MulAdd( Mul( r, r ), p, Add( r, Splat( 1.0f ) ) );
+
+		const Int n1 = ShiftRight< 1 >( ToInt( n ) );
+		const Int n2 = Sub( ToInt( n ), n1 );
+		p = Mul( p, AsFloat( ShiftLeft< 23 >( Add( n1, SplatInt( 127 ) ) ) ) );
+		p = Mul( p, AsFloat( ShiftLeft< 23 >( Add( n2, SplatInt( 127 ) ) ) ) );
+		return Select( IsNan( x ), x, p );
+	}
+
+	/*
+	Rozklad kladneho x na x = 2^e * ( 1 + m ), 1 + m v < sqrt( 0.5 ); sqrt( 2 ) ).
+	Denormalni hodnoty jsou pred rozkladem vynasobeny 2^25. Vysledek pro nulu, zaporna cisla, nekonecno a NaN neni urcen.
+	*/
+	inline Float Decompose( const Float x, Float& exponent ) {
+		const Float denormal = Less( x, Splat( 1.17549435e-38f ) );
+		const Int bits = AsInt( Select( denormal, Mul( x, Splat( 33554432.0f ) ), x ) );
+		Int e = Sub( ShiftRight< 23 >( bits ), SplatInt( 126 ) );
+		e = Sub( e, And( AsInt( denormal ), SplatInt( 25 ) ) );
+
+		// mantisa v < 0.5; 1 ), pod sqrt( 0.5 ) je zdvojnasobena
+		const Float m = AsFloat( Add( And( bits, SplatInt( 0x007fffff ) ), SplatInt( 0x3f000000 ) ) );
+		const Float small = Less( m, Splat( 0.707106781186547524f ) );
+		e = Add( e, AsInt( small ) );
+		exponent = ToFloat( e );
+		return Sub( Add( m, And( small, m ) ), Splat( 1.0f ) );
+	}
+
+	template < bool PRECISE >
+	inline Float LogKernel( const Float x ) {
+		Float e;
+		const Float m = Decompose( x, e );
+		const Float z = Mul( m, m );
+
+		// ln( 1 + m ) = m - m^2 / 2 + m^3 * p( m )
+		Float p;
+		if ( PRECISE ) {
+			p = MulAdd( m, Splat( 7.0376836292e-2f ), Splat( -1.1514610310e-1f ) );
+			p = MulAdd( m, p, Splat( 1.1676998740e-1f ) );
+			p = MulAdd( m, p, Splat( -1.2420140846e-1f ) );
+			p = MulAdd( m, p, Splat( 1.4249322787e-1f ) );
+			p = MulAdd( m, p, Splat( -1.6668057665e-1f ) );
+			p = MulAdd( m, p, Splat( 2.0000714765e-1f ) );
+			p = MulAdd( m, p, Splat( -2.4999993993e-1f ) );
+			p = MulAdd( m, p, Splat( 3.3333331174e-1f ) );
+		} else {
+			p = MulAdd( m, Splat( -1.459251493e-1f ), Splat( 2.177650928e-1f ) );
+			p = MulAdd( m, p, Splat( -2.524499893e-1f ) );
+			p = MulAdd( m, p, Splat( 3.328547180e-1f ) );
+		}
+		Float y = Mul( Mul( m, z ), p );
+		y = MulAdd( e, Splat( LN2_2 ), y );
+		y = NegMulAdd( z, Splat( 0.5f ), y );
+		Float result = MulAdd( e, Splat( LN2_1 ), Add( m, y ) );
+
+		// log( 0 ) = -inf, log( inf ) = inf, zaporna cisla a NaN vraci NaN
+		result = Select( Equal( x, Splat( INFINITY_FLOAT ) ), x, result );
+		result = Select( Equal( x, Splat( 0 ) ), Splat( -INFINITY_FLOAT ), result );
+		return Select( Or( Less( x, Splat( 0 ) ), IsNan( x ) ), Splat( NAN_FLOAT ), result );
+	}
+
+	/*
+	Presna mocnina je pocitana v double: exponent * ln( base ) je treba znat s presnosti radove 2^-30,
+	chyba logaritmu je vynasobena exponentem.
+	ln( 1 + m ) = 2 * atanh( s ), s = m / ( 2 + m ), |s| < 0.172 (rada do s^15 ma chybu < 2^-44).
+	*/
+	inline Double PowDouble( const Double exponent, const Double e, const Double m ) {
+		const Double s = Div( m, Add( m, SplatDouble( 2.0 ) ) );
+		const Double s2 = Mul( s, s );
+		Double p = MulAdd( s2, SplatDouble( 1.0 / 15.0 ), SplatDouble( 1.0 / 13.0 ) );
+		p = MulAdd( s2, p, SplatDouble( 1.0 / 11.0 ) );
+		p = MulAdd( s2, p, SplatDouble( 1.0 / 9.0 ) );
+		p = MulAdd( s2, p, SplatDouble( 1.0 / 7.0 ) );
+		p = MulAdd( s2, p, SplatDouble( 1.0 / 5.0 ) );
+		p = MulAdd( s2, p, SplatDouble( 1.0 / 3.0 ) );
+		p = MulAdd( s2, p, SplatDouble( 1.0 ) );
+		const Double logarithm = MulAdd( e, SplatDouble( LN2_DOUBLE ), Mul( Add( s, s ), p ) );
+
+		// exp( t ) = 2^n * exp( r ), vysledky mimo rozsah float jsou omezeny na nekonecno a nulu
+		const Double t = Min( Max( Mul( exponent, logarithm ), SplatDouble( -110.0 ) ), SplatDouble( 90.0 ) );
+		const Double rounded = MulAdd( t, SplatDouble( LOG2E_DOUBLE ), SplatDouble( DOUBLE_ROUND ) );
+		const Double n = Sub( rounded, SplatDouble( DOUBLE_ROUND ) );
+		const Double r = Sub( t, Mul( n, SplatDouble( LN2_DOUBLE ) ) );
+		Double q = MulAdd( r, SplatDouble( 1.0 / 362880.0 ), SplatDouble( 1.0 / 40320.0 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 / 5040.0 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 / 720.0 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 / 120.0 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 / 24.0 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 / 6.0 ) );
+		q = MulAdd( r, q, SplatDouble( 0.5 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 ) );
+		q = MulAdd( r, q, SplatDouble( 1.0 ) );
+		return Mul( q, Exp2Rounded( rounded ) );
+	}
+
+	// pow( |base|, exponent ) pro konecne nenulove base
+	template < bool PRECISE >
+	inline Float PowMagnitude( const Float base, const Float exponent ) {
+		if ( !PRECISE ) {
+			return ExpKernel< false >( Mul( exponent, LogKernel< false >( base ) ) );
+		}
+		Float e;
+		const Float m = Decompose( base, e );
+		const Double low = PowDouble( ToDoubleLow( exponent ), ToDoubleLow( e ), ToDoubleLow( m ) );
+		const Double high = PowDouble( ToDoubleHigh( exponent ), ToDoubleHigh( e ), ToDoubleHigh( m ) );
+		return ToFloat( low, high );
+	}
+
+	// specialni hodnoty odpovidaji funkci pow ze standardni knihovny
+	template < bool PRECISE >
+	inline Float PowKernel( const Float base, const Float exponent ) {
+		const Float a = Abs( base );
+		Float result = PowMagnitude< PRECISE >( a, exponent );
+		const Float positive = Less( Splat( 0 ), exponent );
+		result = Select( Equal( a, Splat( INFINITY_FLOAT ) ), And( positive, Splat( INFINITY_FLOAT ) ), result );
+		result = Select( Equal( a, Splat( 0 ) ), AndNot( positive, Splat( INFINITY_FLOAT ) ), result );
+		result = Select( Equal( a, Splat( 1.0f ) ), Splat( 1.0f ), result );
+
+		// zaporny zaklad: licha cela mocnina meni znamenko, necela mocnina konecneho zakladu je NaN
+		const Float integer = Equal( Round( exponent ), exponent );
+		const Float odd = And( integer, AsFloat( ShiftRight< 31 >( ShiftLeft< 31 >( ToInt( exponent ) ) ) ) );
+		result = Xor( result, And( And( odd, SignMask( base ) ), Splat( SIGN_MASK ) ) );
+		const Float negative = And( Less( base, Splat( 0 ) ), Less( a, Splat( INFINITY_FLOAT ) ) );
+		result = Select( AndNot( integer, negative ), Splat( NAN_FLOAT ), result );
+
+		result = Select( Or( IsNan( base ), IsNan( exponent ) ), Splat( NAN_FLOAT ), result );
+		return Select( Or( Equal( base, Splat( 1.0f ) ), Equal( exponent, Splat( 0 ) ) ), Splat( 1.0f ), result );
+	}
+
+	template < bool PRECISE >
+	inline Float RSqrtKernel( const Float x ) {
+		if ( PRECISE ) {
+			return Div( Splat( 1.0f ), Sqrt( x ) );
+		}
+
+		// jeden krok Newtonovy metody, 0 a nekonecno vraci odhad (nasobeni by dalo NaN)
+		const Float y = RSqrtEstimate( x );
+		const Float refined = Mul( Mul( Splat( 0.5f ), y ), NegMulAdd( Mul( x, y ), y, Splat( 3.0f ) ) );
+		return Select( IsNan( refined ), y, refined );
+	}
+
+	/*
+	atan2 z pomeru a = min( |x|, |y| ) / max( |x|, |y| ) v < 0; 1 >, vysledek je pak posunut do spravneho oktantu.
+	Presna verze redukuje a > tan( pi / 8 ) na ( a - 1 ) / ( a + 1 ) + pi / 4.
+	*/
+	template < bool PRECISE >
+	inline Float Atan2Kernel( const Float y, const Float x ) {
+		const Float ax = Abs( x );
+		const Float ay = Abs( y );
+		const Float max = Max( ax, ay );
+		const Float min = Min( ax, ay );
+		Float a = Div( min, max );
+		a = Select( Equal( max, Splat( 0 ) ), Splat( 0 ), a );
+		a = Select( Equal( min, Splat( INFINITY_FLOAT ) ), Splat( 1.0f ), a );
+
+		Float r;
+		if ( PRECISE ) {
+			// ( a - 1 ) / ( a + 1 ) primo z argumentu bez zaokrouhleni pomeru a, velke hodnoty se zmensi (soucet nesmi pretect)
+			const Float reduce = Less( Splat( 0.414213562373095f ), a );
+			const Float scale = Select( Less( Splat( 1.0e38f ), max ), Splat( 0.25f ), Splat( 1.0f ) );
+			const Float scaledMin = Mul( min, scale );
+			const Float scaledMax = Mul( max, scale );
+			Float reduced = Div( Sub( scaledMin, scaledMax ), Add( scaledMin, scaledMax ) );
+			reduced = Select( Equal( min, Splat( INFINITY_FLOAT ) ), Splat( 0 ), reduced );
+			a = Select( reduce, reduced, a );
+			const Float z = Mul( a, a );
+			Float p = MulAdd( z, Splat( 8.05374449538e-2f ), Splat( -1.38776856032e-1f ) );
+			p = MulAdd( z, p, Splat( 1.99777106478e-1f ) );
+			p = MulAdd( z, p, Splat( -3.33329491539e-1f ) );
+			r = Add( MulAdd( Mul( a, z ), p, a ), And( reduce, Splat( PIDIV4_LOW ) ) );
+			r = Add( r, And( reduce, Splat( PIDIV4_HIGH ) ) );
+		} else {
+			const Float z = Mul( a, a );
+			Float p = MulAdd( z, Splat( -1.395509019e-2f ), Splat( 5.877022818e-2f ) );
+			p = MulAdd( z, p, Splat( -1.225149930e-1f ) );
+			p = MulAdd( z, p, Splat( 1.961830854e-1f ) );
+			p = MulAdd( z, p, Splat( -3.330889940e-1f ) );
+			r = MulAdd( Mul( a, z ), p, a );
+		}
+
+		// |y| > |x|: pi / 2 - r, x < 0: pi - r, znamenko podle y
+		r = Select( Less( ax, ay ), Add( Sub( Splat( PIDIV2_HIGH ), r ), Splat( PIDIV2_LOW ) ), r );
+		r = Select( SignMask( x ), Add( Sub( Splat( PI_HIGH ), r ), Splat( PI_LOW ) ), r );
+		r = Or( r, And( y, Splat( SIGN_MASK ) ) );
+		return Select( Or( IsNan( x ), IsNan( y ) ), Add( x, y ), r );
+	}
+
+	/*
+	Zpracovani pole po LANES hodnotach, zbytek pole je zpracovan stejnym kernelem pres pomocny buffer,
+	vysledek tak nezavisi na pozici hodnoty v poli.
+	*/
+	template < typename Kernel >
+	void Apply( const float* const in, float* const out, const std::size_t count, const Kernel& kernel ) {
+		std::size_t i = 0;
+		for ( ; i + LANES <= count; i += LANES ) {
+			Store( out + i, kernel( Load( in + i ) ) );
+		}
+		if ( i < count ) {
+			float buffer[ LANES ] = {};
+			std::memcpy( buffer, in + i, ( count - i ) * sizeof( float ) );
+			Store( buffer, kernel( Load( buffer ) ) );
+			std::memcpy( out + i, buffer, ( count - i ) * sizeof( float ) );
+		}
+	}
+
+	template < typename Kernel >
+	void Apply( const float* const a, const float* const b, float* const out, const std::size_t count, const Kernel& kernel ) {
+		std::size_t i = 0;
+		for ( ; i + LANES <= count; i += LANES ) {
+			Store( out + i, kernel( Load( a + i ), Load( b + i ) ) );
+		}
+		if ( i < count ) {
+			float bufferA[ LANES ] = {};
+			float bufferB[ LANES ] = {};
+			std::memcpy( bufferA, a + i, ( count - i ) * sizeof( float ) );
+			std::memcpy( bufferB, b + i, ( count - i ) * sizeof( float ) );
+			Store( bufferA, kernel( Load( bufferA ), Load( bufferB ) ) );
+			std::memcpy( out + i, bufferA, ( count - i ) * sizeof( float ) );
+		}
+	}
+
+	template < bool PRECISE >
+	void SinCosArray( const float* const in, float* const sin, float* const cos, const std::size_t count ) {
+		std::size_t i = 0;
+		Float s, c;
+		for ( ; i + LANES <= count; i += LANES ) {
+			SinCosKernel< PRECISE >( Load( in + i ), s, c );
+			Store( sin + i, s );
+			Store( cos + i, c );
+		}
+		if ( i < count ) {
+			float buffer[ LANES ] = {};
+			std::memcpy( buffer, in + i, ( count - i ) * sizeof( float ) );
+			SinCosKernel< PRECISE >( Load( buffer ), s, c );
+			Store( buffer, s );
+			std::memcpy( sin + i, buffer, ( count - i ) * sizeof( float ) );
+			Store( buffer, c );
+			std::memcpy( cos + i, buffer, ( count - i ) * sizeof( float ) );
+		}
+	}
+}
+
+namespace Math {
+
+	void Sin( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( in, out, count, []( const Float x ) { return SinKernel< true >( x ); } );
+		} else {
+			Apply( in, out, count, []( const Float x ) { return SinKernel< false >( x ); } );
+		}
+	}
+
+	void Cos( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( in, out, count, []( const Float x ) { return CosKernel< true >( x ); } );
+		} else {
+			Apply( in, out, count, []( const Float x ) { return CosKernel< false >( x ); } );
+		}
+	}
+
+	void SinCos( const float* const in, float* const sin, float* const cos, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			SinCosArray< true >( in, sin, cos, count );
+		} else {
+			SinCosArray< false >( in, sin, cos, count );
+		}
+	}
+
+	void Exp( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( in, out, count, []( const Float x ) { return ExpKernel< true >( x ); } );
+		} else {
+			Apply( in, out, count, []( const Float x ) { return ExpKernel< false >( x ); } );
+		}
+	}
+
+	void Log( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( in, out, count, []( const Float x ) { return LogKernel< true >( x ); } );
+		} else {
+			Apply( in, out, count, []( const Float x ) { return LogKernel< false >( x ); } );
+		}
+	}
+
+	void Pow( const float* const base, const float* const exponent, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( base, exponent, out, count, []( const Float b, const Float e ) { return PowKernel< true >( b, e ); } );
+		} else {
+			Apply( base, exponent, out, count, []( const Float b, const Float e ) { return PowKernel< false >( b, e ); } );
+		}
+	}
+
+	void RSqrt( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( in, out, count, []( const Float x ) { return RSqrtKernel< true >( x ); } );
+		} else {
+			Apply( in, out, count, []( const Float x ) { return RSqrtKernel< false >( x ); } );
+		}
+	}
+
+	void Atan2( const float* const y, const float* const x, float* const out, const std::size_t count, const MathAccuracy accuracy ) {
+		if ( accuracy == MathAccuracy::PRECISE ) {
+			Apply( y, x, out, count, []( const Float a, const Float b ) { return Atan2Kernel< true >( a, b ); } );
+		} else {
+			Apply( y, x, out, count, []( const Float a, const Float b ) { return Atan2Kernel< false >( a, b ); } );
+		}
+	}
+}
\ No newline at end of file
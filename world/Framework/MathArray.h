@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+Presnost funkci pro pole.
+PRECISE: chyba nejvyse nekolik ULP (jednotek posledniho mista) oproti presne zaokrouhlenemu vysledku, viz jednotlive funkce.
+FAST: relativni chyba radove 2^-16 (priblizne 5 platnych cislic), vhodne pro efekty a castice.
+*/
+enum class MathAccuracy {
+	FAST,
+	PRECISE
+};
+
+/*
+Elementarni funkce pro pole float, hodnoty jsou zpracovany po 8 (AVX2) nebo 4 (SSE) najednou.
+Pole nemusi byt zarovnana, vstup a vystup muze byt totozne pole. Vysledek nezavisi na pozici hodnoty v poli.
+Specialni hodnoty (0, nekonecno, NaN) odpovidaji standardni knihovne, pokud neni uvedeno jinak.
+Uvedene chyby jsou zmereny oproti vysledku v double pres cely definicni obor (pro SSE2, SSE4.1, AVX2 s FMA i skalarni
+implementaci), mereni opakuje benchmark bench accuracy.
+*/
+namespace Math {
+
+	/*
+	PRECISE: <= 2.5 ulp, FAST: absolutni chyba <= 1.5e-5, obe pro |x| <= 8192.
+	Pro vetsi |x| neni vysledek urcen (argument je redukovan jen s presnosti float), nekonecno a NaN vraci NaN.
+	*/
+	void Sin( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+	void Cos( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+	void SinCos( const float* const in, float* const sin, float* const cos, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+
+	// PRECISE: <= 1.5 ulp, FAST: <= 2^-17 relativne, denormalni vysledky mohou mit chybu 1 ulp navic
+	void Exp( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+
+	// prirozeny logaritmus, PRECISE: <= 1 ulp, FAST: absolutni chyba <= 1e-5 (relativni chyba blizko x = 1 roste)
+	void Log( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+
+	/*
+	out[ i ] = base[ i ]^exponent[ i ]
+	PRECISE: <= 1 ulp (pocitano v double), FAST: exp( exponent * log( base ) ) s relativni chybou <= 2^-15 * max( 1, |exponent * log( base )| )
+	*/
+	void Pow( const float* const base, const float* const exponent, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+
+	// 1 / sqrt( x ), PRECISE: <= 1.5 ulp, FAST: <= 2^-21 relativne, pro denormalni x muze vracet nekonecno
+	void RSqrt( const float* const in, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+
+	// out[ i ] = atan2( y[ i ], x[ i ] ), PRECISE: <= 2.5 ulp, FAST: <= 2^-17 relativne
+	void Atan2( const float* const y, const float* const x, float* const out, const std::size_t count, const MathAccuracy accuracy = MathAccuracy::PRECISE );
+}
\ No newline at end of file
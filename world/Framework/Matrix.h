@@ -1,7 +1,8 @@
 #pragma once
 
-#include <DirectXMath.h>
+#include <cmath>
 #include "Types.h"
+#include "Simd.h"
 
 class Vector;
 
@@ -17,13 +18,37 @@ public:
 			float m30, m31, m32, m33;
 		};
 		float m[ 4 ][ 4 ];
-		
-		// internal use only!
-		DirectX::XMFLOAT4X4A xm4x4;
 	};
 
 public:
-	Matrix();
+	// jednotkova matice
+	constexpr Matrix();
+	constexpr Matrix(
+		const float m00, const float m01, const float m02, const float m03,
+		const float m10, const float m11, const float m12, const float m13,
+		const float m20, const float m21, const float m22, const float m23,
+		const float m30, const float m31, const float m32, const float m33
+	);
+
+	/*
+	Konstantni matice vyhodnotitelne pri prekladu (constexpr Matrix view = Matrix::MakeBasis( ... )).
+	Pri prekladu lze cist jen pole m (aktivni clen unie), ne pojmenovane prvky m00 - m33.
+	*/
+	static constexpr Matrix MakeTranslation( const float x, const float y, const float z );
+	static constexpr Matrix MakeScaling( const float x, const float y, const float z );
+
+	// osy a pocatek lokalniho souradneho systemu (radky matice)
+	static constexpr Matrix MakeBasis( const Vector& axisX, const Vector& axisY, const Vector& axisZ, const Vector& origin );
+
+	// projekce podle rozmeru viditelne oblasti v near rovine (pro zorny uhel fov je sirka 2 * near * tan( fov / 2 ))
+	static constexpr Matrix MakePerspectiveLH( const float viewWidth, const float viewHeight, const float nearDraw, const float farDraw );
+	static constexpr Matrix MakeOrthographicLH( const float viewWidth, const float viewHeight, const float nearDraw, const float farDraw );
+
+	// a * b
+	static constexpr Matrix MakeProduct( const Matrix& a, const Matrix& b );
+
+	// transpozice pro konstantni buffery
+	constexpr Float4x4 GetColumnMajor() const;
 	
 	// operace
 	void Mul( const Matrix& m );
@@ -65,35 +90,100 @@ public:
 
 #include "Vector.h"
 
-inline Matrix::Matrix() {
-	DirectX::XMStoreFloat4x4A( &xm4x4, DirectX::XMMatrixIdentity() );
+constexpr Matrix::Matrix(): m{ { 1.0f, 0, 0, 0 }, { 0, 1.0f, 0, 0 }, { 0, 0, 1.0f, 0 }, { 0, 0, 0, 1.0f } } {
+}
+
+constexpr Matrix::Matrix(
+	const float m00, const float m01, const float m02, const float m03,
+	const float m10, const float m11, const float m12, const float m13,
+	const float m20, const float m21, const float m22, const float m23,
+	const float m30, const float m31, const float m32, const float m33
+): m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } } {
+}
+
+constexpr Matrix Matrix::MakeTranslation( const float x, const float y, const float z ) {
+	return Matrix(
+		1.0f, 0, 0, 0,
+		0, 1.0f, 0, 0,
+		0, 0, 1.0f, 0,
+		x, y, z, 1.0f
+	);
+}
+
+constexpr Matrix Matrix::MakeScaling( const float x, const float y, const float z ) {
+	return Matrix(
+		x, 0, 0, 0,
+		0, y, 0, 0,
+		0, 0, z, 0,
+		0, 0, 0, 1.0f
+	);
+}
+
+constexpr Matrix Matrix::MakeBasis( const Vector& axisX, const Vector& axisY, const Vector& axisZ, const Vector& origin ) {
+	return Matrix(
+		axisX.x, axisX.y, axisX.z, 0,
+		axisY.x, axisY.y, axisY.z, 0,
+		axisZ.x, axisZ.y, axisZ.z, 0,
+		origin.x, origin.y, origin.z, 1.0f
+	);
+}
+
+constexpr Matrix Matrix::MakePerspectiveLH( const float viewWidth, const float viewHeight, const float nearDraw, const float farDraw ) {
+	const float range = farDraw / ( farDraw - nearDraw );
+	return Matrix(
+		2.0f * nearDraw / viewWidth, 0, 0, 0,
+		0, 2.0f * nearDraw / viewHeight, 0, 0,
+		0, 0, range, 1.0f,
+		0, 0, -range * nearDraw, 0
+	);
+}
+
+constexpr Matrix Matrix::MakeOrthographicLH( const float viewWidth, const float viewHeight, const float nearDraw, const float farDraw ) {
+	const float range = 1.0f / ( farDraw - nearDraw );
+	return Matrix(
+		2.0f / viewWidth, 0, 0, 0,
+		0, 2.0f / viewHeight, 0, 0,
+		0, 0, range, 0,
+		0, 0, -range * nearDraw, 1.0f
+	);
+}
+
+constexpr Matrix Matrix::MakeProduct( const Matrix& a, const Matrix& b ) {
+	Matrix result;
+	for ( int i = 0; i < 4; i++ ) {
+		for ( int j = 0; j < 4; j++ ) {
+			result.m[ i ][ j ] = a.m[ i ][ 0 ] * b.m[ 0 ][ j ] + a.m[ i ][ 1 ] * b.m[ 1 ][ j ] + a.m[ i ][ 2 ] * b.m[ 2 ][ j ] + a.m[ i ][ 3 ] * b.m[ 3 ][ j ];
+		}
+	}
+	return result;
+}
+
+constexpr Float4x4 Matrix::GetColumnMajor() const {
+	return Float4x4(
+		m[ 0 ][ 0 ], m[ 1 ][ 0 ], m[ 2 ][ 0 ], m[ 3 ][ 0 ],
+		m[ 0 ][ 1 ], m[ 1 ][ 1 ], m[ 2 ][ 1 ], m[ 3 ][ 1 ],
+		m[ 0 ][ 2 ], m[ 1 ][ 2 ], m[ 2 ][ 2 ], m[ 3 ][ 2 ],
+		m[ 0 ][ 3 ], m[ 1 ][ 3 ], m[ 2 ][ 3 ], m[ 3 ][ 3 ]
+	);
 }
 
 inline void Matrix::Identity() {
-	DirectX::XMStoreFloat4x4A( &xm4x4, DirectX::XMMatrixIdentity() );
+	Simd::Store( m[ 0 ], Simd::Set( 1.0f, 0, 0, 0 ) );
+	Simd::Store( m[ 1 ], Simd::Set( 0, 1.0f, 0, 0 ) );
+	Simd::Store( m[ 2 ], Simd::Set( 0, 0, 1.0f, 0 ) );
+	Simd::Store( m[ 3 ], Simd::Set( 0, 0, 0, 1.0f ) );
 }
 
 inline void Matrix::Transpose() {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixTranspose(
-			DirectX::XMLoadFloat4x4A( &xm4x4 )
-		)
-	);
+	Simd::MatrixTranspose( m[ 0 ], m[ 0 ] );
 }
 
 inline void Matrix::Inverse() {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixInverse( nullptr, DirectX::XMLoadFloat4x4A( &xm4x4 ) )
-	);
+	Simd::MatrixInverse( m[ 0 ], m[ 0 ] );
 }
 
 inline void Matrix::Mul( const Matrix& m ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMLoadFloat4x4A( &m.xm4x4 )
-		)
-	);
+	Simd::MatrixMultiply( this->m[ 0 ], m.m[ 0 ], this->m[ 0 ] );
 }
 
 inline void Matrix::Transform( const Matrix& transformations ) {
@@ -101,25 +191,37 @@ inline void Matrix::Transform( const Matrix& transformations ) {
 }
 
 inline void Matrix::Translate( const float x, const float y, const float z ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMMatrixTranslation( x, y, z )
-		)
-	);
+	Matrix translation;
+	translation.m30 = x;
+	translation.m31 = y;
+	translation.m32 = z;
+	Mul( translation );
 }
 
 inline void Matrix::Translate( const Vector& xyz ) {
 	Translate( xyz.x, xyz.y, xyz.z );
 }
 
+// rotace postupne kolem os z (roll), x (pitch) a y (yaw)
 inline void Matrix::Rotate( const float roll, const float pitch, const float yaw ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMMatrixRotationRollPitchYaw( pitch, yaw, roll )
-		)
-	);
+	const float sp = std::sin( pitch );
+	const float cp = std::cos( pitch );
+	const float sy = std::sin( yaw );
+	const float cy = std::cos( yaw );
+	const float sr = std::sin( roll );
+	const float cr = std::cos( roll );
+
+	Matrix rotation;
+	rotation.m00 = cr * cy + sr * sp * sy;
+	rotation.m01 = sr * cp;
+	rotation.m02 = sr * sp * cy - cr * sy;
+	rotation.m10 = cr * sp * sy - sr * cy;
+	rotation.m11 = cr * cp;
+	rotation.m12 = sr * sy + cr * sp * cy;
+	rotation.m20 = cp * sy;
+	rotation.m21 = -sp;
+	rotation.m22 = cp * cy;
+	Mul( rotation );
 }
 
 inline void Matrix::Rotate( const Vector& rollPitchYaw ) {
@@ -127,48 +229,64 @@ inline void Matrix::Rotate( const Vector& rollPitchYaw ) {
 }
 
 inline void Matrix::RotateX( const float rad ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMMatrixRotationX( rad )
-		)
-	);
+	const float sin = std::sin( rad );
+	const float cos = std::cos( rad );
+	Matrix rotation;
+	rotation.m11 = cos;
+	rotation.m12 = sin;
+	rotation.m21 = -sin;
+	rotation.m22 = cos;
+	Mul( rotation );
 }
 
 inline void Matrix::RotateY( const float rad ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMMatrixRotationY( rad )
-		)
-	);
+	const float sin = std::sin( rad );
+	const float cos = std::cos( rad );
+	Matrix rotation;
+	rotation.m00 = cos;
+	rotation.m02 = -sin;
+	rotation.m20 = sin;
+	rotation.m22 = cos;
+	Mul( rotation );
 }
 
 inline void Matrix::RotateZ( const float rad ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMMatrixRotationZ( rad )
-		)
-	);
+	const float sin = std::sin( rad );
+	const float cos = std::cos( rad );
+	Matrix rotation;
+	rotation.m00 = cos;
+	rotation.m01 = sin;
+	rotation.m10 = -sin;
+	rotation.m11 = cos;
+	Mul( rotation );
 }
 
 inline void Matrix::RotateAxis( const Vector& axes, const float rad ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply(
-			DirectX::XMLoadFloat4x4A( &xm4x4 ),
-			DirectX::XMMatrixRotationAxis( DirectX::XMLoadFloat4( &axes.xm4 ), rad )
-		)
-	);
+	Vector n = axes;
+	n.Normalize();
+	const float sin = std::sin( rad );
+	const float cos = std::cos( rad );
+	const float t = 1.0f - cos;
+
+	Matrix rotation;
+	rotation.m00 = t * n.x * n.x + cos;
+	rotation.m01 = t * n.x * n.y + sin * n.z;
+	rotation.m02 = t * n.z * n.x - sin * n.y;
+	rotation.m10 = t * n.x * n.y - sin * n.z;
+	rotation.m11 = t * n.y * n.y + cos;
+	rotation.m12 = t * n.y * n.z + sin * n.x;
+	rotation.m20 = t * n.z * n.x + sin * n.y;
+	rotation.m21 = t * n.y * n.z - sin * n.x;
+	rotation.m22 = t * n.z * n.z + cos;
+	Mul( rotation );
 }
 
 inline void Matrix::Scale( const float x, const float y, const float z ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixMultiply( 
-			DirectX::XMLoadFloat4x4A( &xm4x4 ), 
-			DirectX::XMMatrixScaling( x, y, z )
-		)
-	);
+	Matrix scaling;
+	scaling.m00 = x;
+	scaling.m11 = y;
+	scaling.m22 = z;
+	Mul( scaling );
 }
 
 inline void Matrix::Scale( const Vector& xyz ) {
@@ -176,31 +294,29 @@ inline void Matrix::Scale( const Vector& xyz ) {
 }
 
 inline void Matrix::StoreColumnMajor( Float4x4& dest ) const {
-	DirectX::XMStoreFloat4x4A(
-		reinterpret_cast< DirectX::XMFLOAT4X4A* >( &dest ),
-		DirectX::XMMatrixTranspose( DirectX::XMLoadFloat4x4A( &xm4x4 ) )
-	);
+	Simd::MatrixTranspose( m[ 0 ], dest.m[ 0 ] );
 }
 
 inline void Matrix::StoreColumnMajor( Float3x3& dest ) const {
-	DirectX::XMStoreFloat3x3(
-		reinterpret_cast< DirectX::XMFLOAT3X3* >( &dest ),
-		DirectX::XMMatrixTranspose( DirectX::XMLoadFloat4x4A( &xm4x4 ) )
-	);
+	for ( int i = 0; i < 3; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			dest.m[ i ][ j ] = m[ j ][ i ];
+		}
+	}
 }
 
 inline void Matrix::Store( Float4x4& dest ) const {
-	DirectX::XMStoreFloat4x4A(
-		reinterpret_cast< DirectX::XMFLOAT4X4A* >( &dest ),
-		DirectX::XMLoadFloat4x4A( &xm4x4 )
-	);
+	for ( int i = 0; i < 4; i++ ) {
+		Simd::Store( dest.m[ i ], Simd::Load( m[ i ] ) );
+	}
 }
 
 inline void Matrix::Store( Float3x3& dest ) const {
-	DirectX::XMStoreFloat3x3(
-		reinterpret_cast< DirectX::XMFLOAT3X3* >( &dest ),
-		DirectX::XMLoadFloat4x4A( &xm4x4 )
-	);
+	for ( int i = 0; i < 3; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			dest.m[ i ][ j ] = m[ i ][ j ];
+		}
+	}
 }
 
 inline Matrix::operator Float4x4() const {
@@ -216,17 +332,33 @@ inline Matrix::operator Float3x3() const {
 }
 
 inline void Matrix::PerspectiveLH( const float fovVertical, const float aspectRatio, const float nearDraw, const float farDraw ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixPerspectiveFovLH( fovVertical, aspectRatio, nearDraw, farDraw )
-	);
+	const float height = std::cos( fovVertical * 0.5f ) / std::sin( fovVertical * 0.5f );
+	const float range = farDraw / ( farDraw - nearDraw );
+	Simd::Store( m[ 0 ], Simd::Set( height / aspectRatio, 0, 0, 0 ) );
+	Simd::Store( m[ 1 ], Simd::Set( 0, height, 0, 0 ) );
+	Simd::Store( m[ 2 ], Simd::Set( 0, 0, range, 1.0f ) );
+	Simd::Store( m[ 3 ], Simd::Set( 0, 0, -range * nearDraw, 0 ) );
 }
 
 inline void Matrix::LookToLH( const Vector& position, const Vector& direction, const Vector& up ) {
-	DirectX::XMStoreFloat4x4A( &xm4x4,
-		DirectX::XMMatrixLookToLH( 
-			DirectX::XMLoadFloat4A( &position.xm4 ),
-			DirectX::XMLoadFloat4A( &direction.xm4 ),
-			DirectX::XMLoadFloat4A( &up.xm4 )
-		)
-	);
+	const Simd::Vec4 axisZ = Simd::Normalize3( Simd::Load( &direction.x ) );
+	const Simd::Vec4 axisX = Simd::Normalize3( Simd::Cross3( Simd::Load( &up.x ), axisZ ) );
+	const Simd::Vec4 axisY = Simd::Cross3( axisZ, axisX );
+	const Simd::Vec4 negPosition = Simd::Sub( Simd::Zero(), Simd::Load( &position.x ) );
+
+	// radky pohledove matice jsou sloupce os kamery, posledni radek posun
+	Simd::Vec4 r0 = Simd::ClearW( axisX );
+	Simd::Vec4 r1 = Simd::ClearW( axisY );
+	Simd::Vec4 r2 = Simd::ClearW( axisZ );
+	Simd::Vec4 r3 = Simd::Set( 0, 0, 0, 1.0f );
+	Simd::Transpose( r0, r1, r2, r3 );
+	Simd::Store( m[ 0 ], r0 );
+	Simd::Store( m[ 1 ], r1 );
+	Simd::Store( m[ 2 ], r2 );
+	Simd::Store( m[ 3 ], Simd::Set(
+		Simd::GetX( Simd::Dot3( axisX, negPosition ) ),
+		Simd::GetX( Simd::Dot3( axisY, negPosition ) ),
+		Simd::GetX( Simd::Dot3( axisZ, negPosition ) ),
+		1.0f
+	) );
 }
\ No newline at end of file
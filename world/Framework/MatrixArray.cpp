@@ -0,0 +1,318 @@
+#include "MatrixArray.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+static_assert( MATRIX_PARALLEL_BATCH % 8 == 0, "MATRIX_PARALLEL_BATCH must be a multiple of 8" );
+
+namespace {
+
+	/*
+	Registry pro davkove zpracovani matic: Lanes4 zpracovava 4 matice (Simd::Vec4), Lanes8 8 matic (AVX2).
+	Registr Lanes8 obsahuje v dolni polovine matici k a v horni polovine matici k + 4, operace s obema polovinami
+	(vcetne transpozice) probihaji nezavisle. Pro Lanes8 tak plati stejny kod jako pro Lanes4.
+	*/
+	struct Lanes4 {
+		using Reg = Simd::Vec4;
+		static const std::size_t COUNT = 4;
+
+		static Reg LoadRow( const Matrix* const matrices, const std::size_t k, const std::size_t row ) {
+			return Simd::Load( matrices[ k ].m[ row ] );
+		}
+
+		static void StoreRow( Matrix* const matrices, const std::size_t k, const std::size_t row, const Reg v ) {
+			Simd::Store( matrices[ k ].m[ row ], v );
+		}
+
+		static Reg Replicate( const float value ) {
+			return Simd::Replicate( value );
+		}
+
+		static Reg Mul( const Reg a, const Reg b ) {
+			return Simd::Mul( a, b );
+		}
+
+		static Reg Div( const Reg a, const Reg b ) {
+			return Simd::Div( a, b );
+		}
+
+		static Reg MulAdd( const Reg a, const Reg b, const Reg c ) {
+			return Simd::MulAdd( a, b, c );
+		}
+
+		static Reg NegMulAdd( const Reg a, const Reg b, const Reg c ) {
+			return Simd::NegMulAdd( a, b, c );
+		}
+
+		static void Transpose( Reg& r0, Reg& r1, Reg& r2, Reg& r3 ) {
+			Simd::Transpose( r0, r1, r2, r3 );
+		}
+	};
+
+#ifdef SIMD_AVX2
+	struct Lanes8 {
+		using Reg = __m256;
+		static const std::size_t COUNT = 8;
+
+		static Reg LoadRow( const Matrix* const matrices, const std::size_t k, const std::size_t row ) {
+			return Load( matrices[ k ].m[ row ], matrices[ k + 4 ].m[ row ] );
+		}
+
+		static void StoreRow( Matrix* const matrices, const std::size_t k, const std::size_t row, const Reg v ) {
+			_mm_store_ps( matrices[ k ].m[ row ], _mm256_castps256_ps128( v ) );
+			_mm_store_ps( matrices[ k + 4 ].m[ row ], _mm256_extractf128_ps( v, 1 ) );
+		}
+
+		// nacteni dvou radku po 16 bajtech do dolni a horni poloviny registru
+		static Reg Load( const float* const low, const float* const high ) {
+			return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( low ) ), _mm_load_ps( high ), 1 );
+		}
+
+		static Reg Replicate( const float value ) {
+			return _mm256_set1_ps( value );
+		}
+
+		static Reg Mul( const Reg a, const Reg b ) {
+			return _mm256_mul_ps( a, b );
+		}
+
+		static Reg Div( const Reg a, const Reg b ) {
+			return _mm256_div_ps( a, b );
+		}
+
+		static Reg MulAdd( const Reg a, const Reg b, const Reg c ) {
+		#ifdef SIMD_FMA
+			return _mm256_fmadd_ps( a, b, c );
+		#else
+			return _mm256_add_ps( _mm256_mul_ps( a, b ), c );
+		#endif
+		}
+
+		static Reg NegMulAdd( const Reg a, const Reg b, const Reg c ) {
+		#ifdef SIMD_FMA
+			return _mm256_fnmadd_ps( a, b, c );
+		#else
+			return _mm256_sub_ps( c, _mm256_mul_ps( a, b ) );
+		#endif
+		}
+
+		// transpozice v kazde polovine registru zvlast (stejne poradi instrukci jako Simd::Transpose)
+		static void Transpose( Reg& r0, Reg& r1, Reg& r2, Reg& r3 ) {
+			const Reg t0 = _mm256_shuffle_ps( r0, r1, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const Reg t1 = _mm256_shuffle_ps( r0, r1, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+			const Reg t2 = _mm256_shuffle_ps( r2, r3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const Reg t3 = _mm256_shuffle_ps( r2, r3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+			r0 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+			r1 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+			r2 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 2, 0, 2, 0 ) );
+			r3 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+		}
+	};
+#endif
+
+	/*
+	Inverze Lanes::COUNT afinnich matic. Matice jsou transponovany po radcich tak, ze kazdy registr obsahuje
+	jeden prvek vsech matic (structure of arrays), inverze se pak pocita jako pro jednu matici bez shuffle instrukci.
+	Inverze 3x3 casti je transpozice vektorovych soucinu radku delena determinantem, posun je -t * inverze( A ).
+	*/
+	template < typename Lanes >
+	void InverseAffineBatch( const Matrix* const in, Matrix* const out ) {
+		using Reg = typename Lanes::Reg;
+		Reg a[ 4 ][ 4 ];
+		for ( std::size_t row = 0; row < 4; row++ ) {
+			Reg r0 = Lanes::LoadRow( in, 0, row );
+			Reg r1 = Lanes::LoadRow( in, 1, row );
+			Reg r2 = Lanes::LoadRow( in, 2, row );
+			Reg r3 = Lanes::LoadRow( in, 3, row );
+			Lanes::Transpose( r0, r1, r2, r3 );
+			a[ row ][ 0 ] = r0;
+			a[ row ][ 1 ] = r1;
+			a[ row ][ 2 ] = r2;
+			a[ row ][ 3 ] = r3;
+		}
+
+		// c0 = cross( a1, a2 ), c1 = cross( a2, a0 ), c2 = cross( a0, a1 )
+		Reg c[ 3 ][ 3 ];
+		for ( std::size_t i = 0; i < 3; i++ ) {
+			const Reg* const u = a[ ( i + 1 ) % 3 ];
+			const Reg* const v = a[ ( i + 2 ) % 3 ];
+			c[ i ][ 0 ] = Lanes::NegMulAdd( u[ 2 ], v[ 1 ], Lanes::Mul( u[ 1 ], v[ 2 ] ) );
+			c[ i ][ 1 ] = Lanes::NegMulAdd( u[ 0 ], v[ 2 ], Lanes::Mul( u[ 2 ], v[ 0 ] ) );
+			c[ i ][ 2 ] = Lanes::NegMulAdd( u[ 1 ], v[ 0 ], Lanes::Mul( u[ 0 ], v[ 1 ] ) );
+		}
+		const Reg det = Lanes::MulAdd( a[ 0 ][ 2 ], c[ 0 ][ 2 ], Lanes::MulAdd( a[ 0 ][ 1 ], c[ 0 ][ 1 ], Lanes::Mul( a[ 0 ][ 0 ], c[ 0 ][ 0 ] ) ) );
+		const Reg invDet = Lanes::Div( Lanes::Replicate( 1.0f ), det );
+
+		Reg inv[ 4 ][ 4 ];
+		for ( std::size_t row = 0; row < 3; row++ ) {
+			for ( std::size_t column = 0; column < 3; column++ ) {
+				inv[ row ][ column ] = Lanes::Mul( c[ column ][ row ], invDet );
+			}
+			inv[ row ][ 3 ] = Lanes::Replicate( 0 );
+		}
+		for ( std::size_t column = 0; column < 3; column++ ) {
+			Reg t = Lanes::NegMulAdd( a[ 3 ][ 0 ], inv[ 0 ][ column ], Lanes::Replicate( 0 ) );
+			t = Lanes::NegMulAdd( a[ 3 ][ 1 ], inv[ 1 ][ column ], t );
+			inv[ 3 ][ column ] = Lanes::NegMulAdd( a[ 3 ][ 2 ], inv[ 2 ][ column ], t );
+		}
+		inv[ 3 ][ 3 ] = Lanes::Replicate( 1.0f );
+
+		for ( std::size_t row = 0; row < 4; row++ ) {
+			Reg r0 = inv[ row ][ 0 ];
+			Reg r1 = inv[ row ][ 1 ];
+			Reg r2 = inv[ row ][ 2 ];
+			Reg r3 = inv[ row ][ 3 ];
+			Lanes::Transpose( r0, r1, r2, r3 );
+			Lanes::StoreRow( out, 0, row, r0 );
+			Lanes::StoreRow( out, 1, row, r1 );
+			Lanes::StoreRow( out, 2, row, r2 );
+			Lanes::StoreRow( out, 3, row, r3 );
+		}
+	}
+
+	void InverseAffine( const Matrix* const in, Matrix* const out, const std::size_t begin, const std::size_t end ) {
+		std::size_t i = begin;
+	#ifdef SIMD_AVX2
+		for ( ; i + Lanes8::COUNT <= end; i += Lanes8::COUNT ) {
+			InverseAffineBatch< Lanes8 >( in + i, out + i );
+		}
+	#endif
+		for ( ; i + Lanes4::COUNT <= end; i += Lanes4::COUNT ) {
+			InverseAffineBatch< Lanes4 >( in + i, out + i );
+		}
+
+		// konec pole, chybejici matice jsou jednotkove
+		if ( i < end ) {
+			Matrix batch[ 4 ];
+			for ( std::size_t k = 0; i + k < end; k++ ) {
+				batch[ k ] = in[ i + k ];
+			}
+			InverseAffineBatch< Lanes4 >( batch, batch );
+			for ( std::size_t k = 0; i + k < end; k++ ) {
+				out[ i + k ] = batch[ k ];
+			}
+		}
+	}
+
+	template < bool STREAMING >
+	void StoreRow( float* const dest, const Simd::Vec4 v ) {
+		if ( STREAMING ) {
+			Simd::StoreStream( dest, v );
+		} else {
+			Simd::Store( dest, v );
+		}
+	}
+
+	/*
+	Ulozeni po sloupcich: transpozice vstupni matice a pri MULTIPLY soucin transpose( a * m ) = transpose( m ) * transpose( a ),
+	tj. radek j vysledku je soucet m[ k ][ j ] * radek k transpozice a. Prvky m jsou pripraveny pred smyckou,
+	na jednu matici tak pripada jedna transpozice a 16 nasobeni bez dalsich shuffle instrukci.
+	Pri AVX2 jsou zpracovavany dve matice najednou (kazda v jedne polovine registru).
+	*/
+	template < bool MULTIPLY, bool STREAMING >
+	void StoreColumnMajor( const Matrix* const in, const float* const m, Float4x4* const out, const std::size_t begin, const std::size_t end ) {
+		std::size_t i = begin;
+	#ifdef SIMD_AVX2
+		if ( MULTIPLY ) {
+			// bt[ j ][ k ] = m[ k ][ j ]
+			__m256 bt[ 4 ][ 4 ];
+			for ( std::size_t k = 0; k < 16; k++ ) {
+				bt[ k % 4 ][ k / 4 ] = _mm256_set1_ps( m[ k ] );
+			}
+			for ( ; i + 2 <= end; i += 2 ) {
+				__m256 r0 = Lanes8::Load( in[ i ].m[ 0 ], in[ i + 1 ].m[ 0 ] );
+				__m256 r1 = Lanes8::Load( in[ i ].m[ 1 ], in[ i + 1 ].m[ 1 ] );
+				__m256 r2 = Lanes8::Load( in[ i ].m[ 2 ], in[ i + 1 ].m[ 2 ] );
+				__m256 r3 = Lanes8::Load( in[ i ].m[ 3 ], in[ i + 1 ].m[ 3 ] );
+				Lanes8::Transpose( r0, r1, r2, r3 );
+				for ( std::size_t j = 0; j < 4; j++ ) {
+					const __m256* const b = bt[ j ];
+					const __m256 column = Lanes8::MulAdd( r3, b[ 3 ], Lanes8::MulAdd( r2, b[ 2 ], Lanes8::MulAdd( r1, b[ 1 ], Lanes8::Mul( r0, b[ 0 ] ) ) ) );
+					StoreRow< STREAMING >( out[ i ].m[ j ], _mm256_castps256_ps128( column ) );
+					StoreRow< STREAMING >( out[ i + 1 ].m[ j ], _mm256_extractf128_ps( column, 1 ) );
+				}
+			}
+		}
+	#endif
+		Simd::Vec4 bt[ 4 ][ 4 ];
+		if ( MULTIPLY ) {
+			for ( std::size_t k = 0; k < 16; k++ ) {
+				bt[ k % 4 ][ k / 4 ] = Simd::Replicate( m[ k ] );
+			}
+		}
+		for ( ; i < end; i++ ) {
+			Simd::Vec4 r0 = Simd::Load( in[ i ].m[ 0 ] );
+			Simd::Vec4 r1 = Simd::Load( in[ i ].m[ 1 ] );
+			Simd::Vec4 r2 = Simd::Load( in[ i ].m[ 2 ] );
+			Simd::Vec4 r3 = Simd::Load( in[ i ].m[ 3 ] );
+			Simd::Transpose( r0, r1, r2, r3 );
+			if ( MULTIPLY ) {
+				for ( std::size_t j = 0; j < 4; j++ ) {
+					const Simd::Vec4* const b = bt[ j ];
+					const Simd::Vec4 column = Simd::MulAdd( r3, b[ 3 ], Simd::MulAdd( r2, b[ 2 ], Simd::MulAdd( r1, b[ 1 ], Simd::Mul( r0, b[ 0 ] ) ) ) );
+					StoreRow< STREAMING >( out[ i ].m[ j ], column );
+				}
+			} else {
+				StoreRow< STREAMING >( out[ i ].m[ 0 ], r0 );
+				StoreRow< STREAMING >( out[ i ].m[ 1 ], r1 );
+				StoreRow< STREAMING >( out[ i ].m[ 2 ], r2 );
+				StoreRow< STREAMING >( out[ i ].m[ 3 ], r3 );
+			}
+		}
+
+		// zapisy mimo cache musi byt dokonceny ve vlakne, ktere je provedlo
+		if ( STREAMING ) {
+			Simd::StreamFence();
+		}
+	}
+
+	template < bool MULTIPLY >
+	void StoreColumnMajor( const Matrix* const in, const Matrix* const m, Float4x4* const out, const std::size_t count, const bool streaming, const bool parallel ) {
+		// kopie m, pole out muze prekryvat m
+		const Matrix local = m != nullptr ? *m : Matrix();
+		auto function = [ & ]( const std::size_t begin, const std::size_t end ) {
+			if ( streaming ) {
+				StoreColumnMajor< MULTIPLY, true >( in, local.m[ 0 ], out, begin, end );
+			} else {
+				StoreColumnMajor< MULTIPLY, false >( in, local.m[ 0 ], out, begin, end );
+			}
+		};
+		if ( parallel ) {
+			ParallelFor( count, MATRIX_PARALLEL_BATCH, function );
+			return;
+		}
+		function( 0, count );
+	}
+}
+
+void MultiplyMatrices( const Matrix* const in, const Matrix& m, Matrix* const out, const std::size_t count, const bool parallel ) {
+	// kopie m, pole out muze obsahovat m
+	const Matrix local = m;
+	auto function = [ & ]( const std::size_t begin, const std::size_t end ) {
+		for ( std::size_t i = begin; i < end; i++ ) {
+			Simd::MatrixMultiply( in[ i ].m[ 0 ], local.m[ 0 ], out[ i ].m[ 0 ] );
+		}
+	};
+	if ( parallel ) {
+		ParallelFor( count, MATRIX_PARALLEL_BATCH, function );
+		return;
+	}
+	function( 0, count );
+}
+
+void InverseAffineMatrices( const Matrix* const in, Matrix* const out, const std::size_t count, const bool parallel ) {
+	if ( parallel ) {
+		ParallelFor( count, MATRIX_PARALLEL_BATCH, [ & ]( const std::size_t begin, const std::size_t end ) {
+			InverseAffine( in, out, begin, end );
+		} );
+		return;
+	}
+	InverseAffine( in, out, 0, count );
+}
+
+void StoreColumnMajor( const Matrix* const in, Float4x4* const out, const std::size_t count, const bool streaming, const bool parallel ) {
+	StoreColumnMajor< false >( in, nullptr, out, count, streaming, parallel );
+}
+
+void StoreColumnMajor( const Matrix* const in, const Matrix& m, Float4x4* const out, const std::size_t count, const bool streaming, const bool parallel ) {
+	StoreColumnMajor< true >( in, &m, out, count, streaming, parallel );
+}
\ No newline at end of file
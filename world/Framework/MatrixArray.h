@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include "Types.h"
+#include "Matrix.h"
+
+/*
+Operace s poli matic (napr. transformace instanci).
+Pole matic musi byt zarovnana na 16 bajtu (Matrix a Float4x4 jsou zarovnane), vstup a vystup muze byt totozne pole.
+Pri parallel jsou pole delsi nez MATRIX_PARALLEL_BATCH rozdelena mezi vlakna ParallelFor.
+*/
+const std::size_t MATRIX_PARALLEL_BATCH = 1024;
+
+// out[ i ] = in[ i ] * m
+void MultiplyMatrices( const Matrix* const in, const Matrix& m, Matrix* const out, const std::size_t count, const bool parallel = false );
+
+/*
+Inverze afinnich matic (posledni sloupec matice je ( 0, 0, 0, 1 ), jeho skutecna hodnota se ignoruje).
+Matice musi byt regularni. Matice jsou zpracovavany po 4 (SSE) nebo 8 (AVX2) najednou.
+*/
+void InverseAffineMatrices( const Matrix* const in, Matrix* const out, const std::size_t count, const bool parallel = false );
+
+/*
+Ulozeni matic po sloupcich (pro konstantni buffery a buffery instanci s formatem R32G32B32A32_FLOAT).
+Pri streaming jsou data zapisovana mimo cache, coz je vhodne pro zapis do namapovaneho bufferu GPU,
+ktery se zpetne necte. Funkce se vraci az po dokonceni zapisu, buffer lze ihned odmapovat.
+*/
+void StoreColumnMajor( const Matrix* const in, Float4x4* const out, const std::size_t count, const bool streaming = false, const bool parallel = false );
+
+// out[ i ] = transpose( in[ i ] * m ), napr. world * viewProjection v jednom pruchodu
+void StoreColumnMajor( const Matrix* const in, const Matrix& m, Float4x4* const out, const std::size_t count, const bool streaming = false, const bool parallel = false );
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "PackedArray.h"
+#include "Half.h"
+#include "VertexPacking.h"
+#include "Simd.h"
+
+// FloatN a Vector zabiraji 16 bajtu, Float4 a Half4 lze prevadet jako souvisla pole slozek
+static_assert( sizeof( Float2 ) == 16 && sizeof( Float3 ) == 16 && sizeof( Float4 ) == 16 && sizeof( Vector ) == 16, "compute types must be padded to 16 bytes" );
+static_assert( sizeof( Float4 ) == sizeof( PackedFloat4 ), "Float4 must have no padding" );
+
+namespace {
+
+	// velikost bloku pro prevod Half2 pres pomocne pole
+	const std::size_t HALF_CHUNK = 256;
+
+}
+
+/*
+PackedFloat3: kazdy prvek krome posledniho se nacita (zapisuje) jednou 16 bajtovou operaci,
+ctvrta slozka patri nasledujicimu prvku (pri zapisu je prepsana zapisem nasledujiciho prvku).
+*/
+
+void LoadPacked( const PackedFloat2* const src, Float2* const dest, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		dest[ i ] = Float2( src[ i ].x, src[ i ].y );
+	}
+}
+
+void LoadPacked( const PackedFloat3* const src, Float3* const dest, const std::size_t count ) {
+	if ( count == 0 ) {
+		return;
+	}
+	for ( std::size_t i = 0; i + 1 < count; i++ ) {
+		Simd::Store( &dest[ i ].x, Simd::ClearW( Simd::LoadUnaligned( &src[ i ].x ) ) );
+	}
+	const PackedFloat3& last = src[ count - 1 ];
+	dest[ count - 1 ] = Float3( last.x, last.y, last.z );
+}
+
+void LoadPacked( const PackedFloat4* const src, Float4* const dest, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		Simd::Store( &dest[ i ].x, Simd::LoadUnaligned( &src[ i ].x ) );
+	}
+}
+
+void LoadPacked( const PackedFloat3* const src, Vector* const dest, const std::size_t count, const float w ) {
+	if ( count == 0 ) {
+		return;
+	}
+	const Simd::Vec4 fill = Simd::Replicate( w );
+	for ( std::size_t i = 0; i + 1 < count; i++ ) {
+		// ( x, y, z, ? ) -> ( z, z, w, w ) -> ( x, y, z, w )
+		const Simd::Vec4 v = Simd::LoadUnaligned( &src[ i ].x );
+		Simd::Store( &dest[ i ].x, Simd::Shuffle< 0, 1, 0, 2 >( v, Simd::Shuffle< 2, 2, 0, 0 >( v, fill ) ) );
+	}
+	const PackedFloat3& last = src[ count - 1 ];
+	dest[ count - 1 ] = Vector( last.x, last.y, last.z, w );
+}
+
+void LoadPacked( const PackedFloat4* const src, Vector* const dest, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		Simd::Store( &dest[ i ].x, Simd::LoadUnaligned( &src[ i ].x ) );
+	}
+}
+
+void StorePacked( const Float2* const src, PackedFloat2* const dest, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		dest[ i ] = PackedFloat2( src[ i ].x, src[ i ].y );
+	}
+}
+
+void StorePacked( const Float3* const src, PackedFloat3* const dest, const std::size_t count ) {
+	if ( count == 0 ) {
+		return;
+	}
+	for ( std::size_t i = 0; i + 1 < count; i++ ) {
+		Simd::StoreUnaligned( &dest[ i ].x, Simd::Load( &src[ i ].x ) );
+	}
+	const Float3& last = src[ count - 1 ];
+	dest[ count - 1 ] = PackedFloat3( last.x, last.y, last.z );
+}
+
+void StorePacked( const Float4* const src, PackedFloat4* const dest, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		Simd::StoreUnaligned( &dest[ i ].x, Simd::Load( &src[ i ].x ) );
+	}
+}
+
+void StorePacked( const Vector* const src, PackedFloat3* const dest, const std::size_t count ) {
+	if ( count == 0 ) {
+		return;
+	}
+	for ( std::size_t i = 0; i + 1 < count; i++ ) {
+		Simd::StoreUnaligned( &dest[ i ].x, Simd::Load( &src[ i ].x ) );
+	}
+	const Vector& last = src[ count - 1 ];
+	dest[ count - 1 ] = PackedFloat3( last.x, last.y, last.z );
+}
+
+void StorePacked( const Vector* const src, PackedFloat4* const dest, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		Simd::StoreUnaligned( &dest[ i ].x, Simd::Load( &src[ i ].x ) );
+	}
+}
+
+void LoadPacked( const Half2* const src, Float2* const dest, const std::size_t count ) {
+	float values[ HALF_CHUNK * 2 ];
+	for ( std::size_t begin = 0; begin < count; begin += HALF_CHUNK ) {
+		const std::size_t n = count - begin < HALF_CHUNK ? count - begin : HALF_CHUNK;
+		HalfToFloat( reinterpret_cast< const uint16_t* >( src + begin ), values, n * 2 );
+		for ( std::size_t i = 0; i < n; i++ ) {
+			dest[ begin + i ] = Float2( values[ i * 2 ], values[ i * 2 + 1 ] );
+		}
+	}
+}
+
+void LoadPacked( const Half4* const src, Float4* const dest, const std::size_t count ) {
+	HalfToFloat( reinterpret_cast< const uint16_t* >( src ), reinterpret_cast< float* >( dest ), count * 4 );
+}
+
+void StorePacked( const Float2* const src, Half2* const dest, const std::size_t count ) {
+	float values[ HALF_CHUNK * 2 ];
+	for ( std::size_t begin = 0; begin < count; begin += HALF_CHUNK ) {
+		const std::size_t n = count - begin < HALF_CHUNK ? count - begin : HALF_CHUNK;
+		for ( std::size_t i = 0; i < n; i++ ) {
+			values[ i * 2 ] = src[ begin + i ].x;
+			values[ i * 2 + 1 ] = src[ begin + i ].y;
+		}
+		FloatToHalf( values, reinterpret_cast< uint16_t* >( dest + begin ), n * 2 );
+	}
+}
+
+void StorePacked( const Float4* const src, Half4* const dest, const std::size_t count ) {
+	FloatToHalf( reinterpret_cast< const float* >( src ), reinterpret_cast< uint16_t* >( dest ), count * 4 );
+}
+
+void LoadPacked( const UNorm4x8* const src, Float4* const dest, const std::size_t count ) {
+	UnpackColors( src, dest, count );
+}
+
+void StorePacked( const Float4* const src, UNorm4x8* const dest, const std::size_t count ) {
+	PackColors( src, dest, count );
+}
\ No newline at end of file
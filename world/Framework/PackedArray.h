@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include "Types.h"
+#include "Vector.h"
+
+/*
+Hromadny prevod mezi typy pro ukladani (PackedFloatN, HalfN, UNorm4x8) a zarovnanymi typy pro vypocty (FloatN, Vector).
+LoadPacked() prevadi z ulozenych dat, StorePacked() do nich. Slozka w vektoru nacteneho z PackedFloat3 je parametr w.
+StorePacked() vystup jen postupne zapisuje (nikdy z nej necte), lze tedy zapisovat primo do namapovaneho bufferu.
+Zdrojove a cilove pole se nesmi prekryvat.
+*/
+
+void LoadPacked( const PackedFloat2* const src, Float2* const dest, const std::size_t count );
+void LoadPacked( const PackedFloat3* const src, Float3* const dest, const std::size_t count );
+void LoadPacked( const PackedFloat4* const src, Float4* const dest, const std::size_t count );
+void LoadPacked( const PackedFloat3* const src, Vector* const dest, const std::size_t count, const float w = 0 );
+void LoadPacked( const PackedFloat4* const src, Vector* const dest, const std::size_t count );
+
+void StorePacked( const Float2* const src, PackedFloat2* const dest, const std::size_t count );
+void StorePacked( const Float3* const src, PackedFloat3* const dest, const std::size_t count );
+void StorePacked( const Float4* const src, PackedFloat4* const dest, const std::size_t count );
+void StorePacked( const Vector* const src, PackedFloat3* const dest, const std::size_t count );
+void StorePacked( const Vector* const src, PackedFloat4* const dest, const std::size_t count );
+
+// half, zaokrouhleni a specialni hodnoty viz Half.h
+void LoadPacked( const Half2* const src, Float2* const dest, const std::size_t count );
+void LoadPacked( const Half4* const src, Float4* const dest, const std::size_t count );
+void StorePacked( const Float2* const src, Half2* const dest, const std::size_t count );
+void StorePacked( const Float4* const src, Half4* const dest, const std::size_t count );
+
+// barvy RGBA v rozsahu < 0; 1 >, stejne jako PackColors() a UnpackColors() (VertexPacking.h)
+void LoadPacked( const UNorm4x8* const src, Float4* const dest, const std::size_t count );
+void StorePacked( const Float4* const src, UNorm4x8* const dest, const std::size_t count );
\ No newline at end of file
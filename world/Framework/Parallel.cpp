@@ -0,0 +1,165 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+
+namespace {
+
+	// vlakno prave zpracovava ParallelFor (vlakna poolu vzdy), vnorene ParallelFor se zpracuje primo
+	thread_local bool insideParallelFor = false;
+
+	/*
+	Pool vlaken pro ParallelFor. Pool zpracovava vzdy jen jednu ulohu, casti ulohy si vlakna berou atomickym citacem.
+	Parametry ulohy se meni jen pod zamkem a jen pokud zadne vlakno ulohu nezpracovava (activeWorkers == 0).
+	*/
+	class WorkerPool {
+	public:
+		WorkerPool();
+		~WorkerPool();
+
+		// vraci false, pokud pool zpracovava jinou ulohu
+		bool Run( const std::size_t count, const std::size_t batchSize, const std::function< void( const std::size_t, const std::size_t ) >& function );
+
+		unsigned int GetThreadsCount() const;
+
+	private:
+		void WorkerMain();
+
+		// zpracuje casti ulohy, dokud nejsou vsechny prevzaty
+		void Process();
+
+	private:
+		std::vector< std::thread > workers;
+		std::mutex submitMutex;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		unsigned long generation;
+		unsigned int activeWorkers;
+		bool exit;
+
+		// uloha
+		const std::function< void( const std::size_t, const std::size_t ) >* function;
+		std::size_t count;
+		std::size_t batchSize;
+		std::size_t batchesCount;
+		std::atomic< std::size_t > nextBatch;
+	};
+
+	WorkerPool::WorkerPool() {
+		generation = 0;
+		activeWorkers = 0;
+		exit = false;
+		function = nullptr;
+		count = 0;
+		batchSize = 0;
+		batchesCount = 0;
+		nextBatch.store( 0, std::memory_order_relaxed );
+
+		const unsigned int processors = std::thread::hardware_concurrency();
+		for ( unsigned int i = 1; i < processors; i++ ) {
+			workers.emplace_back( &WorkerPool::WorkerMain, this );
+		}
+	}
+
+	WorkerPool::~WorkerPool() {
+		{
+			std::lock_guard< std::mutex > lock( mutex );
+			exit = true;
+		}
+		wake.notify_all();
+		for ( auto& worker : workers ) {
+			worker.join();
+		}
+	}
+
+	unsigned int WorkerPool::GetThreadsCount() const {
+		return static_cast< unsigned int >( workers.size() ) + 1;
+	}
+
+	void WorkerPool::WorkerMain() {
+		insideParallelFor = true;
+		unsigned long processed = 0;
+		std::unique_lock< std::mutex > lock( mutex );
+		for ( ;; ) {
+			wake.wait( lock, [ & ] { return exit || generation != processed; } );
+			if ( exit ) {
+				return;
+			}
+			processed = generation;
+			activeWorkers += 1;
+			lock.unlock();
+
+			Process();
+
+			lock.lock();
+			activeWorkers -= 1;
+			if ( activeWorkers == 0 ) {
+				done.notify_all();
+			}
+		}
+	}
+
+	void WorkerPool::Process() {
+		for ( ;; ) {
+			const std::size_t batch = nextBatch.fetch_add( 1, std::memory_order_relaxed );
+			if ( batch >= batchesCount ) {
+				return;
+			}
+			const std::size_t begin = batch * batchSize;
+			const std::size_t end = count - begin < batchSize ? count : begin + batchSize;
+			( *function )( begin, end );
+		}
+	}
+
+	bool WorkerPool::Run( const std::size_t countParam, const std::size_t batchSizeParam, const std::function< void( const std::size_t, const std::size_t ) >& functionParam ) {
+		if ( !submitMutex.try_lock() ) {
+			return false;
+		}
+		{
+			// vlakno, ktere se probudilo az po dokonceni predchozi ulohy, muze jeste cist jeji parametry
+			std::unique_lock< std::mutex > lock( mutex );
+			done.wait( lock, [ this ] { return activeWorkers == 0; } );
+			function = &functionParam;
+			count = countParam;
+			batchSize = batchSizeParam;
+			batchesCount = ( countParam + batchSizeParam - 1 ) / batchSizeParam;
+			nextBatch.store( 0, std::memory_order_relaxed );
+			generation += 1;
+		}
+		wake.notify_all();
+
+		insideParallelFor = true;
+		Process();
+		insideParallelFor = false;
+
+		// vsechny casti jsou prevzaty, pockat na dokonceni casti zpracovavanych ostatnimi vlakny
+		{
+			std::unique_lock< std::mutex > lock( mutex );
+			done.wait( lock, [ this ] { return activeWorkers == 0; } );
+		}
+		submitMutex.unlock();
+		return true;
+	}
+
+	WorkerPool& GetWorkerPool() {
+		static WorkerPool pool;
+		return pool;
+	}
+}
+
+void ParallelFor( const std::size_t count, const std::size_t batchSize, const std::function< void( const std::size_t begin, const std::size_t end ) >& function ) {
+	if ( count == 0 ) {
+		return;
+	}
+	const std::size_t batch = batchSize > 0 ? batchSize : 1;
+	if ( count <= batch || insideParallelFor || GetWorkerPool().GetThreadsCount() == 1 || !GetWorkerPool().Run( count, batch, function ) ) {
+		function( 0, count );
+	}
+}
+
+unsigned int GetParallelThreadsCount() {
+	return GetWorkerPool().GetThreadsCount();
+}
\ No newline at end of file
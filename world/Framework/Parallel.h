@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/*
+ParallelFor: zpracuje interval < 0; count ) po castech o velikosti batchSize ve vlaknech sdileneho poolu.
+Funkce je volana pro kazdou cast s intervalem < begin; end ), poradi casti ani vlakno neni urceno.
+Volajici vlakno zpracovava casti take, ParallelFor se vrati az po zpracovani celeho intervalu.
+Interval je zpracovan primo ve volajicim vlakne, pokud obsahuje jen jednu cast, pool prave zpracovava jine volani
+ParallelFor (napr. z jineho vlakna) nebo je ParallelFor volana z funkce zpracovavane poolem.
+Pool je vytvoren pri prvnim volani, pocet vlaken poolu je o jedno mensi nez pocet logickych procesoru.
+*/
+void ParallelFor( const std::size_t count, const std::size_t batchSize, const std::function< void( const std::size_t begin, const std::size_t end ) >& function );
+
+// pocet vlaken, ktera zpracovavaji ParallelFor (vcetne volajiciho vlakna)
+unsigned int GetParallelThreadsCount();
\ No newline at end of file
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cmath>
+#include "Types.h"
+#include "Simd.h"
+#include "Vector.h"
+#include "Matrix.h"
+
+/*
+Kvaternion rotace ( x, y, z, w ), w je realna slozka.
+Poradi skladani rotaci odpovida tride Matrix: a.Mul( b ) je rotace a nasledovana rotaci b.
+*/
+class alignas( 16 ) Quaternion {
+public:
+	float x, y, z, w;
+
+public:
+	// jednotkovy kvaternion (bez rotace)
+	Quaternion();
+	Quaternion( const float x, const float y, const float z, const float w );
+
+	// rotacni matice nesmi obsahovat meritko
+	explicit Quaternion( const Matrix& rotation );
+
+	// pretypovani z a na Float4
+	explicit Quaternion( const Float4& src );
+	operator Float4() const;
+	void Store( Float4& dest ) const;
+
+	// rotacni matice
+	void StoreMatrix( Matrix& dest ) const;
+
+	// operace
+	void Identity();
+	void Mul( const Quaternion& q );
+	void Conjugate();
+	void Inverse();
+	void Normalize();
+	float Dot( const Quaternion& q ) const;
+	float GetLength() const;
+
+	// rotace (stejne parametry jako odpovidajici metody tridy Matrix)
+	void Rotate( const float roll, const float pitch, const float yaw );
+	void RotateX( const float rad );
+	void RotateY( const float rad );
+	void RotateZ( const float rad );
+	void RotateAxis( const Vector& axes, const float rad );
+
+	/*
+	Interpolace mezi normalizovanymi kvaterniony, vysledek je normalizovany.
+	Interpoluje se vzdy kratsi cestou. Nlerp nema konstantni uhlovou rychlost, je ale vyrazne rychlejsi nez Slerp.
+	*/
+	static Quaternion Nlerp( const Quaternion& a, const Quaternion& b, const float t );
+	static Quaternion Slerp( const Quaternion& a, const Quaternion& b, const float t );
+};
+
+inline Quaternion::Quaternion() {
+	Identity();
+}
+
+inline Quaternion::Quaternion( const float x, const float y, const float z, const float w ) {
+	this->x = x;
+	this->y = y;
+	this->z = z;
+	this->w = w;
+}
+
+inline Quaternion::Quaternion( const Matrix& r ) {
+	// vychazi se z nejvetsi slozky, aby nedochazelo ke ztrate presnosti
+	const float trace = r.m00 + r.m11 + r.m22;
+	if ( trace > 0 ) {
+		const float s = std::sqrt( trace + 1.0f ) * 2.0f;
+		x = ( r.m12 - r.m21 ) / s;
+		y = ( r.m20 - r.m02 ) / s;
+		z = ( r.m01 - r.m10 ) / s;
+		w = 0.25f * s;
+	} else if ( r.m00 > r.m11 && r.m00 > r.m22 ) {
+		const float s = std::sqrt( 1.0f + r.m00 - r.m11 - r.m22 ) * 2.0f;
+		x = 0.25f * s;
+		y = ( r.m01 + r.m10 ) / s;
+		z = ( r.m20 + r.m02 ) / s;
+		w = ( r.m12 - r.m21 ) / s;
+	} else if ( r.m11 > r.m22 ) {
+		const float s = std::sqrt( 1.0f + r.m11 - r.m00 - r.m22 ) * 2.0f;
+		x = ( r.m01 + r.m10 ) / s;
+		y = 0.25f * s;
+		z = ( r.m12 + r.m21 ) / s;
+		w = ( r.m20 - r.m02 ) / s;
+	} else {
+		const float s = std::sqrt( 1.0f + r.m22 - r.m00 - r.m11 ) * 2.0f;
+		x = ( r.m20 + r.m02 ) / s;
+		y = ( r.m12 + r.m21 ) / s;
+		z = 0.25f * s;
+		w = ( r.m01 - r.m10 ) / s;
+	}
+}
+
+inline Quaternion::Quaternion( const Float4& src ) {
+	x = src.x;
+	y = src.y;
+	z = src.z;
+	w = src.w;
+}
+
+inline Quaternion::operator Float4() const {
+	return Float4( x, y, z, w );
+}
+
+inline void Quaternion::Store( Float4& dest ) const {
+	dest.x = x;
+	dest.y = y;
+	dest.z = z;
+	dest.w = w;
+}
+
+inline void Quaternion::StoreMatrix( Matrix& dest ) const {
+	Simd::Vec4 r0, r1, r2;
+	Simd::QuaternionToMatrix( Simd::Load( &x ), r0, r1, r2 );
+	Simd::Store( dest.m[ 0 ], r0 );
+	Simd::Store( dest.m[ 1 ], r1 );
+	Simd::Store( dest.m[ 2 ], r2 );
+	Simd::Store( dest.m[ 3 ], Simd::Set( 0, 0, 0, 1.0f ) );
+}
+
+inline void Quaternion::Identity() {
+	x = y = z = 0;
+	w = 1.0f;
+}
+
+inline void Quaternion::Mul( const Quaternion& q ) {
+	Simd::Store( &x, Simd::QuaternionMultiply( Simd::Load( &q.x ), Simd::Load( &x ) ) );
+}
+
+inline void Quaternion::Conjugate() {
+	Simd::Store( &x, Simd::Mul( Simd::Load( &x ), Simd::Set( -1.0f, -1.0f, -1.0f, 1.0f ) ) );
+}
+
+inline void Quaternion::Inverse() {
+	const Simd::Vec4 q = Simd::Load( &x );
+	Simd::Store( &x, Simd::Div( Simd::Mul( q, Simd::Set( -1.0f, -1.0f, -1.0f, 1.0f ) ), Simd::Dot4( q, q ) ) );
+}
+
+inline void Quaternion::Normalize() {
+	const Simd::Vec4 q = Simd::Load( &x );
+	Simd::Store( &x, Simd::Div( q, Simd::Sqrt( Simd::Dot4( q, q ) ) ) );
+}
+
+inline float Quaternion::Dot( const Quaternion& q ) const {
+	return Simd::GetX( Simd::Dot4( Simd::Load( &x ), Simd::Load( &q.x ) ) );
+}
+
+inline float Quaternion::GetLength() const {
+	return std::sqrt( Dot( *this ) );
+}
+
+// rotace postupne kolem os z (roll), x (pitch) a y (yaw)
+inline void Quaternion::Rotate( const float roll, const float pitch, const float yaw ) {
+	const float sp = std::sin( pitch * 0.5f );
+	const float cp = std::cos( pitch * 0.5f );
+	const float sy = std::sin( yaw * 0.5f );
+	const float cy = std::cos( yaw * 0.5f );
+	const float sr = std::sin( roll * 0.5f );
+	const float cr = std::cos( roll * 0.5f );
+	Mul( Quaternion(
+		cr * sp * cy + sr * cp * sy,
+		cr * cp * sy - sr * sp * cy,
+		sr * cp * cy - cr * sp * sy,
+		cr * cp * cy + sr * sp * sy
+	) );
+}
+
+inline void Quaternion::RotateX( const float rad ) {
+	Mul( Quaternion( std::sin( rad * 0.5f ), 0, 0, std::cos( rad * 0.5f ) ) );
+}
+
+inline void Quaternion::RotateY( const float rad ) {
+	Mul( Quaternion( 0, std::sin( rad * 0.5f ), 0, std::cos( rad * 0.5f ) ) );
+}
+
+inline void Quaternion::RotateZ( const float rad ) {
+	Mul( Quaternion( 0, 0, std::sin( rad * 0.5f ), std::cos( rad * 0.5f ) ) );
+}
+
+inline void Quaternion::RotateAxis( const Vector& axes, const float rad ) {
+	Vector n = axes;
+	n.Normalize();
+	const float sin = std::sin( rad * 0.5f );
+	Mul( Quaternion( n.x * sin, n.y * sin, n.z * sin, std::cos( rad * 0.5f ) ) );
+}
+
+inline Quaternion Quaternion::Nlerp( const Quaternion& a, const Quaternion& b, const float t ) {
+	const Simd::Vec4 qa = Simd::Load( &a.x );
+	Simd::Vec4 qb = Simd::Load( &b.x );
+	if ( Simd::GetX( Simd::Dot4( qa, qb ) ) < 0 ) {
+		qb = Simd::Mul( qb, Simd::Replicate( -1.0f ) );
+	}
+	const Simd::Vec4 q = Simd::MulAdd( Simd::Sub( qb, qa ), Simd::Replicate( t ), qa );
+	Quaternion result;
+	Simd::Store( &result.x, Simd::Div( q, Simd::Sqrt( Simd::Dot4( q, q ) ) ) );
+	return result;
+}
+
+inline Quaternion Quaternion::Slerp( const Quaternion& a, const Quaternion& b, const float t ) {
+	const Simd::Vec4 qa = Simd::Load( &a.x );
+	Simd::Vec4 qb = Simd::Load( &b.x );
+	float cos = Simd::GetX( Simd::Dot4( qa, qb ) );
+	if ( cos < 0 ) {
+		qb = Simd::Mul( qb, Simd::Replicate( -1.0f ) );
+		cos = -cos;
+	}
+
+	// pro temer shodne kvaterniony je sin( angle ) blizky nule, rozdil proti Nlerp je zanedbatelny
+	if ( cos > 0.9995f ) {
+		Quaternion nearest;
+		Simd::Store( &nearest.x, qb );
+		return Nlerp( a, nearest, t );
+	}
+	// uhel z |b - a| a |b + a| (acos a 1 - cos * cos ztraci blizko cos = 1 presnost odectenim)
+	const Simd::Vec4 difference = Simd::Sub( qb, qa );
+	const Simd::Vec4 sum = Simd::Add( qb, qa );
+	const float angle = 2.0f * std::atan2( std::sqrt( Simd::GetX( Simd::Dot4( difference, difference ) ) ), std::sqrt( Simd::GetX( Simd::Dot4( sum, sum ) ) ) );
+	const float invSin = 1.0f / std::sin( angle );
+	const float sa = std::sin( ( 1.0f - t ) * angle ) * invSin;
+	const float sb = std::sin( t * angle ) * invSin;
+	Quaternion result;
+	Simd::Store( &result.x, Simd::MulAdd( qa, Simd::Replicate( sa ), Simd::Mul( qb, Simd::Replicate( sb ) ) ) );
+	return result;
+}
+
+inline void Vector::Rotate( const Quaternion& q ) {
+	Simd::Store( &x, Simd::QuaternionRotate( Simd::Load( &x ), Simd::Load( &q.x ) ) );
+}
\ No newline at end of file
@@ -0,0 +1,542 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+/*
+Simd: 4 slozkove vektorove operace pro tridy Vector a Matrix.
+Instrukcni sada se vybira pri prekladu podle nastaveni prekladace (/arch, -m...):
+SIMD_AVX2 (AVX2 + FMA), SIMD_SSE4 (SSE4.1), SIMD_SSE2, nebo SIMD_SCALAR pro ostatni platformy.
+Definici SIMD_FORCE_SCALAR lze vynutit skalarni implementaci (napr. pro porovnani vysledku).
+Vsechny implementace maji shodne rozhrani, vysledky se mohou lisit jen zaokrouhlenim (FMA).
+*/
+
+#if defined( SIMD_FORCE_SCALAR )
+#define SIMD_SCALAR
+#elif defined( __AVX2__ )
+#define SIMD_AVX2
+#define SIMD_SSE4
+#define SIMD_SSE2
+#elif defined( __SSE4_1__ ) || defined( __AVX__ )
+#define SIMD_SSE4
+#define SIMD_SSE2
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define SIMD_SSE2
+#else
+#define SIMD_SCALAR
+#endif
+
+// MSVC s /arch:AVX2 generuje FMA instrukce, GCC a Clang definuji __FMA__ (-mfma, -march=haswell)
+#if defined( SIMD_AVX2 ) && ( defined( __FMA__ ) || defined( _MSC_VER ) )
+#define SIMD_FMA
+#endif
+
+// prevod float <-> half (F16C), MSVC ho s /arch:AVX2 povoluje, GCC a Clang definuji __F16C__ (-mf16c, -march=haswell)
+#if defined( SIMD_AVX2 ) && ( defined( __F16C__ ) || defined( _MSC_VER ) )
+#define SIMD_F16C
+#endif
+
+#if defined( SIMD_AVX2 )
+#include <immintrin.h>
+#elif defined( SIMD_SSE4 )
+#include <smmintrin.h>
+#elif defined( SIMD_SSE2 )
+#include <emmintrin.h>
+#endif
+
+namespace Simd {
+
+#ifdef SIMD_SSE2
+
+	using Vec4 = __m128;
+
+	// Load a Store vyzaduji adresu zarovnanou na 16 bajtu
+	inline Vec4 Load( const float* const src ) {
+		return _mm_load_ps( src );
+	}
+
+	inline Vec4 LoadUnaligned( const float* const src ) {
+		return _mm_loadu_ps( src );
+	}
+
+	inline void Store( float* const dest, const Vec4 v ) {
+		_mm_store_ps( dest, v );
+	}
+
+	inline void StoreUnaligned( float* const dest, const Vec4 v ) {
+		_mm_storeu_ps( dest, v );
+	}
+
+	// zapis mimo cache (napr. do namapovaneho bufferu GPU), adresa musi byt zarovnana na 16 bajtu
+	// pred predanim dat jinemu vlaknu nebo GPU je nutne zavolat StreamFence()
+	inline void StoreStream( float* const dest, const Vec4 v ) {
+		_mm_stream_ps( dest, v );
+	}
+
+	inline void StreamFence() {
+		_mm_sfence();
+	}
+
+	inline Vec4 Set( const float x, const float y, const float z, const float w ) {
+		return _mm_setr_ps( x, y, z, w );
+	}
+
+	inline Vec4 Replicate( const float value ) {
+		return _mm_set1_ps( value );
+	}
+
+	inline Vec4 Zero() {
+		return _mm_setzero_ps();
+	}
+
+	inline float GetX( const Vec4 v ) {
+		return _mm_cvtss_f32( v );
+	}
+
+	// vysledek ( a[ X ], a[ Y ], b[ Z ], b[ W ] )
+	template < int X, int Y, int Z, int W >
+	inline Vec4 Shuffle( const Vec4 a, const Vec4 b ) {
+		return _mm_shuffle_ps( a, b, _MM_SHUFFLE( W, Z, Y, X ) );
+	}
+
+	inline Vec4 Add( const Vec4 a, const Vec4 b ) {
+		return _mm_add_ps( a, b );
+	}
+
+	inline Vec4 Sub( const Vec4 a, const Vec4 b ) {
+		return _mm_sub_ps( a, b );
+	}
+
+	inline Vec4 Mul( const Vec4 a, const Vec4 b ) {
+		return _mm_mul_ps( a, b );
+	}
+
+	inline Vec4 Div( const Vec4 a, const Vec4 b ) {
+		return _mm_div_ps( a, b );
+	}
+
+	inline Vec4 Min( const Vec4 a, const Vec4 b ) {
+		return _mm_min_ps( a, b );
+	}
+
+	inline Vec4 Max( const Vec4 a, const Vec4 b ) {
+		return _mm_max_ps( a, b );
+	}
+
+	inline Vec4 Sqrt( const Vec4 v ) {
+		return _mm_sqrt_ps( v );
+	}
+
+	// zaokrouhleni k nejblizsimu celemu cislu (pri shode k sudemu), |v| < 2^31
+	inline Vec4 Round( const Vec4 v ) {
+	#ifdef SIMD_SSE4
+		return _mm_round_ps( v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+	#else
+		return _mm_cvtepi32_ps( _mm_cvtps_epi32( v ) );
+	#endif
+	}
+
+	// a * b + c
+	inline Vec4 MulAdd( const Vec4 a, const Vec4 b, const Vec4 c ) {
+	#ifdef SIMD_FMA
+		return _mm_fmadd_ps( a, b, c );
+	#else
+		return _mm_add_ps( _mm_mul_ps( a, b ), c );
+	#endif
+	}
+
+	// c - a * b
+	inline Vec4 NegMulAdd( const Vec4 a, const Vec4 b, const Vec4 c ) {
+	#ifdef SIMD_FMA
+		return _mm_fnmadd_ps( a, b, c );
+	#else
+		return _mm_sub_ps( c, _mm_mul_ps( a, b ) );
+	#endif
+	}
+
+	// vynuluje slozku w
+	inline Vec4 ClearW( const Vec4 v ) {
+	#ifdef SIMD_SSE4
+		return _mm_blend_ps( v, _mm_setzero_ps(), 0x08 );
+	#else
+		return _mm_and_ps( v, _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) ) );
+	#endif
+	}
+
+	// bit i vysledku je 1, pokud a[ i ] < b[ i ]
+	inline int LessMask( const Vec4 a, const Vec4 b ) {
+		return _mm_movemask_ps( _mm_cmplt_ps( a, b ) );
+	}
+
+#else // SIMD_SCALAR
+
+	struct alignas( 16 ) Vec4 {
+		float v[ 4 ];
+	};
+
+	inline Vec4 Load( const float* const src ) {
+		return Vec4{ { src[ 0 ], src[ 1 ], src[ 2 ], src[ 3 ] } };
+	}
+
+	inline Vec4 LoadUnaligned( const float* const src ) {
+		return Load( src );
+	}
+
+	inline void Store( float* const dest, const Vec4 v ) {
+		dest[ 0 ] = v.v[ 0 ];
+		dest[ 1 ] = v.v[ 1 ];
+		dest[ 2 ] = v.v[ 2 ];
+		dest[ 3 ] = v.v[ 3 ];
+	}
+
+	inline void StoreUnaligned( float* const dest, const Vec4 v ) {
+		Store( dest, v );
+	}
+
+	inline void StoreStream( float* const dest, const Vec4 v ) {
+		Store( dest, v );
+	}
+
+	inline void StreamFence() {
+	}
+
+	inline Vec4 Set( const float x, const float y, const float z, const float w ) {
+		return Vec4{ { x, y, z, w } };
+	}
+
+	inline Vec4 Replicate( const float value ) {
+		return Vec4{ { value, value, value, value } };
+	}
+
+	inline Vec4 Zero() {
+		return Vec4{ { 0, 0, 0, 0 } };
+	}
+
+	inline float GetX( const Vec4 v ) {
+		return v.v[ 0 ];
+	}
+
+	template < int X, int Y, int Z, int W >
+	inline Vec4 Shuffle( const Vec4 a, const Vec4 b ) {
+		return Vec4{ { a.v[ X ], a.v[ Y ], b.v[ Z ], b.v[ W ] } };
+	}
+
+	inline Vec4 Add( const Vec4 a, const Vec4 b ) {
+		return Vec4{ { a.v[ 0 ] + b.v[ 0 ], a.v[ 1 ] + b.v[ 1 ], a.v[ 2 ] + b.v[ 2 ], a.v[ 3 ] + b.v[ 3 ] } };
+	}
+
+	inline Vec4 Sub( const Vec4 a, const Vec4 b ) {
+		return Vec4{ { a.v[ 0 ] - b.v[ 0 ], a.v[ 1 ] - b.v[ 1 ], a.v[ 2 ] - b.v[ 2 ], a.v[ 3 ] - b.v[ 3 ] } };
+	}
+
+	inline Vec4 Mul( const Vec4 a, const Vec4 b ) {
+		return Vec4{ { a.v[ 0 ] * b.v[ 0 ], a.v[ 1 ] * b.v[ 1 ], a.v[ 2 ] * b.v[ 2 ], a.v[ 3 ] * b.v[ 3 ] } };
+	}
+
+	inline Vec4 Div( const Vec4 a, const Vec4 b ) {
+		return Vec4{ { a.v[ 0 ] / b.v[ 0 ], a.v[ 1 ] / b.v[ 1 ], a.v[ 2 ] / b.v[ 2 ], a.v[ 3 ] / b.v[ 3 ] } };
+	}
+
+	inline Vec4 Min( const Vec4 a, const Vec4 b ) {
+		return Vec4{ {
+			a.v[ 0 ] < b.v[ 0 ] ? a.v[ 0 ] : b.v[ 0 ],
+			a.v[ 1 ] < b.v[ 1 ] ? a.v[ 1 ] : b.v[ 1 ],
+			a.v[ 2 ] < b.v[ 2 ] ? a.v[ 2 ] : b.v[ 2 ],
+			a.v[ 3 ] < b.v[ 3 ] ? a.v[ 3 ] : b.v[ 3 ]
+		} };
+	}
+
+	inline Vec4 Max( const Vec4 a, const Vec4 b ) {
+		return Vec4{ {
+			a.v[ 0 ] > b.v[ 0 ] ? a.v[ 0 ] : b.v[ 0 ],
+			a.v[ 1 ] > b.v[ 1 ] ? a.v[ 1 ] : b.v[ 1 ],
+			a.v[ 2 ] > b.v[ 2 ] ? a.v[ 2 ] : b.v[ 2 ],
+			a.v[ 3 ] > b.v[ 3 ] ? a.v[ 3 ] : b.v[ 3 ]
+		} };
+	}
+
+	inline Vec4 Sqrt( const Vec4 v ) {
+		return Vec4{ { std::sqrt( v.v[ 0 ] ), std::sqrt( v.v[ 1 ] ), std::sqrt( v.v[ 2 ] ), std::sqrt( v.v[ 3 ] ) } };
+	}
+
+	inline Vec4 Round( const Vec4 v ) {
+		return Vec4{ { std::nearbyint( v.v[ 0 ] ), std::nearbyint( v.v[ 1 ] ), std::nearbyint( v.v[ 2 ] ), std::nearbyint( v.v[ 3 ] ) } };
+	}
+
+	inline Vec4 MulAdd( const Vec4 a, const Vec4 b, const Vec4 c ) {
+		return Add( Mul( a, b ), c );
+	}
+
+	inline Vec4 NegMulAdd( const Vec4 a, const Vec4 b, const Vec4 c ) {
+		return Sub( c, Mul( a, b ) );
+	}
+
+	inline Vec4 ClearW( const Vec4 v ) {
+		return Vec4{ { v.v[ 0 ], v.v[ 1 ], v.v[ 2 ], 0 } };
+	}
+
+	inline int LessMask( const Vec4 a, const Vec4 b ) {
+		int mask = 0;
+		for ( int i = 0; i < 4; i++ ) {
+			mask |= ( a.v[ i ] < b.v[ i ] ? 1 : 0 ) << i;
+		}
+		return mask;
+	}
+
+#endif // SIMD_SSE2
+
+	// operace spolecne pro vsechny implementace
+
+	// vysledek ( v[ X ], v[ Y ], v[ Z ], v[ W ] )
+	template < int X, int Y, int Z, int W >
+	inline Vec4 Swizzle( const Vec4 v ) {
+		return Shuffle< X, Y, Z, W >( v, v );
+	}
+
+	inline Vec4 SplatX( const Vec4 v ) {
+		return Swizzle< 0, 0, 0, 0 >( v );
+	}
+
+	inline Vec4 SplatY( const Vec4 v ) {
+		return Swizzle< 1, 1, 1, 1 >( v );
+	}
+
+	inline Vec4 SplatZ( const Vec4 v ) {
+		return Swizzle< 2, 2, 2, 2 >( v );
+	}
+
+	inline Vec4 SplatW( const Vec4 v ) {
+		return Swizzle< 3, 3, 3, 3 >( v );
+	}
+
+	// skalarni soucin xyz slozek, vysledek je ve vsech slozkach
+	// instrukce dpps (SSE4.1) ma vetsi latenci nez shuffle + add, proto se nepouziva
+	inline Vec4 Dot3( const Vec4 a, const Vec4 b ) {
+		const Vec4 product = Mul( a, b );
+		return Add( Add( SplatX( product ), SplatY( product ) ), SplatZ( product ) );
+	}
+
+	// skalarni soucin vsech slozek, vysledek je ve vsech slozkach
+	inline Vec4 Dot4( const Vec4 a, const Vec4 b ) {
+		const Vec4 product = Mul( a, b );
+		const Vec4 sum = Add( product, Swizzle< 1, 0, 3, 2 >( product ) );
+		return Add( sum, Swizzle< 2, 3, 0, 1 >( sum ) );
+	}
+
+	// vektorovy soucin xyz slozek, w = 0
+	inline Vec4 Cross3( const Vec4 a, const Vec4 b ) {
+		const Vec4 result = NegMulAdd(
+			Swizzle< 2, 0, 1, 3 >( a ),
+			Swizzle< 1, 2, 0, 3 >( b ),
+			Mul( Swizzle< 1, 2, 0, 3 >( a ), Swizzle< 2, 0, 1, 3 >( b ) )
+		);
+		return ClearW( result );
+	}
+
+	/*
+	Normalizuje vektor delkou xyz slozek (deli i slozku w).
+	Nulovy vektor zustane nulovy, vektor s nekonecnou delkou vraci NaN (stejne jako XMVector3Normalize).
+	*/
+	inline Vec4 Normalize3( const Vec4 v ) {
+		const Vec4 lengthSq = Dot3( v, v );
+		const float length = std::sqrt( GetX( lengthSq ) );
+		if ( length == 0 ) {
+			return Zero();
+		}
+		if ( GetX( lengthSq ) == std::numeric_limits< float >::infinity() ) {
+			return Replicate( std::numeric_limits< float >::quiet_NaN() );
+		}
+		return Div( v, Replicate( length ) );
+	}
+
+	// transpozice matice 4x4 ulozene v radcich r0 - r3
+	inline void Transpose( Vec4& r0, Vec4& r1, Vec4& r2, Vec4& r3 ) {
+		const Vec4 t0 = Shuffle< 0, 1, 0, 1 >( r0, r1 );
+		const Vec4 t1 = Shuffle< 2, 3, 2, 3 >( r0, r1 );
+		const Vec4 t2 = Shuffle< 0, 1, 0, 1 >( r2, r3 );
+		const Vec4 t3 = Shuffle< 2, 3, 2, 3 >( r2, r3 );
+		r0 = Shuffle< 0, 2, 0, 2 >( t0, t2 );
+		r1 = Shuffle< 1, 3, 1, 3 >( t0, t2 );
+		r2 = Shuffle< 0, 2, 0, 2 >( t1, t3 );
+		r3 = Shuffle< 1, 3, 1, 3 >( t1, t3 );
+	}
+
+	/*
+	Operace s maticemi 4x4 ulozenymi po radcich (16 float zarovnanych na 16 bajtu).
+	Vysledek muze byt ulozen do nektereho ze vstupu.
+	*/
+
+	// result = a * b
+	inline void MatrixMultiply( const float* const a, const float* const b, float* const result ) {
+	#ifdef SIMD_AVX2
+		// dva radky najednou, radky jsou nacteny po 16 bajtech (32 bajtove cteni by pri predchozim zapisu po radcich neproslo store forwardingem)
+		const __m256 b0 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b ) );
+		const __m256 b1 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b + 4 ) );
+		const __m256 b2 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b + 8 ) );
+		const __m256 b3 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( b + 12 ) );
+		const __m256 a01 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( a ) ), _mm_load_ps( a + 4 ), 1 );
+		const __m256 a23 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_load_ps( a + 8 ) ), _mm_load_ps( a + 12 ), 1 );
+		__m256 r01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x00 ), b0 );
+		__m256 r23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x00 ), b0 );
+		__m256 s01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xaa ), b2 );
+		__m256 s23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xaa ), b2 );
+	#ifdef SIMD_FMA
+		r01 = _mm256_fmadd_ps( _mm256_shuffle_ps( a01, a01, 0x55 ), b1, r01 );
+		r23 = _mm256_fmadd_ps( _mm256_shuffle_ps( a23, a23, 0x55 ), b1, r23 );
+		s01 = _mm256_fmadd_ps( _mm256_shuffle_ps( a01, a01, 0xff ), b3, s01 );
+		s23 = _mm256_fmadd_ps( _mm256_shuffle_ps( a23, a23, 0xff ), b3, s23 );
+	#else
+		r01 = _mm256_add_ps( _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x55 ), b1 ), r01 );
+		r23 = _mm256_add_ps( _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x55 ), b1 ), r23 );
+		s01 = _mm256_add_ps( _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xff ), b3 ), s01 );
+		s23 = _mm256_add_ps( _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xff ), b3 ), s23 );
+	#endif
+		_mm256_storeu_ps( result, _mm256_add_ps( r01, s01 ) );
+		_mm256_storeu_ps( result + 8, _mm256_add_ps( r23, s23 ) );
+	#else
+		const Vec4 b0 = Load( b );
+		const Vec4 b1 = Load( b + 4 );
+		const Vec4 b2 = Load( b + 8 );
+		const Vec4 b3 = Load( b + 12 );
+		for ( int i = 0; i < 4; i++ ) {
+			const Vec4 row = Load( a + i * 4 );
+			const Vec4 r = MulAdd( SplatY( row ), b1, Mul( SplatX( row ), b0 ) );
+			const Vec4 s = MulAdd( SplatW( row ), b3, Mul( SplatZ( row ), b2 ) );
+			Store( result + i * 4, Add( r, s ) );
+		}
+	#endif
+	}
+
+	// result = transpose( m )
+	inline void MatrixTranspose( const float* const m, float* const result ) {
+		Vec4 r0 = Load( m );
+		Vec4 r1 = Load( m + 4 );
+		Vec4 r2 = Load( m + 8 );
+		Vec4 r3 = Load( m + 12 );
+		Transpose( r0, r1, r2, r3 );
+		Store( result, r0 );
+		Store( result + 4, r1 );
+		Store( result + 8, r2 );
+		Store( result + 12, r3 );
+	}
+
+	namespace Internal {
+
+		// matice 2x2 ulozena v jednom vektoru ( m00, m01, m10, m11 )
+
+		// a * b
+		inline Vec4 Matrix2Mul( const Vec4 a, const Vec4 b ) {
+			return MulAdd( a, Swizzle< 0, 3, 0, 3 >( b ), Mul( Swizzle< 1, 0, 3, 2 >( a ), Swizzle< 2, 1, 2, 1 >( b ) ) );
+		}
+
+		// adj( a ) * b
+		inline Vec4 Matrix2AdjMul( const Vec4 a, const Vec4 b ) {
+			return Sub( Mul( Swizzle< 3, 3, 0, 0 >( a ), b ), Mul( Swizzle< 1, 1, 2, 2 >( a ), Swizzle< 2, 3, 0, 1 >( b ) ) );
+		}
+
+		// a * adj( b )
+		inline Vec4 Matrix2MulAdj( const Vec4 a, const Vec4 b ) {
+			return Sub( Mul( a, Swizzle< 3, 0, 3, 0 >( b ) ), Mul( Swizzle< 1, 0, 3, 2 >( a ), Swizzle< 2, 1, 2, 1 >( b ) ) );
+		}
+	}
+
+	/*
+	result = inverse( m ), inverze blokovou metodou (4 bloky 2x2).
+	Pro singularni matici obsahuje vysledek nekonecna nebo NaN (stejne jako XMMatrixInverse).
+	*/
+	inline void MatrixInverse( const float* const m, float* const result ) {
+		using namespace Internal;
+
+		const Vec4 r0 = Load( m );
+		const Vec4 r1 = Load( m + 4 );
+		const Vec4 r2 = Load( m + 8 );
+		const Vec4 r3 = Load( m + 12 );
+
+		// bloky | A B |
+		//       | C D |
+		const Vec4 a = Shuffle< 0, 1, 0, 1 >( r0, r1 );
+		const Vec4 b = Shuffle< 2, 3, 2, 3 >( r0, r1 );
+		const Vec4 c = Shuffle< 0, 1, 0, 1 >( r2, r3 );
+		const Vec4 d = Shuffle< 2, 3, 2, 3 >( r2, r3 );
+
+		// determinanty bloku ( |A|, |B|, |C|, |D| )
+		const Vec4 detSub = Sub(
+			Mul( Shuffle< 0, 2, 0, 2 >( r0, r2 ), Shuffle< 1, 3, 1, 3 >( r1, r3 ) ),
+			Mul( Shuffle< 1, 3, 1, 3 >( r0, r2 ), Shuffle< 0, 2, 0, 2 >( r1, r3 ) )
+		);
+		const Vec4 detA = SplatX( detSub );
+		const Vec4 detB = SplatY( detSub );
+		const Vec4 detC = SplatZ( detSub );
+		const Vec4 detD = SplatW( detSub );
+
+		const Vec4 dc = Matrix2AdjMul( d, c );
+		const Vec4 ab = Matrix2AdjMul( a, b );
+
+		// inverse( m ) = 1 / |M| * | X Y |
+		//                          | Z W |
+		Vec4 x = Sub( Mul( detD, a ), Matrix2Mul( b, dc ) );
+		Vec4 w = Sub( Mul( detA, d ), Matrix2Mul( c, ab ) );
+		Vec4 y = Sub( Mul( detB, c ), Matrix2MulAdj( d, ab ) );
+		Vec4 z = Sub( Mul( detC, b ), Matrix2MulAdj( a, dc ) );
+
+		// |M| = |A| |D| + |B| |C| - tr( adj( A ) B adj( D ) C )
+		Vec4 det = MulAdd( detB, detC, Mul( detA, detD ) );
+		det = Sub( det, Dot4( ab, Swizzle< 0, 2, 1, 3 >( dc ) ) );
+
+		const Vec4 reciprocal = Div( Set( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+		x = Mul( x, reciprocal );
+		y = Mul( y, reciprocal );
+		z = Mul( z, reciprocal );
+		w = Mul( w, reciprocal );
+
+		// adjungovane bloky zpet do radku
+		Store( result, Shuffle< 3, 1, 3, 1 >( x, y ) );
+		Store( result + 4, Shuffle< 2, 0, 2, 0 >( x, y ) );
+		Store( result + 8, Shuffle< 3, 1, 3, 1 >( z, w ) );
+		Store( result + 12, Shuffle< 2, 0, 2, 0 >( z, w ) );
+	}
+
+	// transformace bodu ( v.x, v.y, v.z, 1 ) matici m, vysledek neni delen slozkou w
+	inline Vec4 TransformPoint( const Vec4 v, const float* const m ) {
+		Vec4 result = MulAdd( SplatZ( v ), Load( m + 8 ), Load( m + 12 ) );
+		result = MulAdd( SplatY( v ), Load( m + 4 ), result );
+		return MulAdd( SplatX( v ), Load( m ), result );
+	}
+
+	// transformace smeru ( v.x, v.y, v.z, 0 ) matici m
+	inline Vec4 TransformNormal( const Vec4 v, const float* const m ) {
+		Vec4 result = Mul( SplatZ( v ), Load( m + 8 ) );
+		result = MulAdd( SplatY( v ), Load( m + 4 ), result );
+		return MulAdd( SplatX( v ), Load( m ), result );
+	}
+
+	/*
+	Operace s kvaterniony ( x, y, z, w ), w je realna slozka.
+	*/
+
+	// Hamiltonuv soucin a * b (rotace b nasledovana rotaci a)
+	inline Vec4 QuaternionMultiply( const Vec4 a, const Vec4 b ) {
+		Vec4 result = Mul( SplatW( a ), b );
+		result = MulAdd( SplatX( a ), Mul( Swizzle< 3, 2, 1, 0 >( b ), Set( 1.0f, -1.0f, 1.0f, -1.0f ) ), result );
+		result = MulAdd( SplatY( a ), Mul( Swizzle< 2, 3, 0, 1 >( b ), Set( 1.0f, 1.0f, -1.0f, -1.0f ) ), result );
+		return MulAdd( SplatZ( a ), Mul( Swizzle< 1, 0, 3, 2 >( b ), Set( -1.0f, 1.0f, 1.0f, -1.0f ) ), result );
+	}
+
+	// radky rotacni matice normalizovaneho kvaternionu q (slozky w radku jsou nulove)
+	inline void QuaternionToMatrix( const Vec4 q, Vec4& r0, Vec4& r1, Vec4& r2 ) {
+		const Vec4 q2 = Add( q, q );
+		r0 = MulAdd( Swizzle< 1, 0, 0, 3 >( q2 ), Mul( Swizzle< 1, 1, 2, 3 >( q ), Set( -1.0f, 1.0f, 1.0f, 0 ) ), Set( 1.0f, 0, 0, 0 ) );
+		r0 = MulAdd( Swizzle< 2, 2, 1, 3 >( q2 ), Mul( Swizzle< 2, 3, 3, 3 >( q ), Set( -1.0f, 1.0f, -1.0f, 0 ) ), r0 );
+		r1 = MulAdd( Swizzle< 0, 0, 1, 3 >( q2 ), Mul( Swizzle< 1, 0, 2, 3 >( q ), Set( 1.0f, -1.0f, 1.0f, 0 ) ), Set( 0, 1.0f, 0, 0 ) );
+		r1 = MulAdd( Swizzle< 2, 2, 0, 3 >( q2 ), Mul( Swizzle< 3, 2, 3, 3 >( q ), Set( -1.0f, -1.0f, 1.0f, 0 ) ), r1 );
+		r2 = MulAdd( Swizzle< 0, 1, 0, 3 >( q2 ), Mul( Swizzle< 2, 2, 0, 3 >( q ), Set( 1.0f, 1.0f, -1.0f, 0 ) ), Set( 0, 0, 1.0f, 0 ) );
+		r2 = MulAdd( Swizzle< 1, 0, 1, 3 >( q2 ), Mul( Swizzle< 3, 3, 1, 3 >( q ), Set( 1.0f, -1.0f, -1.0f, 0 ) ), r2 );
+	}
+
+	// rotace xyz slozek v normalizovanym kvaternionem q (q * v * q'), w = 0
+	// v + w * t + cross( q, t ), kde t = 2 * cross( q, v )
+	inline Vec4 QuaternionRotate( const Vec4 v, const Vec4 q ) {
+		const Vec4 t = Cross3( q, Add( v, v ) );
+		return ClearW( Add( MulAdd( SplatW( q ), t, v ), Cross3( q, t ) ) );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include <cassert>
+#include "Transform.h"
+
+void ComposeHierarchy( const Transform* const local, const uint32_t* const parents, Transform* const world, Matrix* const worldMatrices, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		const uint32_t parent = parents[ i ];
+		Transform transform = local[ i ];
+		if ( parent != TRANSFORM_ROOT ) {
+			assert( parent < i );
+			transform.Mul( world[ parent ] );
+		}
+		world[ i ] = transform;
+		if ( worldMatrices != nullptr ) {
+			transform.StoreMatrix( worldMatrices[ i ] );
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Vector.h"
+#include "Matrix.h"
+#include "Quaternion.h"
+
+/*
+Transformace slozena z meritka, rotace a posunu (v tomto poradi), odpovida matici scale * rotation * translation.
+Slozky w vektoru translation a scale jsou nulove.
+Skladani transformaci odpovida tride Matrix: a.Mul( b ) je transformace a nasledovana transformaci b
+(napr. local.Mul( parentWorld )). Vysledek je presny, pokud je meritko b uniformni, jinak by vysledna matice
+obsahovala zkoseni, ktere transformace nemuze vyjadrit.
+*/
+class alignas( 16 ) Transform {
+public:
+	Vector translation;
+	Quaternion rotation;
+	Vector scale;
+
+public:
+	// jednotkova transformace
+	Transform();
+	Transform( const Vector& translation, const Quaternion& rotation, const Vector& scale );
+
+	// rozklad afinni matice bez zkoseni
+	explicit Transform( const Matrix& matrix );
+
+	void Identity();
+	void Mul( const Transform& t );
+
+	// presna inverze pro uniformni meritko
+	void Inverse();
+
+	// matice scale * rotation * translation
+	void StoreMatrix( Matrix& dest ) const;
+};
+
+inline Transform::Transform() {
+	Identity();
+}
+
+inline Transform::Transform( const Vector& translation, const Quaternion& rotation, const Vector& scale ) {
+	this->translation = translation;
+	this->rotation = rotation;
+	this->scale = scale;
+	this->translation.w = 0;
+	this->scale.w = 0;
+}
+
+inline Transform::Transform( const Matrix& matrix ) {
+	Vector rows[ 3 ];
+	for ( int i = 0; i < 3; i++ ) {
+		rows[ i ] = Vector( matrix.m[ i ][ 0 ], matrix.m[ i ][ 1 ], matrix.m[ i ][ 2 ], 0 );
+	}
+	scale = Vector( rows[ 0 ].GetLength(), rows[ 1 ].GetLength(), rows[ 2 ].GetLength(), 0 );
+
+	// zaporny determinant (zrcadleni) je vyjadren zapornym meritkem x
+	Vector cross = rows[ 1 ];
+	cross.Cross( rows[ 2 ] );
+	if ( rows[ 0 ].Dot( cross ) < 0 ) {
+		scale.x = -scale.x;
+	}
+
+	Matrix r;
+	for ( int i = 0; i < 3; i++ ) {
+		const float s = ( &scale.x )[ i ];
+		r.m[ i ][ 0 ] = rows[ i ].x / s;
+		r.m[ i ][ 1 ] = rows[ i ].y / s;
+		r.m[ i ][ 2 ] = rows[ i ].z / s;
+	}
+	rotation = Quaternion( r );
+	translation = Vector( matrix.m30, matrix.m31, matrix.m32, 0 );
+}
+
+inline void Transform::Identity() {
+	translation.Set( 0, 0, 0, 0 );
+	rotation.Identity();
+	scale.Set( 1.0f, 1.0f, 1.0f, 0 );
+}
+
+inline void Transform::Mul( const Transform& t ) {
+	const Simd::Vec4 parentScale = Simd::Load( &t.scale.x );
+	const Simd::Vec4 parentRotation = Simd::Load( &t.rotation.x );
+
+	// posun je otocen a zmenen meritkem nadrazene transformace
+	const Simd::Vec4 offset = Simd::QuaternionRotate( Simd::Mul( Simd::Load( &translation.x ), parentScale ), parentRotation );
+	Simd::Store( &translation.x, Simd::Add( offset, Simd::Load( &t.translation.x ) ) );
+	Simd::Store( &rotation.x, Simd::QuaternionMultiply( parentRotation, Simd::Load( &rotation.x ) ) );
+	Simd::Store( &scale.x, Simd::Mul( Simd::Load( &scale.x ), parentScale ) );
+}
+
+inline void Transform::Inverse() {
+	// w = 1 zabrani deleni nulou, slozka w je pak vynulovana
+	const Simd::Vec4 inverseScale = Simd::ClearW( Simd::Div( Simd::Replicate( 1.0f ), Simd::Add( Simd::Load( &scale.x ), Simd::Set( 0, 0, 0, 1.0f ) ) ) );
+	rotation.Conjugate();
+	const Simd::Vec4 offset = Simd::QuaternionRotate( Simd::Load( &translation.x ), Simd::Load( &rotation.x ) );
+	Simd::Store( &translation.x, Simd::Sub( Simd::Zero(), Simd::Mul( offset, inverseScale ) ) );
+	Simd::Store( &scale.x, inverseScale );
+}
+
+inline void Transform::StoreMatrix( Matrix& dest ) const {
+	Simd::Vec4 r0, r1, r2;
+	Simd::QuaternionToMatrix( Simd::Load( &rotation.x ), r0, r1, r2 );
+	const Simd::Vec4 s = Simd::Load( &scale.x );
+	Simd::Store( dest.m[ 0 ], Simd::Mul( r0, Simd::SplatX( s ) ) );
+	Simd::Store( dest.m[ 1 ], Simd::Mul( r1, Simd::SplatY( s ) ) );
+	Simd::Store( dest.m[ 2 ], Simd::Mul( r2, Simd::SplatZ( s ) ) );
+	Simd::Store( dest.m[ 3 ], Simd::Add( Simd::Load( &translation.x ), Simd::Set( 0, 0, 0, 1.0f ) ) );
+}
+
+/*
+Hierarchie transformaci ulozena v poli v poradi pruchodu do hloubky (rodic je vzdy pred svymi potomky).
+parents[ i ] je index rodice uzlu i (parents[ i ] < i), korenove uzly maji TRANSFORM_ROOT.
+ComposeHierarchy() vypocita world[ i ] = local[ i ] * world[ parents[ i ] ] jednim pruchodem pole,
+world transformace rodice je diky poradi uzlu vzdy spocitana a obvykle i v cache.
+Pokud worldMatrices neni nullptr, jsou do nej ve stejnem pruchodu ulozeny i matice world transformaci.
+*/
+const uint32_t TRANSFORM_ROOT = 0xffffffff;
+
+void ComposeHierarchy( const Transform* const local, const uint32_t* const parents, Transform* const world, Matrix* const worldMatrices, const std::size_t count );
\ No newline at end of file
@@ -10,33 +10,88 @@ using Byte = uint8_t;
 struct alignas( 16 ) Float2 {
 	float x, y;
 	
-	Float2( const float x = 0, const float y = 0 ) {
-		this->x = x;
-		this->y = y;
+	constexpr Float2( const float x = 0, const float y = 0 ): x( x ), y( y ) {
 	}
 };
 
 struct alignas( 16 ) Float3 {
 	float x, y, z;
 	
-	Float3( const float x = 0, const float y = 0, const float z = 0 ) {
-		this->x = x;
-		this->y = y;
-		this->z = z;
+	constexpr Float3( const float x = 0, const float y = 0, const float z = 0 ): x( x ), y( y ), z( z ) {
 	}
 };
 
 struct alignas( 16 ) Float4 {
 	float x, y, z, w;
 	
-	Float4( const float x = 0, const float y = 0, const float z = 0, const float w = 0 ) {
-		this->x = x;
-		this->y = y;
-		this->z = z;
-		this->w = w;
+	constexpr Float4( const float x = 0, const float y = 0, const float z = 0, const float w = 0 ): x( x ), y( y ), z( z ), w( w ) {
 	}
 };
 
+/*
+Typy pro ukladani (pole, soubory, vertex buffery): bez zarovnani a vyplne, velikost odpovida formatu RenderInterface::Format.
+FloatN, Vector a Matrix jsou zarovnane typy pro vypocty, hromadny prevod mezi nimi viz PackedArray.h.
+*/
+
+// R32G32_FLOAT
+struct PackedFloat2 {
+	float x, y;
+
+	constexpr PackedFloat2( const float x = 0, const float y = 0 ): x( x ), y( y ) {
+	}
+};
+
+// R32G32B32_FLOAT
+struct PackedFloat3 {
+	float x, y, z;
+
+	constexpr PackedFloat3( const float x = 0, const float y = 0, const float z = 0 ): x( x ), y( y ), z( z ) {
+	}
+};
+
+// R32G32B32A32_FLOAT
+struct PackedFloat4 {
+	float x, y, z, w;
+
+	constexpr PackedFloat4( const float x = 0, const float y = 0, const float z = 0, const float w = 0 ): x( x ), y( y ), z( z ), w( w ) {
+	}
+};
+
+// R16G16_FLOAT a R16G16B16A16_FLOAT, slozky jsou bity hodnot half (prevod viz Half.h)
+struct Half2 {
+	uint16_t x, y;
+};
+
+struct Half4 {
+	uint16_t x, y, z, w;
+};
+
+// normalizovane celociselne formaty (nazev: pocet slozek x pocet bitu), slozky v poradi x, y, z, w (r, g, b, a pro barvy)
+
+// R16G16_SNORM
+struct SNorm2x16 {
+	int16_t x, y;
+};
+
+// R16G16B16A16_SNORM
+struct SNorm4x16 {
+	int16_t x, y, z, w;
+};
+
+// R16G16_UNORM
+struct UNorm2x16 {
+	uint16_t x, y;
+};
+
+// R8G8B8A8_UNORM
+struct UNorm4x8 {
+	uint8_t x, y, z, w;
+};
+
+static_assert( sizeof( PackedFloat2 ) == 8 && sizeof( PackedFloat3 ) == 12 && sizeof( PackedFloat4 ) == 16, "packed float size mismatch" );
+static_assert( sizeof( Half2 ) == 4 && sizeof( Half4 ) == 8, "packed half size mismatch" );
+static_assert( sizeof( SNorm2x16 ) == 4 && sizeof( SNorm4x16 ) == 8 && sizeof( UNorm2x16 ) == 4 && sizeof( UNorm4x8 ) == 4, "packed norm size mismatch" );
+
 union alignas( 16 ) Float2x2 {
 	struct {
 		float m00, m01;
@@ -62,4 +117,16 @@ union alignas( 16 ) Float4x4 {
 		float m30, m31, m32, m33;
 	};
 	float m[ 4 ][ 4 ];
+
+	// bez inicializace (napr. pole pro zapis do bufferu)
+	Float4x4() = default;
+
+	// pri prekladu lze cist jen pole m (aktivni clen unie)
+	constexpr Float4x4(
+		const float m00, const float m01, const float m02, const float m03,
+		const float m10, const float m11, const float m12, const float m13,
+		const float m20, const float m21, const float m22, const float m23,
+		const float m30, const float m31, const float m32, const float m33
+	): m{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } } {
+	}
 };
\ No newline at end of file
@@ -1,32 +1,29 @@
 #pragma once
 
-#include <DirectXMath.h>
+#include <cmath>
 #include "Types.h"
+#include "Simd.h"
 
 class Matrix;
+class Quaternion;
 
 // do aritmetickych operaci se nezahrnuje w
 //
 class alignas( 16 ) Vector {
 public:
-	union {
-		struct {
-			float x, y, z, w;
-		};
-		// internal use only!
-		DirectX::XMFLOAT4A xm4;
-	};
+	float x, y, z, w;
 	
 public:
-	Vector();
-	Vector( const float x, const float y, const float z, const float w );
-	explicit Vector( const float replicate );
-	Vector( const Vector& begin, const Vector& end );
+	// konstruktory lze vyhodnotit pri prekladu (konstantni vektory)
+	constexpr Vector();
+	constexpr Vector( const float x, const float y, const float z, const float w );
+	constexpr explicit Vector( const float replicate );
+	constexpr Vector( const Vector& begin, const Vector& end );
 	
 	// pretypovani z FloatN
-	explicit Vector( const Float2& src );
-	explicit Vector( const Float3& src );
-	explicit Vector( const Float4& src );
+	constexpr explicit Vector( const Float2& src );
+	constexpr explicit Vector( const Float3& src );
+	constexpr explicit Vector( const Float4& src );
 	
 	// pretypovani na FloatN
 	operator Float2() const;
@@ -82,6 +79,7 @@ public:
 	// 3D transformace
 	void Transform( const Matrix& matrix );
 	void Rotate( const float pitch, const float yaw, const float roll );
+	void Rotate( const Quaternion& rotation );
 	
 	// velikost 3D vektoru
 	float GetLength() const;
@@ -93,45 +91,27 @@ public:
 };
 
 #include "Matrix.h"
+#include "Quaternion.h"
 
-inline Vector::Vector() {
-	Set( 0, 0, 0, 0 );
+constexpr Vector::Vector(): x( 0 ), y( 0 ), z( 0 ), w( 0 ) {
 }
 
-inline Vector::Vector( const float x, const float y, const float z, const float w ) {
-	Set( x, y, z, w );
+constexpr Vector::Vector( const float x, const float y, const float z, const float w ): x( x ), y( y ), z( z ), w( w ) {
 }
 
-inline Vector::Vector( const float replicate ) {
-	x = y = z = replicate;
-	w = 0;
+constexpr Vector::Vector( const float replicate ): x( replicate ), y( replicate ), z( replicate ), w( 0 ) {
 }
 
-inline Vector::Vector( const Vector& begin, const Vector& end ) {
-	x = end.x - begin.x;
-	y = end.y - begin.y;
-	z = end.z - begin.z;
-	w = 0;
+constexpr Vector::Vector( const Vector& begin, const Vector& end ): x( end.x - begin.x ), y( end.y - begin.y ), z( end.z - begin.z ), w( 0 ) {
 }
 
-inline Vector::Vector( const Float2& src ) {
-	x = src.x;
-	y = src.y;
-	z = w = 0;
+constexpr Vector::Vector( const Float2& src ): x( src.x ), y( src.y ), z( 0 ), w( 0 ) {
 }
 
-inline Vector::Vector( const Float3& src ) {
-	x = src.x;
-	y = src.y;
-	z = src.z;
-	w = 0;
+constexpr Vector::Vector( const Float3& src ): x( src.x ), y( src.y ), z( src.z ), w( 0 ) {
 }
 
-inline Vector::Vector( const Float4& src ) {
-	x = src.x;
-	y = src.y;
-	z = src.z;
-	w = src.w;
+constexpr Vector::Vector( const Float4& src ): x( src.x ), y( src.y ), z( src.z ), w( src.w ) {
 }
 
 inline Vector::operator Float2() const {
@@ -229,40 +209,22 @@ inline float Vector::Dot( const Vector& v ) const {
 }
 
 inline void Vector::Cross( const Vector& v ) {
-	DirectX::XMStoreFloat4A( &xm4,
-		DirectX::XMVector3Cross(
-			DirectX::XMLoadFloat4A( &xm4 ),
-			DirectX::XMLoadFloat4A( &v.xm4 )
-		)
-	);
+	Simd::Store( &x, Simd::Cross3( Simd::Load( &x ), Simd::Load( &v.x ) ) );
 }
 
 inline void Vector::Normalize() {
-	DirectX::XMStoreFloat4A( &xm4,
-		DirectX::XMVector3Normalize(
-			DirectX::XMLoadFloat4A( &xm4 )
-		)
-	);
+	Simd::Store( &x, Simd::Normalize3( Simd::Load( &x ) ) );
 }
 
 inline void Vector::Transform( const Matrix& matrix ) {
-	DirectX::XMStoreFloat4A( &xm4,
-		DirectX::XMVector3Transform(
-			DirectX::XMLoadFloat4A( &xm4 ),
-			DirectX::XMLoadFloat4x4A( &matrix.xm4x4 )
-		)
-	);
-	// MSDN XMVector3Transform(): The w component of the returned vector may be non-homogeneous (!= 1.0)
-	w = 0;
+	// w vysledku neni homogenni (muze byt != 1), proto je vynulovano
+	Simd::Store( &x, Simd::ClearW( Simd::TransformPoint( Simd::Load( &x ), &matrix.m[ 0 ][ 0 ] ) ) );
 }
 
 inline void Vector::Rotate( const float pitch, const float yaw, const float roll ) {
-	DirectX::XMStoreFloat4A( &xm4,
-		DirectX::XMVector3Rotate(
-			DirectX::XMLoadFloat4A( &xm4 ),
-			DirectX::XMQuaternionRotationRollPitchYaw( pitch, yaw, roll )
-		)
-	);
+	Matrix rotation;
+	rotation.Rotate( roll, pitch, yaw );
+	Simd::Store( &x, Simd::ClearW( Simd::TransformNormal( Simd::Load( &x ), &rotation.m[ 0 ][ 0 ] ) ) );
 }
 
 inline Vector Vector::operator+( const Vector& v ) const {
@@ -370,17 +332,11 @@ inline float Vector::GetLengthSq() const {
 }
 
 inline float Vector::Distance( const Vector& begin, const Vector& end ) {
-	DirectX::XMVECTOR diff = DirectX::XMVectorSubtract(
-		DirectX::XMLoadFloat4A( &end.xm4 ),
-		DirectX::XMLoadFloat4A( &begin.xm4 )
-	);
-	return DirectX::XMVectorGetX( DirectX::XMVector3Length( diff ) );
+	const Simd::Vec4 diff = Simd::Sub( Simd::Load( &end.x ), Simd::Load( &begin.x ) );
+	return std::sqrt( Simd::GetX( Simd::Dot3( diff, diff ) ) );
 }
 
 inline float Vector::DistanceSq( const Vector& begin, const Vector& end ) {
-	DirectX::XMVECTOR diff = DirectX::XMVectorSubtract(
-		DirectX::XMLoadFloat4A( &end.xm4 ),
-		DirectX::XMLoadFloat4A( &begin.xm4 )
-	);
-	return DirectX::XMVectorGetX( DirectX::XMVector3LengthSq( diff ) );
+	const Simd::Vec4 diff = Simd::Sub( Simd::Load( &end.x ), Simd::Load( &begin.x ) );
+	return Simd::GetX( Simd::Dot3( diff, diff ) );
 }
\ No newline at end of file
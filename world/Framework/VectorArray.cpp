@@ -0,0 +1,240 @@
+#include <cstring>
+#include <new>
+#include "VectorArray.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+// kernel pro pole Float3 nacita cely prvek jednou instrukci
+static_assert( sizeof( Float3 ) == 16, "Float3 must be padded to 16 bytes" );
+static_assert( TRANSFORM_PARALLEL_BATCH % VECTOR_ARRAY_LANES == 0, "TRANSFORM_PARALLEL_BATCH must be a multiple of VECTOR_ARRAY_LANES" );
+
+// class VectorArray
+
+VectorArray::VectorArray() {
+	data = nullptr;
+	count = 0;
+	capacity = 0;
+}
+
+VectorArray::VectorArray( const std::size_t count ): VectorArray() {
+	Resize( count );
+}
+
+VectorArray::~VectorArray() {
+	if ( data != nullptr ) {
+		::operator delete( data, std::align_val_t( 32 ) );
+	}
+}
+
+void VectorArray::Resize( const std::size_t countParam ) {
+	const std::size_t newCapacity = ( countParam + VECTOR_ARRAY_LANES - 1 ) / VECTOR_ARRAY_LANES * VECTOR_ARRAY_LANES;
+	if ( newCapacity != capacity ) {
+		float* const newData = newCapacity > 0 ? static_cast< float* >( ::operator new( newCapacity * 3 * sizeof( float ), std::align_val_t( 32 ) ) ) : nullptr;
+		const std::size_t preserved = count < countParam ? count : countParam;
+		for ( std::size_t i = 0; i < 3; i++ ) {
+			if ( preserved > 0 ) {
+				std::memcpy( newData + newCapacity * i, data + capacity * i, preserved * sizeof( float ) );
+			}
+			if ( newCapacity > preserved ) {
+				std::memset( newData + newCapacity * i + preserved, 0, ( newCapacity - preserved ) * sizeof( float ) );
+			}
+		}
+		if ( data != nullptr ) {
+			::operator delete( data, std::align_val_t( 32 ) );
+		}
+		data = newData;
+		capacity = newCapacity;
+	} else if ( countParam > count ) {
+		// pridane vektory byly doplnenim, do ktereho zapisuji transformace
+		for ( std::size_t i = 0; i < 3; i++ ) {
+			std::memset( data + capacity * i + count, 0, ( countParam - count ) * sizeof( float ) );
+		}
+	}
+	count = countParam;
+}
+
+// transformacni kernely
+
+namespace {
+
+#ifdef SIMD_AVX2
+	inline __m256 MulAdd( const __m256 a, const __m256 b, const __m256 c ) {
+	#ifdef SIMD_FMA
+		return _mm256_fmadd_ps( a, b, c );
+	#else
+		return _mm256_add_ps( _mm256_mul_ps( a, b ), c );
+	#endif
+	}
+#endif
+
+	// vynechani posunu (m30, m31, m32) pro TransformNormals
+	template < bool TRANSLATE >
+	void TransformArray( const float* const m, const Float3* const in, Float3* const out, const std::size_t begin, const std::size_t end ) {
+		std::size_t i = begin;
+	#ifdef SIMD_AVX2
+		{
+			// dva prvky v jednom registru, radky matice v obou polovinach registru
+			const __m256 r0 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( m ) );
+			const __m256 r1 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( m + 4 ) );
+			const __m256 r2 = _mm256_broadcast_ps( reinterpret_cast< const __m128* >( m + 8 ) );
+			const __m256 r3 = TRANSLATE ? _mm256_broadcast_ps( reinterpret_cast< const __m128* >( m + 12 ) ) : _mm256_setzero_ps();
+			for ( ; i + 4 <= end; i += 4 ) {
+				const __m256 v01 = _mm256_loadu_ps( &in[ i ].x );
+				const __m256 v23 = _mm256_loadu_ps( &in[ i + 2 ].x );
+				__m256 t01 = MulAdd( _mm256_permute_ps( v01, 0xaa ), r2, r3 );
+				__m256 t23 = MulAdd( _mm256_permute_ps( v23, 0xaa ), r2, r3 );
+				t01 = MulAdd( _mm256_permute_ps( v01, 0x55 ), r1, t01 );
+				t23 = MulAdd( _mm256_permute_ps( v23, 0x55 ), r1, t23 );
+				t01 = MulAdd( _mm256_permute_ps( v01, 0x00 ), r0, t01 );
+				t23 = MulAdd( _mm256_permute_ps( v23, 0x00 ), r0, t23 );
+				_mm256_storeu_ps( &out[ i ].x, t01 );
+				_mm256_storeu_ps( &out[ i + 2 ].x, t23 );
+			}
+		}
+	#endif
+		{
+			const Simd::Vec4 r0 = Simd::Load( m );
+			const Simd::Vec4 r1 = Simd::Load( m + 4 );
+			const Simd::Vec4 r2 = Simd::Load( m + 8 );
+			const Simd::Vec4 r3 = TRANSLATE ? Simd::Load( m + 12 ) : Simd::Zero();
+			for ( ; i < end; i++ ) {
+				const Simd::Vec4 v = Simd::Load( &in[ i ].x );
+				Simd::Vec4 t = Simd::MulAdd( Simd::SplatZ( v ), r2, r3 );
+				t = Simd::MulAdd( Simd::SplatY( v ), r1, t );
+				t = Simd::MulAdd( Simd::SplatX( v ), r0, t );
+				Simd::Store( &out[ i ].x, t );
+			}
+		}
+	}
+
+	struct ComponentArrays {
+		const float* inX;
+		const float* inY;
+		const float* inZ;
+		float* outX;
+		float* outY;
+		float* outZ;
+	};
+
+	template < bool TRANSLATE >
+	void TransformArray( const float* const m, const ComponentArrays& arrays, const std::size_t begin, const std::size_t end ) {
+		const float* const inX = arrays.inX;
+		const float* const inY = arrays.inY;
+		const float* const inZ = arrays.inZ;
+		float* const outX = arrays.outX;
+		float* const outY = arrays.outY;
+		float* const outZ = arrays.outZ;
+		std::size_t i = begin;
+	#ifdef SIMD_AVX2
+		{
+			const __m256 m00 = _mm256_set1_ps( m[ 0 ] ), m01 = _mm256_set1_ps( m[ 1 ] ), m02 = _mm256_set1_ps( m[ 2 ] );
+			const __m256 m10 = _mm256_set1_ps( m[ 4 ] ), m11 = _mm256_set1_ps( m[ 5 ] ), m12 = _mm256_set1_ps( m[ 6 ] );
+			const __m256 m20 = _mm256_set1_ps( m[ 8 ] ), m21 = _mm256_set1_ps( m[ 9 ] ), m22 = _mm256_set1_ps( m[ 10 ] );
+			const __m256 m30 = _mm256_set1_ps( TRANSLATE ? m[ 12 ] : 0 );
+			const __m256 m31 = _mm256_set1_ps( TRANSLATE ? m[ 13 ] : 0 );
+			const __m256 m32 = _mm256_set1_ps( TRANSLATE ? m[ 14 ] : 0 );
+			for ( ; i + 8 <= end; i += 8 ) {
+				const __m256 x = _mm256_loadu_ps( inX + i );
+				const __m256 y = _mm256_loadu_ps( inY + i );
+				const __m256 z = _mm256_loadu_ps( inZ + i );
+				_mm256_storeu_ps( outX + i, MulAdd( x, m00, MulAdd( y, m10, MulAdd( z, m20, m30 ) ) ) );
+				_mm256_storeu_ps( outY + i, MulAdd( x, m01, MulAdd( y, m11, MulAdd( z, m21, m31 ) ) ) );
+				_mm256_storeu_ps( outZ + i, MulAdd( x, m02, MulAdd( y, m12, MulAdd( z, m22, m32 ) ) ) );
+			}
+		}
+	#endif
+		{
+			const Simd::Vec4 m00 = Simd::Replicate( m[ 0 ] ), m01 = Simd::Replicate( m[ 1 ] ), m02 = Simd::Replicate( m[ 2 ] );
+			const Simd::Vec4 m10 = Simd::Replicate( m[ 4 ] ), m11 = Simd::Replicate( m[ 5 ] ), m12 = Simd::Replicate( m[ 6 ] );
+			const Simd::Vec4 m20 = Simd::Replicate( m[ 8 ] ), m21 = Simd::Replicate( m[ 9 ] ), m22 = Simd::Replicate( m[ 10 ] );
+			const Simd::Vec4 m30 = Simd::Replicate( TRANSLATE ? m[ 12 ] : 0 );
+			const Simd::Vec4 m31 = Simd::Replicate( TRANSLATE ? m[ 13 ] : 0 );
+			const Simd::Vec4 m32 = Simd::Replicate( TRANSLATE ? m[ 14 ] : 0 );
+			for ( ; i + 4 <= end; i += 4 ) {
+				const Simd::Vec4 x = Simd::LoadUnaligned( inX + i );
+				const Simd::Vec4 y = Simd::LoadUnaligned( inY + i );
+				const Simd::Vec4 z = Simd::LoadUnaligned( inZ + i );
+				Simd::StoreUnaligned( outX + i, Simd::MulAdd( x, m00, Simd::MulAdd( y, m10, Simd::MulAdd( z, m20, m30 ) ) ) );
+				Simd::StoreUnaligned( outY + i, Simd::MulAdd( x, m01, Simd::MulAdd( y, m11, Simd::MulAdd( z, m21, m31 ) ) ) );
+				Simd::StoreUnaligned( outZ + i, Simd::MulAdd( x, m02, Simd::MulAdd( y, m12, Simd::MulAdd( z, m22, m32 ) ) ) );
+			}
+		}
+
+		// konec pole
+		for ( ; i < end; i++ ) {
+			const float x = inX[ i ];
+			const float y = inY[ i ];
+			const float z = inZ[ i ];
+			outX[ i ] = x * m[ 0 ] + ( y * m[ 4 ] + ( z * m[ 8 ] + ( TRANSLATE ? m[ 12 ] : 0 ) ) );
+			outY[ i ] = x * m[ 1 ] + ( y * m[ 5 ] + ( z * m[ 9 ] + ( TRANSLATE ? m[ 13 ] : 0 ) ) );
+			outZ[ i ] = x * m[ 2 ] + ( y * m[ 6 ] + ( z * m[ 10 ] + ( TRANSLATE ? m[ 14 ] : 0 ) ) );
+		}
+	}
+
+	// adapter pro pole Float3
+	struct Float3Arrays {
+		const Float3* in;
+		Float3* out;
+	};
+
+	template < bool TRANSLATE >
+	void TransformArray( const float* const m, const Float3Arrays& arrays, const std::size_t begin, const std::size_t end ) {
+		TransformArray< TRANSLATE >( m, arrays.in, arrays.out, begin, end );
+	}
+
+	template < bool TRANSLATE, typename Arrays >
+	void Transform( const Matrix& matrix, const Arrays& arrays, const std::size_t count, const bool parallel ) {
+		const float* const m = matrix.m[ 0 ];
+		if ( parallel ) {
+			ParallelFor( count, TRANSFORM_PARALLEL_BATCH, [ & ]( const std::size_t begin, const std::size_t end ) {
+				TransformArray< TRANSLATE >( m, arrays, begin, end );
+			} );
+			return;
+		}
+		TransformArray< TRANSLATE >( m, arrays, 0, count );
+	}
+
+	ComponentArrays GetComponentArrays( const VectorArray& in, VectorArray& out ) {
+		out.Resize( in.GetCount() );
+		return ComponentArrays{ in.GetX(), in.GetY(), in.GetZ(), out.GetX(), out.GetY(), out.GetZ() };
+	}
+}
+
+void TransformPoints( const Matrix& matrix, const Float3* const in, Float3* const out, const std::size_t count, const bool parallel ) {
+	Transform< true >( matrix, Float3Arrays{ in, out }, count, parallel );
+}
+
+void TransformNormals( const Matrix& matrix, const Float3* const in, Float3* const out, const std::size_t count, const bool parallel ) {
+	Transform< false >( matrix, Float3Arrays{ in, out }, count, parallel );
+}
+
+void TransformPoints(
+	const Matrix& matrix,
+	const float* const inX, const float* const inY, const float* const inZ,
+	float* const outX, float* const outY, float* const outZ,
+	const std::size_t count,
+	const bool parallel
+) {
+	Transform< true >( matrix, ComponentArrays{ inX, inY, inZ, outX, outY, outZ }, count, parallel );
+}
+
+void TransformNormals(
+	const Matrix& matrix,
+	const float* const inX, const float* const inY, const float* const inZ,
+	float* const outX, float* const outY, float* const outZ,
+	const std::size_t count,
+	const bool parallel
+) {
+	Transform< false >( matrix, ComponentArrays{ inX, inY, inZ, outX, outY, outZ }, count, parallel );
+}
+
+// transformuje se i doplneni pole, konec pole se tak nezpracovava po jednom vektoru
+void TransformPoints( const Matrix& matrix, const VectorArray& in, VectorArray& out, const bool parallel ) {
+	const ComponentArrays arrays = GetComponentArrays( in, out );
+	Transform< true >( matrix, arrays, in.GetCapacity(), parallel );
+}
+
+void TransformNormals( const Matrix& matrix, const VectorArray& in, VectorArray& out, const bool parallel ) {
+	const ComponentArrays arrays = GetComponentArrays( in, out );
+	Transform< false >( matrix, arrays, in.GetCapacity(), parallel );
+}
\ No newline at end of file
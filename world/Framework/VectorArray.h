@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include "Types.h"
+#include "Vector.h"
+#include "Matrix.h"
+
+/*
+VectorArray: pole 3D vektoru ulozene po slozkach (structure of arrays).
+Kazda slozka je souvisle pole zarovnane na 32 bajtu a doplnene na nasobek VECTOR_ARRAY_LANES prvku,
+transformace tak zpracovavaji 8 (AVX2) nebo 4 (SSE) vektory najednou bez zvlastniho zpracovani konce pole.
+Doplneni obsahuje konecne hodnoty (Resize ho nuluje, transformace do nej zapisuji).
+*/
+const std::size_t VECTOR_ARRAY_LANES = 8;
+
+class VectorArray {
+public:
+	VectorArray();
+	explicit VectorArray( const std::size_t count );
+	~VectorArray();
+
+	// neni povoleno vytvaret kopie
+	VectorArray( const VectorArray& ) = delete;
+	VectorArray& operator=( const VectorArray& ) = delete;
+
+	// zmeni pocet vektoru, puvodni hodnoty zustanou zachovany, nove vektory jsou nulove
+	void Resize( const std::size_t count );
+
+	std::size_t GetCount() const;
+
+	// pocet prvku kazde slozky vcetne doplneni (nasobek VECTOR_ARRAY_LANES)
+	std::size_t GetCapacity() const;
+
+	// slozky vektoru
+	float* GetX();
+	float* GetY();
+	float* GetZ();
+	const float* GetX() const;
+	const float* GetY() const;
+	const float* GetZ() const;
+
+	// pristup k jednomu vektoru (w = 0)
+	void Set( const std::size_t index, const Vector& vector );
+	Vector Get( const std::size_t index ) const;
+
+private:
+	float* data;
+	std::size_t count;
+	std::size_t capacity;
+};
+
+inline std::size_t VectorArray::GetCount() const {
+	return count;
+}
+
+inline std::size_t VectorArray::GetCapacity() const {
+	return capacity;
+}
+
+inline float* VectorArray::GetX() {
+	return data;
+}
+
+inline float* VectorArray::GetY() {
+	return data + capacity;
+}
+
+inline float* VectorArray::GetZ() {
+	return data + capacity * 2;
+}
+
+inline const float* VectorArray::GetX() const {
+	return data;
+}
+
+inline const float* VectorArray::GetY() const {
+	return data + capacity;
+}
+
+inline const float* VectorArray::GetZ() const {
+	return data + capacity * 2;
+}
+
+inline void VectorArray::Set( const std::size_t index, const Vector& vector ) {
+	data[ index ] = vector.x;
+	data[ capacity + index ] = vector.y;
+	data[ capacity * 2 + index ] = vector.z;
+}
+
+inline Vector VectorArray::Get( const std::size_t index ) const {
+	return Vector( data[ index ], data[ capacity + index ], data[ capacity * 2 + index ], 0 );
+}
+
+/*
+Transformace pole vektoru matici.
+TransformPoints() transformuje body (w = 1), vysledek neni delen slozkou w (stejne jako Vector::Transform).
+TransformNormals() transformuje smery (w = 0), tj. bez posunu.
+Vstup a vystup muze byt totozne pole. Pri parallel jsou pole delsi nez TRANSFORM_PARALLEL_BATCH
+rozdelena mezi vlakna ParallelFor.
+*/
+const std::size_t TRANSFORM_PARALLEL_BATCH = 16 * 1024;
+
+// pole Float3 (prvek je zarovnany na 16 bajtu, zapisuje se cely prvek vcetne vyplne za slozkou z)
+void TransformPoints( const Matrix& matrix, const Float3* const in, Float3* const out, const std::size_t count, const bool parallel = false );
+void TransformNormals( const Matrix& matrix, const Float3* const in, Float3* const out, const std::size_t count, const bool parallel = false );
+
+// slozky ulozene v samostatnych polich, pole nemusi byt zarovnana
+void TransformPoints(
+	const Matrix& matrix,
+	const float* const inX, const float* const inY, const float* const inZ,
+	float* const outX, float* const outY, float* const outZ,
+	const std::size_t count,
+	const bool parallel = false
+);
+void TransformNormals(
+	const Matrix& matrix,
+	const float* const inX, const float* const inY, const float* const inZ,
+	float* const outX, float* const outY, float* const outZ,
+	const std::size_t count,
+	const bool parallel = false
+);
+
+// velikost out je zmenena na velikost in
+void TransformPoints( const Matrix& matrix, const VectorArray& in, VectorArray& out, const bool parallel = false );
+void TransformNormals( const Matrix& matrix, const VectorArray& in, VectorArray& out, const bool parallel = false );
\ No newline at end of file
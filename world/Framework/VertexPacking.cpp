@@ -0,0 +1,415 @@
+#include <cmath>
+#include <cstring>
+#include "VertexPacking.h"
+#include "Quaternion.h"
+#include "Simd.h"
+
+// SSE2 kernel nacita cely prvek jednou instrukci
+static_assert( sizeof( Float2 ) == 16 && sizeof( Float3 ) == 16 && sizeof( Float4 ) == 16, "Float2/3/4 must be padded to 16 bytes" );
+
+namespace {
+
+	const float SNORM16_MAX = 32767.0f;
+	const float UNORM16_MAX = 65535.0f;
+	const float UNORM8_MAX = 255.0f;
+
+	// nejmensi kladna hodnota w kvaternionu, ktera po kvantizaci zachova znamenko (orientaci bitangenty)
+	const float TANGENT_FRAME_BIAS = 1.0f / SNORM16_MAX;
+
+	// zapis prvku vystupu s roztecem stride (memcpy, prvek nemusi byt zarovnany)
+	template < typename T >
+	inline void StoreElement( char* const dest, const std::size_t index, const std::size_t stride, const T& value ) {
+		std::memcpy( dest + index * stride, &value, sizeof( T ) );
+	}
+
+	// skalarni kodovani, zaokrouhleni lrint odpovida instrukci cvtps2dq (k nejblizsimu, pri shode k sudemu)
+
+	inline float Saturate( const float value, const float min ) {
+		return fminf( fmaxf( value, min ), 1.0f );
+	}
+
+	inline int16_t QuantizeSNorm16( const float value ) {
+		return static_cast< int16_t >( std::lrint( Saturate( value, -1.0f ) * SNORM16_MAX ) );
+	}
+
+	inline uint16_t QuantizeUNorm16( const float value ) {
+		return static_cast< uint16_t >( std::lrint( Saturate( value, 0 ) * UNORM16_MAX ) );
+	}
+
+	inline uint8_t QuantizeUNorm8( const float value ) {
+		return static_cast< uint8_t >( std::lrint( Saturate( value, 0 ) * UNORM8_MAX ) );
+	}
+
+	inline float DequantizeSNorm16( const int16_t value ) {
+		return fmaxf( static_cast< float >( value ) / SNORM16_MAX, -1.0f );
+	}
+
+	inline SNorm2x16 EncodeNormal( const Float3& normal ) {
+		const float sum = fabsf( normal.x ) + fabsf( normal.y ) + fabsf( normal.z );
+		const float inv = sum > 0 ? 1.0f / sum : 0;
+		float x = normal.x * inv;
+		float y = normal.y * inv;
+		if ( normal.z < 0 ) {
+			const float foldX = ( 1.0f - fabsf( y ) ) * copysignf( 1.0f, x );
+			const float foldY = ( 1.0f - fabsf( x ) ) * copysignf( 1.0f, y );
+			x = foldX;
+			y = foldY;
+		}
+		return SNorm2x16{ QuantizeSNorm16( x ), QuantizeSNorm16( y ) };
+	}
+
+	inline SNorm4x16 EncodeTangentFrame( const Float3& normal, const Float4& tangent ) {
+		// osy tangentniho prostoru (radky rotacni matice): t, b = cross( n, t ), n
+		const float normalLength = sqrtf( normal.x * normal.x + normal.y * normal.y + normal.z * normal.z );
+		const float normalInv = normalLength > 0 ? 1.0f / normalLength : 0;
+		const float nx = normal.x * normalInv;
+		const float ny = normal.y * normalInv;
+		const float nz = normal.z * normalInv;
+		const float d = nx * tangent.x + ny * tangent.y + nz * tangent.z;
+		float tx = tangent.x - nx * d;
+		float ty = tangent.y - ny * d;
+		float tz = tangent.z - nz * d;
+		const float tangentLength = sqrtf( tx * tx + ty * ty + tz * tz );
+		const float tangentInv = tangentLength > 0 ? 1.0f / tangentLength : 0;
+		tx *= tangentInv;
+		ty *= tangentInv;
+		tz *= tangentInv;
+		const float bx = ny * tz - nz * ty;
+		const float by = nz * tx - nx * tz;
+		const float bz = nx * ty - ny * tx;
+
+		// stejny postup jako Quaternion( const Matrix& ), vychazi se z nejvetsi slozky
+		// 1 + diagonala se scita ve stejnem poradi jako v SSE2 kernelu
+		float q[ 4 ];
+		if ( tx + by + nz > 0 ) {
+			const float s = sqrtf( 1.0f + ( tx + by + nz ) ) * 2.0f;
+			q[ 0 ] = ( bz - ny ) / s;
+			q[ 1 ] = ( nx - tz ) / s;
+			q[ 2 ] = ( ty - bx ) / s;
+			q[ 3 ] = 0.25f * s;
+		} else if ( tx > by && tx > nz ) {
+			const float s = sqrtf( 1.0f + ( tx - by - nz ) ) * 2.0f;
+			q[ 0 ] = 0.25f * s;
+			q[ 1 ] = ( ty + bx ) / s;
+			q[ 2 ] = ( nx + tz ) / s;
+			q[ 3 ] = ( bz - ny ) / s;
+		} else if ( by > nz ) {
+			const float s = sqrtf( 1.0f + ( by - tx - nz ) ) * 2.0f;
+			q[ 0 ] = ( ty + bx ) / s;
+			q[ 1 ] = 0.25f * s;
+			q[ 2 ] = ( bz + ny ) / s;
+			q[ 3 ] = ( nx - tz ) / s;
+		} else {
+			const float s = sqrtf( 1.0f + ( nz - tx - by ) ) * 2.0f;
+			q[ 0 ] = ( nx + tz ) / s;
+			q[ 1 ] = ( bz + ny ) / s;
+			q[ 2 ] = 0.25f * s;
+			q[ 3 ] = ( ty - bx ) / s;
+		}
+
+		// w >= TANGENT_FRAME_BIAS, znamenko w je orientace bitangenty (znamenkovy bit, -0 je zaporna orientace)
+		const bool negative = std::signbit( tangent.w );
+		const float sign = std::signbit( q[ 3 ] ) != negative ? -1.0f : 1.0f;
+		q[ 3 ] = fmaxf( fabsf( q[ 3 ] ), TANGENT_FRAME_BIAS );
+		return SNorm4x16{
+			QuantizeSNorm16( q[ 0 ] * sign ),
+			QuantizeSNorm16( q[ 1 ] * sign ),
+			QuantizeSNorm16( q[ 2 ] * sign ),
+			QuantizeSNorm16( negative ? -q[ 3 ] : q[ 3 ] )
+		};
+	}
+
+#ifdef SIMD_SSE2
+
+	inline __m128 Select( const __m128 mask, const __m128 a, const __m128 b ) {
+		return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+	}
+
+	inline __m128 SignMask() {
+		return _mm_set1_ps( -0.0f );
+	}
+
+	inline __m128 Abs( const __m128 v ) {
+		return _mm_andnot_ps( SignMask(), v );
+	}
+
+	// +1 nebo -1 podle znamenka (i pro +0 a -0), odpovida copysignf( 1, v )
+	inline __m128 SignNotZero( const __m128 v ) {
+		return _mm_or_ps( _mm_and_ps( v, SignMask() ), _mm_set1_ps( 1.0f ) );
+	}
+
+	// 1 / v, pro v <= 0 vraci 0
+	inline __m128 InversePositive( const __m128 v ) {
+		return _mm_and_ps( _mm_cmpgt_ps( v, _mm_setzero_ps() ), _mm_div_ps( _mm_set1_ps( 1.0f ), v ) );
+	}
+
+	// maxps vraci pro NaN druhy operand, stejne jako fmaxf
+	inline __m128i QuantizeSNorm16( const __m128 v ) {
+		const __m128 clamped = _mm_min_ps( _mm_max_ps( v, _mm_set1_ps( -1.0f ) ), _mm_set1_ps( 1.0f ) );
+		return _mm_cvtps_epi32( _mm_mul_ps( clamped, _mm_set1_ps( SNORM16_MAX ) ) );
+	}
+
+	inline __m128i QuantizeUNorm( const __m128 v, const float max ) {
+		const __m128 clamped = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps( 1.0f ) );
+		return _mm_cvtps_epi32( _mm_mul_ps( clamped, _mm_set1_ps( max ) ) );
+	}
+
+	// dve 16 bitove hodnoty do 32 bitove slozky ( low | high << 16 )
+	inline __m128i Pack16( const __m128i low, const __m128i high ) {
+		return _mm_or_si128( _mm_and_si128( low, _mm_set1_epi32( 0xffff ) ), _mm_slli_epi32( high, 16 ) );
+	}
+
+	// 4 prvky po 4 bajtech, pri stride != 4 se zapisuji jednotlive
+	template < typename T >
+	inline void StoreLanes( char* const dest, const std::size_t index, const std::size_t stride, const __m128i value ) {
+		static_assert( sizeof( T ) == 4, "T must be 4 bytes" );
+		if ( stride == sizeof( T ) ) {
+			_mm_storeu_si128( reinterpret_cast< __m128i* >( dest + index * stride ), value );
+			return;
+		}
+		alignas( 16 ) T lanes[ 4 ];
+		_mm_store_si128( reinterpret_cast< __m128i* >( lanes ), value );
+		for ( std::size_t i = 0; i < 4; i++ ) {
+			StoreElement( dest, index + i, stride, lanes[ i ] );
+		}
+	}
+
+	// 4 tangentni prostory, vysledek ve dvou registrech ( prvky 0, 1 ), ( prvky 2, 3 )
+	inline void EncodeTangentFrames( const Float3* const normals, const Float4* const tangents, __m128i& first, __m128i& second ) {
+		__m128 nx = _mm_load_ps( &normals[ 0 ].x );
+		__m128 ny = _mm_load_ps( &normals[ 1 ].x );
+		__m128 nz = _mm_load_ps( &normals[ 2 ].x );
+		__m128 nw = _mm_load_ps( &normals[ 3 ].x );
+		_MM_TRANSPOSE4_PS( nx, ny, nz, nw );
+		__m128 tx = _mm_load_ps( &tangents[ 0 ].x );
+		__m128 ty = _mm_load_ps( &tangents[ 1 ].x );
+		__m128 tz = _mm_load_ps( &tangents[ 2 ].x );
+		__m128 tw = _mm_load_ps( &tangents[ 3 ].x );
+		_MM_TRANSPOSE4_PS( tx, ty, tz, tw );
+
+		// normalizace normaly a ortogonalizace tangenty
+		const __m128 normalInv = InversePositive( _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, nx ), _mm_mul_ps( ny, ny ) ), _mm_mul_ps( nz, nz ) ) ) );
+		nx = _mm_mul_ps( nx, normalInv );
+		ny = _mm_mul_ps( ny, normalInv );
+		nz = _mm_mul_ps( nz, normalInv );
+		const __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, tx ), _mm_mul_ps( ny, ty ) ), _mm_mul_ps( nz, tz ) );
+		tx = _mm_sub_ps( tx, _mm_mul_ps( nx, d ) );
+		ty = _mm_sub_ps( ty, _mm_mul_ps( ny, d ) );
+		tz = _mm_sub_ps( tz, _mm_mul_ps( nz, d ) );
+		const __m128 tangentInv = InversePositive( _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( tx, tx ), _mm_mul_ps( ty, ty ) ), _mm_mul_ps( tz, tz ) ) ) );
+		tx = _mm_mul_ps( tx, tangentInv );
+		ty = _mm_mul_ps( ty, tangentInv );
+		tz = _mm_mul_ps( tz, tangentInv );
+		const __m128 bx = _mm_sub_ps( _mm_mul_ps( ny, tz ), _mm_mul_ps( nz, ty ) );
+		const __m128 by = _mm_sub_ps( _mm_mul_ps( nz, tx ), _mm_mul_ps( nx, tz ) );
+		const __m128 bz = _mm_sub_ps( _mm_mul_ps( nx, ty ), _mm_mul_ps( ny, tx ) );
+
+		// vetve Quaternion( const Matrix& ) jako masky, 4 * q[ k ] * q[ j ] pro dvojice slozek
+		const __m128 caseW = _mm_cmpgt_ps( _mm_add_ps( _mm_add_ps( tx, by ), nz ), _mm_setzero_ps() );
+		const __m128 caseX = _mm_andnot_ps( caseW, _mm_and_ps( _mm_cmpgt_ps( tx, by ), _mm_cmpgt_ps( tx, nz ) ) );
+		const __m128 caseY = _mm_andnot_ps( _mm_or_ps( caseW, caseX ), _mm_cmpgt_ps( by, nz ) );
+		const __m128 wx = _mm_sub_ps( bz, ny );
+		const __m128 wy = _mm_sub_ps( nx, tz );
+		const __m128 wz = _mm_sub_ps( ty, bx );
+		const __m128 xy = _mm_add_ps( ty, bx );
+		const __m128 xz = _mm_add_ps( nx, tz );
+		const __m128 yz = _mm_add_ps( bz, ny );
+
+		const __m128 diagonalW = _mm_add_ps( _mm_add_ps( tx, by ), nz );
+		const __m128 diagonalX = _mm_sub_ps( _mm_sub_ps( tx, by ), nz );
+		const __m128 diagonalY = _mm_sub_ps( _mm_sub_ps( by, tx ), nz );
+		const __m128 diagonalZ = _mm_sub_ps( _mm_sub_ps( nz, tx ), by );
+		const __m128 diagonal = Select( caseW, diagonalW, Select( caseX, diagonalX, Select( caseY, diagonalY, diagonalZ ) ) );
+		const __m128 s = _mm_mul_ps( _mm_sqrt_ps( _mm_add_ps( _mm_set1_ps( 1.0f ), diagonal ) ), _mm_set1_ps( 2.0f ) );
+		const __m128 quarter = _mm_mul_ps( s, _mm_set1_ps( 0.25f ) );
+
+		// slozka vybrane vetve je s / 4, ostatni slozky 4 * q[ k ] * q[ j ] / s
+		const __m128 notZ = _mm_or_ps( _mm_or_ps( caseW, caseX ), caseY );
+		__m128 qx = _mm_div_ps( Select( caseW, wx, Select( caseY, xy, xz ) ), s );
+		__m128 qy = _mm_div_ps( Select( caseW, wy, Select( caseX, xy, yz ) ), s );
+		__m128 qz = _mm_div_ps( Select( caseW, wz, Select( caseX, xz, yz ) ), s );
+		__m128 qw = _mm_div_ps( Select( caseX, wx, Select( caseY, wy, wz ) ), s );
+		qx = Select( caseX, quarter, qx );
+		qy = Select( caseY, quarter, qy );
+		qz = Select( notZ, qz, quarter );
+		qw = Select( caseW, quarter, qw );
+
+		// w >= TANGENT_FRAME_BIAS, znamenko w je orientace bitangenty
+		const __m128 flip = _mm_and_ps( _mm_xor_ps( qw, tw ), SignMask() );
+		const __m128 handedness = _mm_and_ps( tw, SignMask() );
+		qx = _mm_xor_ps( qx, flip );
+		qy = _mm_xor_ps( qy, flip );
+		qz = _mm_xor_ps( qz, flip );
+		qw = _mm_xor_ps( _mm_max_ps( Abs( qw ), _mm_set1_ps( TANGENT_FRAME_BIAS ) ), handedness );
+
+		const __m128i low = Pack16( QuantizeSNorm16( qx ), QuantizeSNorm16( qy ) );
+		const __m128i high = Pack16( QuantizeSNorm16( qz ), QuantizeSNorm16( qw ) );
+		first = _mm_unpacklo_epi32( low, high );
+		second = _mm_unpackhi_epi32( low, high );
+	}
+
+	// zapis lanes (<= 4) prvku vysledku EncodeTangentFrames
+	inline void StoreTangentFrames( char* const dest, const std::size_t index, const std::size_t lanes, const std::size_t stride, const __m128i first, const __m128i second ) {
+		if ( lanes == 4 && stride == sizeof( SNorm4x16 ) ) {
+			_mm_storeu_si128( reinterpret_cast< __m128i* >( dest + index * stride ), first );
+			_mm_storeu_si128( reinterpret_cast< __m128i* >( dest + ( index + 2 ) * stride ), second );
+			return;
+		}
+		alignas( 16 ) SNorm4x16 values[ 4 ];
+		_mm_store_si128( reinterpret_cast< __m128i* >( values ), first );
+		_mm_store_si128( reinterpret_cast< __m128i* >( values + 2 ), second );
+		for ( std::size_t i = 0; i < lanes; i++ ) {
+			StoreElement( dest, index + i, stride, values[ i ] );
+		}
+	}
+
+#endif
+
+}
+
+void PackNormals( const Float3* const normals, SNorm2x16* const dest, const std::size_t count, const std::size_t stride ) {
+	char* const bytes = reinterpret_cast< char* >( dest );
+	std::size_t i = 0;
+#ifdef SIMD_SSE2
+	for ( ; i + 4 <= count; i += 4 ) {
+		__m128 x = _mm_load_ps( &normals[ i ].x );
+		__m128 y = _mm_load_ps( &normals[ i + 1 ].x );
+		__m128 z = _mm_load_ps( &normals[ i + 2 ].x );
+		__m128 w = _mm_load_ps( &normals[ i + 3 ].x );
+		_MM_TRANSPOSE4_PS( x, y, z, w );
+
+		const __m128 inv = InversePositive( _mm_add_ps( _mm_add_ps( Abs( x ), Abs( y ) ), Abs( z ) ) );
+		const __m128 px = _mm_mul_ps( x, inv );
+		const __m128 py = _mm_mul_ps( y, inv );
+
+		// dolni polokoule
+		const __m128 lower = _mm_cmplt_ps( z, _mm_setzero_ps() );
+		const __m128 foldX = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), Abs( py ) ), SignNotZero( px ) );
+		const __m128 foldY = _mm_mul_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), Abs( px ) ), SignNotZero( py ) );
+
+		const __m128i qx = QuantizeSNorm16( Select( lower, foldX, px ) );
+		const __m128i qy = QuantizeSNorm16( Select( lower, foldY, py ) );
+		StoreLanes< SNorm2x16 >( bytes, i, stride, Pack16( qx, qy ) );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		StoreElement( bytes, i, stride, EncodeNormal( normals[ i ] ) );
+	}
+}
+
+void PackTangentFrames( const Float3* const normals, const Float4* const tangents, SNorm4x16* const dest, const std::size_t count, const std::size_t stride ) {
+	char* const bytes = reinterpret_cast< char* >( dest );
+#ifdef SIMD_SSE2
+	// zbytek pole prochazi stejnym kernelem pres pomocny buffer, vysledek tak nezavisi na pozici prvku v poli
+	__m128i first, second;
+	std::size_t i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		EncodeTangentFrames( normals + i, tangents + i, first, second );
+		StoreTangentFrames( bytes, i, 4, stride, first, second );
+	}
+	if ( i < count ) {
+		Float3 normalBuffer[ 4 ];
+		Float4 tangentBuffer[ 4 ];
+		for ( std::size_t j = 0; j < 4; j++ ) {
+			normalBuffer[ j ] = i + j < count ? normals[ i + j ] : Float3( 0, 0, 1.0f );
+			tangentBuffer[ j ] = i + j < count ? tangents[ i + j ] : Float4( 1.0f, 0, 0, 1.0f );
+		}
+		EncodeTangentFrames( normalBuffer, tangentBuffer, first, second );
+		StoreTangentFrames( bytes, i, count - i, stride, first, second );
+	}
+#else
+	for ( std::size_t i = 0; i < count; i++ ) {
+		StoreElement( bytes, i, stride, EncodeTangentFrame( normals[ i ], tangents[ i ] ) );
+	}
+#endif
+}
+
+void PackTexCoords( const Float2* const texCoords, UNorm2x16* const dest, const std::size_t count, const std::size_t stride ) {
+	char* const bytes = reinterpret_cast< char* >( dest );
+	std::size_t i = 0;
+#ifdef SIMD_SSE2
+	for ( ; i + 4 <= count; i += 4 ) {
+		// ( u0, v0, u1, v1 ), ( u2, v2, u3, v3 )
+		const __m128 first = _mm_shuffle_ps( _mm_load_ps( &texCoords[ i ].x ), _mm_load_ps( &texCoords[ i + 1 ].x ), _MM_SHUFFLE( 1, 0, 1, 0 ) );
+		const __m128 second = _mm_shuffle_ps( _mm_load_ps( &texCoords[ i + 2 ].x ), _mm_load_ps( &texCoords[ i + 3 ].x ), _MM_SHUFFLE( 1, 0, 1, 0 ) );
+
+		// packs saturuje se znamenkem, hodnoty 0 - 65535 jsou proto nejdrive znamenkove rozsireny z 16 bitu
+		const __m128i low = QuantizeUNorm( first, UNORM16_MAX );
+		const __m128i high = QuantizeUNorm( second, UNORM16_MAX );
+		const __m128i packed = _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( low, 16 ), 16 ), _mm_srai_epi32( _mm_slli_epi32( high, 16 ), 16 ) );
+		StoreLanes< UNorm2x16 >( bytes, i, stride, packed );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		StoreElement( bytes, i, stride, UNorm2x16{ QuantizeUNorm16( texCoords[ i ].x ), QuantizeUNorm16( texCoords[ i ].y ) } );
+	}
+}
+
+void PackColors( const Float4* const colors, UNorm4x8* const dest, const std::size_t count, const std::size_t stride ) {
+	char* const bytes = reinterpret_cast< char* >( dest );
+	std::size_t i = 0;
+#ifdef SIMD_SSE2
+	for ( ; i + 4 <= count; i += 4 ) {
+		const __m128i c0 = QuantizeUNorm( _mm_load_ps( &colors[ i ].x ), UNORM8_MAX );
+		const __m128i c1 = QuantizeUNorm( _mm_load_ps( &colors[ i + 1 ].x ), UNORM8_MAX );
+		const __m128i c2 = QuantizeUNorm( _mm_load_ps( &colors[ i + 2 ].x ), UNORM8_MAX );
+		const __m128i c3 = QuantizeUNorm( _mm_load_ps( &colors[ i + 3 ].x ), UNORM8_MAX );
+		const __m128i packed = _mm_packus_epi16( _mm_packs_epi32( c0, c1 ), _mm_packs_epi32( c2, c3 ) );
+		StoreLanes< UNorm4x8 >( bytes, i, stride, packed );
+	}
+#endif
+	for ( ; i < count; i++ ) {
+		const Float4& color = colors[ i ];
+		StoreElement( bytes, i, stride, UNorm4x8{ QuantizeUNorm8( color.x ), QuantizeUNorm8( color.y ), QuantizeUNorm8( color.z ), QuantizeUNorm8( color.w ) } );
+	}
+}
+
+void UnpackNormals( const SNorm2x16* const src, Float3* const normals, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		float x = DequantizeSNorm16( src[ i ].x );
+		float y = DequantizeSNorm16( src[ i ].y );
+		const float z = 1.0f - fabsf( x ) - fabsf( y );
+		if ( z < 0 ) {
+			const float foldX = ( 1.0f - fabsf( y ) ) * copysignf( 1.0f, x );
+			const float foldY = ( 1.0f - fabsf( x ) ) * copysignf( 1.0f, y );
+			x = foldX;
+			y = foldY;
+		}
+		const float inv = 1.0f / sqrtf( x * x + y * y + z * z );
+		normals[ i ] = Float3( x * inv, y * inv, z * inv );
+	}
+}
+
+void UnpackTangentFrames( const SNorm4x16* const src, Float3* const normals, Float4* const tangents, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		Quaternion q(
+			DequantizeSNorm16( src[ i ].x ),
+			DequantizeSNorm16( src[ i ].y ),
+			DequantizeSNorm16( src[ i ].z ),
+			DequantizeSNorm16( src[ i ].w )
+		);
+		q.Normalize();
+		Matrix frame;
+		q.StoreMatrix( frame );
+		tangents[ i ] = Float4( frame.m00, frame.m01, frame.m02, src[ i ].w < 0 ? -1.0f : 1.0f );
+		normals[ i ] = Float3( frame.m20, frame.m21, frame.m22 );
+	}
+}
+
+void UnpackTexCoords( const UNorm2x16* const src, Float2* const texCoords, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		texCoords[ i ] = Float2( static_cast< float >( src[ i ].x ) / UNORM16_MAX, static_cast< float >( src[ i ].y ) / UNORM16_MAX );
+	}
+}
+
+void UnpackColors( const UNorm4x8* const src, Float4* const colors, const std::size_t count ) {
+	for ( std::size_t i = 0; i < count; i++ ) {
+		const UNorm4x8& color = src[ i ];
+		colors[ i ] = Float4(
+			static_cast< float >( color.x ) / UNORM8_MAX,
+			static_cast< float >( color.y ) / UNORM8_MAX,
+			static_cast< float >( color.z ) / UNORM8_MAX,
+			static_cast< float >( color.w ) / UNORM8_MAX
+		);
+	}
+}
\ No newline at end of file
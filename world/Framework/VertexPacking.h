@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Types.h"
+
+// typy SNorm2x16, SNorm4x16, UNorm2x16 a UNorm4x8 jsou definovany v Types.h
+
+/*
+Kodovani atributu pro vertex buffery, 4 vertexy najednou (SSE2), zbytek pole skalarne.
+Vystup se jen zapisuje postupne (nikdy se z nej necte), lze tedy zapisovat primo do namapovaneho bufferu.
+stride je vzdalenost prvku vystupu v bajtech, pro prokladane vertexy velikost struktury vertexu.
+Hodnoty jsou zaokrouhleny k nejblizsi hodnote formatu, hodnoty mimo rozsah formatu jsou orezany.
+*/
+
+/*
+Normala v oktaedricke projekci: (x, y, z) / ( |x| + |y| + |z| ), dolni polokoule je preklopena pres diagonaly.
+Normala nemusi byt normalizovana, nulova normala je ulozena jako ( 0, 0, 1 ).
+Uhlova chyba po dekodovani je nejvyse 0.005 stupne.
+*/
+void PackNormals( const Float3* const normals, SNorm2x16* const dest, const std::size_t count, const std::size_t stride = sizeof( SNorm2x16 ) );
+
+/*
+Tangentni prostor jako kvaternion rotace z os ( tangent, cross( normal, tangent ), normal ) do prostoru modelu.
+tangents[ i ].w je orientace bitangenty (+1 nebo -1, bitangent = w * cross( normal, tangent )),
+ulozena je ve znamenku slozky w kvaternionu (kvaternion q a -q predstavuji stejnou rotaci).
+Tangenta je ortogonalizovana k normale (Gram-Schmidt). Uhlova chyba os po dekodovani je nejvyse 0.01 stupne
+(pro tangentu temer rovnobeznou s normalou je chyba dana uz ortogonalizaci ve float).
+Zbytek pole prochazi stejnym SSE2 kernelem, vysledek nezavisi na pozici prvku v poli ani na stride.
+*/
+void PackTangentFrames( const Float3* const normals, const Float4* const tangents, SNorm4x16* const dest, const std::size_t count, const std::size_t stride = sizeof( SNorm4x16 ) );
+
+// texturove souradnice v rozsahu < 0; 1 > (opakovani textury mimo tento rozsah vyzaduje R16G16_FLOAT, viz Half.h)
+void PackTexCoords( const Float2* const texCoords, UNorm2x16* const dest, const std::size_t count, const std::size_t stride = sizeof( UNorm2x16 ) );
+
+// barvy RGBA v rozsahu < 0; 1 >, bez prevodu do sRGB
+void PackColors( const Float4* const colors, UNorm4x8* const dest, const std::size_t count, const std::size_t stride = sizeof( UNorm4x8 ) );
+
+/*
+Dekodovani (nacteni dat z GPU, kontrola kvantizace), souvisla pole.
+Dekodovane normaly a osy tangentniho prostoru jsou normalizovane, tangents[ i ].w je +1 nebo -1.
+*/
+void UnpackNormals( const SNorm2x16* const src, Float3* const normals, const std::size_t count );
+void UnpackTangentFrames( const SNorm4x16* const src, Float3* const normals, Float4* const tangents, const std::size_t count );
+void UnpackTexCoords( const UNorm2x16* const src, Float2* const texCoords, const std::size_t count );
+void UnpackColors( const UNorm4x8* const src, Float4* const colors, const std::size_t count );
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "File.h"
+#include "Framework/Allocation.h"
 
 String GetFileName( const String &file ) {
 	int index = file.FindBack( u'/' );
@@ -171,4 +172,41 @@ std::unique_ptr< Byte[] > LoadByteFile( const String& path ) {
 	file.Read( bytes.get(), size );
 	file.Close();
 	return bytes;
+}
+
+char* LoadCharFile( const String& path, StackAllocator& allocator, unsigned long* const size ) {
+	File file;
+	if ( !file.OpenToRead( path, FileAccess::SEQUENTIAL ) ) {
+		return nullptr;
+	}
+	const auto bytes = file.Size();
+	char* const string = allocator.AllocArray< char >( bytes + 1 );
+	if ( string == nullptr ) {
+		return nullptr;
+	}
+	file.Read( string, bytes );
+	file.Close();
+	string[ bytes ] = '\0';
+	if ( size != nullptr ) {
+		*size = bytes;
+	}
+	return string;
+}
+
+Byte* LoadByteFile( const String& path, StackAllocator& allocator, unsigned long* const size ) {
+	File file;
+	if ( !file.OpenToRead( path, FileAccess::SEQUENTIAL ) ) {
+		return nullptr;
+	}
+	const auto bytes = file.Size();
+	Byte* const data = allocator.AllocArray< Byte >( bytes );
+	if ( data == nullptr ) {
+		return nullptr;
+	}
+	file.Read( data, bytes );
+	file.Close();
+	if ( size != nullptr ) {
+		*size = bytes;
+	}
+	return data;
 }
\ No newline at end of file
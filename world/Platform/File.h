@@ -157,4 +157,14 @@ std::unique_ptr< char[] > LoadCharFile( const String& path );
 // Nacte cely obsah souboru jako pole Bytes
 std::unique_ptr< Byte[] > LoadByteFile( const String& path );
 
+class StackAllocator;
+
+/*
+Varianty pro docasne buffery, pamet je alokovana z allocator (napr. GetThreadStackAllocator()).
+Buffer je platny do uvolneni alokatoru ke znacce ziskane pred volanim funkce, pri chybe vraci nullptr.
+Parameter size (muze byt nullptr) vraci velikost souboru v bajtech.
+*/
+char* LoadCharFile( const String& path, StackAllocator& allocator, unsigned long* const size = nullptr );
+Byte* LoadByteFile( const String& path, StackAllocator& allocator, unsigned long* const size = nullptr );
+
 //String LoadStringFile()
\ No newline at end of file